@@ -0,0 +1,142 @@
+#include <vector>
+
+#include "core/cbus.h"
+#include "core/fiber.h"
+#include "core/memory.h"
+
+#include <benchmark/benchmark.h>
+
+/**
+ * This suite contains benchmarks for cbus - the inter-thread message
+ * bus. A batch of messages is sent from the main thread to a worker
+ * thread and back. Both pipes use the same transport, so the results
+ * can be used to compare CPIPE_TRANSPORT_MUTEX with
+ * CPIPE_TRANSPORT_LOCKFREE.
+ */
+
+/** Worker thread running the cbus loop. */
+static struct cord worker;
+/** Pipe from the main thread to the worker. */
+static struct cpipe pipe_to_worker;
+/** Pipe from the worker to the main thread. */
+static struct cpipe pipe_to_main;
+/** Transport of the pipes used by the current benchmark. */
+static enum cpipe_transport transport;
+/** Number of messages that have returned to the main thread. */
+static int completed;
+
+static void
+do_nothing(struct cmsg *msg)
+{
+	(void)msg;
+}
+
+static void
+complete(struct cmsg *msg)
+{
+	(void)msg;
+	completed++;
+}
+
+static struct cmsg_hop route[] = {
+	{do_nothing, &pipe_to_main},
+	{complete, nullptr},
+};
+
+static int
+worker_f(va_list ap)
+{
+	(void)ap;
+	cpipe_create(&pipe_to_main, "main");
+	cpipe_set_transport(&pipe_to_main, transport);
+	struct cbus_endpoint endpoint;
+	cbus_endpoint_create(&endpoint, "worker", fiber_schedule_cb, fiber());
+	cbus_loop(&endpoint);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	cpipe_destroy(&pipe_to_main);
+	return 0;
+}
+
+static void
+worker_start(enum cpipe_transport value)
+{
+	transport = value;
+	if (cord_costart(&worker, "worker", worker_f, nullptr) != 0)
+		panic("failed to start the worker");
+	cpipe_create_noev(&pipe_to_worker, "worker");
+	cpipe_set_transport(&pipe_to_worker, transport);
+}
+
+static void
+worker_stop()
+{
+	cbus_stop_loop(&pipe_to_worker);
+	cpipe_destroy(&pipe_to_worker);
+	if (cord_join(&worker) != 0)
+		panic("failed to join the worker");
+}
+
+static void
+main_endpoint_cb(ev_loop *loop, struct ev_watcher *watcher, int events)
+{
+	(void)loop;
+	(void)events;
+	cbus_process((struct cbus_endpoint *)watcher->data);
+}
+
+class CbusFixture {
+public:
+	static void
+	init()
+	{
+		static CbusFixture instance;
+	}
+
+private:
+	CbusFixture()
+	{
+		memory_init();
+		fiber_init(fiber_c_invoke);
+		cbus_init();
+		cbus_endpoint_create(&endpoint, "main", main_endpoint_cb,
+				     &endpoint);
+	}
+
+	struct cbus_endpoint endpoint;
+};
+
+/**
+ * Send a batch of messages to the worker and wait for all of them to
+ * return. The first argument is the transport, the second one is the
+ * batch size.
+ */
+static void
+bench_round_trip(benchmark::State &state)
+{
+	CbusFixture::init();
+	worker_start(static_cast<enum cpipe_transport>(state.range(0)));
+	int batch_size = state.range(1);
+	std::vector<struct cmsg> msgs(batch_size);
+	for (auto _ : state) {
+		completed = 0;
+		for (auto &msg : msgs) {
+			cmsg_init(&msg, route);
+			cpipe_push(&pipe_to_worker, &msg);
+		}
+		cpipe_flush(&pipe_to_worker);
+		while (completed < batch_size)
+			ev_run(loop(), EVRUN_ONCE);
+	}
+	state.SetItemsProcessed(state.iterations() * batch_size);
+	worker_stop();
+}
+
+BENCHMARK(bench_round_trip)
+	->ArgsProduct({{CPIPE_TRANSPORT_MUTEX, CPIPE_TRANSPORT_LOCKFREE},
+		       {1, 32, 1024}})
+	->ArgNames({"lockfree", "batch"})
+	->UseRealTime();
+
+BENCHMARK_MAIN();
+
+#include "debug_warning.h"
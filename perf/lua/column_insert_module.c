@@ -9,10 +9,6 @@
 #include "trivia/util.h"
 #include "arrow/abi.h"
 
-#ifdef ENABLE_MEMCS_ENGINE
-# define ENABLE_BATCH_INSERT 1
-#endif
-
 enum sparse_mode {
 	SPARSE_MODE_SEQ,
 	SPARSE_MODE_RAND,
@@ -117,7 +113,6 @@ insert_serial_lua_func(struct lua_State *L)
 	return 0;
 }
 
-#if defined(ENABLE_BATCH_INSERT)
 static void
 arrow_schema_destroy(struct ArrowSchema *schema)
 {
@@ -279,7 +274,6 @@ insert_batch_lua_func(struct lua_State *L)
 	}
 	return 0;
 }
-#endif /* defined(ENABLE_BATCH_INSERT) */
 
 static int
 init_lua_func(struct lua_State *L)
@@ -335,9 +329,7 @@ luaopen_column_insert_module(struct lua_State *L)
 		{"init", init_lua_func},
 		{"fini", fini_lua_func},
 		{"insert_serial", insert_serial_lua_func},
-#ifdef ENABLE_BATCH_INSERT
 		{"insert_batch", insert_batch_lua_func},
-#endif
 		{NULL, NULL},
 	};
 	luaL_register(L, "column_insert_module", lib);
@@ -14,10 +14,6 @@
 # define ROUND_UP(n, d) (DIV_ROUND_UP(n, d) * (d))
 #endif
 
-#if defined(ENABLE_MEMCS_ENGINE) || defined(ENABLE_QUIVER_ENGINE)
-# define ENABLE_ARROW 1
-#endif /* ENABLE_MEMCS_ENGINE || ENABLE_QUIVER_ENGINE */
-
 #if defined(ENABLE_RAW_READ_VIEW)
 static box_raw_read_view_t *rv;
 
@@ -32,7 +28,6 @@ init_rv(struct lua_State *L)
 }
 #endif /* ENABLE_RAW_READ_VIEW */
 
-#if defined(ENABLE_ARROW)
 struct arrow_string {
 	int32_t len;
 	union {
@@ -241,7 +236,6 @@ gen_arrow_lua_func(struct lua_State *L)
 	}
 	return 0;
 }
-#endif /* defined(ENABLE_ARROW) */
 
 static int
 sum_iterator_lua_func(struct lua_State *L)
@@ -461,7 +455,6 @@ str_iterator_rv_lua_func(struct lua_State *L)
 }
 #endif /* defined(ENABLE_RAW_READ_VIEW) */
 
-#if defined(ENABLE_ARROW)
 static int
 sum_arrow_lua_func(struct lua_State *L)
 {
@@ -587,9 +580,8 @@ str_arrow_lua_func(struct lua_State *L)
 	lua_pushboolean(L, true);
 	return 1;
 }
-#endif /* defined(ENABLE_ARROW) */
 
-#if defined(ENABLE_ARROW) && defined(ENABLE_RAW_READ_VIEW)
+#if defined(ENABLE_RAW_READ_VIEW)
 static int
 sum_arrow_rv_lua_func(struct lua_State *L)
 {
@@ -765,29 +757,25 @@ str_arrow_rv_lua_func(struct lua_State *L)
 	lua_pushboolean(L, true);
 	return 1;
 }
-#endif /* defined(ENABLE_ARROW) && defined(ENABLE_RAW_READ_VIEW) */
+#endif /* defined(ENABLE_RAW_READ_VIEW) */
 
 LUA_API int
 luaopen_column_scan_module(struct lua_State *L)
 {
 	static const struct luaL_Reg lib[] = {
-#if defined(ENABLE_ARROW)
 		{"gen_arrow", gen_arrow_lua_func},
-#endif /* defined(ENABLE_ARROW) */
 		{"sum_iterator", sum_iterator_lua_func},
 		{"str_iterator", str_iterator_lua_func},
 #if defined(ENABLE_RAW_READ_VIEW)
 		{"sum_iterator_rv", sum_iterator_rv_lua_func},
 		{"str_iterator_rv", str_iterator_rv_lua_func},
 #endif /* defined(ENABLE_RAW_READ_VIEW) */
-#if defined(ENABLE_ARROW)
 		{"sum_arrow", sum_arrow_lua_func},
 		{"str_arrow", str_arrow_lua_func},
-#endif /* defined(ENABLE_ARROW) */
-#if defined(ENABLE_ARROW) && defined(ENABLE_RAW_READ_VIEW)
+#if defined(ENABLE_RAW_READ_VIEW)
 		{"sum_arrow_rv", sum_arrow_rv_lua_func},
 		{"str_arrow_rv", str_arrow_rv_lua_func},
-#endif /* defined(ENABLE_ARROW) && defined(ENABLE_RAW_READ_VIEW) */
+#endif /* defined(ENABLE_RAW_READ_VIEW) */
 		{NULL, NULL},
 	};
 	luaL_register(L, "column_scan_module", lib);
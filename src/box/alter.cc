@@ -45,6 +45,7 @@
 #include "fiber.h" /* for gc_pool */
 #include "scoped_guard.h"
 #include <base64.h>
+#include <pmatomic.h>
 #include <new> /* for placement new */
 #include <stdio.h> /* snprintf() */
 #include <ctype.h>
@@ -70,7 +71,8 @@
 static void
 box_schema_version_bump(void)
 {
-	++schema_version;
+	/* Read by IPROTO threads, see net_process_stale_read(). */
+	pm_atomic_store(&schema_version, schema_version + 1);
 	box_broadcast_schema();
 }
 
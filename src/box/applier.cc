@@ -63,6 +63,10 @@
 #include "tt_static.h"
 #include "memory.h"
 #include "ssl_error.h"
+#include "space.h"
+#include "index.h"
+#include "memtx_tx.h"
+#include "tweaks.h"
 
 STRS(applier_state, applier_STATE);
 
@@ -1466,8 +1470,13 @@ applier_handle_raft_request(struct applier *applier, struct raft_request *req)
 	return box_raft_process(req, applier->instance_id);
 }
 
-static int
-apply_plain_tx(uint32_t replica_id, struct stailq *rows)
+/**
+ * Apply all rows of a transaction and prepare it for commit. Returns
+ * the transaction, which must then be submitted with txn_commit_submit(),
+ * or NULL on error.
+ */
+static struct txn *
+apply_plain_tx_prepare(uint32_t replica_id, struct stailq *rows)
 {
 	/*
 	 * Explicitly begin the transaction so that we can
@@ -1478,7 +1487,7 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows)
 	struct txn *txn = txn_begin();
 	struct applier_tx_row *item;
 	if (txn == NULL)
-		 return -1;
+		 return NULL;
 	txn->isolation = TXN_ISOLATION_READ_COMMITTED;
 
 	stailq_foreach_entry(item, rows, next) {
@@ -1563,10 +1572,19 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows)
 	rcb->txn_last_tm = item->row.tm;
 	trigger_create(on_wal_write, applier_txn_wal_write_cb, rcb, NULL);
 	txn_on_wal_write(txn, on_wal_write);
-	return txn_commit_submit(txn);
+	return txn;
 fail:
 	txn_abort(txn);
-	return -1;
+	return NULL;
+}
+
+static int
+apply_plain_tx(uint32_t replica_id, struct stailq *rows)
+{
+	struct txn *txn = apply_plain_tx_prepare(replica_id, rows);
+	if (txn == NULL)
+		return -1;
+	return txn_commit_submit(txn);
 }
 
 /**
@@ -1742,6 +1760,393 @@ applier_apply_tx(struct applier *applier, struct stailq *rows)
 	return rc;
 }
 
+/* {{{ Parallel apply */
+
+/**
+ * Max number of transactions an applier may apply concurrently.
+ * Zero disables parallel apply.
+ */
+static uint64_t applier_parallel_tx_max = 0;
+TWEAK_UINT(applier_parallel_tx_max);
+
+enum {
+	/**
+	 * Max number of keys tracked per transaction. A transaction
+	 * modifying more keys is applied exclusively.
+	 */
+	APPLIER_PARALLEL_TX_KEYS_MAX = 32,
+	/** Upper bound of applier_parallel_tx_max. */
+	APPLIER_PARALLEL_TX_LIMIT = 1024,
+};
+
+/**
+ * Returns the max number of worker fibers applying transactions
+ * concurrently. The tweak can be set to any 64-bit value, so it is
+ * clamped to a sane range. The result is at least 1 so that a
+ * transaction can always be applied, even if the tweak is reset to 0
+ * while the applier is waiting for a free worker.
+ */
+static int
+applier_parallel_tx_limit(void)
+{
+	uint64_t limit = applier_parallel_tx_max;
+	if (limit > APPLIER_PARALLEL_TX_LIMIT)
+		limit = APPLIER_PARALLEL_TX_LIMIT;
+	if (limit == 0)
+		limit = 1;
+	return (int)limit;
+}
+
+/**
+ * Transactions received in a batch are applied by worker fibers so
+ * that a transaction that has to wait for a disk read (vinyl) doesn't
+ * block transactions that follow it. Two transactions depend on each
+ * other if they modify a tuple with the same primary key in the same
+ * space. A transaction doesn't start applying its rows until all
+ * earlier transactions it depends on have been submitted to WAL.
+ * Independent transactions apply their rows concurrently, but they
+ * are always submitted to WAL in the order they were received, which
+ * keeps the replica's vclock monotonic. A prepared transaction that
+ * isn't allowed to yield (memtx without MVCC) can't wait for its turn
+ * to be submitted, so such a transaction applies its rows only when
+ * all earlier transactions have been submitted.
+ *
+ * Transactions that can't be reasoned about in terms of primary keys
+ * (synchronous replication requests, DDL, transactions affecting
+ * spaces with triggers, sequences or secondary unique indexes) are
+ * applied exclusively: the applier waits for all workers to complete
+ * and then applies them in its own fiber.
+ */
+struct applier_parallel {
+	/** Applier the transactions were received from. */
+	struct applier *applier;
+	/**
+	 * Order latch of the replica the transactions being applied
+	 * originate from. Held as long as there are transactions in
+	 * progress. NULL if there are none.
+	 */
+	struct latch *latch;
+	/** ID of the replica the transactions originate from. */
+	uint32_t replica_id;
+	/** LSN of the last dispatched transaction. */
+	int64_t lsn;
+	/** Sequence number to assign to the next transaction. */
+	uint64_t next_seq;
+	/** Sequence number of the next transaction to submit to WAL. */
+	uint64_t submit_seq;
+	/** Number of worker fibers that haven't finished yet. */
+	int worker_count;
+	/** Transactions that haven't been submitted yet. */
+	struct rlist txs;
+	/** Signalled when a transaction is submitted. */
+	struct fiber_cond cond;
+	/**
+	 * Set if a transaction failed. All transactions following it are
+	 * aborted.
+	 */
+	bool is_failed;
+	/** Error that caused the failure. */
+	struct diag diag;
+};
+
+/** A transaction applied by a worker fiber. */
+struct applier_parallel_tx {
+	/** Link in applier_parallel::txs. */
+	struct rlist in_txs;
+	/** Parallel apply state this transaction belongs to. */
+	struct applier_parallel *parallel;
+	/** Transaction rows. */
+	struct stailq *rows;
+	/** Order in which the transaction must be submitted to WAL. */
+	uint64_t seq;
+	/**
+	 * Sequence number of the last earlier transaction this one
+	 * depends on. Valid only if has_dep is set.
+	 */
+	uint64_t dep_seq;
+	/** Set if the transaction depends on an earlier transaction. */
+	bool has_dep;
+	/**
+	 * Set if the transaction may yield after it has been prepared,
+	 * see applier_parallel_apply_tx().
+	 */
+	bool can_yield;
+	/** Hashes of the modified keys, see applier_parallel_tx_keys(). */
+	uint64_t keys[APPLIER_PARALLEL_TX_KEYS_MAX];
+	/** Number of entries in the keys array. */
+	int key_count;
+};
+
+static void
+applier_parallel_create(struct applier_parallel *parallel,
+			struct applier *applier)
+{
+	memset(parallel, 0, sizeof(*parallel));
+	parallel->applier = applier;
+	rlist_create(&parallel->txs);
+	fiber_cond_create(&parallel->cond);
+	diag_create(&parallel->diag);
+}
+
+/** Wait for all workers to complete and release the order latch. */
+static void
+applier_parallel_wait(struct applier_parallel *parallel)
+{
+	while (parallel->worker_count > 0)
+		fiber_cond_wait(&parallel->cond);
+	assert(rlist_empty(&parallel->txs));
+	if (parallel->latch != NULL) {
+		latch_unlock(parallel->latch);
+		parallel->latch = NULL;
+	}
+}
+
+/**
+ * Wait for all transactions in progress to be submitted to WAL.
+ * Returns -1 and sets diag if any of them failed.
+ */
+static int
+applier_parallel_drain(struct applier_parallel *parallel)
+{
+	applier_parallel_wait(parallel);
+	if (parallel->is_failed) {
+		diag_move(&parallel->diag, diag_get());
+		return -1;
+	}
+	return 0;
+}
+
+static void
+applier_parallel_destroy(struct applier_parallel *parallel)
+{
+	applier_parallel_wait(parallel);
+	diag_destroy(&parallel->diag);
+	fiber_cond_destroy(&parallel->cond);
+}
+
+/**
+ * Collect hashes of the primary keys modified by a transaction. A hash
+ * combines the space id and the hash of the key, computed the same way
+ * as the hash index does it so that equal keys encoded differently
+ * have the same hash. Returns false if the transaction must be applied
+ * exclusively.
+ */
+static bool
+applier_parallel_tx_keys(struct applier_parallel_tx *ptx, struct stailq *rows)
+{
+	ptx->key_count = 0;
+	ptx->can_yield = true;
+	struct applier_tx_row *item;
+	stailq_foreach_entry(item, rows, next) {
+		struct request *request = &item->req.dml;
+		const char *key;
+		switch (item->row.type) {
+		case IPROTO_NOP:
+			continue;
+		case IPROTO_INSERT:
+		case IPROTO_REPLACE:
+		case IPROTO_UPSERT:
+			key = NULL;
+			break;
+		case IPROTO_UPDATE:
+		case IPROTO_DELETE:
+			if (request->index_id != 0)
+				return false;
+			key = request->key;
+			break;
+		default:
+			return false;
+		}
+		struct space *space = space_by_id(request->space_id);
+		if (space == NULL || space_is_system(space) ||
+		    space->index_count == 0 || space->sequence != NULL ||
+		    space->has_foreign_keys ||
+		    space_has_before_replace_triggers(space) ||
+		    space_has_on_replace_triggers(space))
+			return false;
+		for (uint32_t i = 1; i < space->index_count; i++) {
+			if (space->index[i]->def->opts.is_unique)
+				return false;
+		}
+		if (!space_is_vinyl(space) &&
+		    !(space_is_memtx(space) &&
+		      memtx_tx_manager_use_mvcc_engine))
+			ptx->can_yield = false;
+		if (ptx->key_count == APPLIER_PARALLEL_TX_KEYS_MAX)
+			return false;
+		struct key_def *key_def = space->index[0]->def->key_def;
+		if (key == NULL) {
+			uint32_t key_size;
+			key = tuple_extract_key_raw(request->tuple,
+						    request->tuple_end,
+						    key_def, MULTIKEY_NONE,
+						    &key_size);
+			if (key == NULL) {
+				diag_clear(diag_get());
+				return false;
+			}
+		}
+		if (mp_typeof(*key) != MP_ARRAY ||
+		    mp_decode_array(&key) != key_def->part_count)
+			return false;
+		ptx->keys[ptx->key_count++] =
+			(uint64_t)request->space_id << 32 |
+			key_hash(key, key_def);
+	}
+	return true;
+}
+
+/** Check if two transactions modify the same key. */
+static bool
+applier_parallel_tx_conflicts(const struct applier_parallel_tx *a,
+			      const struct applier_parallel_tx *b)
+{
+	for (int i = 0; i < a->key_count; i++) {
+		for (int j = 0; j < b->key_count; j++) {
+			if (a->keys[i] == b->keys[j])
+				return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Apply a transaction in a worker fiber and submit it to WAL once all
+ * earlier transactions have been submitted.
+ */
+static void
+applier_parallel_apply_tx(struct applier_parallel_tx *ptx)
+{
+	struct applier_parallel *parallel = ptx->parallel;
+	struct applier *applier = parallel->applier;
+	while (ptx->has_dep && parallel->submit_seq <= ptx->dep_seq &&
+	       !parallel->is_failed)
+		fiber_cond_wait(&parallel->cond);
+	/*
+	 * A transaction that isn't allowed to yield (memtx without MVCC)
+	 * would be aborted by waiting for its turn after it has been
+	 * prepared so it's prepared only when it's its turn to be
+	 * submitted.
+	 */
+	while (!ptx->can_yield && parallel->submit_seq != ptx->seq)
+		fiber_cond_wait(&parallel->cond);
+	struct txn *txn = NULL;
+	if (!parallel->is_failed)
+		txn = apply_plain_tx_prepare(applier->instance_id, ptx->rows);
+	while (parallel->submit_seq != ptx->seq)
+		fiber_cond_wait(&parallel->cond);
+	if (parallel->is_failed) {
+		if (txn != NULL)
+			txn_abort(txn);
+		diag_clear(diag_get());
+	} else if (txn == NULL || txn_commit_submit(txn) != 0) {
+		parallel->is_failed = true;
+		diag_move(diag_get(), &parallel->diag);
+	} else {
+		struct xrow_header *last_row = &stailq_last_entry(
+			ptx->rows, struct applier_tx_row, next)->row;
+		vclock_follow(&replicaset.applier.vclock,
+			      last_row->replica_id, last_row->lsn);
+	}
+	rlist_del_entry(ptx, in_txs);
+	parallel->submit_seq++;
+	fiber_cond_broadcast(&parallel->cond);
+}
+
+static int
+applier_parallel_f(va_list ap)
+{
+	struct applier_parallel_tx *ptx =
+		va_arg(ap, struct applier_parallel_tx *);
+	struct session *session = va_arg(ap, struct session *);
+	struct applier_parallel *parallel = ptx->parallel;
+	fiber_set_session(fiber(), session);
+	applier_parallel_apply_tx(ptx);
+	fiber_set_session(fiber(), NULL);
+	parallel->worker_count--;
+	fiber_cond_broadcast(&parallel->cond);
+	return 0;
+}
+
+/**
+ * Apply a transaction concurrently with other transactions if
+ * possible, otherwise wait for all transactions in progress and apply
+ * it exclusively. Like applier_apply_tx(), returns -1 and sets diag
+ * on failure. Note, an error may be reported by a later call or by
+ * applier_parallel_drain().
+ */
+static int
+applier_parallel_apply(struct applier_parallel *parallel,
+		       struct stailq *rows)
+{
+	struct applier *applier = parallel->applier;
+	struct xrow_header *first_row = &stailq_first_entry(
+		rows, struct applier_tx_row, next)->row;
+	struct xrow_header *last_row = &stailq_last_entry(
+		rows, struct applier_tx_row, next)->row;
+	struct applier_parallel_tx *ptx = xregion_alloc_object(
+		&fiber()->gc, struct applier_parallel_tx);
+	bool is_exclusive = iproto_type_is_synchro_request(first_row->type) ||
+			    !applier_parallel_tx_keys(ptx, rows);
+	if (is_exclusive || (parallel->latch != NULL &&
+			     parallel->replica_id != first_row->replica_id)) {
+		if (applier_parallel_drain(parallel) != 0)
+			return -1;
+		if (is_exclusive)
+			return applier_apply_tx(applier, rows);
+	}
+	if (parallel->latch == NULL) {
+		/* See the comment in applier_apply_tx(). */
+		struct replica *replica = replica_by_id(first_row->replica_id);
+		parallel->latch = replica != NULL ? &replica->order_latch :
+				  &replicaset.applier.order_latch;
+		parallel->replica_id = first_row->replica_id;
+		latch_lock(parallel->latch);
+		parallel->lsn = vclock_get(&replicaset.applier.vclock,
+					   parallel->replica_id);
+		if (fiber_is_cancelled()) {
+			diag_set(FiberIsCancelled);
+			return -1;
+		}
+	}
+	/* Skip the rows that have already been applied. */
+	if (last_row->lsn <= parallel->lsn)
+		return 0;
+	while (first_row->lsn <= parallel->lsn) {
+		stailq_shift(rows);
+		first_row = &stailq_first_entry(
+			rows, struct applier_tx_row, next)->row;
+	}
+	if (applier_synchro_filter_tx(rows) != 0)
+		return -1;
+	while (parallel->worker_count >= applier_parallel_tx_limit())
+		fiber_cond_wait(&parallel->cond);
+	if (parallel->is_failed)
+		return applier_parallel_drain(parallel);
+	ptx->parallel = parallel;
+	ptx->rows = rows;
+	ptx->seq = parallel->next_seq++;
+	ptx->has_dep = false;
+	struct applier_parallel_tx *prev;
+	rlist_foreach_entry(prev, &parallel->txs, in_txs) {
+		if (applier_parallel_tx_conflicts(ptx, prev)) {
+			ptx->has_dep = true;
+			ptx->dep_seq = prev->seq;
+		}
+	}
+	struct fiber *f = fiber_new_system("applier_worker",
+					   applier_parallel_f);
+	if (f == NULL)
+		return -1;
+	rlist_add_tail_entry(&parallel->txs, ptx, in_txs);
+	parallel->lsn = last_row->lsn;
+	parallel->worker_count++;
+	fiber_start(f, ptx, current_session());
+	return 0;
+}
+
+/* }}} Parallel apply */
+
 /**
  * Notify the applier's write fiber that there are more ACKs to
  * send to master.
@@ -1913,6 +2318,16 @@ applier_process_batch(struct cmsg *base)
 {
 	struct applier_data_msg *msg = (struct applier_data_msg *)base;
 	struct applier *applier = msg->base.applier;
+	/*
+	 * Workers reference the message rows so they must be done before
+	 * the message is returned to the applier thread.
+	 */
+	RegionGuard region_guard(&fiber()->gc);
+	struct applier_parallel parallel;
+	applier_parallel_create(&parallel, applier);
+	auto parallel_guard = make_scoped_guard([&] {
+		applier_parallel_destroy(&parallel);
+	});
 	struct applier_tx *tx;
 	stailq_foreach_entry(tx, &msg->txs, next) {
 		struct applier_tx_row *last_txr =
@@ -1928,12 +2343,17 @@ applier_process_batch(struct cmsg *base)
 					       applier->instance_id);
 		}
 		if (last_txr->row.lsn == 0) {
+			if (applier_parallel_drain(&parallel) != 0)
+				diag_raise();
 			if (applier_process_heartbeat(applier, last_txr) != 0)
 				diag_raise();
 			if (applier_handle_raft(applier, last_txr) != 0)
 				diag_raise();
 			applier_signal_ack(applier);
 			applier_check_sync(applier);
+		} else if (applier_parallel_tx_max > 0) {
+			if (applier_parallel_apply(&parallel, &tx->rows) != 0)
+				diag_raise();
 		} else if (applier_apply_tx(applier, &tx->rows) != 0) {
 			diag_raise();
 		}
@@ -1945,6 +2365,8 @@ applier_process_batch(struct cmsg *base)
 			applier_set_state(applier, APPLIER_FOLLOW);
 		}
 	}
+	if (applier_parallel_drain(&parallel) != 0)
+		diag_raise();
 
 	/* Return the message to applier thread. */
 	cmsg_init(&msg->base.base, return_route);
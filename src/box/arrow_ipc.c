@@ -0,0 +1,1386 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "arrow_ipc.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bit/bit.h"
+#include "diag.h"
+#include "error.h"
+#include "small/region.h"
+#include "trivia/util.h"
+#include "tt_static.h"
+
+/*
+ * An Arrow IPC stream is a sequence of encapsulated messages. Each message
+ * starts with the continuation marker and the length of the metadata, which
+ * is a flatbuffers-encoded Message table padded to 8 bytes, followed by the
+ * message body. The first message describes the schema, the following ones
+ * carry record batches. The stream ends with a zero metadata length.
+ *
+ * Only flat record batches of primitive, boolean, binary and string columns
+ * are supported so the flatbuffers encoding is done by hand here rather than
+ * with the generated code.
+ */
+
+/** Marker preceding the metadata length of a message. */
+#define ARROW_IPC_CONTINUATION 0xFFFFFFFF
+/** MetadataVersion.V4: the oldest version we can read. */
+#define ARROW_IPC_METADATA_VERSION_V4 3
+/** MetadataVersion.V5: the version we write. */
+#define ARROW_IPC_METADATA_VERSION_V5 4
+/** Alignment of the message metadata and body buffers. */
+#define ARROW_IPC_ALIGNMENT 8
+
+/** Ids of the MessageHeader union members. */
+enum {
+	ARROW_IPC_HEADER_SCHEMA = 1,
+	ARROW_IPC_HEADER_DICTIONARY_BATCH = 2,
+	ARROW_IPC_HEADER_RECORD_BATCH = 3,
+};
+
+/** Ids of the Type union members supported by the codec. */
+enum {
+	ARROW_IPC_TYPE_NULL = 1,
+	ARROW_IPC_TYPE_INT = 2,
+	ARROW_IPC_TYPE_FLOATING_POINT = 3,
+	ARROW_IPC_TYPE_BINARY = 4,
+	ARROW_IPC_TYPE_UTF8 = 5,
+	ARROW_IPC_TYPE_BOOL = 6,
+	ARROW_IPC_TYPE_LARGE_BINARY = 19,
+	ARROW_IPC_TYPE_LARGE_UTF8 = 20,
+};
+
+/** Values of the Precision enum. */
+enum {
+	ARROW_IPC_PRECISION_SINGLE = 1,
+	ARROW_IPC_PRECISION_DOUBLE = 2,
+};
+
+/** Field ids of the flatbuffers tables. */
+enum {
+	FB_MESSAGE_VERSION = 0,
+	FB_MESSAGE_HEADER_TYPE = 1,
+	FB_MESSAGE_HEADER = 2,
+	FB_MESSAGE_BODY_LENGTH = 3,
+};
+
+enum {
+	FB_SCHEMA_ENDIANNESS = 0,
+	FB_SCHEMA_FIELDS = 1,
+};
+
+enum {
+	FB_FIELD_NAME = 0,
+	FB_FIELD_NULLABLE = 1,
+	FB_FIELD_TYPE_TYPE = 2,
+	FB_FIELD_TYPE = 3,
+	FB_FIELD_DICTIONARY = 4,
+	FB_FIELD_CHILDREN = 5,
+};
+
+enum {
+	FB_INT_BIT_WIDTH = 0,
+	FB_INT_IS_SIGNED = 1,
+};
+
+enum {
+	FB_FLOATING_POINT_PRECISION = 0,
+};
+
+enum {
+	FB_RECORD_BATCH_LENGTH = 0,
+	FB_RECORD_BATCH_NODES = 1,
+	FB_RECORD_BATCH_BUFFERS = 2,
+	FB_RECORD_BATCH_COMPRESSION = 3,
+};
+
+/** Size of the FieldNode and Buffer structs. */
+#define FB_STRUCT_SIZE 16
+
+/** Description of an Arrow type supported by the codec. */
+struct arrow_ipc_type {
+	/** Format string in the C data interface. */
+	const char *format;
+	/** Id of the type in the Type union. */
+	uint8_t type_id;
+	/**
+	 * Width of a value in bits for fixed-width types or width
+	 * of an offset for variable-length types.
+	 */
+	int bit_width;
+	/** Whether an integer type is signed. */
+	bool is_signed;
+};
+
+static const struct arrow_ipc_type arrow_ipc_types[] = {
+	{"n", ARROW_IPC_TYPE_NULL, 0, false},
+	{"b", ARROW_IPC_TYPE_BOOL, 1, false},
+	{"c", ARROW_IPC_TYPE_INT, 8, true},
+	{"C", ARROW_IPC_TYPE_INT, 8, false},
+	{"s", ARROW_IPC_TYPE_INT, 16, true},
+	{"S", ARROW_IPC_TYPE_INT, 16, false},
+	{"i", ARROW_IPC_TYPE_INT, 32, true},
+	{"I", ARROW_IPC_TYPE_INT, 32, false},
+	{"l", ARROW_IPC_TYPE_INT, 64, true},
+	{"L", ARROW_IPC_TYPE_INT, 64, false},
+	{"f", ARROW_IPC_TYPE_FLOATING_POINT, 32, false},
+	{"g", ARROW_IPC_TYPE_FLOATING_POINT, 64, false},
+	{"z", ARROW_IPC_TYPE_BINARY, 32, false},
+	{"u", ARROW_IPC_TYPE_UTF8, 32, false},
+	{"Z", ARROW_IPC_TYPE_LARGE_BINARY, 64, false},
+	{"U", ARROW_IPC_TYPE_LARGE_UTF8, 64, false},
+};
+
+static const struct arrow_ipc_type *
+arrow_ipc_type_by_format(const char *format)
+{
+	for (size_t i = 0; i < lengthof(arrow_ipc_types); i++) {
+		if (strcmp(arrow_ipc_types[i].format, format) == 0)
+			return &arrow_ipc_types[i];
+	}
+	return NULL;
+}
+
+static const struct arrow_ipc_type *
+arrow_ipc_type_by_id(uint8_t type_id, int bit_width, bool is_signed)
+{
+	for (size_t i = 0; i < lengthof(arrow_ipc_types); i++) {
+		const struct arrow_ipc_type *type = &arrow_ipc_types[i];
+		if (type->type_id != type_id)
+			continue;
+		if (type_id == ARROW_IPC_TYPE_INT &&
+		    (type->bit_width != bit_width ||
+		     type->is_signed != is_signed))
+			continue;
+		if (type_id == ARROW_IPC_TYPE_FLOATING_POINT &&
+		    type->bit_width != bit_width)
+			continue;
+		return type;
+	}
+	return NULL;
+}
+
+/** Checks if values of the type are addressed with an offsets buffer. */
+static inline bool
+arrow_ipc_type_is_var(const struct arrow_ipc_type *type)
+{
+	switch (type->type_id) {
+	case ARROW_IPC_TYPE_BINARY:
+	case ARROW_IPC_TYPE_UTF8:
+	case ARROW_IPC_TYPE_LARGE_BINARY:
+	case ARROW_IPC_TYPE_LARGE_UTF8:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Returns the number of buffers of an array of the type. It's the same
+ * for the C data interface and IPC record batches.
+ */
+static inline int
+arrow_ipc_type_buffer_count(const struct arrow_ipc_type *type)
+{
+	if (type->type_id == ARROW_IPC_TYPE_NULL)
+		return 0;
+	return arrow_ipc_type_is_var(type) ? 3 : 2;
+}
+
+/** Returns the @a i-th value of an offsets buffer. */
+static inline int64_t
+arrow_ipc_load_offset(const struct arrow_ipc_type *type, const void *offsets,
+		      int64_t i)
+{
+	if (offsets == NULL)
+		return 0;
+	if (type->bit_width == 32)
+		return ((const int32_t *)offsets)[i];
+	return ((const int64_t *)offsets)[i];
+}
+
+static inline size_t
+arrow_ipc_align(size_t size)
+{
+	return (size + ARROW_IPC_ALIGNMENT - 1) & ~(ARROW_IPC_ALIGNMENT - 1);
+}
+
+static inline int64_t
+arrow_ipc_bitmap_size(int64_t bit_count)
+{
+	return (bit_count + CHAR_BIT - 1) / CHAR_BIT;
+}
+
+static int
+arrow_ipc_invalid(const char *reason)
+{
+	diag_set(IllegalParams, "Invalid Arrow IPC stream: %s", reason);
+	return -1;
+}
+
+static int
+arrow_ipc_unsupported(const char *what)
+{
+	diag_set(ClientError, ER_UNSUPPORTED, "Arrow IPC", what);
+	return -1;
+}
+
+/* {{{ Flatbuffers writer */
+
+/**
+ * Flatbuffers builder writing objects front to back: a referencing object
+ * is always written before the referenced one so that all offsets, which
+ * are unsigned, point forward. A vtable is written right before its table.
+ */
+struct fb_builder {
+	/** Buffer with the encoded data. */
+	char *data;
+	/** Size of the encoded data. */
+	size_t size;
+	/** Size of the allocated buffer. */
+	size_t capacity;
+};
+
+/** A field of a table being added. */
+struct fb_field {
+	/** Id of the field in the schema. */
+	uint16_t id;
+	/** Size of the field value: 1, 2, 4 or 8 bytes. */
+	uint16_t size;
+};
+
+static void
+fb_builder_create(struct fb_builder *b)
+{
+	b->data = NULL;
+	b->size = 0;
+	b->capacity = 0;
+}
+
+static void
+fb_builder_destroy(struct fb_builder *b)
+{
+	free(b->data);
+}
+
+/**
+ * Appends @a size zeroed bytes aligned by @a align relative to the buffer
+ * start and returns their position.
+ */
+static size_t
+fb_reserve(struct fb_builder *b, size_t size, size_t align)
+{
+	size_t pos = (b->size + align - 1) & ~(align - 1);
+	size_t new_size = pos + size;
+	if (new_size > b->capacity) {
+		size_t capacity = MAX(b->capacity * 2, (size_t)256);
+		while (capacity < new_size)
+			capacity *= 2;
+		b->data = xrealloc(b->data, capacity);
+		b->capacity = capacity;
+	}
+	memset(b->data + b->size, 0, new_size - b->size);
+	b->size = new_size;
+	return pos;
+}
+
+static inline void
+fb_store_u8(struct fb_builder *b, size_t pos, uint8_t value)
+{
+	store_u8(b->data + pos, value);
+}
+
+static inline void
+fb_store_u16(struct fb_builder *b, size_t pos, uint16_t value)
+{
+	store_u16(b->data + pos, value);
+}
+
+static inline void
+fb_store_u32(struct fb_builder *b, size_t pos, uint32_t value)
+{
+	store_u32(b->data + pos, value);
+}
+
+static inline void
+fb_store_u64(struct fb_builder *b, size_t pos, uint64_t value)
+{
+	store_u64(b->data + pos, value);
+}
+
+/** Makes the offset field at @a pos reference the object at @a target. */
+static inline void
+fb_set_offset(struct fb_builder *b, size_t pos, size_t target)
+{
+	assert(target > pos);
+	fb_store_u32(b, pos, target - pos);
+}
+
+/**
+ * Adds a table with the given fields laid out in the given order. Stores
+ * the positions of the field values in @a pos and returns the position
+ * of the table.
+ */
+static size_t
+fb_add_table(struct fb_builder *b, const struct fb_field *fields,
+	     int field_count, size_t *pos)
+{
+	uint16_t offsets[8];
+	assert(field_count <= (int)lengthof(offsets));
+	uint16_t table_size = sizeof(int32_t);
+	int max_id = -1;
+	for (int i = 0; i < field_count; i++) {
+		uint16_t size = fields[i].size;
+		table_size = (table_size + size - 1) & ~(size - 1);
+		offsets[i] = table_size;
+		table_size += size;
+		max_id = MAX(max_id, (int)fields[i].id);
+	}
+	uint16_t vtable_size = (2 + max_id + 1) * sizeof(uint16_t);
+	size_t vtable = fb_reserve(b, vtable_size, sizeof(uint16_t));
+	fb_store_u16(b, vtable, vtable_size);
+	fb_store_u16(b, vtable + sizeof(uint16_t), table_size);
+	for (int i = 0; i < field_count; i++) {
+		fb_store_u16(b, vtable + (2 + fields[i].id) * sizeof(uint16_t),
+			     offsets[i]);
+	}
+	/* Align tables by 8 so that all fields are naturally aligned. */
+	size_t table = fb_reserve(b, table_size, 8);
+	fb_store_u32(b, table, (uint32_t)(table - vtable));
+	for (int i = 0; i < field_count; i++)
+		pos[i] = table + offsets[i];
+	return table;
+}
+
+/** Adds a table without fields. */
+static size_t
+fb_add_empty_table(struct fb_builder *b)
+{
+	return fb_add_table(b, NULL, 0, NULL);
+}
+
+/**
+ * Adds a vector of @a count elements of @a size bytes aligned by @a align.
+ * Returns the position of the vector length, the elements follow it.
+ */
+static size_t
+fb_add_vector(struct fb_builder *b, uint32_t count, size_t size, size_t align)
+{
+	size_t data = (b->size + sizeof(uint32_t) + align - 1) & ~(align - 1);
+	size_t pos = data - sizeof(uint32_t);
+	fb_reserve(b, data + count * size - b->size, 1);
+	fb_store_u32(b, pos, count);
+	return pos;
+}
+
+static size_t
+fb_add_string(struct fb_builder *b, const char *str, size_t len)
+{
+	size_t pos = fb_reserve(b, sizeof(uint32_t) + len + 1,
+				sizeof(uint32_t));
+	fb_store_u32(b, pos, len);
+	memcpy(b->data + pos + sizeof(uint32_t), str, len);
+	return pos;
+}
+
+/* }}} */
+
+/* {{{ Flatbuffers reader */
+
+/** A table of a flatbuffer being read. */
+struct fb_table {
+	/** The flatbuffer. */
+	const char *data;
+	/** Size of the flatbuffer. */
+	size_t size;
+	/** Position of the table. */
+	size_t pos;
+	/** Position of the table vtable. */
+	size_t vtable;
+	/** Size of the vtable. */
+	uint16_t vtable_size;
+	/** Size of the inline part of the table. */
+	uint16_t table_size;
+};
+
+static int
+fb_invalid(void)
+{
+	return arrow_ipc_invalid("malformed message metadata");
+}
+
+static int
+fb_table_create(struct fb_table *t, const char *data, size_t size, size_t pos)
+{
+	if (size < sizeof(int32_t) || pos > size - sizeof(int32_t))
+		return fb_invalid();
+	int64_t vtable = (int64_t)pos - (int32_t)load_u32(data + pos);
+	if (vtable < 0 || (uint64_t)vtable > size - 2 * sizeof(uint16_t))
+		return fb_invalid();
+	uint16_t vtable_size = load_u16(data + vtable);
+	uint16_t table_size = load_u16(data + vtable + sizeof(uint16_t));
+	if (vtable_size < 2 * sizeof(uint16_t) || vtable_size % 2 != 0 ||
+	    vtable_size > size - vtable || table_size < sizeof(int32_t) ||
+	    table_size > size - pos)
+		return fb_invalid();
+	t->data = data;
+	t->size = size;
+	t->pos = pos;
+	t->vtable = vtable;
+	t->vtable_size = vtable_size;
+	t->table_size = table_size;
+	return 0;
+}
+
+/**
+ * Returns the position of a field value of the given size or 0 if the
+ * field is absent.
+ */
+static size_t
+fb_table_field(const struct fb_table *t, int id, size_t size)
+{
+	size_t entry = (2 + id) * sizeof(uint16_t);
+	if (entry + sizeof(uint16_t) > t->vtable_size)
+		return 0;
+	uint16_t offset = load_u16(t->data + t->vtable + entry);
+	if (offset < sizeof(int32_t) || offset + size > t->table_size)
+		return 0;
+	return t->pos + offset;
+}
+
+/** Reads an integer field or returns @a def if it's absent. */
+static int64_t
+fb_table_int(const struct fb_table *t, int id, size_t size, int64_t def)
+{
+	size_t pos = fb_table_field(t, id, size);
+	if (pos == 0)
+		return def;
+	const char *p = t->data + pos;
+	switch (size) {
+	case 1:
+		return load_u8(p);
+	case 2:
+		return (int16_t)load_u16(p);
+	case 4:
+		return (int32_t)load_u32(p);
+	case 8:
+		return (int64_t)load_u64(p);
+	default:
+		unreachable();
+		return def;
+	}
+}
+
+/** Follows an offset at @a pos, returns false if it's out of bounds. */
+static bool
+fb_follow(const char *data, size_t size, size_t pos, size_t *target)
+{
+	uint32_t offset = load_u32(data + pos);
+	if (offset > size - pos || size - pos - offset < sizeof(uint32_t))
+		return false;
+	*target = pos + offset;
+	return true;
+}
+
+/** Reads a required table field. */
+static int
+fb_table_table(const struct fb_table *t, int id, struct fb_table *table)
+{
+	size_t pos = fb_table_field(t, id, sizeof(uint32_t));
+	if (pos == 0 || !fb_follow(t->data, t->size, pos, &pos))
+		return fb_invalid();
+	return fb_table_create(table, t->data, t->size, pos);
+}
+
+/**
+ * Reads a vector field. An absent vector is treated as empty. Stores the
+ * position of the first element in @a elems.
+ */
+static int
+fb_table_vector(const struct fb_table *t, int id, size_t elem_size,
+		size_t *elems, uint32_t *count)
+{
+	*elems = 0;
+	*count = 0;
+	size_t pos = fb_table_field(t, id, sizeof(uint32_t));
+	if (pos == 0)
+		return 0;
+	if (!fb_follow(t->data, t->size, pos, &pos))
+		return fb_invalid();
+	uint32_t n = load_u32(t->data + pos);
+	pos += sizeof(uint32_t);
+	if ((t->size - pos) / elem_size < n)
+		return fb_invalid();
+	*elems = pos;
+	*count = n;
+	return 0;
+}
+
+/** Reads the @a i-th table of a vector of tables. */
+static int
+fb_vector_table(const struct fb_table *t, size_t elems, uint32_t i,
+		struct fb_table *table)
+{
+	size_t pos = elems + i * sizeof(uint32_t);
+	if (!fb_follow(t->data, t->size, pos, &pos))
+		return fb_invalid();
+	return fb_table_create(table, t->data, t->size, pos);
+}
+
+/* }}} */
+
+/* {{{ Encoder */
+
+/** A column of a record batch being encoded. */
+struct arrow_ipc_column {
+	/** Column type. */
+	const struct arrow_ipc_type *type;
+	/** Column schema. */
+	const struct ArrowSchema *schema;
+	/** Column data. */
+	const struct ArrowArray *array;
+	/** Index of the first value of the batch in the column data. */
+	int64_t offset;
+	/** Number of values. */
+	int64_t length;
+	/** Number of nulls. */
+	int64_t null_count;
+	/** Positions of the buffers in the message body. */
+	struct {
+		int64_t offset;
+		int64_t length;
+	} buffers[3];
+};
+
+/** Counts unset bits in the given range of a bitmap. */
+static int64_t
+arrow_ipc_count_nulls(const void *validity, int64_t offset, int64_t length)
+{
+	int64_t count = 0;
+	for (int64_t i = 0; i < length; i++) {
+		if (!bit_test(validity, offset + i))
+			count++;
+	}
+	return count;
+}
+
+/**
+ * Checks the @a i-th child of a struct array and computes the sizes of
+ * the column buffers, placing them at the end of the body of size
+ * @a body_size.
+ */
+static int
+arrow_ipc_column_create(struct arrow_ipc_column *column,
+			const struct ArrowArray *parent,
+			const struct ArrowSchema *parent_schema, int64_t i,
+			int64_t *body_size)
+{
+	const struct ArrowSchema *schema = parent_schema->children[i];
+	const struct ArrowArray *array = parent->children[i];
+	const struct arrow_ipc_type *type =
+		arrow_ipc_type_by_format(schema->format);
+	if (type == NULL) {
+		return arrow_ipc_unsupported(
+			tt_sprintf("type '%s'", schema->format));
+	}
+	if (schema->dictionary != NULL || array->dictionary != NULL)
+		return arrow_ipc_unsupported("dictionary encoding");
+	int buffer_count = arrow_ipc_type_buffer_count(type);
+	if (array->n_buffers != buffer_count || array->offset < 0 ||
+	    array->length < parent->offset + parent->length)
+		return arrow_ipc_invalid("bad column array");
+
+	int64_t offset = array->offset + parent->offset;
+	int64_t length = parent->length;
+	int64_t null_count = 0;
+	int64_t sizes[3] = {0, 0, 0};
+	if (type->type_id == ARROW_IPC_TYPE_NULL) {
+		null_count = length;
+	} else {
+		const void *validity = array->buffers[0];
+		if (validity != NULL && array->null_count != 0)
+			null_count = arrow_ipc_count_nulls(validity, offset,
+							   length);
+		if (null_count > 0)
+			sizes[0] = arrow_ipc_bitmap_size(length);
+	}
+	if (arrow_ipc_type_is_var(type)) {
+		const void *offsets = array->buffers[1];
+		if (offsets == NULL && array->length > 0)
+			return arrow_ipc_invalid("bad column array");
+		int64_t begin = arrow_ipc_load_offset(type, offsets, offset);
+		int64_t end = arrow_ipc_load_offset(type, offsets,
+						    offset + length);
+		if (begin < 0 || end < begin ||
+		    (end > begin && array->buffers[2] == NULL))
+			return arrow_ipc_invalid("bad column array");
+		sizes[1] = (length + 1) * type->bit_width / CHAR_BIT;
+		sizes[2] = end - begin;
+	} else if (type->type_id != ARROW_IPC_TYPE_NULL) {
+		if (array->buffers[1] == NULL && length > 0)
+			return arrow_ipc_invalid("bad column array");
+		sizes[1] = arrow_ipc_bitmap_size(length * type->bit_width);
+	}
+	column->type = type;
+	column->schema = schema;
+	column->array = array;
+	column->offset = offset;
+	column->length = length;
+	column->null_count = null_count;
+	for (int j = 0; j < buffer_count; j++) {
+		column->buffers[j].offset = *body_size;
+		column->buffers[j].length = sizes[j];
+		*body_size += arrow_ipc_align(sizes[j]);
+	}
+	return 0;
+}
+
+/** Copies a range of a bitmap to the zeroed destination. */
+static void
+arrow_ipc_copy_bitmap(char *dst, const void *src, int64_t offset,
+		      int64_t length)
+{
+	if (offset % CHAR_BIT == 0) {
+		memcpy(dst, (const char *)src + offset / CHAR_BIT,
+		       arrow_ipc_bitmap_size(length));
+		if (length % CHAR_BIT != 0) {
+			dst[length / CHAR_BIT] &=
+				(1 << (length % CHAR_BIT)) - 1;
+		}
+		return;
+	}
+	for (int64_t i = 0; i < length; i++) {
+		if (bit_test(src, offset + i))
+			bit_set(dst, i);
+	}
+}
+
+/** Writes the column buffers to the zeroed message body. */
+static void
+arrow_ipc_column_write(const struct arrow_ipc_column *column, char *body)
+{
+	const struct arrow_ipc_type *type = column->type;
+	const struct ArrowArray *array = column->array;
+	int64_t offset = column->offset;
+	int64_t length = column->length;
+	if (type->type_id == ARROW_IPC_TYPE_NULL)
+		return;
+	if (column->null_count > 0) {
+		arrow_ipc_copy_bitmap(body + column->buffers[0].offset,
+				      array->buffers[0], offset, length);
+	}
+	char *data = body + column->buffers[1].offset;
+	if (arrow_ipc_type_is_var(type)) {
+		/* Rebase the offsets so that the first one is zero. */
+		const void *offsets = array->buffers[1];
+		int64_t begin = arrow_ipc_load_offset(type, offsets, offset);
+		for (int64_t i = 0; i <= length; i++) {
+			int64_t value = arrow_ipc_load_offset(
+				type, offsets, offset + i) - begin;
+			if (type->bit_width == 32)
+				store_u32(data + i * 4, (uint32_t)value);
+			else
+				store_u64(data + i * 8, (uint64_t)value);
+		}
+		if (column->buffers[2].length > 0) {
+			memcpy(body + column->buffers[2].offset,
+			       (const char *)array->buffers[2] + begin,
+			       column->buffers[2].length);
+		}
+	} else if (type->type_id == ARROW_IPC_TYPE_BOOL) {
+		if (length > 0) {
+			arrow_ipc_copy_bitmap(data, array->buffers[1],
+					      offset, length);
+		}
+	} else if (length > 0) {
+		memcpy(data, (const char *)array->buffers[1] +
+		       offset * type->bit_width / CHAR_BIT,
+		       column->buffers[1].length);
+	}
+}
+
+/**
+ * Adds the root Message table to an empty builder. Returns the position
+ * of the header offset field.
+ */
+static size_t
+arrow_ipc_add_message(struct fb_builder *b, uint8_t header_type,
+		      int64_t body_length)
+{
+	size_t root = fb_reserve(b, sizeof(uint32_t), sizeof(uint32_t));
+	static const struct fb_field fields[] = {
+		{FB_MESSAGE_BODY_LENGTH, 8},
+		{FB_MESSAGE_HEADER, 4},
+		{FB_MESSAGE_VERSION, 2},
+		{FB_MESSAGE_HEADER_TYPE, 1},
+	};
+	size_t pos[lengthof(fields)];
+	size_t message = fb_add_table(b, fields, lengthof(fields), pos);
+	fb_set_offset(b, root, message);
+	fb_store_u64(b, pos[0], body_length);
+	fb_store_u16(b, pos[2], ARROW_IPC_METADATA_VERSION_V5);
+	fb_store_u8(b, pos[3], header_type);
+	return pos[1];
+}
+
+/** Adds the Type table of a column to the builder. */
+static size_t
+arrow_ipc_add_type(struct fb_builder *b, const struct arrow_ipc_type *type)
+{
+	size_t pos[2];
+	size_t table;
+	switch (type->type_id) {
+	case ARROW_IPC_TYPE_INT: {
+		static const struct fb_field fields[] = {
+			{FB_INT_BIT_WIDTH, 4},
+			{FB_INT_IS_SIGNED, 1},
+		};
+		table = fb_add_table(b, fields, lengthof(fields), pos);
+		fb_store_u32(b, pos[0], type->bit_width);
+		fb_store_u8(b, pos[1], type->is_signed);
+		return table;
+	}
+	case ARROW_IPC_TYPE_FLOATING_POINT: {
+		static const struct fb_field fields[] = {
+			{FB_FLOATING_POINT_PRECISION, 2},
+		};
+		table = fb_add_table(b, fields, lengthof(fields), pos);
+		fb_store_u16(b, pos[0], type->bit_width == 32 ?
+			     ARROW_IPC_PRECISION_SINGLE :
+			     ARROW_IPC_PRECISION_DOUBLE);
+		return table;
+	}
+	default:
+		return fb_add_empty_table(b);
+	}
+}
+
+/** Encodes the schema message metadata. */
+static void
+arrow_ipc_encode_schema(struct fb_builder *b,
+			const struct arrow_ipc_column *columns,
+			int64_t column_count)
+{
+	size_t header = arrow_ipc_add_message(b, ARROW_IPC_HEADER_SCHEMA, 0);
+	static const struct fb_field schema_fields[] = {
+		{FB_SCHEMA_FIELDS, 4},
+		{FB_SCHEMA_ENDIANNESS, 2},
+	};
+	size_t schema_pos[lengthof(schema_fields)];
+	size_t schema = fb_add_table(b, schema_fields, lengthof(schema_fields),
+				     schema_pos);
+	fb_set_offset(b, header, schema);
+	size_t fields = fb_add_vector(b, column_count, sizeof(uint32_t),
+				      sizeof(uint32_t));
+	fb_set_offset(b, schema_pos[0], fields);
+	for (int64_t i = 0; i < column_count; i++) {
+		const struct arrow_ipc_column *column = &columns[i];
+		static const struct fb_field field_fields[] = {
+			{FB_FIELD_NAME, 4},
+			{FB_FIELD_TYPE, 4},
+			{FB_FIELD_CHILDREN, 4},
+			{FB_FIELD_NULLABLE, 1},
+			{FB_FIELD_TYPE_TYPE, 1},
+		};
+		size_t pos[lengthof(field_fields)];
+		size_t field = fb_add_table(b, field_fields,
+					    lengthof(field_fields), pos);
+		fb_set_offset(b, fields + sizeof(uint32_t) * (i + 1), field);
+		fb_store_u8(b, pos[3], (column->schema->flags &
+					ARROW_FLAG_NULLABLE) != 0);
+		fb_store_u8(b, pos[4], column->type->type_id);
+		const char *name = column->schema->name;
+		if (name == NULL)
+			name = "";
+		fb_set_offset(b, pos[0], fb_add_string(b, name, strlen(name)));
+		fb_set_offset(b, pos[1], arrow_ipc_add_type(b, column->type));
+		fb_set_offset(b, pos[2], fb_add_vector(b, 0, sizeof(uint32_t),
+						       sizeof(uint32_t)));
+	}
+}
+
+/** Encodes the record batch message metadata. */
+static void
+arrow_ipc_encode_record_batch(struct fb_builder *b,
+			      const struct arrow_ipc_column *columns,
+			      int64_t column_count, int64_t length,
+			      int64_t body_size)
+{
+	size_t header = arrow_ipc_add_message(b, ARROW_IPC_HEADER_RECORD_BATCH,
+					      body_size);
+	static const struct fb_field batch_fields[] = {
+		{FB_RECORD_BATCH_LENGTH, 8},
+		{FB_RECORD_BATCH_NODES, 4},
+		{FB_RECORD_BATCH_BUFFERS, 4},
+	};
+	size_t pos[lengthof(batch_fields)];
+	size_t batch = fb_add_table(b, batch_fields, lengthof(batch_fields),
+				    pos);
+	fb_set_offset(b, header, batch);
+	fb_store_u64(b, pos[0], length);
+	size_t nodes = fb_add_vector(b, column_count, FB_STRUCT_SIZE, 8);
+	fb_set_offset(b, pos[1], nodes);
+	uint32_t buffer_count = 0;
+	for (int64_t i = 0; i < column_count; i++) {
+		size_t node = nodes + sizeof(uint32_t) + i * FB_STRUCT_SIZE;
+		fb_store_u64(b, node, columns[i].length);
+		fb_store_u64(b, node + 8, columns[i].null_count);
+		buffer_count += arrow_ipc_type_buffer_count(columns[i].type);
+	}
+	size_t buffers = fb_add_vector(b, buffer_count, FB_STRUCT_SIZE, 8);
+	fb_set_offset(b, pos[2], buffers);
+	size_t buffer = buffers + sizeof(uint32_t);
+	for (int64_t i = 0; i < column_count; i++) {
+		int count = arrow_ipc_type_buffer_count(columns[i].type);
+		for (int j = 0; j < count; j++) {
+			fb_store_u64(b, buffer, columns[i].buffers[j].offset);
+			fb_store_u64(b, buffer + 8,
+				     columns[i].buffers[j].length);
+			buffer += FB_STRUCT_SIZE;
+		}
+	}
+}
+
+/** Size of an encapsulated message with the given metadata. */
+static size_t
+arrow_ipc_message_size(const struct fb_builder *b)
+{
+	return 2 * sizeof(uint32_t) + arrow_ipc_align(b->size);
+}
+
+/** Writes the message prefix and metadata, returns the body position. */
+static char *
+arrow_ipc_write_message(char *pos, const struct fb_builder *b)
+{
+	store_u32(pos, ARROW_IPC_CONTINUATION);
+	store_u32(pos + sizeof(uint32_t), arrow_ipc_align(b->size));
+	memcpy(pos + 2 * sizeof(uint32_t), b->data, b->size);
+	return pos + arrow_ipc_message_size(b);
+}
+
+int
+arrow_ipc_encode(struct ArrowArray *array, struct ArrowSchema *schema,
+		 struct region *region, const char **ret_data,
+		 const char **ret_data_end)
+{
+	if (strcmp(schema->format, "+s") != 0)
+		return arrow_ipc_unsupported(
+			tt_sprintf("top-level type '%s'", schema->format));
+	if (array->n_children != schema->n_children ||
+	    array->offset < 0 || array->length < 0 ||
+	    (array->null_count != 0 && array->n_buffers > 0 &&
+	     array->buffers[0] != NULL))
+		return arrow_ipc_invalid("bad struct array");
+
+	int rc = -1;
+	int64_t column_count = schema->n_children;
+	struct arrow_ipc_column *columns =
+		xcalloc(MAX(column_count, 1), sizeof(*columns));
+	struct fb_builder schema_fb, batch_fb;
+	fb_builder_create(&schema_fb);
+	fb_builder_create(&batch_fb);
+	int64_t body_size = 0;
+	for (int64_t i = 0; i < column_count; i++) {
+		if (arrow_ipc_column_create(&columns[i], array, schema, i,
+					    &body_size) != 0)
+			goto out;
+	}
+	arrow_ipc_encode_schema(&schema_fb, columns, column_count);
+	arrow_ipc_encode_record_batch(&batch_fb, columns, column_count,
+				      array->length, body_size);
+
+	size_t size = arrow_ipc_message_size(&schema_fb) +
+		      arrow_ipc_message_size(&batch_fb) + body_size +
+		      2 * sizeof(uint32_t);
+	char *data = xregion_aligned_alloc(region, size, ARROW_IPC_ALIGNMENT);
+	memset(data, 0, size);
+	char *pos = arrow_ipc_write_message(data, &schema_fb);
+	pos = arrow_ipc_write_message(pos, &batch_fb);
+	for (int64_t i = 0; i < column_count; i++)
+		arrow_ipc_column_write(&columns[i], pos);
+	pos += body_size;
+	/* End-of-stream marker. */
+	store_u32(pos, ARROW_IPC_CONTINUATION);
+	store_u32(pos + sizeof(uint32_t), 0);
+	pos += 2 * sizeof(uint32_t);
+	assert(pos == data + size);
+	*ret_data = data;
+	*ret_data_end = pos;
+	rc = 0;
+out:
+	fb_builder_destroy(&batch_fb);
+	fb_builder_destroy(&schema_fb);
+	free(columns);
+	return rc;
+}
+
+/* }}} */
+
+/* {{{ Decoder */
+
+/** An encapsulated message of an Arrow IPC stream. */
+struct arrow_ipc_message {
+	/** Set if the end of the stream was reached. */
+	bool is_eos;
+	/** Type of the message header. */
+	uint8_t header_type;
+	/** Message header. */
+	struct fb_table header;
+	/** Message body. */
+	const char *body;
+	/** Size of the message body. */
+	int64_t body_size;
+};
+
+/** Reads the next message of a stream. */
+static int
+arrow_ipc_read_message(const char **data, const char *data_end,
+		       struct arrow_ipc_message *msg)
+{
+	const char *pos = *data;
+	memset(msg, 0, sizeof(*msg));
+	/* The end-of-stream marker is optional. */
+	if (pos == data_end) {
+		msg->is_eos = true;
+		return 0;
+	}
+	if (data_end - pos < (ptrdiff_t)sizeof(uint32_t))
+		return arrow_ipc_invalid("truncated message");
+	uint32_t size = load_u32(pos);
+	pos += sizeof(uint32_t);
+	/* Streams written before Arrow 0.15 lack the continuation marker. */
+	if (size == ARROW_IPC_CONTINUATION) {
+		if (data_end - pos < (ptrdiff_t)sizeof(uint32_t))
+			return arrow_ipc_invalid("truncated message");
+		size = load_u32(pos);
+		pos += sizeof(uint32_t);
+	}
+	if (size == 0) {
+		msg->is_eos = true;
+		*data = pos;
+		return 0;
+	}
+	if (size > (size_t)(data_end - pos) || size < sizeof(uint32_t))
+		return arrow_ipc_invalid("truncated message");
+	const char *metadata = pos;
+	pos += size;
+	struct fb_table message;
+	if (fb_table_create(&message, metadata, size, load_u32(metadata)) != 0)
+		return -1;
+	int64_t version = fb_table_int(&message, FB_MESSAGE_VERSION, 2, 0);
+	if (version < ARROW_IPC_METADATA_VERSION_V4)
+		return arrow_ipc_unsupported("metadata version < V4");
+	msg->header_type = fb_table_int(&message, FB_MESSAGE_HEADER_TYPE, 1, 0);
+	if (fb_table_table(&message, FB_MESSAGE_HEADER, &msg->header) != 0)
+		return -1;
+	int64_t body_size = fb_table_int(&message, FB_MESSAGE_BODY_LENGTH,
+					 8, 0);
+	if (body_size < 0 || body_size > data_end - pos)
+		return arrow_ipc_invalid("truncated message");
+	msg->body = pos;
+	msg->body_size = body_size;
+	*data = pos + body_size;
+	return 0;
+}
+
+/** Private data of a decoded schema. */
+struct arrow_ipc_schema_data {
+	/** Child schemas. */
+	struct ArrowSchema *children;
+	/** Pointers to the child schemas. */
+	struct ArrowSchema **child_ptrs;
+};
+
+static void
+arrow_ipc_child_schema_release(struct ArrowSchema *schema)
+{
+	free((char *)schema->name);
+	schema->release = NULL;
+}
+
+static void
+arrow_ipc_schema_release(struct ArrowSchema *schema)
+{
+	struct arrow_ipc_schema_data *data = schema->private_data;
+	for (int64_t i = 0; i < schema->n_children; i++) {
+		struct ArrowSchema *child = schema->children[i];
+		if (child->release != NULL)
+			child->release(child);
+	}
+	free(data->children);
+	free(data->child_ptrs);
+	free(data);
+	schema->release = NULL;
+}
+
+/** Decodes the Field table describing a column. */
+static int
+arrow_ipc_decode_field(const struct fb_table *field, struct ArrowSchema *schema)
+{
+	size_t elems;
+	uint32_t count;
+	if (fb_table_field(field, FB_FIELD_DICTIONARY, sizeof(uint32_t)) != 0)
+		return arrow_ipc_unsupported("dictionary encoding");
+	if (fb_table_vector(field, FB_FIELD_CHILDREN, sizeof(uint32_t),
+			    &elems, &count) != 0)
+		return -1;
+	if (count != 0)
+		return arrow_ipc_unsupported("nested types");
+	if (fb_table_vector(field, FB_FIELD_NAME, 1, &elems, &count) != 0)
+		return -1;
+	const char *name = field->data + elems;
+	uint32_t name_len = count;
+	uint8_t type_id = fb_table_int(field, FB_FIELD_TYPE_TYPE, 1, 0);
+	struct fb_table type_table;
+	if (fb_table_table(field, FB_FIELD_TYPE, &type_table) != 0)
+		return -1;
+	int bit_width = 0;
+	bool is_signed = false;
+	if (type_id == ARROW_IPC_TYPE_INT) {
+		bit_width = fb_table_int(&type_table, FB_INT_BIT_WIDTH, 4, 0);
+		is_signed = fb_table_int(&type_table, FB_INT_IS_SIGNED,
+					 1, 0) != 0;
+	} else if (type_id == ARROW_IPC_TYPE_FLOATING_POINT) {
+		int64_t precision = fb_table_int(&type_table,
+						 FB_FLOATING_POINT_PRECISION,
+						 2, 0);
+		if (precision == ARROW_IPC_PRECISION_SINGLE)
+			bit_width = 32;
+		else if (precision == ARROW_IPC_PRECISION_DOUBLE)
+			bit_width = 64;
+	}
+	const struct arrow_ipc_type *type =
+		arrow_ipc_type_by_id(type_id, bit_width, is_signed);
+	if (type == NULL) {
+		return arrow_ipc_unsupported(
+			tt_sprintf("type of field '%.*s'", (int)name_len,
+				   name));
+	}
+	schema->format = type->format;
+	schema->name = xstrndup(name, name_len);
+	schema->release = arrow_ipc_child_schema_release;
+	if (fb_table_int(field, FB_FIELD_NULLABLE, 1, 0) != 0)
+		schema->flags |= ARROW_FLAG_NULLABLE;
+	return 0;
+}
+
+/** Decodes the Schema table into a struct schema. */
+static int
+arrow_ipc_decode_schema(const struct fb_table *header,
+			struct ArrowSchema *schema)
+{
+	if (fb_table_int(header, FB_SCHEMA_ENDIANNESS, 2, 0) != 0)
+		return arrow_ipc_unsupported("big-endian data");
+	size_t fields;
+	uint32_t count;
+	if (fb_table_vector(header, FB_SCHEMA_FIELDS, sizeof(uint32_t),
+			    &fields, &count) != 0)
+		return -1;
+	struct arrow_ipc_schema_data *data = xmalloc(sizeof(*data));
+	data->children = xcalloc(MAX(count, 1), sizeof(*data->children));
+	data->child_ptrs = xcalloc(MAX(count, 1), sizeof(*data->child_ptrs));
+	memset(schema, 0, sizeof(*schema));
+	schema->format = "+s";
+	schema->name = "";
+	schema->n_children = count;
+	schema->children = data->child_ptrs;
+	schema->release = arrow_ipc_schema_release;
+	schema->private_data = data;
+	for (uint32_t i = 0; i < count; i++)
+		data->child_ptrs[i] = &data->children[i];
+	for (uint32_t i = 0; i < count; i++) {
+		struct fb_table field;
+		if (fb_vector_table(header, fields, i, &field) != 0 ||
+		    arrow_ipc_decode_field(&field, schema->children[i]) != 0) {
+			schema->release(schema);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/** Private data of a decoded record batch. */
+struct arrow_ipc_array_data {
+	/** Copy of the record batch body with aligned buffers. */
+	char *body;
+	/** Child arrays. */
+	struct ArrowArray *children;
+	/** Pointers to the child arrays. */
+	struct ArrowArray **child_ptrs;
+	/** Buffers of the child arrays, three per child. */
+	const void **buffers;
+	/** Buffers of the struct array. */
+	const void *struct_buffers[1];
+};
+
+/** Offsets of an empty variable-length array without an offsets buffer. */
+static const int64_t arrow_ipc_empty_offsets[1] = {0};
+
+static void
+arrow_ipc_child_array_release(struct ArrowArray *array)
+{
+	array->release = NULL;
+}
+
+static void
+arrow_ipc_array_release(struct ArrowArray *array)
+{
+	struct arrow_ipc_array_data *data = array->private_data;
+	for (int64_t i = 0; i < array->n_children; i++) {
+		struct ArrowArray *child = array->children[i];
+		if (child->release != NULL)
+			child->release(child);
+	}
+	free(data->body);
+	free(data->children);
+	free(data->child_ptrs);
+	free(data->buffers);
+	free(data);
+	array->release = NULL;
+}
+
+/**
+ * Creates a struct array of the given length with @a column_count empty
+ * children and allocates @a body_size bytes for the buffers.
+ * Returns -1 and sets diag if the buffers can't be allocated.
+ */
+static int
+arrow_ipc_array_create(struct ArrowArray *array, int64_t length,
+		       int64_t column_count, size_t body_size)
+{
+	char *body = NULL;
+	if (body_size > 0) {
+		body = malloc(body_size);
+		if (body == NULL) {
+			diag_set(OutOfMemory, body_size, "malloc",
+				 "record batch body");
+			return -1;
+		}
+	}
+	struct arrow_ipc_array_data *data = xmalloc(sizeof(*data));
+	size_t count = MAX(column_count, 1);
+	data->body = body;
+	data->children = xcalloc(count, sizeof(*data->children));
+	data->child_ptrs = xcalloc(count, sizeof(*data->child_ptrs));
+	data->buffers = xcalloc(3 * count, sizeof(*data->buffers));
+	data->struct_buffers[0] = NULL;
+	memset(array, 0, sizeof(*array));
+	array->length = length;
+	array->n_buffers = 1;
+	array->buffers = data->struct_buffers;
+	array->n_children = column_count;
+	array->children = data->child_ptrs;
+	array->release = arrow_ipc_array_release;
+	array->private_data = data;
+	for (int64_t i = 0; i < column_count; i++) {
+		struct ArrowArray *child = &data->children[i];
+		child->buffers = &data->buffers[3 * i];
+		child->release = arrow_ipc_child_array_release;
+		data->child_ptrs[i] = child;
+	}
+	return 0;
+}
+
+/**
+ * Checks that the buffers of a decoded column of the given type are big
+ * enough for its length and the offsets are valid.
+ */
+static int
+arrow_ipc_check_column(const struct arrow_ipc_type *type,
+		       struct ArrowArray *array, const int64_t *sizes)
+{
+	int64_t length = array->length;
+	if (type->type_id == ARROW_IPC_TYPE_NULL) {
+		array->null_count = length;
+		return 0;
+	}
+	if (array->null_count == 0)
+		array->buffers[0] = NULL;
+	else if (sizes[0] < arrow_ipc_bitmap_size(length))
+		return arrow_ipc_invalid("validity buffer is too short");
+	if (!arrow_ipc_type_is_var(type)) {
+		if (sizes[1] < arrow_ipc_bitmap_size(length * type->bit_width))
+			return arrow_ipc_invalid("data buffer is too short");
+		return 0;
+	}
+	if (sizes[1] == 0 && length == 0) {
+		array->buffers[1] = arrow_ipc_empty_offsets;
+		return 0;
+	}
+	if (sizes[1] < (length + 1) * type->bit_width / CHAR_BIT)
+		return arrow_ipc_invalid("offsets buffer is too short");
+	const void *offsets = array->buffers[1];
+	int64_t prev = arrow_ipc_load_offset(type, offsets, 0);
+	if (prev < 0)
+		return arrow_ipc_invalid("bad offsets");
+	for (int64_t i = 1; i <= length; i++) {
+		int64_t next = arrow_ipc_load_offset(type, offsets, i);
+		if (next < prev)
+			return arrow_ipc_invalid("bad offsets");
+		prev = next;
+	}
+	if (prev > sizes[2])
+		return arrow_ipc_invalid("data buffer is too short");
+	return 0;
+}
+
+/** Creates a struct array without rows for a stream with no batches. */
+static void
+arrow_ipc_decode_empty(const struct ArrowSchema *schema,
+		       struct ArrowArray *array)
+{
+	VERIFY(arrow_ipc_array_create(array, 0, schema->n_children, 0) == 0);
+	for (int64_t i = 0; i < schema->n_children; i++) {
+		const struct arrow_ipc_type *type =
+			arrow_ipc_type_by_format(schema->children[i]->format);
+		struct ArrowArray *child = array->children[i];
+		child->n_buffers = arrow_ipc_type_buffer_count(type);
+		if (arrow_ipc_type_is_var(type))
+			child->buffers[1] = arrow_ipc_empty_offsets;
+	}
+}
+
+/** Decodes the RecordBatch table and the message body into a struct array. */
+static int
+arrow_ipc_decode_record_batch(const struct arrow_ipc_message *msg,
+			      const struct ArrowSchema *schema,
+			      struct ArrowArray *array)
+{
+	const struct fb_table *header = &msg->header;
+	if (fb_table_field(header, FB_RECORD_BATCH_COMPRESSION,
+			   sizeof(uint32_t)) != 0)
+		return arrow_ipc_unsupported("compressed record batches");
+	int64_t length = fb_table_int(header, FB_RECORD_BATCH_LENGTH, 8, 0);
+	if (length < 0 || length > INT32_MAX)
+		return arrow_ipc_invalid("bad record batch length");
+	size_t nodes, buffers;
+	uint32_t node_count, buffer_count;
+	if (fb_table_vector(header, FB_RECORD_BATCH_NODES, FB_STRUCT_SIZE,
+			    &nodes, &node_count) != 0 ||
+	    fb_table_vector(header, FB_RECORD_BATCH_BUFFERS, FB_STRUCT_SIZE,
+			    &buffers, &buffer_count) != 0)
+		return -1;
+	if (node_count != schema->n_children)
+		return arrow_ipc_invalid("field count mismatch");
+	uint32_t expected_buffer_count = 0;
+	for (int64_t i = 0; i < schema->n_children; i++) {
+		const struct arrow_ipc_type *type =
+			arrow_ipc_type_by_format(schema->children[i]->format);
+		expected_buffer_count += arrow_ipc_type_buffer_count(type);
+	}
+	if (buffer_count != expected_buffer_count)
+		return arrow_ipc_invalid("buffer count mismatch");
+	/*
+	 * Copy the buffers so that they are properly aligned and don't
+	 * reference the input.
+	 */
+	const char *data = header->data;
+	size_t body_size = 0;
+	for (uint32_t i = 0; i < buffer_count; i++) {
+		size_t pos = buffers + i * FB_STRUCT_SIZE;
+		int64_t offset = load_u64(data + pos);
+		int64_t size = load_u64(data + pos + 8);
+		if (offset < 0 || size < 0 || offset > msg->body_size ||
+		    size > msg->body_size - offset)
+			return arrow_ipc_invalid("buffer is out of body");
+		body_size += arrow_ipc_align(size);
+	}
+	/*
+	 * Buffers may overlap, so the sum of their sizes isn't limited by
+	 * the body size. Don't let a small message make us allocate much
+	 * more memory than it takes.
+	 */
+	if (body_size > (size_t)msg->body_size +
+	    (size_t)buffer_count * ARROW_IPC_ALIGNMENT)
+		return arrow_ipc_invalid("buffers overlap");
+	if (arrow_ipc_array_create(array, length, schema->n_children,
+				   body_size) != 0)
+		return -1;
+	struct arrow_ipc_array_data *array_data = array->private_data;
+	char *dst = array_data->body;
+	size_t buffer = buffers;
+	for (int64_t i = 0; i < schema->n_children; i++) {
+		const struct arrow_ipc_type *type =
+			arrow_ipc_type_by_format(schema->children[i]->format);
+		struct ArrowArray *child = array->children[i];
+		size_t node = nodes + i * FB_STRUCT_SIZE;
+		int64_t node_length = load_u64(data + node);
+		int64_t null_count = load_u64(data + node + 8);
+		if (node_length != length || null_count < 0 ||
+		    null_count > length) {
+			array->release(array);
+			return arrow_ipc_invalid("bad field node");
+		}
+		child->length = length;
+		child->null_count = null_count;
+		child->n_buffers = arrow_ipc_type_buffer_count(type);
+		int64_t sizes[3] = {0, 0, 0};
+		for (int j = 0; j < child->n_buffers; j++) {
+			int64_t offset = load_u64(data + buffer);
+			int64_t size = load_u64(data + buffer + 8);
+			buffer += FB_STRUCT_SIZE;
+			sizes[j] = size;
+			if (size == 0)
+				continue;
+			memcpy(dst, msg->body + offset, size);
+			child->buffers[j] = dst;
+			dst += arrow_ipc_align(size);
+		}
+		if (arrow_ipc_check_column(type, child, sizes) != 0) {
+			array->release(array);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+int
+arrow_ipc_decode(struct ArrowArray *array, struct ArrowSchema *schema,
+		 const char *data, const char *data_end)
+{
+	struct arrow_ipc_message msg;
+	if (arrow_ipc_read_message(&data, data_end, &msg) != 0)
+		return -1;
+	if (msg.is_eos || msg.header_type != ARROW_IPC_HEADER_SCHEMA)
+		return arrow_ipc_invalid("schema message expected");
+	if (arrow_ipc_decode_schema(&msg.header, schema) != 0)
+		return -1;
+	if (arrow_ipc_read_message(&data, data_end, &msg) != 0)
+		goto fail;
+	if (msg.is_eos) {
+		arrow_ipc_decode_empty(schema, array);
+		return 0;
+	}
+	if (msg.header_type == ARROW_IPC_HEADER_DICTIONARY_BATCH) {
+		arrow_ipc_unsupported("dictionary encoding");
+		goto fail;
+	}
+	if (msg.header_type != ARROW_IPC_HEADER_RECORD_BATCH) {
+		arrow_ipc_invalid("record batch message expected");
+		goto fail;
+	}
+	if (arrow_ipc_decode_record_batch(&msg, schema, array) != 0)
+		goto fail;
+	if (arrow_ipc_read_message(&data, data_end, &msg) != 0)
+		goto fail_array;
+	if (!msg.is_eos) {
+		arrow_ipc_unsupported("multiple record batches");
+		goto fail_array;
+	}
+	return 0;
+fail_array:
+	array->release(array);
+fail:
+	schema->release(schema);
+	return -1;
+}
+
+/* }}} */
@@ -12,8 +12,6 @@
 #else /* !defined(ENABLE_ARROW_IPC) */
 
 #include "arrow/abi.h"
-#include "diag.h"
-#include "error.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -21,31 +19,29 @@ extern "C" {
 
 struct region;
 
-static inline int
+/**
+ * Encodes a record batch given in the Arrow C data interface format as an
+ * Arrow IPC stream consisting of a schema message, a single record batch
+ * message and the end-of-stream marker. The top-level array must be of
+ * the struct type. The stream is allocated on @a region.
+ *
+ * Returns 0 on success, -1 on error (diag is set).
+ */
+int
 arrow_ipc_encode(struct ArrowArray *array, struct ArrowSchema *schema,
 		 struct region *region, const char **ret_data,
-		 const char **ret_data_end)
-{
-	(void)array;
-	(void)schema;
-	(void)region;
-	(void)ret_data;
-	(void)ret_data_end;
-	diag_set(ClientError, ER_UNSUPPORTED, "CE version", "arrow format");
-	return -1;
-}
-
-static inline int
+		 const char **ret_data_end);
+
+/**
+ * Decodes an Arrow IPC stream containing at most one record batch into
+ * a struct array and its schema. The decoded data doesn't reference the
+ * input buffer and must be released with the release callbacks.
+ *
+ * Returns 0 on success, -1 on error (diag is set).
+ */
+int
 arrow_ipc_decode(struct ArrowArray *array, struct ArrowSchema *schema,
-		 const char *data, const char *data_end)
-{
-	(void)array;
-	(void)schema;
-	(void)data;
-	(void)data_end;
-	diag_set(ClientError, ER_UNSUPPORTED, "CE version", "arrow format");
-	return -1;
-}
+		 const char *data, const char *data_end);
 
 #if defined(__cplusplus)
 } /* extern "C" */
@@ -0,0 +1,46 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iterator_type.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+enum {
+	/** Default max number of rows in an Arrow record batch. */
+	ARROW_OPTIONS_DEFAULT_BATCH_ROW_COUNT = 4096,
+};
+
+/** Options of an Arrow stream over an index. */
+struct arrow_options {
+	/** Iterator type. */
+	enum iterator_type iterator;
+	/** Max number of rows in a record batch. */
+	uint32_t batch_row_count;
+	/**
+	 * Use the string view and binary view types instead of the string
+	 * and binary types for string and varbinary columns.
+	 */
+	bool force_view_types;
+};
+
+/** Initializes Arrow stream options with default values. */
+static inline void
+arrow_options_create(struct arrow_options *options)
+{
+	options->iterator = ITER_GE;
+	options->batch_row_count = ARROW_OPTIONS_DEFAULT_BATCH_ROW_COUNT;
+	options->force_view_types = false;
+}
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
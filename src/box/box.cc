@@ -44,6 +44,7 @@
 #include "app_threads.h"
 #include "iproto.h"
 #include "iproto_constants.h"
+#include "net_box_io.h"
 #include "recovery.h"
 #include "wal.h"
 #include "relay.h"
@@ -1674,6 +1675,19 @@ box_check_replication_synchro_timeout(void)
 	return timeout;
 }
 
+static double
+box_check_replication_synchro_confirm_delay(void)
+{
+	double delay = cfg_getd("replication_synchro_confirm_delay");
+	if (delay < 0) {
+		diag_set(ClientError, ER_CFG,
+			 "replication_synchro_confirm_delay",
+			 "the value must be greater than or equal to zero");
+		return -1;
+	}
+	return delay;
+}
+
 static double
 box_check_replication_sync_timeout(void)
 {
@@ -1990,6 +2004,25 @@ box_check_checkpoint_count(int checkpoint_count)
 	}
 }
 
+static void
+box_check_snap_compress_threads(int thread_count)
+{
+	if (thread_count < 1 || thread_count > XLOG_COMPRESS_THREADS_MAX) {
+		tnt_raise(ClientError, ER_CFG, "snap_compress_threads",
+			  tt_sprintf("must be greater than 0 and less than or"
+				     " equal to %d", XLOG_COMPRESS_THREADS_MAX));
+	}
+}
+
+static void
+box_check_snap_delta_count(int count)
+{
+	if (count < 0) {
+		tnt_raise(ClientError, ER_CFG, "snap_delta_count",
+			  "the value must be greater than or equal to zero");
+	}
+}
+
 static int64_t
 box_check_wal_max_size(int64_t wal_max_size)
 {
@@ -2156,6 +2189,36 @@ box_check_iproto_options(void)
 	return 0;
 }
 
+static double
+box_check_iproto_stale_read_max_lag(void)
+{
+	double lag = cfg_getd("iproto_stale_read_max_lag");
+	if (lag < 0) {
+		diag_set(ClientError, ER_CFG, "iproto_stale_read_max_lag",
+			 "the value must be greater than or equal to zero");
+		return -1;
+	}
+	return lag;
+}
+
+/**
+ * Checks the value of the box.cfg.net_box_io_threads.
+ */
+static int
+box_check_net_box_io_threads(void)
+{
+	int net_box_io_threads = cfg_geti("net_box_io_threads");
+	if (net_box_io_threads < 0 ||
+	    net_box_io_threads > NET_BOX_IO_THREADS_MAX) {
+		diag_set(ClientError, ER_CFG, "net_box_io_threads",
+			 tt_sprintf("must be greater than or equal to 0 "
+				    "and less than or equal to %d",
+				    NET_BOX_IO_THREADS_MAX));
+		return -1;
+	}
+	return 0;
+}
+
 static double
 box_check_txn_timeout(void)
 {
@@ -2308,6 +2371,8 @@ box_check_config(void)
 	box_check_replication_linearizable_quorum();
 	if (box_check_replication_synchro_timeout() < 0)
 		diag_raise();
+	if (box_check_replication_synchro_confirm_delay() < 0)
+		diag_raise();
 	if (box_check_replication_threads() < 0)
 		diag_raise();
 	box_check_replication_sync_timeout();
@@ -2319,8 +2384,12 @@ box_check_config(void)
 	if (box_check_bootstrap_leader(&uri, &uuid, name) != 0)
 		diag_raise();
 	uri_destroy(&uri);
+	if (box_check_iproto_stale_read_max_lag() < 0)
+		diag_raise();
 	box_check_readahead(cfg_geti("readahead"));
 	box_check_checkpoint_count(cfg_geti("checkpoint_count"));
+	box_check_snap_compress_threads(cfg_geti("snap_compress_threads"));
+	box_check_snap_delta_count(cfg_geti("snap_delta_count"));
 	box_check_wal_max_size(cfg_geti64("wal_max_size"));
 	box_check_wal_mode(cfg_gets("wal_mode"));
 	if (box_check_wal_queue_max_size() < 0)
@@ -2342,6 +2411,8 @@ box_check_config(void)
 		diag_raise();
 	if (box_check_iproto_options() != 0)
 		diag_raise();
+	if (box_check_net_box_io_threads() != 0)
+		diag_raise();
 	if (box_check_sql_cache_size(cfg_geti("sql_cache_size")) != 0)
 		diag_raise();
 	if (box_check_txn_timeout() < 0)
@@ -2740,6 +2811,17 @@ box_set_replication_synchro_timeout(void)
 	return 0;
 }
 
+int
+box_set_replication_synchro_confirm_delay(void)
+{
+	double value = box_check_replication_synchro_confirm_delay();
+	if (value < 0)
+		return -1;
+	replication_synchro_confirm_delay = value;
+	txn_limbo_on_parameters_change(&txn_limbo);
+	return 0;
+}
+
 void
 box_set_replication_sync_timeout(void)
 {
@@ -3210,6 +3292,28 @@ box_set_snap_io_rate_limit(void)
 			cfg_getd("snap_io_rate_limit"));
 }
 
+void
+box_set_snap_compress_threads(void)
+{
+	int thread_count = cfg_geti("snap_compress_threads");
+	box_check_snap_compress_threads(thread_count);
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_snap_compress_threads(memtx, thread_count);
+}
+
+void
+box_set_snap_delta_count(void)
+{
+	int count = cfg_geti("snap_delta_count");
+	box_check_snap_delta_count(count);
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_snap_delta_count(memtx, count);
+}
+
 void
 box_set_memtx_memory(void)
 {
@@ -3363,6 +3467,14 @@ box_set_vinyl_cache(void)
 	vinyl_engine_set_cache(vinyl, cfg_geti64("vinyl_cache"));
 }
 
+void
+box_set_vinyl_page_cache(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_page_cache(vinyl, cfg_geti64("vinyl_page_cache"));
+}
+
 void
 box_set_vinyl_timeout(void)
 {
@@ -3388,6 +3500,16 @@ box_set_net_msg_max(void)
 				IPROTO_FIBER_POOL_SIZE_FACTOR);
 }
 
+int
+box_set_iproto_stale_read_max_lag(void)
+{
+	double value = box_check_iproto_stale_read_max_lag();
+	if (value < 0)
+		return -1;
+	iproto_set_stale_read_max_lag(value);
+	return 0;
+}
+
 int
 box_set_prepared_stmt_cache_size(void)
 {
@@ -3882,6 +4004,9 @@ box_iterator_position_unpack(const char *packed_pos,
 	return 0;
 }
 
+/** Max number of tuples fetched by box_select() per iterator call. */
+enum { BOX_SELECT_BATCH_SIZE = 64 };
+
 int
 box_select(uint32_t space_id, uint32_t index_id,
 	   int iterator, uint32_t offset, uint32_t limit,
@@ -3942,17 +4067,21 @@ box_select(uint32_t space_id, uint32_t index_id,
 
 	int rc = 0;
 	uint32_t found = 0;
-	struct tuple *tuple;
+	struct tuple *batch[BOX_SELECT_BATCH_SIZE];
 	port_c_create(port);
 	while (found < limit) {
-		rc = box_check_slice();
+		uint32_t batch_size = MIN(limit - found,
+					  (uint32_t)BOX_SELECT_BATCH_SIZE);
+		rc = box_check_slice_n(batch_size);
 		if (rc != 0)
 			break;
-		rc = iterator_next(it, &tuple);
-		if (rc != 0 || tuple == NULL)
+		uint32_t count;
+		rc = iterator_next_batch(it, batch, batch_size, &count);
+		for (uint32_t i = 0; i < count; i++)
+			port_c_add_tuple(port, batch[i]);
+		found += count;
+		if (rc != 0 || count == 0)
 			break;
-		port_c_add_tuple(port, tuple);
-		found++;
 		/*
 		 * Refresh the pointer to the space, because the space struct
 		 * could be freed if the iterator yielded.
@@ -5219,6 +5348,7 @@ engine_init()
 	engine_register((struct engine *)memtx);
 	box_set_memtx_use_sort_data();
 	box_set_memtx_max_tuple_size();
+	box_set_snap_delta_count();
 
 	memcs_engine_register();
 
@@ -5231,6 +5361,7 @@ engine_init()
 	engine_register(vinyl);
 	box_set_vinyl_max_tuple_size();
 	box_set_vinyl_cache();
+	box_set_vinyl_page_cache();
 	box_set_vinyl_timeout();
 
 	quiver_engine_register();
@@ -5873,6 +6004,8 @@ box_cfg_xc(void)
 	if (box_set_prepared_stmt_cache_size() != 0)
 		diag_raise();
 	box_set_net_msg_max();
+	if (box_set_iproto_stale_read_max_lag() != 0)
+		diag_raise();
 	box_set_readahead();
 	box_set_too_long_threshold();
 	box_set_replication_timeout();
@@ -5889,6 +6022,8 @@ box_cfg_xc(void)
 		diag_raise();
 	if (box_set_replication_synchro_timeout() != 0)
 		diag_raise();
+	if (box_set_replication_synchro_confirm_delay() != 0)
+		diag_raise();
 	if (box_set_txn_synchro_timeout() != 0)
 		diag_raise();
 	if (box_set_replication_synchro_queue_max_size() != 0)
@@ -6684,6 +6819,12 @@ box_on_journal_cascading_rollback(void)
 	txn_limbo_rollback_all_volatile(&txn_limbo);
 }
 
+static void
+box_on_journal_submit(void)
+{
+	txn_limbo_on_journal_submit(&txn_limbo);
+}
+
 static void
 box_storage_init(void)
 {
@@ -6704,9 +6845,11 @@ box_storage_init(void)
 	engine_init();
 	schema_init();
 	journal_on_cascading_rollback = box_on_journal_cascading_rollback;
+	journal_on_submit = box_on_journal_submit;
 	replication_init(cfg_geti_default("replication_threads", 1));
 	txn_limbo_init(box_raft());
 	iproto_init(cfg_geti("iproto_threads"));
+	net_box_io_init(cfg_geti("net_box_io_threads"));
 	sql_init();
 	audit_log_init();
 	security_cfg();
@@ -6736,6 +6879,7 @@ box_storage_free(void)
 		return;
 	wal_free();
 	iproto_free();
+	net_box_io_free();
 	txn_limbo_free();
 
 	/*
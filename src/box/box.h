@@ -184,14 +184,18 @@ box_check_configured(void);
 int
 box_check_slice_slow(void);
 
-/** Check periodically if the slice of main cord has expired. */
+/**
+ * Check periodically if the slice of main cord has expired.
+ * The slice is checked once per 1000 iterations, @a count is
+ * the number of iterations made since the previous call.
+ */
 static inline int
-box_check_slice(void)
+box_check_slice_n(uint32_t count)
 {
 	const uint32_t check_limit = 1000;
 	static uint32_t check_count;
-	check_count++;
-	if (check_count == check_limit) {
+	check_count += count;
+	if (check_count >= check_limit) {
 		check_count = 0;
 		return box_check_slice_slow();
 	} else {
@@ -199,6 +203,13 @@ box_check_slice(void)
 	}
 }
 
+/** Check periodically if the slice of main cord has expired. */
+static inline int
+box_check_slice(void)
+{
+	return box_check_slice_n(1);
+}
+
 /**
  * Check if a write operation can be performed on this instance.
  * Returns 0 on success. On error, sets diag and returns -1.
@@ -459,6 +470,8 @@ int box_listen(void);
 void box_set_replication(void);
 void box_set_io_collect_interval(void);
 void box_set_snap_io_rate_limit(void);
+void box_set_snap_compress_threads(void);
+void box_set_snap_delta_count(void);
 void box_set_too_long_threshold(void);
 void box_set_readahead(void);
 void box_set_checkpoint_count(void);
@@ -473,6 +486,7 @@ void box_set_memtx_max_tuple_size(void);
 void box_set_vinyl_memory(void);
 void box_set_vinyl_max_tuple_size(void);
 void box_set_vinyl_cache(void);
+void box_set_vinyl_page_cache(void);
 void box_set_vinyl_timeout(void);
 void box_set_force_recovery(void);
 int box_set_election_mode(void);
@@ -487,6 +501,7 @@ void box_update_replication_synchro_quorum(void);
 int box_set_replication_synchro_quorum(void);
 void box_set_replication_linearizable_quorum(void);
 int box_set_replication_synchro_timeout(void);
+int box_set_replication_synchro_confirm_delay(void);
 void box_set_replication_sync_timeout(void);
 void box_set_replication_skip_conflict(void);
 void box_set_replication_anon(void);
@@ -495,6 +510,7 @@ void box_set_instance_name(void);
 void box_set_replicaset_name(void);
 void box_set_cluster_name(void);
 void box_set_net_msg_max(void);
+int box_set_iproto_stale_read_max_lag(void);
 int box_set_prepared_stmt_cache_size(void);
 int box_set_feedback(void);
 int box_set_txn_timeout(void);
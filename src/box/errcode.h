@@ -450,6 +450,8 @@ struct errcode_record {
 	_(ER_XLOG_NOT_FOUND, 303,		"xlog file not found", "vclock", STRING) \
 	_(ER_RECOVERY_POINT_TXN_LAST_ROW, 304,	"Last row of recovery point transaction should not be local") \
 	_(ER_NO_SUCH_READ_VIEW, 305,		"Read view was not found by id") \
+	_(ER_NO_SUCH_CURSOR, 306,		"Cursor does not exist", "cursor_id", UINT) \
+	_(ER_CURSOR_LIMIT, 307,			"Too many open cursors", "max", UINT) \
 	TEST_ERROR_CODES(_) /** This one should be last. */
 
 /*
@@ -30,6 +30,7 @@
  */
 #include "index.h"
 #include "index_def.h"
+#include "arrow_options.h"
 #include "tuple.h"
 #include "say.h"
 #include "schema.h"
@@ -657,6 +658,82 @@ box_index_count(uint32_t space_id, uint32_t index_id, int type,
 
 /* }}} */
 
+/* {{{ Arrow streams ********************************************/
+
+box_arrow_options_t *
+box_arrow_options_new(void)
+{
+	struct arrow_options *options =
+		(struct arrow_options *)xmalloc(sizeof(*options));
+	arrow_options_create(options);
+	return options;
+}
+
+void
+box_arrow_options_delete(box_arrow_options_t *options)
+{
+	free(options);
+}
+
+void
+box_arrow_options_set_batch_row_count(box_arrow_options_t *options,
+				      uint32_t batch_row_count)
+{
+	options->batch_row_count = batch_row_count;
+}
+
+void
+box_arrow_options_set_iterator(box_arrow_options_t *options, int type)
+{
+	options->iterator = (enum iterator_type)type;
+}
+
+void
+box_arrow_options_set_force_view_types(box_arrow_options_t *options,
+				       bool force_view_types)
+{
+	options->force_view_types = force_view_types;
+}
+
+int
+box_index_arrow_stream(uint32_t space_id, uint32_t index_id,
+		       uint32_t field_count, const uint32_t *fields,
+		       const char *key, const char *key_end,
+		       const box_arrow_options_t *options,
+		       struct ArrowArrayStream *stream)
+{
+	assert(key != NULL && key_end != NULL);
+	mp_tuple_assert(key, key_end);
+	if (options->iterator < 0 || options->iterator >= iterator_type_MAX) {
+		diag_set(IllegalParams, "Invalid iterator type");
+		return -1;
+	}
+	struct space *space;
+	struct index *index;
+	if (check_index(space_id, index_id, &space, &index) != 0)
+		return -1;
+	uint32_t part_count = mp_decode_array(&key);
+	if (iterator_validate(index->def, options->iterator, key, part_count))
+		return -1;
+	for (uint32_t i = 0; i < field_count; i++) {
+		if (fields[i] >= space->def->field_count) {
+			diag_set(ClientError, ER_NO_SUCH_FIELD_NO,
+				 fields[i] + TUPLE_INDEX_BASE);
+			return -1;
+		}
+	}
+	struct txn *txn;
+	struct txn_ro_savepoint svp;
+	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
+		return -1;
+	int rc = index_create_arrow_stream(index, field_count, fields, key,
+					   part_count, options, stream);
+	txn_end_ro_stmt(txn, &svp);
+	return rc;
+}
+
+/* }}} */
+
 /* {{{ Iterators ************************************************/
 
 box_iterator_t *
@@ -800,6 +877,7 @@ iterator_create(struct iterator *it, struct index *index)
 	index_weak_ref_create(&it->index_ref, index);
 	it->next_internal = NULL;
 	it->next = NULL;
+	it->next_batch = generic_iterator_next_batch;
 	it->free = NULL;
 	it->pos_buf = NULL;
 	it->pos_buf_size = 0;
@@ -816,6 +894,19 @@ iterator_next(struct iterator *it, struct tuple **ret)
 	return it->next(it, ret);
 }
 
+int
+iterator_next_batch(struct iterator *it, struct tuple **ret, uint32_t size,
+		    uint32_t *count)
+{
+	assert(it->next_batch != NULL);
+	assert(size > 0);
+	if (!index_weak_ref_check(&it->index_ref)) {
+		*count = 0;
+		return 0;
+	}
+	return it->next_batch(it, ret, size, count);
+}
+
 int
 iterator_next_internal(struct iterator *it, struct tuple **ret)
 {
@@ -1352,6 +1443,20 @@ exhausted_iterator_next(struct iterator *it, struct tuple **ret)
 	return 0;
 }
 
+int
+generic_iterator_next_batch(struct iterator *it, struct tuple **ret,
+			    uint32_t size, uint32_t *count)
+{
+	(void)size;
+	struct tuple *tuple;
+	*count = 0;
+	if (it->next(it, &tuple) != 0)
+		return -1;
+	if (tuple != NULL)
+		ret[(*count)++] = tuple;
+	return 0;
+}
+
 int
 exhausted_index_read_view_iterator_next_raw(struct index_read_view_iterator *it,
 					    struct read_view_tuple *result)
@@ -287,6 +287,64 @@ char *
 box_tuple_extract_key(box_tuple_t *tuple, uint32_t space_id,
 		      uint32_t index_id, uint32_t *key_size);
 
+struct ArrowArrayStream;
+
+/** Options of an Arrow stream, see box_index_arrow_stream(). */
+typedef struct arrow_options box_arrow_options_t;
+
+/**
+ * Allocate Arrow stream options initialized with default values:
+ * the ITER_GE iterator, 4096 rows per record batch, no view types.
+ * The options must be deleted with box_arrow_options_delete().
+ */
+box_arrow_options_t *
+box_arrow_options_new(void);
+
+/** Delete Arrow stream options. */
+void
+box_arrow_options_delete(box_arrow_options_t *options);
+
+/** Set the max number of rows in a record batch. */
+void
+box_arrow_options_set_batch_row_count(box_arrow_options_t *options,
+				      uint32_t batch_row_count);
+
+/** Set the \link iterator_type iterator type \endlink. */
+void
+box_arrow_options_set_iterator(box_arrow_options_t *options, int type);
+
+/**
+ * Make the stream return string and varbinary fields as Arrow string view
+ * and binary view columns.
+ */
+void
+box_arrow_options_set_force_view_types(box_arrow_options_t *options,
+				       bool force_view_types);
+
+/**
+ * Open an Arrow stream returning the given fields of tuples matching
+ * the key in the index as record batches. The stream reads a consistent
+ * snapshot of the index taken when it's opened and must be released
+ * by the caller. The end of the stream is marked by a released array.
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \param field_count number of fields in \a fields
+ * \param fields zero-based numbers of fields to return
+ * \param key encoded key in MsgPack Array format ([part1, part2, ...]).
+ * \param key_end the end of encoded \a key
+ * \param options stream options
+ * \param[out] stream Arrow stream
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ */
+int
+box_index_arrow_stream(uint32_t space_id, uint32_t index_id,
+		       uint32_t field_count, const uint32_t *fields,
+		       const char *key, const char *key_end,
+		       const box_arrow_options_t *options,
+		       struct ArrowArrayStream *stream);
+
 /** \endcond public */
 
 /**
@@ -372,6 +430,12 @@ struct iterator {
 	 * Returns 0 on success, -1 on error.
 	 */
 	int (*next)(struct iterator *it, struct tuple **ret);
+	/**
+	 * Fetch up to @a size tuples at once, see iterator_next_batch().
+	 * Set to generic_iterator_next_batch() by iterator_create().
+	 */
+	int (*next_batch)(struct iterator *it, struct tuple **ret,
+			  uint32_t size, uint32_t *count);
 	/**
 	 * Get position of iterator - extracted cmp_def of last fetched
 	 * tuple with MP_ARRAY header. If iterator is exhausted,
@@ -414,6 +478,22 @@ iterator_create(struct iterator *it, struct index *index);
 int
 iterator_next(struct iterator *it, struct tuple **ret);
 
+/**
+ * Fetch a batch of tuples from the iterator.
+ *
+ * Up to @a size tuples are stored in the @a ret array, the number of
+ * fetched tuples is returned in @a count. A batch may be shorter than
+ * requested even if the iterator isn't exhausted, zero @a count means
+ * EOF. The tuples aren't referenced: the caller must reference them
+ * before calling the iterator again.
+ *
+ * Returns 0 on success, -1 on error. On error, the tuples fetched
+ * before the failure are still returned.
+ */
+int
+iterator_next_batch(struct iterator *it, struct tuple **ret, uint32_t size,
+		    uint32_t *count);
+
 /**
  * Iterate to the next tuple as is, without any transformations.
  *
@@ -1302,6 +1382,14 @@ generic_index_read_view_create_arrow_stream(
 	struct ArrowArrayStream *stream);
 int
 exhausted_iterator_next(struct iterator *it, struct tuple **ret);
+/**
+ * Fetch at most one tuple with iterator->next(). Used by iterators
+ * that may yield or return tuples that are only referenced until the
+ * next fetch.
+ */
+int
+generic_iterator_next_batch(struct iterator *it, struct tuple **ret,
+			    uint32_t size, uint32_t *count);
 int
 exhausted_index_read_view_iterator_next_raw(struct index_read_view_iterator *it,
 					    struct read_view_tuple *result);
@@ -36,6 +36,7 @@
 #include <ctype.h>
 
 #include <msgpuck.h>
+#include <pmatomic.h>
 #include <small/ibuf.h>
 #include <small/obuf.h>
 #include <base64.h>
@@ -67,9 +68,11 @@
 #include "iproto_constants.h"
 #include "iproto_features.h"
 #include "rmean.h"
+#include "clock.h"
 #include "execute.h"
 #include "errinj.h"
 #include "tt_static.h"
+#include "tweaks.h"
 #include "trivia/util.h"
 #include "salad/stailq.h"
 #include "salad/grp_alloc.h"
@@ -80,6 +83,10 @@
 #include "watcher.h"
 #include "box/mp_box_ctx.h"
 #include "box/tuple.h"
+#include "box/index.h"
+#include "box/read_view.h"
+#include "box/space.h"
+#include "box/user.h"
 #include "mpstream/mpstream.h"
 
 enum {
@@ -141,6 +148,37 @@ struct iproto_func {
 	int srv_count;
 };
 
+/** Space served by IPROTO threads from the stale read view. */
+struct iproto_stale_read_space {
+	/** Space read view. */
+	struct space_read_view *rv;
+	/** Bit i is set if the user with auth token i may read the space. */
+	uint32_t access_mask;
+};
+
+static_assert(BOX_USER_MAX <= 32, "access_mask is too small");
+
+/**
+ * Read view used by IPROTO threads to serve SELECT requests for spaces with
+ * the stale_read option without forwarding them to tx. It's created and
+ * destroyed by tx and never modified while IPROTO threads may use it, see
+ * iproto_set_stale_read_max_lag().
+ */
+struct iproto_stale_read_view {
+	/** Database read view. */
+	struct read_view *rv;
+	/** Monotonic time when the read view was created. */
+	double timestamp;
+	/** Max age of the read view that may still be used. */
+	double max_lag;
+	/** Schema version the read view was created at. */
+	uint64_t schema_version;
+	/** Space id -> struct iproto_stale_read_space. */
+	struct mh_i32ptr_t *spaces;
+	/** Array of served spaces, referenced by the map. */
+	struct iproto_stale_read_space *space_array;
+};
+
 struct iproto_thread {
 	/**
 	 * Network thread execution unit.
@@ -192,6 +230,9 @@ struct iproto_thread {
 	struct cmsg_hop auth_route[2];
 	struct cmsg_hop misc_route[2];
 	struct cmsg_hop select_route[2];
+	struct cmsg_hop select_multi_route[2];
+	struct cmsg_hop select_release_route[2];
+	struct cmsg_hop cursor_route[2];
 	struct cmsg_hop process1_route[2];
 	struct cmsg_hop sql_route[2];
 	struct cmsg_hop join_route[2];
@@ -224,6 +265,8 @@ struct iproto_thread {
 	 * Iproto thread stat
 	 */
 	struct rmean *rmean;
+	/** Latency of requests processed by this thread. */
+	struct iproto_latency latency;
 	/*
 	 * Iproto thread id
 	 */
@@ -238,6 +281,32 @@ struct iproto_thread {
 	int connection_count;
 	/** Number of connections that pending drop. */
 	size_t drop_pending_connection_count;
+	/**
+	 * Timer that accounts CPU time consumed by this thread and
+	 * pauses or resumes accepting new connections depending on
+	 * the load of the other iproto threads.
+	 */
+	struct ev_timer load_timer;
+	/** CPU time consumed by this thread at the last timer tick, in ns. */
+	int64_t cpu_time;
+	/**
+	 * CPU load of this thread in microseconds per second, averaged
+	 * over the last few seconds. Updated by the thread on each load
+	 * timer tick and read by the other threads so it must only be
+	 * accessed with atomics. The rmean it's computed from is not
+	 * thread-safe and is only touched by the owner thread.
+	 */
+	int64_t load;
+	/**
+	 * Set if this thread is much more loaded than the least loaded
+	 * iproto thread so it leaves new connections to other threads.
+	 */
+	bool is_accept_paused;
+	/**
+	 * Read view used to serve stale reads in this thread or NULL.
+	 * Set by tx with IPROTO_CFG_STALE_READ_VIEW.
+	 */
+	struct iproto_stale_read_view *stale_read_view;
 	/**
 	 * If set then iproto thread shutdown is started and we should not
 	 * accept new connections.
@@ -400,6 +469,11 @@ enum iproto_cfg_op {
 	 * Command code to reset IPROTO thread statistics.
 	 */
 	IPROTO_CFG_RESET_STAT,
+	/**
+	 * Command code to get request latency statistics from IPROTO
+	 * thread.
+	 */
+	IPROTO_CFG_LATENCY,
 	/**
 	 * Command code to notify IPROTO threads a new handler has been set or
 	 * reset.
@@ -418,6 +492,10 @@ enum iproto_cfg_op {
 	 * new connections.
 	 */
 	IPROTO_CFG_SHUTDOWN,
+	/**
+	 * Command code to switch IPROTO thread to a new stale read view.
+	 */
+	IPROTO_CFG_STALE_READ_VIEW,
 };
 
 /**
@@ -433,8 +511,12 @@ struct iproto_cfg_msg: public cbus_call_msg
 	union {
 		/** Pointer to the statistic structure. */
 		struct iproto_stats *stats;
+		/** Latency statistics to add the thread statistics to. */
+		struct iproto_latency *latency;
 		/** New iproto max message count. */
 		int iproto_msg_max;
+		/** New stale read view, may be NULL. */
+		struct iproto_stale_read_view *stale_read_view;
 		struct {
 			/** New connection IO stream. */
 			struct iostream io;
@@ -681,11 +763,36 @@ struct iproto_msg
 	 * Used by long (yielding) CALL/EVAL requests.
 	 */
 	struct cmsg discard_input;
+	/**
+	 * Result of a big SELECT request. Instead of copying the tuples to
+	 * the output buffer, tx passes them referenced to the IPROTO thread,
+	 * which writes the response, see tx_process_select(). The message
+	 * then returns to tx to release the tuples.
+	 */
+	struct {
+		/** Selected tuples. */
+		struct port port;
+		/** Schema version to report in the response. */
+		uint64_t schema_version;
+		/** Set if the response must be written by the IPROTO thread. */
+		bool is_pending;
+	} select_result;
 	/**
 	 * Used in "connect" msgs, true if connect trigger failed
 	 * and the connection must be closed.
 	 */
 	bool close_connection;
+	/**
+	 * Set if the request may change the session user or features,
+	 * see iproto_connection::session_update_count.
+	 */
+	bool updates_session;
+	/**
+	 * Auth token of the session user reported by tx on request
+	 * completion, see iproto_connection::auth_token. Negative if
+	 * not reported.
+	 */
+	int auth_token;
 	/**
 	 * A stailq_entry to hold message in stream.
 	 * All messages processed in stream sequently. Before processing
@@ -700,6 +807,15 @@ struct iproto_msg
 	struct rlist in_inprogress;
 	/** Serving thread fiber processing this message. */
 	struct fiber *fiber;
+	/**
+	 * Monotonic time when the request was read, sent to a serving
+	 * thread, accepted and processed by it, see iproto_latency_stage.
+	 * Zero if the request hasn't reached the stage.
+	 */
+	double read_time;
+	double push_time;
+	double accept_time;
+	double end_time;
 };
 
 /**
@@ -727,6 +843,7 @@ enum rmean_net_name {
 	IPROTO_REQUESTS,
 	IPROTO_STREAMS,
 	REQUESTS_IN_STREAM_QUEUE,
+	IPROTO_CPU_TIME,
 	RMEAN_NET_LAST,
 };
 
@@ -737,6 +854,7 @@ const char *rmean_net_strings[RMEAN_NET_LAST] = {
 	"REQUESTS",
 	"STREAMS",
 	"REQUESTS_IN_STREAM_QUEUE",
+	"CPU_TIME",
 };
 
 enum rmean_tx_name {
@@ -857,6 +975,8 @@ struct iproto_connection
 	/**
 	 * States of threads serving incoming requests.
 	 * srv[0] is for tx, srv[1,2,...] are for application threads.
+	 * The last entry, srv[iproto_net_srv_id()], holds responses
+	 * written by the IPROTO thread itself, see net_process_stale_read().
 	 */
 	struct {
 		alignas(CACHELINE_SIZE)
@@ -1004,6 +1124,13 @@ struct iproto_connection
 		 * return.
 		 */
 		bool is_push_pending;
+		/**
+		 * Cursor id -> struct iproto_cursor. Created on demand.
+		 * Cursors are closed when the connection is destroyed.
+		 */
+		struct mh_i64ptr_t *cursors;
+		/** Id of the last cursor opened in the connection. */
+		uint64_t last_cursor_id;
 	} tx;
 	/** Authentication salt. */
 	char salt[IPROTO_SALT_SIZE];
@@ -1039,6 +1166,18 @@ struct iproto_connection
 	struct ev_timer idle_timer;
 	/** Set when the connection was closed by the idle timeout. */
 	bool disconnected_by_timeout;
+	/**
+	 * Auth token of the session user, as last reported by tx. Used
+	 * for checking access to spaces served from the stale read view.
+	 * Set to BOX_USER_MAX if stale reads mustn't be served to this
+	 * connection, e.g. because it needs tuples as MsgPack extensions.
+	 */
+	uint8_t auth_token;
+	/**
+	 * Number of requests in progress that may change the session
+	 * user or features. Stale reads aren't served while it's not 0.
+	 */
+	int session_update_count;
 };
 
 /** Returns a string suitable for logging. */
@@ -1055,6 +1194,16 @@ iproto_msg_obuf(struct iproto_msg *msg)
 	return msg->connection->srv[msg->srv_id].p_obuf;
 }
 
+/**
+ * Returns the index of the connection output state used for responses
+ * written by the IPROTO thread itself. It follows the serving threads.
+ */
+static inline int
+iproto_net_srv_id(struct iproto_thread *iproto_thread)
+{
+	return iproto_thread->srv_count;
+}
+
 #ifdef NDEBUG
 #define iproto_write_error(io, e, schema_version, sync)                         \
 	iproto_do_write_error(io, e, schema_version, sync);
@@ -1108,16 +1257,30 @@ iproto_check_msg_max(struct iproto_thread *iproto_thread)
 	return request_count > (size_t) iproto_msg_max;
 }
 
+/**
+ * Frees a message without resuming stopped connections.
+ * Use iproto_msg_delete() unless the caller is enqueueing input.
+ */
 static inline void
-iproto_msg_delete(struct iproto_msg *msg)
+iproto_msg_free(struct iproto_msg *msg)
 {
 	struct iproto_connection *con = msg->connection;
 	assert(con->request_count > 0);
 	con->request_count--;
 	if (con->request_count == 0 && con->idle_timeout > 0)
 		iproto_connection_set_idle_timer(con);
-	struct iproto_thread *iproto_thread = con->iproto_thread;
-	mempool_free(&iproto_thread->iproto_msg_pool, msg);
+	if (msg->updates_session) {
+		assert(con->session_update_count > 0);
+		con->session_update_count--;
+	}
+	mempool_free(&con->iproto_thread->iproto_msg_pool, msg);
+}
+
+static inline void
+iproto_msg_delete(struct iproto_msg *msg)
+{
+	struct iproto_thread *iproto_thread = msg->connection->iproto_thread;
+	iproto_msg_free(msg);
 	iproto_resume(iproto_thread);
 }
 
@@ -1137,10 +1300,17 @@ iproto_msg_new(struct iproto_connection *con)
 	struct iproto_msg *msg =
 		(struct iproto_msg *)xmempool_alloc(iproto_msg_pool);
 	msg->close_connection = false;
+	msg->updates_session = false;
+	msg->auth_token = -1;
+	msg->select_result.is_pending = false;
 	msg->connection = con;
 	msg->srv_id = 0;
 	msg->stream = NULL;
 	msg->fiber = NULL;
+	msg->read_time = clock_monotonic();
+	msg->push_time = 0;
+	msg->accept_time = 0;
+	msg->end_time = 0;
 	rmean_collect(con->iproto_thread->rmean, IPROTO_REQUESTS, 1);
 	con->request_count++;
 	if (con->request_count == 1 && con->idle_timeout > 0)
@@ -1469,7 +1639,7 @@ iproto_connection_input_buffer(struct iproto_connection *con)
 static inline bool
 iproto_is_flushed(struct iproto_connection *con)
 {
-	for (int i = 0; i < con->iproto_thread->srv_count; i++) {
+	for (int i = 0; i <= iproto_net_srv_id(con->iproto_thread); i++) {
 		struct iproto_wpos *wpos = &con->srv[i].wpos;
 		struct iproto_wpos *wend = &con->srv[i].wend;
 		if (wpos->obuf != wend->obuf ||
@@ -1526,6 +1696,15 @@ iproto_submit_input(struct iproto_thread *iproto_thread)
 		cpipe_submit_flush(&iproto_thread->srv[i].pipe);
 }
 
+/**
+ * Serves a SELECT request in the IPROTO thread from the stale read view if
+ * possible, see iproto_set_stale_read_max_lag(). On success, writes the
+ * response, frees the message, and returns true. Otherwise, returns false
+ * and the request should be forwarded to tx as usual.
+ */
+static bool
+net_process_stale_read(struct iproto_msg *msg);
+
 /**
  * Enqueue all requests which were read up. If a request limit is
  * reached - stop the connection input even if not the whole batch
@@ -1579,17 +1758,26 @@ iproto_enqueue_batch(struct iproto_connection *con, struct ibuf *in)
 		con->input_msg_count[msg->p_ibuf == &con->ibuf[1]]++;
 
 		iproto_msg_prepare(msg, &pos, reqend);
-		if (iproto_msg_start_processing_in_stream(msg)) {
-			msg->wpos = con->srv[msg->srv_id].wpos;
-			cpipe_push(&con->iproto_thread->srv[msg->srv_id].pipe,
-				   &msg->base);
-			n_requests++;
+		if (msg->header.type == IPROTO_AUTH ||
+		    msg->header.type == IPROTO_ID) {
+			msg->updates_session = true;
+			con->session_update_count++;
 		}
 
 		/* Request is parsed */
 		assert(reqend > reqstart);
 		assert(con->parse_size >= (size_t) (reqend - reqstart));
 		con->parse_size -= reqend - reqstart;
+
+		if (iproto_msg_start_processing_in_stream(msg)) {
+			n_requests++;
+			if (net_process_stale_read(msg))
+				continue;
+			msg->wpos = con->srv[msg->srv_id].wpos;
+			msg->push_time = clock_monotonic();
+			cpipe_push(&con->iproto_thread->srv[msg->srv_id].pipe,
+				   &msg->base);
+		}
 	}
 	if (con->is_in_replication) {
 		/**
@@ -1855,7 +2043,7 @@ iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 			break;
 		}
 		/* Proceed to the next buffer. */
-		if (++con->flush.srv_id == con->iproto_thread->srv_count)
+		if (++con->flush.srv_id > iproto_net_srv_id(con->iproto_thread))
 			con->flush.srv_id = 0;
 		con->flush.wend = con->srv[con->flush.srv_id].wend;
 		if (con->flush.srv_id == start_srv_id) {
@@ -1881,7 +2069,8 @@ static struct iproto_connection *
 iproto_connection_new(struct iproto_thread *iproto_thread)
 {
 	struct iproto_connection *con = xalloc_object(typeof(*con));
-	con->srv = xalloc_array(typeof(*con->srv), iproto_thread->srv_count);
+	int net_srv_id = iproto_net_srv_id(iproto_thread);
+	con->srv = xalloc_array(typeof(*con->srv), net_srv_id + 1);
 	con->streams = mh_i64ptr_new();
 	con->iproto_thread = iproto_thread;
 	con->input.data = con->output.data = con;
@@ -1907,6 +2096,18 @@ iproto_connection_new(struct iproto_thread *iproto_thread)
 		rlist_create(&con->srv[i].inprogress);
 		con->srv[i].runtime_credentials.user_name = NULL;
 	}
+	/* Output written by the IPROTO thread is allocated locally. */
+	obuf_create(&con->srv[net_srv_id].obuf[0], cord_slab_cache(),
+		    iproto_readahead);
+	obuf_create(&con->srv[net_srv_id].obuf[1], cord_slab_cache(),
+		    iproto_readahead);
+	con->srv[net_srv_id].p_obuf = &con->srv[net_srv_id].obuf[0];
+	iproto_wpos_create(&con->srv[net_srv_id].wpos,
+			   con->srv[net_srv_id].p_obuf);
+	iproto_wpos_create(&con->srv[net_srv_id].wend,
+			   con->srv[net_srv_id].p_obuf);
+	rlist_create(&con->srv[net_srv_id].inprogress);
+	con->srv[net_srv_id].runtime_credentials.user_name = NULL;
 	con->flush.srv_id = 0;
 	con->flush.wend = con->srv[0].wend;
 	con->parse_size = 0;
@@ -1923,11 +2124,15 @@ iproto_connection_new(struct iproto_thread *iproto_thread)
 	con->destroy_msg_count = 0;
 	con->tx.is_push_pending = false;
 	con->tx.is_push_sent = false;
+	con->tx.cursors = NULL;
+	con->tx.last_cursor_id = 0;
 	rmean_collect(iproto_thread->rmean, IPROTO_CONNECTIONS, 1);
 	con->request_count = 0;
 	con->is_internal = false;
 	con->idle_timeout = 0;
 	con->disconnected_by_timeout = false;
+	con->auth_token = BOX_USER_MAX;
+	con->session_update_count = 0;
 	con->idle_timer.data = con;
 	ev_timer_init(&con->idle_timer, iproto_connection_idle_timeout_cb,
 		      0, 0);
@@ -1977,6 +2182,9 @@ iproto_connection_delete(struct iproto_connection *con)
 		assert(!obuf_is_initialized(&con->srv[i].obuf[1]));
 		free(con->srv[i].runtime_credentials.user_name);
 	}
+	int net_srv_id = iproto_net_srv_id(iproto_thread);
+	obuf_destroy(&con->srv[net_srv_id].obuf[0]);
+	obuf_destroy(&con->srv[net_srv_id].obuf[1]);
 	assert(mh_size(con->streams) == 0);
 	mh_i64ptr_delete(con->streams);
 	rlist_del(&con->in_connections);
@@ -2008,6 +2216,16 @@ tx_process1(struct cmsg *msg);
 static void
 tx_process_select(struct cmsg *msg);
 
+static void
+tx_process_select_multi(struct cmsg *msg);
+
+static void
+tx_process_cursor(struct cmsg *msg);
+
+/** Closes all cursors open in a connection. */
+static void
+tx_close_cursors(struct iproto_connection *con);
+
 static void
 tx_process_sql(struct cmsg *msg);
 
@@ -2023,6 +2241,12 @@ net_send_msg(struct cmsg *msg);
 static void
 net_send_error(struct cmsg *msg);
 
+static void
+tx_release_select(struct cmsg *msg);
+
+static void
+net_end_select(struct cmsg *msg);
+
 static void
 tx_process_replication(struct cmsg *msg);
 
@@ -2181,6 +2405,10 @@ iproto_msg_decode(struct iproto_msg *msg, struct cmsg_hop **route)
 	case IPROTO_DELETE:
 	case IPROTO_UPSERT:
 	case IPROTO_INSERT_ARROW:
+	case IPROTO_SELECT_MULTI:
+	case IPROTO_CURSOR_OPEN:
+	case IPROTO_CURSOR_FETCH:
+	case IPROTO_CURSOR_CLOSE:
 		assert(type < sizeof(iproto_thread->dml_route) /
 			      sizeof(*iproto_thread->dml_route));
 		*route = iproto_thread->dml_route[type];
@@ -2379,6 +2607,8 @@ srv_process_destroy(struct cmsg *m)
 		session_delete(con->session);
 		con->session = NULL; /* safety */
 	}
+	if (msg->srv_id == 0)
+		tx_close_cursors(con);
 	/*
 	 * obuf is destroyed in the serving thread because it is where
 	 * it was allocated.
@@ -2532,6 +2762,7 @@ srv_accept_msg(struct cmsg *m)
 			msg, in_inprogress);
 	assert(msg->fiber == NULL);
 	msg->fiber = fiber();
+	msg->accept_time = clock_monotonic();
 	assert(msg->fiber->storage.runtime_credentials == NULL);
 	msg->fiber->storage.runtime_credentials =
 		&msg->connection->srv[msg->srv_id].runtime_credentials;
@@ -2599,6 +2830,20 @@ srv_end_msg(struct iproto_msg *msg)
 	rlist_del(&msg->in_inprogress);
 	msg->fiber->storage.runtime_credentials = NULL;
 	msg->fiber = NULL;
+	msg->end_time = clock_monotonic();
+}
+
+/**
+ * Returns the auth token to report to the IPROTO thread for serving stale
+ * reads to the given session, see iproto_connection::auth_token.
+ */
+static inline uint8_t
+tx_session_auth_token(struct session *session)
+{
+	if (iproto_features_test(&session->meta.features,
+				 IPROTO_FEATURE_DML_TUPLE_EXTENSION))
+		return BOX_USER_MAX;
+	return session->credentials.auth_token;
 }
 
 static inline void
@@ -2610,6 +2855,7 @@ tx_end_msg(struct iproto_msg *msg, struct obuf_svp *svp)
 		msg->stream->txn = txn_detach();
 	}
 	msg->connection->iproto_thread->tx.requests_in_progress--;
+	msg->auth_token = tx_session_auth_token(msg->connection->session);
 	struct obuf *out = iproto_msg_obuf(msg);
 	if (out->used != svp->used)
 		/* Log response to the flight recorder. */
@@ -2845,6 +3091,31 @@ tx_process1(struct cmsg *m)
 	tx_end_msg(msg, &svp);
 }
 
+/**
+ * Min size of the tuple data returned by a SELECT request that makes tx
+ * pass the tuples to the IPROTO thread instead of copying them to the
+ * output buffer.
+ */
+enum { IPROTO_SELECT_OFFLOAD_BSIZE_MIN = 64 * 1024 };
+
+/**
+ * Returns true if the tuples selected to a port should be written to the
+ * output buffer by the IPROTO thread, see tx_process_select().
+ */
+static bool
+tx_select_result_is_big(struct port *base)
+{
+	struct port_c *port = (struct port_c *)base;
+	size_t bsize = 0;
+	for (struct port_c_entry *pe = port->first; pe != NULL;
+	     pe = pe->next) {
+		if (pe->type != PORT_C_ENTRY_TUPLE)
+			return false;
+		bsize += tuple_bsize(pe->tuple);
+	}
+	return bsize >= IPROTO_SELECT_OFFLOAD_BSIZE_MIN;
+}
+
 static void
 tx_process_select(struct cmsg *m)
 {
@@ -2854,7 +3125,11 @@ tx_process_select(struct cmsg *m)
 				     IPROTO_FEATURE_DML_TUPLE_EXTENSION);
 	struct obuf *out;
 	struct obuf_svp svp;
-	struct port port;
+	/*
+	 * The port is stored in the message because it may be passed to
+	 * the IPROTO thread. Note that a port can't be moved.
+	 */
+	struct port *port = &msg->select_result.port;
 
 	struct mp_box_ctx ctx;
 	struct mp_ctx *ctx_ref = NULL;
@@ -2894,12 +3169,27 @@ tx_process_select(struct cmsg *m)
 	rc = box_select(req->space_id, req->index_id,
 			req->iterator, req->offset, req->limit,
 			req->key, req->key_end, &packed_pos, &packed_pos_end,
-			req->fetch_position, &port);
+			req->fetch_position, port);
 	if (rc < 0)
 		goto error;
 
 	out = iproto_msg_obuf(msg);
 	reply_position = req->fetch_position && packed_pos != NULL;
+	if (!box_tuple_as_ext && !reply_position &&
+	    tx_select_result_is_big(port)) {
+		/*
+		 * Copying a lot of tuples would keep tx busy for long so
+		 * let the IPROTO thread do it. The tuples stay referenced
+		 * until the message returns to tx, see net_send_msg().
+		 */
+		msg->select_result.schema_version = ::schema_version;
+		msg->select_result.is_pending = true;
+		region_truncate(&fiber()->gc, region_svp);
+		svp = obuf_create_svp(out);
+		iproto_wpos_create(&msg->wpos, out);
+		tx_end_msg(msg, &svp);
+		return;
+	}
 	if (reply_position)
 		iproto_prepare_select_with_position(out, &svp);
 	else
@@ -2907,8 +3197,8 @@ tx_process_select(struct cmsg *m)
 	/*
 	 * SELECT output format has not changed since Tarantool 1.6
 	 */
-	count = port_dump_msgpack_16_with_ctx(&port, out, ctx_ref);
-	port_destroy(&port);
+	count = port_dump_msgpack_16_with_ctx(port, out, ctx_ref);
+	port_destroy(port);
 	if (count < 0 || (box_tuple_as_ext &&
 			  tuple_format_map_to_iproto_obuf(&ctx.tuple_format_map,
 							  out) != 0)) {
@@ -2939,6 +3229,105 @@ tx_process_select(struct cmsg *m)
 	tx_end_msg(msg, &svp);
 }
 
+/**
+ * Processes IPROTO_SELECT_MULTI: selects tuples for each key of the request
+ * and replies with an array of tuple arrays, one per key. Fails as a whole
+ * if a select for any key fails.
+ */
+static void
+tx_process_select_multi(struct cmsg *m)
+{
+	struct iproto_msg *msg = tx_accept_msg(m);
+	bool box_tuple_as_ext =
+		iproto_features_test(&msg->connection->session->meta.features,
+				     IPROTO_FEATURE_DML_TUPLE_EXTENSION);
+	struct obuf *out;
+	struct obuf_svp svp;
+
+	struct mp_box_ctx ctx;
+	struct mp_ctx *ctx_ref = NULL;
+	if (box_tuple_as_ext) {
+		mp_box_ctx_create(&ctx, NULL, NULL);
+		ctx_ref = (struct mp_ctx *)&ctx;
+	}
+	auto ctx_guard = make_scoped_guard([ctx_ref] {
+		mp_ctx_destroy(ctx_ref);
+	});
+	ctx_guard.is_active = box_tuple_as_ext;
+
+	struct request *req = &msg->dml;
+	const char *key_list;
+	uint32_t key_count;
+	uint32_t region_svp = region_used(&fiber()->gc);
+	if (tx_check_msg(msg) != 0)
+		goto error;
+
+	rmean_collect(rmean_box, IPROTO_SELECT_MULTI, 1);
+	tx_inject_delay();
+	if (tx_resolve_space_and_index_name(&msg->dml) != 0)
+		goto error;
+	if (req->after_position != NULL || req->after_tuple != NULL ||
+	    req->fetch_position) {
+		diag_set(ClientError, ER_UNSUPPORTED, "SELECT_MULTI",
+			 "pagination");
+		goto error;
+	}
+	/* Check the keys before writing anything to the output. */
+	key_list = req->key_list;
+	key_count = mp_decode_array(&key_list);
+	for (uint32_t i = 0; i < key_count; i++) {
+		if (mp_typeof(*key_list) != MP_ARRAY) {
+			diag_set(ClientError, ER_INVALID_MSGPACK,
+				 "SELECT_MULTI key");
+			goto error;
+		}
+		mp_next(&key_list);
+	}
+
+	out = iproto_msg_obuf(msg);
+	iproto_prepare_select(out, &svp);
+	key_list = req->key_list;
+	mp_decode_array(&key_list);
+	for (uint32_t i = 0; i < key_count; i++) {
+		const char *key = key_list;
+		mp_next(&key_list);
+		const char *packed_pos = NULL, *packed_pos_end = NULL;
+		struct port port;
+		if (box_select(req->space_id, req->index_id,
+			       req->iterator, req->offset, req->limit,
+			       key, key_list, &packed_pos, &packed_pos_end,
+			       /*update_pos=*/false, &port) != 0)
+			goto discard;
+		/* The tuple count is unknown until the port is dumped. */
+		char *data_len = (char *)xobuf_alloc(out, 5);
+		int count = port_dump_msgpack_16_with_ctx(&port, out, ctx_ref);
+		port_destroy(&port);
+		if (count < 0)
+			goto discard;
+		*data_len = 0xdd;
+		mp_store_u32(data_len + 1, count);
+		region_truncate(&fiber()->gc, region_svp);
+	}
+	if (box_tuple_as_ext &&
+	    tuple_format_map_to_iproto_obuf(&ctx.tuple_format_map, out) != 0)
+		goto discard;
+	iproto_reply_select(out, &svp, msg->header.sync, ::schema_version,
+			    key_count, box_tuple_as_ext);
+	region_truncate(&fiber()->gc, region_svp);
+	iproto_wpos_create(&msg->wpos, out);
+	tx_end_msg(msg, &svp);
+	return;
+discard:
+	/* Discard the prepared select. */
+	obuf_rollback_to_svp(out, &svp);
+error:
+	region_truncate(&fiber()->gc, region_svp);
+	out = iproto_msg_obuf(msg);
+	svp = obuf_create_svp(out);
+	tx_reply_error(msg);
+	tx_end_msg(msg, &svp);
+}
+
 static int
 srv_process_call_on_yield(struct trigger *trigger, void *event)
 {
@@ -3713,20 +4102,112 @@ iproto_msg_finish_processing_in_stream(struct iproto_msg *msg)
 						     in_stream);
 		assert(stream->current != NULL);
 		stream->current->wpos = con->srv[msg->srv_id].wpos;
+		stream->current->push_time = clock_monotonic();
 		con->iproto_thread->requests_in_stream_queue--;
 		cpipe_push(&con->iproto_thread->srv[msg->srv_id].pipe,
 			   &stream->current->base);
 	}
 }
 
+/** Return the request type used for latency statistics. */
+static enum iproto_latency_type
+iproto_latency_type_by_request(uint32_t type)
+{
+	switch (type) {
+	case IPROTO_SELECT:
+		return IPROTO_LATENCY_SELECT;
+	case IPROTO_INSERT:
+		return IPROTO_LATENCY_INSERT;
+	case IPROTO_REPLACE:
+		return IPROTO_LATENCY_REPLACE;
+	case IPROTO_UPDATE:
+		return IPROTO_LATENCY_UPDATE;
+	case IPROTO_DELETE:
+		return IPROTO_LATENCY_DELETE;
+	case IPROTO_UPSERT:
+		return IPROTO_LATENCY_UPSERT;
+	case IPROTO_CALL:
+	case IPROTO_CALL_16:
+		return IPROTO_LATENCY_CALL;
+	case IPROTO_EVAL:
+		return IPROTO_LATENCY_EVAL;
+	case IPROTO_EXECUTE:
+		return IPROTO_LATENCY_EXECUTE;
+	case IPROTO_PREPARE:
+		return IPROTO_LATENCY_PREPARE;
+	default:
+		return IPROTO_LATENCY_OTHER;
+	}
+}
+
+/**
+ * Account the latency of a request processed by a serving thread.
+ * The timestamps are taken by different threads, so the differences
+ * are clamped in case the clocks aren't perfectly in sync.
+ */
+static void
+iproto_msg_collect_latency(struct iproto_msg *msg)
+{
+	if (msg->push_time == 0 || msg->end_time == 0)
+		return;
+	assert(msg->accept_time != 0);
+	struct latency *latency = msg->connection->iproto_thread->latency.stage[
+		iproto_latency_type_by_request(msg->header.type)];
+	double now = clock_monotonic();
+	latency_collect(&latency[IPROTO_LATENCY_NET_QUEUE],
+			MAX(msg->push_time - msg->read_time, 0.));
+	latency_collect(&latency[IPROTO_LATENCY_TX_QUEUE],
+			MAX(msg->accept_time - msg->push_time, 0.));
+	latency_collect(&latency[IPROTO_LATENCY_EXEC],
+			MAX(msg->end_time - msg->accept_time, 0.));
+	latency_collect(&latency[IPROTO_LATENCY_TOTAL],
+			MAX(now - msg->read_time, 0.));
+}
+
+/**
+ * Writes a SELECT response with the tuples passed by tx to the output
+ * buffer of the IPROTO thread, see tx_process_select().
+ */
+static void
+net_write_select_result(struct iproto_msg *msg)
+{
+	struct iproto_connection *con = msg->connection;
+	int net_srv_id = iproto_net_srv_id(con->iproto_thread);
+	srv_accept_wpos(con, net_srv_id, &con->srv[net_srv_id].wpos);
+	struct obuf *out = con->srv[net_srv_id].p_obuf;
+	struct obuf_svp svp;
+	iproto_prepare_select(out, &svp);
+	struct port_c *port = (struct port_c *)&msg->select_result.port;
+	for (struct port_c_entry *pe = port->first; pe != NULL;
+	     pe = pe->next) {
+		assert(pe->type == PORT_C_ENTRY_TUPLE);
+		uint32_t size;
+		const char *data = tuple_data_range(pe->tuple, &size);
+		xobuf_dup(out, data, size);
+	}
+	iproto_reply_select(out, &svp, msg->header.sync,
+			    msg->select_result.schema_version, port->size,
+			    /*box_tuple_as_ext=*/false);
+	iproto_wpos_create(&con->srv[net_srv_id].wend, out);
+}
+
 static void
 net_send_msg(struct cmsg *m)
 {
 	struct iproto_msg *msg = (struct iproto_msg *) m;
 	struct iproto_connection *con = msg->connection;
 
+	iproto_msg_collect_latency(msg);
 	iproto_msg_finish_processing_in_stream(msg);
-	if (msg->len != 0) {
+	if (msg->select_result.is_pending) {
+		/*
+		 * The input is discarded when the message returns from tx
+		 * so that the connection isn't destroyed while the tuples
+		 * are referenced, see net_end_select().
+		 */
+		if (con->state == IPROTO_CONNECTION_ALIVE)
+			net_write_select_result(msg);
+	} else if (msg->len != 0) {
 		/* Discard request (see iproto_enqueue_batch()). */
 		iproto_msg_finish_input(msg);
 	} else {
@@ -3735,15 +4216,152 @@ net_send_msg(struct cmsg *m)
 		con->long_poll_count--;
 	}
 	con->srv[msg->srv_id].wend = msg->wpos;
+	if (msg->auth_token >= 0)
+		con->auth_token = msg->auth_token;
 
 	if (con->state == IPROTO_CONNECTION_ALIVE) {
 		iproto_connection_feed_output(con);
 	} else if (iproto_connection_is_idle(con)) {
 		iproto_connection_close(con);
 	}
+	if (msg->select_result.is_pending) {
+		/* Tuples may only be unreferenced in tx. */
+		cmsg_init(&msg->base, con->iproto_thread->select_release_route);
+		cpipe_push(&con->iproto_thread->srv[0].pipe, &msg->base);
+		return;
+	}
+	iproto_msg_delete(msg);
+}
+
+/** Releases the tuples of a SELECT response written by net_send_msg(). */
+static void
+tx_release_select(struct cmsg *m)
+{
+	struct iproto_msg *msg = (struct iproto_msg *)m;
+	assert(msg->select_result.is_pending);
+	port_destroy(&msg->select_result.port);
+}
+
+/** Completes a SELECT request after its tuples were released in tx. */
+static void
+net_end_select(struct cmsg *m)
+{
+	struct iproto_msg *msg = (struct iproto_msg *)m;
+	struct iproto_connection *con = msg->connection;
+	iproto_msg_finish_input(msg);
+	if (con->state != IPROTO_CONNECTION_ALIVE &&
+	    iproto_connection_is_idle(con))
+		iproto_connection_close(con);
 	iproto_msg_delete(msg);
 }
 
+/**
+ * Max number of tuples returned by a SELECT request served from the stale
+ * read view. Bigger requests are forwarded to tx so as not to stall other
+ * connections of the IPROTO thread.
+ */
+enum { IPROTO_STALE_READ_TUPLES_MAX = 1024 };
+
+static bool
+net_process_stale_read(struct iproto_msg *msg)
+{
+	struct iproto_connection *con = msg->connection;
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	struct iproto_stale_read_view *view = iproto_thread->stale_read_view;
+	if (view == NULL || msg->base.route != iproto_thread->select_route ||
+	    msg->stream != NULL || con->session_update_count > 0 ||
+	    con->auth_token >= BOX_USER_MAX)
+		return false;
+	double start_time = clock_monotonic();
+	/*
+	 * The schema version is updated by tx atomically. A DDL that
+	 * isn't seen yet just makes us serve a read view that is still
+	 * within the max lag.
+	 */
+	if (start_time - view->timestamp > view->max_lag ||
+	    view->schema_version != pm_atomic_load(&::schema_version))
+		return false;
+	/* Let tx report the schema version mismatch. */
+	if (msg->header.schema_version != 0 &&
+	    msg->header.schema_version != view->schema_version)
+		return false;
+	struct request *req = &msg->dml;
+	if (req->space_name != NULL || req->index_name != NULL ||
+	    req->after_position != NULL || req->after_tuple != NULL ||
+	    req->fetch_position || req->iterator >= iterator_type_MAX ||
+	    req->offset > IPROTO_STALE_READ_TUPLES_MAX)
+		return false;
+	mh_int_t k = mh_i32ptr_find(view->spaces, req->space_id, NULL);
+	if (k == mh_end(view->spaces))
+		return false;
+	struct iproto_stale_read_space *space =
+		(struct iproto_stale_read_space *)
+		mh_i32ptr_node(view->spaces, k)->val;
+	if ((space->access_mask & (1u << con->auth_token)) == 0)
+		return false;
+	struct index_read_view *index =
+		space_read_view_index(space->rv, req->index_id);
+	if (index == NULL)
+		return false;
+	enum iterator_type type = (enum iterator_type)req->iterator;
+	const char *key = req->key;
+	uint32_t part_count = key != NULL ? mp_decode_array(&key) : 0;
+	struct index_read_view_iterator it;
+	if (iterator_validate(index->def, type, key, part_count) != 0 ||
+	    index_read_view_create_iterator_with_offset(
+			index, type, key, part_count, /*pos=*/NULL,
+			req->offset, &it) != 0) {
+		/* Let tx report the error. */
+		diag_clear(diag_get());
+		return false;
+	}
+
+	int net_srv_id = iproto_net_srv_id(iproto_thread);
+	srv_accept_wpos(con, net_srv_id, &con->srv[net_srv_id].wpos);
+	struct obuf *out = con->srv[net_srv_id].p_obuf;
+	struct obuf_svp svp;
+	iproto_prepare_select(out, &svp);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t count = 0;
+	int rc = 0;
+	while (count < req->limit) {
+		struct read_view_tuple tuple;
+		rc = index_read_view_iterator_next_raw(&it, &tuple);
+		if (rc != 0 || tuple.data == NULL)
+			break;
+		if (count == IPROTO_STALE_READ_TUPLES_MAX) {
+			rc = -1;
+			break;
+		}
+		xobuf_dup(out, tuple.data, tuple.size);
+		region_truncate(region, region_svp);
+		count++;
+	}
+	region_truncate(region, region_svp);
+	index_read_view_iterator_destroy(&it);
+	if (rc != 0) {
+		obuf_rollback_to_svp(out, &svp);
+		diag_clear(diag_get());
+		return false;
+	}
+	iproto_reply_select(out, &svp, msg->header.sync, view->schema_version,
+			    count, /*box_tuple_as_ext=*/false);
+	iproto_wpos_create(&con->srv[net_srv_id].wend, out);
+
+	msg->push_time = msg->accept_time = start_time;
+	msg->end_time = clock_monotonic();
+	iproto_msg_collect_latency(msg);
+	iproto_msg_finish_input(msg);
+	iproto_connection_feed_output(con);
+	/*
+	 * Stopped connections will be resumed by requests processed
+	 * in tx, don't recurse into iproto_enqueue_batch() here.
+	 */
+	iproto_msg_free(msg);
+	return true;
+}
+
 /**
  * Complete sending an iproto error:
  * recycle the error object and flush output.
@@ -3830,6 +4448,7 @@ tx_process_connect(struct cmsg *m)
 	xobuf_dup(out, greeting, IPROTO_GREETING_SIZE);
 	if (session_run_on_connect_triggers(con->session) != 0)
 		goto error;
+	msg->auth_token = tx_session_auth_token(con->session);
 	iproto_wpos_create(&msg->wpos, out);
 	return;
 error:
@@ -3869,6 +4488,8 @@ net_send_greeting(struct cmsg *m)
 	}
 	con->is_established = true;
 	con->idle_timeout = msg->connect.guest_idle_timeout;
+	if (msg->auth_token >= 0)
+		con->auth_token = msg->auth_token;
 	con->srv[msg->srv_id].wend = msg->wpos;
 	/*
 	 * Connect is synchronous, so no one could have been
@@ -3929,6 +4550,105 @@ iproto_on_accept_cb(struct evio_service *service, struct iostream *io,
 			     /*is_internal=*/false);
 }
 
+/** {{{ Load balancing */
+
+/**
+ * All iproto threads listen on the same sockets, so a new connection is
+ * accepted by whichever thread gets to it first. A thread busy serving a few
+ * chatty connections may be just as quick to do that as an idle one, so the
+ * busy thread stops accepting new connections while its CPU load, in
+ * microseconds per second, exceeds the load of the least loaded iproto
+ * thread by more than this value.
+ */
+enum { IPROTO_THREAD_LOAD_DELTA = 100 * 1000 };
+
+/**
+ * Returns the CPU load of an iproto thread in microseconds per second,
+ * averaged over the last few seconds. May be called from any thread.
+ */
+static int64_t
+iproto_thread_load(struct iproto_thread *iproto_thread)
+{
+	return pm_atomic_load(&iproto_thread->load);
+}
+
+/** Returns the CPU load of the least loaded iproto thread. */
+static int64_t
+iproto_threads_min_load(void)
+{
+	int64_t min_load = INT64_MAX;
+	for (int i = 0; i < iproto_threads_count; i++)
+		min_load = MIN(min_load, iproto_thread_load(&iproto_threads[i]));
+	return min_load;
+}
+
+/**
+ * Returns the id of the iproto thread a new connection should be handed to.
+ * Threads are tried round-robin starting from the given one, which is chosen
+ * unless another thread is considerably less loaded.
+ */
+static int
+iproto_threads_pick(int start)
+{
+	int best = start;
+	int64_t best_load = iproto_thread_load(&iproto_threads[start]);
+	for (int i = 1; i < iproto_threads_count; i++) {
+		int id = (start + i) % iproto_threads_count;
+		int64_t load = iproto_thread_load(&iproto_threads[id]);
+		if (load + IPROTO_THREAD_LOAD_DELTA < best_load) {
+			best = id;
+			best_load = load;
+		}
+	}
+	return best;
+}
+
+/**
+ * Pauses accepting new connections in an overloaded iproto thread and
+ * resumes it once the load evens out. The least loaded thread never stops
+ * accepting, so new connections are always served by someone. The loads of
+ * the other threads may be stale by up to a timer period, but the worst that
+ * can happen is that a new connection waits in the listen backlog until the
+ * next timer tick.
+ */
+static void
+iproto_thread_balance_accept(struct iproto_thread *iproto_thread)
+{
+	int64_t load = iproto_thread_load(iproto_thread);
+	bool is_overloaded =
+		load - iproto_threads_min_load() > IPROTO_THREAD_LOAD_DELTA;
+	if (is_overloaded == iproto_thread->is_accept_paused)
+		return;
+	iproto_thread->is_accept_paused = is_overloaded;
+	if (is_overloaded)
+		evio_service_pause(&iproto_thread->binary);
+	else
+		evio_service_resume(&iproto_thread->binary);
+}
+
+/** Accounts CPU time consumed by an iproto thread and balances accept. */
+static void
+iproto_thread_load_timer_cb(ev_loop *loop, struct ev_timer *watcher,
+			    int events)
+{
+	(void)loop;
+	(void)events;
+	struct iproto_thread *iproto_thread =
+		(struct iproto_thread *)watcher->data;
+	int64_t cpu_time = clock_thread64();
+	int64_t delta = (cpu_time - iproto_thread->cpu_time) / 1000;
+	iproto_thread->cpu_time = cpu_time;
+	ERROR_INJECT_INT(ERRINJ_IPROTO_LOAD,
+			 inj->iparam == (int64_t)iproto_thread->id,
+			 delta = 1000 * 1000);
+	rmean_collect(iproto_thread->rmean, IPROTO_CPU_TIME, delta);
+	pm_atomic_store(&iproto_thread->load,
+			rmean_mean(iproto_thread->rmean, IPROTO_CPU_TIME));
+	iproto_thread_balance_accept(iproto_thread);
+}
+
+/** }}} */
+
 /**
  * Initializes the IPROTO infrastructure in a serving thread.
  */
@@ -3997,6 +4717,13 @@ net_cord_f(va_list  ap)
 	evio_service_create(loop(), &iproto_thread->binary, "binary",
 			    iproto_on_accept_cb, iproto_thread);
 
+	iproto_thread->cpu_time = clock_thread64();
+	pm_atomic_store(&iproto_thread->load, 0);
+	ev_timer_init(&iproto_thread->load_timer, iproto_thread_load_timer_cb,
+		      1, 1);
+	iproto_thread->load_timer.data = iproto_thread;
+	ev_timer_start(loop(), &iproto_thread->load_timer);
+
 	char endpoint_name[ENDPOINT_NAME_MAX];
 	snprintf(endpoint_name, ENDPOINT_NAME_MAX, "net%u",
 		 iproto_thread->id);
@@ -4053,6 +4780,7 @@ net_cord_f(va_list  ap)
 	}
 	/* Destroy "net" endpoint. */
 	cbus_endpoint_destroy(&endpoint, cbus_process);
+	ev_timer_stop(loop(), &iproto_thread->load_timer);
 	evio_service_detach(&iproto_thread->binary);
 
 	mempool_destroy(&iproto_thread->iproto_stream_pool);
@@ -4179,6 +4907,503 @@ iproto_session_notify(struct session *session, uint64_t sync,
 
 /** }}} */
 
+/** {{{ Stale reads */
+
+/** Max age of the stale read view. Stale reads are disabled if 0. */
+static double iproto_stale_read_max_lag;
+
+/** Stale read view used by IPROTO threads or NULL. */
+static struct iproto_stale_read_view *iproto_stale_read_view;
+
+/** Fiber that refreshes the stale read view. */
+static struct fiber *iproto_stale_read_fiber;
+
+/** Read view filter that selects spaces served by IPROTO threads. */
+static bool
+iproto_stale_read_filter_space(struct space *space, void *arg)
+{
+	(void)arg;
+	return space->def->opts.stale_read && !space_is_system(space) &&
+	       space->upgrade == NULL;
+}
+
+/**
+ * Returns the mask of auth tokens of users that may read the given space,
+ * see iproto_stale_read_space::access_mask.
+ */
+static uint32_t
+iproto_stale_read_access_mask(struct space *space)
+{
+	uint32_t mask = 0;
+	struct credentials *orig_credentials = fiber_get_user(fiber());
+	for (int token = 0; token < BOX_USER_MAX; token++) {
+		struct user *user = user_find_by_token(token);
+		if (user->def == NULL || user->def->type != SC_USER)
+			continue;
+		struct credentials credentials;
+		credentials_create(&credentials, user);
+		fiber_set_user(fiber(), &credentials);
+		if (access_check_space(space, PRIV_R) == 0)
+			mask |= 1u << token;
+		else
+			diag_clear(diag_get());
+		fiber_set_user(fiber(), orig_credentials);
+		credentials_destroy(&credentials);
+	}
+	return mask;
+}
+
+/**
+ * Creates a read view of all spaces with the stale_read option. Returns
+ * NULL if there's no such spaces or the read view can't be created.
+ */
+static struct iproto_stale_read_view *
+iproto_stale_read_view_new(double max_lag)
+{
+	/* The triggers must run in tx for each SELECT. */
+	if (!rlist_empty(&box_on_select))
+		return NULL;
+	struct read_view_opts opts;
+	read_view_opts_create(&opts);
+	opts.name = "iproto.stale_read";
+	opts.is_system = true;
+	opts.filter_space = iproto_stale_read_filter_space;
+	opts.enable_data_temporary_spaces = true;
+	double timestamp = clock_monotonic();
+	struct read_view *rv = read_view_new(&opts);
+	if (rv == NULL) {
+		diag_log();
+		return NULL;
+	}
+	int space_count = 0;
+	struct space_read_view *space_rv;
+	read_view_foreach_space(space_rv, rv)
+		space_count++;
+	if (space_count == 0) {
+		read_view_delete(rv);
+		return NULL;
+	}
+	struct iproto_stale_read_view *view = xalloc_object(typeof(*view));
+	view->rv = rv;
+	view->timestamp = timestamp;
+	view->max_lag = max_lag;
+	view->schema_version = ::schema_version;
+	view->spaces = mh_i32ptr_new();
+	view->space_array = xalloc_array(struct iproto_stale_read_space,
+					 space_count);
+	struct iproto_stale_read_space *space = view->space_array;
+	read_view_foreach_space(space_rv, rv) {
+		space->rv = space_rv;
+		space->access_mask = iproto_stale_read_access_mask(
+			space_by_id(space_rv->id));
+		struct mh_i32ptr_node_t node = {space_rv->id, space};
+		mh_i32ptr_put(view->spaces, &node, NULL, NULL);
+		space++;
+	}
+	return view;
+}
+
+static void
+iproto_stale_read_view_delete(struct iproto_stale_read_view *view)
+{
+	read_view_delete(view->rv);
+	mh_i32ptr_delete(view->spaces);
+	free(view->space_array);
+	free(view);
+}
+
+/**
+ * Switches all IPROTO threads to a new stale read view (may be NULL) and
+ * destroys the old one.
+ */
+static void
+iproto_stale_read_view_set(struct iproto_stale_read_view *view)
+{
+	if (view == NULL && iproto_stale_read_view == NULL)
+		return;
+	struct iproto_cfg_msg cfg_msg;
+	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_STALE_READ_VIEW);
+	cfg_msg.stale_read_view = view;
+	for (int i = 0; i < iproto_threads_count; i++)
+		iproto_do_cfg(&iproto_threads[i], &cfg_msg);
+	if (iproto_stale_read_view != NULL)
+		iproto_stale_read_view_delete(iproto_stale_read_view);
+	iproto_stale_read_view = view;
+}
+
+/**
+ * Refreshes the stale read view twice per the max lag so that IPROTO
+ * threads always have a read view that is fresh enough to be used unless
+ * tx is blocked.
+ */
+static int
+iproto_stale_read_f(va_list ap)
+{
+	(void)ap;
+	while (!fiber_is_cancelled()) {
+		double max_lag = iproto_stale_read_max_lag;
+		struct iproto_stale_read_view *view = NULL;
+		if (max_lag > 0 && box_is_configured())
+			view = iproto_stale_read_view_new(max_lag);
+		iproto_stale_read_view_set(view);
+		if (max_lag > 0)
+			fiber_sleep(max_lag / 2);
+		else
+			fiber_yield();
+	}
+	iproto_stale_read_view_set(NULL);
+	return 0;
+}
+
+void
+iproto_set_stale_read_max_lag(double max_lag)
+{
+	iproto_stale_read_max_lag = max_lag;
+	if (iproto_is_shutting_down)
+		return;
+	if (iproto_stale_read_fiber == NULL) {
+		if (max_lag == 0)
+			return;
+		iproto_stale_read_fiber = fiber_new_system(
+			"iproto.stale_read", iproto_stale_read_f);
+		if (iproto_stale_read_fiber == NULL) {
+			diag_log();
+			panic("failed to start stale read fiber");
+		}
+		fiber_set_joinable(iproto_stale_read_fiber, true);
+		fiber_start(iproto_stale_read_fiber);
+		return;
+	}
+	fiber_wakeup(iproto_stale_read_fiber);
+}
+
+/** }}} */
+
+/** {{{ Cursors */
+
+/** Max number of cursors open in a connection. */
+enum { IPROTO_CURSOR_MAX = 64 };
+
+/**
+ * Max size of the tuple data returned by a cursor request. Bigger chunks
+ * are truncated so that a request doesn't stall other connections and the
+ * output buffer stays bounded whatever limit the client asks for.
+ */
+enum { IPROTO_CURSOR_CHUNK_BSIZE_MAX = 1024 * 1024 };
+
+/**
+ * A cursor that isn't used for this long, in seconds, is closed so that
+ * a client that forgot about it doesn't pin the read view forever.
+ */
+static double iproto_cursor_idle_timeout = 300;
+TWEAK_DOUBLE(iproto_cursor_idle_timeout);
+
+/** All open cursors, least recently used first. Used only by tx. */
+static RLIST_HEAD(tx_cursor_lru);
+
+/** Timer that closes idle cursors. Used only by tx. */
+static struct ev_timer tx_cursor_timer;
+
+/**
+ * Server-side cursor open with IPROTO_CURSOR_OPEN. It iterates over a read
+ * view of the index so it doesn't see changes made after it was open and
+ * doesn't pin any tx resources between requests. Used only by tx.
+ */
+struct iproto_cursor {
+	/** Cursor id, unique within the connection. */
+	uint64_t id;
+	/** Connection that opened the cursor. */
+	struct iproto_connection *con;
+	/** Time of the last use of the cursor, see ev_monotonic_now(). */
+	double last_used;
+	/** Link in tx_cursor_lru. */
+	struct rlist in_lru;
+	/** Read view of the iterated index. */
+	struct read_view *rv;
+	/** Iterator over the index read view. */
+	struct index_read_view_iterator it;
+	/** Search key, referenced by the iterator. */
+	char key[0];
+};
+
+/** Read view filter that selects the space of a cursor. */
+static bool
+iproto_cursor_filter_space(struct space *space, void *arg)
+{
+	struct request *req = (struct request *)arg;
+	return space->def->id == req->space_id && space->upgrade == NULL;
+}
+
+/** Read view filter that selects the index of a cursor. */
+static bool
+iproto_cursor_filter_index(struct space *space, struct index *index,
+			   void *arg)
+{
+	(void)space;
+	struct request *req = (struct request *)arg;
+	return index->def->iid == req->index_id;
+}
+
+/**
+ * Marks a cursor as just used: moves it to the end of the LRU list and
+ * arms the idle timer unless it's going to fire before the cursor expires
+ * (the timeout may have been decreased since the timer was armed).
+ */
+static void
+tx_touch_cursor(struct iproto_cursor *cursor)
+{
+	cursor->last_used = ev_monotonic_now(loop());
+	rlist_move_tail_entry(&tx_cursor_lru, cursor, in_lru);
+	if (ev_is_active(&tx_cursor_timer) &&
+	    ev_timer_remaining(loop(), &tx_cursor_timer) <=
+	    iproto_cursor_idle_timeout)
+		return;
+	ev_timer_stop(loop(), &tx_cursor_timer);
+	ev_timer_set(&tx_cursor_timer, iproto_cursor_idle_timeout, 0);
+	ev_timer_start(loop(), &tx_cursor_timer);
+}
+
+/**
+ * Opens a cursor for an IPROTO_CURSOR_OPEN request. On error, returns NULL
+ * and sets diag.
+ */
+static struct iproto_cursor *
+tx_open_cursor(struct iproto_connection *con, struct request *req)
+{
+	if (req->iterator >= iterator_type_MAX) {
+		diag_set(IllegalParams, "Invalid iterator type");
+		return NULL;
+	}
+	struct space *space = space_cache_find(req->space_id);
+	if (space == NULL)
+		return NULL;
+	if (access_check_space(space, PRIV_R) != 0)
+		return NULL;
+	struct index *index = index_find(space, req->index_id);
+	if (index == NULL)
+		return NULL;
+	enum iterator_type type = (enum iterator_type)req->iterator;
+	const char *key = req->key;
+	uint32_t part_count = mp_decode_array(&key);
+	if (iterator_validate(index->def, type, key, part_count) != 0)
+		return NULL;
+	if (con->tx.cursors != NULL &&
+	    mh_size(con->tx.cursors) >= IPROTO_CURSOR_MAX) {
+		diag_set(ClientError, ER_CURSOR_LIMIT, IPROTO_CURSOR_MAX);
+		return NULL;
+	}
+	box_run_on_select(space, index, type, req->key);
+
+	struct read_view_opts opts;
+	read_view_opts_create(&opts);
+	opts.name = "iproto.cursor";
+	opts.is_system = true;
+	opts.filter_space = iproto_cursor_filter_space;
+	opts.filter_index = iproto_cursor_filter_index;
+	opts.filter_arg = req;
+	opts.enable_data_temporary_spaces = space_is_data_temporary(space);
+	struct read_view *rv = read_view_new(&opts);
+	if (rv == NULL)
+		return NULL;
+	struct index_read_view *index_rv = NULL;
+	struct space_read_view *space_rv;
+	read_view_foreach_space(space_rv, rv)
+		index_rv = space_read_view_index(space_rv, req->index_id);
+	if (index_rv == NULL) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Cursor",
+			 tt_sprintf("%s index of %s space",
+				    index_type_strs[index->def->type],
+				    space->engine->name));
+		read_view_delete(rv);
+		return NULL;
+	}
+	size_t key_size = req->key_end - req->key;
+	struct iproto_cursor *cursor =
+		(struct iproto_cursor *)xmalloc(sizeof(*cursor) + key_size);
+	memcpy(cursor->key, req->key, key_size);
+	key = cursor->key;
+	mp_decode_array(&key);
+	if (index_read_view_create_iterator_with_offset(
+			index_rv, type, key, part_count, /*pos=*/NULL,
+			req->offset, &cursor->it) != 0) {
+		free(cursor);
+		read_view_delete(rv);
+		return NULL;
+	}
+	cursor->rv = rv;
+	cursor->id = ++con->tx.last_cursor_id;
+	cursor->con = con;
+	rlist_create(&cursor->in_lru);
+	tx_touch_cursor(cursor);
+	if (con->tx.cursors == NULL)
+		con->tx.cursors = mh_i64ptr_new();
+	struct mh_i64ptr_node_t node = {cursor->id, cursor};
+	mh_i64ptr_put(con->tx.cursors, &node, NULL, NULL);
+	return cursor;
+}
+
+/** Looks up an open cursor. On error, returns NULL and sets diag. */
+static struct iproto_cursor *
+tx_find_cursor(struct iproto_connection *con, uint64_t id)
+{
+	struct mh_i64ptr_t *h = con->tx.cursors;
+	if (h != NULL) {
+		mh_int_t k = mh_i64ptr_find(h, id, NULL);
+		if (k != mh_end(h))
+			return (struct iproto_cursor *)mh_i64ptr_node(h, k)->val;
+	}
+	diag_set(ClientError, ER_NO_SUCH_CURSOR, id);
+	return NULL;
+}
+
+/** Closes a cursor and removes it from the connection. */
+static void
+tx_close_cursor(struct iproto_connection *con, struct iproto_cursor *cursor)
+{
+	mh_i64ptr_del(con->tx.cursors,
+		      mh_i64ptr_find(con->tx.cursors, cursor->id, NULL), NULL);
+	rlist_del_entry(cursor, in_lru);
+	index_read_view_iterator_destroy(&cursor->it);
+	read_view_delete(cursor->rv);
+	TRASH(cursor);
+	free(cursor);
+}
+
+static void
+tx_close_cursors(struct iproto_connection *con)
+{
+	struct mh_i64ptr_t *h = con->tx.cursors;
+	if (h == NULL)
+		return;
+	mh_int_t k;
+	mh_foreach(h, k) {
+		struct iproto_cursor *cursor =
+			(struct iproto_cursor *)mh_i64ptr_node(h, k)->val;
+		rlist_del_entry(cursor, in_lru);
+		index_read_view_iterator_destroy(&cursor->it);
+		read_view_delete(cursor->rv);
+		free(cursor);
+	}
+	mh_i64ptr_delete(h);
+	con->tx.cursors = NULL;
+}
+
+/**
+ * Closes cursors that have been idle for longer than the timeout and
+ * rearms the timer for the next one.
+ */
+static void
+tx_cursor_timer_cb(ev_loop *loop, struct ev_timer *watcher, int /*revents*/)
+{
+	double now = ev_monotonic_now(loop);
+	struct iproto_cursor *cursor, *next;
+	rlist_foreach_entry_safe(cursor, &tx_cursor_lru, in_lru, next) {
+		double deadline = cursor->last_used +
+				  iproto_cursor_idle_timeout;
+		if (deadline > now) {
+			ev_timer_set(watcher, deadline - now, 0);
+			ev_timer_start(loop, watcher);
+			return;
+		}
+		say_info("closing cursor %llu: idle for %.1f second(s)",
+			 (unsigned long long)cursor->id,
+			 now - cursor->last_used);
+		tx_close_cursor(cursor->con, cursor);
+	}
+}
+
+/**
+ * Writes up to @a limit next tuples of a cursor to the output buffer.
+ * Sets @a is_eof if the cursor is exhausted. Returns 0 on success.
+ * On error, returns -1 and sets diag.
+ */
+static int
+tx_fetch_cursor(struct iproto_cursor *cursor, uint32_t limit,
+		struct obuf *out, uint32_t *count, bool *is_eof)
+{
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t bsize = 0;
+	int rc = 0;
+	*count = 0;
+	*is_eof = false;
+	while (*count < limit && bsize < IPROTO_CURSOR_CHUNK_BSIZE_MAX) {
+		struct read_view_tuple tuple;
+		rc = index_read_view_iterator_next_raw(&cursor->it, &tuple);
+		if (rc != 0)
+			break;
+		if (tuple.data == NULL) {
+			*is_eof = true;
+			break;
+		}
+		xobuf_dup(out, tuple.data, tuple.size);
+		region_truncate(region, region_svp);
+		bsize += tuple.size;
+		(*count)++;
+	}
+	region_truncate(region, region_svp);
+	return rc;
+}
+
+static void
+tx_process_cursor(struct cmsg *m)
+{
+	struct iproto_msg *msg = tx_accept_msg(m);
+	struct iproto_connection *con = msg->connection;
+	struct request *req = &msg->dml;
+	struct iproto_cursor *cursor;
+	struct obuf *out;
+	struct obuf_svp svp;
+	uint32_t count;
+	bool is_eof;
+	if (tx_check_msg(msg) != 0)
+		goto error;
+
+	rmean_collect(rmean_box, req->type, 1);
+	tx_inject_delay();
+	if (req->type == IPROTO_CURSOR_OPEN) {
+		if (tx_resolve_space_and_index_name(req) != 0)
+			goto error;
+		cursor = tx_open_cursor(con, req);
+	} else {
+		cursor = tx_find_cursor(con, req->cursor_id);
+		if (cursor != NULL)
+			tx_touch_cursor(cursor);
+	}
+	if (cursor == NULL)
+		goto error;
+
+	out = iproto_msg_obuf(msg);
+	if (req->type == IPROTO_CURSOR_CLOSE) {
+		tx_close_cursor(con, cursor);
+		svp = obuf_create_svp(out);
+		iproto_reply_ok(out, msg->header.sync, ::schema_version);
+		iproto_wpos_create(&msg->wpos, out);
+		tx_end_msg(msg, &svp);
+		return;
+	}
+	iproto_prepare_select(out, &svp);
+	if (tx_fetch_cursor(cursor, req->limit, out, &count, &is_eof) != 0) {
+		obuf_rollback_to_svp(out, &svp);
+		tx_close_cursor(con, cursor);
+		goto error;
+	}
+	iproto_reply_cursor(out, &svp, msg->header.sync, ::schema_version,
+			    count, is_eof ? 0 : cursor->id);
+	if (is_eof)
+		tx_close_cursor(con, cursor);
+	iproto_wpos_create(&msg->wpos, out);
+	tx_end_msg(msg, &svp);
+	return;
+error:
+	out = iproto_msg_obuf(msg);
+	svp = obuf_create_svp(out);
+	tx_reply_error(msg);
+	tx_end_msg(msg, &svp);
+}
+
+/** }}} */
+
 /**
  * Stops accepting new connections on shutdown.
  */
@@ -4193,6 +5418,11 @@ iproto_on_shutdown_f(void *arg)
 	for (int i = 0; i < iproto_threads_count; i++)
 		iproto_do_cfg(&iproto_threads[i], &cfg_msg);
 	evio_service_stop(&tx_binary);
+	if (iproto_stale_read_fiber != NULL) {
+		fiber_cancel(iproto_stale_read_fiber);
+		fiber_join(iproto_stale_read_fiber);
+		iproto_stale_read_fiber = NULL;
+	}
 	return 0;
 }
 
@@ -4220,6 +5450,13 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	iproto_thread->misc_route[1] = {net_send_msg, NULL};
 	iproto_thread->select_route[0] = {tx_process_select, net_pipe};
 	iproto_thread->select_route[1] = {net_send_msg, NULL};
+	iproto_thread->select_multi_route[0] =
+		{tx_process_select_multi, net_pipe};
+	iproto_thread->select_multi_route[1] = {net_send_msg, NULL};
+	iproto_thread->select_release_route[0] = {tx_release_select, net_pipe};
+	iproto_thread->select_release_route[1] = {net_end_select, NULL};
+	iproto_thread->cursor_route[0] = {tx_process_cursor, net_pipe};
+	iproto_thread->cursor_route[1] = {net_send_msg, NULL};
 	iproto_thread->process1_route[0] = {tx_process1, net_pipe};
 	iproto_thread->process1_route[1] = {net_send_msg, NULL};
 	iproto_thread->sql_route[0] = {tx_process_sql, net_pipe};
@@ -4242,6 +5479,10 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	dml_route[IPROTO_UPSERT] = iproto_thread->process1_route;
 	dml_route[IPROTO_INSERT_ARROW] = iproto_thread->process1_route;
 	assert(dml_route[IPROTO_DELETE_RANGE] == NULL); /* Unuspported yet. */
+	dml_route[IPROTO_SELECT_MULTI] = iproto_thread->select_multi_route;
+	dml_route[IPROTO_CURSOR_OPEN] = iproto_thread->cursor_route;
+	dml_route[IPROTO_CURSOR_FETCH] = iproto_thread->cursor_route;
+	dml_route[IPROTO_CURSOR_CLOSE] = iproto_thread->cursor_route;
 
 	iproto_thread->connect_route[0] = {tx_process_connect, net_pipe};
 	iproto_thread->connect_route[1] = {net_send_greeting, NULL};
@@ -4277,11 +5518,15 @@ iproto_thread_init(struct iproto_thread *iproto_thread, int srv_count)
 	/* Init statistics counter */
 	iproto_thread->rmean = rmean_new(rmean_net_strings, RMEAN_NET_LAST);
 	iproto_thread->tx.rmean = rmean_new(rmean_tx_strings, RMEAN_TX_LAST);
+	if (iproto_latency_create(&iproto_thread->latency) != 0)
+		panic("failed to allocate iproto latency statistics");
 	rlist_create(&iproto_thread->stopped_connections);
 	iproto_thread->tx.requests_in_progress = 0;
 	iproto_thread->requests_in_stream_queue = 0;
 	rlist_create(&iproto_thread->connections);
 	iproto_thread->connection_count = 0;
+	iproto_thread->is_accept_paused = false;
+	iproto_thread->stale_read_view = NULL;
 }
 
 /**
@@ -4463,6 +5708,7 @@ iproto_init(int threads_count)
 	iproto_threads = xalloc_array(struct iproto_thread, threads_count);
 	memset(iproto_threads, 0, sizeof(struct iproto_thread) * threads_count);
 	fiber_cond_create(&drop_finished_cond);
+	ev_timer_init(&tx_cursor_timer, tx_cursor_timer_cb, 0, 0);
 
 	int srv_count = app_thread_count + 1;
 	for (int i = 0; i < threads_count; i++, iproto_threads_count++) {
@@ -4568,6 +5814,8 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 		if (iproto_thread->is_shutting_down)
 			break;
 		evio_service_attach(binary, &tx_binary);
+		if (iproto_thread->is_accept_paused)
+			evio_service_pause(binary);
 		break;
 	case IPROTO_CFG_SHUTDOWN:
 		iproto_thread->is_shutting_down = true;
@@ -4578,12 +5826,23 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 	case IPROTO_CFG_RESTART:
 		evio_service_detach(binary);
 		evio_service_attach(binary, &tx_binary);
+		if (iproto_thread->is_accept_paused)
+			evio_service_pause(binary);
 		break;
 	case IPROTO_CFG_STAT:
 		iproto_fill_stat(iproto_thread, cfg_msg);
 		break;
 	case IPROTO_CFG_RESET_STAT:
 		rmean_cleanup(iproto_thread->rmean);
+		iproto_latency_reset(&iproto_thread->latency);
+		break;
+	case IPROTO_CFG_LATENCY:
+		for (int i = 0; i < iproto_latency_type_MAX; i++) {
+			for (int j = 0; j < iproto_latency_stage_MAX; j++) {
+				latency_merge(&cfg_msg->latency->stage[i][j],
+					      &iproto_thread->latency.stage[i][j]);
+			}
+		}
 		break;
 	case IPROTO_CFG_OVERRIDE:
 		if (cfg_msg->override.is_set) {
@@ -4657,6 +5916,9 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 				cfg_msg->drop_connections.generation);
 		break;
 	}
+	case IPROTO_CFG_STALE_READ_VIEW:
+		iproto_thread->stale_read_view = cfg_msg->stale_read_view;
+		break;
 	default:
 		unreachable();
 	}
@@ -4839,6 +6101,87 @@ iproto_thread_stats_get(struct iproto_stats *stats, int thread_id)
 		iproto_threads[thread_id].tx.requests_in_progress;
 }
 
+const char *iproto_latency_type_strs[] = {
+	"SELECT",
+	"INSERT",
+	"REPLACE",
+	"UPDATE",
+	"DELETE",
+	"UPSERT",
+	"CALL",
+	"EVAL",
+	"EXECUTE",
+	"PREPARE",
+	"OTHER",
+};
+
+static_assert(lengthof(iproto_latency_type_strs) == iproto_latency_type_MAX,
+	      "iproto_latency_type_strs doesn't match iproto_latency_type");
+
+const char *iproto_latency_stage_strs[] = {
+	"NET_QUEUE",
+	"TX_QUEUE",
+	"EXEC",
+	"TOTAL",
+};
+
+static_assert(lengthof(iproto_latency_stage_strs) == iproto_latency_stage_MAX,
+	      "iproto_latency_stage_strs doesn't match iproto_latency_stage");
+
+int
+iproto_latency_create(struct iproto_latency *latency)
+{
+	for (int i = 0; i < iproto_latency_type_MAX; i++) {
+		for (int j = 0; j < iproto_latency_stage_MAX; j++) {
+			if (latency_create(&latency->stage[i][j]) == 0)
+				continue;
+			while (j-- > 0)
+				latency_destroy(&latency->stage[i][j]);
+			while (i-- > 0) {
+				for (j = 0; j < iproto_latency_stage_MAX; j++)
+					latency_destroy(&latency->stage[i][j]);
+			}
+			return -1;
+		}
+	}
+	return 0;
+}
+
+void
+iproto_latency_destroy(struct iproto_latency *latency)
+{
+	for (int i = 0; i < iproto_latency_type_MAX; i++) {
+		for (int j = 0; j < iproto_latency_stage_MAX; j++)
+			latency_destroy(&latency->stage[i][j]);
+	}
+}
+
+void
+iproto_latency_reset(struct iproto_latency *latency)
+{
+	for (int i = 0; i < iproto_latency_type_MAX; i++) {
+		for (int j = 0; j < iproto_latency_stage_MAX; j++)
+			latency_reset(&latency->stage[i][j]);
+	}
+}
+
+void
+iproto_latency_get(struct iproto_latency *latency)
+{
+	for (int i = 0; i < iproto_threads_count; i++)
+		iproto_thread_latency_get(latency, i);
+}
+
+void
+iproto_thread_latency_get(struct iproto_latency *latency, int thread_id)
+{
+	assert(thread_id >= 0 && thread_id < iproto_threads_count);
+	struct iproto_cfg_msg cfg_msg;
+	iproto_cfg_msg_create(&cfg_msg, IPROTO_CFG_LATENCY);
+	cfg_msg.latency = latency;
+	iproto_do_cfg(&iproto_threads[thread_id], &cfg_msg);
+}
+
 void
 iproto_reset_stat(void)
 {
@@ -4888,7 +6231,8 @@ iproto_session_new(struct iostream *io, struct user *user, uint64_t *sid)
 	cfg_msg->session_new.user_name = user_name;
 	static int thread = 0;
 	thread = (thread + 1) % iproto_threads_count;
-	iproto_do_cfg_async(&iproto_threads[thread], cfg_msg);
+	iproto_do_cfg_async(&iproto_threads[iproto_threads_pick(thread)],
+			    cfg_msg);
 	*sid = session->id;
 	return 0;
 }
@@ -4956,6 +6300,7 @@ iproto_shutdown(double timeout)
 void
 iproto_free(void)
 {
+	ev_timer_stop(loop(), &tx_cursor_timer);
 	for (int i = 0; i < iproto_threads_count; i++) {
 		mh_int_t j;
 		struct mh_strnptr_t *funcs = iproto_threads[i].funcs;
@@ -4971,6 +6316,7 @@ iproto_free(void)
 		evio_service_detach(&iproto_threads[i].binary);
 		rmean_delete(iproto_threads[i].rmean);
 		rmean_delete(iproto_threads[i].tx.rmean);
+		iproto_latency_destroy(&iproto_threads[i].latency);
 		slab_cache_destroy(&iproto_threads[i].srv[0].net_slabc);
 		free(iproto_threads[i].srv);
 	}
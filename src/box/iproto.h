@@ -35,6 +35,7 @@
 #include <stdint.h>
 
 #include "box/box.h"
+#include "latency.h"
 
 struct uri_set;
 struct session;
@@ -79,6 +80,64 @@ struct iproto_stats {
 	size_t requests_in_stream_queue;
 };
 
+/** Request types with separate latency statistics. */
+enum iproto_latency_type {
+	IPROTO_LATENCY_SELECT,
+	IPROTO_LATENCY_INSERT,
+	IPROTO_LATENCY_REPLACE,
+	IPROTO_LATENCY_UPDATE,
+	IPROTO_LATENCY_DELETE,
+	IPROTO_LATENCY_UPSERT,
+	IPROTO_LATENCY_CALL,
+	IPROTO_LATENCY_EVAL,
+	IPROTO_LATENCY_EXECUTE,
+	IPROTO_LATENCY_PREPARE,
+	/** All other request types. */
+	IPROTO_LATENCY_OTHER,
+	iproto_latency_type_MAX,
+};
+
+extern const char *iproto_latency_type_strs[];
+
+/** Stages of request processing with separate latency statistics. */
+enum iproto_latency_stage {
+	/**
+	 * From reading a request in an iproto thread to sending it to
+	 * a serving thread (tx or app). Includes waiting in a stream queue.
+	 */
+	IPROTO_LATENCY_NET_QUEUE,
+	/** Waiting in the serving thread queue. */
+	IPROTO_LATENCY_TX_QUEUE,
+	/** Executing the request in the serving thread. */
+	IPROTO_LATENCY_EXEC,
+	/** From reading a request to sending the response back. */
+	IPROTO_LATENCY_TOTAL,
+	iproto_latency_stage_MAX,
+};
+
+extern const char *iproto_latency_stage_strs[];
+
+/** Latency statistics of iproto requests. */
+struct iproto_latency {
+	/** Latency counters by request type and processing stage. */
+	struct latency stage[iproto_latency_type_MAX][iproto_latency_stage_MAX];
+};
+
+/**
+ * Initialize iproto latency statistics.
+ * Return 0 on success, -1 on OOM.
+ */
+int
+iproto_latency_create(struct iproto_latency *latency);
+
+/** Destroy iproto latency statistics. */
+void
+iproto_latency_destroy(struct iproto_latency *latency);
+
+/** Reset iproto latency statistics. */
+void
+iproto_latency_reset(struct iproto_latency *latency);
+
 extern unsigned iproto_readahead;
 extern int iproto_threads_count;
 
@@ -95,6 +154,20 @@ iproto_stats_get(struct iproto_stats *stats);
 void
 iproto_thread_stats_get(struct iproto_stats *stats, int thread_id);
 
+/**
+ * Add latency statistics of requests processed by all iproto threads
+ * to @a latency.
+ */
+void
+iproto_latency_get(struct iproto_latency *latency);
+
+/**
+ * Same as iproto_latency_get(), but collects statistics of the thread
+ * with the given id only.
+ */
+void
+iproto_thread_latency_get(struct iproto_latency *latency, int thread_id);
+
 /**
  * Reset network statistics.
  */
@@ -155,6 +228,14 @@ iproto_listen(const struct uri_set *uri_set);
 int
 iproto_set_msg_max(int iproto_msg_max);
 
+/**
+ * Sets the max staleness of the read view used by IPROTO threads to serve
+ * SELECT requests for spaces with the stale_read option. Zero disables
+ * serving requests in IPROTO threads.
+ */
+void
+iproto_set_stale_read_max_lag(double max_lag);
+
 /**
  * Creates a new IPROTO session over the given IO stream. Doesn't yield.
  * Set the output parameter sid to the sid of newly created session.
@@ -53,6 +53,10 @@ const uint64_t iproto_body_key_map[IPROTO_TYPE_STAT_MAX] = {
 	0,                                                    /* ROLLBACK */
 	bit(SPACE_ID) | bit(ARROW),                           /* INSERT_ARROW */
 	bit(SPACE_ID) | bit(BEGIN_KEY) | bit(END_KEY),        /* DELETE_RANGE */
+	bit(SPACE_ID) | bit(KEY_LIST),                        /* SELECT_MULTI */
+	bit(SPACE_ID) | bit(KEY),                             /* CURSOR_OPEN */
+	bit(CURSOR_ID) | bit(LIMIT),                          /* CURSOR_FETCH */
+	bit(CURSOR_ID),                                       /* CURSOR_CLOSE */
 };
 #undef bit
 
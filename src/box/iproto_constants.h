@@ -164,6 +164,10 @@ extern const char *iproto_flag_bit_strs[];
 	_(BEGIN_KEY, 0x37, MP_ARRAY)					\
 	/** The key to operate until. */				\
 	_(END_KEY, 0x38, MP_ARRAY)					\
+	/** Search keys of IPROTO_SELECT_MULTI request. */		\
+	_(KEY_LIST, 0x39, MP_ARRAY)					\
+	/** Server-side cursor id, see IPROTO_CURSOR_OPEN. */		\
+	_(CURSOR_ID, 0x3a, MP_UINT)					\
 									\
 	/* Leave a gap between response keys and SQL keys. */		\
 	_(SQL_TEXT, 0x40, MP_STR)					\
@@ -369,6 +373,34 @@ iproto_key_bit(unsigned char key)
 	_(INSERT_ARROW, 17)						\
 	/** DELETE range request. */					\
 	_(DELETE_RANGE, 18)						\
+	/**
+	 * SELECT request with a list of keys (IPROTO_KEY_LIST) instead of
+	 * a single key. The iterator, offset, and limit apply to each key.
+	 * The response IPROTO_DATA is an array of tuple arrays, one per key.
+	 */								\
+	_(SELECT_MULTI, 19)						\
+	/**
+	 * The following three requests implement server-side cursors,
+	 * which are used for fetching big result sets in chunks:
+	 *
+	 *  1. IPROTO_CURSOR_OPEN takes the same arguments as IPROTO_SELECT,
+	 *     except for pagination, and opens a cursor over a read view
+	 *     of the index. IPROTO_LIMIT sets the number of tuples returned
+	 *     in the response.
+	 *  2. IPROTO_CURSOR_FETCH returns up to IPROTO_LIMIT next tuples of
+	 *     the cursor with the given IPROTO_CURSOR_ID. The server may
+	 *     return fewer tuples to limit the response size.
+	 *  3. IPROTO_CURSOR_CLOSE closes the cursor with the given
+	 *     IPROTO_CURSOR_ID.
+	 *
+	 * The response to IPROTO_CURSOR_OPEN and IPROTO_CURSOR_FETCH contains
+	 * IPROTO_DATA with the tuples and IPROTO_CURSOR_ID if the cursor is
+	 * still open. A cursor is closed automatically once it is exhausted
+	 * and when the connection is closed.
+	 */								\
+	_(CURSOR_OPEN, 20)						\
+	_(CURSOR_FETCH, 21)						\
+	_(CURSOR_CLOSE, 22)						\
 									\
 	_(RAFT, 30)							\
 	/** PROMOTE request. */						\
@@ -452,7 +484,7 @@ enum iproto_type {
 	IPROTO_UNKNOWN = -1,
 
 	/** The maximum typecode used for box.stat() */
-	IPROTO_TYPE_STAT_MAX = IPROTO_DELETE_RANGE + 1,
+	IPROTO_TYPE_STAT_MAX = IPROTO_CURSOR_CLOSE + 1,
 
 	/** Vinyl run info stored in .index file */
 	VY_INDEX_RUN_INFO = 100,
@@ -549,7 +581,9 @@ iproto_type_is_dml(uint16_t type)
 {
 	return (type >= IPROTO_SELECT && type <= IPROTO_DELETE) ||
 		type == IPROTO_UPSERT || type == IPROTO_NOP ||
-		type == IPROTO_INSERT_ARROW || type == IPROTO_DELETE_RANGE;
+		type == IPROTO_INSERT_ARROW || type == IPROTO_DELETE_RANGE ||
+		type == IPROTO_SELECT_MULTI || type == IPROTO_CURSOR_OPEN ||
+		type == IPROTO_CURSOR_FETCH || type == IPROTO_CURSOR_CLOSE;
 }
 
 /**
@@ -634,8 +668,10 @@ request_replace_body_create(struct request_replace_body *body,
 	_(BLOOM_FILTER_LEGACY_V2, 7)					\
 	/** Number of statements of each type (map). */			\
 	_(STMT_STAT, 8)							\
+	/** Legacy bloom filter implementation. */			\
+	_(BLOOM_FILTER_LEGACY_V3, 9)					\
 	/** Bloom filter for keys. */					\
-	_(BLOOM_FILTER, 9)						\
+	_(BLOOM_FILTER, 10)						\
 
 #define VY_RUN_INFO_KEY_MEMBER(s, v) VY_RUN_INFO_ ## s = v,
 
@@ -120,6 +120,19 @@ extern "C" {
 	 * Available since IPROTO protocol version 10.
 	 */								\
 	_(INSERT_ARROW, 12)						\
+	/**
+	 * IPROTO_SELECT_MULTI request support.
+	 *
+	 * Available since IPROTO protocol version 11.
+	 */								\
+	_(SELECT_MULTI, 13)						\
+	/**
+	 * IPROTO_CURSOR_OPEN, IPROTO_CURSOR_FETCH, and IPROTO_CURSOR_CLOSE
+	 * request support.
+	 *
+	 * Available since IPROTO protocol version 12.
+	 */								\
+	_(CURSORS, 14)							\
 
 #define IPROTO_FEATURE_MEMBER(s, v) IPROTO_FEATURE_ ## s = v,
 
@@ -144,7 +157,7 @@ struct iproto_features {
  * `box.iproto.protocol_version` needs to be updated correspondingly.
  */
 enum {
-	IPROTO_CURRENT_VERSION = 10,
+	IPROTO_CURRENT_VERSION = 12,
 };
 
 /**
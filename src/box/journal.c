@@ -40,9 +40,15 @@ journal_on_cascading_rollback_nop(void)
 {
 }
 
+static void
+journal_on_submit_nop(void)
+{
+}
+
 struct journal *current_journal = NULL;
 journal_on_cascading_rollback_f journal_on_cascading_rollback =
 	journal_on_cascading_rollback_nop;
+journal_on_submit_f journal_on_submit = journal_on_submit_nop;
 
 struct journal_queue journal_queue = {
 	.max_size = 16 * 1024 * 1024, /* 16 megabytes */
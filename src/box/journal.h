@@ -57,6 +57,9 @@ typedef int
 typedef void
 (*journal_on_cascading_rollback_f)(void);
 
+typedef void
+(*journal_on_submit_f)(void);
+
 typedef int
 (*journal_begin_checkpoint_f)(struct journal *journal,
 			      struct journal_checkpoint *out);
@@ -292,6 +295,12 @@ extern struct journal *current_journal;
  * callback is fired.
  */
 extern journal_on_cascading_rollback_f journal_on_cascading_rollback;
+/**
+ * The callback invoked after an entry is successfully submitted to the
+ * journal. Entries submitted from it get into the same journal batch as the
+ * submitted one, unless the batch is flushed already. It must not yield.
+ */
+extern journal_on_submit_f journal_on_submit;
 
 /** Write a single row in a blocking way. */
 int
@@ -325,6 +334,7 @@ journal_write_submit(struct journal_entry *entry)
 		journal_queue_rollback();
 		return -1;
 	}
+	journal_on_submit();
 	return 0;
 }
 
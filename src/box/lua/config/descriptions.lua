@@ -1783,6 +1783,15 @@ I['iproto.listen.*.uri'] = format_text([[
     in the URI string. Use the `iproto.listen.*.params` for them.
 ]])
 
+I['iproto.net_box_io_threads'] = format_text([[
+    The number of threads doing socket I/O for outgoing `net.box`
+    connections. By default (0), a connection reads and writes its socket in
+    the thread that owns it. If set, the socket of a connection opened from
+    the main thread is served by one of the I/O threads, which also split
+    the input into packets, so the main thread only encodes requests and
+    decodes responses. SSL connections always do I/O in the owner thread.
+]])
+
 I['iproto.net_msg_max'] = format_text([[
     To handle messages, Tarantool allocates fibers. To prevent fiber overhead
     from affecting the whole system, Tarantool restricts how many messages the
@@ -1816,6 +1825,17 @@ I['iproto.readahead'] = format_bytes_text([[
     leave this setting at its default.
 ]])
 
+I['iproto.stale_read_max_lag'] = format_duration_text([[
+    The maximum staleness (in seconds) of data returned by SELECT requests
+    that IProto threads serve on their own for spaces created with the
+    `stale_read` option. Such requests are served from a read view that
+    is refreshed in the background and never reach the main thread, so
+    they don't compete with writes, but they may miss recent changes.
+
+    The default value is 0, which means all requests are processed in
+    the main thread.
+]])
+
 I['iproto.ssl'] = format_text([[
     SSL parameters required for encrypted connections. These parameters would be
     used to set up SSL IProto sockets and to connect to other instances which
@@ -2536,6 +2556,16 @@ I['replication.sync_timeout'] = format_duration_text([[
     If `replication.sync_timeout` expires, the replica enters `orphan` status.
 ]])
 
+I['replication.synchro_confirm_delay'] = format_duration_text([[
+    The maximum time (in seconds) the master may delay writing a CONFIRM
+    request for synchronous transactions that gathered a quorum, waiting for
+    another WAL write to join. The request is then written in the same WAL
+    batch and doesn't cost a separate write and fsync, which helps under a
+    high synchronous write load at the cost of the commit latency.
+
+    The default value is 0, which means CONFIRM is written right away.
+]])
+
 I['replication.synchro_queue_max_size'] = format_bytes_text([[
     Puts a limit on the number of transactions in the master synchronous queue.
 
@@ -2904,6 +2934,13 @@ I['snapshot.by.wal_size'] = format_bytes_text([[
     snapshot and delete old WAL files.
 ]])
 
+I['snapshot.compress_threads'] = format_text([[
+    The number of threads compressing a snapshot. Snapshot creation is
+    usually bound on zstd compression, so using more threads speeds it up
+    on a multi-core machine. The snapshot file format doesn't depend on
+    this option.
+]])
+
 I['snapshot.count'] = format_text([[
     The maximum number of snapshots that are stored in the `snapshot.dir`
     directory. If the number of snapshots after creating a new one exceeds
@@ -2912,6 +2949,16 @@ I['snapshot.count'] = format_text([[
     old snapshots.
 ]])
 
+I['snapshot.delta_count'] = format_text([[
+    The maximum number of delta snapshots written in a row on top of a full
+    snapshot. A delta snapshot only contains the tuples changed since the
+    previous snapshot, so it's much faster to write if only a small part of
+    the data changes between snapshots. On recovery, the full snapshot is
+    loaded and then the delta snapshots are applied on top of it. A full
+    snapshot is written once the limit is reached or if the schema has
+    changed since the previous snapshot. Zero disables delta snapshots.
+]])
+
 I['snapshot.dir'] = format_text([[
     A directory where memtx stores snapshot (`.snap`) files. A relative path
     in this option is interpreted as relative to `process.work_dir`.
@@ -3020,6 +3067,11 @@ I['vinyl.memory'] = format_bytes_text([[
     The maximum number of in-memory bytes that vinyl uses.
 ]])
 
+I['vinyl.page_cache'] = format_bytes_text([[
+    The size of the cache of decompressed vinyl run pages shared by all
+    indexes. Zero disables the cache. The cache can be resized dynamically.
+]])
+
 I['vinyl.page_size'] = format_bytes_text([[
     The page size. A page is a read/write unit for vinyl disk operations.
     The `vinyl.page_size` setting is a default value for the page_size option
@@ -919,6 +919,12 @@ return schema.new('instance_config', schema.record({
             box_cfg_nondynamic = true,
             default = 1,
         }),
+        net_box_io_threads = schema.scalar({
+            type = 'integer',
+            box_cfg = 'net_box_io_threads',
+            box_cfg_nondynamic = true,
+            default = 0,
+        }),
         net_msg_max = schema.scalar({
             type = 'integer',
             box_cfg = 'net_msg_max',
@@ -929,6 +935,11 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'readahead',
             default = 16320,
         })),
+        stale_read_max_lag = duration(schema.scalar({
+            type = 'number',
+            box_cfg = 'iproto_stale_read_max_lag',
+            default = 0,
+        })),
         ssl = enterprise_edition(schema.record({
             ca_file = schema.scalar({
                 type = 'string',
@@ -1117,6 +1128,11 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'vinyl_memory',
             default = 128 * 1024 * 1024,
         })),
+        page_cache = byte_size(schema.scalar({
+            type = 'integer',
+            box_cfg = 'vinyl_page_cache',
+            default = 0,
+        })),
         page_size = byte_size(schema.scalar({
             type = 'integer',
             box_cfg = 'vinyl_page_size',
@@ -1282,11 +1298,21 @@ return schema.new('instance_config', schema.record({
                 default = 1e18,
             })),
         }),
+        compress_threads = schema.scalar({
+            type = 'integer',
+            box_cfg = 'snap_compress_threads',
+            default = 1,
+        }),
         count = schema.scalar({
             type = 'integer',
             box_cfg = 'checkpoint_count',
             default = 2,
         }),
+        delta_count = schema.scalar({
+            type = 'integer',
+            box_cfg = 'snap_delta_count',
+            default = 0,
+        }),
         snap_io_rate_limit = schema.scalar({
             type = 'number',
             box_cfg = 'snap_io_rate_limit',
@@ -1385,6 +1411,11 @@ return schema.new('instance_config', schema.record({
             box_cfg = 'replication_synchro_timeout',
             default = 5,
         })),
+        synchro_confirm_delay = duration(schema.scalar({
+            type = 'number',
+            box_cfg = 'replication_synchro_confirm_delay',
+            default = 0,
+        })),
         synchro_queue_max_size = byte_size(schema.scalar({
             type = 'integer',
             box_cfg = 'replication_synchro_queue_max_size',
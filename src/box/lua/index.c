@@ -38,6 +38,10 @@
 #include "box/lua/misc.h"
 #include "small/region.h"
 #include "box/arrow_ipc.h"
+#include "box/port.h"
+#include "box/space.h"
+#include "box/space_cache.h"
+#include "box/tuple_arrow.h"
 #include "fiber.h"
 
 /** {{{ box.index Lua library: access to spaces and indexes
@@ -487,6 +491,86 @@ lbox_insert_arrow(lua_State *L)
 	return 0;
 }
 
+/**
+ * Selects tuples like index:select() and returns them as an Arrow IPC
+ * stream with a column per field of the space format.
+ */
+static int
+lbox_select_arrow(lua_State *L)
+{
+	if (lua_gettop(L) != 8 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
+	    !lua_isnumber(L, 3) || !lua_isnumber(L, 4) || !lua_isnumber(L, 5) ||
+	    !lua_isboolean(L, 8)) {
+		return luaL_error(L, "Usage index:select_arrow(iterator, "
+				  "offset, limit, key, after, fetch_pos)");
+	}
+
+	struct region *gc = &fiber()->gc;
+	size_t svp = region_used(gc);
+	int ret_count = 1;
+	struct port port;
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	int iterator = lua_tonumber(L, 3);
+	uint32_t offset = lua_tonumber(L, 4);
+	uint32_t limit = lua_tonumber(L, 5);
+	bool fetch_pos = lua_toboolean(L, 8);
+
+	size_t key_len;
+	const char *key = lbox_encode_tuple_on_gc(L, 6, &key_len);
+	if (key == NULL)
+		goto fail;
+	const char *packed_pos, *packed_pos_end;
+	if (lbox_index_normalize_position(L, 7, space_id, index_id,
+					  &packed_pos, &packed_pos_end) != 0)
+		goto fail;
+	struct space *space = space_cache_find(space_id);
+	if (space == NULL)
+		goto fail;
+	struct tuple_arrow_builder *builder =
+		tuple_arrow_builder_new(space->def->fields,
+					space->def->field_count);
+	if (builder == NULL)
+		goto fail;
+	if (box_select(space_id, index_id, iterator, offset, limit, key,
+		       key + key_len, &packed_pos, &packed_pos_end, fetch_pos,
+		       &port) != 0) {
+		tuple_arrow_builder_delete(builder);
+		goto fail;
+	}
+	struct port_c *port_c = (struct port_c *)&port;
+	for (struct port_c_entry *entry = port_c->first; entry != NULL;
+	     entry = entry->next) {
+		assert(entry->type == PORT_C_ENTRY_TUPLE);
+		if (tuple_arrow_builder_add(builder, entry->tuple) != 0) {
+			tuple_arrow_builder_delete(builder);
+			port_destroy(&port);
+			goto fail;
+		}
+	}
+	port_destroy(&port);
+	struct ArrowArray array;
+	struct ArrowSchema schema;
+	tuple_arrow_builder_finish(builder, &array, &schema);
+	const char *data, *data_end;
+	int rc = arrow_ipc_encode(&array, &schema, gc, &data, &data_end);
+	array.release(&array);
+	schema.release(&schema);
+	if (rc != 0)
+		goto fail;
+	lua_pushlstring(L, data, data_end - data);
+	if (fetch_pos && packed_pos != NULL) {
+		lua_pushlstring(L, packed_pos, packed_pos_end - packed_pos);
+		ret_count++;
+	}
+	region_truncate(gc, svp);
+	return ret_count;
+fail:
+	region_truncate(gc, svp);
+	return luaT_error(L);
+}
+
 void
 box_lua_index_init(struct lua_State *L)
 {
@@ -516,6 +600,7 @@ box_lua_index_init(struct lua_State *L)
 		{"stat", lbox_index_stat},
 		{"compact", lbox_index_compact},
 		{"insert_arrow", lbox_insert_arrow},
+		{"select_arrow", lbox_select_arrow},
 		{NULL, NULL}
 	};
 
@@ -710,6 +710,30 @@ lbox_info_election(struct lua_State *L)
 	return 1;
 }
 
+/**
+ * Push a table with latency percentiles of the synchronous transactions
+ * confirmed by this instance, by stage.
+ */
+static void
+lbox_info_synchro_latency(struct lua_State *L, struct txn_limbo_queue *queue)
+{
+	static const int pcts[] = {50, 75, 90, 95, 99};
+	static const char *pct_strs[] = {"p50", "p75", "p90", "p95", "p99"};
+	lua_createtable(L, 0, txn_limbo_latency_stage_MAX + 1);
+	lua_pushnumber(L, latency_count(
+		&queue->latency[TXN_LIMBO_LATENCY_TOTAL]));
+	lua_setfield(L, -2, "count");
+	for (int i = 0; i < txn_limbo_latency_stage_MAX; i++) {
+		lua_createtable(L, 0, lengthof(pcts));
+		for (size_t j = 0; j < lengthof(pcts); j++) {
+			lua_pushnumber(L, latency_get(&queue->latency[i],
+						      pcts[j]));
+			lua_setfield(L, -2, pct_strs[j]);
+		}
+		lua_setfield(L, -2, txn_limbo_latency_stage_strs[i]);
+	}
+}
+
 static int
 lbox_info_synchro(struct lua_State *L)
 {
@@ -722,7 +746,7 @@ lbox_info_synchro(struct lua_State *L)
 	/* Queue information. */
 	struct txn_limbo *limbo = &txn_limbo;
 	struct txn_limbo_queue *queue = &limbo->queue;
-	lua_createtable(L, 0, 7);
+	lua_createtable(L, 0, 8);
 	lua_pushnumber(L, queue->len);
 	lua_setfield(L, -2, "len");
 	lua_pushnumber(L, queue->size);
@@ -740,6 +764,8 @@ lbox_info_synchro(struct lua_State *L)
 	lua_setfield(L, -2, "age");
 	lua_pushnumber(L, queue->confirm_lag);
 	lua_setfield(L, -2, "confirm_lag");
+	lbox_info_synchro_latency(L, queue);
+	lua_setfield(L, -2, "latency");
 	lua_setfield(L, -2, "queue");
 
 	return 1;
@@ -101,6 +101,7 @@ local default_cfg = {
     slab_alloc_factor   = 1.05,
     app_threads         = 0,
     iproto_threads      = 1,
+    net_box_io_threads  = 0,
     memtx_allocator     = "small",
     work_dir            = nil,
     memtx_dir           = ".",
@@ -109,6 +110,7 @@ local default_cfg = {
     vinyl_dir           = '.',
     vinyl_memory        = 128 * 1024 * 1024,
     vinyl_cache         = 128 * 1024 * 1024,
+    vinyl_page_cache    = 0,
     vinyl_max_tuple_size = 1024 * 1024,
     vinyl_read_threads  = 1,
     vinyl_write_threads = 4,
@@ -163,6 +165,8 @@ local default_cfg = {
     io_collect_interval = nil,
     readahead           = 16320,
     snap_io_rate_limit  = nil, -- no limit
+    snap_compress_threads = 1,
+    snap_delta_count    = 0,
     too_long_threshold  = 0.5,
     wal_mode            = "write",
     wal_max_size        = 256 * 1024 * 1024,
@@ -199,6 +203,7 @@ local default_cfg = {
     replication_sync_timeout = 0,
     replication_synchro_quorum = "N / 2 + 1",
     replication_synchro_timeout = 5,
+    replication_synchro_confirm_delay = 0,
     replication_synchro_queue_max_size = 16 * 1024 * 1024,
     replication_linearizable_quorum = "N - Q + 1",
     replication_connect_timeout = 30,
@@ -217,6 +222,7 @@ local default_cfg = {
     feedback_metrics_collect_interval = ifdef_feedback(60),
     feedback_metrics_limit = ifdef_feedback(1024 * 1024),
     net_msg_max           = 768,
+    iproto_stale_read_max_lag = 0,
     sql_cache_size        = 5 * 1024 * 1024,
     txn_timeout           = 365 * 100 * 86400,
     txn_synchro_timeout   = 5,
@@ -313,6 +319,7 @@ local template_cfg = {
     slab_alloc_factor   = 'number',
     app_threads         = 'number',
     iproto_threads      = 'number',
+    net_box_io_threads  = 'number',
     memtx_allocator     = 'string',
     work_dir            = 'string',
     memtx_dir            = 'string',
@@ -320,6 +327,7 @@ local template_cfg = {
     vinyl_dir           = 'string',
     vinyl_memory        = 'number',
     vinyl_cache               = 'number',
+    vinyl_page_cache          = 'number',
     vinyl_max_tuple_size      = 'number',
     vinyl_read_threads        = 'number',
     vinyl_write_threads       = 'number',
@@ -374,6 +382,8 @@ local template_cfg = {
     io_collect_interval = 'number',
     readahead           = 'number',
     snap_io_rate_limit  = 'number',
+    snap_compress_threads = 'number',
+    snap_delta_count    = 'number',
     too_long_threshold  = 'number',
     wal_mode            = 'string',
     wal_max_size        = 'number',
@@ -411,6 +421,7 @@ local template_cfg = {
     replication_sync_timeout = 'number',
     replication_synchro_quorum = 'string, number',
     replication_synchro_timeout = 'number',
+    replication_synchro_confirm_delay = 'number',
     replication_synchro_queue_max_size = 'number',
     replication_linearizable_quorum = "string, number",
     replication_connect_timeout = 'number',
@@ -429,6 +440,7 @@ local template_cfg = {
     feedback_metrics_collect_interval = ifdef_feedback('number'),
     feedback_metrics_limit = ifdef_feedback('number'),
     net_msg_max           = 'number',
+    iproto_stale_read_max_lag = 'number',
     sql_cache_size        = 'number',
     txn_timeout           = 'number',
     txn_synchro_timeout   = 'number',
@@ -467,6 +479,7 @@ local byte_size_cfg = {
     slab_alloc_granularity = true,
     vinyl_memory = true,
     vinyl_cache = true,
+    vinyl_page_cache = true,
     vinyl_max_tuple_size = true,
     vinyl_range_size = true,
     vinyl_page_size = true,
@@ -504,6 +517,7 @@ local duration_cfg = {
     replication_timeout = true,
     replication_reconnect_timeout = true,
     replication_synchro_timeout = true,
+    replication_synchro_confirm_delay = true,
     replication_connect_timeout = true,
     replication_sync_timeout = true,
     replication_sync_lag = true,
@@ -513,6 +527,7 @@ local duration_cfg = {
     flightrec_metrics_interval = true,
     flightrec_metrics_period = true,
     auth_delay = true,
+    iproto_stale_read_max_lag = true,
 }
 
 local function normalize_byte_size_option(option_name, value)
@@ -623,6 +638,8 @@ local dynamic_cfg = {
     readahead               = private.cfg_set_readahead,
     too_long_threshold      = private.cfg_set_too_long_threshold,
     snap_io_rate_limit      = private.cfg_set_snap_io_rate_limit,
+    snap_compress_threads   = private.cfg_set_snap_compress_threads,
+    snap_delta_count        = private.cfg_set_snap_delta_count,
     read_only               = private.cfg_set_read_only,
     memtx_memory            = private.cfg_set_memtx_memory,
     memtx_use_sort_data     = private.cfg_set_memtx_use_sort_data,
@@ -630,6 +647,7 @@ local dynamic_cfg = {
     vinyl_memory            = private.cfg_set_vinyl_memory,
     vinyl_max_tuple_size    = private.cfg_set_vinyl_max_tuple_size,
     vinyl_cache             = private.cfg_set_vinyl_cache,
+    vinyl_page_cache        = private.cfg_set_vinyl_page_cache,
     vinyl_timeout           = private.cfg_set_vinyl_timeout,
     vinyl_defer_deletes     = nop,
     quiver_memory           = private.cfg_set_quiver_memory,
@@ -666,6 +684,8 @@ local dynamic_cfg = {
     replication_sync_timeout = private.cfg_set_replication_sync_timeout,
     replication_synchro_quorum = private.cfg_set_replication_synchro_quorum,
     replication_synchro_timeout = private.cfg_set_replication_synchro_timeout,
+    replication_synchro_confirm_delay =
+        private.cfg_set_replication_synchro_confirm_delay,
     replication_synchro_queue_max_size =
         private.cfg_set_replication_synchro_queue_max_size,
     replication_linearizable_quorum =
@@ -681,6 +701,7 @@ local dynamic_cfg = {
     replicaset_name         = private.cfg_set_replicaset_name,
     cluster_name            = private.cfg_set_cluster_name,
     net_msg_max             = private.cfg_set_net_msg_max,
+    iproto_stale_read_max_lag = private.cfg_set_iproto_stale_read_max_lag,
     sql_cache_size          = private.cfg_set_sql_cache_size,
     txn_timeout             = private.cfg_set_txn_timeout,
     txn_synchro_timeout     = private.cfg_set_txn_synchro_timeout,
@@ -790,6 +811,7 @@ local dynamic_cfg_order = {
     replication_sync_timeout    = 150,
     replication_synchro_quorum  = 150,
     replication_synchro_timeout = 150,
+    replication_synchro_confirm_delay = 150,
     replication_synchro_queue_max_size = 150,
     replication_connect_timeout = 150,
     replication_connect_quorum  = 150,
@@ -826,9 +848,11 @@ local dynamic_cfg_skip_at_load = {
     memtx_memory            = true,
     memtx_use_sort_data     = true,
     memtx_max_tuple_size    = true,
+    snap_delta_count        = true,
     vinyl_memory            = true,
     vinyl_max_tuple_size    = true,
     vinyl_cache             = true,
+    vinyl_page_cache        = true,
     vinyl_timeout           = true,
     quiver_memory           = ifdef_quiver(true),
     quiver_run_size         = ifdef_quiver(true),
@@ -845,6 +869,7 @@ local dynamic_cfg_skip_at_load = {
     replication_sync_timeout = true,
     replication_synchro_quorum = true,
     replication_synchro_timeout = true,
+    replication_synchro_confirm_delay = true,
     replication_synchro_queue_max_size = true,
     replication_linearizable_quorum = true,
     replication_skip_conflict = true,
@@ -862,6 +887,7 @@ local dynamic_cfg_skip_at_load = {
     replicaset_name         = true,
     cluster_name            = true,
     net_msg_max             = true,
+    iproto_stale_read_max_lag = true,
     readahead               = true,
     auth_type               = true,
     auth_delay              = ifdef_security(true),
@@ -51,6 +51,7 @@
 #include "box/schema_def.h"
 #include "box/mp_box_ctx.h"
 #include "box/mp_tuple.h"
+#include "box/net_box_io.h"
 
 #include "coio.h"
 #include "fiber.h"
@@ -101,6 +102,10 @@ static struct iproto_features NETBOX_IPROTO_FEATURES;
 	_(UPSERT)							\
 	_(SELECT)							\
 	_(SELECT_WITH_POS)						\
+	_(SELECT_MULTI)							\
+	_(CURSOR_OPEN)							\
+	_(CURSOR_FETCH)							\
+	_(CURSOR_CLOSE)							\
 	_(EXECUTE)							\
 	_(PREPARE)							\
 	_(UNPREPARE)							\
@@ -269,6 +274,11 @@ struct netbox_transport {
 	struct iostream_ctx io_ctx;
 	/** Connection I/O stream. */
 	struct iostream io;
+	/**
+	 * Connection served by a net.box I/O thread or NULL if I/O is done
+	 * by the worker fiber. If set, the I/O stream is owned by it.
+	 */
+	struct net_box_io_conn *io_conn;
 	/** Connection send buffer. */
 	struct ibuf send_buf;
 	/** Connection receive buffer. */
@@ -553,6 +563,7 @@ netbox_transport_create(struct netbox_transport *transport)
 	transport->self_ref = LUA_NOREF;
 	iostream_ctx_clear(&transport->io_ctx);
 	iostream_clear(&transport->io);
+	transport->io_conn = NULL;
 	ibuf_create(&transport->send_buf, &cord()->slabc, NETBOX_READAHEAD);
 	ibuf_create(&transport->recv_buf, &cord()->slabc, NETBOX_READAHEAD);
 	transport->last_msg_size = 0;
@@ -574,6 +585,7 @@ netbox_transport_destroy(struct netbox_transport *transport)
 	assert(transport->self_ref == LUA_NOREF);
 	iostream_ctx_destroy(&transport->io_ctx);
 	assert(!iostream_is_initialized(&transport->io));
+	assert(transport->io_conn == NULL);
 	assert(ibuf_used(&transport->send_buf) == 0);
 	assert(ibuf_used(&transport->recv_buf) == 0);
 	fiber_cond_destroy(&transport->on_send_buf_empty);
@@ -990,6 +1002,130 @@ netbox_encode_select(lua_State *L, int idx,
 	return 0;
 }
 
+/* Encode select request with a list of keys. */
+static int
+netbox_encode_select_multi(lua_State *L, int idx,
+			   struct netbox_method_encode_ctx *ctx)
+{
+	/*
+	 * Lua stack at idx: space_id, index_id, iterator, offset, limit,
+	 * keys.
+	 */
+	size_t svp = netbox_begin_encode(ctx->stream, ctx->sync,
+					 IPROTO_SELECT_MULTI, ctx->thread_id,
+					 ctx->stream_id);
+	mpstream_encode_map(ctx->stream, 6);
+	int iterator = lua_tointeger(L, idx + 2);
+	uint32_t offset = lua_tonumber(L, idx + 3);
+	uint32_t limit = lua_tonumber(L, idx + 4);
+
+	netbox_encode_space_id_or_name(L, idx, ctx->stream);
+
+	netbox_encode_index_id_or_name(L, idx + 1, ctx->stream);
+
+	/* encode iterator */
+	mpstream_encode_uint(ctx->stream, IPROTO_ITERATOR);
+	mpstream_encode_uint(ctx->stream, iterator);
+
+	/* encode offset */
+	mpstream_encode_uint(ctx->stream, IPROTO_OFFSET);
+	mpstream_encode_uint(ctx->stream, offset);
+
+	/* encode limit */
+	mpstream_encode_uint(ctx->stream, IPROTO_LIMIT);
+	mpstream_encode_uint(ctx->stream, limit);
+
+	/* encode keys */
+	mpstream_encode_uint(ctx->stream, IPROTO_KEY_LIST);
+	uint32_t key_count = lua_objlen(L, idx + 5);
+	mpstream_encode_array(ctx->stream, key_count);
+	for (uint32_t i = 1; i <= key_count; i++) {
+		lua_rawgeti(L, idx + 5, i);
+		int rc = luamp_convert_key(L, cfg, ctx->stream, lua_gettop(L));
+		lua_pop(L, 1);
+		if (rc != 0)
+			return -1;
+	}
+
+	netbox_end_encode(ctx->stream, svp);
+	return 0;
+}
+
+/* Encode cursor open request. */
+static int
+netbox_encode_cursor_open(lua_State *L, int idx,
+			  struct netbox_method_encode_ctx *ctx)
+{
+	/*
+	 * Lua stack at idx: space_id, index_id, iterator, offset, limit, key.
+	 */
+	size_t svp = netbox_begin_encode(ctx->stream, ctx->sync,
+					 IPROTO_CURSOR_OPEN, ctx->thread_id,
+					 ctx->stream_id);
+	mpstream_encode_map(ctx->stream, 6);
+	int iterator = lua_tointeger(L, idx + 2);
+	uint32_t offset = lua_tonumber(L, idx + 3);
+	uint32_t limit = lua_tonumber(L, idx + 4);
+
+	netbox_encode_space_id_or_name(L, idx, ctx->stream);
+
+	netbox_encode_index_id_or_name(L, idx + 1, ctx->stream);
+
+	/* encode iterator */
+	mpstream_encode_uint(ctx->stream, IPROTO_ITERATOR);
+	mpstream_encode_uint(ctx->stream, iterator);
+
+	/* encode offset */
+	mpstream_encode_uint(ctx->stream, IPROTO_OFFSET);
+	mpstream_encode_uint(ctx->stream, offset);
+
+	/* encode limit */
+	mpstream_encode_uint(ctx->stream, IPROTO_LIMIT);
+	mpstream_encode_uint(ctx->stream, limit);
+
+	/* encode key */
+	mpstream_encode_uint(ctx->stream, IPROTO_KEY);
+	if (luamp_convert_key(L, cfg, ctx->stream, idx + 5) != 0)
+		return -1;
+
+	netbox_end_encode(ctx->stream, svp);
+	return 0;
+}
+
+/* Encode cursor fetch request. */
+static int
+netbox_encode_cursor_fetch(lua_State *L, int idx,
+			   struct netbox_method_encode_ctx *ctx)
+{
+	/* Lua stack at idx: cursor_id, limit. */
+	size_t svp = netbox_begin_encode(ctx->stream, ctx->sync,
+					 IPROTO_CURSOR_FETCH, ctx->thread_id,
+					 ctx->stream_id);
+	mpstream_encode_map(ctx->stream, 2);
+	mpstream_encode_uint(ctx->stream, IPROTO_CURSOR_ID);
+	mpstream_encode_uint(ctx->stream, luaL_checkuint64(L, idx));
+	mpstream_encode_uint(ctx->stream, IPROTO_LIMIT);
+	mpstream_encode_uint(ctx->stream, (uint32_t)lua_tonumber(L, idx + 1));
+	netbox_end_encode(ctx->stream, svp);
+	return 0;
+}
+
+/* Encode cursor close request. */
+static int
+netbox_encode_cursor_close(lua_State *L, int idx,
+			   struct netbox_method_encode_ctx *ctx)
+{
+	/* Lua stack at idx: cursor_id. */
+	size_t svp = netbox_begin_encode(ctx->stream, ctx->sync,
+					 IPROTO_CURSOR_CLOSE, ctx->thread_id,
+					 ctx->stream_id);
+	mpstream_encode_map(ctx->stream, 1);
+	mpstream_encode_uint(ctx->stream, IPROTO_CURSOR_ID);
+	mpstream_encode_uint(ctx->stream, luaL_checkuint64(L, idx));
+	netbox_end_encode(ctx->stream, svp);
+	return 0;
+}
+
 static int
 netbox_encode_insert_or_replace(lua_State *L, int idx, struct mpstream *stream,
 				uint64_t sync, enum iproto_type type,
@@ -1274,6 +1410,52 @@ netbox_transport_communicate(struct netbox_transport *transport, size_t limit)
 	return -1;
 }
 
+/**
+ * Sends and receives data over an iproto connection served by a net.box
+ * I/O thread. Returns 0 and a decoded response header on success.
+ * On error returns -1.
+ */
+static int
+netbox_transport_send_and_recv_io_thread(struct netbox_transport *transport,
+					 struct xrow_header *hdr)
+{
+	struct net_box_io_conn *conn = transport->io_conn;
+	while (true) {
+		/*
+		 * Gracefully shut down the connection if there are no more
+		 * in-progress requests and the server requested us to.
+		 */
+		if (transport->state == NETBOX_GRACEFUL_SHUTDOWN &&
+		    transport->inprogress_request_count == 0) {
+			box_error_raise(ER_NO_CONNECTION, "Peer closed");
+			return -1;
+		}
+		/*
+		 * Sic: on_send_buf_empty is broadcast by the I/O thread
+		 * when the data is actually sent.
+		 */
+		if (ibuf_used(&transport->send_buf) > 0)
+			net_box_io_conn_write(conn, &transport->send_buf);
+		const char *data, *data_end;
+		int rc = net_box_io_conn_read(conn, &data, &data_end);
+		if (rc < 0)
+			return -1;
+		if (rc > 0)
+			return xrow_decode(hdr, &data, data_end,
+					   /*end_is_exact=*/true);
+		net_box_io_conn_wait(conn);
+		ERROR_INJECT_YIELD(ERRINJ_NETBOX_IO_DELAY);
+		ERROR_INJECT(ERRINJ_NETBOX_IO_ERROR, {
+			box_error_raise(ER_NO_CONNECTION, "Error injection");
+			return -1;
+		});
+		if (fiber_is_cancelled()) {
+			diag_set(FiberIsCancelled);
+			return -1;
+		}
+	}
+}
+
 /**
  * Sends and receives data over an iproto connection.
  * Returns 0 and a decoded response header on success.
@@ -1283,6 +1465,8 @@ static int
 netbox_transport_send_and_recv(struct netbox_transport *transport,
 			       struct xrow_header *hdr)
 {
+	if (transport->io_conn != NULL)
+		return netbox_transport_send_and_recv_io_thread(transport, hdr);
 	ibuf_consume(&transport->recv_buf, transport->last_msg_size);
 	while (true) {
 		size_t required;
@@ -1524,6 +1708,10 @@ netbox_encode_method(struct lua_State *L, int idx, enum netbox_method method,
 		[NETBOX_UPSERT]		= netbox_encode_upsert,
 		[NETBOX_SELECT]		= netbox_encode_select,
 		[NETBOX_SELECT_WITH_POS] = netbox_encode_select,
+		[NETBOX_SELECT_MULTI]	= netbox_encode_select_multi,
+		[NETBOX_CURSOR_OPEN]	= netbox_encode_cursor_open,
+		[NETBOX_CURSOR_FETCH]	= netbox_encode_cursor_fetch,
+		[NETBOX_CURSOR_CLOSE]	= netbox_encode_cursor_close,
 		[NETBOX_EXECUTE]	= netbox_encode_execute,
 		[NETBOX_PREPARE]	= netbox_encode_prepare,
 		[NETBOX_UNPREPARE]	= netbox_encode_unprepare,
@@ -1566,6 +1754,8 @@ struct response_body {
 	const char *tuple_formats;
 	/* IPROTO_TUPLE_FORMATS end. */
 	const char *tuple_formats_end;
+	/* IPROTO_CURSOR_ID, 0 if absent. */
+	uint64_t cursor_id;
 };
 
 /*
@@ -1601,6 +1791,10 @@ response_body_decode(struct response_body *response_body, const char **data,
 			response_body->tuple_formats = value;
 			response_body->tuple_formats_end = *data;
 			break;
+		case IPROTO_CURSOR_ID:
+			assert(mp_typeof(*value) == MP_UINT);
+			response_body->cursor_id = mp_decode_uint(&value);
+			break;
 		default:
 			break;
 		}
@@ -1778,6 +1972,68 @@ netbox_decode_select_with_pos(struct lua_State *L, const char **data,
 	}
 }
 
+/**
+ * Decodes Tarantool response body to IPROTO_SELECT_MULTI, which consists of
+ * IPROTO_DATA key holding an array of tuple arrays, and pushes the array of
+ * tuple arrays to Lua stack.
+ */
+static void
+netbox_decode_select_multi(struct lua_State *L, const char **data,
+			   const char *data_end, bool return_raw,
+			   struct tuple_format *format)
+{
+	struct response_body response_body;
+	response_body_decode(&response_body, data, data_end);
+	struct mp_box_ctx ctx;
+	mp_box_ctx_create(&ctx, NULL, response_body.tuple_formats);
+	if (return_raw) {
+		luamp_push_with_ctx(L, response_body.data,
+				    response_body.data_end,
+				    (struct mp_ctx *)&ctx);
+	} else {
+		uint32_t count = mp_decode_array(&response_body.data);
+		lua_createtable(L, count, 0);
+		for (uint32_t i = 0; i < count; i++) {
+			netbox_decode_data(L, &response_body.data, format,
+					   &ctx);
+			lua_rawseti(L, -2, i + 1);
+		}
+	}
+	mp_ctx_destroy((struct mp_ctx *)&ctx);
+}
+
+/**
+ * Decodes Tarantool response body to IPROTO_CURSOR_OPEN or IPROTO_CURSOR_FETCH
+ * consisting of IPROTO_DATA and probably IPROTO_CURSOR_ID keys into array with
+ * array of tuples on the first place and cursor id on the second place, pushes
+ * it to Lua stack. The cursor id is absent if the cursor was closed.
+ */
+static void
+netbox_decode_cursor(struct lua_State *L, const char **data,
+		     const char *data_end, bool return_raw,
+		     struct tuple_format *format)
+{
+	struct response_body response_body;
+	response_body_decode(&response_body, data, data_end);
+	lua_createtable(L, response_body.cursor_id != 0 ? 2 : 1, 0);
+	int table_idx = lua_gettop(L);
+	struct mp_box_ctx ctx;
+	mp_box_ctx_create(&ctx, NULL, response_body.tuple_formats);
+	if (return_raw) {
+		luamp_push_with_ctx(L, response_body.data,
+				    response_body.data_end,
+				    (struct mp_ctx *)&ctx);
+	} else {
+		netbox_decode_data(L, &response_body.data, format, &ctx);
+	}
+	mp_ctx_destroy((struct mp_ctx *)&ctx);
+	lua_rawseti(L, table_idx, 1);
+	if (response_body.cursor_id != 0) {
+		luaL_pushuint64(L, response_body.cursor_id);
+		lua_rawseti(L, table_idx, 2);
+	}
+}
+
 /**
  * Same as netbox_decode_select, but only decodes the first tuple of the array,
  * skipping the rest.
@@ -2070,6 +2326,10 @@ netbox_decode_method(struct lua_State *L, enum netbox_method method,
 		[NETBOX_UPSERT]		= netbox_decode_nil,
 		[NETBOX_SELECT]		= netbox_decode_select,
 		[NETBOX_SELECT_WITH_POS] = netbox_decode_select_with_pos,
+		[NETBOX_SELECT_MULTI]	= netbox_decode_select_multi,
+		[NETBOX_CURSOR_OPEN]	= netbox_decode_cursor,
+		[NETBOX_CURSOR_FETCH]	= netbox_decode_cursor,
+		[NETBOX_CURSOR_CLOSE]	= netbox_decode_nil,
 		[NETBOX_EXECUTE]	= netbox_decode_execute,
 		[NETBOX_PREPARE]	= netbox_decode_prepare,
 		[NETBOX_UNPREPARE]	= netbox_decode_nil,
@@ -3143,11 +3403,26 @@ netbox_worker_f(va_list ap)
 				       transport->opts.reconnect_after : 0;
 	while (!fiber_is_cancelled()) {
 		if (netbox_transport_connect(transport) == 0) {
+			/*
+			 * I/O threads send messages to the main thread.
+			 * Encrypted streams can't be moved between threads.
+			 */
+			if (net_box_io_is_enabled() && cord_is_main() &&
+			    (transport->io.flags & IOSTREAM_IS_ENCRYPTED) == 0) {
+				transport->io_conn = net_box_io_conn_new(
+					&transport->io,
+					&transport->on_send_buf_empty);
+			}
 			int rc = luaT_cpcall(L, netbox_connection_handler_f,
 					     transport);
 			/* The worker loop can only be broken by an error. */
 			assert(rc != 0);
 			(void)rc;
+			if (transport->io_conn != NULL) {
+				net_box_io_conn_delete(transport->io_conn,
+						       &transport->io);
+				transport->io_conn = NULL;
+			}
 			iostream_close(&transport->io);
 		}
 		if (fiber_is_cancelled())
@@ -3234,7 +3509,9 @@ luaT_netbox_transport_stop(struct lua_State *L)
 		 * it is necessary to ensure that all requests are
 		 * sent before the connection is closed.
 		 */
-		while (ibuf_used(&transport->send_buf) > 0)
+		while (ibuf_used(&transport->send_buf) > 0 ||
+		       (transport->io_conn != NULL &&
+			net_box_io_conn_has_output(transport->io_conn)))
 			fiber_cond_wait(&transport->on_send_buf_empty);
 	}
 	/* Cancel the worker fiber. */
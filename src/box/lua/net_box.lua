@@ -290,6 +290,8 @@ local function new_sm(uri_or_fd, opts)
                    state == 'closed' then
                 if was_connected then
                     remote._is_connected = false
+                    -- Cursors are closed by the server with the connection.
+                    table.clear(remote._gc_cursor_ids)
                     local ok, trigger_err = pcall(remote._on_disconnect.run,
                                                   remote._on_disconnect, remote)
                     if not ok then
@@ -431,6 +433,8 @@ local function new_sm(uri_or_fd, opts)
     remote._state_cond = fiber.cond()
     -- Last stream ID used for this connection.
     remote._last_stream_id = 0
+    -- IDs of garbage collected cursors to close on the server.
+    remote._gc_cursor_ids = {}
     local weak_refs = setmetatable({callback = callback}, {__mode = 'v'})
     -- Create a transport, adding auto-stop-on-GC feature.
     -- The tricky part is the callback:
@@ -885,6 +889,23 @@ function remote_methods:wait_connected(timeout)
     return self:wait_state('active', timeout)
 end
 
+--
+-- Closes cursors that were garbage collected without being closed, see
+-- cursor_set_gc_hook(). It can't be done by the finalizer itself because
+-- the garbage collector may run in the middle of encoding another request.
+--
+local function close_gc_cursors(remote)
+    local ids = remote._gc_cursor_ids
+    local method = internal.method.CURSOR_CLOSE
+    for i = #ids, 1, -1 do
+        local id = ids[i]
+        ids[i] = nil
+        remote._transport:perform_async_request(remote, nil, nil, nil,
+                                                table.insert, {}, nil, nil,
+                                                nil, method, id)
+    end
+end
+
 --
 -- Make a request, which throws an exception in case of critical errors
 -- (e.g. wrong API usage) and returns nil,err if there's connection related
@@ -894,6 +915,9 @@ function remote_methods:_request_impl(method, opts, format, stream_id, ...)
     method = internal.method[method]
     assert(method ~= nil)
     local transport = self._transport
+    if self._gc_cursor_ids[1] ~= nil then
+        close_gc_cursors(self)
+    end
     local thread_id
     local on_push, on_push_ctx, buffer, skip_header, return_raw, deadline
     -- Extract options, set defaults, check if the request is
@@ -1192,6 +1216,81 @@ local function nothing_or_data(value)
     end
 end
 
+local function check_cursor_opts(opts, method)
+    if opts and (opts.buffer or opts.is_async) then
+        error(method .. " doesn't support `buffer` and `is_async` arguments")
+    end
+end
+
+--
+-- Server-side cursor returned by index:cursor(). The id is set to nil once
+-- the cursor is closed on the server.
+--
+local cursor_methods = {}
+local cursor_mt = {__index = cursor_methods}
+
+--
+-- Makes the cursor close itself on the server when it's garbage collected.
+-- Since a finalizer can't send requests, the cursor id is queued and the
+-- close request is sent along with the next request of the connection.
+--
+local function cursor_set_gc_hook(cursor)
+    local ids = cursor._remote._gc_cursor_ids
+    local id = cursor.id
+    cursor._gc_hook = ffi.gc(ffi.new('char[1]'), function()
+        table.insert(ids, id)
+    end)
+end
+
+-- Called when the cursor is closed on the server.
+local function cursor_reset_gc_hook(cursor)
+    if cursor._gc_hook ~= nil then
+        ffi.gc(cursor._gc_hook, nil)
+        cursor._gc_hook = nil
+    end
+end
+
+local function check_cursor_arg(cursor, method)
+    if type(cursor) ~= 'table' or getmetatable(cursor) ~= cursor_mt then
+        local fmt = 'Use cursor:%s(...) instead of cursor.%s(...)'
+        box.error(box.error.ILLEGAL_PARAMS, string.format(fmt, method, method))
+    end
+end
+
+function cursor_methods:fetch(count, opts)
+    check_cursor_arg(self, 'fetch')
+    if type(count) ~= 'number' then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "Usage: cursor:fetch(count, opts)")
+    end
+    check_param_table(opts, REQUEST_OPTION_TYPES)
+    check_cursor_opts(opts, 'cursor:fetch()')
+    if self.id == nil then
+        return {}
+    end
+    local res = self._remote:_request('CURSOR_FETCH', opts,
+                                      self._format_cdata, self._stream_id,
+                                      self.id, count)
+    self.id = res[2]
+    if self.id == nil then
+        cursor_reset_gc_hook(self)
+    end
+    return res[1]
+end
+
+function cursor_methods:close(opts)
+    check_cursor_arg(self, 'close')
+    check_param_table(opts, REQUEST_OPTION_TYPES)
+    check_cursor_opts(opts, 'cursor:close()')
+    if self.id == nil then
+        return
+    end
+    local id = self.id
+    self.id = nil
+    cursor_reset_gc_hook(self)
+    self._remote:_request('CURSOR_CLOSE', opts, nil, self._stream_id, id)
+end
+
 space_metatable = function(remote)
     local methods = {}
 
@@ -1233,6 +1332,16 @@ space_metatable = function(remote)
                                                key, oplist))
     end
 
+    function methods:select_multi(keys, opts)
+        check_space_arg(self, 'select_multi')
+        return check_primary_index(self):select_multi(keys, opts)
+    end
+
+    function methods:cursor(key, opts)
+        check_space_arg(self, 'cursor')
+        return check_primary_index(self):cursor(key, opts)
+    end
+
     function methods:get(key, opts)
         check_space_arg(self, 'get')
         return check_primary_index(self):get(key, opts)
@@ -1277,6 +1386,61 @@ index_metatable = function(remote)
         return unpack(res)
     end
 
+    function methods:select_multi(keys, opts)
+        check_index_arg(self, 'select_multi')
+        check_param_table(opts, REQUEST_OPTION_TYPES)
+        if type(keys) ~= 'table' then
+            box.error(box.error.ILLEGAL_PARAMS,
+                      "Usage: index:select_multi(keys, opts)")
+        end
+        local iterator, offset, limit, after, fetch_pos =
+            check_select_opts(opts, false)
+        if after ~= nil or fetch_pos then
+            box.error(box.error.UNSUPPORTED, "select_multi()", "pagination")
+        end
+        if not remote.peer_protocol_features.select_multi then
+            return box.error(box.error.UNSUPPORTED, "Remote server",
+                "select_multi()")
+        end
+        return (remote:_request('SELECT_MULTI', opts,
+                                self.space._format_cdata, self._stream_id,
+                                self.space._id_or_name, self._id_or_name,
+                                iterator, offset, limit, keys))
+    end
+
+    function methods:cursor(key, opts)
+        check_index_arg(self, 'cursor')
+        check_param_table(opts, REQUEST_OPTION_TYPES)
+        check_cursor_opts(opts, 'index:cursor()')
+        local key_is_nil = (key == nil or
+                            (type(key) == 'table' and #key == 0))
+        local iterator, offset, _, after, fetch_pos =
+            check_select_opts(opts, key_is_nil)
+        if after ~= nil or fetch_pos then
+            box.error(box.error.UNSUPPORTED, "cursor()", "pagination")
+        end
+        if not remote.peer_protocol_features.cursors then
+            return box.error(box.error.UNSUPPORTED, "Remote server",
+                "cursor()")
+        end
+        -- Tuples are fetched only on demand, see cursor:fetch().
+        local res = remote:_request('CURSOR_OPEN', opts,
+                                    self.space._format_cdata,
+                                    self._stream_id, self.space._id_or_name,
+                                    self._id_or_name, iterator, offset, 0,
+                                    key)
+        local cursor = setmetatable({
+            id = res[2],
+            _remote = remote,
+            _format_cdata = self.space._format_cdata,
+            _stream_id = self._stream_id,
+        }, cursor_mt)
+        if cursor.id ~= nil then
+            cursor_set_gc_hook(cursor)
+        end
+        return cursor
+    end
+
     function methods:get(key, opts)
         check_index_arg(self, 'get')
         check_param_table(opts, REQUEST_OPTION_TYPES)
@@ -429,6 +429,8 @@ box.schema.space.create = function(name, options)
         temporary = 'boolean',
         is_sync = 'boolean',
         defer_deletes = 'boolean',
+        compression = 'string',
+        stale_read = 'boolean',
         constraint = 'string, table',
         foreign_key = 'table',
     }
@@ -481,6 +483,8 @@ box.schema.space.create = function(name, options)
         type = options.type,
         is_sync = options.is_sync,
         defer_deletes = options.defer_deletes and true or nil,
+        compression = options.compression,
+        stale_read = options.stale_read,
         constraint = constraint,
         foreign_key = foreign_key,
     })
@@ -591,6 +595,8 @@ local alter_space_template = {
     temporary = 'boolean',
     is_sync = 'boolean',
     defer_deletes = 'boolean',
+    compression = 'string',
+    stale_read = 'boolean',
     name = 'string',
     constraint = 'string, table',
     foreign_key = 'table',
@@ -639,6 +645,14 @@ box.schema.space.alter = function(space_id, options)
         flags.defer_deletes = options.defer_deletes
     end
 
+    if options.compression ~= nil then
+        flags.compression = options.compression
+    end
+
+    if options.stale_read ~= nil then
+        flags.stale_read = options.stale_read
+    end
+
     local format
     if options.format ~= nil then
         format = normalize_format(space_id, tuple.name, options.format, 2)
@@ -2245,6 +2259,32 @@ base_index_mt.select_luac = function(index, key, opts)
         offset, limit, key, after, fetch_pos)
 end
 
+base_index_mt.select_arrow = function(index, key, opts)
+    check_index_arg(index, 'select_arrow', 2)
+    local key = keify(key)
+    local key_is_nil = #key == 0
+    local iterator, offset, limit, after, fetch_pos =
+        check_select_opts(opts, key_is_nil, 2)
+    return internal.select_arrow(index.space_id, index.id, iterator,
+        offset, limit, key, after, fetch_pos)
+end
+
+base_index_mt.select_multi = function(index, keys, opts)
+    check_index_arg(index, 'select_multi', 2)
+    if type(keys) ~= 'table' then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "Usage: index:select_multi(keys, opts)", 2)
+    end
+    if opts ~= nil and (opts.after ~= nil or opts.fetch_pos) then
+        box.error(box.error.UNSUPPORTED, "select_multi()", "pagination", 2)
+    end
+    local ret = {}
+    for i, key in ipairs(keys) do
+        ret[i] = index:select(key, opts)
+    end
+    return ret
+end
+
 base_index_mt.update = function(index, key, ops)
     check_index_arg(index, 'update', 2)
     return internal.update(index.space_id, index.id, keify(key), ops);
@@ -2362,6 +2402,14 @@ space_mt.select = function(space, key, opts)
     check_space_arg(space, 'select', 2)
     return check_primary_index(space, 2):select(key, opts)
 end
+space_mt.select_multi = function(space, keys, opts)
+    check_space_arg(space, 'select_multi', 2)
+    return check_primary_index(space, 2):select_multi(keys, opts)
+end
+space_mt.select_arrow = function(space, key, opts)
+    check_space_arg(space, 'select_arrow', 2)
+    return check_primary_index(space, 2):select_arrow(key, opts)
+end
 space_mt.fselect = function(space, key, opts, fselect_opts)
     check_space_arg(space, 'select', 2)
     return check_primary_index(space, 2):fselect(key, opts, fselect_opts)
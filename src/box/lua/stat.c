@@ -80,6 +80,48 @@ inject_iproto_stats(struct lua_State *L, struct iproto_stats *stats)
 			    stats->requests_in_stream_queue);
 }
 
+/**
+ * Add a 'LATENCY' table with iproto request latency statistics to the
+ * table at the top of the Lua stack. Statistics are collected from the
+ * thread with the given id or from all threads if the id is negative.
+ * Request types that have no observations are omitted.
+ */
+static void
+inject_iproto_latency(struct lua_State *L, int thread_id)
+{
+	static const int pcts[] = {50, 75, 90, 95, 99};
+	static const char *pct_strs[] = {"p50", "p75", "p90", "p95", "p99"};
+	struct iproto_latency latency;
+	if (iproto_latency_create(&latency) != 0)
+		luaL_error(L, "failed to allocate latency statistics");
+	if (thread_id < 0)
+		iproto_latency_get(&latency);
+	else
+		iproto_thread_latency_get(&latency, thread_id);
+	lua_newtable(L);
+	for (int i = 0; i < iproto_latency_type_MAX; i++) {
+		struct latency *stage = latency.stage[i];
+		size_t count = latency_count(&stage[IPROTO_LATENCY_TOTAL]);
+		if (count == 0)
+			continue;
+		lua_newtable(L);
+		lua_pushnumber(L, count);
+		lua_setfield(L, -2, "count");
+		for (int j = 0; j < iproto_latency_stage_MAX; j++) {
+			lua_newtable(L);
+			for (size_t k = 0; k < lengthof(pcts); k++) {
+				lua_pushnumber(L, latency_get(&stage[j],
+							      pcts[k]));
+				lua_setfield(L, -2, pct_strs[k]);
+			}
+			lua_setfield(L, -2, iproto_latency_stage_strs[j]);
+		}
+		lua_setfield(L, -2, iproto_latency_type_strs[i]);
+	}
+	lua_setfield(L, -2, "LATENCY");
+	iproto_latency_destroy(&latency);
+}
+
 static void
 fill_stat_item(struct lua_State *L, int rps, int64_t total)
 {
@@ -221,6 +263,12 @@ static int
 lbox_stat_net_index(struct lua_State *L)
 {
 	const char *key = luaL_checkstring(L, -1);
+	if (strcmp(key, "LATENCY") == 0) {
+		lua_newtable(L);
+		inject_iproto_latency(L, -1);
+		lua_getfield(L, -1, "LATENCY");
+		return 1;
+	}
 	if (iproto_rmean_foreach(seek_stat_item, L) == 0)
 		return 0;
 
@@ -261,7 +309,11 @@ lbox_stat_net_index(struct lua_State *L)
  * - STREAMS: total, rps, current;
  * - REQUESTS: total, rps, current;
  * - REQUESTS_IN_PROGRESS: total, rps, current;
- * - REQUESTS_IN_STREAM_QUEUE: total, rps, current.
+ * - REQUESTS_IN_STREAM_QUEUE: total, rps, current;
+ * - CPU_TIME (microseconds of CPU time used by iproto threads): total, rps;
+ * - LATENCY: a table of request latency statistics by request type
+ *   (SELECT, INSERT, CALL, ...) and processing stage (NET_QUEUE,
+ *   TX_QUEUE, EXEC, TOTAL), each stage has p50, p75, p90, p95, p99.
  *
  * These fields have the following meaning:
  *
@@ -278,6 +330,7 @@ lbox_stat_net_call(struct lua_State *L)
 	struct iproto_stats stats;
 	iproto_stats_get(&stats);
 	inject_iproto_stats(L, &stats);
+	inject_iproto_latency(L, -1);
 	return 1;
 }
 
@@ -296,6 +349,7 @@ lbox_stat_net_thread_index(struct lua_State *L)
 	struct iproto_stats stats;
 	iproto_thread_stats_get(&stats, thread_id);
 	inject_iproto_stats(L, &stats);
+	inject_iproto_latency(L, thread_id);
 	return 1;
 }
 
@@ -312,6 +366,7 @@ lbox_stat_net_thread_call(struct lua_State *L)
 		iproto_thread_rmean_foreach(thread_id, set_stat_item, L);
 		iproto_thread_stats_get(&stats, thread_id);
 		inject_iproto_stats(L, &stats);
+		inject_iproto_latency(L, thread_id);
 		lua_rawseti(L, -2, thread_id + 1);
 	}
 	return 1;
@@ -0,0 +1,2990 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memcs_engine.h"
+
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <msgpuck.h>
+#include <small/matras.h>
+#include <small/region.h>
+#include <small/rlist.h>
+
+#include "arrow/abi.h"
+#include "arrow_options.h"
+#include "assoc.h"
+#include "bit/bit.h"
+#include "column_mask.h"
+#include "diag.h"
+#include "engine.h"
+#include "errcode.h"
+#include "error.h"
+#include "fiber.h"
+#include "index.h"
+#include "index_def.h"
+#include "iproto_constants.h"
+#include "key_def.h"
+#include "memtx_engine.h"
+#include "read_view.h"
+#include "space.h"
+#include "space_cache.h"
+#include "trivia/util.h"
+#include "tt_static.h"
+#include "tuple.h"
+#include "tuple_arrow.h"
+#include "txn.h"
+#include "xrow.h"
+#include "xrow_update.h"
+
+/**
+ * The memcs engine stores each field of a space in a separate typed
+ * vector. Rows are numbered; row data is split into blocks of
+ * MEMCS_BLOCK_ROW_COUNT rows, and every block keeps a validity bitmap
+ * and a value vector for each column. String and varbinary values are
+ * dictionary-encoded: the vector stores codes of strings kept in a
+ * per-column dictionary. A string is referenced by the rows storing it
+ * and is removed from the dictionary when the last of them is freed, its
+ * code is then reused. The primary key is a B+*-tree of row numbers.
+ *
+ * Read views share blocks and dictionary chunks with the index: a block
+ * or a chunk referenced by a read view is copied before it's modified.
+ * A string is freed when no chunk references it.
+ */
+
+enum {
+	/** Number of rows in a block. */
+	MEMCS_BLOCK_ROW_COUNT = 1024,
+	/** Number of strings in a dictionary chunk. */
+	MEMCS_DICT_CHUNK_SIZE = 1024,
+	/** Size of a primary key tree extent. */
+	MEMCS_TREE_EXTENT_SIZE = 16 * 1024,
+};
+
+/** Row number used to denote the absence of a row. */
+#define MEMCS_ROW_NONE UINT32_MAX
+
+struct memcs_engine {
+	struct engine base;
+	/** Allocator of primary key tree extents. */
+	struct matras_allocator extent_allocator;
+	/** Memory used by row blocks and dictionaries. */
+	size_t data_size;
+	/** Memory used by primary key trees. */
+	size_t index_size;
+};
+
+/** Storage layout of a space field. */
+struct memcs_column {
+	/** Field type. */
+	enum field_type type;
+	/** Size of a stored value, in bytes. */
+	uint32_t width;
+	/** Offset of the validity bitmap in block data. */
+	uint32_t validity_offset;
+	/** Offset of the value vector in block data. */
+	uint32_t values_offset;
+};
+
+/** A block of MEMCS_BLOCK_ROW_COUNT rows. */
+struct memcs_block {
+	/** Number of owners: the index and read views. */
+	int64_t refs;
+	/** Validity bitmaps and value vectors of the columns. */
+	char data[0];
+};
+
+/** A string or a binary value stored in a dictionary. */
+struct memcs_str {
+	/** Number of index rows storing the value. */
+	uint32_t row_refs;
+	/** Number of dictionary chunks referencing the value. */
+	uint32_t chunk_refs;
+	/** Length of the value. */
+	uint32_t len;
+	/** Value data. */
+	char data[0];
+};
+
+/** A chunk of a dictionary: strings with consecutive codes. */
+struct memcs_dict_chunk {
+	/** Number of owners: the index and read views. */
+	int64_t refs;
+	/** Strings, NULL if a code isn't used. */
+	struct memcs_str *strs[MEMCS_DICT_CHUNK_SIZE];
+};
+
+/** Dictionary of a string or varbinary column. */
+struct memcs_dict {
+	/** Chunk directory. */
+	struct memcs_dict_chunk **chunks;
+	/** Number of allocated codes, including free ones. */
+	uint32_t size;
+	/** Capacity of the chunk directory. */
+	uint32_t chunk_capacity;
+	/** Map of strings to codes, NULL in read views. */
+	struct mh_strnu32_t *hash;
+	/** Stack of free codes, unused in read views. */
+	uint32_t *free_codes;
+	/** Number of free codes. */
+	uint32_t free_code_count;
+	/** Capacity of the free code stack. */
+	uint32_t free_code_capacity;
+};
+
+/** Column data visible to a reader: the index or a read view. */
+struct memcs_data {
+	/** Primary key definition. */
+	struct key_def *key_def;
+	/** Column layouts, one per space field. */
+	struct memcs_column *columns;
+	/** Number of columns. */
+	uint32_t column_count;
+	/** Row blocks. */
+	struct memcs_block **blocks;
+	/** Number of blocks. */
+	uint32_t block_count;
+	/** Dictionaries, one per column, unused by non-string columns. */
+	struct memcs_dict *dicts;
+};
+
+/** Primary key tree search key. */
+struct memcs_tree_key {
+	/** MsgPack key parts without the array header. */
+	const char *key;
+	/** Number of key parts. */
+	uint32_t part_count;
+};
+
+/** Returns the size of a stored value of the given type or 0. */
+static uint32_t
+memcs_type_width(enum field_type type)
+{
+	switch (type) {
+	case FIELD_TYPE_BOOLEAN:
+	case FIELD_TYPE_INT8:
+	case FIELD_TYPE_UINT8:
+		return 1;
+	case FIELD_TYPE_INT16:
+	case FIELD_TYPE_UINT16:
+		return 2;
+	case FIELD_TYPE_INT32:
+	case FIELD_TYPE_UINT32:
+	case FIELD_TYPE_FLOAT32:
+	case FIELD_TYPE_STRING:
+	case FIELD_TYPE_VARBINARY:
+		return 4;
+	case FIELD_TYPE_INTEGER:
+	case FIELD_TYPE_INT64:
+	case FIELD_TYPE_UNSIGNED:
+	case FIELD_TYPE_UINT64:
+	case FIELD_TYPE_DOUBLE:
+	case FIELD_TYPE_FLOAT64:
+		return 8;
+	default:
+		return 0;
+	}
+}
+
+/** Returns true if values of the type are dictionary-encoded. */
+static inline bool
+memcs_type_is_dict(enum field_type type)
+{
+	return type == FIELD_TYPE_STRING || type == FIELD_TYPE_VARBINARY;
+}
+
+/** Returns the string with the given code. */
+static inline const struct memcs_str *
+memcs_dict_get(const struct memcs_dict *dict, uint32_t code)
+{
+	assert(code < dict->size);
+	return dict->chunks[code / MEMCS_DICT_CHUNK_SIZE]->
+		strs[code % MEMCS_DICT_CHUNK_SIZE];
+}
+
+/** Returns true if a field of a row is null. */
+static inline bool
+memcs_data_is_null(const struct memcs_data *data, uint32_t fieldno,
+		   uint32_t row)
+{
+	assert(row / MEMCS_BLOCK_ROW_COUNT < data->block_count);
+	const struct memcs_block *block =
+		data->blocks[row / MEMCS_BLOCK_ROW_COUNT];
+	return !bit_test(block->data + data->columns[fieldno].validity_offset,
+			 row % MEMCS_BLOCK_ROW_COUNT);
+}
+
+/** Returns a pointer to the stored value of a field of a row. */
+static inline const char *
+memcs_data_value(const struct memcs_data *data, uint32_t fieldno,
+		 uint32_t row)
+{
+	assert(row / MEMCS_BLOCK_ROW_COUNT < data->block_count);
+	const struct memcs_column *column = &data->columns[fieldno];
+	const struct memcs_block *block =
+		data->blocks[row / MEMCS_BLOCK_ROW_COUNT];
+	return block->data + column->values_offset +
+	       (row % MEMCS_BLOCK_ROW_COUNT) * column->width;
+}
+
+/** Returns the string stored in a field of a row. */
+static inline const struct memcs_str *
+memcs_data_str(const struct memcs_data *data, uint32_t fieldno, uint32_t row)
+{
+	uint32_t code = load_u32(memcs_data_value(data, fieldno, row));
+	return memcs_dict_get(&data->dicts[fieldno], code);
+}
+
+/** {{{ Comparators */
+
+/** A number loaded from a column or decoded from MsgPack. */
+struct memcs_number {
+	enum {
+		MEMCS_NUMBER_UINT,
+		MEMCS_NUMBER_INT,
+		MEMCS_NUMBER_DOUBLE,
+	} kind;
+	union {
+		/** MEMCS_NUMBER_UINT value. */
+		uint64_t u;
+		/** MEMCS_NUMBER_INT value, always negative. */
+		int64_t i;
+		/** MEMCS_NUMBER_DOUBLE value. */
+		double d;
+	};
+};
+
+static inline struct memcs_number
+memcs_number_uint(uint64_t value)
+{
+	struct memcs_number n;
+	n.kind = MEMCS_NUMBER_UINT;
+	n.u = value;
+	return n;
+}
+
+static inline struct memcs_number
+memcs_number_int(int64_t value)
+{
+	if (value >= 0)
+		return memcs_number_uint(value);
+	struct memcs_number n;
+	n.kind = MEMCS_NUMBER_INT;
+	n.i = value;
+	return n;
+}
+
+static inline struct memcs_number
+memcs_number_double(double value)
+{
+	struct memcs_number n;
+	n.kind = MEMCS_NUMBER_DOUBLE;
+	n.d = value;
+	return n;
+}
+
+/** Loads a number stored in a column of the given type. */
+static inline struct memcs_number
+memcs_number_load(enum field_type type, const char *value)
+{
+	switch (type) {
+	case FIELD_TYPE_INT8:
+		return memcs_number_int(*(const int8_t *)value);
+	case FIELD_TYPE_UINT8:
+		return memcs_number_uint(*(const uint8_t *)value);
+	case FIELD_TYPE_INT16:
+		return memcs_number_int(*(const int16_t *)value);
+	case FIELD_TYPE_UINT16:
+		return memcs_number_uint(*(const uint16_t *)value);
+	case FIELD_TYPE_INT32:
+		return memcs_number_int(*(const int32_t *)value);
+	case FIELD_TYPE_UINT32:
+		return memcs_number_uint(*(const uint32_t *)value);
+	case FIELD_TYPE_INTEGER:
+	case FIELD_TYPE_INT64:
+		return memcs_number_int(*(const int64_t *)value);
+	case FIELD_TYPE_UNSIGNED:
+	case FIELD_TYPE_UINT64:
+		return memcs_number_uint(*(const uint64_t *)value);
+	case FIELD_TYPE_FLOAT32:
+		return memcs_number_double(*(const float *)value);
+	case FIELD_TYPE_DOUBLE:
+	case FIELD_TYPE_FLOAT64:
+		return memcs_number_double(*(const double *)value);
+	default:
+		unreachable();
+		return memcs_number_uint(0);
+	}
+}
+
+/** Decodes a MsgPack number. */
+static inline struct memcs_number
+memcs_number_decode(const char **data)
+{
+	switch (mp_typeof(**data)) {
+	case MP_UINT:
+		return memcs_number_uint(mp_decode_uint(data));
+	case MP_INT:
+		return memcs_number_int(mp_decode_int(data));
+	case MP_FLOAT:
+		return memcs_number_double(mp_decode_float(data));
+	case MP_DOUBLE:
+		return memcs_number_double(mp_decode_double(data));
+	default:
+		unreachable();
+		return memcs_number_uint(0);
+	}
+}
+
+static inline double
+memcs_number_to_double(struct memcs_number n)
+{
+	switch (n.kind) {
+	case MEMCS_NUMBER_UINT:
+		return n.u;
+	case MEMCS_NUMBER_INT:
+		return n.i;
+	default:
+		return n.d;
+	}
+}
+
+/** Compares two numbers. NaN is less than any other number. */
+static int
+memcs_number_compare(struct memcs_number a, struct memcs_number b)
+{
+	if (a.kind == MEMCS_NUMBER_DOUBLE || b.kind == MEMCS_NUMBER_DOUBLE) {
+		double x = memcs_number_to_double(a);
+		double y = memcs_number_to_double(b);
+		if (isnan(x) || isnan(y))
+			return isnan(y) - isnan(x);
+		return x < y ? -1 : x > y;
+	}
+	if (a.kind != b.kind)
+		return a.kind == MEMCS_NUMBER_INT ? -1 : 1;
+	if (a.kind == MEMCS_NUMBER_INT)
+		return a.i < b.i ? -1 : a.i > b.i;
+	return a.u < b.u ? -1 : a.u > b.u;
+}
+
+/** Compares two strings as MsgPack strings without collation. */
+static inline int
+memcs_str_compare(const char *a, uint32_t a_len, const char *b,
+		  uint32_t b_len)
+{
+	int rc = memcmp(a, b, MIN(a_len, b_len));
+	if (rc != 0)
+		return rc;
+	return a_len < b_len ? -1 : a_len > b_len;
+}
+
+/** Compares a field of two rows. */
+static int
+memcs_data_compare_fields(const struct memcs_data *data, uint32_t fieldno,
+			  uint32_t a, uint32_t b)
+{
+	enum field_type type = data->columns[fieldno].type;
+	const char *x = memcs_data_value(data, fieldno, a);
+	const char *y = memcs_data_value(data, fieldno, b);
+	switch (type) {
+	case FIELD_TYPE_BOOLEAN:
+		return (int)*(const uint8_t *)x - (int)*(const uint8_t *)y;
+	case FIELD_TYPE_STRING:
+	case FIELD_TYPE_VARBINARY: {
+		if (load_u32(x) == load_u32(y))
+			return 0;
+		const struct memcs_str *s1 = memcs_data_str(data, fieldno, a);
+		const struct memcs_str *s2 = memcs_data_str(data, fieldno, b);
+		return memcs_str_compare(s1->data, s1->len,
+					 s2->data, s2->len);
+	}
+	default:
+		return memcs_number_compare(memcs_number_load(type, x),
+					    memcs_number_load(type, y));
+	}
+}
+
+/** Compares two rows by the primary key. */
+static int
+memcs_data_compare(const struct memcs_data *data, uint32_t a, uint32_t b)
+{
+	const struct key_def *key_def = data->key_def;
+	for (uint32_t i = 0; i < key_def->part_count; i++) {
+		const struct key_part *part = &key_def->parts[i];
+		int rc = memcs_data_compare_fields(data, part->fieldno, a, b);
+		if (rc != 0)
+			return part->sort_order == SORT_ORDER_DESC ? -rc : rc;
+	}
+	return 0;
+}
+
+/**
+ * Compares a row with a primary key prefix of @a part_count parts
+ * without the array header.
+ */
+static int
+memcs_data_compare_with_key(const struct memcs_data *data, uint32_t row,
+			    const char *key, uint32_t part_count)
+{
+	const struct key_def *key_def = data->key_def;
+	assert(part_count <= key_def->part_count);
+	for (uint32_t i = 0; i < part_count; i++) {
+		const struct key_part *part = &key_def->parts[i];
+		enum field_type type = data->columns[part->fieldno].type;
+		const char *value = memcs_data_value(data, part->fieldno, row);
+		int rc;
+		switch (type) {
+		case FIELD_TYPE_BOOLEAN:
+			rc = (int)*(const uint8_t *)value -
+			     (int)mp_decode_bool(&key);
+			break;
+		case FIELD_TYPE_STRING:
+		case FIELD_TYPE_VARBINARY: {
+			uint32_t len;
+			const char *str = type == FIELD_TYPE_STRING ?
+					  mp_decode_str(&key, &len) :
+					  mp_decode_bin(&key, &len);
+			const struct memcs_str *s =
+				memcs_data_str(data, part->fieldno, row);
+			rc = memcs_str_compare(s->data, s->len, str, len);
+			break;
+		}
+		default:
+			rc = memcs_number_compare(
+				memcs_number_load(type, value),
+				memcs_number_decode(&key));
+			break;
+		}
+		if (rc != 0)
+			return part->sort_order == SORT_ORDER_DESC ? -rc : rc;
+	}
+	return 0;
+}
+
+static inline int
+memcs_tree_compare(uint32_t a, uint32_t b, struct memcs_data *data)
+{
+	return memcs_data_compare(data, a, b);
+}
+
+static inline int
+memcs_tree_compare_key(uint32_t row, struct memcs_tree_key *key,
+		       struct memcs_data *data)
+{
+	return memcs_data_compare_with_key(data, row, key->key,
+					   key->part_count);
+}
+
+/** }}} Comparators */
+
+#define BPS_TREE_NAME memcs_tree
+#define BPS_TREE_BLOCK_SIZE 512
+#define BPS_TREE_EXTENT_SIZE MEMCS_TREE_EXTENT_SIZE
+#define BPS_TREE_COMPARE(a, b, arg) memcs_tree_compare(a, b, arg)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) memcs_tree_compare_key(a, b, arg)
+#define BPS_TREE_IS_IDENTICAL(a, b) ((a) == (b))
+#define bps_tree_elem_t uint32_t
+#define bps_tree_key_t struct memcs_tree_key *
+#define bps_tree_arg_t struct memcs_data *
+
+#include "salad/bps_tree.h"
+
+#undef BPS_TREE_NAME
+#undef BPS_TREE_BLOCK_SIZE
+#undef BPS_TREE_EXTENT_SIZE
+#undef BPS_TREE_COMPARE
+#undef BPS_TREE_COMPARE_KEY
+#undef BPS_TREE_IS_IDENTICAL
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+#undef bps_tree_arg_t
+
+struct memcs_index {
+	struct index base;
+	/** Column data, the primary key tree comparator argument. */
+	struct memcs_data data;
+	/** Size of a row block, in bytes. */
+	size_t block_size;
+	/** Capacity of the block array. */
+	uint32_t block_capacity;
+	/** Number of allocated row numbers, including free ones. */
+	uint32_t row_count;
+	/** Stack of free row numbers. */
+	uint32_t *free_rows;
+	/** Number of free row numbers. */
+	uint32_t free_row_count;
+	/** Capacity of the free row number stack. */
+	uint32_t free_row_capacity;
+	/** Memory used by dictionaries. */
+	size_t dict_size;
+	/** Primary key tree of row numbers. */
+	struct memcs_tree tree;
+	/** Incremented on each tree change to reposition iterators. */
+	uint32_t version;
+};
+
+/** Returns the format of tuples returned by an index. */
+static struct tuple_format *
+memcs_index_format(struct memcs_index *index)
+{
+	struct space *space = space_by_id(index->base.def->space_id);
+	assert(space != NULL);
+	return space->format;
+}
+
+/** {{{ Row encoding */
+
+/** Returns the size of a non-null field of a row encoded in MsgPack. */
+static uint32_t
+memcs_data_sizeof_value(const struct memcs_data *data, uint32_t fieldno,
+			uint32_t row)
+{
+	enum field_type type = data->columns[fieldno].type;
+	switch (type) {
+	case FIELD_TYPE_BOOLEAN:
+		return mp_sizeof_bool(true);
+	case FIELD_TYPE_STRING:
+		return mp_sizeof_str(memcs_data_str(data, fieldno, row)->len);
+	case FIELD_TYPE_VARBINARY:
+		return mp_sizeof_bin(memcs_data_str(data, fieldno, row)->len);
+	case FIELD_TYPE_FLOAT32:
+		return mp_sizeof_float(0);
+	case FIELD_TYPE_DOUBLE:
+	case FIELD_TYPE_FLOAT64:
+		return mp_sizeof_double(0);
+	default: {
+		struct memcs_number n = memcs_number_load(
+			type, memcs_data_value(data, fieldno, row));
+		return n.kind == MEMCS_NUMBER_INT ? mp_sizeof_int(n.i) :
+						    mp_sizeof_uint(n.u);
+	}
+	}
+}
+
+/** Encodes a non-null field of a row in MsgPack. */
+static char *
+memcs_data_encode_value(const struct memcs_data *data, uint32_t fieldno,
+			uint32_t row, char *pos)
+{
+	enum field_type type = data->columns[fieldno].type;
+	const char *value = memcs_data_value(data, fieldno, row);
+	switch (type) {
+	case FIELD_TYPE_BOOLEAN:
+		return mp_encode_bool(pos, *(const uint8_t *)value != 0);
+	case FIELD_TYPE_STRING: {
+		const struct memcs_str *s = memcs_data_str(data, fieldno, row);
+		return mp_encode_str(pos, s->data, s->len);
+	}
+	case FIELD_TYPE_VARBINARY: {
+		const struct memcs_str *s = memcs_data_str(data, fieldno, row);
+		return mp_encode_bin(pos, s->data, s->len);
+	}
+	case FIELD_TYPE_FLOAT32:
+		return mp_encode_float(pos, *(const float *)value);
+	case FIELD_TYPE_DOUBLE:
+	case FIELD_TYPE_FLOAT64:
+		return mp_encode_double(pos, *(const double *)value);
+	default: {
+		struct memcs_number n = memcs_number_load(type, value);
+		return n.kind == MEMCS_NUMBER_INT ? mp_encode_int(pos, n.i) :
+						    mp_encode_uint(pos, n.u);
+	}
+	}
+}
+
+/**
+ * Encodes a row as a MsgPack array on the fiber region. Trailing nulls
+ * are omitted.
+ */
+static const char *
+memcs_data_encode_row(const struct memcs_data *data, uint32_t row,
+		      uint32_t *size)
+{
+	uint32_t field_count = 0;
+	uint32_t fields_size = 0;
+	uint32_t bsize = 0;
+	for (uint32_t i = 0; i < data->column_count; i++) {
+		if (memcs_data_is_null(data, i, row)) {
+			bsize += mp_sizeof_nil();
+			continue;
+		}
+		bsize += memcs_data_sizeof_value(data, i, row);
+		field_count = i + 1;
+		fields_size = bsize;
+	}
+	*size = mp_sizeof_array(field_count) + fields_size;
+	char *buf = xregion_alloc(&fiber()->gc, *size);
+	char *pos = mp_encode_array(buf, field_count);
+	for (uint32_t i = 0; i < field_count; i++) {
+		if (memcs_data_is_null(data, i, row))
+			pos = mp_encode_nil(pos);
+		else
+			pos = memcs_data_encode_value(data, i, row, pos);
+	}
+	assert(pos == buf + *size);
+	return buf;
+}
+
+/** Returns the size of the primary key of a row without the array header. */
+static uint32_t
+memcs_data_key_bsize(const struct memcs_data *data, uint32_t row)
+{
+	uint32_t size = 0;
+	for (uint32_t i = 0; i < data->key_def->part_count; i++) {
+		size += memcs_data_sizeof_value(
+			data, data->key_def->parts[i].fieldno, row);
+	}
+	return size;
+}
+
+/** Encodes the primary key of a row without the array header. */
+static char *
+memcs_data_encode_key(const struct memcs_data *data, uint32_t row, char *pos)
+{
+	for (uint32_t i = 0; i < data->key_def->part_count; i++) {
+		pos = memcs_data_encode_value(
+			data, data->key_def->parts[i].fieldno, row, pos);
+	}
+	return pos;
+}
+
+/** Returns the size of @a part_count MsgPack values. */
+static uint32_t
+memcs_key_bsize(const char *key, uint32_t part_count)
+{
+	const char *end = key;
+	for (uint32_t i = 0; i < part_count; i++)
+		mp_next(&end);
+	return end - key;
+}
+
+/** Returns a copy of a key allocated with malloc or NULL if it's empty. */
+static char *
+memcs_key_dup(const char *key, uint32_t part_count, uint32_t *size)
+{
+	*size = 0;
+	if (key == NULL || part_count == 0)
+		return NULL;
+	*size = memcs_key_bsize(key, part_count);
+	char *copy = xmalloc(*size);
+	memcpy(copy, key, *size);
+	return copy;
+}
+
+/**
+ * Creates a tuple from a row. The tuple isn't referenced.
+ * Returns NULL on error (diag is set).
+ */
+static struct tuple *
+memcs_index_tuple_new(struct memcs_index *index, uint32_t row)
+{
+	struct region *gc = &fiber()->gc;
+	size_t gc_svp = region_used(gc);
+	uint32_t size;
+	const char *data = memcs_data_encode_row(&index->data, row, &size);
+	struct tuple *tuple = tuple_new(memcs_index_format(index),
+					data, data + size);
+	region_truncate(gc, gc_svp);
+	return tuple;
+}
+
+/** }}} Row encoding */
+
+/** {{{ Row storage */
+
+/** Allocates a new row number. Returns -1 on error (diag is set). */
+static int
+memcs_index_alloc_row(struct memcs_index *index, uint32_t *row)
+{
+	if (index->free_row_count > 0) {
+		*row = index->free_rows[--index->free_row_count];
+		return 0;
+	}
+	if (index->row_count == MEMCS_ROW_NONE) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+			 "more than 4294967294 rows in a space");
+		return -1;
+	}
+	struct memcs_data *data = &index->data;
+	*row = index->row_count++;
+	if (*row % MEMCS_BLOCK_ROW_COUNT == 0) {
+		if (data->block_count == index->block_capacity) {
+			index->block_capacity =
+				MAX(index->block_capacity * 2, 16);
+			data->blocks = xrealloc(data->blocks,
+						index->block_capacity *
+						sizeof(data->blocks[0]));
+		}
+		struct memcs_block *block = xmalloc(index->block_size);
+		block->refs = 1;
+		data->blocks[data->block_count++] = block;
+		struct memcs_engine *engine =
+			(struct memcs_engine *)index->base.engine;
+		engine->data_size += index->block_size;
+	}
+	return 0;
+}
+
+static void
+memcs_index_dict_unref(struct memcs_index *index, uint32_t fieldno,
+		       uint32_t code);
+
+/**
+ * Returns a row number that isn't used anymore for reuse. Strings stored
+ * in the row are unreferenced.
+ */
+static void
+memcs_index_free_row(struct memcs_index *index, uint32_t row)
+{
+	assert(row < index->row_count);
+	struct memcs_data *data = &index->data;
+	for (uint32_t i = 0; i < data->column_count; i++) {
+		if (!memcs_type_is_dict(data->columns[i].type) ||
+		    memcs_data_is_null(data, i, row))
+			continue;
+		memcs_index_dict_unref(index, i,
+				       load_u32(memcs_data_value(data, i,
+								 row)));
+	}
+	if (index->free_row_count == index->free_row_capacity) {
+		index->free_row_capacity =
+			MAX(index->free_row_capacity * 2, 64);
+		index->free_rows = xrealloc(index->free_rows,
+					    index->free_row_capacity *
+					    sizeof(index->free_rows[0]));
+	}
+	index->free_rows[index->free_row_count++] = row;
+}
+
+/**
+ * Returns the block storing a row for writing. A block shared with
+ * a read view is copied.
+ */
+static struct memcs_block *
+memcs_index_writable_block(struct memcs_index *index, uint32_t row)
+{
+	struct memcs_block **blocks = index->data.blocks;
+	uint32_t i = row / MEMCS_BLOCK_ROW_COUNT;
+	assert(i < index->data.block_count);
+	struct memcs_block *block = blocks[i];
+	if (block->refs > 1) {
+		struct memcs_block *copy = xmalloc(index->block_size);
+		memcpy(copy, block, index->block_size);
+		copy->refs = 1;
+		block->refs--;
+		blocks[i] = copy;
+		block = copy;
+		struct memcs_engine *engine =
+			(struct memcs_engine *)index->base.engine;
+		engine->data_size += index->block_size;
+	}
+	return block;
+}
+
+/** Accounts memory allocated (@a size > 0) or freed for a dictionary. */
+static void
+memcs_index_account_dict(struct memcs_index *index, ssize_t size)
+{
+	struct memcs_engine *engine = (struct memcs_engine *)index->base.engine;
+	index->dict_size += size;
+	engine->data_size += size;
+}
+
+/** Drops a chunk reference to a string, freeing it if it was the last. */
+static void
+memcs_index_str_unref(struct memcs_index *index, struct memcs_str *s)
+{
+	assert(s->chunk_refs > 0);
+	if (--s->chunk_refs > 0)
+		return;
+	assert(s->row_refs == 0);
+	memcs_index_account_dict(index, -(ssize_t)(sizeof(*s) + s->len));
+	free(s);
+}
+
+/**
+ * Drops a reference to a dictionary chunk of an index. The last reference
+ * frees the chunk and drops its references to strings.
+ */
+static void
+memcs_index_dict_chunk_unref(struct memcs_index *index,
+			     struct memcs_dict_chunk *chunk)
+{
+	assert(chunk->refs > 0);
+	if (--chunk->refs > 0)
+		return;
+	for (uint32_t i = 0; i < MEMCS_DICT_CHUNK_SIZE; i++) {
+		if (chunk->strs[i] != NULL)
+			memcs_index_str_unref(index, chunk->strs[i]);
+	}
+	memcs_index_account_dict(index, -(ssize_t)sizeof(*chunk));
+	free(chunk);
+}
+
+/**
+ * Returns the dictionary chunk storing a code for writing. A chunk shared
+ * with a read view is copied.
+ */
+static struct memcs_dict_chunk *
+memcs_index_writable_dict_chunk(struct memcs_index *index,
+				struct memcs_dict *dict, uint32_t code)
+{
+	uint32_t chunk_no = code / MEMCS_DICT_CHUNK_SIZE;
+	struct memcs_dict_chunk *chunk = dict->chunks[chunk_no];
+	if (chunk->refs > 1) {
+		struct memcs_dict_chunk *copy = xmalloc(sizeof(*copy));
+		memcpy(copy, chunk, sizeof(*copy));
+		copy->refs = 1;
+		for (uint32_t i = 0; i < MEMCS_DICT_CHUNK_SIZE; i++) {
+			if (copy->strs[i] != NULL)
+				copy->strs[i]->chunk_refs++;
+		}
+		chunk->refs--;
+		dict->chunks[chunk_no] = copy;
+		chunk = copy;
+		memcs_index_account_dict(index, sizeof(*copy));
+	}
+	return chunk;
+}
+
+/** Allocates a code in a dictionary, reusing a free one if possible. */
+static uint32_t
+memcs_index_dict_alloc_code(struct memcs_index *index, struct memcs_dict *dict)
+{
+	if (dict->free_code_count > 0)
+		return dict->free_codes[--dict->free_code_count];
+	uint32_t code = dict->size++;
+	uint32_t chunk_no = code / MEMCS_DICT_CHUNK_SIZE;
+	if (code % MEMCS_DICT_CHUNK_SIZE == 0) {
+		if (chunk_no == dict->chunk_capacity) {
+			dict->chunk_capacity = MAX(dict->chunk_capacity * 2, 8);
+			dict->chunks = xrealloc(dict->chunks,
+						dict->chunk_capacity *
+						sizeof(dict->chunks[0]));
+		}
+		struct memcs_dict_chunk *chunk = xcalloc(1, sizeof(*chunk));
+		chunk->refs = 1;
+		dict->chunks[chunk_no] = chunk;
+		memcs_index_account_dict(index, sizeof(*chunk));
+	}
+	return code;
+}
+
+/**
+ * Returns the code of a string in a dictionary, adding it if needed.
+ * The string is referenced by the row the code is stored in.
+ */
+static uint32_t
+memcs_index_dict_put(struct memcs_index *index, uint32_t fieldno,
+		     const char *str, uint32_t len)
+{
+	struct memcs_dict *dict = &index->data.dicts[fieldno];
+	struct mh_strnu32_key_t key = {str, len, mh_strn_hash(str, len)};
+	mh_int_t k = mh_strnu32_find(dict->hash, &key, NULL);
+	if (k != mh_end(dict->hash)) {
+		uint32_t code = mh_strnu32_node(dict->hash, k)->val;
+		struct memcs_str *s = dict->chunks[code / MEMCS_DICT_CHUNK_SIZE]->
+			strs[code % MEMCS_DICT_CHUNK_SIZE];
+		s->row_refs++;
+		return code;
+	}
+	uint32_t code = memcs_index_dict_alloc_code(index, dict);
+	struct memcs_dict_chunk *chunk =
+		memcs_index_writable_dict_chunk(index, dict, code);
+	struct memcs_str *s = xmalloc(sizeof(*s) + len);
+	s->row_refs = 1;
+	s->chunk_refs = 1;
+	s->len = len;
+	memcpy(s->data, str, len);
+	assert(chunk->strs[code % MEMCS_DICT_CHUNK_SIZE] == NULL);
+	chunk->strs[code % MEMCS_DICT_CHUNK_SIZE] = s;
+	memcs_index_account_dict(index, sizeof(*s) + len);
+	struct mh_strnu32_node_t node = {s->data, len, key.hash, code};
+	mh_strnu32_put(dict->hash, &node, NULL, NULL);
+	return code;
+}
+
+/**
+ * Drops a row reference to a string with the given code. If it was the
+ * last one, removes the string from the dictionary and frees the code.
+ */
+static void
+memcs_index_dict_unref(struct memcs_index *index, uint32_t fieldno,
+		       uint32_t code)
+{
+	struct memcs_dict *dict = &index->data.dicts[fieldno];
+	assert(code < dict->size);
+	struct memcs_str *s = dict->chunks[code / MEMCS_DICT_CHUNK_SIZE]->
+		strs[code % MEMCS_DICT_CHUNK_SIZE];
+	assert(s != NULL && s->row_refs > 0);
+	if (--s->row_refs > 0)
+		return;
+	struct mh_strnu32_key_t key = {s->data, s->len,
+				       mh_strn_hash(s->data, s->len)};
+	mh_int_t k = mh_strnu32_find(dict->hash, &key, NULL);
+	assert(k != mh_end(dict->hash));
+	mh_strnu32_del(dict->hash, k, NULL);
+	struct memcs_dict_chunk *chunk =
+		memcs_index_writable_dict_chunk(index, dict, code);
+	chunk->strs[code % MEMCS_DICT_CHUNK_SIZE] = NULL;
+	memcs_index_str_unref(index, s);
+	if (dict->free_code_count == dict->free_code_capacity) {
+		dict->free_code_capacity =
+			MAX(dict->free_code_capacity * 2, 64);
+		dict->free_codes = xrealloc(dict->free_codes,
+					    dict->free_code_capacity *
+					    sizeof(dict->free_codes[0]));
+	}
+	dict->free_codes[dict->free_code_count++] = code;
+}
+
+/**
+ * Stores a value decoded from MsgPack in the @a pos-th element of
+ * a value vector. Returns -1 on error (diag is set).
+ */
+static int
+memcs_index_store_value(struct memcs_index *index, uint32_t fieldno,
+			const char **data, char *values, uint32_t pos)
+{
+	const struct memcs_column *column = &index->data.columns[fieldno];
+	switch (column->type) {
+	case FIELD_TYPE_BOOLEAN:
+		((uint8_t *)values)[pos] = mp_decode_bool(data);
+		break;
+	case FIELD_TYPE_INT8:
+	case FIELD_TYPE_INT16:
+	case FIELD_TYPE_INT32:
+	case FIELD_TYPE_INTEGER:
+	case FIELD_TYPE_INT64: {
+		int64_t value;
+		if (mp_read_int64(data, &value) != 0) {
+			diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+				 "integers out of the int64 range");
+			return -1;
+		}
+		if (column->width == 1)
+			((int8_t *)values)[pos] = value;
+		else if (column->width == 2)
+			((int16_t *)values)[pos] = value;
+		else if (column->width == 4)
+			((int32_t *)values)[pos] = value;
+		else
+			((int64_t *)values)[pos] = value;
+		break;
+	}
+	case FIELD_TYPE_UINT8:
+	case FIELD_TYPE_UINT16:
+	case FIELD_TYPE_UINT32:
+	case FIELD_TYPE_UNSIGNED:
+	case FIELD_TYPE_UINT64: {
+		uint64_t value = mp_decode_uint(data);
+		if (column->width == 1)
+			((uint8_t *)values)[pos] = value;
+		else if (column->width == 2)
+			((uint16_t *)values)[pos] = value;
+		else if (column->width == 4)
+			((uint32_t *)values)[pos] = value;
+		else
+			((uint64_t *)values)[pos] = value;
+		break;
+	}
+	case FIELD_TYPE_FLOAT32:
+		((float *)values)[pos] = mp_decode_float(data);
+		break;
+	case FIELD_TYPE_DOUBLE: {
+		double value;
+		VERIFY(mp_read_double_lossy(data, &value) == 0);
+		((double *)values)[pos] = value;
+		break;
+	}
+	case FIELD_TYPE_FLOAT64:
+		((double *)values)[pos] = mp_decode_double(data);
+		break;
+	case FIELD_TYPE_STRING:
+	case FIELD_TYPE_VARBINARY: {
+		uint32_t len;
+		const char *str = column->type == FIELD_TYPE_STRING ?
+				  mp_decode_str(data, &len) :
+				  mp_decode_bin(data, &len);
+		((uint32_t *)values)[pos] =
+			memcs_index_dict_put(index, fieldno, str, len);
+		break;
+	}
+	default:
+		unreachable();
+	}
+	return 0;
+}
+
+/**
+ * Marks fields of a row starting from @a fieldno as null. The row is
+ * freed on a write error, so fields that weren't written must not keep
+ * string codes left from a previous row, which were unreferenced when
+ * that row was freed.
+ */
+static void
+memcs_index_clear_row(struct memcs_index *index, struct memcs_block *block,
+		      uint32_t pos, uint32_t fieldno)
+{
+	for (uint32_t i = fieldno; i < index->data.column_count; i++) {
+		const struct memcs_column *column = &index->data.columns[i];
+		bit_clear(block->data + column->validity_offset, pos);
+	}
+}
+
+/**
+ * Stores a MsgPack array validated against the space format in a row.
+ * Returns -1 on error (diag is set).
+ */
+static int
+memcs_index_write_row(struct memcs_index *index, uint32_t row,
+		      const char *data)
+{
+	struct memcs_block *block = memcs_index_writable_block(index, row);
+	uint32_t pos = row % MEMCS_BLOCK_ROW_COUNT;
+	uint32_t field_count = mp_decode_array(&data);
+	if (field_count > index->data.column_count) {
+		memcs_index_clear_row(index, block, pos, 0);
+		diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+			 "fields not described by the space format");
+		return -1;
+	}
+	for (uint32_t i = 0; i < index->data.column_count; i++) {
+		const struct memcs_column *column = &index->data.columns[i];
+		char *values = block->data + column->values_offset;
+		if (i >= field_count || mp_typeof(*data) == MP_NIL) {
+			bit_clear(block->data + column->validity_offset, pos);
+			memset(values + pos * column->width, 0, column->width);
+			if (i < field_count)
+				mp_next(&data);
+			continue;
+		}
+		bit_set(block->data + column->validity_offset, pos);
+		if (memcs_index_store_value(index, i, &data, values,
+					    pos) != 0) {
+			memcs_index_clear_row(index, block, pos, i);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/** }}} Row storage */
+
+/** {{{ Primary key tree */
+
+static void
+memcs_index_tree_insert(struct memcs_index *index, uint32_t row,
+			uint32_t *replaced)
+{
+	*replaced = MEMCS_ROW_NONE;
+	/* Tree extents are allocated with xmalloc so insertion can't fail. */
+	VERIFY(memcs_tree_insert(&index->tree, row, replaced, NULL) == 0);
+	index->version++;
+}
+
+static void
+memcs_index_tree_delete(struct memcs_index *index, uint32_t row)
+{
+	VERIFY(memcs_tree_delete(&index->tree, row, NULL) == 0);
+	index->version++;
+}
+
+/** Looks up a row by a full key, returns MEMCS_ROW_NONE if not found. */
+static uint32_t
+memcs_index_find_key(struct memcs_index *index, const char *key,
+		     uint32_t part_count)
+{
+	struct memcs_tree_key tree_key = {key, part_count};
+	uint32_t *row = memcs_tree_find(&index->tree, &tree_key);
+	return row != NULL ? *row : MEMCS_ROW_NONE;
+}
+
+/**
+ * Looks up a row with the same key as @a row, returns MEMCS_ROW_NONE
+ * if not found.
+ */
+static uint32_t
+memcs_index_find_row(struct memcs_index *index, uint32_t row)
+{
+	bool exact = false;
+	struct memcs_tree_iterator it =
+		memcs_tree_lower_bound_elem(&index->tree, row, &exact);
+	if (!exact)
+		return MEMCS_ROW_NONE;
+	return *memcs_tree_iterator_get_elem(&index->tree, &it);
+}
+
+/**
+ * Stores a MsgPack array validated against the space format in a new row
+ * and inserts it into the primary key. @a old_row is the row the new one
+ * is supposed to replace (MEMCS_ROW_NONE if none), @a old_tuple is the
+ * tuple created from it. Duplicates are handled according to @a mode as
+ * in index_check_dup().
+ *
+ * On success returns the new row and the replaced row or MEMCS_ROW_NONE.
+ * The replaced row isn't freed. On error returns -1 and sets diag.
+ */
+static int
+memcs_index_replace(struct memcs_index *index, uint32_t old_row,
+		    struct tuple *old_tuple, const char *data,
+		    const char *data_end, enum dup_replace_mode mode,
+		    uint32_t *new_row, uint32_t *replaced_row)
+{
+	uint32_t row;
+	if (memcs_index_alloc_row(index, &row) != 0)
+		return -1;
+	if (memcs_index_write_row(index, row, data) != 0)
+		goto fail;
+	uint32_t dup_row = memcs_index_find_row(index, row);
+	bool is_dup_ok = dup_row == old_row ||
+			 (dup_row == MEMCS_ROW_NONE ? mode != DUP_REPLACE :
+			  old_row == MEMCS_ROW_NONE && mode != DUP_INSERT);
+	if (!is_dup_ok) {
+		/* Create tuples only to report the error. */
+		struct tuple *new_tuple = tuple_new(memcs_index_format(index),
+						    data, data_end);
+		if (new_tuple == NULL)
+			goto fail;
+		tuple_ref(new_tuple);
+		struct tuple *dup_tuple = NULL;
+		if (dup_row != MEMCS_ROW_NONE) {
+			dup_tuple = memcs_index_tuple_new(index, dup_row);
+			if (dup_tuple == NULL) {
+				tuple_unref(new_tuple);
+				goto fail;
+			}
+			tuple_ref(dup_tuple);
+		}
+		VERIFY(index_check_dup(&index->base, old_tuple, new_tuple,
+				       dup_tuple, mode) != 0);
+		tuple_unref(new_tuple);
+		if (dup_tuple != NULL)
+			tuple_unref(dup_tuple);
+		goto fail;
+	}
+	uint32_t replaced;
+	memcs_index_tree_insert(index, row, &replaced);
+	assert(replaced == dup_row);
+	*new_row = row;
+	*replaced_row = replaced;
+	return 0;
+fail:
+	memcs_index_free_row(index, row);
+	return -1;
+}
+
+/**
+ * Positions a tree iterator at the first row to return when iterating
+ * with the given type and key, skipping rows up to the @a after key
+ * if it isn't NULL. See memtx_tree_lookup() for the details.
+ */
+static struct memcs_tree_iterator
+memcs_tree_lookup(const struct memcs_tree *tree, enum iterator_type type,
+		  const char *key, uint32_t part_count,
+		  const char *after, uint32_t after_part_count)
+{
+	struct memcs_tree_key start = {key, part_count};
+	bool skip_equal = after != NULL;
+	if (skip_equal) {
+		start.key = after;
+		start.part_count = after_part_count;
+		if (type != ITER_EQ && type != ITER_REQ)
+			type = iterator_type_is_reverse(type) ?
+			       ITER_LT : ITER_GT;
+	}
+	struct memcs_tree_iterator it;
+	bool exact;
+	if (start.part_count == 0) {
+		it = iterator_type_is_reverse(type) ?
+		     memcs_tree_invalid_iterator() : memcs_tree_first(tree);
+	} else {
+		bool need_lower_bound = type == ITER_EQ || type == ITER_GE ||
+					type == ITER_LT;
+		if (skip_equal && (type == ITER_EQ || type == ITER_REQ))
+			need_lower_bound = !need_lower_bound;
+		it = need_lower_bound ?
+		     memcs_tree_lower_bound(tree, &start, &exact) :
+		     memcs_tree_upper_bound(tree, &start, &exact);
+	}
+	/* A step back from an invalid iterator goes to the last row. */
+	if (iterator_type_is_reverse(type))
+		memcs_tree_iterator_prev(tree, &it);
+	return it;
+}
+
+/** Same as memcs_tree_lookup(), but looks up in a tree view. */
+static struct memcs_tree_iterator
+memcs_tree_view_lookup(const struct memcs_tree_view *view,
+		       enum iterator_type type,
+		       const char *key, uint32_t part_count,
+		       const char *after, uint32_t after_part_count)
+{
+	struct memcs_tree_key start = {key, part_count};
+	bool skip_equal = after != NULL;
+	if (skip_equal) {
+		start.key = after;
+		start.part_count = after_part_count;
+		if (type != ITER_EQ && type != ITER_REQ)
+			type = iterator_type_is_reverse(type) ?
+			       ITER_LT : ITER_GT;
+	}
+	struct memcs_tree_iterator it;
+	bool exact;
+	if (start.part_count == 0) {
+		it = iterator_type_is_reverse(type) ?
+		     memcs_tree_invalid_iterator() :
+		     memcs_tree_view_first(view);
+	} else {
+		bool need_lower_bound = type == ITER_EQ || type == ITER_GE ||
+					type == ITER_LT;
+		if (skip_equal && (type == ITER_EQ || type == ITER_REQ))
+			need_lower_bound = !need_lower_bound;
+		it = need_lower_bound ?
+		     memcs_tree_view_lower_bound(view, &start, &exact) :
+		     memcs_tree_view_upper_bound(view, &start, &exact);
+	}
+	if (iterator_type_is_reverse(type))
+		memcs_tree_view_iterator_prev(view, &it);
+	return it;
+}
+
+/**
+ * Canonicalizes the iterator type: a search without a key is a full
+ * scan. Returns -1 and sets diag if the type isn't supported.
+ */
+static int
+memcs_canonicalize_lookup(struct index_def *def, enum iterator_type *type,
+			  uint32_t part_count)
+{
+	if (*type == ITER_NP || *type == ITER_PP) {
+		diag_set(UnsupportedIndexFeature, def,
+			 "requested iterator type");
+		return -1;
+	}
+	if (part_count == 0)
+		*type = iterator_type_is_reverse(*type) ? ITER_LE : ITER_GE;
+	if (*type == ITER_ALL)
+		*type = ITER_GE;
+	return 0;
+}
+
+/** }}} Primary key tree */
+
+/** {{{ Statement undo */
+
+/** Changes made by a statement, stored in txn_stmt::engine_savepoint. */
+struct memcs_undo {
+	/** Modified index, referenced. */
+	struct memcs_index *index;
+	/** Rows inserted into the index. */
+	uint32_t *new_rows;
+	/** Number of inserted rows. */
+	uint32_t new_row_count;
+	/** Capacity of the inserted row array. */
+	uint32_t new_row_capacity;
+	/** Rows deleted from the index. */
+	uint32_t *old_rows;
+	/** Number of deleted rows. */
+	uint32_t old_row_count;
+	/** Capacity of the deleted row array. */
+	uint32_t old_row_capacity;
+};
+
+/** Appends a row to an array growing it if needed. */
+static void
+memcs_row_array_add(uint32_t **rows, uint32_t *count, uint32_t *capacity,
+		    uint32_t row)
+{
+	if (*count == *capacity) {
+		*capacity = MAX(*capacity * 2, 4);
+		*rows = xrealloc(*rows, *capacity * sizeof(**rows));
+	}
+	(*rows)[(*count)++] = row;
+}
+
+/**
+ * Records a change made by the current statement: @a new_row was inserted
+ * and @a old_row was deleted. Either of the rows may be MEMCS_ROW_NONE.
+ */
+static void
+memcs_undo_add(struct txn_stmt *stmt, struct memcs_index *index,
+	       uint32_t new_row, uint32_t old_row)
+{
+	struct memcs_undo *undo = stmt->engine_savepoint;
+	if (undo == NULL) {
+		undo = xcalloc(1, sizeof(*undo));
+		undo->index = index;
+		index_ref(&index->base);
+		stmt->engine_savepoint = undo;
+	}
+	assert(undo->index == index);
+	if (new_row != MEMCS_ROW_NONE) {
+		memcs_row_array_add(&undo->new_rows, &undo->new_row_count,
+				    &undo->new_row_capacity, new_row);
+	}
+	if (old_row != MEMCS_ROW_NONE) {
+		memcs_row_array_add(&undo->old_rows, &undo->old_row_count,
+				    &undo->old_row_capacity, old_row);
+	}
+}
+
+/** }}} Statement undo */
+
+/** {{{ Iterator */
+
+struct memcs_iterator {
+	struct iterator base;
+	/** Iterator type. */
+	enum iterator_type type;
+	/** Search key allocated with malloc, NULL for a full scan. */
+	char *key;
+	/** Number of parts in the search key. */
+	uint32_t part_count;
+	/**
+	 * Primary key of the last returned row or the start position
+	 * without the array header, allocated with malloc. NULL if none.
+	 */
+	char *last_key;
+	/** Size of the last key. */
+	uint32_t last_key_size;
+	/** Size of the memory allocated for the last key. */
+	uint32_t last_key_capacity;
+	/** Number of parts in the primary key. */
+	uint32_t pk_part_count;
+	/** Position in the tree. */
+	struct memcs_tree_iterator tree_it;
+	/** Index version the position is valid for. */
+	uint32_t version;
+	/** Set once the first row is fetched. */
+	bool is_started;
+};
+
+static void
+memcs_iterator_set_last_key(struct memcs_iterator *it,
+			    const struct memcs_data *data, uint32_t row)
+{
+	uint32_t size = memcs_data_key_bsize(data, row);
+	if (size > it->last_key_capacity) {
+		it->last_key = xrealloc(it->last_key, size);
+		it->last_key_capacity = size;
+	}
+	char *end = memcs_data_encode_key(data, row, it->last_key);
+	assert(end == it->last_key + size);
+	(void)end;
+	it->last_key_size = size;
+}
+
+static int
+memcs_iterator_next(struct iterator *base, struct tuple **ret)
+{
+	struct memcs_iterator *it = (struct memcs_iterator *)base;
+	struct memcs_index *index = (struct memcs_index *)
+		index_weak_ref_get_index_checked(&base->index_ref);
+	struct memcs_tree *tree = &index->tree;
+	if (it->version != index->version) {
+		/* The tree was modified: continue after the last key. */
+		it->tree_it = memcs_tree_lookup(
+			tree, it->type, it->key, it->part_count, it->last_key,
+			it->last_key != NULL ? it->pk_part_count : 0);
+		it->version = index->version;
+	} else if (it->is_started) {
+		if (iterator_type_is_reverse(it->type))
+			memcs_tree_iterator_prev(tree, &it->tree_it);
+		else
+			memcs_tree_iterator_next(tree, &it->tree_it);
+	}
+	it->is_started = true;
+	uint32_t *row = memcs_tree_iterator_get_elem(tree, &it->tree_it);
+	if (row == NULL ||
+	    ((it->type == ITER_EQ || it->type == ITER_REQ) &&
+	     memcs_data_compare_with_key(&index->data, *row, it->key,
+					 it->part_count) != 0)) {
+		base->next = exhausted_iterator_next;
+		*ret = NULL;
+		return 0;
+	}
+	struct tuple *tuple = memcs_index_tuple_new(index, *row);
+	if (tuple == NULL)
+		return -1;
+	memcs_iterator_set_last_key(it, &index->data, *row);
+	*ret = tuple_bless(tuple);
+	return 0;
+}
+
+static int
+memcs_iterator_position(struct iterator *base, const char **pos,
+			uint32_t *size)
+{
+	struct memcs_iterator *it = (struct memcs_iterator *)base;
+	if (it->last_key == NULL) {
+		*pos = NULL;
+		*size = 0;
+		return 0;
+	}
+	*size = mp_sizeof_array(it->pk_part_count) + it->last_key_size;
+	char *buf = xregion_alloc(&fiber()->gc, *size);
+	char *p = mp_encode_array(buf, it->pk_part_count);
+	memcpy(p, it->last_key, it->last_key_size);
+	*pos = buf;
+	return 0;
+}
+
+static void
+memcs_iterator_free(struct iterator *base)
+{
+	struct memcs_iterator *it = (struct memcs_iterator *)base;
+	free(it->key);
+	free(it->last_key);
+	free(it);
+}
+
+/** }}} Iterator */
+
+/** {{{ Read view */
+
+struct memcs_index_read_view {
+	struct index_read_view base;
+	/** Snapshot of the index data. */
+	struct memcs_data data;
+	/** Frozen primary key tree. */
+	struct memcs_tree_view tree_view;
+	/** Index the read view was created from, referenced. */
+	struct memcs_index *index;
+};
+
+struct memcs_read_view_iterator {
+	struct index_read_view_iterator_base base;
+	/** Position in the frozen tree. */
+	struct memcs_tree_iterator tree_it;
+	/** Key of an EQ or REQ iterator allocated with malloc or NULL. */
+	char *key;
+	/** Number of parts in the key. */
+	uint32_t part_count;
+	/** Set if the iterator is reverse. */
+	bool is_reverse;
+	/** Set once the first row is fetched. */
+	bool is_started;
+};
+
+static_assert(sizeof(struct memcs_read_view_iterator) <=
+	      INDEX_READ_VIEW_ITERATOR_SIZE,
+	      "sizeof(struct memcs_read_view_iterator) must be less than "
+	      "or equal to INDEX_READ_VIEW_ITERATOR_SIZE");
+
+/** Fetches the next row number, returns false at the end. */
+static bool
+memcs_read_view_iterator_next_row(struct memcs_read_view_iterator *it,
+				  uint32_t *row)
+{
+	struct memcs_index_read_view *rv =
+		(struct memcs_index_read_view *)it->base.index;
+	struct memcs_tree_view *view = &rv->tree_view;
+	if (it->is_started) {
+		/* A step from an invalid iterator wraps around. */
+		if (memcs_tree_iterator_is_invalid(&it->tree_it))
+			return false;
+		if (it->is_reverse)
+			memcs_tree_view_iterator_prev(view, &it->tree_it);
+		else
+			memcs_tree_view_iterator_next(view, &it->tree_it);
+	}
+	it->is_started = true;
+	uint32_t *elem = memcs_tree_view_iterator_get_elem(view, &it->tree_it);
+	if (elem == NULL)
+		return false;
+	if (it->key != NULL &&
+	    memcs_data_compare_with_key(&rv->data, *elem, it->key,
+					it->part_count) != 0) {
+		it->tree_it = memcs_tree_invalid_iterator();
+		return false;
+	}
+	*row = *elem;
+	return true;
+}
+
+static int
+memcs_read_view_iterator_next_raw(struct index_read_view_iterator *base,
+				  struct read_view_tuple *result)
+{
+	struct memcs_read_view_iterator *it =
+		(struct memcs_read_view_iterator *)base;
+	struct memcs_index_read_view *rv =
+		(struct memcs_index_read_view *)it->base.index;
+	uint32_t row;
+	if (!memcs_read_view_iterator_next_row(it, &row)) {
+		*result = read_view_tuple_none();
+		return 0;
+	}
+	*result = read_view_tuple_none();
+	result->data = memcs_data_encode_row(&rv->data, row, &result->size);
+	return 0;
+}
+
+static void
+memcs_read_view_iterator_destroy(struct index_read_view_iterator *base)
+{
+	struct memcs_read_view_iterator *it =
+		(struct memcs_read_view_iterator *)base;
+	free(it->key);
+	TRASH(it);
+}
+
+static int
+memcs_index_read_view_create_iterator(struct index_read_view *base,
+				      enum iterator_type type,
+				      const char *key, uint32_t part_count,
+				      const char *pos,
+				      struct index_read_view_iterator *it_base)
+{
+	struct memcs_index_read_view *rv =
+		(struct memcs_index_read_view *)base;
+	if (memcs_canonicalize_lookup(base->def, &type, part_count) != 0)
+		return -1;
+	struct memcs_read_view_iterator *it =
+		(struct memcs_read_view_iterator *)it_base;
+	it->base.index = base;
+	it->base.destroy = memcs_read_view_iterator_destroy;
+	it->base.next_raw = memcs_read_view_iterator_next_raw;
+	it->base.position = generic_index_read_view_iterator_position;
+	it->tree_it = memcs_tree_view_lookup(
+		&rv->tree_view, type, key, part_count, pos,
+		pos != NULL ? rv->data.key_def->part_count : 0);
+	it->key = NULL;
+	it->part_count = part_count;
+	if (type == ITER_EQ || type == ITER_REQ) {
+		uint32_t size;
+		it->key = memcs_key_dup(key, part_count, &size);
+	}
+	it->is_reverse = iterator_type_is_reverse(type);
+	it->is_started = false;
+	return 0;
+}
+
+static int
+memcs_index_read_view_get_raw(struct index_read_view *base,
+			      const char *key, uint32_t part_count,
+			      struct read_view_tuple *result)
+{
+	struct memcs_index_read_view *rv =
+		(struct memcs_index_read_view *)base;
+	struct memcs_tree_key tree_key = {key, part_count};
+	uint32_t *row = memcs_tree_view_find(&rv->tree_view, &tree_key);
+	*result = read_view_tuple_none();
+	if (row != NULL) {
+		result->data = memcs_data_encode_row(&rv->data, *row,
+						     &result->size);
+	}
+	return 0;
+}
+
+static void
+memcs_index_read_view_free(struct index_read_view *base)
+{
+	struct memcs_index_read_view *rv =
+		(struct memcs_index_read_view *)base;
+	struct memcs_index *index = rv->index;
+	struct memcs_engine *engine = (struct memcs_engine *)index->base.engine;
+	memcs_tree_view_destroy(&rv->tree_view);
+	for (uint32_t i = 0; i < rv->data.block_count; i++) {
+		struct memcs_block *block = rv->data.blocks[i];
+		if (--block->refs == 0) {
+			free(block);
+			engine->data_size -= index->block_size;
+		}
+	}
+	free(rv->data.blocks);
+	for (uint32_t i = 0; i < rv->data.column_count; i++) {
+		struct memcs_dict *dict = &rv->data.dicts[i];
+		uint32_t chunk_count = DIV_ROUND_UP(dict->size,
+						    MEMCS_DICT_CHUNK_SIZE);
+		for (uint32_t j = 0; j < chunk_count; j++)
+			memcs_index_dict_chunk_unref(index, dict->chunks[j]);
+		free(dict->chunks);
+	}
+	free(rv->data.dicts);
+	index_unref(&index->base);
+	TRASH(rv);
+	free(rv);
+}
+
+static int
+memcs_index_read_view_create_arrow_stream(
+	struct index_read_view *base, uint32_t field_count,
+	const uint32_t *fields, const char *key, uint32_t part_count,
+	const struct arrow_options *options, struct ArrowArrayStream *stream);
+
+static const struct index_read_view_vtab memcs_index_read_view_vtab = {
+	.free = memcs_index_read_view_free,
+	.count = generic_index_read_view_count,
+	.quantile = generic_index_read_view_quantile,
+	.get_raw = memcs_index_read_view_get_raw,
+	.create_iterator = memcs_index_read_view_create_iterator,
+	.create_iterator_with_offset =
+		generic_index_read_view_create_iterator_with_offset,
+	.create_arrow_stream = memcs_index_read_view_create_arrow_stream,
+};
+
+static struct index_read_view *
+memcs_index_create_read_view(struct index *base)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	struct memcs_index_read_view *rv = xmalloc(sizeof(*rv));
+	index_read_view_create(&rv->base, &memcs_index_read_view_vtab,
+			       base->def);
+	index_ref(base);
+	rv->index = index;
+	struct memcs_data *data = &rv->data;
+	*data = index->data;
+	data->blocks = NULL;
+	if (data->block_count > 0) {
+		data->blocks = xmalloc(data->block_count *
+				       sizeof(data->blocks[0]));
+		for (uint32_t i = 0; i < data->block_count; i++) {
+			data->blocks[i] = index->data.blocks[i];
+			data->blocks[i]->refs++;
+		}
+	}
+	data->dicts = xcalloc(data->column_count, sizeof(data->dicts[0]));
+	for (uint32_t i = 0; i < data->column_count; i++) {
+		const struct memcs_dict *src = &index->data.dicts[i];
+		struct memcs_dict *dst = &data->dicts[i];
+		uint32_t chunk_count = DIV_ROUND_UP(src->size,
+						    MEMCS_DICT_CHUNK_SIZE);
+		if (chunk_count == 0)
+			continue;
+		dst->chunks = xmalloc(chunk_count * sizeof(dst->chunks[0]));
+		for (uint32_t j = 0; j < chunk_count; j++) {
+			dst->chunks[j] = src->chunks[j];
+			dst->chunks[j]->refs++;
+		}
+		dst->size = src->size;
+		dst->chunk_capacity = chunk_count;
+	}
+	memcs_tree_view_create(&rv->tree_view, &index->tree);
+	rv->tree_view.common.arg = &rv->data;
+	return &rv->base;
+}
+
+/** }}} Read view */
+
+/** {{{ Arrow stream */
+
+/** A column of an Arrow stream. */
+struct memcs_arrow_column {
+	/** Number of the field stored in the column. */
+	uint32_t fieldno;
+	/** Column name. */
+	char *name;
+	/** Whether the column may contain nulls. */
+	bool is_nullable;
+};
+
+/** Arrow stream over a memcs index read view. */
+struct memcs_arrow_stream {
+	/** Read view the stream reads from. */
+	struct memcs_index_read_view *rv;
+	/** Set if the read view was created for the stream. */
+	bool owns_rv;
+	/** Iterator over the read view. */
+	struct index_read_view_iterator it;
+	/** Columns of record batches. */
+	struct memcs_arrow_column *columns;
+	/** Number of columns. */
+	uint32_t column_count;
+	/** Max number of rows in a record batch. */
+	uint32_t batch_row_count;
+	/** Row numbers of the record batch being built. */
+	uint32_t *rows;
+	/** Message of the last error or NULL. */
+	char *last_error;
+};
+
+static void
+memcs_arrow_child_array_release(struct ArrowArray *array)
+{
+	for (int64_t i = 0; i < array->n_buffers; i++)
+		free((void *)array->buffers[i]);
+	free(array->buffers);
+	array->release = NULL;
+}
+
+static void
+memcs_arrow_array_release(struct ArrowArray *array)
+{
+	for (int64_t i = 0; i < array->n_children; i++) {
+		struct ArrowArray *child = array->children[i];
+		if (child == NULL)
+			continue;
+		if (child->release != NULL)
+			child->release(child);
+		free(child);
+	}
+	free(array->children);
+	free(array->buffers);
+	array->release = NULL;
+}
+
+static void
+memcs_arrow_child_schema_release(struct ArrowSchema *schema)
+{
+	free((char *)schema->name);
+	schema->release = NULL;
+}
+
+static void
+memcs_arrow_schema_release(struct ArrowSchema *schema)
+{
+	for (int64_t i = 0; i < schema->n_children; i++) {
+		struct ArrowSchema *child = schema->children[i];
+		if (child->release != NULL)
+			child->release(child);
+		free(child);
+	}
+	free(schema->children);
+	schema->release = NULL;
+}
+
+/**
+ * Gathers values of a field of the given rows into a column of a record
+ * batch. Returns -1 on error (diag is set).
+ */
+static int
+memcs_arrow_column_build(const struct memcs_data *data, uint32_t fieldno,
+			 const uint32_t *rows, uint32_t count,
+			 struct ArrowArray *child)
+{
+	const struct memcs_column *column = &data->columns[fieldno];
+	const void **buffers = xcalloc(3, sizeof(*buffers));
+	child->length = count;
+	child->n_buffers = memcs_type_is_dict(column->type) ? 3 : 2;
+	child->buffers = buffers;
+	child->release = memcs_arrow_child_array_release;
+
+	size_t bitmap_size = DIV_ROUND_UP(count, CHAR_BIT);
+	uint8_t *validity = xcalloc(bitmap_size, 1);
+	buffers[0] = validity;
+	for (uint32_t i = 0; i < count; i++) {
+		if (memcs_data_is_null(data, fieldno, rows[i]))
+			child->null_count++;
+		else
+			bit_set(validity, i);
+	}
+	switch (column->type) {
+	case FIELD_TYPE_BOOLEAN: {
+		uint8_t *values = xcalloc(bitmap_size, 1);
+		buffers[1] = values;
+		for (uint32_t i = 0; i < count; i++) {
+			if (*memcs_data_value(data, fieldno, rows[i]) != 0)
+				bit_set(values, i);
+		}
+		break;
+	}
+	case FIELD_TYPE_STRING:
+	case FIELD_TYPE_VARBINARY: {
+		int32_t *offsets = xmalloc((count + 1) * sizeof(*offsets));
+		buffers[1] = offsets;
+		size_t size = 0;
+		offsets[0] = 0;
+		for (uint32_t i = 0; i < count; i++) {
+			if (bit_test(validity, i))
+				size += memcs_data_str(data, fieldno,
+						       rows[i])->len;
+			if (size > INT32_MAX) {
+				diag_set(ClientError, ER_UNSUPPORTED,
+					 "Engine 'memcs'",
+					 "more than 2GB of data in a column "
+					 "of a record batch");
+				return -1;
+			}
+			offsets[i + 1] = size;
+		}
+		char *values = xmalloc(MAX(size, (size_t)1));
+		buffers[2] = values;
+		for (uint32_t i = 0; i < count; i++) {
+			if (!bit_test(validity, i))
+				continue;
+			const struct memcs_str *s =
+				memcs_data_str(data, fieldno, rows[i]);
+			memcpy(values + offsets[i], s->data, s->len);
+		}
+		break;
+	}
+	default: {
+		uint32_t width = column->width;
+		char *values = xmalloc((size_t)count * width);
+		buffers[1] = values;
+		for (uint32_t i = 0; i < count; i++) {
+			memcpy(values + (size_t)i * width,
+			       memcs_data_value(data, fieldno, rows[i]), width);
+		}
+		break;
+	}
+	}
+	return 0;
+}
+
+/** Remembers the diag error message to return it from get_last_error. */
+static void
+memcs_arrow_stream_set_error(struct memcs_arrow_stream *s)
+{
+	free(s->last_error);
+	s->last_error = xstrdup(diag_last_error(diag_get())->errmsg);
+}
+
+static int
+memcs_arrow_stream_get_schema(struct ArrowArrayStream *stream,
+			      struct ArrowSchema *schema)
+{
+	struct memcs_arrow_stream *s = stream->private_data;
+	memset(schema, 0, sizeof(*schema));
+	schema->format = "+s";
+	schema->name = "";
+	schema->n_children = s->column_count;
+	schema->children = xcalloc(s->column_count,
+				   sizeof(schema->children[0]));
+	schema->release = memcs_arrow_schema_release;
+	for (uint32_t i = 0; i < s->column_count; i++) {
+		const struct memcs_arrow_column *column = &s->columns[i];
+		struct ArrowSchema *child = xcalloc(1, sizeof(*child));
+		child->format = tuple_arrow_format(
+			s->rv->data.columns[column->fieldno].type);
+		child->name = xstrdup(column->name);
+		child->flags = column->is_nullable ? ARROW_FLAG_NULLABLE : 0;
+		child->release = memcs_arrow_child_schema_release;
+		schema->children[i] = child;
+	}
+	return 0;
+}
+
+static int
+memcs_arrow_stream_get_next(struct ArrowArrayStream *stream,
+			    struct ArrowArray *array)
+{
+	struct memcs_arrow_stream *s = stream->private_data;
+	struct memcs_read_view_iterator *it =
+		(struct memcs_read_view_iterator *)&s->it;
+	memset(array, 0, sizeof(*array));
+	uint32_t count = 0;
+	while (count < s->batch_row_count &&
+	       memcs_read_view_iterator_next_row(it, &s->rows[count]))
+		count++;
+	/* The end of the stream is marked by a released array. */
+	if (count == 0)
+		return 0;
+	array->length = count;
+	array->n_buffers = 1;
+	array->buffers = xcalloc(1, sizeof(array->buffers[0]));
+	array->n_children = s->column_count;
+	array->children = xcalloc(s->column_count, sizeof(array->children[0]));
+	array->release = memcs_arrow_array_release;
+	for (uint32_t i = 0; i < s->column_count; i++) {
+		struct ArrowArray *child = xcalloc(1, sizeof(*child));
+		array->children[i] = child;
+		if (memcs_arrow_column_build(&s->rv->data,
+					     s->columns[i].fieldno,
+					     s->rows, count, child) != 0) {
+			memcs_arrow_stream_set_error(s);
+			array->release(array);
+			return EINVAL;
+		}
+	}
+	return 0;
+}
+
+static const char *
+memcs_arrow_stream_get_last_error(struct ArrowArrayStream *stream)
+{
+	struct memcs_arrow_stream *s = stream->private_data;
+	return s->last_error;
+}
+
+static void
+memcs_arrow_stream_release(struct ArrowArrayStream *stream)
+{
+	struct memcs_arrow_stream *s = stream->private_data;
+	index_read_view_iterator_destroy(&s->it);
+	if (s->owns_rv)
+		index_read_view_delete(&s->rv->base);
+	for (uint32_t i = 0; i < s->column_count; i++)
+		free(s->columns[i].name);
+	free(s->columns);
+	free(s->rows);
+	free(s->last_error);
+	free(s);
+	stream->release = NULL;
+}
+
+/**
+ * Creates an Arrow stream returning the given fields of rows of a read
+ * view. If @a owns_rv is set, the read view is deleted with the stream.
+ * @a defs are definitions of the space fields, used for column names,
+ * or NULL. Returns -1 on error (diag is set).
+ */
+static int
+memcs_arrow_stream_create(struct memcs_index_read_view *rv, bool owns_rv,
+			  const struct field_def *defs, uint32_t field_count,
+			  const uint32_t *fields, const char *key,
+			  uint32_t part_count,
+			  const struct arrow_options *options,
+			  struct ArrowArrayStream *stream)
+{
+	if (options->batch_row_count == 0) {
+		diag_set(IllegalParams,
+			 "Arrow record batch row count must be positive");
+		return -1;
+	}
+	for (uint32_t i = 0; i < field_count; i++) {
+		if (fields[i] >= rv->data.column_count) {
+			diag_set(ClientError, ER_NO_SUCH_FIELD_NO,
+				 fields[i] + TUPLE_INDEX_BASE);
+			return -1;
+		}
+		enum field_type type = rv->data.columns[fields[i]].type;
+		if (options->force_view_types && memcs_type_is_dict(type)) {
+			diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+				 "Arrow view types");
+			return -1;
+		}
+	}
+	struct memcs_arrow_stream *s = xcalloc(1, sizeof(*s));
+	if (memcs_index_read_view_create_iterator(&rv->base, options->iterator,
+						  key, part_count, NULL,
+						  &s->it) != 0) {
+		free(s);
+		return -1;
+	}
+	s->rv = rv;
+	s->owns_rv = owns_rv;
+	s->column_count = field_count;
+	s->columns = xcalloc(field_count, sizeof(s->columns[0]));
+	for (uint32_t i = 0; i < field_count; i++) {
+		struct memcs_arrow_column *column = &s->columns[i];
+		column->fieldno = fields[i];
+		if (defs != NULL) {
+			column->name = xstrdup(defs[fields[i]].name);
+			column->is_nullable = defs[fields[i]].is_nullable;
+		} else {
+			column->name = xstrdup(tt_sprintf(
+				"field_%u", fields[i] + TUPLE_INDEX_BASE));
+			column->is_nullable = true;
+		}
+	}
+	s->batch_row_count = options->batch_row_count;
+	s->rows = xmalloc(s->batch_row_count * sizeof(s->rows[0]));
+	memset(stream, 0, sizeof(*stream));
+	stream->get_schema = memcs_arrow_stream_get_schema;
+	stream->get_next = memcs_arrow_stream_get_next;
+	stream->get_last_error = memcs_arrow_stream_get_last_error;
+	stream->release = memcs_arrow_stream_release;
+	stream->private_data = s;
+	return 0;
+}
+
+static int
+memcs_index_read_view_create_arrow_stream(
+	struct index_read_view *base, uint32_t field_count,
+	const uint32_t *fields, const char *key, uint32_t part_count,
+	const struct arrow_options *options, struct ArrowArrayStream *stream)
+{
+	struct memcs_index_read_view *rv =
+		(struct memcs_index_read_view *)base;
+	const struct field_def *defs = NULL;
+	if (base->space != NULL &&
+	    base->space->field_count == rv->data.column_count)
+		defs = base->space->fields;
+	return memcs_arrow_stream_create(rv, false, defs, field_count, fields,
+					 key, part_count, options, stream);
+}
+
+/** }}} Arrow stream */
+
+/** {{{ Index */
+
+static void
+memcs_index_destroy(struct index *base)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	struct memcs_engine *engine = (struct memcs_engine *)base->engine;
+	struct memcs_data *data = &index->data;
+	memcs_tree_destroy(&index->tree);
+	for (uint32_t i = 0; i < data->block_count; i++) {
+		assert(data->blocks[i]->refs == 1);
+		free(data->blocks[i]);
+	}
+	engine->data_size -= data->block_count * index->block_size;
+	free(data->blocks);
+	for (uint32_t i = 0; i < data->column_count; i++) {
+		struct memcs_dict *dict = &data->dicts[i];
+		if (dict->hash == NULL)
+			continue;
+		mh_strnu32_delete(dict->hash);
+		uint32_t chunk_count = DIV_ROUND_UP(dict->size,
+						    MEMCS_DICT_CHUNK_SIZE);
+		for (uint32_t j = 0; j < chunk_count; j++) {
+			struct memcs_dict_chunk *chunk = dict->chunks[j];
+			assert(chunk->refs == 1);
+			for (uint32_t k = 0; k < MEMCS_DICT_CHUNK_SIZE; k++) {
+				if (chunk->strs[k] != NULL)
+					chunk->strs[k]->row_refs = 0;
+			}
+			memcs_index_dict_chunk_unref(index, chunk);
+		}
+		free(dict->chunks);
+		free(dict->free_codes);
+	}
+	assert(index->dict_size == 0);
+	free(data->dicts);
+	free(data->columns);
+	key_def_delete(data->key_def);
+	free(index->free_rows);
+	TRASH(index);
+	free(index);
+}
+
+static bool
+memcs_index_def_change_requires_rebuild(struct index *index,
+					const struct index_def *new_def)
+{
+	struct key_def *old_key_def = index->def->key_def;
+	struct key_def *new_key_def = new_def->key_def;
+	return key_part_cmp(old_key_def->parts, old_key_def->part_count,
+			    new_key_def->parts, new_key_def->part_count) != 0;
+}
+
+static ssize_t
+memcs_index_size(struct index *base)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	return memcs_tree_size(&index->tree);
+}
+
+static ssize_t
+memcs_index_bsize(struct index *base)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	return memcs_tree_mem_used(&index->tree) +
+	       index->data.block_count * index->block_size + index->dict_size;
+}
+
+static int
+memcs_index_random(struct index *base, uint32_t rnd, struct tuple **result)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	uint32_t *row = memcs_tree_random(&index->tree, rnd);
+	*result = NULL;
+	if (row == NULL)
+		return 0;
+	struct tuple *tuple = memcs_index_tuple_new(index, *row);
+	if (tuple == NULL)
+		return -1;
+	*result = tuple_bless(tuple);
+	return 0;
+}
+
+static ssize_t
+memcs_index_count(struct index *base, enum iterator_type type,
+		  const char *key, uint32_t part_count)
+{
+	if (part_count == 0)
+		return memcs_index_size(base);
+	return generic_index_count(base, type, key, part_count);
+}
+
+static int
+memcs_index_get(struct index *base, const char *key, uint32_t part_count,
+		struct tuple **result)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	uint32_t row = memcs_index_find_key(index, key, part_count);
+	*result = NULL;
+	if (row == MEMCS_ROW_NONE)
+		return 0;
+	struct tuple *tuple = memcs_index_tuple_new(index, row);
+	if (tuple == NULL)
+		return -1;
+	*result = tuple_bless(tuple);
+	return 0;
+}
+
+static struct iterator *
+memcs_index_create_iterator(struct index *base, enum iterator_type type,
+			    const char *key, uint32_t part_count,
+			    const char *pos)
+{
+	struct memcs_index *index = (struct memcs_index *)base;
+	if (memcs_canonicalize_lookup(base->def, &type, part_count) != 0)
+		return NULL;
+	struct memcs_iterator *it = xcalloc(1, sizeof(*it));
+	iterator_create(&it->base, base);
+	it->base.next = memcs_iterator_next;
+	it->base.position = memcs_iterator_position;
+	it->base.free = memcs_iterator_free;
+	it->type = type;
+	uint32_t key_size;
+	it->key = memcs_key_dup(key, part_count, &key_size);
+	it->part_count = part_count;
+	it->pk_part_count = index->data.key_def->part_count;
+	it->last_key = memcs_key_dup(pos, it->pk_part_count,
+				     &it->last_key_size);
+	it->last_key_capacity = it->last_key_size;
+	it->tree_it = memcs_tree_lookup(
+		&index->tree, type, it->key, part_count, it->last_key,
+		it->last_key != NULL ? it->pk_part_count : 0);
+	it->version = index->version;
+	return &it->base;
+}
+
+static int
+memcs_index_create_arrow_stream(struct index *base, uint32_t field_count,
+				const uint32_t *fields, const char *key,
+				uint32_t part_count,
+				const struct arrow_options *options,
+				struct ArrowArrayStream *stream)
+{
+	struct space *space = space_by_id(base->def->space_id);
+	assert(space != NULL);
+	/* The stream reads a private read view to tolerate writes. */
+	struct index_read_view *rv = memcs_index_create_read_view(base);
+	if (memcs_arrow_stream_create((struct memcs_index_read_view *)rv,
+				      true, space->def->fields, field_count,
+				      fields, key, part_count, options,
+				      stream) != 0) {
+		index_read_view_delete(rv);
+		return -1;
+	}
+	return 0;
+}
+
+static const struct index_vtab memcs_index_vtab = {
+	/* .destroy = */ memcs_index_destroy,
+	/* .commit_create = */ generic_index_commit_create,
+	/* .abort_create = */ generic_index_abort_create,
+	/* .commit_modify = */ generic_index_commit_modify,
+	/* .commit_drop = */ generic_index_commit_drop,
+	/* .update_def = */ generic_index_update_def,
+	/* .depends_on_pk = */ generic_index_depends_on_pk,
+	/* .def_change_requires_rebuild = */
+		memcs_index_def_change_requires_rebuild,
+	/* .size = */ memcs_index_size,
+	/* .bsize = */ memcs_index_bsize,
+	/* .quantile = */ generic_index_quantile,
+	/* .min = */ generic_index_min,
+	/* .max = */ generic_index_max,
+	/* .random = */ memcs_index_random,
+	/* .count = */ memcs_index_count,
+	/* .get = */ memcs_index_get,
+	/* .create_iterator = */ memcs_index_create_iterator,
+	/* .create_iterator_with_offset = */
+		generic_index_create_iterator_with_offset,
+	/* .create_arrow_stream = */ memcs_index_create_arrow_stream,
+	/* .create_read_view = */ memcs_index_create_read_view,
+	/* .info = */ generic_index_info,
+	/* .stat = */ generic_index_stat,
+	/* .compact = */ generic_index_compact,
+	/* .reset_stat = */ generic_index_reset_stat,
+};
+
+/** }}} Index */
+
+/** {{{ Space */
+
+/** Returns the primary key of a space or NULL (diag is set). */
+static struct memcs_index *
+memcs_space_pk(struct space *space)
+{
+	return (struct memcs_index *)index_find(space, 0);
+}
+
+static void
+memcs_space_destroy(struct space *space)
+{
+	free(space);
+}
+
+static size_t
+memcs_space_bsize(struct space *space)
+{
+	struct memcs_index *index = (struct memcs_index *)space_index(space, 0);
+	if (index == NULL)
+		return 0;
+	return index->data.block_count * index->block_size + index->dict_size;
+}
+
+static inline enum dup_replace_mode
+dup_replace_mode(uint16_t op)
+{
+	return op == IPROTO_INSERT ? DUP_INSERT : DUP_REPLACE_OR_INSERT;
+}
+
+static int
+memcs_space_execute_replace(struct space *space, struct txn *txn,
+			    struct request *request, struct tuple **result)
+{
+	struct memcs_index *index = memcs_space_pk(space);
+	if (index == NULL)
+		return -1;
+	struct tuple *new_tuple =
+		space->format->vtab.tuple_new(space->format, request->tuple,
+					      request->tuple_end);
+	if (new_tuple == NULL) {
+		error_set_space(diag_last_error(diag_get()), space->def);
+		return -1;
+	}
+	tuple_ref(new_tuple);
+	int rc = -1;
+	struct txn_stmt *stmt = txn_current_stmt(txn);
+	uint32_t bsize;
+	const char *data = tuple_data_range(new_tuple, &bsize);
+	uint32_t new_row, old_row;
+	if (memcs_index_replace(index, MEMCS_ROW_NONE, NULL, data,
+				data + bsize, dup_replace_mode(request->type),
+				&new_row, &old_row) != 0)
+		goto out;
+	memcs_undo_add(stmt, index, new_row, old_row);
+	struct tuple *old_tuple = NULL;
+	if (old_row != MEMCS_ROW_NONE) {
+		old_tuple = memcs_index_tuple_new(index, old_row);
+		if (old_tuple == NULL)
+			goto out;
+	}
+	txn_stmt_set_tuples(stmt, old_tuple, new_tuple);
+	*result = new_tuple;
+	rc = 0;
+out:
+	tuple_unref(new_tuple);
+	return rc;
+}
+
+/**
+ * Looks up a row by the key of a delete or update request. Returns
+ * MEMCS_ROW_NONE in @a row if not found.
+ */
+static int
+memcs_space_find_request_row(struct space *space, struct request *request,
+			     struct memcs_index **index, uint32_t *row)
+{
+	struct index *pk = index_find(space, request->index_id);
+	if (pk == NULL)
+		return -1;
+	const char *key = request->key;
+	uint32_t part_count = mp_decode_array(&key);
+	if (exact_key_validate(pk->def, key, part_count) != 0)
+		return -1;
+	*index = (struct memcs_index *)pk;
+	*row = memcs_index_find_key(*index, key, part_count);
+	return 0;
+}
+
+static int
+memcs_space_execute_delete(struct space *space, struct txn *txn,
+			   struct request *request, struct tuple **result)
+{
+	struct memcs_index *index;
+	uint32_t old_row;
+	if (memcs_space_find_request_row(space, request, &index,
+					 &old_row) != 0)
+		return -1;
+	*result = NULL;
+	if (old_row == MEMCS_ROW_NONE)
+		return 0;
+	struct tuple *old_tuple = memcs_index_tuple_new(index, old_row);
+	if (old_tuple == NULL)
+		return -1;
+	memcs_index_tree_delete(index, old_row);
+	struct txn_stmt *stmt = txn_current_stmt(txn);
+	memcs_undo_add(stmt, index, MEMCS_ROW_NONE, old_row);
+	txn_stmt_set_tuples(stmt, old_tuple, NULL);
+	*result = old_tuple;
+	return 0;
+}
+
+static int
+memcs_space_execute_update(struct space *space, struct txn *txn,
+			   struct request *request, struct tuple **result)
+{
+	struct memcs_index *index;
+	uint32_t old_row;
+	if (memcs_space_find_request_row(space, request, &index,
+					 &old_row) != 0)
+		return -1;
+	*result = NULL;
+	if (old_row == MEMCS_ROW_NONE)
+		return 0;
+	struct tuple *old_tuple = memcs_index_tuple_new(index, old_row);
+	if (old_tuple == NULL)
+		return -1;
+	tuple_ref(old_tuple);
+
+	/* Update the tuple; legacy, request ops are in request->tuple */
+	int rc = -1;
+	struct tuple *new_tuple = NULL;
+	uint32_t new_size = 0, bsize;
+	struct tuple_format *format = space->format;
+	const char *old_data = tuple_data_range(old_tuple, &bsize);
+	size_t region_svp = region_used(&fiber()->gc);
+	const char *new_data =
+		xrow_update_execute(request->tuple, request->tuple_end,
+				    old_data, old_data + bsize, format,
+				    &new_size, request->index_base, NULL);
+	if (new_data == NULL) {
+		error_set_index(diag_last_error(diag_get()), index->base.def);
+		goto out;
+	}
+	new_tuple = format->vtab.tuple_new(format, new_data,
+					   new_data + new_size);
+	region_truncate(&fiber()->gc, region_svp);
+	if (new_tuple == NULL) {
+		error_set_index(diag_last_error(diag_get()), index->base.def);
+		goto out;
+	}
+	tuple_ref(new_tuple);
+	const char *data = tuple_data_range(new_tuple, &bsize);
+	uint32_t new_row, replaced_row;
+	if (memcs_index_replace(index, old_row, old_tuple, data, data + bsize,
+				DUP_REPLACE, &new_row, &replaced_row) != 0)
+		goto out;
+	assert(replaced_row == old_row);
+	struct txn_stmt *stmt = txn_current_stmt(txn);
+	memcs_undo_add(stmt, index, new_row, replaced_row);
+	txn_stmt_set_tuples(stmt, old_tuple, new_tuple);
+	*result = new_tuple;
+	rc = 0;
+out:
+	region_truncate(&fiber()->gc, region_svp);
+	tuple_unref(old_tuple);
+	if (new_tuple != NULL)
+		tuple_unref(new_tuple);
+	return rc;
+}
+
+static int
+memcs_space_execute_upsert(struct space *space, struct txn *txn,
+			   struct request *request)
+{
+	/*
+	 * Check all tuple fields: we should produce an error on
+	 * malformed tuple even if upsert turns into an update.
+	 */
+	if (tuple_validate_raw(space->format, request->tuple)) {
+		error_set_space(diag_last_error(diag_get()), space->def);
+		return -1;
+	}
+	struct memcs_index *index = memcs_space_pk(space);
+	if (index == NULL)
+		return -1;
+	struct key_def *key_def = index->base.def->key_def;
+	size_t region_svp = region_used(&fiber()->gc);
+	/* Extract the primary key from tuple. */
+	const char *key = tuple_extract_key_raw(request->tuple,
+						request->tuple_end, key_def,
+						MULTIKEY_NONE, NULL);
+	if (key == NULL)
+		return -1;
+	/* Cut array header */
+	mp_decode_array(&key);
+	uint32_t old_row = memcs_index_find_key(index, key,
+						key_def->part_count);
+	region_truncate(&fiber()->gc, region_svp);
+
+	struct tuple_format *format = space->format;
+	struct tuple *old_tuple = NULL;
+	struct tuple *new_tuple;
+	if (old_row == MEMCS_ROW_NONE) {
+		/* See the comment in memtx_space_execute_upsert(). */
+		if (xrow_update_check_ops(request->ops, request->ops_end,
+					  format, request->index_base) != 0) {
+			error_set_space(diag_last_error(diag_get()),
+					space->def);
+			return -1;
+		}
+		new_tuple = format->vtab.tuple_new(format, request->tuple,
+						   request->tuple_end);
+		if (new_tuple == NULL)
+			return -1;
+		tuple_ref(new_tuple);
+	} else {
+		old_tuple = memcs_index_tuple_new(index, old_row);
+		if (old_tuple == NULL)
+			return -1;
+		tuple_ref(old_tuple);
+		uint32_t new_size = 0, bsize;
+		const char *old_data = tuple_data_range(old_tuple, &bsize);
+		/*
+		 * Update the tuple.
+		 * xrow_upsert_execute() fails on totally wrong
+		 * tuple ops, but ignores ops that not suitable
+		 * for the tuple.
+		 */
+		uint64_t column_mask = COLUMN_MASK_FULL;
+		const char *new_data =
+			xrow_upsert_execute(request->ops, request->ops_end,
+					    old_data, old_data + bsize,
+					    format, &new_size,
+					    request->index_base, false,
+					    &column_mask);
+		if (new_data == NULL) {
+			error_set_space(diag_last_error(diag_get()),
+					space->def);
+			tuple_unref(old_tuple);
+			return -1;
+		}
+		new_tuple = format->vtab.tuple_new(format, new_data,
+						   new_data + new_size);
+		region_truncate(&fiber()->gc, region_svp);
+		if (new_tuple == NULL) {
+			error_set_space(diag_last_error(diag_get()),
+					space->def);
+			tuple_unref(old_tuple);
+			return -1;
+		}
+		tuple_ref(new_tuple);
+		if (!key_update_can_be_skipped(key_def->column_mask,
+					       column_mask) &&
+		    tuple_compare(old_tuple, HINT_NONE, new_tuple,
+				  HINT_NONE, key_def) != 0) {
+			/* Primary key is changed: log error and do nothing. */
+			diag_set(ClientError, ER_CANT_UPDATE_PRIMARY_KEY,
+				 space_name(space), space_id(space),
+				 old_tuple, new_tuple, NULL);
+			diag_log();
+			tuple_unref(old_tuple);
+			tuple_unref(new_tuple);
+			return 0;
+		}
+	}
+	int rc = -1;
+	uint32_t bsize;
+	const char *data = tuple_data_range(new_tuple, &bsize);
+	uint32_t new_row, replaced_row;
+	if (memcs_index_replace(index, old_row, old_tuple, data, data + bsize,
+				DUP_REPLACE_OR_INSERT, &new_row,
+				&replaced_row) != 0)
+		goto out;
+	assert(replaced_row == old_row);
+	struct txn_stmt *stmt = txn_current_stmt(txn);
+	memcs_undo_add(stmt, index, new_row, replaced_row);
+	txn_stmt_set_tuples(stmt, old_tuple, new_tuple);
+	/* Return nothing: UPSERT does not return data. */
+	rc = 0;
+out:
+	if (old_tuple != NULL)
+		tuple_unref(old_tuple);
+	tuple_unref(new_tuple);
+	return rc;
+}
+
+static int
+memcs_space_execute_insert_arrow(struct space *space, struct txn *txn,
+				 struct ArrowArray *array,
+				 struct ArrowSchema *schema)
+{
+	struct memcs_index *index = memcs_space_pk(space);
+	if (index == NULL)
+		return -1;
+	struct region *gc = &fiber()->gc;
+	struct tuple_arrow_field_map map;
+	if (tuple_arrow_check(array, schema, space->format->dict,
+			      space_name(space), gc, &map) != 0)
+		return -1;
+	/*
+	 * Rows are stored without creating tuples. All of them are
+	 * rolled back with the statement on error.
+	 */
+	struct txn_stmt *stmt = txn_current_stmt(txn);
+	for (int64_t i = 0; i < array->length; i++) {
+		size_t gc_svp = region_used(gc);
+		const char *data_end;
+		const char *data = tuple_arrow_encode_row(array, schema, &map,
+							  i, gc, &data_end);
+		uint32_t new_row, old_row;
+		int rc = tuple_validate_raw(space->format, data);
+		if (rc != 0)
+			error_set_space(diag_last_error(diag_get()),
+					space->def);
+		else
+			rc = memcs_index_replace(index, MEMCS_ROW_NONE, NULL,
+						 data, data_end, DUP_INSERT,
+						 &new_row, &old_row);
+		region_truncate(gc, gc_svp);
+		if (rc != 0)
+			return -1;
+		memcs_undo_add(stmt, index, new_row, old_row);
+	}
+	return 0;
+}
+
+static int
+memcs_space_check_index_def(struct space *space, struct index_def *index_def)
+{
+	if (index_def->iid != 0) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+			 "secondary indexes");
+		return -1;
+	}
+	if (index_def->type != TREE) {
+		diag_set(ClientError, ER_INDEX_TYPE,
+			 index_def->name, space_name(space));
+		return -1;
+	}
+	struct key_def *key_def = index_def->key_def;
+	if (key_def->is_nullable) {
+		diag_set(ClientError, ER_NULLABLE_PRIMARY, space_name(space));
+		return -1;
+	}
+	if (index_def_check_field_types(index_def, space_name(space)) != 0)
+		return -1;
+	if (space->def->field_count == 0) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+			 "spaces without format");
+		return -1;
+	}
+	if (key_def->for_func_index) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+			 "functional index");
+		return -1;
+	}
+	if (key_def->is_multikey || key_def->has_json_paths) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+			 "JSON path index");
+		return -1;
+	}
+	if (index_def->opts.covered_field_count != 0) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+			 "covering index");
+		return -1;
+	}
+	if (index_def->opts.layout != NULL) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+			 "'layout' option");
+		return -1;
+	}
+	if (index_def->opts.aggregates != NULL) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+			 "'aggregates' option");
+		return -1;
+	}
+	for (uint32_t i = 0; i < key_def->part_count; i++) {
+		const struct key_part *part = &key_def->parts[i];
+		if (part->coll != NULL) {
+			diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+				 "collations");
+			return -1;
+		}
+		if (part->fieldno >= space->def->field_count ||
+		    part->type != space->def->fields[part->fieldno].type) {
+			diag_set(ClientError, ER_MODIFY_INDEX, index_def->name,
+				 space_name(space), "index part type must "
+				 "match the space field type");
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static struct index *
+memcs_space_create_index(struct space *space, struct index_def *index_def)
+{
+	assert(index_def->iid == 0);
+	assert(index_def->type == TREE);
+	struct memcs_engine *engine = (struct memcs_engine *)space->engine;
+	struct memcs_index *index = xcalloc(1, sizeof(*index));
+	struct memcs_data *data = &index->data;
+	data->column_count = space->def->field_count;
+	data->columns = xcalloc(data->column_count, sizeof(data->columns[0]));
+	data->dicts = xcalloc(data->column_count, sizeof(data->dicts[0]));
+	uint32_t offset = 0;
+	for (uint32_t i = 0; i < data->column_count; i++) {
+		struct memcs_column *column = &data->columns[i];
+		column->type = space->def->fields[i].type;
+		column->width = memcs_type_width(column->type);
+		assert(column->width > 0);
+		column->validity_offset = offset;
+		offset += MEMCS_BLOCK_ROW_COUNT / CHAR_BIT;
+		column->values_offset = offset;
+		offset += MEMCS_BLOCK_ROW_COUNT * column->width;
+		if (memcs_type_is_dict(column->type))
+			data->dicts[i].hash = mh_strnu32_new();
+	}
+	index->block_size = sizeof(struct memcs_block) + offset;
+	data->key_def = key_def_dup(index_def->key_def);
+	memcs_tree_create(&index->tree, data, &engine->extent_allocator, NULL);
+	index_create(&index->base, &engine->base, &memcs_index_vtab,
+		     index_def);
+	return &index->base;
+}
+
+static int
+memcs_space_check_format(struct space *space, struct tuple_format *format)
+{
+	struct memcs_index *index = (struct memcs_index *)space_index(space, 0);
+	if (index == NULL)
+		return 0;
+	struct memcs_tree *tree = &index->tree;
+	struct region *gc = &fiber()->gc;
+	struct memcs_tree_iterator it = memcs_tree_first(tree);
+	uint32_t *row;
+	while ((row = memcs_tree_iterator_get_elem(tree, &it)) != NULL) {
+		size_t gc_svp = region_used(gc);
+		uint32_t size;
+		const char *data = memcs_data_encode_row(&index->data, *row,
+							 &size);
+		int rc = tuple_validate_raw(format, data);
+		region_truncate(gc, gc_svp);
+		if (rc != 0)
+			return -1;
+		memcs_tree_iterator_next(tree, &it);
+	}
+	return 0;
+}
+
+static int
+memcs_space_build_index(struct space *src_space, struct index *new_index,
+			struct tuple_format *new_format,
+			bool check_unique_constraint)
+{
+	(void)check_unique_constraint;
+	assert(new_index->def->iid == 0);
+	struct memcs_index *src = (struct memcs_index *)space_index(src_space,
+								     0);
+	if (src == NULL)
+		return 0;
+	struct memcs_index *dst = (struct memcs_index *)new_index;
+	struct memcs_tree *tree = &src->tree;
+	struct region *gc = &fiber()->gc;
+	struct memcs_tree_iterator it = memcs_tree_first(tree);
+	uint32_t *row;
+	while ((row = memcs_tree_iterator_get_elem(tree, &it)) != NULL) {
+		size_t gc_svp = region_used(gc);
+		uint32_t size;
+		const char *data = memcs_data_encode_row(&src->data, *row,
+							 &size);
+		uint32_t new_row, old_row;
+		int rc = tuple_validate_raw(new_format, data);
+		if (rc == 0)
+			rc = memcs_index_replace(dst, MEMCS_ROW_NONE, NULL,
+						 data, data + size, DUP_INSERT,
+						 &new_row, &old_row);
+		region_truncate(gc, gc_svp);
+		if (rc != 0)
+			return -1;
+		memcs_tree_iterator_next(tree, &it);
+	}
+	return 0;
+}
+
+static int
+memcs_space_prepare_alter(struct space *old_space, struct space *new_space)
+{
+	/* The storage layout is fixed once the primary key is created. */
+	if (space_index(old_space, 0) == NULL)
+		return 0;
+	struct space_def *old_def = old_space->def;
+	struct space_def *new_def = new_space->def;
+	bool is_changed = old_def->field_count != new_def->field_count;
+	for (uint32_t i = 0; !is_changed && i < old_def->field_count; i++)
+		is_changed = old_def->fields[i].type != new_def->fields[i].type;
+	if (is_changed) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+			 "changing field count or types of an indexed space");
+		return -1;
+	}
+	return 0;
+}
+
+static const struct space_vtab memcs_space_vtab = {
+	/* .destroy = */ memcs_space_destroy,
+	/* .bsize = */ memcs_space_bsize,
+	/* .execute_replace = */ memcs_space_execute_replace,
+	/* .execute_delete = */ memcs_space_execute_delete,
+	/* .execute_update = */ memcs_space_execute_update,
+	/* .execute_upsert = */ memcs_space_execute_upsert,
+	/* .execute_insert_arrow = */ memcs_space_execute_insert_arrow,
+	/* .execute_delete_range = */ generic_space_execute_delete_range,
+	/* .ephemeral_replace = */ generic_space_ephemeral_replace,
+	/* .ephemeral_delete = */ generic_space_ephemeral_delete,
+	/* .ephemeral_rowid_next = */ generic_space_ephemeral_rowid_next,
+	/* .init_system_space = */ generic_init_system_space,
+	/* .init_ephemeral_space = */ generic_init_ephemeral_space,
+	/* .check_index_def = */ memcs_space_check_index_def,
+	/* .create_index = */ memcs_space_create_index,
+	/* .add_primary_key = */ generic_space_add_primary_key,
+	/* .drop_primary_key = */ generic_space_drop_primary_key,
+	/* .check_format = */ memcs_space_check_format,
+	/* .build_index = */ memcs_space_build_index,
+	/* .swap_index = */ generic_space_swap_index,
+	/* .prepare_alter = */ memcs_space_prepare_alter,
+	/* .finish_alter = */ generic_space_finish_alter,
+	/* .prepare_upgrade = */ generic_space_prepare_upgrade,
+	/* .invalidate = */ generic_space_invalidate,
+};
+
+/** }}} Space */
+
+/** {{{ Engine */
+
+static void
+memcs_engine_free(struct engine *base)
+{
+	struct memcs_engine *engine = (struct memcs_engine *)base;
+	matras_allocator_destroy(&engine->extent_allocator);
+	free(engine);
+}
+
+static struct space *
+memcs_engine_create_space(struct engine *engine, struct space_def *def,
+			  struct rlist *key_list)
+{
+	struct space *space = calloc(1, sizeof(*space));
+	if (space == NULL) {
+		diag_set(OutOfMemory, sizeof(*space),
+			 "malloc", "struct space");
+		return NULL;
+	}
+	/*
+	 * Tuples are only created to be returned to the user so they
+	 * are allocated on the runtime arena.
+	 */
+	int key_count = 0;
+	size_t region_svp = region_used(&fiber()->gc);
+	struct key_def **keys = index_def_to_key_def(key_list, &key_count);
+	struct tuple_format *format =
+		space_tuple_format_new(&tuple_format_runtime->vtab, NULL,
+				       keys, key_count, def);
+	region_truncate(&fiber()->gc, region_svp);
+	if (format == NULL) {
+		free(space);
+		return NULL;
+	}
+	tuple_format_ref(format);
+	if (space_create(space, engine, &memcs_space_vtab,
+			 def, key_list, format) != 0) {
+		tuple_format_unref(format);
+		free(space);
+		return NULL;
+	}
+	/* Format is now referenced by the space. */
+	tuple_format_unref(format);
+	return space;
+}
+
+static void
+memcs_engine_read_view_free(struct engine_read_view *rv)
+{
+	free(rv);
+}
+
+static const struct engine_read_view_vtab memcs_engine_read_view_vtab = {
+	.free = memcs_engine_read_view_free,
+};
+
+static struct engine_read_view *
+memcs_engine_create_read_view(struct engine *engine,
+			      const struct read_view_opts *opts)
+{
+	(void)engine;
+	(void)opts;
+	/* Index read views are self-contained. */
+	struct engine_read_view *rv = xmalloc(sizeof(*rv));
+	rv->vtab = &memcs_engine_read_view_vtab;
+	return rv;
+}
+
+static void
+memcs_engine_begin(struct engine *engine, struct txn *txn)
+{
+	(void)engine;
+	/* There's no MVCC: a transaction must not yield. */
+	txn_can_yield(txn, false);
+}
+
+/**
+ * Memcs spaces are checkpointed by memtx, but their changes aren't tracked
+ * by primary key, so the next memtx checkpoint must be written in full.
+ */
+static void
+memcs_engine_invalidate_checkpoint(void)
+{
+	struct engine *memtx = engine_by_name("memtx");
+	if (memtx != NULL)
+		memtx_engine_invalidate_dirty_set((struct memtx_engine *)memtx);
+}
+
+static void
+memcs_engine_commit(struct engine *engine, struct txn *txn)
+{
+	bool is_changed = false;
+	struct txn_stmt *stmt;
+	stailq_foreach_entry(stmt, &txn->stmts, next) {
+		if (stmt->engine != engine)
+			continue;
+		struct memcs_undo *undo = stmt->engine_savepoint;
+		if (undo == NULL)
+			continue;
+		is_changed = true;
+		/* Deleted rows are not visible anymore. */
+		for (uint32_t i = 0; i < undo->old_row_count; i++)
+			memcs_index_free_row(undo->index, undo->old_rows[i]);
+		undo->old_row_count = 0;
+	}
+	if (is_changed)
+		memcs_engine_invalidate_checkpoint();
+}
+
+static void
+memcs_engine_rollback_statement(struct engine *engine, struct txn *txn,
+				struct txn_stmt *stmt)
+{
+	(void)engine;
+	(void)txn;
+	struct memcs_undo *undo = stmt->engine_savepoint;
+	if (undo == NULL)
+		return;
+	if (stmt->space == NULL) {
+		/* The space was deleted. Nothing to rollback. */
+		return;
+	}
+	memcs_engine_invalidate_checkpoint();
+	struct memcs_index *index = undo->index;
+	for (uint32_t i = undo->new_row_count; i-- > 0; ) {
+		memcs_index_tree_delete(index, undo->new_rows[i]);
+		memcs_index_free_row(index, undo->new_rows[i]);
+	}
+	for (uint32_t i = undo->old_row_count; i-- > 0; ) {
+		uint32_t replaced;
+		memcs_index_tree_insert(index, undo->old_rows[i], &replaced);
+		assert(replaced == MEMCS_ROW_NONE);
+	}
+	undo->new_row_count = 0;
+	undo->old_row_count = 0;
+}
+
+static void
+memcs_engine_destroy_savepoint(void *engine_savepoint)
+{
+	struct memcs_undo *undo = engine_savepoint;
+	free(undo->new_rows);
+	free(undo->old_rows);
+	index_unref(&undo->index->base);
+	free(undo);
+}
+
+static void
+memcs_engine_memory_stat(struct engine *base, struct engine_memory_stat *stat)
+{
+	struct memcs_engine *engine = (struct memcs_engine *)base;
+	stat->data += engine->data_size;
+	stat->index += engine->index_size;
+}
+
+static int
+memcs_engine_check_space_def(struct space_def *def)
+{
+	for (uint32_t i = 0; i < def->field_count; i++) {
+		const struct field_def *field = &def->fields[i];
+		if (memcs_type_width(field->type) == 0) {
+			diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+				 tt_sprintf("field type '%s'",
+					    field_type_strs[field->type]));
+			return -1;
+		}
+		if (field->compression_opts.type != COMPRESSION_TYPE_NONE) {
+			diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+				 "compression");
+			return -1;
+		}
+		if (field->layout != NULL) {
+			diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+				 "'layout' option");
+			return -1;
+		}
+	}
+	if (def->opts.compression != SPACE_COMPRESSION_NONE) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Engine 'memcs'",
+			 "tuple compression");
+		return -1;
+	}
+	return 0;
+}
+
+static const struct engine_vtab memcs_engine_vtab = {
+	/* .free = */ memcs_engine_free,
+	/* .shutdown = */ generic_engine_shutdown,
+	/* .create_space = */ memcs_engine_create_space,
+	/* .create_read_view = */ memcs_engine_create_read_view,
+	/* .prepare_join = */ generic_engine_prepare_join,
+	/* .join = */ generic_engine_join,
+	/* .complete_join = */ generic_engine_complete_join,
+	/* .begin = */ memcs_engine_begin,
+	/* .begin_statement = */ generic_engine_begin_statement,
+	/* .prepare = */ generic_engine_prepare,
+	/* .commit = */ memcs_engine_commit,
+	/* .rollback_statement = */ memcs_engine_rollback_statement,
+	/* .rollback = */ generic_engine_rollback,
+	/* .destroy_savepoint = */ memcs_engine_destroy_savepoint,
+	/* .send_to_read_view = */ generic_engine_send_to_read_view,
+	/* .abort_with_conflict = */ generic_engine_abort_with_conflict,
+	/* .bootstrap = */ generic_engine_bootstrap,
+	/* .begin_initial_recovery = */ generic_engine_begin_initial_recovery,
+	/* .begin_final_recovery = */ generic_engine_begin_final_recovery,
+	/* .begin_hot_standby = */ generic_engine_begin_hot_standby,
+	/* .end_recovery = */ generic_engine_end_recovery,
+	/* .begin_checkpoint = */ generic_engine_begin_checkpoint,
+	/* .wait_checkpoint = */ generic_engine_wait_checkpoint,
+	/* .commit_checkpoint = */ generic_engine_commit_checkpoint,
+	/* .abort_checkpoint = */ generic_engine_abort_checkpoint,
+	/* .collect_garbage = */ generic_engine_collect_garbage,
+	/* .backup = */ generic_engine_backup,
+	/* .memory_stat = */ memcs_engine_memory_stat,
+	/* .reset_stat = */ generic_engine_reset_stat,
+	/* .check_space_def = */ memcs_engine_check_space_def,
+};
+
+static void *
+memcs_tree_extent_alloc(struct matras_allocator *allocator)
+{
+	struct memcs_engine *engine = container_of(allocator,
+						   struct memcs_engine,
+						   extent_allocator);
+	engine->index_size += MEMCS_TREE_EXTENT_SIZE;
+	return xmalloc(MEMCS_TREE_EXTENT_SIZE);
+}
+
+static void
+memcs_tree_extent_free(struct matras_allocator *allocator, void *extent)
+{
+	struct memcs_engine *engine = container_of(allocator,
+						   struct memcs_engine,
+						   extent_allocator);
+	engine->index_size -= MEMCS_TREE_EXTENT_SIZE;
+	free(extent);
+}
+
+void
+memcs_engine_register(void)
+{
+	struct memcs_engine *engine = xcalloc(1, sizeof(*engine));
+	matras_allocator_create(&engine->extent_allocator,
+				MEMCS_TREE_EXTENT_SIZE,
+				memcs_tree_extent_alloc,
+				memcs_tree_extent_free);
+	engine->base.vtab = &memcs_engine_vtab;
+	engine->base.name = "memcs";
+	/*
+	 * Checkpoints and initial join are done by memtx using
+	 * index read views.
+	 */
+	engine->base.flags = ENGINE_SUPPORTS_READ_VIEW |
+			     ENGINE_CHECKPOINT_BY_MEMTX |
+			     ENGINE_JOIN_BY_MEMTX;
+	engine_register(&engine->base);
+}
+
+/** }}} Engine */
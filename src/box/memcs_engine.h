@@ -15,8 +15,12 @@
 extern "C" {
 #endif /* defined(__cplusplus) */
 
-static inline void
-memcs_engine_register(void) {}
+/**
+ * Registers the memcs engine, an in-memory engine storing space fields
+ * in typed columns.
+ */
+void
+memcs_engine_register(void);
 
 #if defined(__cplusplus)
 } /* extern "C" */
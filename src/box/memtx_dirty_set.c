@@ -0,0 +1,124 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memtx_dirty_set.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "assoc.h"
+#include "trivia/util.h"
+
+/** Dirty key lookup key. */
+struct memtx_dirty_key_ref {
+	/** Hash of the key data. */
+	uint32_t hash;
+	/** Size of the key data. */
+	uint32_t size;
+	/** MsgPack array of the key parts. */
+	const char *data;
+};
+
+#define mh_name _memtx_dirty_keys
+#define mh_key_t const struct memtx_dirty_key_ref *
+#define mh_node_t struct memtx_dirty_key *
+#define mh_arg_t void *
+#define mh_hash(a, arg) ((*(a))->hash)
+#define mh_hash_key(a, arg) ((a)->hash)
+#define mh_cmp(a, b, arg) ((*(a))->size != (*(b))->size || \
+			   memcmp((*(a))->data, (*(b))->data, \
+				  (*(a))->size) != 0)
+#define mh_cmp_key(a, b, arg) ((a)->size != (*(b))->size || \
+			       memcmp((a)->data, (*(b))->data, (a)->size) != 0)
+#define MH_SOURCE 1
+#include "salad/mhash.h"
+
+void
+memtx_dirty_set_create(struct memtx_dirty_set *set)
+{
+	set->spaces = mh_i32ptr_new();
+	set->key_count = 0;
+	set->mem_used = 0;
+}
+
+/** Frees a dirty space with all its keys. */
+static void
+memtx_dirty_space_delete(struct memtx_dirty_space *space)
+{
+	mh_int_t i;
+	mh_foreach(space->keys, i)
+		free(*mh_memtx_dirty_keys_node(space->keys, i));
+	mh_memtx_dirty_keys_delete(space->keys);
+	free(space);
+}
+
+void
+memtx_dirty_set_destroy(struct memtx_dirty_set *set)
+{
+	mh_int_t i;
+	mh_foreach(set->spaces, i)
+		memtx_dirty_space_delete(mh_i32ptr_node(set->spaces, i)->val);
+	mh_i32ptr_delete(set->spaces);
+}
+
+struct memtx_dirty_space *
+memtx_dirty_set_space(struct memtx_dirty_set *set, uint32_t space_id)
+{
+	mh_int_t i = mh_i32ptr_find(set->spaces, space_id, NULL);
+	if (i == mh_end(set->spaces))
+		return NULL;
+	return mh_i32ptr_node(set->spaces, i)->val;
+}
+
+void
+memtx_dirty_set_add(struct memtx_dirty_set *set, uint32_t space_id,
+		    const char *key, uint32_t size)
+{
+	struct memtx_dirty_space *space = memtx_dirty_set_space(set, space_id);
+	if (space == NULL) {
+		space = xmalloc(sizeof(*space));
+		space->id = space_id;
+		space->keys = mh_memtx_dirty_keys_new();
+		struct mh_i32ptr_node_t node = {space_id, space};
+		mh_i32ptr_put(set->spaces, &node, NULL, NULL);
+	}
+	struct memtx_dirty_key_ref ref = {
+		.hash = mh_strn_hash(key, size),
+		.size = size,
+		.data = key,
+	};
+	if (mh_memtx_dirty_keys_find(space->keys, &ref, NULL) !=
+	    mh_end(space->keys))
+		return;
+	struct memtx_dirty_key *dirty = xmalloc(sizeof(*dirty) + size);
+	dirty->hash = ref.hash;
+	dirty->size = size;
+	memcpy(dirty->data, key, size);
+	const struct memtx_dirty_key *node = dirty;
+	mh_memtx_dirty_keys_put(space->keys, &node, NULL, NULL);
+	set->key_count++;
+	set->mem_used += sizeof(*dirty) + size;
+}
+
+void
+memtx_dirty_space_iterator_create(struct memtx_dirty_space_iterator *it,
+				  struct memtx_dirty_space *space)
+{
+	it->space = space;
+	it->pos = mh_first(space->keys);
+}
+
+const struct memtx_dirty_key *
+memtx_dirty_space_iterator_next(struct memtx_dirty_space_iterator *it)
+{
+	struct mh_memtx_dirty_keys_t *keys = it->space->keys;
+	if (it->pos >= mh_end(keys))
+		return NULL;
+	const struct memtx_dirty_key *key =
+		*mh_memtx_dirty_keys_node(keys, it->pos);
+	it->pos = mh_next(keys, it->pos);
+	return key;
+}
@@ -0,0 +1,100 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct mh_i32ptr_t;
+struct mh_memtx_dirty_keys_t;
+
+/** Primary key of a tuple changed since the last checkpoint. */
+struct memtx_dirty_key {
+	/** Hash of the key data. */
+	uint32_t hash;
+	/** Size of the key data. */
+	uint32_t size;
+	/** MsgPack array of the key parts. */
+	char data[0];
+};
+
+/** Primary keys of a space changed since the last checkpoint. */
+struct memtx_dirty_space {
+	/** Space ID. */
+	uint32_t id;
+	/** Set of struct memtx_dirty_key. */
+	struct mh_memtx_dirty_keys_t *keys;
+};
+
+/**
+ * Set of primary keys changed since the last checkpoint, grouped by space.
+ * It's used for writing an incremental (delta) checkpoint, which only
+ * contains the current state of the keys changed since the previous one.
+ *
+ * Keys are compared byte-wise so the same key may be stored more than once
+ * if it was encoded differently by clients. That's fine: all copies of a
+ * key are looked up in the same read view and produce identical rows.
+ *
+ * The set may only be modified from the tx thread, but it may be read
+ * from another thread once it has been detached from the engine.
+ */
+struct memtx_dirty_set {
+	/** Space ID -> struct memtx_dirty_space. */
+	struct mh_i32ptr_t *spaces;
+	/** Number of keys in the set. */
+	size_t key_count;
+	/** Memory used by the keys. */
+	size_t mem_used;
+};
+
+/** Iterator over the keys of a dirty space. */
+struct memtx_dirty_space_iterator {
+	/** Iterated space. */
+	struct memtx_dirty_space *space;
+	/** Current position in the key set. */
+	uint32_t pos;
+};
+
+/** Initializes an empty dirty key set. */
+void
+memtx_dirty_set_create(struct memtx_dirty_set *set);
+
+/** Frees all the keys and the set itself. */
+void
+memtx_dirty_set_destroy(struct memtx_dirty_set *set);
+
+/**
+ * Adds a primary key to the set. The key is copied. Never fails.
+ *
+ * @param set dirty key set
+ * @param space_id ID of the space the key belongs to
+ * @param key MsgPack array of the key parts
+ * @param size size of the key data
+ */
+void
+memtx_dirty_set_add(struct memtx_dirty_set *set, uint32_t space_id,
+		    const char *key, uint32_t size);
+
+/** Returns the changed keys of a space or NULL if there's none. */
+struct memtx_dirty_space *
+memtx_dirty_set_space(struct memtx_dirty_set *set, uint32_t space_id);
+
+/** Positions an iterator before the first key of a dirty space. */
+void
+memtx_dirty_space_iterator_create(struct memtx_dirty_space_iterator *it,
+				  struct memtx_dirty_space *space);
+
+/** Returns the next key of a dirty space or NULL at the end. */
+const struct memtx_dirty_key *
+memtx_dirty_space_iterator_next(struct memtx_dirty_space_iterator *it);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
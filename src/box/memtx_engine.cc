@@ -78,6 +78,11 @@ enum {
 	SLAB_SIZE = 16 * 1024 * 1024,
 	MIN_MEMORY_QUOTA = SLAB_SIZE * 4,
 	MAX_TUPLE_SIZE = 1 * 1024 * 1024,
+	/**
+	 * The next checkpoint is written in full if the keys changed since
+	 * the last one take more than 1/16 of the memtx memory.
+	 */
+	MEMTX_DIRTY_SET_MEMORY_RATIO = 16,
 };
 
 template <class ALLOC>
@@ -333,6 +338,7 @@ memtx_engine_shutdown(struct engine *engine)
 	fiber_cancel(memtx->gc_fiber);
 	fiber_join(memtx->gc_fiber);
 	memtx->gc_fiber = NULL;
+	memtx_tuple_compression_shutdown();
 }
 
 static void
@@ -370,7 +376,10 @@ memtx_engine_free(struct engine *engine)
 	tuple_arena_destroy(&memtx->arena);
 
 	xdir_destroy(&memtx->snap_dir);
+	xdir_destroy(&memtx->delta_dir);
+	memtx_dirty_set_destroy(&memtx->dirty_set);
 	tuple_format_unref(memtx->func_key_format);
+	memtx_tuple_compression_free();
 	free(memtx);
 }
 
@@ -385,13 +394,42 @@ memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 				  struct xlog_entry *entry,
 				  bool recovering_system_spaces);
 
+/**
+ * Returns the vclock of the full snapshot the checkpoint with the given
+ * signature is based on, i.e. the last snapshot not newer than it, or NULL
+ * if there's no such snapshot.
+ */
+static const struct vclock *
+memtx_engine_snap_base(struct memtx_engine *memtx, int64_t signature)
+{
+	const struct vclock *base = NULL;
+	struct vclock *snap_vclock;
+	vclockset_foreach(&memtx->snap_dir.index, snap_vclock) {
+		if (vclock_sum(snap_vclock) > signature)
+			break;
+		base = snap_vclock;
+	}
+	return base;
+}
+
 int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 			      const struct vclock *vclock)
 {
 	/* Process existing snapshot */
 	say_info("recovery start");
+	memtx->recovery.checkpoint_signature = vclock_sum(vclock);
+	/*
+	 * The checkpoint may be a delta snapshot. If so, load the full
+	 * snapshot it's based on first, the deltas are applied later,
+	 * see memtx_engine_recover_deltas().
+	 */
+	const struct vclock *base = memtx_engine_snap_base(
+		memtx, memtx->recovery.checkpoint_signature);
+	if (base != NULL)
+		vclock = base;
 	int64_t signature = vclock_sum(vclock);
+	memtx->recovery.snap_signature = signature;
 	const char *filename = xdir_format_filename(&memtx->snap_dir,
 						    signature);
 
@@ -619,6 +657,191 @@ memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 	return -1;
 }
 
+/**
+ * Journal used for applying delta snapshot rows. The rows are already
+ * persisted so there's nothing to write.
+ */
+static int
+memtx_delta_journal_write(struct journal *base, struct journal_entry *entry)
+{
+	(void)base;
+	entry->res = 0;
+	journal_async_complete(entry);
+	return 0;
+}
+
+/**
+ * Applies an xrow from a delta snapshot. Unlike full snapshot rows, these
+ * may be replaces or deletes of tuples loaded from the previous checkpoint.
+ *
+ * @retval -1 error, diagnostic set
+ * @retval 0 success
+ */
+static int
+memtx_engine_recover_delta_row(struct memtx_engine *memtx,
+			       struct xlog_entry *entry)
+{
+	uint32_t type = entry->header.type;
+	if (type == IPROTO_RAFT || type == IPROTO_RAFT_PROMOTE)
+		return memtx_engine_recover_snapshot_row(memtx, entry, false);
+	if (type != IPROTO_REPLACE && type != IPROTO_DELETE) {
+		diag_set(ClientError, ER_UNKNOWN_REQUEST_TYPE,
+			 (uint32_t)type);
+		return -1;
+	}
+	RegionGuard region_guard(&fiber()->gc);
+	struct request *request = &entry->dml;
+	struct space *space = space_cache_find(request->space_id);
+	if (space == NULL)
+		goto log_request;
+	if ((space->engine->flags & ENGINE_CHECKPOINT_BY_MEMTX) == 0) {
+		diag_set(ClientError, ER_ALIEN_ENGINE, space->engine->name);
+		goto log_request;
+	}
+	struct tuple *unused;
+	struct txn *txn;
+	txn = txn_begin();
+	if (txn == NULL)
+		goto log_request;
+	if (txn_begin_stmt(txn, space, request->type) != 0)
+		goto rollback;
+	if (space_execute_dml(space, txn, request, &unused) != 0)
+		goto rollback_stmt;
+	if (txn_commit_stmt(txn, request) != 0)
+		goto rollback;
+	txn_set_flags(txn, TXN_FORCE_ASYNC);
+	return txn_commit(txn);
+rollback_stmt:
+	txn_rollback_stmt(txn);
+rollback:
+	txn_abort(txn);
+log_request:
+	say_error("error at request: %s", request_str(request));
+	return -1;
+}
+
+/** Applies a delta snapshot on top of the recovered data. */
+static int
+memtx_engine_recover_delta(struct memtx_engine *memtx,
+			   const struct vclock *vclock)
+{
+	int64_t signature = vclock_sum(vclock);
+	const char *filename = xdir_format_filename(&memtx->delta_dir,
+						    signature);
+	say_info("recovering from `%s'", filename);
+	struct xlog_reader *reader = xlog_reader_new(filename);
+	if (reader == NULL)
+		return -1;
+
+	int rc = 0;
+	uint64_t row_count = 0;
+	bool eof_marker = false;
+	while (true) {
+		struct xlog_entry *entry;
+		enum xlog_reader_result result =
+					xlog_reader_next(reader, &entry);
+		if (result == XLOG_READER_READ_ERROR) {
+			struct error *e = diag_last_error(diag_get());
+			if (memtx->force_recovery &&
+			    e->type == &type_XlogError) {
+				diag_log();
+				continue;
+			}
+			rc = -1;
+			break;
+		}
+		if (result == XLOG_READER_EOF)
+			break;
+		if (result == XLOG_READER_EOF_MARKER) {
+			eof_marker = true;
+			break;
+		}
+		if (result == XLOG_READER_OK) {
+			entry->header.lsn = signature;
+			rc = memtx_engine_recover_delta_row(memtx, entry);
+		} else {
+			rc = -1;
+		}
+		if (rc < 0) {
+			if (!memtx->force_recovery)
+				break;
+			rc = 0;
+			say_error("can't apply row: ");
+			diag_log();
+		}
+		++row_count;
+		if (row_count % 100000 == 0) {
+			say_info_ratelimited("%.1fM rows processed",
+					     row_count / 1e6);
+			fiber_yield_timeout(0);
+		}
+	}
+	xlog_reader_delete(reader);
+	if (rc < 0)
+		return -1;
+
+	if (!eof_marker) {
+		const char *filename = xdir_format_filename(&memtx->delta_dir,
+							    signature);
+		if (!memtx->force_recovery)
+			panic("snapshot `%s' has no EOF marker", filename);
+		else
+			say_error("snapshot `%s' has no EOF marker", filename);
+	}
+	return 0;
+}
+
+/**
+ * Applies the delta snapshots written after the recovered full snapshot
+ * up to the recovered checkpoint. Must be called once the memtx spaces are
+ * ready to execute requests.
+ */
+static int
+memtx_engine_recover_deltas(struct memtx_engine *memtx)
+{
+	int64_t snap_signature = memtx->recovery.snap_signature;
+	int64_t checkpoint_signature = memtx->recovery.checkpoint_signature;
+	memtx->recovery.checkpoint_signature = -1;
+	if (checkpoint_signature < 0)
+		return 0;
+	int chain = 0;
+	if (checkpoint_signature > snap_signature) {
+		/*
+		 * The recovery journal would advance the instance vclock
+		 * past the rows' fake LSNs, so use a journal that merely
+		 * completes the transactions.
+		 */
+		struct journal *journal = current_journal;
+		struct journal delta_journal;
+		journal_create(&delta_journal, memtx_delta_journal_write,
+			       NULL, NULL, NULL);
+		journal_set(&delta_journal);
+		int rc = 0;
+		struct vclock *vclock;
+		vclockset_foreach(&memtx->delta_dir.index, vclock) {
+			int64_t signature = vclock_sum(vclock);
+			if (signature <= snap_signature)
+				continue;
+			if (signature > checkpoint_signature)
+				break;
+			if (memtx_engine_recover_delta(memtx, vclock) != 0) {
+				rc = -1;
+				break;
+			}
+			chain++;
+		}
+		journal_set(journal);
+		if (rc != 0)
+			return -1;
+	}
+	/* Changes replayed from WAL go to the next delta. */
+	memtx->snap_delta_chain = chain;
+	memtx_dirty_set_destroy(&memtx->dirty_set);
+	memtx_dirty_set_create(&memtx->dirty_set);
+	memtx->dirty_set_is_complete = memtx->snap_delta_count > 0;
+	return 0;
+}
+
 /** Called at start to tell memtx to recover to a given LSN. */
 static int
 memtx_engine_begin_initial_recovery(struct engine *engine,
@@ -647,7 +870,7 @@ memtx_engine_begin_final_recovery(struct engine *engine)
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
 	if (memtx->state == MEMTX_OK) {
 		assert(memtx->recovery.sort_data_reader == NULL);
-		return 0;
+		return memtx_engine_recover_deltas(memtx);
 	}
 
 	/* Build PK and possibly SKs of the last space. */
@@ -684,7 +907,7 @@ memtx_engine_begin_final_recovery(struct engine *engine)
 		memtx_sort_data_reader_delete(memtx->recovery.sort_data_reader);
 		memtx->recovery.sort_data_reader = NULL;
 	}
-	return 0;
+	return memtx_engine_recover_deltas(memtx);
 }
 
 static int
@@ -726,6 +949,7 @@ memtx_engine_end_recovery(struct engine *engine)
 
 	/* Also removes *.sortdata.inprogress files. */
 	xdir_remove_temporary_files(&memtx->snap_dir);
+	xdir_remove_temporary_files(&memtx->delta_dir);
 
 	/* Complete space initialization. */
 	int rc = space_foreach(space_on_final_recovery_complete, NULL);
@@ -810,17 +1034,89 @@ memtx_engine_begin(struct engine *engine, struct txn *txn)
 		txn_can_yield(txn, false);
 }
 
+void
+memtx_engine_invalidate_dirty_set(struct memtx_engine *memtx)
+{
+	if (!memtx->dirty_set_is_complete)
+		return;
+	memtx_dirty_set_destroy(&memtx->dirty_set);
+	memtx_dirty_set_create(&memtx->dirty_set);
+	memtx->dirty_set_is_complete = false;
+}
+
+/** Adds the primary key of a tuple to the dirty key set. */
+static void
+memtx_engine_track_dirty_tuple(struct memtx_engine *memtx,
+			       struct space *space, struct tuple *tuple)
+{
+	struct key_def *key_def = space->index[0]->def->key_def;
+	RegionGuard region_guard(&fiber()->gc);
+	uint32_t size;
+	const char *key = tuple_extract_key(tuple, key_def, MULTIKEY_NONE,
+					    &size);
+	if (key == NULL) {
+		/* Can only fail on OOM. Write the next checkpoint in full. */
+		diag_clear(diag_get());
+		memtx_engine_invalidate_dirty_set(memtx);
+		return;
+	}
+	memtx_dirty_set_add(&memtx->dirty_set, space->def->id, key, size);
+}
+
+/**
+ * Remembers the primary keys changed by a statement so that the next
+ * checkpoint may be written as a delta. Changes that can't be replayed
+ * by primary key (DDL) make the next checkpoint a full one.
+ */
+static void
+memtx_engine_track_dirty_stmt(struct memtx_engine *memtx, struct space *space,
+			      struct memtx_stmt_rollback_info *undo)
+{
+	if (!memtx->dirty_set_is_complete || space_is_data_temporary(space))
+		return;
+	uint32_t space_id = space->def->id;
+	if ((space_id_is_system(space_id) &&
+	     space_id != BOX_SEQUENCE_DATA_ID &&
+	     space_id != BOX_GC_CONSUMERS_ID) || space->index_count == 0) {
+		memtx_engine_invalidate_dirty_set(memtx);
+		return;
+	}
+	struct tuple *tuple;
+	memtx_tuple_list_foreach(undo->old_tuples, tuple, {
+		memtx_engine_track_dirty_tuple(memtx, space, tuple);
+	});
+	if (undo->new_tuple != NULL)
+		memtx_engine_track_dirty_tuple(memtx, space, undo->new_tuple);
+	memtx_tuple_list_foreach(undo->new_tuples, tuple, {
+		memtx_engine_track_dirty_tuple(memtx, space, tuple);
+	});
+	if (memtx->dirty_set.mem_used >
+	    quota_total(&memtx->quota) / MEMTX_DIRTY_SET_MEMORY_RATIO)
+		memtx_engine_invalidate_dirty_set(memtx);
+}
+
 static int
 memtx_engine_prepare(struct engine *engine, struct txn *txn)
 {
-	if (memtx_tx_manager_use_mvcc_engine) {
-		struct txn_stmt *stmt;
-		stailq_foreach_entry(stmt, &txn->stmts, next) {
-			if (stmt->engine != engine)
-				continue;
+	struct memtx_engine *memtx = (struct memtx_engine *)engine;
+	struct txn_stmt *stmt;
+	stailq_foreach_entry(stmt, &txn->stmts, next) {
+		if (stmt->engine != engine)
+			continue;
+		if (memtx_tx_manager_use_mvcc_engine) {
 			assert(stmt->space->engine == engine);
 			memtx_tx_history_prepare_stmt(stmt);
 		}
+		/*
+		 * Track the change before it's written to the journal
+		 * rather than on commit: a checkpoint read view taken in
+		 * between sees the change, and the checkpoint vclock
+		 * includes it, so the key must go to that checkpoint.
+		 */
+		struct memtx_stmt_rollback_info *undo =
+			(typeof(undo))stmt->engine_savepoint;
+		if (undo != NULL)
+			memtx_engine_track_dirty_stmt(memtx, stmt->space, undo);
 	}
 	return 0;
 }
@@ -854,7 +1150,7 @@ static void
 memtx_engine_rollback_statement(struct engine *engine, struct txn *txn,
 				struct txn_stmt *stmt)
 {
-	(void)engine;
+	struct memtx_engine *memtx = (struct memtx_engine *)engine;
 	(void)txn;
 	/* Only roll back the changes if they were made. */
 	if (stmt->engine_savepoint == NULL)
@@ -864,7 +1160,8 @@ memtx_engine_rollback_statement(struct engine *engine, struct txn *txn,
 	struct memtx_tuple_list *old_tuples = undo->old_tuples;
 	struct tuple *new_tuple = undo->new_tuple;
 	/* The savepoint is only set if anything has changed. */
-	assert(old_tuples != NULL || new_tuple != NULL);
+	assert(old_tuples != NULL || new_tuple != NULL ||
+	       undo->new_tuples != NULL);
 	/*
 	 * Can only have more than one old tuple if no inserts were made
 	 * (that is, the op is delete_range, that only sets old_tuples).
@@ -877,19 +1174,35 @@ memtx_engine_rollback_statement(struct engine *engine, struct txn *txn,
 		/* The space was deleted. Nothing to rollback. */
 		return;
 	}
+	/*
+	 * The change may have been seen by a checkpoint read view, so the
+	 * key must be written to the next delta checkpoint, too.
+	 */
+	memtx_engine_track_dirty_stmt(memtx, space, undo);
 	struct memtx_space *memtx_space = (struct memtx_space *)space;
 	uint32_t index_count;
 
-	if (space->upgrade != NULL && new_tuple != NULL)
-		memtx_space_upgrade_untrack_tuple(space->upgrade, new_tuple);
+	struct tuple *inserted;
+	if (space->upgrade != NULL) {
+		if (new_tuple != NULL)
+			memtx_space_upgrade_untrack_tuple(space->upgrade,
+							  new_tuple);
+		memtx_tuple_list_foreach(undo->new_tuples, inserted, {
+			memtx_space_upgrade_untrack_tuple(space->upgrade,
+							  inserted);
+		});
+	}
 
 	/*
 	 * With MVCC, we do not physically rollback the state of the indexes.
 	 * Instead, we mark the `new_tuple`, if any, as deleted and everything
 	 * in the `old_tuples` list, if any, as visible again.
 	 */
-	if (memtx_tx_manager_use_mvcc_engine)
+	if (memtx_tx_manager_use_mvcc_engine) {
+		/* Multi-row inserts are not supported with MVCC. */
+		assert(undo->new_tuples == NULL);
 		return memtx_tx_history_rollback_stmt(stmt);
+	}
 
 	if (memtx_space->replace == memtx_space_replace_all_keys)
 		index_count = space->index_count;
@@ -902,6 +1215,18 @@ memtx_engine_rollback_statement(struct engine *engine, struct txn *txn,
 	for (uint32_t i = 0; i < index_count; i++) {
 		struct tuple *unused;
 		struct index *index = space->index[i];
+		/* Tuples are listed in reverse order of insertion. */
+		memtx_tuple_list_foreach(undo->new_tuples, inserted, {
+			if (memtx_index_replace(index, inserted, NULL,
+						DUP_INSERT, &unused,
+						&unused) != 0) {
+				diag_log();
+				unreachable();
+				panic("failed to rollback change");
+			}
+		});
+		if (undo->new_tuples != NULL)
+			continue;
 		memtx_tuple_list_foreach_or_null(old_tuples, old_tuple, {
 			/* Rollback must not fail. */
 			if (memtx_index_replace(index, new_tuple,
@@ -922,6 +1247,10 @@ memtx_engine_rollback_statement(struct engine *engine, struct txn *txn,
 		memtx_space_update_tuple_stat(space, new_tuple, NULL);
 		tuple_unref(new_tuple);
 	}
+	memtx_tuple_list_foreach(undo->new_tuples, inserted, {
+		memtx_space_update_tuple_stat(space, inserted, NULL);
+		tuple_unref(inserted);
+	});
 }
 
 static void
@@ -1029,16 +1358,22 @@ checkpoint_write_row(struct xlog *l, struct xrow_header *row)
 
 }
 
+/**
+ * Writes a DML request to the snapshot. The data is a tuple for INSERT
+ * and REPLACE and a key for DELETE.
+ */
 static int
-checkpoint_write_tuple(struct xlog *l, uint32_t space_id, uint32_t group_id,
-		       const char *data, uint32_t size)
+checkpoint_write_request(struct xlog *l, uint16_t type, uint32_t space_id,
+			 uint32_t group_id, const char *data, uint32_t size)
 {
 	struct request_replace_body body;
 	request_replace_body_create(&body, space_id);
+	if (type == IPROTO_DELETE)
+		body.k_tuple = IPROTO_KEY;
 
 	struct xrow_header row;
 	memset(&row, 0, sizeof(struct xrow_header));
-	row.type = IPROTO_INSERT;
+	row.type = type;
 	row.group_id = group_id;
 
 	row.bodycnt = 2;
@@ -1051,6 +1386,14 @@ checkpoint_write_tuple(struct xlog *l, uint32_t space_id, uint32_t group_id,
 	return checkpoint_write_row(l, &row);
 }
 
+static int
+checkpoint_write_tuple(struct xlog *l, uint32_t space_id, uint32_t group_id,
+		       const char *data, uint32_t size)
+{
+	return checkpoint_write_request(l, IPROTO_INSERT, space_id, group_id,
+					data, size);
+}
+
 struct checkpoint {
 	/** Database read view written to the snapshot file. */
 	struct read_view *rv;
@@ -1074,6 +1417,16 @@ struct checkpoint {
 	 * checkpoint already exists.
 	 */
 	bool touch;
+	/**
+	 * Write a delta snapshot containing only the tuples changed since
+	 * the previous checkpoint instead of a full one.
+	 */
+	bool is_delta;
+	/**
+	 * Primary keys changed since the previous checkpoint. Empty unless
+	 * it's a delta snapshot.
+	 */
+	struct memtx_dirty_set dirty_set;
 };
 
 /** Space filter for checkpoint. */
@@ -1177,8 +1530,24 @@ checkpoint_dump_sort_data(
 							 writer, have_more);
 }
 
+/** Sets the type of the snapshot file written by a checkpoint. */
+static void
+checkpoint_set_is_delta(struct checkpoint *ckpt, struct memtx_engine *memtx,
+			bool is_delta)
+{
+	struct xlog_opts opts = xlog_opts_default;
+	opts.rate_limit = memtx->snap_io_rate_limit;
+	opts.compress_threads = memtx->snap_compress_threads;
+	opts.sync_interval = SNAP_SYNC_INTERVAL;
+	opts.free_cache = true;
+	xdir_create(&ckpt->dir, memtx->snap_dir.dirname,
+		    is_delta ? "DELTA" : "SNAP", &INSTANCE_UUID, &opts);
+	ckpt->is_delta = is_delta;
+}
+
 static struct checkpoint *
-checkpoint_new(struct memtx_engine *memtx, const struct box_checkpoint *box)
+checkpoint_new(struct memtx_engine *memtx, const struct box_checkpoint *box,
+	       bool is_delta)
 {
 	struct checkpoint *ckpt = (struct checkpoint *)xmalloc(sizeof(*ckpt));
 	struct read_view_opts rv_opts;
@@ -1186,24 +1555,22 @@ checkpoint_new(struct memtx_engine *memtx, const struct box_checkpoint *box)
 	rv_opts.name = "checkpoint";
 	rv_opts.is_system = true;
 	rv_opts.filter_space = checkpoint_space_filter;
-	rv_opts.filter_index = checkpoint_index_filter;
+	/* Delta snapshots don't have sort data. */
+	rv_opts.filter_index = is_delta ? primary_index_filter :
+			       checkpoint_index_filter;
 	ckpt->rv = read_view_new(&rv_opts);
 	if (ckpt->rv == NULL) {
 		free(ckpt);
 		return NULL;
 	}
-	struct xlog_opts opts = xlog_opts_default;
-	opts.rate_limit = memtx->snap_io_rate_limit;
-	opts.sync_interval = SNAP_SYNC_INTERVAL;
-	opts.free_cache = true;
-	xdir_create(&ckpt->dir, memtx->snap_dir.dirname,
-		    "SNAP", &INSTANCE_UUID, &opts);
+	checkpoint_set_is_delta(ckpt, memtx, is_delta);
 	xlog_clear(&ckpt->snap);
 	vclock_create(&ckpt->vclock);
-	ckpt->sort_data_writer = memtx->use_sort_data ?
+	ckpt->sort_data_writer = memtx->use_sort_data && !is_delta ?
 				 memtx_sort_data_writer_new() : NULL;
 	ckpt->box = box;
 	ckpt->touch = false;
+	memtx_dirty_set_create(&ckpt->dirty_set);
 	return ckpt;
 }
 
@@ -1214,6 +1581,7 @@ checkpoint_delete(struct checkpoint *ckpt)
 		memtx_sort_data_writer_delete(ckpt->sort_data_writer);
 	read_view_delete(ckpt->rv);
 	xdir_destroy(&ckpt->dir);
+	memtx_dirty_set_destroy(&ckpt->dirty_set);
 	free(ckpt);
 }
 
@@ -1316,6 +1684,107 @@ checkpoint_write_invalid_system_row(struct xlog *l)
 }
 #endif /* NDEBUG */
 
+/**
+ * Writes a delta snapshot: a DELETE of each key changed since the previous
+ * checkpoint followed by a REPLACE of the tuple stored under the key in the
+ * read view, if any. Deletes go first so that replaying a delta never hits
+ * a transient unique constraint violation in a secondary index.
+ *
+ * Sequence values may change without updating _sequence_data so the space
+ * is always written in full.
+ */
+static int
+checkpoint_write_delta(struct checkpoint *ckpt, unsigned int yield_loops)
+{
+	struct xlog *snap = &ckpt->snap;
+	if (checkpoint_write_system_data(snap, &ckpt->box->raft_local,
+					 &ckpt->box->limbo) != 0)
+		return -1;
+	unsigned int loops = 0;
+	struct space_read_view *space_rv;
+	read_view_foreach_space(space_rv, ckpt->rv) {
+		FiberGCChecker gc_check;
+		struct index_read_view *index_rv =
+			space_read_view_index(space_rv, 0);
+		assert(index_rv != NULL);
+		struct memtx_dirty_space *dirty =
+			memtx_dirty_set_space(&ckpt->dirty_set, space_rv->id);
+		bool write_all = space_rv->id == BOX_SEQUENCE_DATA_ID;
+		if (dirty == NULL && !write_all)
+			continue;
+		struct memtx_dirty_space_iterator dirty_it;
+		const struct memtx_dirty_key *key;
+		if (dirty != NULL) {
+			memtx_dirty_space_iterator_create(&dirty_it, dirty);
+			while ((key = memtx_dirty_space_iterator_next(
+						&dirty_it)) != NULL) {
+				if (checkpoint_write_request(
+						snap, IPROTO_DELETE,
+						space_rv->id,
+						space_rv->group_id,
+						key->data, key->size) != 0)
+					return -1;
+				if (++loops % yield_loops == 0)
+					fiber_sleep(0);
+				if (fiber_is_cancelled()) {
+					diag_set(FiberIsCancelled);
+					return -1;
+				}
+			}
+		}
+		if (write_all) {
+			struct index_read_view_iterator it;
+			if (index_read_view_create_iterator(index_rv, ITER_ALL,
+							    NULL, 0, &it) != 0)
+				return -1;
+			auto _ = make_scoped_guard([&] {
+				index_read_view_iterator_destroy(&it);
+			});
+			while (true) {
+				RegionGuard region_guard(&fiber()->gc);
+				struct read_view_tuple tuple;
+				if (index_read_view_iterator_next_raw(
+						&it, &tuple) != 0)
+					return -1;
+				if (tuple.data == NULL)
+					break;
+				if (checkpoint_write_request(
+						snap, IPROTO_REPLACE,
+						space_rv->id,
+						space_rv->group_id,
+						tuple.data, tuple.size) != 0)
+					return -1;
+			}
+			continue;
+		}
+		memtx_dirty_space_iterator_create(&dirty_it, dirty);
+		while ((key = memtx_dirty_space_iterator_next(
+					&dirty_it)) != NULL) {
+			RegionGuard region_guard(&fiber()->gc);
+			const char *data = key->data;
+			uint32_t part_count = mp_decode_array(&data);
+			struct read_view_tuple tuple;
+			if (index_read_view_get_raw(index_rv, data, part_count,
+						    &tuple) != 0)
+				return -1;
+			if (tuple.data != NULL &&
+			    checkpoint_write_request(snap, IPROTO_REPLACE,
+						     space_rv->id,
+						     space_rv->group_id,
+						     tuple.data,
+						     tuple.size) != 0)
+				return -1;
+			if (++loops % yield_loops == 0)
+				fiber_sleep(0);
+			if (fiber_is_cancelled()) {
+				diag_set(FiberIsCancelled);
+				return -1;
+			}
+		}
+	}
+	return 0;
+}
+
 static int
 checkpoint_f(va_list ap)
 {
@@ -1376,6 +1845,11 @@ checkpoint_f(va_list ap)
 		}
 	});
 	ERROR_INJECT(ERRINJ_SNAP_SKIP_ALL_ROWS, goto done);
+	if (ckpt->is_delta) {
+		if (checkpoint_write_delta(ckpt, YIELD_LOOPS_SNAP) != 0)
+			return -1;
+		goto done;
+	}
 	struct space_read_view *space_rv;
 	read_view_foreach_space(space_rv, ckpt->rv) {
 		FiberGCChecker gc_check;
@@ -1534,15 +2008,47 @@ checkpoint_f(va_list ap)
 	return 0;
 }
 
+/**
+ * Gets the vclock of the last checkpoint, either full or delta.
+ * Returns -1 if there's no checkpoints.
+ */
+static int
+memtx_engine_last_checkpoint(struct memtx_engine *memtx, struct vclock *vclock,
+			     bool *is_delta)
+{
+	struct vclock delta;
+	int64_t snap_signature = xdir_last_vclock(&memtx->snap_dir, vclock);
+	int64_t delta_signature = xdir_last_vclock(&memtx->delta_dir, &delta);
+	*is_delta = delta_signature > snap_signature;
+	if (*is_delta)
+		vclock_copy(vclock, &delta);
+	return *is_delta ? 0 : (snap_signature >= 0 ? 0 : -1);
+}
+
 static int
 memtx_engine_begin_checkpoint(struct engine *engine,
 			      const struct engine_checkpoint_params *params)
 {
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
 	assert(memtx->checkpoint == NULL);
-	memtx->checkpoint = checkpoint_new(memtx, params->box);
+	bool is_delta = memtx->dirty_set_is_complete &&
+			memtx->snap_delta_chain < memtx->snap_delta_count &&
+			vclockset_last(&memtx->snap_dir.index) != NULL;
+	memtx->checkpoint = checkpoint_new(memtx, params->box, is_delta);
 	if (memtx->checkpoint == NULL)
 		return -1;
+	/*
+	 * The read view is taken, so the changes made from now on go to
+	 * the next checkpoint.
+	 */
+	if (is_delta) {
+		memtx_dirty_set_destroy(&memtx->checkpoint->dirty_set);
+		memtx->checkpoint->dirty_set = memtx->dirty_set;
+	} else {
+		memtx_dirty_set_destroy(&memtx->dirty_set);
+	}
+	memtx_dirty_set_create(&memtx->dirty_set);
+	memtx->dirty_set_is_complete = memtx->snap_delta_count > 0;
 	return 0;
 }
 
@@ -1555,11 +2061,19 @@ memtx_engine_wait_checkpoint(struct engine *engine,
 	assert(memtx->checkpoint != NULL);
 	/*
 	 * If a snapshot already exists, do not create a new one.
+	 * Nothing has changed since then so it doesn't matter whether
+	 * it's a full or a delta snapshot.
 	 */
 	struct vclock last;
-	if (xdir_last_vclock(&memtx->snap_dir, &last) >= 0 &&
+	bool is_delta;
+	if (memtx_engine_last_checkpoint(memtx, &last, &is_delta) == 0 &&
 	    vclock_compare(&last, vclock) == 0) {
 		memtx->checkpoint->touch = true;
+		if (memtx->checkpoint->is_delta != is_delta) {
+			xdir_destroy(&memtx->checkpoint->dir);
+			checkpoint_set_is_delta(memtx->checkpoint, memtx,
+						is_delta);
+		}
 	}
 	vclock_copy(&memtx->checkpoint->vclock, vclock);
 
@@ -1606,11 +2120,17 @@ memtx_engine_commit_checkpoint(struct engine *engine,
 		coio_call(memtx_engine_commit_checkpoint_f, memtx->checkpoint);
 	}
 
+	struct xdir *dir = memtx->checkpoint->is_delta ?
+			   &memtx->delta_dir : &memtx->snap_dir;
 	struct vclock last;
-	if (xdir_last_vclock(&memtx->snap_dir, &last) < 0 ||
+	if (xdir_last_vclock(dir, &last) < 0 ||
 	    vclock_compare(&last, vclock) != 0) {
 		/* Add the new checkpoint to the set. */
-		xdir_add_vclock(&memtx->snap_dir, &memtx->checkpoint->vclock);
+		xdir_add_vclock(dir, &memtx->checkpoint->vclock);
+	}
+	if (!memtx->checkpoint->touch) {
+		memtx->snap_delta_chain = memtx->checkpoint->is_delta ?
+					  memtx->snap_delta_chain + 1 : 0;
 	}
 
 	checkpoint_delete(memtx->checkpoint);
@@ -1639,14 +2159,24 @@ memtx_engine_abort_checkpoint(struct engine *engine)
 	coio_call(memtx_engine_abort_checkpoint_f, memtx->checkpoint);
 	checkpoint_delete(memtx->checkpoint);
 	memtx->checkpoint = NULL;
+	/* The changes seen by the read view are lost, start over. */
+	memtx_engine_invalidate_dirty_set(memtx);
 }
 
 static void
 memtx_engine_collect_garbage(struct engine *engine, const struct vclock *vclock)
 {
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
-	xdir_collect_garbage(&memtx->snap_dir, vclock_sum(vclock),
-			     XDIR_GC_ASYNC);
+	/*
+	 * Delta snapshots are useless without the full snapshot they
+	 * are based on, so keep the base of the oldest checkpoint.
+	 */
+	int64_t signature = vclock_sum(vclock);
+	const struct vclock *base = memtx_engine_snap_base(memtx, signature);
+	if (base != NULL)
+		signature = vclock_sum(base);
+	xdir_collect_garbage(&memtx->snap_dir, signature, XDIR_GC_ASYNC);
+	xdir_collect_garbage(&memtx->delta_dir, signature + 1, XDIR_GC_ASYNC);
 }
 
 static int
@@ -1654,17 +2184,34 @@ memtx_engine_backup(struct engine *engine, const struct vclock *vclock,
 		    engine_backup_cb cb, void *cb_arg)
 {
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
+	int64_t signature = vclock_sum(vclock);
+	const struct vclock *base = memtx_engine_snap_base(memtx, signature);
+	int64_t snap_signature = base != NULL ? vclock_sum(base) : signature;
 
 	/* Backup the .snap file. */
 	const char *snap_filename = xdir_format_filename(&memtx->snap_dir,
-							 vclock_sum(vclock));
+							 snap_signature);
 	if (cb(snap_filename, cb_arg) != 0)
 		return -1;
 
 	/* Backup the corresponding .sortdata file if exists. */
 	const char *sortdata_filename = memtx_sort_data_filename(snap_filename);
-	if (access(sortdata_filename, F_OK) == 0)
-		return cb(sortdata_filename, cb_arg);
+	if (access(sortdata_filename, F_OK) == 0 &&
+	    cb(sortdata_filename, cb_arg) != 0)
+		return -1;
+
+	/* Backup the delta snapshots written on top of it. */
+	struct vclock *delta_vclock;
+	vclockset_foreach(&memtx->delta_dir.index, delta_vclock) {
+		int64_t delta_signature = vclock_sum(delta_vclock);
+		if (delta_signature <= snap_signature)
+			continue;
+		if (delta_signature > signature)
+			break;
+		if (cb(xdir_format_filename(&memtx->delta_dir,
+					    delta_signature), cb_arg) != 0)
+			return -1;
+	}
 	return 0;
 }
 
@@ -1935,6 +2482,22 @@ memtx_tuple_validate(struct tuple_format *format, struct tuple *tuple)
 	return rc;
 }
 
+/** Apprises the garbage collector of an available checkpoint. */
+static void
+memtx_engine_add_checkpoint(struct xdir *dir, const struct vclock *vclock)
+{
+	const char *name = xdir_format_filename(dir, vclock_sum(vclock));
+	struct stat attr;
+	double timestamp = ev_time();
+	if (stat(name, &attr) != 0)
+		say_warn("failed to get modification time of %s, "
+			 "set it to the current time",
+			 name);
+	else
+		timestamp = (double)attr.st_mtime;
+	gc_add_checkpoint(vclock, timestamp);
+}
+
 struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
@@ -1943,6 +2506,7 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 memtx_on_indexes_built_cb on_indexes_built)
 {
 	int64_t snap_signature;
+	struct vclock *snap_vclock, *delta_vclock;
 	struct memtx_engine *memtx =
 		(struct memtx_engine *)calloc(1, sizeof(*memtx));
 	if (memtx == NULL) {
@@ -1955,8 +2519,12 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		    &xlog_opts_default);
 	memtx->snap_dir.force_recovery = force_recovery;
 	memtx->snap_dir.gc_cb = memtx_sort_data_collect;
+	xdir_create(&memtx->delta_dir, snap_dirname, "DELTA", &INSTANCE_UUID,
+		    &xlog_opts_default);
+	memtx->delta_dir.force_recovery = force_recovery;
 
-	if (xdir_scan(&memtx->snap_dir, true) != 0)
+	if (xdir_scan(&memtx->snap_dir, true) != 0 ||
+	    xdir_scan(&memtx->delta_dir, true) != 0)
 		goto fail;
 
 	/*
@@ -1979,21 +2547,28 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		xlog_cursor_close(&cursor, false);
 	}
 
-	/* Apprise the garbage collector of available checkpoints. */
-	for (struct vclock *vclock = vclockset_first(&memtx->snap_dir.index);
-	     vclock != NULL;
-	     vclock = vclockset_next(&memtx->snap_dir.index, vclock)) {
-		const char *name = xdir_format_filename(&memtx->snap_dir,
-							vclock_sum(vclock));
-		struct stat attr;
-		double timestamp = ev_time();
-		if (stat(name, &attr) != 0)
-			say_warn("failed to get modification time of %s, "
-				 "set it to the current time",
-				 name);
-		else
-			timestamp = (double)attr.st_mtime;
-		gc_add_checkpoint(vclock, timestamp);
+	/*
+	 * Apprise the garbage collector of available checkpoints in
+	 * the signature order. Delta snapshots older than the first
+	 * full snapshot can't be recovered so they are ignored.
+	 */
+	snap_vclock = vclockset_first(&memtx->snap_dir.index);
+	delta_vclock = vclockset_first(&memtx->delta_dir.index);
+	while (delta_vclock != NULL && (snap_vclock == NULL ||
+	       vclock_sum(delta_vclock) <= vclock_sum(snap_vclock)))
+		delta_vclock = vclockset_next(&memtx->delta_dir.index,
+					      delta_vclock);
+	while (snap_vclock != NULL) {
+		memtx_engine_add_checkpoint(&memtx->snap_dir, snap_vclock);
+		snap_vclock = vclockset_next(&memtx->snap_dir.index,
+					     snap_vclock);
+		while (delta_vclock != NULL && (snap_vclock == NULL ||
+		       vclock_sum(delta_vclock) < vclock_sum(snap_vclock))) {
+			memtx_engine_add_checkpoint(&memtx->delta_dir,
+						    delta_vclock);
+			delta_vclock = vclockset_next(&memtx->delta_dir.index,
+						      delta_vclock);
+		}
 	}
 
 	stailq_create(&memtx->gc_queue);
@@ -2097,6 +2672,9 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	memtx->sort_threads = sort_threads;
 	memtx->recovery.last_space_id = BOX_ID_NIL;
 	memtx->recovery.sort_data_reader = NULL;
+	memtx->recovery.snap_signature = -1;
+	memtx->recovery.checkpoint_signature = -1;
+	memtx_dirty_set_create(&memtx->dirty_set);
 
 	memtx->base.vtab = &memtx_engine_vtab;
 	memtx->base.name = "memtx";
@@ -2117,10 +2695,12 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	memtx->on_indexes_built_cb = on_indexes_built;
 	memtx->use_sort_data = false;
 
+	memtx_tuple_compression_init();
 	fiber_start(memtx->gc_fiber, memtx);
 	return memtx;
 fail:
 	xdir_destroy(&memtx->snap_dir);
+	xdir_destroy(&memtx->delta_dir);
 	free(memtx);
 	return NULL;
 }
@@ -2243,6 +2823,13 @@ memtx_engine_set_snap_io_rate_limit(struct memtx_engine *memtx, double limit)
 	memtx->snap_io_rate_limit = limit * 1024 * 1024;
 }
 
+void
+memtx_engine_set_snap_compress_threads(struct memtx_engine *memtx,
+				       int thread_count)
+{
+	memtx->snap_compress_threads = thread_count;
+}
+
 int
 memtx_engine_set_memory(struct memtx_engine *memtx, size_t size)
 {
@@ -2259,6 +2846,14 @@ memtx_engine_set_memory(struct memtx_engine *memtx, size_t size)
 	return 0;
 }
 
+void
+memtx_engine_set_snap_delta_count(struct memtx_engine *memtx, int count)
+{
+	memtx->snap_delta_count = count;
+	if (count == 0)
+		memtx_engine_invalidate_dirty_set(memtx);
+}
+
 void
 memtx_engine_set_use_sort_data(struct memtx_engine *memtx, bool value)
 {
@@ -2569,10 +3164,11 @@ memtx_prepare_read_view_tuple(struct tuple *tuple,
 					index->space->upgrade, tuple);
 	result->data = tuple_data_range(tuple, &result->size);
 	result->ptr = tuple;
-	if (!index->space->rv->disable_decompression) {
+	if (tuple_is_compressed(tuple) &&
+	    !index->space->rv->disable_decompression) {
 		result->data = memtx_tuple_decompress_raw(
-				result->data, result->data + result->size,
-				&result->size);
+				index->space->compression_dict, result->data,
+				result->data + result->size, &result->size);
 		if (result->data == NULL)
 			return -1;
 	}
@@ -41,6 +41,7 @@
 
 
 #include "engine.h"
+#include "memtx_dirty_set.h"
 #include "xlog.h"
 #include "salad/stailq.h"
 #include "sysalloc.h"
@@ -114,8 +115,29 @@ struct memtx_engine {
 	struct checkpoint *checkpoint;
 	/** The directory where to store snapshots. */
 	struct xdir snap_dir;
+	/**
+	 * The directory where to store delta snapshots. It's the same
+	 * directory as snap_dir, but the files have a different extension.
+	 */
+	struct xdir delta_dir;
 	/** Limit disk usage of checkpointing (bytes per second). */
 	uint64_t snap_io_rate_limit;
+	/** Number of threads compressing a snapshot. */
+	int snap_compress_threads;
+	/**
+	 * Max number of delta snapshots written on top of a full one,
+	 * box.cfg.snap_delta_count. Zero disables delta snapshots.
+	 */
+	int snap_delta_count;
+	/** Number of delta snapshots since the last full snapshot. */
+	int snap_delta_chain;
+	/** Primary keys changed since the last checkpoint. */
+	struct memtx_dirty_set dirty_set;
+	/**
+	 * Set if dirty_set contains all the changes made since the last
+	 * checkpoint so the next checkpoint may be written as a delta.
+	 */
+	bool dirty_set_is_complete;
 	/** Skip invalid snapshot records if this flag is set. */
 	bool force_recovery;
 	/** Save and load the sort data. */
@@ -181,6 +203,13 @@ struct memtx_engine {
 		uint32_t last_space_id;
 		/** The memtx index sort data reader. */
 		struct memtx_sort_data_reader *sort_data_reader;
+		/** Signature of the recovered full snapshot or -1. */
+		int64_t snap_signature;
+		/**
+		 * Signature of the recovered checkpoint or -1. It's greater
+		 * than snap_signature if there are delta snapshots to apply.
+		 */
+		int64_t checkpoint_signature;
 	} recovery;
 };
 
@@ -233,6 +262,11 @@ struct memtx_stmt_rollback_info {
 	struct memtx_tuple_list *old_tuples;
 	/* The inserted tuple (NULL if no tuple inserted). */
 	struct tuple *new_tuple;
+	/*
+	 * A list of tuples inserted by a multi-row statement (NULL if
+	 * none). Can't be used along with the other members.
+	 */
+	struct memtx_tuple_list *new_tuples;
 };
 
 /**
@@ -259,6 +293,10 @@ memtx_stmt_rollback_info_delete(struct memtx_stmt_rollback_info *undo)
 	});
 	if (undo->new_tuple != NULL)
 		tuple_unref(undo->new_tuple);
+	struct tuple *new_tuple;
+	memtx_tuple_list_foreach(undo->new_tuples, new_tuple, {
+		tuple_unref(new_tuple);
+	});
 }
 
 /**
@@ -289,6 +327,23 @@ memtx_stmt_rollback_info_set_new_tuple(struct memtx_stmt_rollback_info *undo,
 	tuple_ref(new_tuple);
 }
 
+/**
+ * Add a tuple inserted by a multi-row statement to the rollback info.
+ */
+static inline void
+memtx_stmt_rollback_info_add_new_tuple(struct memtx_stmt_rollback_info *undo,
+				       struct tuple *new_tuple,
+				       struct region *region)
+{
+	assert(undo->new_tuple == NULL && undo->old_tuples == NULL);
+	struct memtx_tuple_list *prev_inserted = undo->new_tuples;
+	undo->new_tuples =
+		xregion_alloc_object(region, struct memtx_tuple_list);
+	undo->new_tuples->tuple = new_tuple;
+	undo->new_tuples->next = prev_inserted;
+	tuple_ref(new_tuple);
+}
+
 struct memtx_gc_task;
 
 struct memtx_gc_task_vtab {
@@ -345,6 +400,24 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 void
 memtx_engine_set_snap_io_rate_limit(struct memtx_engine *memtx, double limit);
 
+void
+memtx_engine_set_snap_compress_threads(struct memtx_engine *memtx,
+				       int thread_count);
+
+/**
+ * The box.cfg.snap_delta_count field update handler.
+ */
+void
+memtx_engine_set_snap_delta_count(struct memtx_engine *memtx, int count);
+
+/**
+ * Forget the keys changed since the last checkpoint so that the next
+ * checkpoint is written in full. Called on changes that can't be tracked
+ * by primary key, e.g. data changes of other engines checkpointed by memtx.
+ */
+void
+memtx_engine_invalidate_dirty_set(struct memtx_engine *memtx);
+
 int
 memtx_engine_set_memory(struct memtx_engine *memtx, size_t size);
 
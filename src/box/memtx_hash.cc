@@ -44,6 +44,7 @@
 #include "errinj.h"
 #include "trivia/config.h"
 
+#include <math.h>
 #include <small/mempool.h>
 
 static inline bool
@@ -83,8 +84,117 @@ struct memtx_hash_index {
 	struct light_index_core hash_table;
 	struct memtx_gc_task gc_task;
 	struct light_index_iterator gc_iterator;
+	/**
+	 * Set if the index is over a single non-nullable unsigned or
+	 * integer field. Such keys are hashed by value rather than with
+	 * the generic MsgPack hash, see memtx_hash_index_is_int_key().
+	 * Hashes are stored in the hash table so the flag is fixed for
+	 * the lifetime of the index.
+	 */
+	bool is_int_key;
 };
 
+/**
+ * Returns true if the integer key hash may be used for an index with
+ * the given definition.
+ */
+static bool
+memtx_hash_index_is_int_key(const struct index_def *def)
+{
+	const struct key_def *key_def = def->key_def;
+	if (key_def->part_count != 1 || key_def->is_nullable ||
+	    key_def->has_json_paths || key_def->is_multikey ||
+	    key_def->for_func_index)
+		return false;
+	enum field_type type = key_def->parts[0].type;
+	return type == FIELD_TYPE_UNSIGNED || type == FIELD_TYPE_INTEGER;
+}
+
+/** Mixes the bits of a 64-bit integer (MurmurHash3 finalizer). */
+static inline uint32_t
+memtx_hash_int(uint64_t v)
+{
+	v ^= v >> 33;
+	v *= 0xff51afd7ed558ccdULL;
+	v ^= v >> 33;
+	v *= 0xc4ceb9fe1a85ec53ULL;
+	v ^= v >> 33;
+	return (uint32_t)v;
+}
+
+/**
+ * Hashes an integer key part. Integral floating point numbers are hashed
+ * as integers so that they match integer keys, like key_hash() does.
+ */
+static inline uint32_t
+memtx_hash_int_field(const char *field)
+{
+	switch (mp_typeof(*field)) {
+	case MP_UINT:
+		return memtx_hash_int(mp_decode_uint(&field));
+	case MP_INT:
+		return memtx_hash_int((uint64_t)mp_decode_int(&field));
+	case MP_FLOAT:
+	case MP_DOUBLE: {
+		double iptr;
+		double val = mp_typeof(*field) == MP_FLOAT ?
+			     mp_decode_float(&field) :
+			     mp_decode_double(&field);
+		if (!isfinite(val) || modf(val, &iptr) != 0 ||
+		    val < -exp2(63) || val >= exp2(64))
+			break;
+		if (val >= 0)
+			return memtx_hash_int((uint64_t)val);
+		return memtx_hash_int((uint64_t)(int64_t)val);
+	}
+	default:
+		break;
+	}
+	/* Not an integer, can't be equal to any key stored in the index. */
+	return 0;
+}
+
+/** Computes the hash of a tuple stored in the index. */
+static inline uint32_t
+memtx_hash_index_tuple_hash(struct memtx_hash_index *index,
+			    struct tuple *tuple)
+{
+	struct key_def *key_def = index->base.def->key_def;
+	if (index->is_int_key) {
+		return memtx_hash_int_field(tuple_field_by_part(
+				tuple, &key_def->parts[0], MULTIKEY_NONE));
+	}
+	return tuple_hash(tuple, key_def);
+}
+
+/**
+ * Computes the hash of a lookup key. The key definition is passed
+ * explicitly, because read views use their own copy of it.
+ */
+static inline uint32_t
+memtx_hash_index_key_hash(struct memtx_hash_index *index, const char *key,
+			  struct key_def *key_def)
+{
+	if (index->is_int_key)
+		return memtx_hash_int_field(key);
+	return key_hash(key, key_def);
+}
+
+/**
+ * Implementation of def_change_requires_rebuild for memtx hash index.
+ * The index must be rebuilt if the new definition switches between
+ * the integer and generic key hash.
+ */
+static bool
+memtx_hash_index_def_change_requires_rebuild(struct index *base,
+					     const struct index_def *new_def)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	if (memtx_index_def_change_requires_rebuild(base, new_def))
+		return true;
+	return index->is_int_key != memtx_hash_index_is_int_key(new_def);
+}
+
 /* {{{ MemtxHash Iterators ****************************************/
 
 struct hash_iterator {
@@ -182,6 +292,43 @@ hash_iterator_eq(struct iterator *it, struct tuple **ret)
 	return 0;
 }
 
+/**
+ * Fetch a batch of tuples from a full scan iterator. A batch ends early
+ * on a tuple that was decompressed or upgraded, because such a tuple is
+ * only referenced until the next one is fetched.
+ */
+static int
+hash_iterator_next_batch(struct iterator *iterator, struct tuple **ret,
+			 uint32_t size, uint32_t *count)
+{
+	if (iterator->next_internal != hash_iterator_ge)
+		return generic_iterator_next_batch(iterator, ret, size, count);
+	struct hash_iterator *it = (struct hash_iterator *)iterator;
+	struct txn *txn = in_txn();
+	struct space *space;
+	struct index *index;
+	index_weak_ref_get_checked(&iterator->index_ref, &space, &index);
+	struct memtx_hash_index *hash_index = (struct memtx_hash_index *)index;
+	*count = 0;
+	while (*count < size) {
+		struct tuple **res = light_index_iterator_get_and_next(
+			&hash_index->hash_table, &it->iterator);
+		if (res == NULL)
+			break;
+		struct tuple *tuple = memtx_tx_tuple_clarify(txn, space, *res,
+							     index, 0);
+		if (tuple == NULL)
+			continue;
+		struct tuple *result = tuple;
+		if (memtx_prepare_result_tuple(space, &result) != 0)
+			return -1;
+		ret[(*count)++] = result;
+		if (result != tuple)
+			break;
+	}
+	return 0;
+}
+
 /* }}} */
 
 /* {{{ MemtxHash -- implementation of all hashes. **********************/
@@ -335,7 +482,7 @@ memtx_hash_index_get_internal(struct index *base, const char *key,
 	struct space *space = space_by_id(base->def->space_id);
 	struct txn *txn = in_txn();
 	*result = NULL;
-	uint32_t h = key_hash(key, base->def->key_def);
+	uint32_t h = memtx_hash_index_key_hash(index, key, base->def->key_def);
 	uint32_t k = light_index_find_key(&index->hash_table, h, key);
 	if (k != light_index_end) {
 		struct tuple *tuple = light_index_get(&index->hash_table, k);
@@ -362,7 +509,7 @@ memtx_hash_index_replace_impl(struct memtx_hash_index *index,
 			      struct tuple *new_tuple, struct tuple **dup_tuple,
 			      uint32_t *pos)
 {
-	uint32_t h = tuple_hash(new_tuple, index->base.def->key_def);
+	uint32_t h = memtx_hash_index_tuple_hash(index, new_tuple);
 	if (index_inject_oom() != 0)
 		goto fail;
 	*pos = light_index_replace(&index->hash_table, h, new_tuple,
@@ -393,7 +540,7 @@ static int
 memtx_hash_index_insert_impl(struct memtx_hash_index *index,
 			     struct tuple *new_tuple)
 {
-	uint32_t h = tuple_hash(new_tuple, index->base.def->key_def);
+	uint32_t h = memtx_hash_index_tuple_hash(index, new_tuple);
 	if (index_inject_oom() != 0)
 		goto fail;
 	if (light_index_insert(&index->hash_table,
@@ -434,7 +581,7 @@ static int
 memtx_hash_index_delete_value_impl(struct memtx_hash_index *index,
 				   struct tuple *tuple)
 {
-	uint32_t h = tuple_hash(tuple, index->base.def->key_def);
+	uint32_t h = memtx_hash_index_tuple_hash(index, tuple);
 	if (index_inject_oom() != 0)
 		goto fail;
 	if (light_index_delete_value(&index->hash_table, h, tuple) != 0)
@@ -529,7 +676,9 @@ memtx_hash_index_create_iterator(struct index *base, enum iterator_type type,
 
 		if (part_count != 0) {
 			light_index_iterator_key(&index->hash_table, &it->iterator,
-					key_hash(key, base->def->key_def), key);
+					memtx_hash_index_key_hash(
+						index, key, base->def->key_def),
+					key);
 			it->base.next_internal = hash_iterator_gt;
 		} else {
 			light_index_iterator_begin(&index->hash_table, &it->iterator);
@@ -547,7 +696,9 @@ memtx_hash_index_create_iterator(struct index *base, enum iterator_type type,
 	case ITER_EQ:
 		assert(part_count > 0);
 		light_index_iterator_key(&index->hash_table, &it->iterator,
-				key_hash(key, base->def->key_def), key);
+				memtx_hash_index_key_hash(
+					index, key, base->def->key_def),
+				key);
 		it->base.next_internal = hash_iterator_eq;
 		if (it->iterator.slotpos == light_index_end)
 			memtx_tx_track_point(in_txn(), space,
@@ -557,6 +708,7 @@ memtx_hash_index_create_iterator(struct index *base, enum iterator_type type,
 		unreachable();
 	}
 	it->base.next = memtx_iterator_next;
+	it->base.next_batch = hash_iterator_next_batch;
 	it->base.position = generic_iterator_position;
 	return (struct iterator *)it;
 }
@@ -607,7 +759,8 @@ hash_read_view_get_raw(struct index_read_view *base,
 	assert(base->def->opts.is_unique);
 	assert(part_count == base->def->key_def->part_count);
 	(void)part_count;
-	uint32_t h = key_hash(key, base->def->key_def);
+	uint32_t h = memtx_hash_index_key_hash(rv->index, key,
+					       base->def->key_def);
 	uint32_t k = light_index_view_find_key(&rv->view, h, key);
 	if (k == light_index_end) {
 		*result = read_view_tuple_none();
@@ -677,7 +830,8 @@ hash_read_view_iterator_start(struct hash_read_view_iterator *it,
 		if (part_count != 0) {
 			light_index_view_iterator_key(
 				&rv->view, &it->iterator,
-				key_hash(key, key_def), key);
+				memtx_hash_index_key_hash(rv->index, key,
+							  key_def), key);
 			it->base.next_raw = hash_read_view_iterator_gt;
 		} else {
 			light_index_view_iterator_begin(&rv->view,
@@ -693,7 +847,8 @@ hash_read_view_iterator_start(struct hash_read_view_iterator *it,
 		assert(part_count > 0);
 		light_index_view_iterator_key(
 			&rv->view, &it->iterator,
-			key_hash(key, key_def), key);
+			memtx_hash_index_key_hash(rv->index, key, key_def),
+			key);
 		it->base.next_raw = hash_read_view_iterator_eq;
 		break;
 	default:
@@ -776,7 +931,7 @@ static const struct index_vtab memtx_hash_index_vtab_base = {
 	/* .update_def = */ memtx_hash_index_update_def,
 	/* .depends_on_pk = */ generic_index_depends_on_pk,
 	/* .def_change_requires_rebuild = */
-		memtx_index_def_change_requires_rebuild,
+		memtx_hash_index_def_change_requires_rebuild,
 	/* .size = */ memtx_hash_index_size,
 	/* .bsize = */ memtx_hash_index_bsize,
 	/* .quantile = */ generic_index_quantile,
@@ -814,6 +969,7 @@ memtx_hash_index_new(struct memtx_engine *memtx, struct index_def *def)
 	index_create(&index->base, (struct engine *)memtx,
 		     (struct index_vtab *)&memtx_hash_index_vtab, def);
 
+	index->is_int_key = memtx_hash_index_is_int_key(def);
 	light_index_create(&index->hash_table, index->base.def->key_def,
 			   &memtx->index_extent_allocator,
 			   &memtx->index_extent_stats);
@@ -48,6 +48,7 @@
 #include "memtx_tuple_compression.h"
 #include "memtx_sort_data.h"
 #include "memtx_index.h"
+#include "tuple_arrow.h"
 #include "schema.h"
 #include "small/region.h"
 
@@ -774,6 +775,86 @@ memtx_space_execute_delete_range(struct space *space, struct txn *txn,
 	return rc;
 }
 
+/**
+ * Implementation of Arrow insert: a tuple is inserted per row of the
+ * record batch.
+ */
+static int
+memtx_space_execute_insert_arrow(struct space *space, struct txn *txn,
+				 struct ArrowArray *array,
+				 struct ArrowSchema *schema)
+{
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	/*
+	 * The transaction manager can track only one inserted tuple
+	 * per statement.
+	 */
+	if (memtx_tx_manager_use_mvcc_engine) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Memtx MVCC engine",
+			 "Arrow insert");
+		return -1;
+	}
+	struct region *gc = &fiber()->gc;
+	struct tuple_arrow_field_map map;
+	if (tuple_arrow_check(array, schema, space->format->dict,
+			      space_name(space), gc, &map) != 0)
+		return -1;
+
+	int rc = -1;
+	struct region *region = tx_region_acquire(txn);
+	struct memtx_stmt_rollback_info *undo =
+		memtx_stmt_rollback_info_new(region);
+	for (int64_t row = 0; row < array->length; row++) {
+		size_t gc_svp = region_used(gc);
+		const char *data_end;
+		const char *data = tuple_arrow_encode_row(array, schema, &map,
+							  row, gc, &data_end);
+		struct tuple *new_tuple =
+			space->format->vtab.tuple_new(space->format, data,
+						      data_end);
+		region_truncate(gc, gc_svp);
+		if (new_tuple == NULL) {
+			error_set_space(diag_last_error(diag_get()),
+					space->def);
+			goto end;
+		}
+		tuple_ref(new_tuple);
+		struct tuple *new_index_tuple =
+			memtx_space_prepare_index_tuple(space->format,
+							new_tuple);
+		if (new_index_tuple == NULL) {
+			tuple_unref(new_tuple);
+			goto end;
+		}
+		tuple_ref(new_index_tuple);
+		struct tuple *old_index_tuple;
+		int replace_rc = memtx_space->replace(space, NULL,
+						      new_index_tuple,
+						      DUP_INSERT,
+						      &old_index_tuple);
+		if (replace_rc == 0) {
+			assert(old_index_tuple == NULL);
+			if (space->upgrade != NULL)
+				memtx_space_upgrade_track_tuple(
+					space->upgrade, new_index_tuple);
+			memtx_stmt_rollback_info_add_new_tuple(
+				undo, new_index_tuple, region);
+		}
+		tuple_unref(new_index_tuple);
+		tuple_unref(new_tuple);
+		if (replace_rc != 0)
+			goto end;
+	}
+	rc = 0;
+end:
+	/* Set the rollback info. */
+	tx_region_release(txn, TX_ALLOC_SYSTEM);
+	struct txn_stmt *stmt = txn_current_stmt(txn);
+	if (undo->new_tuples != NULL)
+		stmt->engine_savepoint = undo;
+	return rc;
+}
+
 /**
  * This function simply creates new memtx tuple, refs it and calls space's
  * replace function. In constrast to original memtx_space_execute_replace(), it
@@ -1561,7 +1642,8 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 	       tuple != NULL) {
 		struct key_def *key_def = new_index->def->key_def;
 		if (!tuple_format_is_compatible_with_key_def(tuple_format(tuple),
-							     key_def)) {
+							     key_def) ||
+		    memtx_tuple_check_key_def(tuple, key_def) != 0) {
 			rc = -1;
 			break;
 		}
@@ -1656,6 +1738,8 @@ memtx_space_prepare_alter(struct space *old_space, struct space *new_space)
 		return -1;
 	}
 
+	memtx_tuple_format_inherit_compression(new_space->format,
+					       old_space->format);
 	new_memtx_space->replace = old_memtx_space->replace;
 	return 0;
 }
@@ -1705,7 +1789,7 @@ static const struct space_vtab memtx_space_vtab = {
 	/* .execute_delete = */ memtx_space_execute_delete,
 	/* .execute_update = */ memtx_space_execute_update,
 	/* .execute_upsert = */ memtx_space_execute_upsert,
-	/* .execute_insert_arrow = */ generic_space_execute_insert_arrow,
+	/* .execute_insert_arrow = */ memtx_space_execute_insert_arrow,
 	/* .execute_delete_range = */ memtx_space_execute_delete_range,
 	/* .ephemeral_replace = */ memtx_space_ephemeral_replace,
 	/* .ephemeral_delete = */ memtx_space_ephemeral_delete,
@@ -1748,6 +1832,8 @@ memtx_space_new(struct memtx_engine *memtx,
 		free(memtx_space);
 		return NULL;
 	}
+	if (def->opts.compression != SPACE_COMPRESSION_NONE)
+		memtx_tuple_format_enable_compression(format);
 	tuple_format_ref(format);
 
 	if (space_create((struct space *)memtx_space, (struct engine *)memtx,
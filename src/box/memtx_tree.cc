@@ -633,6 +633,90 @@ WRAP_ITERATOR_METHOD(tree_iterator_prev_equal);
 
 #undef WRAP_ITERATOR_METHOD
 
+/**
+ * Fetch a batch of tuples from a forward iterator. Instead of looking up
+ * the tree for each tuple, walks the elements of the current leaf block
+ * as an array, so the iterator state is only updated once per leaf.
+ *
+ * A batch ends early on a tuple that was decompressed or upgraded,
+ * because such a tuple is only referenced until the next one is fetched.
+ */
+template <bool USE_HINT>
+static int
+tree_iterator_next_batch(struct iterator *iterator, struct tuple **ret,
+			 uint32_t size, uint32_t *count)
+{
+	/* The first fetch positions the iterator, others aren't batched. */
+	if (iterator->next_internal != tree_iterator_next<USE_HINT>)
+		return generic_iterator_next_batch(iterator, ret, size, count);
+	struct space *space;
+	struct index *index_base;
+	index_weak_ref_get_checked(&iterator->index_ref, &space, &index_base);
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)index_base;
+	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
+	struct txn *txn = in_txn();
+	bool is_multikey = index_base->def->key_def->is_multikey;
+	int rc = 0;
+	bool is_transient = false;
+	*count = 0;
+	while (*count < size && !is_transient && rc == 0) {
+		assert(it->last.tuple != NULL);
+		struct memtx_tree_data<USE_HINT> *check =
+			memtx_tree_iterator_get_elem(&index->tree,
+						     &it->tree_iterator);
+		if (check == NULL ||
+		    !memtx_tree_data_is_equal(check, &it->last)) {
+			it->tree_iterator = memtx_tree_upper_bound_elem(
+				&index->tree, it->last, NULL);
+		} else {
+			memtx_tree_iterator_next(&index->tree,
+						 &it->tree_iterator);
+		}
+		bps_tree_pos_t leaf_size;
+		struct memtx_tree_data<USE_HINT> *elems =
+			memtx_tree_iterator_get_leaf_elems(&index->tree,
+							   &it->tree_iterator,
+							   &leaf_size);
+		if (elems == NULL) {
+			iterator->next_internal = exhausted_iterator_next;
+			memtx_tx_track_gap(txn, space, index_base, NULL,
+					   ITER_GE, NULL, 0);
+			break;
+		}
+		bps_tree_pos_t i = 0;
+		while (i < leaf_size && *count < size) {
+			struct memtx_tree_data<USE_HINT> *res = &elems[i++];
+			uint32_t mk_index = is_multikey ?
+					    (uint32_t)res->hint : 0;
+			struct tuple *tuple = memtx_tx_tuple_clarify(
+				txn, space, res->tuple, index_base, mk_index);
+			/*
+			 * Pass no key because any write to the gap between
+			 * that two tuples must lead to conflict.
+			 */
+			memtx_tx_track_gap(txn, space, index_base, res->tuple,
+					   ITER_GE, NULL, 0);
+			if (tuple == NULL)
+				continue;
+			struct tuple *result = tuple;
+			if (memtx_prepare_result_tuple(space, &result) != 0) {
+				rc = -1;
+				break;
+			}
+			ret[(*count)++] = result;
+			if (result != tuple) {
+				is_transient = true;
+				break;
+			}
+		}
+		assert(i > 0);
+		it->tree_iterator.pos += i - 1;
+		tree_iterator_set_last<USE_HINT>(it, &elems[i - 1]);
+	}
+	return rc;
+}
+
 template <bool USE_HINT>
 static void
 tree_iterator_set_next_method(struct tree_iterator<USE_HINT> *it)
@@ -2000,6 +2084,7 @@ memtx_tree_index_create_iterator_with_offset(
 	it->pool = &memtx->iterator_pool;
 	it->base.next_internal = tree_iterator_start<USE_HINT>;
 	it->base.next = memtx_iterator_next;
+	it->base.next_batch = tree_iterator_next_batch<USE_HINT>;
 	it->base.free = tree_iterator_free<USE_HINT>;
 	if (base->def->key_def->for_func_index) {
 		assert(USE_HINT);
@@ -0,0 +1,506 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "memtx_tuple_compression.h"
+
+#include <zstd.h>
+#include <zdict.h>
+
+#include "coio_task.h"
+#include "diag.h"
+#include "errcode.h"
+#include "fiber.h"
+#include "key_def.h"
+#include "memtx_engine.h"
+#include "mp_extension_types.h"
+#include "msgpuck.h"
+#include "say.h"
+#include "trivia/util.h"
+#include "tt_pthread.h"
+#include "tuple.h"
+#include "tuple_format.h"
+
+enum {
+	/** Size of a trained dictionary. */
+	MEMTX_COMPRESSION_DICT_SIZE = 16 * 1024,
+	/** Samples are collected until their total size reaches this. */
+	MEMTX_COMPRESSION_SAMPLE_SIZE = 100 * MEMTX_COMPRESSION_DICT_SIZE,
+	/** ... or until this number of samples is collected. */
+	MEMTX_COMPRESSION_SAMPLE_COUNT = 10000,
+	/** Tuple tails shorter than this aren't worth compressing. */
+	MEMTX_COMPRESSION_MIN_SIZE = 32,
+	/** Compression level used with the trained dictionary. */
+	MEMTX_COMPRESSION_LEVEL = 3,
+};
+
+/** See memtx_compression_dict::state. */
+enum memtx_compression_state {
+	/** Samples are being collected. */
+	MEMTX_COMPRESSION_SAMPLING,
+	/** The dictionary is being trained in a worker thread. */
+	MEMTX_COMPRESSION_TRAINING,
+	/** The dictionary is ready, tuples are compressed. */
+	MEMTX_COMPRESSION_READY,
+};
+
+/** Compression dictionary of a memtx space. */
+struct memtx_compression_dict {
+	/** Base class. */
+	struct tuple_compression_dict base;
+	/**
+	 * Dictionary state. Once the dictionary is ready, it never changes
+	 * so it can be used from any thread.
+	 */
+	enum memtx_compression_state state;
+	/** Concatenated samples or NULL if none have been collected. */
+	char *samples;
+	/** Total size of the collected samples. */
+	size_t samples_size;
+	/** Sizes of the collected samples. */
+	size_t *sample_sizes;
+	/** Number of the collected samples. */
+	uint32_t sample_count;
+	/** Digested dictionary for compression. Set once ready. */
+	ZSTD_CDict *cdict;
+	/** Digested dictionary for decompression. Set once ready. */
+	ZSTD_DDict *ddict;
+	/** Link in memtx_compression_train_queue. */
+	struct rlist in_train_queue;
+};
+
+/**
+ * Dictionaries waiting to be trained, linked by
+ * memtx_compression_dict::in_train_queue. Referenced.
+ */
+static RLIST_HEAD(memtx_compression_train_queue);
+
+/** Fiber that trains dictionaries from the queue. */
+static struct fiber *memtx_compression_worker;
+
+static int
+memtx_compression_worker_f(va_list ap);
+
+/** Compression context. Tuples are only compressed in the tx thread. */
+static ZSTD_CCtx *memtx_compression_cctx;
+
+/** Thread-local decompression context. */
+static pthread_key_t memtx_compression_dctx_key;
+
+static void
+memtx_compression_dctx_free(void *arg)
+{
+	ZSTD_freeDCtx(arg);
+}
+
+/** Returns the decompression context of the current thread. */
+static ZSTD_DCtx *
+memtx_compression_dctx(void)
+{
+	ZSTD_DCtx *dctx = tt_pthread_getspecific(memtx_compression_dctx_key);
+	if (dctx == NULL) {
+		dctx = ZSTD_createDCtx();
+		if (dctx == NULL) {
+			diag_set(OutOfMemory, sizeof(dctx), "malloc",
+				 "zstd context");
+			return NULL;
+		}
+		tt_pthread_setspecific(memtx_compression_dctx_key, dctx);
+	}
+	return dctx;
+}
+
+void
+memtx_tuple_compression_init(void)
+{
+	tt_pthread_key_create(&memtx_compression_dctx_key,
+			      memtx_compression_dctx_free);
+	memtx_compression_cctx = ZSTD_createCCtx();
+	if (memtx_compression_cctx == NULL)
+		panic("failed to create zstd compression context");
+	/* Tuples are small, save a few bytes per each. */
+	ZSTD_CCtx_setParameter(memtx_compression_cctx,
+			       ZSTD_c_dictIDFlag, 0);
+	memtx_compression_worker = fiber_new_system(
+		"memtx.compression", memtx_compression_worker_f);
+	if (memtx_compression_worker == NULL) {
+		diag_log();
+		panic("failed to start tuple compression fiber");
+	}
+	fiber_set_joinable(memtx_compression_worker, true);
+	fiber_start(memtx_compression_worker);
+}
+
+void
+memtx_tuple_compression_shutdown(void)
+{
+	fiber_cancel(memtx_compression_worker);
+	fiber_join(memtx_compression_worker);
+	memtx_compression_worker = NULL;
+}
+
+void
+memtx_tuple_compression_free(void)
+{
+	ZSTD_freeCCtx(memtx_compression_cctx);
+	memtx_compression_cctx = NULL;
+	tt_pthread_key_delete(memtx_compression_dctx_key);
+}
+
+/** Frees the collected samples. */
+static void
+memtx_compression_dict_reset_samples(struct memtx_compression_dict *dict)
+{
+	free(dict->samples);
+	free(dict->sample_sizes);
+	dict->samples = NULL;
+	dict->sample_sizes = NULL;
+	dict->samples_size = 0;
+	dict->sample_count = 0;
+}
+
+static void
+memtx_compression_dict_destroy(struct tuple_compression_dict *base)
+{
+	struct memtx_compression_dict *dict =
+		container_of(base, struct memtx_compression_dict, base);
+	assert(dict->state != MEMTX_COMPRESSION_TRAINING);
+	memtx_compression_dict_reset_samples(dict);
+	ZSTD_freeCDict(dict->cdict);
+	ZSTD_freeDDict(dict->ddict);
+	TRASH(dict);
+	free(dict);
+}
+
+static struct memtx_compression_dict *
+memtx_compression_dict_new(void)
+{
+	struct memtx_compression_dict *dict = xmalloc(sizeof(*dict));
+	dict->base.refs = 0;
+	dict->base.destroy = memtx_compression_dict_destroy;
+	dict->state = MEMTX_COMPRESSION_SAMPLING;
+	dict->samples = NULL;
+	dict->samples_size = 0;
+	dict->sample_sizes = NULL;
+	dict->sample_count = 0;
+	dict->cdict = NULL;
+	dict->ddict = NULL;
+	rlist_create(&dict->in_train_queue);
+	return dict;
+}
+
+void
+memtx_tuple_format_enable_compression(struct tuple_format *format)
+{
+	assert(format->compression_dict == NULL);
+	struct memtx_compression_dict *dict = memtx_compression_dict_new();
+	tuple_compression_dict_ref(&dict->base);
+	format->compression_dict = &dict->base;
+	format->is_compressed = true;
+}
+
+void
+memtx_tuple_format_inherit_compression(struct tuple_format *format,
+				       struct tuple_format *prev_format)
+{
+	struct tuple_compression_dict *dict = prev_format->compression_dict;
+	if (dict == NULL || dict == format->compression_dict)
+		return;
+	tuple_compression_dict_ref(dict);
+	if (format->compression_dict != NULL)
+		tuple_compression_dict_unref(format->compression_dict);
+	format->compression_dict = dict;
+}
+
+/** Trains the dictionary from the collected samples. Runs in coio. */
+static ssize_t
+memtx_compression_dict_train_cb(va_list ap)
+{
+	struct memtx_compression_dict *dict =
+		va_arg(ap, struct memtx_compression_dict *);
+	void *buf = xmalloc(MEMTX_COMPRESSION_DICT_SIZE);
+	size_t size = ZDICT_trainFromBuffer(buf, MEMTX_COMPRESSION_DICT_SIZE,
+					    dict->samples, dict->sample_sizes,
+					    dict->sample_count);
+	if (ZDICT_isError(size)) {
+		free(buf);
+		diag_set(ClientError, ER_COMPRESSION,
+			 ZDICT_getErrorName(size));
+		return -1;
+	}
+	dict->cdict = ZSTD_createCDict(buf, size, MEMTX_COMPRESSION_LEVEL);
+	dict->ddict = ZSTD_createDDict(buf, size);
+	free(buf);
+	if (dict->cdict == NULL || dict->ddict == NULL) {
+		ZSTD_freeCDict(dict->cdict);
+		ZSTD_freeDDict(dict->ddict);
+		dict->cdict = NULL;
+		dict->ddict = NULL;
+		diag_set(OutOfMemory, size, "malloc", "zstd dictionary");
+		return -1;
+	}
+	return 0;
+}
+
+/** Trains a dictionary from the queue and makes it ready for use. */
+static void
+memtx_compression_dict_train(struct memtx_compression_dict *dict)
+{
+	assert(dict->state == MEMTX_COMPRESSION_TRAINING);
+	if (coio_call(memtx_compression_dict_train_cb, dict) == 0) {
+		dict->state = MEMTX_COMPRESSION_READY;
+	} else {
+		/* Try again with new samples. */
+		diag_log();
+		say_warn("failed to train tuple compression dictionary");
+		dict->state = MEMTX_COMPRESSION_SAMPLING;
+	}
+	memtx_compression_dict_reset_samples(dict);
+}
+
+static int
+memtx_compression_worker_f(va_list ap)
+{
+	(void)ap;
+	while (!fiber_is_cancelled()) {
+		if (rlist_empty(&memtx_compression_train_queue)) {
+			fiber_yield();
+			continue;
+		}
+		struct memtx_compression_dict *dict = rlist_shift_entry(
+			&memtx_compression_train_queue,
+			struct memtx_compression_dict, in_train_queue);
+		memtx_compression_dict_train(dict);
+		tuple_compression_dict_unref(&dict->base);
+	}
+	struct memtx_compression_dict *dict, *tmp;
+	rlist_foreach_entry_safe(dict, &memtx_compression_train_queue,
+				 in_train_queue, tmp) {
+		rlist_del_entry(dict, in_train_queue);
+		dict->state = MEMTX_COMPRESSION_SAMPLING;
+		memtx_compression_dict_reset_samples(dict);
+		tuple_compression_dict_unref(&dict->base);
+	}
+	return 0;
+}
+
+/**
+ * Queues the dictionary for training. It's done in a separate fiber,
+ * because we may not yield while executing a statement.
+ */
+static void
+memtx_compression_dict_queue_training(struct memtx_compression_dict *dict)
+{
+	assert(dict->state == MEMTX_COMPRESSION_SAMPLING);
+	if (memtx_compression_worker == NULL) {
+		/* Shutdown is in progress. */
+		memtx_compression_dict_reset_samples(dict);
+		return;
+	}
+	dict->state = MEMTX_COMPRESSION_TRAINING;
+	tuple_compression_dict_ref(&dict->base);
+	rlist_add_tail_entry(&memtx_compression_train_queue, dict,
+			     in_train_queue);
+	fiber_wakeup(memtx_compression_worker);
+}
+
+/** Adds a sample and starts training once enough have been collected. */
+static void
+memtx_compression_dict_add_sample(struct memtx_compression_dict *dict,
+				  const char *data, size_t size)
+{
+	assert(dict->state == MEMTX_COMPRESSION_SAMPLING);
+	if (dict->samples == NULL) {
+		dict->samples = xmalloc(MEMTX_COMPRESSION_SAMPLE_SIZE);
+		dict->sample_sizes = xcalloc(MEMTX_COMPRESSION_SAMPLE_COUNT,
+					     sizeof(*dict->sample_sizes));
+	}
+	if (dict->samples_size + size > MEMTX_COMPRESSION_SAMPLE_SIZE) {
+		/* Skip a sample that is too big to fit. */
+		if (dict->sample_count > 0)
+			memtx_compression_dict_queue_training(dict);
+		return;
+	}
+	memcpy(dict->samples + dict->samples_size, data, size);
+	dict->samples_size += size;
+	dict->sample_sizes[dict->sample_count++] = size;
+	if (dict->sample_count == MEMTX_COMPRESSION_SAMPLE_COUNT ||
+	    dict->samples_size + MEMTX_COMPRESSION_MIN_SIZE >
+	    MEMTX_COMPRESSION_SAMPLE_SIZE)
+		memtx_compression_dict_queue_training(dict);
+}
+
+struct tuple *
+memtx_tuple_compress(struct tuple *tuple)
+{
+	struct tuple_format *format = tuple_format(tuple);
+	assert(format->is_compressed && format->compression_dict != NULL);
+	struct memtx_compression_dict *dict = container_of(
+		format->compression_dict, struct memtx_compression_dict, base);
+	if (dict->state == MEMTX_COMPRESSION_TRAINING)
+		return tuple;
+
+	uint32_t bsize;
+	const char *data = tuple_data_range(tuple, &bsize);
+	const char *data_end = data + bsize;
+	const char *pos = data;
+	uint32_t field_count = mp_decode_array(&pos);
+	uint32_t head_field_count = format->index_field_count;
+	if (field_count <= head_field_count)
+		return tuple;
+	const char *head = pos;
+	for (uint32_t i = 0; i < head_field_count; i++)
+		mp_next(&pos);
+	const char *tail = pos;
+	size_t tail_size = data_end - tail;
+	if (tail_size < MEMTX_COMPRESSION_MIN_SIZE)
+		return tuple;
+	if (dict->state == MEMTX_COMPRESSION_SAMPLING) {
+		memtx_compression_dict_add_sample(dict, tail, tail_size);
+		return tuple;
+	}
+
+	uint32_t tail_field_count = field_count - head_field_count;
+	size_t frame_size_max = ZSTD_compressBound(tail_size);
+	size_t payload_size_max = mp_sizeof_uint(tail_field_count) +
+				  frame_size_max;
+	size_t size_max = mp_sizeof_array(head_field_count + 1) +
+			  (tail - head) + mp_sizeof_extl(payload_size_max) +
+			  payload_size_max;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	char *buf = xregion_alloc(region, size_max);
+	struct tuple *result = tuple;
+	/*
+	 * The frame is compressed past the reserved extension header and
+	 * moved to its place once its size is known.
+	 */
+	char *frame = buf + size_max - frame_size_max;
+	ZSTD_CCtx *cctx = memtx_compression_cctx;
+	ZSTD_CCtx_refCDict(cctx, dict->cdict);
+	size_t frame_size = ZSTD_compress2(cctx, frame, frame_size_max,
+					   tail, tail_size);
+	if (ZSTD_isError(frame_size)) {
+		diag_set(ClientError, ER_COMPRESSION,
+			 ZSTD_getErrorName(frame_size));
+		result = NULL;
+		goto out;
+	}
+	size_t payload_size = mp_sizeof_uint(tail_field_count) + frame_size;
+	char *p = mp_encode_array(buf, head_field_count + 1);
+	memcpy(p, head, tail - head);
+	p += tail - head;
+	p = mp_encode_extl(p, MP_COMPRESSION, payload_size);
+	p = mp_encode_uint(p, tail_field_count);
+	/* Store incompressible data as is. */
+	if ((size_t)(p - buf) + frame_size >= bsize)
+		goto out;
+	memmove(p, frame, frame_size);
+	p += frame_size;
+	result = memtx_tuple_new_raw(format, buf, p,
+				     MEMTX_TUPLE_NEW_RAW_NO_VALIDATE);
+	if (result != NULL)
+		tuple_set_flag(result, TUPLE_IS_COMPRESSED);
+out:
+	region_truncate(region, region_svp);
+	return result;
+}
+
+const char *
+memtx_tuple_decompress_raw(struct tuple_compression_dict *base,
+			   const char *data, const char *data_end,
+			   uint32_t *p_size)
+{
+	struct memtx_compression_dict *dict =
+		container_of(base, struct memtx_compression_dict, base);
+	assert(dict->state == MEMTX_COMPRESSION_READY);
+	const char *pos = data;
+	uint32_t field_count = mp_decode_array(&pos);
+	assert(field_count > 0);
+	const char *head = pos;
+	for (uint32_t i = 0; i < field_count - 1; i++)
+		mp_next(&pos);
+	const char *head_end = pos;
+	int8_t type;
+	mp_decode_extl(&pos, &type);
+	assert(type == MP_COMPRESSION);
+	uint32_t tail_field_count = mp_decode_uint(&pos);
+	const char *frame = pos;
+	size_t frame_size = data_end - frame;
+	unsigned long long tail_size =
+		ZSTD_getFrameContentSize(frame, frame_size);
+	if (tail_size == ZSTD_CONTENTSIZE_ERROR ||
+	    tail_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+		diag_set(ClientError, ER_DECOMPRESSION,
+			 "invalid compressed tuple");
+		return NULL;
+	}
+	ZSTD_DCtx *dctx = memtx_compression_dctx();
+	if (dctx == NULL)
+		return NULL;
+	uint32_t total_field_count = field_count - 1 + tail_field_count;
+	size_t size = mp_sizeof_array(total_field_count) +
+		      (head_end - head) + tail_size;
+	char *buf = xregion_alloc(&fiber()->gc, size);
+	char *p = mp_encode_array(buf, total_field_count);
+	memcpy(p, head, head_end - head);
+	p += head_end - head;
+	size_t rc = ZSTD_decompress_usingDDict(dctx, p, tail_size,
+					       frame, frame_size, dict->ddict);
+	if (ZSTD_isError(rc)) {
+		diag_set(ClientError, ER_DECOMPRESSION,
+			 ZSTD_getErrorName(rc));
+		return NULL;
+	}
+	assert(rc == tail_size);
+	*p_size = size;
+	return buf;
+}
+
+struct tuple *
+memtx_tuple_decompress(struct tuple *tuple)
+{
+	if (!tuple_is_compressed(tuple))
+		return tuple;
+	struct tuple_format *format = tuple_format(tuple);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct tuple *result = NULL;
+	uint32_t bsize;
+	const char *data = tuple_data_range(tuple, &bsize);
+	uint32_t size;
+	data = memtx_tuple_decompress_raw(format->compression_dict,
+					  data, data + bsize, &size);
+	if (data == NULL)
+		goto out;
+	result = memtx_tuple_new_raw(format, data, data + size,
+				     MEMTX_TUPLE_NEW_RAW_NO_VALIDATE |
+				     MEMTX_TUPLE_NEW_RAW_NO_TUPLE_MAX_SIZE);
+	/*
+	 * The decompressed copy isn't stored in the space so it may be
+	 * freed immediately even if there's a read view.
+	 */
+	if (result != NULL)
+		tuple_set_flag(result, TUPLE_IS_TEMPORARY);
+out:
+	region_truncate(region, region_svp);
+	return result;
+}
+
+int
+memtx_tuple_check_key_def(struct tuple *tuple, struct key_def *key_def)
+{
+	if (!tuple_is_compressed(tuple))
+		return 0;
+	uint32_t field_count = tuple_field_count(tuple) - 1;
+	for (uint32_t i = 0; i < key_def->part_count; i++) {
+		if (key_def->parts[i].fieldno >= field_count) {
+			diag_set(ClientError, ER_UNSUPPORTED,
+				 "Tuple compression",
+				 "indexing fields of compressed tuples");
+			return -1;
+		}
+	}
+	return 0;
+}
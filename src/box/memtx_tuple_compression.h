@@ -11,34 +11,90 @@
 # include "memtx_tuple_compression_impl.h"
 #else /* !defined(ENABLE_TUPLE_COMPRESSION) */
 
-#include "tuple.h"
+#include <stdint.h>
 
 #if defined(__cplusplus)
 extern "C" {
 #endif
 
-static inline struct tuple *
-memtx_tuple_compress(struct tuple *tuple)
-{
-        (void)tuple;
-        unreachable();
-        return NULL;
-}
-
-static inline struct tuple *
-memtx_tuple_decompress(struct tuple *tuple)
-{
-	assert(!tuple_is_compressed(tuple));
-	return tuple;
-}
-
-static inline const char *
-memtx_tuple_decompress_raw(const char *tuple, const char *tuple_end,
-			   uint32_t *p_size)
-{
-	*p_size = tuple_end - tuple;
-	return tuple;
-}
+struct key_def;
+struct tuple;
+struct tuple_format;
+struct tuple_compression_dict;
+
+/*
+ * Tuples of a memtx space with the 'compression' option set are stored
+ * as follows. Fields up to the last indexed one are stored as is so that
+ * indexes can compare and hash them without decompression. The rest of
+ * the fields are packed into a single MP_COMPRESSION extension holding
+ * the number of packed fields and a zstd frame compressed with a
+ * dictionary trained on samples of the space data. Compressed tuples
+ * are marked with the TUPLE_IS_COMPRESSED flag.
+ *
+ * The dictionary is trained in the background once enough samples have
+ * been collected. Tuples inserted before that are stored uncompressed.
+ */
+
+/** Initialize the tuple compression subsystem. */
+void
+memtx_tuple_compression_init(void);
+
+/** Stop the background fiber training dictionaries. Yields. */
+void
+memtx_tuple_compression_shutdown(void);
+
+/** Free the tuple compression subsystem. */
+void
+memtx_tuple_compression_free(void);
+
+/** Enable compression for tuples of a new space format. */
+void
+memtx_tuple_format_enable_compression(struct tuple_format *format);
+
+/**
+ * Make the new format of an altered space use the dictionary of its
+ * previous format, if any, so that all tuples of a space share the same
+ * dictionary and tuples compressed before alter can be decompressed.
+ */
+void
+memtx_tuple_format_inherit_compression(struct tuple_format *format,
+				       struct tuple_format *prev_format);
+
+/**
+ * Return the tuple that should be stored in the space indexes instead
+ * of the given one, which may be the given tuple itself if it isn't worth
+ * compressing or the dictionary isn't ready yet. The new tuple is
+ * unreferenced. Returns NULL and sets diag on error.
+ */
+struct tuple *
+memtx_tuple_compress(struct tuple *tuple);
+
+/**
+ * Return a tuple with the data of the given stored tuple decompressed,
+ * which may be the given tuple itself if it isn't compressed. The new
+ * tuple is unreferenced. Returns NULL and sets diag on error.
+ */
+struct tuple *
+memtx_tuple_decompress(struct tuple *tuple);
+
+/**
+ * Decompress the data of a compressed tuple with the given dictionary.
+ * The result is allocated on the fiber region, its size is returned in
+ * @a p_size. May be called from any thread. Returns NULL and sets diag
+ * on error.
+ */
+const char *
+memtx_tuple_decompress_raw(struct tuple_compression_dict *dict,
+			   const char *data, const char *data_end,
+			   uint32_t *p_size);
+
+/**
+ * Check that the given stored tuple can be inserted into an index with
+ * the given key definition, i.e. that none of the key fields is stored
+ * compressed. Returns -1 and sets diag if it isn't so.
+ */
+int
+memtx_tuple_check_key_def(struct tuple *tuple, struct key_def *key_def);
 
 #if defined(__cplusplus)
 } /* extern "C" */
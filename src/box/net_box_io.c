@@ -0,0 +1,606 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "net_box_io.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "box/error.h"
+#include "cbus.h"
+#include "coio.h"
+#include "diag.h"
+#include "fiber.h"
+#include "fiber_cond.h"
+#include "iostream.h"
+#include "msgpuck.h"
+#include "salad/stailq.h"
+#include "small/ibuf.h"
+#include "tarantool_ev.h"
+#include "trivia/util.h"
+
+enum {
+	/** Size of a read from the socket. */
+	NET_BOX_IO_READAHEAD = 16 * 1024,
+	/**
+	 * Max size of received data that hasn't been processed by the owner
+	 * thread yet. The I/O thread stops reading when it's reached.
+	 */
+	NET_BOX_IO_INPUT_MAX = 4 * 1024 * 1024,
+};
+
+/** Name of the cbus endpoint the I/O threads send messages to. */
+static const char net_box_io_endpoint_name[] = "net_box_io";
+
+struct net_box_io_thread {
+	struct cord cord;
+	/** Pipe from the owner thread to the I/O thread. */
+	struct cpipe io_pipe;
+	/** Pipe from the I/O thread to the owner thread. */
+	struct cpipe owner_pipe;
+	/** Number of connections served by the thread. */
+	int conn_count;
+};
+
+/** Array of I/O threads. */
+static struct net_box_io_thread *net_box_io_threads;
+/** Number of I/O threads. */
+static int net_box_io_thread_count;
+/** Endpoint receiving messages from the I/O threads. */
+static struct cbus_endpoint net_box_io_endpoint;
+
+struct net_box_io_conn {
+	/** Thread serving the connection. */
+	struct net_box_io_thread *thread;
+	/** The connection stream, used only by the I/O thread. */
+	struct iostream io;
+	/** Message attaching the connection to the I/O thread. */
+	struct cmsg attach_msg;
+	/** Message detaching the connection from the I/O thread. */
+	struct cmsg detach_msg;
+	/*
+	 * Members accessed only by the owner thread.
+	 */
+	/** Broadcast when all output has been sent. */
+	struct fiber_cond *on_output_empty;
+	/** Number of output messages that haven't been sent yet. */
+	int output_count;
+	/** Received messages, linked by net_box_io_msg::in_queue. */
+	struct stailq input;
+	/** Fiber waiting in net_box_io_conn_wait() or NULL. */
+	struct fiber *waiter;
+	/** Error reported by the I/O thread. */
+	struct diag diag;
+	/** Set if the I/O thread reported an error. */
+	bool is_broken;
+	/** Set by net_box_io_conn_delete(). */
+	bool is_closing;
+	/** Set when the I/O thread has released the connection. */
+	bool is_closed;
+	/*
+	 * Members accessed only by the I/O thread.
+	 */
+	/** Socket watchers. */
+	struct ev_io input_ev;
+	struct ev_io output_ev;
+	/** Data read from the socket but not framed yet. */
+	struct ibuf ibuf;
+	/** Messages to send, linked by net_box_io_msg::in_queue. */
+	struct stailq output;
+	/** Size of input passed to the owner thread and not processed yet. */
+	size_t input_size;
+	/** Set on I/O error. No I/O is done after that. */
+	bool is_failed;
+};
+
+/** Chunk of data sent or received over a connection. */
+struct net_box_io_msg {
+	struct cmsg base;
+	struct net_box_io_conn *conn;
+	/** Link in an input or output queue. */
+	struct stailq_entry in_queue;
+	/** Processed part of the data. */
+	size_t pos;
+	/** Size of the data. */
+	size_t size;
+	char data[];
+};
+
+/** Error that broke a connection. */
+struct net_box_io_error_msg {
+	struct cmsg base;
+	struct net_box_io_conn *conn;
+	struct diag diag;
+};
+
+static struct net_box_io_msg *
+net_box_io_msg_new(struct net_box_io_conn *conn, size_t size)
+{
+	struct net_box_io_msg *msg = xmalloc(sizeof(*msg) + size);
+	msg->conn = conn;
+	msg->pos = 0;
+	msg->size = size;
+	return msg;
+}
+
+static void
+net_box_io_received_f(struct cmsg *base);
+
+static void
+net_box_io_sent_f(struct cmsg *base);
+
+static void
+net_box_io_error_f(struct cmsg *base);
+
+static void
+net_box_io_detached_f(struct cmsg *base);
+
+static void
+net_box_io_push(struct net_box_io_conn *conn, struct cmsg *msg,
+		const struct cmsg_hop *route)
+{
+	cmsg_init(msg, route);
+	cpipe_push(&conn->thread->owner_pipe, msg);
+}
+
+/** Stops I/O on a connection and reports the error set in diag. */
+static void
+net_box_io_fail(struct net_box_io_conn *conn)
+{
+	static const struct cmsg_hop route[] = {
+		{net_box_io_error_f, NULL},
+	};
+	assert(!conn->is_failed);
+	conn->is_failed = true;
+	ev_io_stop(loop(), &conn->input_ev);
+	ev_io_stop(loop(), &conn->output_ev);
+	struct net_box_io_error_msg *msg = xmalloc(sizeof(*msg));
+	msg->conn = conn;
+	diag_create(&msg->diag);
+	diag_move(diag_get(), &msg->diag);
+	net_box_io_push(conn, &msg->base, route);
+}
+
+/** Sets diag for a failed socket operation. */
+static void
+net_box_io_set_io_error(void)
+{
+	struct error *e = diag_last_error(diag_get());
+	box_error_raise(ER_NO_CONNECTION, "%s", e->errmsg);
+}
+
+/**
+ * Passes complete packets accumulated in the input buffer to the owner
+ * thread. Returns -1 and sets diag if the input is malformed.
+ */
+static int
+net_box_io_flush_input(struct net_box_io_conn *conn)
+{
+	static const struct cmsg_hop route[] = {
+		{net_box_io_received_f, NULL},
+	};
+	struct ibuf *ibuf = &conn->ibuf;
+	const char *begin = ibuf->rpos;
+	const char *end = ibuf->wpos;
+	const char *pos = begin;
+	while (pos < end) {
+		const char *p = pos;
+		if (mp_typeof(*p) != MP_UINT) {
+			diag_set(ClientError, ER_INVALID_MSGPACK,
+				 "packet length");
+			return -1;
+		}
+		if (mp_check_uint(p, end) > 0)
+			break;
+		uint64_t len = mp_decode_uint(&p);
+		if (len > SIZE_MAX - (p - pos)) {
+			box_error_raise(ER_NO_CONNECTION,
+					"Response size too large");
+			return -1;
+		}
+		if (len > (uint64_t)(end - p))
+			break;
+		pos = p + len;
+	}
+	size_t size = pos - begin;
+	if (size == 0)
+		return 0;
+	struct net_box_io_msg *msg = net_box_io_msg_new(conn, size);
+	memcpy(msg->data, begin, size);
+	ibuf_consume(ibuf, size);
+	conn->input_size += size;
+	net_box_io_push(conn, &msg->base, route);
+	return 0;
+}
+
+static void
+net_box_io_on_input(struct ev_loop *loop, struct ev_io *watcher, int events)
+{
+	(void)events;
+	struct net_box_io_conn *conn = watcher->data;
+	struct ibuf *ibuf = &conn->ibuf;
+	while (true) {
+		if (conn->input_size >= NET_BOX_IO_INPUT_MAX) {
+			/* Resumed by net_box_io_processed_f(). */
+			ev_io_stop(loop, &conn->input_ev);
+			return;
+		}
+		xibuf_reserve(ibuf, NET_BOX_IO_READAHEAD);
+		ssize_t rc = iostream_read(&conn->io, ibuf->wpos,
+					   ibuf_unused(ibuf));
+		if (rc == 0) {
+			box_error_raise(ER_NO_CONNECTION, "Peer closed");
+			break;
+		}
+		if (rc == IOSTREAM_ERROR) {
+			net_box_io_set_io_error();
+			break;
+		}
+		if (rc < 0)
+			return;
+		VERIFY(ibuf_alloc(ibuf, rc) != NULL);
+		if (net_box_io_flush_input(conn) != 0)
+			break;
+	}
+	net_box_io_fail(conn);
+}
+
+/** Writes queued output until the socket would block. */
+static void
+net_box_io_flush_output(struct net_box_io_conn *conn)
+{
+	static const struct cmsg_hop route[] = {
+		{net_box_io_sent_f, NULL},
+	};
+	while (!stailq_empty(&conn->output)) {
+		struct net_box_io_msg *msg = stailq_first_entry(
+			&conn->output, struct net_box_io_msg, in_queue);
+		ssize_t rc = iostream_write(&conn->io, msg->data + msg->pos,
+					    msg->size - msg->pos);
+		if (rc == IOSTREAM_ERROR) {
+			net_box_io_set_io_error();
+			net_box_io_fail(conn);
+			return;
+		}
+		if (rc < 0) {
+			ev_io_start(loop(), &conn->output_ev);
+			return;
+		}
+		msg->pos += rc;
+		if (msg->pos < msg->size)
+			continue;
+		stailq_shift(&conn->output);
+		net_box_io_push(conn, &msg->base, route);
+	}
+	ev_io_stop(loop(), &conn->output_ev);
+}
+
+static void
+net_box_io_on_output(struct ev_loop *loop, struct ev_io *watcher, int events)
+{
+	(void)loop;
+	(void)events;
+	net_box_io_flush_output(watcher->data);
+}
+
+/** Starts serving a connection in the I/O thread. */
+static void
+net_box_io_attach_f(struct cmsg *base)
+{
+	struct net_box_io_conn *conn = container_of(
+		base, struct net_box_io_conn, attach_msg);
+	ibuf_create(&conn->ibuf, cord_slab_cache(), NET_BOX_IO_READAHEAD);
+	stailq_create(&conn->output);
+	ev_io_init(&conn->input_ev, net_box_io_on_input, conn->io.fd, EV_READ);
+	conn->input_ev.data = conn;
+	ev_io_init(&conn->output_ev, net_box_io_on_output, conn->io.fd,
+		   EV_WRITE);
+	conn->output_ev.data = conn;
+	ev_io_start(loop(), &conn->input_ev);
+}
+
+/** Stops serving a connection and hands it back to the owner thread. */
+static void
+net_box_io_detach_f(struct cmsg *base)
+{
+	static const struct cmsg_hop route[] = {
+		{net_box_io_detached_f, NULL},
+	};
+	struct net_box_io_conn *conn = container_of(
+		base, struct net_box_io_conn, detach_msg);
+	ev_io_stop(loop(), &conn->input_ev);
+	ev_io_stop(loop(), &conn->output_ev);
+	struct net_box_io_msg *msg, *tmp;
+	stailq_foreach_entry_safe(msg, tmp, &conn->output, in_queue)
+		free(msg);
+	stailq_create(&conn->output);
+	ibuf_destroy(&conn->ibuf);
+	net_box_io_push(conn, &conn->detach_msg, route);
+}
+
+/** Queues output in the I/O thread. */
+static void
+net_box_io_output_f(struct cmsg *base)
+{
+	struct net_box_io_msg *msg = (struct net_box_io_msg *)base;
+	struct net_box_io_conn *conn = msg->conn;
+	bool was_empty = stailq_empty(&conn->output);
+	stailq_add_tail_entry(&conn->output, msg, in_queue);
+	/* Output of a failed connection is freed on detach. */
+	if (!conn->is_failed && was_empty)
+		net_box_io_flush_output(conn);
+}
+
+/** Frees input processed by the owner thread and resumes reading. */
+static void
+net_box_io_processed_f(struct cmsg *base)
+{
+	struct net_box_io_msg *msg = (struct net_box_io_msg *)base;
+	struct net_box_io_conn *conn = msg->conn;
+	assert(conn->input_size >= msg->size);
+	conn->input_size -= msg->size;
+	free(msg);
+	if (!conn->is_failed && conn->input_size < NET_BOX_IO_INPUT_MAX)
+		ev_io_start(loop(), &conn->input_ev);
+}
+
+/*
+ * Callbacks executed in the owner thread.
+ */
+
+static void
+net_box_io_wakeup(struct net_box_io_conn *conn)
+{
+	if (conn->waiter != NULL)
+		fiber_wakeup(conn->waiter);
+}
+
+static void
+net_box_io_received_f(struct cmsg *base)
+{
+	struct net_box_io_msg *msg = (struct net_box_io_msg *)base;
+	struct net_box_io_conn *conn = msg->conn;
+	if (conn->is_closing) {
+		free(msg);
+		return;
+	}
+	stailq_add_tail_entry(&conn->input, msg, in_queue);
+	net_box_io_wakeup(conn);
+}
+
+static void
+net_box_io_sent_f(struct cmsg *base)
+{
+	struct net_box_io_msg *msg = (struct net_box_io_msg *)base;
+	struct net_box_io_conn *conn = msg->conn;
+	free(msg);
+	assert(conn->output_count > 0);
+	if (--conn->output_count == 0)
+		fiber_cond_broadcast(conn->on_output_empty);
+}
+
+static void
+net_box_io_error_f(struct cmsg *base)
+{
+	struct net_box_io_error_msg *msg = (struct net_box_io_error_msg *)base;
+	struct net_box_io_conn *conn = msg->conn;
+	assert(!conn->is_broken);
+	diag_move(&msg->diag, &conn->diag);
+	diag_destroy(&msg->diag);
+	free(msg);
+	conn->is_broken = true;
+	net_box_io_wakeup(conn);
+}
+
+static void
+net_box_io_detached_f(struct cmsg *base)
+{
+	struct net_box_io_conn *conn = container_of(
+		base, struct net_box_io_conn, detach_msg);
+	conn->is_closed = true;
+	net_box_io_wakeup(conn);
+}
+
+/** Returns processed input to the I/O thread. */
+static void
+net_box_io_msg_release(struct net_box_io_conn *conn,
+		       struct net_box_io_msg *msg)
+{
+	static const struct cmsg_hop route[] = {
+		{net_box_io_processed_f, NULL},
+	};
+	cmsg_init(&msg->base, route);
+	cpipe_push(&conn->thread->io_pipe, &msg->base);
+}
+
+struct net_box_io_conn *
+net_box_io_conn_new(struct iostream *io, struct fiber_cond *on_output_empty)
+{
+	static const struct cmsg_hop route[] = {
+		{net_box_io_attach_f, NULL},
+	};
+	assert(net_box_io_is_enabled());
+	assert(cord_is_main());
+	struct net_box_io_thread *thread = &net_box_io_threads[0];
+	for (int i = 1; i < net_box_io_thread_count; i++) {
+		if (net_box_io_threads[i].conn_count < thread->conn_count)
+			thread = &net_box_io_threads[i];
+	}
+	thread->conn_count++;
+	struct net_box_io_conn *conn = xcalloc(1, sizeof(*conn));
+	conn->thread = thread;
+	iostream_move(&conn->io, io);
+	conn->on_output_empty = on_output_empty;
+	stailq_create(&conn->input);
+	diag_create(&conn->diag);
+	cmsg_init(&conn->attach_msg, route);
+	cpipe_push(&thread->io_pipe, &conn->attach_msg);
+	return conn;
+}
+
+void
+net_box_io_conn_delete(struct net_box_io_conn *conn, struct iostream *io)
+{
+	static const struct cmsg_hop route[] = {
+		{net_box_io_detach_f, NULL},
+	};
+	assert(!conn->is_closing);
+	conn->is_closing = true;
+	/* Received data won't be processed so free it right away. */
+	struct net_box_io_msg *msg, *tmp;
+	stailq_foreach_entry_safe(msg, tmp, &conn->input, in_queue)
+		free(msg);
+	stailq_create(&conn->input);
+	cmsg_init(&conn->detach_msg, route);
+	cpipe_push(&conn->thread->io_pipe, &conn->detach_msg);
+	while (!conn->is_closed)
+		net_box_io_conn_wait(conn);
+	/* Output left in the I/O thread was discarded on detach. */
+	if (conn->output_count > 0) {
+		conn->output_count = 0;
+		fiber_cond_broadcast(conn->on_output_empty);
+	}
+	conn->thread->conn_count--;
+	iostream_move(io, &conn->io);
+	diag_destroy(&conn->diag);
+	free(conn);
+}
+
+void
+net_box_io_conn_write(struct net_box_io_conn *conn, struct ibuf *buf)
+{
+	static const struct cmsg_hop route[] = {
+		{net_box_io_output_f, NULL},
+	};
+	size_t size = ibuf_used(buf);
+	assert(size > 0);
+	struct net_box_io_msg *msg = net_box_io_msg_new(conn, size);
+	memcpy(msg->data, buf->rpos, size);
+	ibuf_reset(buf);
+	conn->output_count++;
+	cmsg_init(&msg->base, route);
+	cpipe_push(&conn->thread->io_pipe, &msg->base);
+}
+
+bool
+net_box_io_conn_has_output(struct net_box_io_conn *conn)
+{
+	return conn->output_count > 0;
+}
+
+int
+net_box_io_conn_read(struct net_box_io_conn *conn, const char **data,
+		     const char **data_end)
+{
+	while (!stailq_empty(&conn->input)) {
+		struct net_box_io_msg *msg = stailq_first_entry(
+			&conn->input, struct net_box_io_msg, in_queue);
+		if (msg->pos < msg->size) {
+			/* The packet was validated by the I/O thread. */
+			const char *p = msg->data + msg->pos;
+			uint64_t len = mp_decode_uint(&p);
+			*data = p;
+			*data_end = p + len;
+			msg->pos = *data_end - msg->data;
+			return 1;
+		}
+		stailq_shift(&conn->input);
+		net_box_io_msg_release(conn, msg);
+	}
+	if (conn->is_broken) {
+		diag_set_error(diag_get(), diag_last_error(&conn->diag));
+		return -1;
+	}
+	return 0;
+}
+
+void
+net_box_io_conn_wait(struct net_box_io_conn *conn)
+{
+	assert(conn->waiter == NULL);
+	conn->waiter = fiber();
+	fiber_yield();
+	conn->waiter = NULL;
+}
+
+static int
+net_box_io_thread_f(va_list ap)
+{
+	struct net_box_io_thread *thread = va_arg(ap, struct net_box_io_thread *);
+	struct cbus_endpoint endpoint;
+	cbus_endpoint_create(&endpoint, cord_name(cord()),
+			     fiber_schedule_cb, fiber());
+	cpipe_create(&thread->owner_pipe, net_box_io_endpoint_name);
+	cbus_loop(&endpoint);
+	cpipe_destroy(&thread->owner_pipe);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	return 0;
+}
+
+static void
+net_box_io_endpoint_cb(struct ev_loop *loop, ev_watcher *watcher, int events)
+{
+	(void)loop;
+	(void)events;
+	struct cbus_endpoint *endpoint = watcher->data;
+	cbus_process(endpoint);
+}
+
+void
+net_box_io_init(int thread_count)
+{
+	assert(cord_is_main());
+	assert(net_box_io_threads == NULL);
+	assert(thread_count >= 0 && thread_count <= NET_BOX_IO_THREADS_MAX);
+	if (thread_count == 0)
+		return;
+	cbus_endpoint_create(&net_box_io_endpoint, net_box_io_endpoint_name,
+			     net_box_io_endpoint_cb, &net_box_io_endpoint);
+	net_box_io_threads = xcalloc(thread_count,
+				     sizeof(*net_box_io_threads));
+	for (int i = 0; i < thread_count; i++) {
+		struct net_box_io_thread *thread = &net_box_io_threads[i];
+		char name[FIBER_NAME_INLINE];
+		snprintf(name, sizeof(name), "net_box_io%d", i + 1);
+		if (cord_costart(&thread->cord, name, net_box_io_thread_f,
+				 thread) != 0)
+			panic("failed to start net.box I/O thread");
+		cpipe_create(&thread->io_pipe, name);
+	}
+	net_box_io_thread_count = thread_count;
+}
+
+void
+net_box_io_free(void)
+{
+	assert(cord_is_main());
+	if (net_box_io_thread_count == 0)
+		return;
+	for (int i = 0; i < net_box_io_thread_count; i++) {
+		struct net_box_io_thread *thread = &net_box_io_threads[i];
+		cbus_stop_loop(&thread->io_pipe);
+		cpipe_destroy(&thread->io_pipe);
+		if (cord_join(&thread->cord) != 0)
+			panic_syserror("net.box I/O thread join failed");
+	}
+	/*
+	 * The threads have destroyed their pipes to the owner thread
+	 * before exiting, so this doesn't wait.
+	 */
+	cbus_endpoint_destroy(&net_box_io_endpoint, cbus_process);
+	free(net_box_io_threads);
+	net_box_io_threads = NULL;
+	net_box_io_thread_count = 0;
+}
+
+bool
+net_box_io_is_enabled(void)
+{
+	return net_box_io_thread_count > 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct fiber_cond;
+struct ibuf;
+struct iostream;
+
+/**
+ * net.box I/O threads.
+ *
+ * By default, a net.box connection reads and writes its socket and splits
+ * the input stream into packets in the thread that owns the connection
+ * (usually tx). If I/O threads are enabled, a connected socket is passed
+ * to one of them. The I/O thread sends data queued by the owner thread and
+ * reads responses, handing over only complete packets, so the owner thread
+ * is left with encoding requests and decoding responses.
+ */
+
+enum {
+	NET_BOX_IO_THREADS_MAX = 1000,
+};
+
+/** Connection served by an I/O thread. */
+struct net_box_io_conn;
+
+/**
+ * Starts I/O threads. If the thread count is 0, I/O threads are disabled.
+ * Must be called from the main thread.
+ */
+void
+net_box_io_init(int thread_count);
+
+/**
+ * Stops I/O threads and frees their resources. Connections still served
+ * by the threads are abandoned. Must be called from the main thread.
+ */
+void
+net_box_io_free(void);
+
+/** Returns true if I/O threads are enabled. */
+bool
+net_box_io_is_enabled(void);
+
+/**
+ * Passes a connected stream to an I/O thread. The stream is moved to the
+ * connection object. The condition variable is broadcast when all data
+ * passed to net_box_io_conn_write() has been sent.
+ */
+struct net_box_io_conn *
+net_box_io_conn_new(struct iostream *io, struct fiber_cond *on_output_empty);
+
+/**
+ * Takes the stream back from the I/O thread and frees the connection.
+ * Data that hasn't been sent yet is discarded. Waits for the I/O thread
+ * to release the connection, ignoring fiber cancellation.
+ */
+void
+net_box_io_conn_delete(struct net_box_io_conn *conn, struct iostream *io);
+
+/**
+ * Queues the content of the given buffer for sending. The buffer is
+ * reset. Never fails.
+ */
+void
+net_box_io_conn_write(struct net_box_io_conn *conn, struct ibuf *buf);
+
+/** Returns true if some data passed for sending hasn't been sent yet. */
+bool
+net_box_io_conn_has_output(struct net_box_io_conn *conn);
+
+/**
+ * Fetches the next received packet without waiting. On success, returns 1
+ * and sets the given pointers to the packet body (without the length
+ * prefix), which stays valid until the next call. Returns 0 if there's
+ * no complete packet. If the connection is broken, returns -1 and sets
+ * diag.
+ */
+int
+net_box_io_conn_read(struct net_box_io_conn *conn, const char **data,
+		     const char **data_end);
+
+/**
+ * Waits until a packet is received or the connection is broken.
+ * The wait may also be interrupted by fiber_wakeup().
+ */
+void
+net_box_io_conn_wait(struct net_box_io_conn *conn);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
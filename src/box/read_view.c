@@ -96,6 +96,8 @@ space_read_view_delete(struct space_read_view *space_rv)
 	}
 	if (space_rv->upgrade != NULL)
 		space_upgrade_read_view_delete(space_rv->upgrade);
+	if (space_rv->compression_dict != NULL)
+		tuple_compression_dict_unref(space_rv->compression_dict);
 	TRASH(space_rv);
 	free(space_rv);
 }
@@ -144,6 +146,9 @@ space_read_view_new(struct space *space, const struct read_view_opts *opts)
 		space_rv->upgrade = NULL;
 	}
 	space_rv->engine = space->engine;
+	space_rv->compression_dict = space->format->compression_dict;
+	if (space_rv->compression_dict != NULL)
+		tuple_compression_dict_ref(space_rv->compression_dict);
 	space_rv->index_id_max = space->index_id_max;
 	memset(space_rv->index_map, 0, index_map_size);
 	space_rv->index_count = 0;
@@ -29,6 +29,7 @@ struct space_upgrade_read_view;
 struct space_upgrade_read_view_handle;
 struct tuple;
 struct tuple_format;
+struct tuple_compression_dict;
 
 /** Read view of a space. */
 struct space_read_view {
@@ -42,6 +43,11 @@ struct space_read_view {
 	char *name;
 	/** Space engine */
 	struct engine *engine;
+	/**
+	 * Dictionary used to compress tuples of this space or NULL.
+	 * Referenced. See tuple_format::compression_dict.
+	 */
+	struct tuple_compression_dict *compression_dict;
 	/**
 	 * Tuple field definition array used by this space. Allocated only if
 	 * read_view_opts::enable_field_names is set, otherwise set to NULL.
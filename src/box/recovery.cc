@@ -38,6 +38,7 @@
 #include "xrow.h"
 #include "xstream.h"
 #include "wal.h" /* wal_watcher */
+#include "wal_ring.h"
 #include "replication.h"
 #include "session.h"
 #include "coio_file.h"
@@ -243,6 +244,78 @@ recovery_delete(struct recovery *r)
 	free(r);
 }
 
+/**
+ * Account a row read from a WAL in the stream statistics and unblock
+ * the event loop if enough rows have been processed since the last
+ * yield.
+ */
+static void
+recovery_account_row(struct recovery *r, struct xstream *stream,
+		     const struct xrow_header *row)
+{
+	++stream->row_count;
+	stream->row_bytes_since_yield += xrow_approx_len(row);
+	if (stream->row_bytes_since_yield > xlog_row_bytes_per_yield) {
+		xstream_yield(stream);
+	}
+	if (stream->row_count % 100000 == 0 &&
+	    !(r->flags & RECOVERY_SUPPRESS_LOGGING)) {
+		say_info_ratelimited("%.1fM rows processed",
+				     stream->row_count / 1e6);
+	}
+}
+
+/**
+ * Write a row read from a WAL to the stream and promote the recovery
+ * vclock. @a is_sending_tx is set if the row belongs to a transaction
+ * that hasn't been fully written yet.
+ */
+static void
+recovery_write_row(struct recovery *r, struct xstream *stream,
+		   struct xrow_header *row, bool *is_sending_tx)
+{
+	/*
+	 * All rows in xlog files have an assigned replica
+	 * id. The only exception are local rows, which
+	 * are signed with a zero replica id.
+	 */
+	assert(row->replica_id != 0 || row->group_id == GROUP_LOCAL);
+	int64_t current_lsn = vclock_get(&r->vclock, row->replica_id);
+	if (row->lsn <= current_lsn) {
+		/*
+		 * Skip the already applied row, if it is not needed to
+		 * preserve transaction boundaries (is not the last row
+		 * of a currently recovered transaction). Otherwise,
+		 * replace it with a NOP, so that the transaction end
+		 * flag reaches the receiver, but the data isn't
+		 * recovered twice.
+		 */
+		if (!*is_sending_tx || !row->is_commit)
+			return; /* already applied, skip */
+		row->type = IPROTO_NOP;
+		row->bodycnt = 0;
+		row->body[0].iov_base = NULL;
+		row->body[0].iov_len = 0;
+	} else {
+		/*
+		 * We can promote the vclock either before or
+		 * after xstream_write(): it only makes any impact
+		 * in case of forced recovery, when we skip the
+		 * failed row anyway.
+		 */
+		vclock_follow_xrow(&r->vclock, row);
+	}
+	*is_sending_tx = !row->is_commit;
+	if (xstream_write(stream, row) != 0) {
+		if (!(r->flags & RECOVERY_IGNORE_ERRORS))
+			diag_raise();
+
+		say_error("skipping row {%u: %lld}",
+			  (unsigned)row->replica_id, (long long)row->lsn);
+		diag_log();
+	}
+}
+
 /**
  * Read all rows in a file starting from the last position.
  * Advance the position. If end of file is reached,
@@ -258,16 +331,7 @@ recover_xlog(struct recovery *r, struct xstream *stream,
 	bool is_sending_tx = false;
 	while (xlog_cursor_next_xc(&r->cursor, &row,
 				   (r->flags & RECOVERY_IGNORE_ERRORS)) == 0) {
-		++stream->row_count;
-		stream->row_bytes_since_yield += xrow_approx_len(&row);
-		if (stream->row_bytes_since_yield > xlog_row_bytes_per_yield) {
-			xstream_yield(stream);
-		}
-		if (stream->row_count % 100000 == 0 &&
-		    !(r->flags & RECOVERY_SUPPRESS_LOGGING)) {
-			say_info_ratelimited("%.1fM rows processed",
-					     stream->row_count / 1e6);
-		}
+		recovery_account_row(r, stream, &row);
 		/*
 		 * Read the next row from xlog file.
 		 *
@@ -279,47 +343,7 @@ recover_xlog(struct recovery *r, struct xstream *stream,
 		if (stop_vclock != NULL &&
 		    r->vclock.signature >= stop_vclock->signature)
 			return;
-
-		/*
-		 * All rows in xlog files have an assigned replica
-		 * id. The only exception are local rows, which
-		 * are signed with a zero replica id.
-		 */
-		assert(row.replica_id != 0 || row.group_id == GROUP_LOCAL);
-		int64_t current_lsn = vclock_get(&r->vclock, row.replica_id);
-		if (row.lsn <= current_lsn) {
-			/*
-			 * Skip the already applied row, if it is not needed to
-			 * preserve transaction boundaries (is not the last row
-			 * of a currently recovered transaction). Otherwise,
-			 * replace it with a NOP, so that the transaction end
-			 * flag reaches the receiver, but the data isn't
-			 * recovered twice.
-			 */
-			if (!is_sending_tx || !row.is_commit)
-				continue; /* already applied, skip */
-			row.type = IPROTO_NOP;
-			row.bodycnt = 0;
-			row.body[0].iov_base = NULL;
-			row.body[0].iov_len = 0;
-		} else {
-			/*
-			 * We can promote the vclock either before or
-			 * after xstream_write(): it only makes any impact
-			 * in case of forced recovery, when we skip the
-			 * failed row anyway.
-			 */
-			vclock_follow_xrow(&r->vclock, &row);
-		}
-		is_sending_tx = !row.is_commit;
-		if (xstream_write(stream, &row) != 0) {
-			if (!(r->flags & RECOVERY_IGNORE_ERRORS))
-				diag_raise();
-
-			say_error("skipping row {%u: %lld}",
-				  (unsigned)row.replica_id, (long long)row.lsn);
-			diag_log();
-		}
+		recovery_write_row(r, stream, &row, &is_sending_tx);
 	}
 }
 
@@ -390,6 +414,37 @@ recover_remaining_wals(struct recovery *r, struct xstream *stream,
 		tnt_raise(XlogGapError, &r->vclock, stop_vclock);
 }
 
+void
+recover_from_wal_ring(struct recovery *r, struct xstream *stream,
+		      struct wal_ring *ring)
+{
+	if (!xlog_cursor_is_open(&r->cursor) ||
+	    xlog_cursor_is_eof(&r->cursor) ||
+	    !xlog_cursor_is_tx_done(&r->cursor))
+		return;
+	int64_t file_signature = vclock_sum(&r->cursor.meta.vclock);
+	while (true) {
+		RegionGuard region_guard(&fiber()->gc);
+		struct wal_ring_batch batch;
+		if (wal_ring_read(ring, file_signature,
+				  xlog_cursor_pos(&r->cursor),
+				  &r->wal_ring_pos, &fiber()->gc,
+				  &batch) != 0)
+			break;
+		bool is_sending_tx = false;
+		const char *data = batch.data;
+		const char *data_end = data + batch.size;
+		while (data < data_end) {
+			struct xrow_header row;
+			if (xrow_decode(&row, &data, data_end, false) != 0)
+				diag_raise();
+			recovery_account_row(r, stream, &row);
+			recovery_write_row(r, stream, &row, &is_sending_tx);
+		}
+		xlog_cursor_skip_to(&r->cursor, batch.file_end);
+	}
+}
+
 void
 recovery_finalize(struct recovery *r)
 {
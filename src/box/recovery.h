@@ -42,6 +42,7 @@ extern "C" {
 
 struct xrow_header;
 struct xstream;
+struct wal_ring;
 
 enum recovery_flag {
 	/**
@@ -73,6 +74,8 @@ struct recovery {
 	struct fiber *watcher;
 	/** List of triggers invoked when the current WAL is closed. */
 	struct rlist on_close_log;
+	/** Read position hint for the WAL ring, see wal_ring_read(). */
+	uint64_t wal_ring_pos;
 };
 
 struct recovery *
@@ -121,4 +124,19 @@ void
 recover_remaining_wals(struct recovery *r, struct xstream *stream,
 		       const struct vclock *stop_vclock, bool scan_dir);
 
+/**
+ * Read the rows appended to the current WAL since the last call
+ * from the given WAL ring instead of the WAL file and advance the
+ * WAL cursor past them.
+ *
+ * Stops as soon as the ring doesn't have the rows following the
+ * current cursor position, e.g. because the reader is lagging
+ * behind or the WAL has been rotated. The caller is supposed to
+ * call recover_remaining_wals() after this function to read the
+ * rest from the disk.
+ */
+void
+recover_from_wal_ring(struct recovery *r, struct xstream *stream,
+		      struct wal_ring *ring);
+
 #endif /* TARANTOOL_RECOVERY_H_INCLUDED */
@@ -794,6 +794,13 @@ relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 		return;
 	}
 	try {
+		/*
+		 * Try to take the new rows from memory first and
+		 * read the file only for what's left, if anything.
+		 */
+		struct wal_ring *ring = wal_get_ring();
+		if (ring != NULL)
+			recover_from_wal_ring(relay->r, &relay->stream, ring);
 		recover_remaining_wals(relay->r, &relay->stream, NULL,
 				       (events & WAL_EVENT_ROTATE) != 0);
 	} catch (Exception *e) {
@@ -62,6 +62,7 @@ double replication_sync_lag = 10.0; /* seconds */
 int replication_synchro_quorum = 1;
 int replication_linearizable_quorum = 1;
 double replication_synchro_timeout = 5.0; /* seconds */
+double replication_synchro_confirm_delay = 0.0; /* seconds */
 double replication_sync_timeout = 300.0; /* seconds */
 bool replication_skip_conflict = false;
 int replication_threads = 1;
@@ -239,6 +239,12 @@ extern int replication_linearizable_quorum;
  */
 extern double replication_synchro_timeout;
 
+/**
+ * Max time in seconds a CONFIRM request may wait for another WAL write to be
+ * written together with it. 0 means CONFIRM is written right away.
+ */
+extern double replication_synchro_confirm_delay;
+
 /**
  * Part of internal.tweaks.replication_synchro_timeout_rollback_enabled.
  * Indicates whether the replication_synchro_timeout option rolls back
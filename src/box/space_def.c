@@ -46,6 +46,8 @@ const struct space_opts space_opts_default = {
 	/* .view = */ false,
 	/* .is_sync = */ false,
 	/* .defer_deletes = */ false,
+	/* .compression = */ SPACE_COMPRESSION_NONE,
+	/* .stale_read = */ false,
 	/* .sql        = */ NULL,
 	/* .constraint_def = */ NULL,
 	/* .constraint_count = */ 0,
@@ -98,6 +100,9 @@ const struct opt_def space_opts_reg[] = {
 	OPT_DEF("view", OPT_BOOL, struct space_opts, is_view),
 	OPT_DEF("is_sync", OPT_BOOL, struct space_opts, is_sync),
 	OPT_DEF("defer_deletes", OPT_BOOL, struct space_opts, defer_deletes),
+	OPT_DEF_ENUM("compression", space_compression, struct space_opts,
+		     compression, NULL),
+	OPT_DEF("stale_read", OPT_BOOL, struct space_opts, stale_read),
 	OPT_DEF("sql", OPT_STRPTR, struct space_opts, sql),
 	OPT_DEF_CUSTOM("constraint", space_opts_parse_constraint),
 	OPT_DEF_CUSTOM("foreign_key", space_opts_parse_foreign_key),
@@ -309,6 +314,11 @@ const char *space_type_strs[] = {
 	/* [SPACE_TYPE_TEMPORARY]      = */ "temporary",
 };
 
+const char *space_compression_strs[] = {
+	/* [SPACE_COMPRESSION_NONE] = */ "none",
+	/* [SPACE_COMPRESSION_ZSTD] = */ "zstd",
+};
+
 static int
 space_opts_parse_type(const char **data, void *vopts, struct region *region)
 {
@@ -67,6 +67,16 @@ space_type_name(enum space_type space_type)
 	return space_type_strs[space_type];
 }
 
+/** Space tuple compression names. */
+extern const char *space_compression_strs[];
+
+/** See space_opts::compression. */
+enum space_compression {
+	SPACE_COMPRESSION_NONE = 0,
+	SPACE_COMPRESSION_ZSTD = 1,
+	space_compression_MAX,
+};
+
 /** Space options */
 struct space_opts {
 	/**
@@ -112,6 +122,18 @@ struct space_opts {
 	 * which should speed up writes, but may also slow down reads.
 	 */
 	bool defer_deletes;
+	/**
+	 * If set to SPACE_COMPRESSION_ZSTD, a memtx space trains a zstd
+	 * dictionary on the stored tuples and keeps fields that aren't
+	 * indexed compressed with it, see memtx_tuple_compression.h.
+	 */
+	enum space_compression compression;
+	/**
+	 * If set, IPROTO threads may serve SELECT requests for a memtx
+	 * space from a periodically refreshed read view instead of
+	 * forwarding them to tx, see box.cfg.iproto_stale_read_max_lag.
+	 */
+	bool stale_read;
 	/** SQL statement that produced this space. */
 	char *sql;
 	/** Array of constraints. Can be NULL if constraints_count == 0. */
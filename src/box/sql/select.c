@@ -1623,6 +1623,19 @@ sql_key_info_new(uint32_t part_count)
 	return key_info;
 }
 
+struct sql_key_info *
+sql_key_info_new_from_key_def(const struct key_def *key_def)
+{
+	struct sql_key_info *key_info = sql_key_info_new(key_def->part_count);
+	for (uint32_t i = 0; i < key_def->part_count; i++) {
+		struct key_part_def *part = &key_info->parts[i];
+		part->type = key_def->parts[i].type;
+		part->coll_id = key_def->parts[i].coll_id;
+		part->sort_order = key_def->parts[i].sort_order;
+	}
+	return key_info;
+}
+
 struct sql_key_info *
 sql_key_info_ref(struct sql_key_info *key_info)
 {
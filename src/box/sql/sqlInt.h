@@ -4117,6 +4117,13 @@ rename_trigger(char const *sql_stmt, char const *table_name, bool *is_quoted);
 ssize_t
 sql_index_tuple_size(struct space *space, struct index *idx);
 
+/**
+ * Allocate a key_info object with parts of the given key definition.
+ * The i-th part of the new object refers to the i-th field of a record.
+ */
+struct sql_key_info *
+sql_key_info_new_from_key_def(const struct key_def *key_def);
+
 /**
  * Increment the reference counter of a key_info object.
  */
@@ -1914,6 +1914,10 @@ case OP_Column: {
 			} else {
 				goto op_column_out;
 			}
+		} else if (pC->eCurType == CURTYPE_HASH) {
+			uint32_t size;
+			const char *data = vdbe_hash_row(pC->uc.hash, &size);
+			vdbe_field_ref_prepare_data(&pC->field_ref, data, size);
 		} else {
 			pCrsr = pC->uc.pCursor;
 			assert(pC->eCurType==CURTYPE_TARANTOOL);
@@ -1927,7 +1931,8 @@ case OP_Column: {
 		pC->cacheStatus = p->cacheCtr;
 	}
 	assert(pC->eCurType == CURTYPE_TARANTOOL ||
-	       pC->eCurType == CURTYPE_PSEUDO);
+	       pC->eCurType == CURTYPE_PSEUDO ||
+	       pC->eCurType == CURTYPE_HASH);
 	struct Mem *default_val_mem =
 		pOp->p4type == P4_MEM ? pOp->p4.pMem : NULL;
 	if (vdbe_field_ref_fetch(&pC->field_ref, p2, pDest) != 0)
@@ -1944,6 +1949,8 @@ case OP_Column: {
 	/* Currently PSEUDO cursor does not have info about field types. */
 	if (pC->eCurType == CURTYPE_TARANTOOL)
 		field_type = pC->uc.pCursor->space->def->fields[p2].type;
+	else if (pC->eCurType == CURTYPE_HASH)
+		field_type = pC->key_def->parts[p2].type;
 	if (field_type == FIELD_TYPE_ANY)
 		pDest->flags |= MEM_Any;
 	else if (field_type == FIELD_TYPE_SCALAR)
@@ -2575,6 +2582,124 @@ case OP_OpenPseudo: {
 	break;
 }
 
+/* Opcode: HashOpen P1 P2 * P4 *
+ * Synopsis: key=P2 fields
+ *
+ * Open a new cursor P1 to a hash table built for a join. P4 is a
+ * KeyInfo structure that describes fields of rows inserted into the
+ * table. The first P2 fields of a row form its key.
+ *
+ * Rows are inserted by OP_HashInsert. Use OP_HashSeek and OP_HashNext
+ * to iterate over rows with the given key. The only other opcodes that
+ * work with a hash cursor are OP_Column and OP_NullRow.
+ */
+case OP_HashOpen: {
+	assert(pOp->p1 >= 0);
+	assert(pOp->p2 > 0);
+	assert(pOp->p4type == P4_KEYINFO);
+	struct key_def *def = sql_key_info_to_key_def(pOp->p4.key_info);
+	if (def == NULL)
+		goto abort_due_to_error;
+	assert((uint32_t)pOp->p2 <= def->part_count);
+	struct VdbeCursor *cur = allocateCursor(p, pOp->p1, def->part_count,
+						CURTYPE_HASH);
+	cur->key_def = def;
+	cur->nullRow = 1;
+	cur->uc.hash = vdbe_hash_new(def, pOp->p2);
+	if (cur->uc.hash == NULL)
+		goto abort_due_to_error;
+	break;
+}
+
+/* Opcode: HashInsert P1 P2 * * *
+ * Synopsis: key=r[P2]
+ *
+ * Register P2 holds a record constructed by MakeRecord. Insert the
+ * record into the hash table of cursor P1. Records with NULL in any
+ * key field are skipped. If the table would exceed the memory limit
+ * set by the sql_hash_join_memory_max tweak, its rows are moved to an
+ * ephemeral space, which is then used instead of the table.
+ */
+case OP_HashInsert: {        /* in2 */
+	assert(pOp->p1 >= 0 && pOp->p1 < p->nCursor);
+	struct VdbeCursor *cur = p->apCsr[pOp->p1];
+	assert(cur != NULL && cur->eCurType == CURTYPE_HASH);
+	struct Mem *mem = &aMem[pOp->p2];
+	assert(mem_is_bin(mem));
+	if (vdbe_hash_insert(cur->uc.hash, mem->z, mem->n) != 0)
+		goto abort_due_to_error;
+	break;
+}
+
+/* Opcode: HashSeek P1 P2 P3 P4 *
+ * Synopsis: key=r[P3@P4]
+ *
+ * Position hash cursor P1 at the first row which key is equal to the
+ * key formed by P4 registers starting from P3. If there is no such row,
+ * jump to P2.
+ */
+case OP_HashSeek: {        /* jump, in3 */
+	assert(pOp->p1 >= 0 && pOp->p1 < p->nCursor);
+	struct VdbeCursor *cur = p->apCsr[pOp->p1];
+	assert(cur != NULL && cur->eCurType == CURTYPE_HASH);
+	assert(pOp->p4type == P4_INT32);
+	uint32_t len = pOp->p4.i;
+	assert(len > 0 && len <= cur->key_def->part_count);
+	cur->nullRow = 1;
+	cur->cacheStatus = CACHE_STALE;
+	struct Mem *mems = &aMem[pOp->p3];
+	for (uint32_t i = 0; i < len; ++i) {
+		enum field_type type = cur->key_def->parts[i].type;
+		struct Mem *mem = &mems[i];
+		if (mem_is_field_compatible(mem, type))
+			continue;
+		if (!sql_type_is_numeric(type) || !mem_is_num(mem)) {
+			diag_set(ClientError, ER_SQL_TYPE_MISMATCH,
+				 mem_str(mem), field_type_strs[type]);
+			goto abort_due_to_error;
+		}
+		/* Nothing is equal to a value that can't be cast exactly. */
+		if (mem_cast_implicit_number(mem, type) != 0)
+			goto jump_to_p2;
+	}
+	struct region *region = &fiber()->gc;
+	size_t svp = region_used(region);
+	uint32_t size;
+	const char *key = mem_encode_array(mems, len, &size, region);
+	if (key == NULL)
+		goto abort_due_to_error;
+	mp_decode_array(&key);
+	bool found;
+	int rc = vdbe_hash_seek(cur->uc.hash, key, &found);
+	region_truncate(region, svp);
+	if (rc != 0)
+		goto abort_due_to_error;
+	if (!found)
+		goto jump_to_p2;
+	cur->nullRow = 0;
+	break;
+}
+
+/* Opcode: HashNext P1 P2 * * *
+ *
+ * Advance hash cursor P1 to the next row with the key passed to the
+ * last OP_HashSeek and jump to P2. If there are no more such rows, fall
+ * through to the next instruction.
+ */
+case OP_HashNext: {        /* jump */
+	assert(pOp->p1 >= 0 && pOp->p1 < p->nCursor);
+	struct VdbeCursor *cur = p->apCsr[pOp->p1];
+	assert(cur != NULL && cur->eCurType == CURTYPE_HASH);
+	cur->cacheStatus = CACHE_STALE;
+	bool found;
+	if (vdbe_hash_next(cur->uc.hash, &found) != 0)
+		goto abort_due_to_error;
+	if (found)
+		goto jump_to_p2;
+	cur->nullRow = 1;
+	break;
+}
+
 /* Opcode: Close P1 * * * *
  *
  * Close a cursor previously opened as P1.  If P1 is not
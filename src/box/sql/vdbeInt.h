@@ -60,6 +60,7 @@ typedef struct VdbeSorter VdbeSorter;
 #define CURTYPE_TARANTOOL   0
 #define CURTYPE_SORTER      1
 #define CURTYPE_PSEUDO      2
+#define CURTYPE_HASH        3
 
 /*
  * A VdbeCursor is an superclass (a wrapper) for various cursor objects:
@@ -68,6 +69,7 @@ typedef struct VdbeSorter VdbeSorter;
  *          -  On either an ephemeral or ordinary space
  *      * A sorter
  *      * A one-row "pseudotable" stored in a single register
+ *      * A hash table built for a join
  */
 typedef struct VdbeCursor VdbeCursor;
 struct VdbeCursor {
@@ -99,6 +101,7 @@ struct VdbeCursor {
 		BtCursor *pCursor;	/* CURTYPE_TARANTOOL */
 		int pseudoTableReg;	/* CURTYPE_PSEUDO. Reg holding content. */
 		VdbeSorter *pSorter;	/* CURTYPE_SORTER. Sorter object */
+		struct vdbe_hash *hash;	/* CURTYPE_HASH. Hash table */
 	} uc;
 	/** Info about keys needed by index cursors. */
 	struct key_def *key_def;
@@ -380,6 +383,52 @@ int sqlVdbeSorterRewind(const VdbeCursor *, int *);
 int sqlVdbeSorterWrite(const VdbeCursor *, Mem *);
 int sqlVdbeSorterCompare(const VdbeCursor *, Mem *, int, int *);
 
+/** Max memory a hash table built for a join may use, in bytes. */
+extern uint64_t sql_hash_join_memory_max;
+
+/**
+ * Create a hash table for a join. Rows inserted into the table are
+ * described by the given key definition, the first key_part_count fields
+ * of a row form its key. The key definition must outlive the table.
+ * Return NULL and set diag on memory allocation error.
+ */
+struct vdbe_hash *
+vdbe_hash_new(struct key_def *key_def, uint32_t key_part_count);
+
+/** Free a hash table and all rows inserted into it. */
+void
+vdbe_hash_delete(struct vdbe_hash *hash);
+
+/**
+ * Insert a row encoded as a MessagePack array into a hash table. Rows
+ * with NULL in any key field are ignored, since no key can be equal to
+ * them. If the table would exceed sql_hash_join_memory_max, its rows are
+ * moved to an ephemeral space. Return -1 and set diag on error.
+ */
+int
+vdbe_hash_insert(struct vdbe_hash *hash, const char *data, uint32_t size);
+
+/**
+ * Position a hash table at the first row with the given key. The key is
+ * a sequence of key_part_count fields without an array header. Set
+ * @a found to false if there are no such rows. Return -1 and set diag
+ * on error.
+ */
+int
+vdbe_hash_seek(struct vdbe_hash *hash, const char *key, bool *found);
+
+/**
+ * Advance a hash table to the next row with the key passed to the last
+ * vdbe_hash_seek(). Set @a found to false if there are no more such
+ * rows. Return -1 and set diag on error.
+ */
+int
+vdbe_hash_next(struct vdbe_hash *hash, bool *found);
+
+/** Return the row a hash table is positioned at. */
+const char *
+vdbe_hash_row(struct vdbe_hash *hash, uint32_t *size);
+
 int sqlVdbeMemTranslate(Mem *, u8);
 #ifdef SQL_DEBUG
 void sqlVdbePrintSql(Vdbe *);
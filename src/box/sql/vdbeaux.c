@@ -1489,6 +1489,10 @@ sqlVdbeFreeCursor(struct VdbeCursor *pCx)
 		sql_cursor_close(pCx->uc.pCursor);
 			break;
 		}
+	case CURTYPE_HASH:
+		if (pCx->uc.hash != NULL)
+			vdbe_hash_delete(pCx->uc.hash);
+		break;
 	}
 }
 
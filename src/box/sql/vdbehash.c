@@ -0,0 +1,415 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+
+/*
+ * This file contains the hash table used by hash cursors. A hash cursor
+ * implements the build side of a hash join: rows of the inner table of
+ * a join are inserted into the hash table once, and then the table is
+ * probed with the key of every row of the outer table.
+ *
+ * Rows with equal keys are collected in groups, so after the group of
+ * the probed key is found, the matching rows are iterated without any
+ * further comparisons. Rows are stored in a region, which is freed
+ * with the cursor.
+ *
+ * The memory used by a table is limited by the sql_hash_join_memory_max
+ * tweak. A table that outgrows the limit is spilled: all its rows are
+ * moved to an ephemeral space with a TREE index over the key, which is
+ * what an automatic index is built as without a hash join, and all
+ * following operations go to the space.
+ */
+#include "sqlInt.h"
+#include "vdbeInt.h"
+
+#include "box/index.h"
+#include "box/key_def.h"
+#include "box/space.h"
+#include "box/tuple.h"
+#include "diag.h"
+#include "fiber.h"
+#include "msgpuck.h"
+#include "small/region.h"
+#include "tweaks.h"
+#include <PMurHash.h>
+
+uint64_t sql_hash_join_memory_max = 64 * 1024 * 1024;
+TWEAK_UINT(sql_hash_join_memory_max);
+
+enum {
+	/** Initial number of buckets, must be a power of two. */
+	VDBE_HASH_MIN_BUCKETS = 64,
+	/** Seed of the key hash function. */
+	VDBE_HASH_SEED = 13,
+};
+
+/** A row inserted into the hash table. */
+struct vdbe_hash_row {
+	/** Next row with the same key. */
+	struct vdbe_hash_row *next;
+	/** Size of the row. */
+	uint32_t size;
+	/** The row, encoded as a MessagePack array. */
+	char data[];
+};
+
+/** A group of rows with equal keys. */
+struct vdbe_hash_group {
+	/** Next group in the same bucket. */
+	struct vdbe_hash_group *next;
+	/** Hash of the key. */
+	uint32_t hash;
+	/** Key fields of the first row, used for comparison. */
+	const char *key;
+	/** First row of the group. */
+	struct vdbe_hash_row *first;
+	/** Last row of the group, new rows are appended after it. */
+	struct vdbe_hash_row *last;
+};
+
+struct vdbe_hash {
+	/** Definition of row fields. The first fields form the key. */
+	struct key_def *key_def;
+	/** Number of key fields. */
+	uint32_t key_part_count;
+	/** Array of buckets, each one is a list of groups. */
+	struct vdbe_hash_group **buckets;
+	/** Number of buckets minus one. */
+	uint32_t bucket_mask;
+	/** Number of groups in the table. */
+	uint32_t group_count;
+	/** Row the cursor is positioned at or NULL. */
+	struct vdbe_hash_row *current;
+	/** Memory for rows and groups. */
+	struct region region;
+	/**
+	 * Ephemeral space the rows are moved to once the table exceeds
+	 * the memory limit or NULL. Rows stored in the space have one more
+	 * field, a unique row id, so that equal rows can be stored.
+	 */
+	struct space *spill;
+	/** Row id of the next row inserted into the spill space. */
+	uint64_t spill_row_id;
+	/** Iterator over rows of the spill space with the sought key. */
+	struct iterator *spill_it;
+	/** Referenced tuple of the spill space the cursor is at or NULL. */
+	struct tuple *spill_tuple;
+};
+
+struct vdbe_hash *
+vdbe_hash_new(struct key_def *key_def, uint32_t key_part_count)
+{
+	assert(key_part_count > 0 && key_part_count <= key_def->part_count);
+	struct vdbe_hash *hash = malloc(sizeof(*hash));
+	if (hash == NULL) {
+		diag_set(OutOfMemory, sizeof(*hash), "malloc", "hash");
+		return NULL;
+	}
+	hash->buckets = calloc(VDBE_HASH_MIN_BUCKETS, sizeof(hash->buckets[0]));
+	if (hash->buckets == NULL) {
+		diag_set(OutOfMemory,
+			 VDBE_HASH_MIN_BUCKETS * sizeof(hash->buckets[0]),
+			 "calloc", "buckets");
+		free(hash);
+		return NULL;
+	}
+	hash->key_def = key_def;
+	hash->key_part_count = key_part_count;
+	hash->bucket_mask = VDBE_HASH_MIN_BUCKETS - 1;
+	hash->group_count = 0;
+	hash->current = NULL;
+	region_create(&hash->region, &cord()->slabc);
+	hash->spill = NULL;
+	hash->spill_row_id = 0;
+	hash->spill_it = NULL;
+	hash->spill_tuple = NULL;
+	return hash;
+}
+
+void
+vdbe_hash_delete(struct vdbe_hash *hash)
+{
+	if (hash->spill_tuple != NULL)
+		tuple_unref(hash->spill_tuple);
+	if (hash->spill_it != NULL)
+		iterator_delete(hash->spill_it);
+	if (hash->spill != NULL)
+		space_delete(hash->spill);
+	region_destroy(&hash->region);
+	free(hash->buckets);
+	free(hash);
+}
+
+/**
+ * Return true if the memory used by a hash table wouldn't exceed the
+ * limit if the given number of bytes were allocated.
+ */
+static bool
+vdbe_hash_fits(struct vdbe_hash *hash, size_t size)
+{
+	size_t used = region_used(&hash->region) +
+		      (hash->bucket_mask + 1) * sizeof(hash->buckets[0]);
+	return used + size <= sql_hash_join_memory_max;
+}
+
+/** Insert a row into the spill space. Return -1 and set diag on error. */
+static int
+vdbe_hash_spill_insert(struct vdbe_hash *hash, const char *data,
+		       uint32_t size)
+{
+	assert(hash->spill != NULL);
+	const char *fields = data;
+	uint32_t field_count = mp_decode_array(&fields);
+	uint32_t fields_size = size - (fields - data);
+	uint64_t row_id = hash->spill_row_id++;
+	struct region *region = &fiber()->gc;
+	size_t svp = region_used(region);
+	size_t tuple_size = mp_sizeof_array(field_count + 1) + fields_size +
+			    mp_sizeof_uint(row_id);
+	char *tuple = region_alloc(region, tuple_size);
+	if (tuple == NULL) {
+		diag_set(OutOfMemory, tuple_size, "region_alloc", "tuple");
+		return -1;
+	}
+	char *pos = mp_encode_array(tuple, field_count + 1);
+	memcpy(pos, fields, fields_size);
+	pos += fields_size;
+	pos = mp_encode_uint(pos, row_id);
+	assert(pos == tuple + tuple_size);
+	int rc = space_ephemeral_replace(hash->spill, tuple, pos);
+	region_truncate(region, svp);
+	return rc;
+}
+
+/**
+ * Move all rows of a hash table to an ephemeral space and free the
+ * memory used by the table. Return -1 and set diag on error.
+ */
+static int
+vdbe_hash_spill(struct vdbe_hash *hash)
+{
+	assert(hash->spill == NULL);
+	uint32_t field_count = hash->key_def->part_count;
+	/* The key and the row id form the primary key of the space. */
+	struct sql_space_info *info =
+		sql_space_info_new(field_count + 1, hash->key_part_count + 1);
+	for (uint32_t i = 0; i < field_count; i++) {
+		info->types[i] = hash->key_def->parts[i].type;
+		info->coll_ids[i] = hash->key_def->parts[i].coll_id;
+	}
+	info->types[field_count] = FIELD_TYPE_UNSIGNED;
+	info->parts[hash->key_part_count] = field_count;
+	hash->spill = sql_ephemeral_space_new(info);
+	sql_xfree(info);
+	if (hash->spill == NULL)
+		return -1;
+	for (uint32_t i = 0; i <= hash->bucket_mask; i++) {
+		struct vdbe_hash_group *group = hash->buckets[i];
+		for (; group != NULL; group = group->next) {
+			struct vdbe_hash_row *row = group->first;
+			for (; row != NULL; row = row->next) {
+				if (vdbe_hash_spill_insert(hash, row->data,
+							   row->size) != 0)
+					return -1;
+			}
+		}
+	}
+	region_free(&hash->region);
+	free(hash->buckets);
+	hash->buckets = NULL;
+	hash->bucket_mask = 0;
+	hash->group_count = 0;
+	hash->current = NULL;
+	return 0;
+}
+
+/** Calculate the hash of the given key fields. */
+static uint32_t
+vdbe_hash_key(struct vdbe_hash *hash, const char *key)
+{
+	uint32_t h = VDBE_HASH_SEED;
+	uint32_t carry = 0;
+	uint32_t total_size = 0;
+	for (uint32_t i = 0; i < hash->key_part_count; i++) {
+		struct key_part *part = &hash->key_def->parts[i];
+		total_size += tuple_hash_field(&h, &carry, &key, part->coll);
+	}
+	return PMurHash32_Result(h, carry, total_size);
+}
+
+/** Find the group of rows with the given key. */
+static struct vdbe_hash_group *
+vdbe_hash_find(struct vdbe_hash *hash, const char *key, uint32_t h)
+{
+	struct vdbe_hash_group *group = hash->buckets[h & hash->bucket_mask];
+	for (; group != NULL; group = group->next) {
+		if (group->hash == h &&
+		    key_compare(group->key, hash->key_part_count, HINT_NONE,
+				key, hash->key_part_count, HINT_NONE,
+				hash->key_def) == 0)
+			return group;
+	}
+	return NULL;
+}
+
+/** Double the number of buckets. Return -1 and set diag on failure. */
+static int
+vdbe_hash_grow(struct vdbe_hash *hash)
+{
+	uint32_t bucket_count = (hash->bucket_mask + 1) * 2;
+	size_t size = bucket_count * sizeof(hash->buckets[0]);
+	struct vdbe_hash_group **buckets = calloc(bucket_count,
+						  sizeof(buckets[0]));
+	if (buckets == NULL) {
+		diag_set(OutOfMemory, size, "calloc", "buckets");
+		return -1;
+	}
+	for (uint32_t i = 0; i <= hash->bucket_mask; i++) {
+		struct vdbe_hash_group *group = hash->buckets[i];
+		while (group != NULL) {
+			struct vdbe_hash_group *next = group->next;
+			uint32_t j = group->hash & (bucket_count - 1);
+			group->next = buckets[j];
+			buckets[j] = group;
+			group = next;
+		}
+	}
+	free(hash->buckets);
+	hash->buckets = buckets;
+	hash->bucket_mask = bucket_count - 1;
+	return 0;
+}
+
+int
+vdbe_hash_insert(struct vdbe_hash *hash, const char *data, uint32_t size)
+{
+	const char *key = data;
+	VERIFY(mp_decode_array(&key) >= hash->key_part_count);
+	/* A row with a NULL key can't be matched by any probe. */
+	const char *field = key;
+	for (uint32_t i = 0; i < hash->key_part_count; i++) {
+		if (mp_typeof(*field) == MP_NIL)
+			return 0;
+		mp_next(&field);
+	}
+	if (hash->spill != NULL)
+		return vdbe_hash_spill_insert(hash, data, size);
+	size_t row_size = sizeof(struct vdbe_hash_row) + size;
+	size_t max_size = row_size + sizeof(struct vdbe_hash_group);
+	/* Old buckets are freed after new ones are allocated. */
+	if (hash->group_count > hash->bucket_mask)
+		max_size += (hash->bucket_mask + 1) * 2 *
+			    sizeof(hash->buckets[0]);
+	if (!vdbe_hash_fits(hash, max_size)) {
+		if (vdbe_hash_spill(hash) != 0)
+			return -1;
+		return vdbe_hash_spill_insert(hash, data, size);
+	}
+	struct vdbe_hash_row *row;
+	row = region_aligned_alloc(&hash->region, row_size, alignof(*row));
+	if (row == NULL) {
+		diag_set(OutOfMemory, row_size, "region_aligned_alloc", "row");
+		return -1;
+	}
+	row->next = NULL;
+	row->size = size;
+	memcpy(row->data, data, size);
+	key = row->data + (key - data);
+
+	uint32_t h = vdbe_hash_key(hash, key);
+	struct vdbe_hash_group *group = vdbe_hash_find(hash, key, h);
+	if (group != NULL) {
+		group->last->next = row;
+		group->last = row;
+		return 0;
+	}
+	if (hash->group_count > hash->bucket_mask &&
+	    vdbe_hash_grow(hash) != 0)
+		return -1;
+	group = region_aligned_alloc(&hash->region, sizeof(*group),
+				     alignof(*group));
+	if (group == NULL) {
+		diag_set(OutOfMemory, sizeof(*group), "region_aligned_alloc",
+			 "group");
+		return -1;
+	}
+	group->hash = h;
+	group->key = key;
+	group->first = row;
+	group->last = row;
+	struct vdbe_hash_group **bucket = &hash->buckets[h & hash->bucket_mask];
+	group->next = *bucket;
+	*bucket = group;
+	hash->group_count++;
+	return 0;
+}
+
+/**
+ * Advance the iterator over the spill space and reference the tuple it
+ * returns. Return -1 and set diag on error.
+ */
+static int
+vdbe_hash_spill_next(struct vdbe_hash *hash, bool *found)
+{
+	if (hash->spill_tuple != NULL) {
+		tuple_unref(hash->spill_tuple);
+		hash->spill_tuple = NULL;
+	}
+	if (hash->spill_it == NULL) {
+		*found = false;
+		return 0;
+	}
+	struct tuple *tuple;
+	if (iterator_next(hash->spill_it, &tuple) != 0)
+		return -1;
+	if (tuple != NULL)
+		tuple_ref(tuple);
+	hash->spill_tuple = tuple;
+	*found = tuple != NULL;
+	return 0;
+}
+
+int
+vdbe_hash_seek(struct vdbe_hash *hash, const char *key, bool *found)
+{
+	if (hash->spill != NULL) {
+		if (hash->spill_it != NULL)
+			iterator_delete(hash->spill_it);
+		hash->spill_it = index_create_iterator(
+			space_index(hash->spill, 0), ITER_EQ, key,
+			hash->key_part_count);
+		if (hash->spill_it == NULL)
+			return -1;
+		return vdbe_hash_spill_next(hash, found);
+	}
+	struct vdbe_hash_group *group =
+		vdbe_hash_find(hash, key, vdbe_hash_key(hash, key));
+	hash->current = group != NULL ? group->first : NULL;
+	*found = hash->current != NULL;
+	return 0;
+}
+
+int
+vdbe_hash_next(struct vdbe_hash *hash, bool *found)
+{
+	if (hash->spill != NULL)
+		return vdbe_hash_spill_next(hash, found);
+	if (hash->current != NULL)
+		hash->current = hash->current->next;
+	*found = hash->current != NULL;
+	return 0;
+}
+
+const char *
+vdbe_hash_row(struct vdbe_hash *hash, uint32_t *size)
+{
+	if (hash->spill != NULL) {
+		assert(hash->spill_tuple != NULL);
+		return tuple_data_range(hash->spill_tuple, size);
+	}
+	assert(hash->current != NULL);
+	*size = hash->current->size;
+	return hash->current->data;
+}
@@ -713,6 +713,48 @@ termCanDriveIndex(WhereTerm * pTerm,	/* WHERE clause term to check */
 	return 1;
 }
 
+/**
+ * Return true if the column compared by the given WHERE clause term can
+ * be a key of a hash table built for a join. It is so if values of the
+ * column that compare equal are always encoded so that they have equal
+ * hashes. This is not true for NUMBER and SCALAR columns, since a decimal
+ * value may be equal to an integer or a double one.
+ */
+static bool
+term_can_drive_hash_join(const struct WhereTerm *term,
+			 const struct SrcList_item *src)
+{
+	assert(term->u.leftColumn >= 0);
+	switch (src->space->def->fields[term->u.leftColumn].type) {
+	case FIELD_TYPE_UNSIGNED:
+	case FIELD_TYPE_INTEGER:
+	case FIELD_TYPE_DOUBLE:
+	case FIELD_TYPE_STRING:
+	case FIELD_TYPE_BOOLEAN:
+	case FIELD_TYPE_VARBINARY:
+	case FIELD_TYPE_UUID:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Return true if the rows of the given table are likely to fit in a hash
+ * table built for a join, see sql_hash_join_memory_max. Otherwise the
+ * automatic index is built as an ephemeral space, which is limited only
+ * by the memtx memory quota. The size of a table that isn't stored in a
+ * space, like a subquery, is unknown in advance. A hash table that
+ * outgrows the limit at runtime is moved to an ephemeral space.
+ */
+static bool
+space_fits_hash_join(struct space *space)
+{
+	if (space_by_id(space->def->id) != space)
+		return true;
+	return space_bsize(space) <= sql_hash_join_memory_max;
+}
+
 /**
  * Generate a code that will create a tuple, which is supposed to be inserted
  * in the ephemeral index space. The created tuple consists of rowid and
@@ -742,6 +784,43 @@ vdbe_emit_ephemeral_index_tuple(struct Parse *parse,
 	sqlReleaseTempRange(parse, reg_base, col_cnt + 1);
 }
 
+/**
+ * Generate code to create a hash table that contains all fields of the
+ * table of the given level used in the query and to fill it. The first
+ * nEq fields described by the key definition form the hash table key.
+ */
+static void
+construct_hash_join_table(struct Parse *parse, struct WhereLevel *level,
+			  const struct key_def *key_def)
+{
+	struct Vdbe *v = parse->pVdbe;
+	struct sql_key_info *key_info = sql_key_info_new_from_key_def(key_def);
+	sqlVdbeAddOp4(v, OP_HashOpen, level->iIdxCur, level->pWLoop->nEq, 0,
+		      (char *)key_info, P4_KEYINFO);
+
+	/* Fill the hash table with content. */
+	sqlExprCachePush(parse);
+	int cursor = level->iTabCur;
+	int addr_top = sqlVdbeAddOp1(v, OP_Rewind, cursor);
+	int col_count = key_def->part_count;
+	int reg_base = sqlGetTempRange(parse, col_count);
+	int reg_record = sqlGetTempReg(parse);
+	for (int i = 0; i < col_count; i++) {
+		sqlVdbeAddOp3(v, OP_Column, cursor, key_def->parts[i].fieldno,
+			      reg_base + i);
+	}
+	sqlVdbeAddOp3(v, OP_MakeRecord, reg_base, col_count, reg_record);
+	/* The record is copied to the hash table. */
+	sqlVdbeChangeP5(v, 1);
+	sqlVdbeAddOp2(v, OP_HashInsert, level->iIdxCur, reg_record);
+	sqlVdbeAddOp2(v, OP_Next, cursor, addr_top + 1);
+	sqlVdbeChangeP5(v, SQL_STMTSTATUS_AUTOINDEX);
+	sqlVdbeJumpHere(v, addr_top);
+	sqlReleaseTempReg(parse, reg_record);
+	sqlReleaseTempRange(parse, reg_base, col_count);
+	sqlExprCachePop(parse);
+}
+
 /*
  * Generate code to construct the ephemeral space that contains all used in
  * query fields of one of the tables that participate in the query. The source
@@ -784,9 +863,11 @@ constructAutomaticIndex(Parse * pParse,			/* The parsing context */
 	nKeyCol = 0;
 	pWCEnd = &pWC->a[pWC->nTerm];
 	pLoop = pLevel->pWLoop;
+	bool is_hash = (pLoop->wsFlags & WHERE_HASH_JOIN) != 0;
 	idxCols = 0;
 	for (pTerm = pWC->a; pTerm < pWCEnd; pTerm++) {
-		if (termCanDriveIndex(pTerm, pSrc, notReady)) {
+		if (termCanDriveIndex(pTerm, pSrc, notReady) &&
+		    (!is_hash || term_can_drive_hash_join(pTerm, pSrc))) {
 			int iCol = pTerm->u.leftColumn;
 			Bitmask cMask =
 			    iCol >= BMS ? MASKBIT(BMS - 1) : MASKBIT(iCol);
@@ -801,6 +882,8 @@ constructAutomaticIndex(Parse * pParse,			/* The parsing context */
 	pLoop->nEq = pLoop->nLTerm = nKeyCol;
 	pLoop->wsFlags = WHERE_COLUMN_EQ | WHERE_IDX_ONLY | WHERE_INDEXED
 	    | WHERE_AUTO_INDEX;
+	if (is_hash)
+		pLoop->wsFlags |= WHERE_HASH_JOIN;
 
 	/* Count the number of additional columns needed to create a
 	 * covering index.  A "covering index" is an index that contains all
@@ -827,7 +910,8 @@ constructAutomaticIndex(Parse * pParse,			/* The parsing context */
 							 typeof(parts[0]),
 							 nKeyCol);
 	for (pTerm = pWC->a; pTerm < pWCEnd; pTerm++) {
-		if (termCanDriveIndex(pTerm, pSrc, notReady)) {
+		if (termCanDriveIndex(pTerm, pSrc, notReady) &&
+		    (!is_hash || term_can_drive_hash_join(pTerm, pSrc))) {
 			int iCol = pTerm->u.leftColumn;
 			Bitmask cMask =
 			    iCol >= BMS ? MASKBIT(BMS - 1) : MASKBIT(iCol);
@@ -906,6 +990,11 @@ constructAutomaticIndex(Parse * pParse,			/* The parsing context */
 	/* Create the automatic index */
 	assert(pLevel->iIdxCur >= 0);
 	pLevel->iIdxCur = pParse->nTab++;
+	if (is_hash) {
+		construct_hash_join_table(pParse, pLevel, idx_def->key_def);
+		sqlVdbeJumpHere(v, addrInit);
+		return;
+	}
 	struct sql_space_info *info = sql_space_info_new_from_index_def(idx_def,
 									true);
 	int reg_eph = sqlGetTempReg(pParse);
@@ -2184,6 +2273,15 @@ whereLoopAddBtree(WhereLoopBuilder * pBuilder,	/* WHERE clause information */
 				pNew->rRun =
 				    sqlLogEstAdd(rLogSize, pNew->nOut);
 				pNew->wsFlags = WHERE_AUTO_INDEX;
+				/*
+				 * A hash table lookup doesn't depend on
+				 * the number of rows in the table.
+				 */
+				if (term_can_drive_hash_join(pTerm, pSrc) &&
+				    space_fits_hash_join(pSrc->space)) {
+					pNew->rRun = pNew->nOut;
+					pNew->wsFlags |= WHERE_HASH_JOIN;
+				}
 				pNew->prereq = mPrereq | pTerm->prereqRight;
 				rc = whereLoopInsert(pBuilder, pNew);
 			}
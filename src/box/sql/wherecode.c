@@ -218,7 +218,8 @@ sqlWhereExplainOneScan(Parse * pParse,	/* Parse context */
 			assert(!(flags & WHERE_AUTO_INDEX)
 			       || (flags & WHERE_IDX_ONLY));
 			if ((flags & WHERE_AUTO_INDEX) != 0) {
-				zFmt = "EPHEMERAL INDEX";
+				zFmt = (flags & WHERE_HASH_JOIN) != 0 ?
+				       "EPHEMERAL HASH INDEX" : "EPHEMERAL INDEX";
 			} else if (idx_def->iid == 0) {
 				if (is_search)
 					zFmt = "PRIMARY KEY";
@@ -727,6 +728,24 @@ sqlWhereCodeOneLoopStart(WhereInfo * pWInfo,	/* Complete information about the W
 		pLevel->p2 = sqlVdbeAddOp2(v, OP_Yield, regYield, addrBrk);
 		VdbeComment((v, "next row of \"%s\"", pTabItem->space->def->name));
 		pLevel->op = OP_Goto;
+	} else if (pLoop->wsFlags & WHERE_HASH_JOIN) {
+		/* Case 3a: A lookup in a hash table built for a join.
+		 *
+		 *         The hash table was created and filled by
+		 *         constructAutomaticIndex(). All its key fields are
+		 *         constrained by "==" terms, and it contains all
+		 *         the columns used by the query.
+		 */
+		assert((pLoop->wsFlags & WHERE_AUTO_INDEX) != 0);
+		assert(omitTable);
+		int iIdxCur = pLevel->iIdxCur;
+		int regBase = codeAllEqualityTerms(pParse, pLevel, bRev, 0);
+		addrNxt = pLevel->addrNxt;
+		sqlVdbeAddOp4Int(v, OP_HashSeek, iIdxCur, addrNxt, regBase,
+				 pLoop->nEq);
+		pLevel->p2 = sqlVdbeCurrentAddr(v);
+		pLevel->op = OP_HashNext;
+		pLevel->p1 = iIdxCur;
 	} else if (pLoop->wsFlags & WHERE_INDEXED) {
 		/* Case 4: A scan using an index.
 		 *
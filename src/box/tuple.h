@@ -35,6 +35,7 @@
 #include "tt_static.h"
 #include "tt_uuid.h"
 #include "tuple_format.h"
+#include "mp_scan.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -410,6 +411,11 @@ enum tuple_flag {
 	 * immediately while a snapshot is in progress.
 	 */
 	TUPLE_IS_TEMPORARY = 2,
+	/**
+	 * Fields of the tuple that follow the last indexed field are
+	 * stored compressed, see memtx_tuple_compression.h.
+	 */
+	TUPLE_IS_COMPRESSED = 3,
 	tuple_flag_MAX,
 };
 
@@ -803,7 +809,7 @@ tuple_format(struct tuple *tuple)
 static inline bool
 tuple_is_compressed(struct tuple *tuple)
 {
-        return tuple_format(tuple)->is_compressed;
+	return tuple_has_flag(tuple, TUPLE_IS_COMPRESSED);
 }
 
 /**
@@ -1025,8 +1031,7 @@ tuple_field_raw_by_path(struct tuple_format *format, const char *tuple,
 		field_count = mp_decode_array(&tuple);
 		if (unlikely(fieldno >= field_count))
 			return NULL;
-		for (uint32_t k = 0; k < fieldno; k++)
-			mp_next(&tuple);
+		mp_next_n(&tuple, fieldno);
 		if (path != NULL &&
 		    unlikely(tuple_go_to_path(&tuple, path, path_len,
 					      index_base, multikey_idx) != 0))
@@ -1074,8 +1079,7 @@ tuple_field_raw(struct tuple_format *format, const char *tuple,
 		uint32_t field_count = mp_decode_array(&tuple);
 		if (unlikely(field_no >= field_count))
 			return NULL;
-		for ( ; field_no > 0; field_no--)
-			mp_next(&tuple);
+		mp_next_n(&tuple, field_no);
 	}
 	return tuple;
 }
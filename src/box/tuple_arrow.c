@@ -0,0 +1,681 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "tuple_arrow.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bit/bit.h"
+#include "diag.h"
+#include "error.h"
+#include "field_def.h"
+#include "msgpuck.h"
+#include "small/region.h"
+#include "trivia/util.h"
+#include "tt_static.h"
+#include "tuple.h"
+#include "tuple_dictionary.h"
+
+/**
+ * Returns the number of buffers of a column with the given format
+ * or -1 if the format isn't supported.
+ */
+static int
+tuple_arrow_buffer_count(const char *format)
+{
+	if (format[0] == '\0' || format[1] != '\0')
+		return -1;
+	switch (format[0]) {
+	case 'n':
+		return 0;
+	case 'b':
+	case 'c':
+	case 'C':
+	case 's':
+	case 'S':
+	case 'i':
+	case 'I':
+	case 'l':
+	case 'L':
+	case 'f':
+	case 'g':
+		return 2;
+	case 'u':
+	case 'U':
+	case 'z':
+	case 'Z':
+		return 3;
+	default:
+		return -1;
+	}
+}
+
+int
+tuple_arrow_check(const struct ArrowArray *array,
+		  const struct ArrowSchema *schema,
+		  struct tuple_dictionary *dict, const char *space_name,
+		  struct region *region, struct tuple_arrow_field_map *map)
+{
+	if (strcmp(schema->format, "+s") != 0) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Arrow conversion",
+			 tt_sprintf("top-level type '%s'", schema->format));
+		return -1;
+	}
+	if (array->n_children != schema->n_children || array->offset < 0 ||
+	    array->length < 0 || (array->null_count != 0 &&
+	     array->n_buffers > 0 && array->buffers[0] != NULL)) {
+		diag_set(IllegalParams, "Invalid Arrow struct array");
+		return -1;
+	}
+	uint32_t *fieldnos = xregion_alloc_array(region, uint32_t,
+						 schema->n_children);
+	uint32_t field_count = 0;
+	for (int64_t i = 0; i < schema->n_children; i++) {
+		const struct ArrowSchema *child_schema = schema->children[i];
+		const struct ArrowArray *child = array->children[i];
+		int buffer_count =
+			tuple_arrow_buffer_count(child_schema->format);
+		if (buffer_count < 0 || child_schema->dictionary != NULL) {
+			diag_set(ClientError, ER_UNSUPPORTED,
+				 "Arrow conversion",
+				 tt_sprintf("type '%s'",
+					    child_schema->format));
+			return -1;
+		}
+		if (child->n_buffers != buffer_count || child->offset < 0 ||
+		    child->length < array->offset + array->length) {
+			diag_set(IllegalParams, "Invalid Arrow array of "
+				 "column %lld", (long long)i + 1);
+			return -1;
+		}
+		for (int j = 1; j < buffer_count; j++) {
+			if (child->buffers[j] == NULL && child->length > 0) {
+				diag_set(IllegalParams, "Invalid Arrow array "
+					 "of column %lld", (long long)i + 1);
+				return -1;
+			}
+		}
+		const char *name = child_schema->name != NULL ?
+				   child_schema->name : "";
+		uint32_t name_len = strlen(name);
+		if (tuple_fieldno_by_name(dict, name, name_len,
+					  field_name_hash(name, name_len),
+					  &fieldnos[i]) != 0) {
+			diag_set(ClientError, ER_NO_SUCH_FIELD_NAME_IN_SPACE,
+				 name, space_name);
+			return -1;
+		}
+		field_count = MAX(field_count, fieldnos[i] + 1);
+	}
+	int64_t *columns = xregion_alloc_array(region, int64_t,
+					       field_count);
+	for (uint32_t i = 0; i < field_count; i++)
+		columns[i] = -1;
+	for (int64_t i = 0; i < schema->n_children; i++) {
+		if (columns[fieldnos[i]] >= 0) {
+			diag_set(IllegalParams, "Invalid Arrow struct array: "
+				 "duplicate column '%s'",
+				 schema->children[i]->name);
+			return -1;
+		}
+		columns[fieldnos[i]] = i;
+	}
+	map->columns = columns;
+	map->field_count = field_count;
+	return 0;
+}
+
+static inline char *
+tuple_arrow_encode_int(char *pos, int64_t value)
+{
+	if (value < 0)
+		return mp_encode_int(pos, value);
+	return mp_encode_uint(pos, value);
+}
+
+/** Checks if the @a i-th physical value of a column is null. */
+static inline bool
+tuple_arrow_is_null(const struct ArrowArray *column, const char *format,
+		    int64_t i)
+{
+	const void *validity = column->n_buffers > 0 ?
+			       column->buffers[0] : NULL;
+	return format[0] == 'n' || (validity != NULL && !bit_test(validity, i));
+}
+
+/**
+ * Encodes the @a i-th physical value of a column. Returns NULL if @a pos
+ * is NULL, but adds the maximal size of the encoded value to @a size.
+ */
+static char *
+tuple_arrow_encode_value(char *pos, const struct ArrowArray *column,
+			 const char *format, int64_t i, size_t *size)
+{
+	if (tuple_arrow_is_null(column, format, i)) {
+		*size += mp_sizeof_nil();
+		return pos != NULL ? mp_encode_nil(pos) : NULL;
+	}
+	const void *values = column->buffers[1];
+	const char *data;
+	int64_t begin = 0, end = 0;
+	switch (format[0]) {
+	case 'u':
+	case 'z':
+		begin = ((const int32_t *)values)[i];
+		end = ((const int32_t *)values)[i + 1];
+		break;
+	case 'U':
+	case 'Z':
+		begin = ((const int64_t *)values)[i];
+		end = ((const int64_t *)values)[i + 1];
+		break;
+	default:
+		/* All fixed-width values fit in 9 bytes. */
+		*size += 9;
+		if (pos == NULL)
+			return NULL;
+		break;
+	}
+	switch (format[0]) {
+	case 'b':
+		return mp_encode_bool(pos, bit_test(values, i));
+	case 'c':
+		return tuple_arrow_encode_int(pos, ((const int8_t *)values)[i]);
+	case 'C':
+		return mp_encode_uint(pos, ((const uint8_t *)values)[i]);
+	case 's':
+		return tuple_arrow_encode_int(pos,
+					      ((const int16_t *)values)[i]);
+	case 'S':
+		return mp_encode_uint(pos, ((const uint16_t *)values)[i]);
+	case 'i':
+		return tuple_arrow_encode_int(pos,
+					      ((const int32_t *)values)[i]);
+	case 'I':
+		return mp_encode_uint(pos, ((const uint32_t *)values)[i]);
+	case 'l':
+		return tuple_arrow_encode_int(pos,
+					      ((const int64_t *)values)[i]);
+	case 'L':
+		return mp_encode_uint(pos, ((const uint64_t *)values)[i]);
+	case 'f':
+		return mp_encode_float(pos, ((const float *)values)[i]);
+	case 'g':
+		return mp_encode_double(pos, ((const double *)values)[i]);
+	case 'u':
+	case 'U':
+		*size += mp_sizeof_str(end - begin);
+		if (pos == NULL)
+			return NULL;
+		data = (const char *)column->buffers[2] + begin;
+		return mp_encode_str(pos, data, end - begin);
+	case 'z':
+	case 'Z':
+		*size += mp_sizeof_bin(end - begin);
+		if (pos == NULL)
+			return NULL;
+		data = (const char *)column->buffers[2] + begin;
+		return mp_encode_bin(pos, data, end - begin);
+	default:
+		unreachable();
+		return pos;
+	}
+}
+
+const char *
+tuple_arrow_encode_row(const struct ArrowArray *array,
+		       const struct ArrowSchema *schema,
+		       const struct tuple_arrow_field_map *map, int64_t row,
+		       struct region *region, const char **data_end)
+{
+	int64_t i = array->offset + row;
+	uint32_t field_count = map->field_count;
+	/* Trailing nulls are omitted, like missing fields of a tuple. */
+	while (field_count > 0) {
+		int64_t j = map->columns[field_count - 1];
+		if (j >= 0) {
+			const struct ArrowArray *column = array->children[j];
+			if (!tuple_arrow_is_null(column,
+						 schema->children[j]->format,
+						 column->offset + i))
+				break;
+		}
+		field_count--;
+	}
+	size_t size = mp_sizeof_array(field_count);
+	for (uint32_t f = 0; f < field_count; f++) {
+		int64_t j = map->columns[f];
+		if (j < 0) {
+			size += mp_sizeof_nil();
+			continue;
+		}
+		const struct ArrowArray *column = array->children[j];
+		tuple_arrow_encode_value(NULL, column,
+					 schema->children[j]->format,
+					 column->offset + i, &size);
+	}
+	char *data = xregion_alloc(region, size);
+	char *pos = mp_encode_array(data, field_count);
+	for (uint32_t f = 0; f < field_count; f++) {
+		int64_t j = map->columns[f];
+		if (j < 0) {
+			pos = mp_encode_nil(pos);
+			continue;
+		}
+		const struct ArrowArray *column = array->children[j];
+		size_t unused = 0;
+		pos = tuple_arrow_encode_value(pos, column,
+					       schema->children[j]->format,
+					       column->offset + i, &unused);
+	}
+	assert(pos <= data + size);
+	*data_end = pos;
+	return data;
+}
+
+/** A growing buffer of a column being built. */
+struct tuple_arrow_buffer {
+	/** Buffer data allocated with malloc. */
+	char *data;
+	/** Size of the data. */
+	size_t size;
+	/** Size of the allocated memory. */
+	size_t capacity;
+};
+
+/** Appends @a size zeroed bytes to the buffer, returns their position. */
+static char *
+tuple_arrow_buffer_append(struct tuple_arrow_buffer *buf, size_t size)
+{
+	size_t new_size = buf->size + size;
+	if (new_size > buf->capacity) {
+		size_t capacity = MAX(buf->capacity * 2, (size_t)1024);
+		while (capacity < new_size)
+			capacity *= 2;
+		buf->data = xrealloc(buf->data, capacity);
+		buf->capacity = capacity;
+	}
+	char *pos = buf->data + buf->size;
+	memset(pos, 0, size);
+	buf->size = new_size;
+	return pos;
+}
+
+/** Appends the @a i-th bit to a bitmap. */
+static void
+tuple_arrow_bitmap_append(struct tuple_arrow_buffer *buf, int64_t i,
+			  bool value)
+{
+	if (i % CHAR_BIT == 0)
+		tuple_arrow_buffer_append(buf, 1);
+	if (value)
+		bit_set(buf->data, i);
+}
+
+/** A column of a record batch being built. */
+struct tuple_arrow_column {
+	/** Format of the column in the C data interface. */
+	const char *format;
+	/** Validity bitmap. */
+	struct tuple_arrow_buffer validity;
+	/** Values or offsets of variable-length values. */
+	struct tuple_arrow_buffer values;
+	/** Data of variable-length values. */
+	struct tuple_arrow_buffer data;
+	/** Number of null values. */
+	int64_t null_count;
+	/** Column name. */
+	char *name;
+	/** Whether the column may contain nulls. */
+	bool is_nullable;
+};
+
+struct tuple_arrow_builder {
+	/** Number of rows. */
+	int64_t length;
+	/** Number of columns. */
+	uint32_t column_count;
+	/** Columns. */
+	struct tuple_arrow_column columns[0];
+};
+
+const char *
+tuple_arrow_format(enum field_type type)
+{
+	switch (type) {
+	case FIELD_TYPE_BOOLEAN:
+		return "b";
+	case FIELD_TYPE_INT8:
+		return "c";
+	case FIELD_TYPE_UINT8:
+		return "C";
+	case FIELD_TYPE_INT16:
+		return "s";
+	case FIELD_TYPE_UINT16:
+		return "S";
+	case FIELD_TYPE_INT32:
+		return "i";
+	case FIELD_TYPE_UINT32:
+		return "I";
+	case FIELD_TYPE_INTEGER:
+	case FIELD_TYPE_INT64:
+		return "l";
+	case FIELD_TYPE_UNSIGNED:
+	case FIELD_TYPE_UINT64:
+		return "L";
+	case FIELD_TYPE_FLOAT32:
+		return "f";
+	case FIELD_TYPE_DOUBLE:
+	case FIELD_TYPE_FLOAT64:
+		return "g";
+	case FIELD_TYPE_STRING:
+		return "u";
+	case FIELD_TYPE_VARBINARY:
+		return "z";
+	default:
+		return NULL;
+	}
+}
+
+struct tuple_arrow_builder *
+tuple_arrow_builder_new(const struct field_def *fields, uint32_t field_count)
+{
+	if (field_count == 0) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Arrow conversion",
+			 "spaces without format");
+		return NULL;
+	}
+	for (uint32_t i = 0; i < field_count; i++) {
+		if (tuple_arrow_format(fields[i].type) == NULL) {
+			diag_set(ClientError, ER_UNSUPPORTED,
+				 "Arrow conversion",
+				 tt_sprintf("field type '%s'",
+					    field_type_strs[fields[i].type]));
+			return NULL;
+		}
+	}
+	struct tuple_arrow_builder *builder =
+		xcalloc(1, sizeof(*builder) +
+			field_count * sizeof(builder->columns[0]));
+	builder->column_count = field_count;
+	for (uint32_t i = 0; i < field_count; i++) {
+		struct tuple_arrow_column *column = &builder->columns[i];
+		column->format = tuple_arrow_format(fields[i].type);
+		column->name = xstrdup(fields[i].name);
+		column->is_nullable = fields[i].is_nullable;
+		/* Variable-length values start with a zero offset. */
+		if (column->format[0] == 'u' || column->format[0] == 'z')
+			tuple_arrow_buffer_append(&column->values,
+						  sizeof(int32_t));
+	}
+	return builder;
+}
+
+void
+tuple_arrow_builder_delete(struct tuple_arrow_builder *builder)
+{
+	for (uint32_t i = 0; i < builder->column_count; i++) {
+		struct tuple_arrow_column *column = &builder->columns[i];
+		free(column->validity.data);
+		free(column->values.data);
+		free(column->data.data);
+		free(column->name);
+	}
+	free(builder);
+}
+
+/** Decodes a MsgPack number as a double. */
+static double
+tuple_arrow_decode_double(const char *field)
+{
+	switch (mp_typeof(*field)) {
+	case MP_FLOAT:
+		return mp_decode_float(&field);
+	case MP_DOUBLE:
+		return mp_decode_double(&field);
+	case MP_UINT:
+		return mp_decode_uint(&field);
+	case MP_INT:
+		return mp_decode_int(&field);
+	default:
+		unreachable();
+		return 0;
+	}
+}
+
+/**
+ * Appends the @a row-th value to a column. @a field is NULL if the tuple
+ * doesn't have the field.
+ */
+static int
+tuple_arrow_column_add(struct tuple_arrow_column *column, int64_t row,
+		       const char *field)
+{
+	bool is_null = field == NULL || mp_typeof(*field) == MP_NIL;
+	tuple_arrow_bitmap_append(&column->validity, row, !is_null);
+	if (is_null)
+		column->null_count++;
+	int64_t int_value = 0;
+	if (!is_null && strchr("cCsSiIlL", column->format[0]) != NULL) {
+		if (mp_typeof(*field) == MP_INT) {
+			int_value = mp_decode_int(&field);
+		} else {
+			uint64_t value = mp_decode_uint(&field);
+			if (value > INT64_MAX && column->format[0] != 'L') {
+				diag_set(ClientError, ER_UNSUPPORTED,
+					 "Arrow conversion",
+					 "integers out of the int64 range");
+				return -1;
+			}
+			int_value = (int64_t)value;
+		}
+	}
+	struct tuple_arrow_buffer *values = &column->values;
+	switch (column->format[0]) {
+	case 'b':
+		tuple_arrow_bitmap_append(values, row,
+					  !is_null && mp_decode_bool(&field));
+		break;
+	case 'c':
+	case 'C':
+		*(int8_t *)tuple_arrow_buffer_append(values, 1) = int_value;
+		break;
+	case 's':
+	case 'S':
+		store_u16(tuple_arrow_buffer_append(values, 2), int_value);
+		break;
+	case 'i':
+	case 'I':
+		store_u32(tuple_arrow_buffer_append(values, 4), int_value);
+		break;
+	case 'l':
+	case 'L':
+		store_u64(tuple_arrow_buffer_append(values, 8), int_value);
+		break;
+	case 'f':
+		store_float(tuple_arrow_buffer_append(values, 4), is_null ?
+			    0 : tuple_arrow_decode_double(field));
+		break;
+	case 'g':
+		store_double(tuple_arrow_buffer_append(values, 8), is_null ?
+			     0 : tuple_arrow_decode_double(field));
+		break;
+	case 'u':
+	case 'z': {
+		const char *data = NULL;
+		uint32_t len = 0;
+		if (!is_null && column->format[0] == 'u')
+			data = mp_decode_str(&field, &len);
+		else if (!is_null)
+			data = mp_decode_bin(&field, &len);
+		if (column->data.size + len > INT32_MAX) {
+			diag_set(ClientError, ER_UNSUPPORTED,
+				 "Arrow conversion",
+				 "more than 2GB of data in a column");
+			return -1;
+		}
+		if (len > 0)
+			memcpy(tuple_arrow_buffer_append(&column->data, len),
+			       data, len);
+		store_u32(tuple_arrow_buffer_append(values, sizeof(int32_t)),
+			  column->data.size);
+		break;
+	}
+	default:
+		unreachable();
+	}
+	return 0;
+}
+
+int
+tuple_arrow_builder_add(struct tuple_arrow_builder *builder,
+			struct tuple *tuple)
+{
+	const char *data = tuple_data(tuple);
+	uint32_t field_count = mp_decode_array(&data);
+	for (uint32_t i = 0; i < builder->column_count; i++) {
+		const char *field = NULL;
+		if (i < field_count) {
+			field = data;
+			mp_next(&data);
+		}
+		if (tuple_arrow_column_add(&builder->columns[i],
+					   builder->length, field) != 0)
+			return -1;
+	}
+	builder->length++;
+	return 0;
+}
+
+/** Private data of a built record batch. */
+struct tuple_arrow_array_data {
+	/** Child arrays. */
+	struct ArrowArray *children;
+	/** Pointers to the child arrays. */
+	struct ArrowArray **child_ptrs;
+	/** Buffers of the child arrays, three per child. */
+	const void **buffers;
+	/** Buffers of the struct array. */
+	const void *struct_buffers[1];
+};
+
+/** Private data of a built schema. */
+struct tuple_arrow_schema_data {
+	/** Child schemas. */
+	struct ArrowSchema *children;
+	/** Pointers to the child schemas. */
+	struct ArrowSchema **child_ptrs;
+};
+
+static void
+tuple_arrow_child_array_release(struct ArrowArray *array)
+{
+	for (int64_t i = 0; i < array->n_buffers; i++)
+		free((void *)array->buffers[i]);
+	array->release = NULL;
+}
+
+static void
+tuple_arrow_array_release(struct ArrowArray *array)
+{
+	struct tuple_arrow_array_data *data = array->private_data;
+	for (int64_t i = 0; i < array->n_children; i++) {
+		struct ArrowArray *child = array->children[i];
+		if (child->release != NULL)
+			child->release(child);
+	}
+	free(data->children);
+	free(data->child_ptrs);
+	free(data->buffers);
+	free(data);
+	array->release = NULL;
+}
+
+static void
+tuple_arrow_child_schema_release(struct ArrowSchema *schema)
+{
+	free((char *)schema->name);
+	schema->release = NULL;
+}
+
+static void
+tuple_arrow_schema_release(struct ArrowSchema *schema)
+{
+	struct tuple_arrow_schema_data *data = schema->private_data;
+	for (int64_t i = 0; i < schema->n_children; i++) {
+		struct ArrowSchema *child = schema->children[i];
+		if (child->release != NULL)
+			child->release(child);
+	}
+	free(data->children);
+	free(data->child_ptrs);
+	free(data);
+	schema->release = NULL;
+}
+
+void
+tuple_arrow_builder_finish(struct tuple_arrow_builder *builder,
+			   struct ArrowArray *array,
+			   struct ArrowSchema *schema)
+{
+	uint32_t count = builder->column_count;
+	struct tuple_arrow_array_data *array_data =
+		xmalloc(sizeof(*array_data));
+	array_data->children = xcalloc(count, sizeof(struct ArrowArray));
+	array_data->child_ptrs = xcalloc(count, sizeof(struct ArrowArray *));
+	array_data->buffers = xcalloc(3 * count, sizeof(const void *));
+	array_data->struct_buffers[0] = NULL;
+	memset(array, 0, sizeof(*array));
+	array->length = builder->length;
+	array->n_buffers = 1;
+	array->buffers = array_data->struct_buffers;
+	array->n_children = count;
+	array->children = array_data->child_ptrs;
+	array->release = tuple_arrow_array_release;
+	array->private_data = array_data;
+
+	struct tuple_arrow_schema_data *schema_data =
+		xmalloc(sizeof(*schema_data));
+	schema_data->children = xcalloc(count, sizeof(struct ArrowSchema));
+	schema_data->child_ptrs = xcalloc(count, sizeof(struct ArrowSchema *));
+	memset(schema, 0, sizeof(*schema));
+	schema->format = "+s";
+	schema->name = "";
+	schema->n_children = count;
+	schema->children = schema_data->child_ptrs;
+	schema->release = tuple_arrow_schema_release;
+	schema->private_data = schema_data;
+
+	for (uint32_t i = 0; i < count; i++) {
+		struct tuple_arrow_column *column = &builder->columns[i];
+		struct ArrowArray *child = &array_data->children[i];
+		const void **buffers = &array_data->buffers[3 * i];
+		child->length = builder->length;
+		child->null_count = column->null_count;
+		child->n_buffers = tuple_arrow_buffer_count(column->format);
+		child->buffers = buffers;
+		child->release = tuple_arrow_child_array_release;
+		buffers[0] = column->validity.data;
+		buffers[1] = column->values.data;
+		buffers[2] = column->data.data;
+		array_data->child_ptrs[i] = child;
+
+		struct ArrowSchema *child_schema = &schema_data->children[i];
+		child_schema->format = column->format;
+		child_schema->name = column->name;
+		child_schema->flags = column->is_nullable ?
+				      ARROW_FLAG_NULLABLE : 0;
+		child_schema->release = tuple_arrow_child_schema_release;
+		schema_data->child_ptrs[i] = child_schema;
+		column->validity.data = NULL;
+		column->values.data = NULL;
+		column->data.data = NULL;
+		column->name = NULL;
+	}
+	tuple_arrow_builder_delete(builder);
+}
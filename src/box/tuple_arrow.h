@@ -0,0 +1,95 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "arrow/abi.h"
+#include "field_def.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct field_def;
+struct region;
+struct tuple;
+struct tuple_arrow_builder;
+struct tuple_dictionary;
+
+/** Mapping of record batch columns to tuple fields. */
+struct tuple_arrow_field_map {
+	/** Column number for each field, -1 if there's no such column. */
+	int64_t *columns;
+	/** Number of elements in the columns array. */
+	uint32_t field_count;
+};
+
+/**
+ * Checks that rows of a record batch can be converted to tuples: the batch
+ * must be a struct array of null, boolean, integer, floating point, string
+ * and binary columns named after fields of the space format given by
+ * @a dict. On success fills @a map allocated on @a region and returns 0.
+ * On error returns -1 and sets diag.
+ */
+int
+tuple_arrow_check(const struct ArrowArray *array,
+		  const struct ArrowSchema *schema,
+		  struct tuple_dictionary *dict, const char *space_name,
+		  struct region *region, struct tuple_arrow_field_map *map);
+
+/**
+ * Encodes the @a row-th row of a record batch checked with
+ * tuple_arrow_check() as a MsgPack array of tuple fields. Nulls and
+ * missing columns are encoded as MP_NIL, trailing nulls are omitted.
+ * The array is allocated on @a region.
+ */
+const char *
+tuple_arrow_encode_row(const struct ArrowArray *array,
+		       const struct ArrowSchema *schema,
+		       const struct tuple_arrow_field_map *map, int64_t row,
+		       struct region *region, const char **data_end);
+
+/**
+ * Returns the format of an Arrow column storing fields of the given type
+ * or NULL if the type isn't supported.
+ */
+const char *
+tuple_arrow_format(enum field_type type);
+
+/**
+ * Creates a builder of a record batch with a column per field of a space
+ * format. Only fields of boolean, integer, floating point, string and
+ * varbinary types are supported. Returns NULL on error (diag is set).
+ */
+struct tuple_arrow_builder *
+tuple_arrow_builder_new(const struct field_def *fields, uint32_t field_count);
+
+/** Deletes a builder. */
+void
+tuple_arrow_builder_delete(struct tuple_arrow_builder *builder);
+
+/**
+ * Appends a tuple conforming to the format to the record batch. Missing
+ * fields are appended as nulls. Returns 0 on success, -1 on error (diag
+ * is set).
+ */
+int
+tuple_arrow_builder_add(struct tuple_arrow_builder *builder,
+			struct tuple *tuple);
+
+/**
+ * Moves the built record batch to @a array and @a schema, which must be
+ * released by the caller, and deletes the builder.
+ */
+void
+tuple_arrow_builder_finish(struct tuple_arrow_builder *builder,
+			   struct ArrowArray *array,
+			   struct ArrowSchema *schema);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -41,9 +41,11 @@
 #include "coll/coll.h"
 #include "diag.h"
 #include "errcode.h"
+#include "errinj.h"
 #include "key_def.h"
 #include "tuple.h"
 #include "salad/bloom.h"
+#include "trivia/config.h"
 #include "trivia/util.h"
 #include <PMurHash.h>
 
@@ -157,6 +159,75 @@ tuple_hash_key_part_bloom_v2(uint32_t *ph1, uint32_t *pcarry,
 					 part->coll);
 }
 
+/**
+ * Allocates zeroed data of a bloom filter part. The data is aligned at
+ * the cache line boundary so that a block, which is never bigger than
+ * a cache line, doesn't cross one.
+ */
+static void *
+tuple_bloom_part_data_alloc(size_t size)
+{
+	/* The size passed to aligned_alloc() must be a multiple of it. */
+	size_t alloc_size = MAX(size, (size_t)1);
+	alloc_size = DIV_ROUND_UP(alloc_size, CACHELINE_SIZE) * CACHELINE_SIZE;
+	void *data = xaligned_alloc(alloc_size, CACHELINE_SIZE);
+	memset(data, 0, size);
+	return data;
+}
+
+/** Initializes a part definition for the given number of values. */
+static void
+tuple_bloom_part_create(enum tuple_bloom_version version,
+			struct tuple_bloom_part *part, uint32_t count,
+			double fpr)
+{
+	if (version == TUPLE_BLOOM_VERSION_V4)
+		bloom_split_create(&part->bloom, count, fpr);
+	else
+		bloom_create(&part->bloom, count, fpr);
+}
+
+/** Returns the expected false positive rate of the part. */
+static double
+tuple_bloom_part_fpr(enum tuple_bloom_version version,
+		     const struct tuple_bloom_part *part, uint32_t count)
+{
+	if (version == TUPLE_BLOOM_VERSION_V4)
+		return bloom_split_fpr(&part->bloom, count);
+	return bloom_fpr(&part->bloom, count);
+}
+
+/** Adds a value with the given hash to the part. */
+static void
+tuple_bloom_part_add(enum tuple_bloom_version version,
+		     struct tuple_bloom_part *part, uint32_t hash)
+{
+	if (version == TUPLE_BLOOM_VERSION_V4)
+		bloom_split_add(&part->bloom, part->data, hash);
+	else
+		bloom_add(&part->bloom, part->data, hash);
+}
+
+/** Check if a value with the given hash may be stored in the part. */
+static inline bool
+tuple_bloom_part_maybe_has(const struct tuple_bloom *bloom,
+			   const struct tuple_bloom_part *part, uint32_t hash)
+{
+	if (bloom->version == TUPLE_BLOOM_VERSION_V4)
+		return bloom_split_maybe_has(&part->bloom, part->data, hash);
+	return bloom_maybe_has(&part->bloom, part->data, hash);
+}
+
+/** Returns the size of the part data. */
+static size_t
+tuple_bloom_part_data_size(enum tuple_bloom_version version,
+			   const struct tuple_bloom_part *part)
+{
+	if (version == TUPLE_BLOOM_VERSION_V4)
+		return bloom_split_data_size(&part->bloom);
+	return bloom_data_size(&part->bloom);
+}
+
 struct tuple_bloom_builder *
 tuple_bloom_builder_new(uint32_t part_count)
 {
@@ -266,7 +337,12 @@ tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
 	size_t size = sizeof(struct tuple_bloom) +
 			part_count * sizeof(struct tuple_bloom_part);
 	struct tuple_bloom *bloom = xmalloc(size);
-	bloom->version = TUPLE_BLOOM_VERSION_V3;
+	enum tuple_bloom_version version = TUPLE_BLOOM_VERSION_V4;
+	/* Used for testing that legacy bloom filters can still be read. */
+	ERROR_INJECT(ERRINJ_TUPLE_BLOOM_LEGACY_V3, {
+		version = TUPLE_BLOOM_VERSION_V3;
+	});
+	bloom->version = version;
 	bloom->part_count = 0;
 
 	for (uint32_t i = 0; i < part_count; i++) {
@@ -282,17 +358,18 @@ tuple_bloom_new(struct tuple_bloom_builder *builder, double fpr)
 		 */
 		double part_fpr = fpr;
 		for (uint32_t j = 0; j < i; j++)
-			part_fpr /= bloom_fpr(&bloom->parts[j].bloom,
-					      count);
+			part_fpr /= tuple_bloom_part_fpr(version,
+							 &bloom->parts[j],
+							 count);
 		part_fpr = MIN(part_fpr, 0.5);
-		bloom_create(&bloom->parts[i].bloom, count, part_fpr);
-		bloom->parts[i].data = xcalloc(
-			1, bloom_data_size(&bloom->parts[i].bloom));
+		struct tuple_bloom_part *part = &bloom->parts[i];
+		tuple_bloom_part_create(version, part, count, part_fpr);
+		part->data = tuple_bloom_part_data_alloc(
+			tuple_bloom_part_data_size(version, part));
 		bloom->part_count++;
 		for (uint32_t k = 0; k < count; k++)
-			bloom_add(&bloom->parts[i].bloom,
-				  bloom->parts[i].data,
-				  hash_arr->values[k]);
+			tuple_bloom_part_add(version, part,
+					     hash_arr->values[k]);
 	}
 	return bloom;
 }
@@ -335,15 +412,14 @@ tuple_bloom_maybe_has(const struct tuple_bloom *bloom, struct tuple *tuple,
 		}
 		return true;
 	}
-	assert(bloom->version == TUPLE_BLOOM_VERSION_V3);
+	assert(bloom->version == TUPLE_BLOOM_VERSION_V3 ||
+	       bloom->version == TUPLE_BLOOM_VERSION_V4);
 	for (uint32_t i = 0; i < key_def->part_count; i++) {
 		total_size += tuple_hash_key_part(&h, &carry, tuple,
 						  &key_def->parts[i],
 						  multikey_idx);
 		uint32_t hash = PMurHash32_Result(h, carry, total_size);
-		if (!bloom_maybe_has(&bloom->parts[i].bloom,
-				     bloom->parts[i].data,
-				     hash))
+		if (!tuple_bloom_part_maybe_has(bloom, &bloom->parts[i], hash))
 			return false;
 	}
 	return true;
@@ -380,13 +456,13 @@ tuple_bloom_maybe_has_key(const struct tuple_bloom *bloom,
 		}
 		return true;
 	}
-	assert(bloom->version == TUPLE_BLOOM_VERSION_V3);
+	assert(bloom->version == TUPLE_BLOOM_VERSION_V3 ||
+	       bloom->version == TUPLE_BLOOM_VERSION_V4);
 	for (uint32_t i = 0; i < part_count; i++) {
 		total_size += tuple_hash_field(&h, &carry, &key,
 					       key_def->parts[i].coll);
 		uint32_t hash = PMurHash32_Result(h, carry, total_size);
-		if (!bloom_maybe_has(&bloom->parts[i].bloom,
-				     bloom->parts[i].data, hash))
+		if (!tuple_bloom_part_maybe_has(bloom, &bloom->parts[i], hash))
 			return false;
 	}
 	return true;
@@ -394,30 +470,34 @@ tuple_bloom_maybe_has_key(const struct tuple_bloom *bloom,
 
 /** Returns amount of bytes required to encode the part to MsgPack. */
 static size_t
-tuple_bloom_sizeof_part(const struct tuple_bloom_part *part)
+tuple_bloom_sizeof_part(enum tuple_bloom_version version,
+			const struct tuple_bloom_part *part)
 {
 	size_t size = 0;
 	size += mp_sizeof_array(3);
 	size += mp_sizeof_uint(part->bloom.table_size);
 	size += mp_sizeof_uint(part->bloom.hash_count);
-	size += mp_sizeof_bin(bloom_data_size(&part->bloom));
+	size += mp_sizeof_bin(tuple_bloom_part_data_size(version, part));
 	return size;
 }
 
 /** Encodes the part to MsgPack. */
 static char *
-tuple_bloom_encode_part(const struct tuple_bloom_part *part, char *buf)
+tuple_bloom_encode_part(enum tuple_bloom_version version,
+			const struct tuple_bloom_part *part, char *buf)
 {
 	buf = mp_encode_array(buf, 3);
 	buf = mp_encode_uint(buf, part->bloom.table_size);
 	buf = mp_encode_uint(buf, part->bloom.hash_count);
-	buf = mp_encode_bin(buf, part->data, bloom_data_size(&part->bloom));
+	buf = mp_encode_bin(buf, part->data,
+			    tuple_bloom_part_data_size(version, part));
 	return buf;
 }
 
 /** Decodes the part from MsgPack. */
 static void
-tuple_bloom_decode_part(struct tuple_bloom_part *part, const char **data)
+tuple_bloom_decode_part(enum tuple_bloom_version version,
+			struct tuple_bloom_part *part, const char **data)
 {
 	memset(part, 0, sizeof(*part));
 	if (mp_decode_array(data) != 3)
@@ -425,8 +505,10 @@ tuple_bloom_decode_part(struct tuple_bloom_part *part, const char **data)
 	part->bloom.table_size = mp_decode_uint(data);
 	part->bloom.hash_count = mp_decode_uint(data);
 	size_t store_size = mp_decode_binl(data);
-	assert(store_size == bloom_data_size(&part->bloom));
-	part->data = xmalloc(store_size);
+	assert(store_size == tuple_bloom_part_data_size(version, part));
+	assert(version != TUPLE_BLOOM_VERSION_V4 ||
+	       part->bloom.hash_count == BLOOM_SPLIT_HASH_COUNT);
+	part->data = tuple_bloom_part_data_alloc(store_size);
 	memcpy(part->data, *data, store_size);
 	*data += store_size;
 }
@@ -437,7 +519,8 @@ tuple_bloom_size(const struct tuple_bloom *bloom)
 	size_t size = 0;
 	size += mp_sizeof_array(bloom->part_count);
 	for (uint32_t i = 0; i < bloom->part_count; i++)
-		size += tuple_bloom_sizeof_part(&bloom->parts[i]);
+		size += tuple_bloom_sizeof_part(bloom->version,
+						&bloom->parts[i]);
 	return size;
 }
 
@@ -446,7 +529,8 @@ tuple_bloom_encode(const struct tuple_bloom *bloom, char *buf)
 {
 	buf = mp_encode_array(buf, bloom->part_count);
 	for (uint32_t i = 0; i < bloom->part_count; i++)
-		buf = tuple_bloom_encode_part(&bloom->parts[i], buf);
+		buf = tuple_bloom_encode_part(bloom->version,
+					      &bloom->parts[i], buf);
 	return buf;
 }
 
@@ -469,15 +553,17 @@ tuple_bloom_decode(const char **data, enum tuple_bloom_version version)
 		size_t store_size = mp_decode_binl(data);
 		assert(store_size ==
 		       bloom_data_size(&bloom->parts[0].bloom));
-		bloom->parts[0].data = xmalloc(store_size);
+		bloom->parts[0].data = tuple_bloom_part_data_alloc(store_size);
 		memcpy(bloom->parts[0].data, *data, store_size);
 		*data += store_size;
 		break;
 	case TUPLE_BLOOM_VERSION_V2:
 	case TUPLE_BLOOM_VERSION_V3:
+	case TUPLE_BLOOM_VERSION_V4:
 		bloom->part_count = 0;
 		for (uint32_t i = 0; i < part_count; i++) {
-			tuple_bloom_decode_part(&bloom->parts[i], data);
+			tuple_bloom_decode_part(version, &bloom->parts[i],
+						data);
 			bloom->part_count++;
 		}
 		break;
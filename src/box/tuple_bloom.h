@@ -51,8 +51,13 @@ enum tuple_bloom_version {
 	 * MessagePack integers.
 	 */
 	TUPLE_BLOOM_VERSION_V2,
-	/** The latest bloom filter. */
+	/** Bloom filter with the classic blocked layout. */
 	TUPLE_BLOOM_VERSION_V3,
+	/**
+	 * The latest bloom filter. Same hashing as V3, but uses the split
+	 * block layout, which is probed with one cache line access.
+	 */
+	TUPLE_BLOOM_VERSION_V4,
 };
 
 /** Holder for bloom filter definition along with its data. */
@@ -784,6 +784,8 @@ tuple_format_destroy(struct tuple_format *format)
 		format->constraint[i].destroy(&format->constraint[i]);
 	free(format->constraint);
 	free(format->data);
+	if (format->compression_dict != NULL)
+		tuple_compression_dict_unref(format->compression_dict);
 }
 
 /**
@@ -864,6 +866,7 @@ tuple_format_new(struct tuple_format_vtab *vtab, void *engine,
 	format->is_reusable = is_reusable;
 	/* This flag is set in `tuple_format_create` function. */
 	format->is_compressed = false;
+	format->compression_dict = NULL;
 	format->exact_field_count = exact_field_count;
 	format->epoch = ++formats_epoch;
 	if (format_data != NULL) {
@@ -927,6 +930,11 @@ bool
 tuple_format_is_compatible_with_key_def(struct tuple_format *format,
 					struct key_def *key_def)
 {
+	if (format->compression_dict != NULL && key_def->for_func_index) {
+		diag_set(ClientError, ER_UNSUPPORTED,
+			 "Functional index", "tuple compression");
+		return false;
+	}
         for (uint32_t i = 0; i < tuple_format_field_count(format); i++) {
         	struct tuple_field *field =
                         tuple_format_field(format, i);
@@ -97,6 +97,34 @@ struct tuple_format_vtab {
 
 struct tuple_constraint;
 
+/**
+ * Engine-specific state used for compression of tuples, for example
+ * a trained dictionary. The engine embeds this structure into its own
+ * one and sets the destructor.
+ */
+struct tuple_compression_dict {
+	/** Reference counter. */
+	int refs;
+	/** Called when the last reference is dropped. */
+	void
+	(*destroy)(struct tuple_compression_dict *dict);
+};
+
+static inline void
+tuple_compression_dict_ref(struct tuple_compression_dict *dict)
+{
+	assert(dict->refs >= 0);
+	dict->refs++;
+}
+
+static inline void
+tuple_compression_dict_unref(struct tuple_compression_dict *dict)
+{
+	assert(dict->refs > 0);
+	if (--dict->refs == 0)
+		dict->destroy(dict);
+}
+
 /** Tuple field default value. */
 struct field_default_value {
 	/**
@@ -246,6 +274,13 @@ struct tuple_format {
 	bool is_reusable;
 	/** True if tuples of this format may contain compressed fields. */
 	bool is_compressed;
+	/**
+	 * Compression state shared by all formats of a space or NULL.
+	 * Referenced. May be set even if is_compressed is false, because
+	 * tuples compressed before the space was altered must still be
+	 * decompressable.
+	 */
+	struct tuple_compression_dict *compression_dict;
 	/**
 	 * Size of minimal field map of tuple where each indexed
 	 * field has own offset slot (in bytes). The real tuple
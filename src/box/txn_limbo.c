@@ -173,23 +173,97 @@ txn_limbo_ack(struct txn_limbo *limbo, uint32_t replica_id, int64_t lsn)
 }
 
 /**
- * Write a confirmation entry to the WAL. After it's written all the
- * transactions waiting for confirmation may be finished.
+ * A CONFIRM request being written by the limbo worker. The confirmed LSN is
+ * chosen at the moment of submission to the journal, so a delayed request
+ * covers all the transactions which gathered a quorum while it was waiting.
+ */
+struct txn_limbo_confirm {
+	/** Journal entry with a single row, see journal_write_row(). */
+	char entry_buf[sizeof(struct journal_entry) +
+		       sizeof(struct xrow_header *)];
+	/** The request row. */
+	struct xrow_header row;
+	/** Body of the request row. */
+	char body[XROW_BODY_LEN_MAX];
+	/** The confirmed LSN. */
+	int64_t lsn;
+};
+
+/**
+ * Encode a CONFIRM for all the transactions which gathered a quorum and submit
+ * it to the journal. The worker is woken up on completion.
+ *
+ * May yield waiting for space in the journal queue, see journal_write_submit().
+ * Callers that must not yield have to check journal_queue_would_block() first.
  */
 static int
-txn_limbo_write_confirm(struct txn_limbo *limbo, int64_t lsn)
+txn_limbo_confirm_submit(struct txn_limbo *limbo,
+			 struct txn_limbo_confirm *confirm)
 {
-	txn_limbo_assert_locked(limbo);
-	assert(lsn > limbo->queue.confirmed_lsn);
 	assert(!limbo->is_in_rollback);
+	confirm->lsn = limbo->queue.volatile_confirmed_lsn;
+	assert(confirm->lsn > limbo->queue.confirmed_lsn);
 	struct synchro_request req = {
 		.type = IPROTO_RAFT_CONFIRM,
 		.queue_owner_id = limbo->queue.owner_id,
 		.confirm = {
-			.lsn = lsn
+			.lsn = confirm->lsn
 		},
 	};
-	return synchro_request_write(&req);
+	xrow_encode_synchro(&confirm->row, confirm->body, &req);
+	struct journal_entry *entry =
+		(struct journal_entry *)confirm->entry_buf;
+	entry->rows[0] = &confirm->row;
+	journal_entry_create(entry, 1, xrow_approx_len(&confirm->row),
+			     journal_entry_fiber_wakeup_cb, limbo->worker);
+	return journal_write_submit(entry);
+}
+
+/**
+ * Write a confirmation entry to the WAL. After it's written all the
+ * transactions waiting for confirmation may be finished.
+ *
+ * With replication_synchro_confirm_delay set, the entry isn't submitted right
+ * away, but waits for another journal write during the delay. Then it is
+ * submitted right after that write, gets into the same WAL batch and doesn't
+ * cost a separate write and fsync.
+ */
+static int
+txn_limbo_write_confirm(struct txn_limbo *limbo,
+			struct txn_limbo_confirm *confirm)
+{
+	assert(limbo->worker == fiber());
+	txn_limbo_assert_locked(limbo);
+	assert(!limbo->is_in_rollback);
+	double start = fiber_clock();
+	limbo->pending_confirm = confirm;
+	while (limbo->pending_confirm == confirm &&
+	       !fiber_is_cancelled()) {
+		double timeout = start + replication_synchro_confirm_delay -
+				 fiber_clock();
+		if (timeout <= 0)
+			break;
+		fiber_yield_timeout(timeout);
+	}
+	if (limbo->pending_confirm == confirm) {
+		/*
+		 * Reset it before the submission: it may yield and the
+		 * request must not be submitted once again by
+		 * txn_limbo_on_journal_submit() meanwhile.
+		 */
+		limbo->pending_confirm = NULL;
+		if (txn_limbo_confirm_submit(limbo, confirm) != 0)
+			return -1;
+	}
+	struct journal_entry *entry =
+		(struct journal_entry *)confirm->entry_buf;
+	while (!entry->is_complete)
+		fiber_yield();
+	if (entry->res < 0) {
+		diag_set_journal_res(entry->res);
+		return -1;
+	}
+	return 0;
 }
 
 /**
@@ -225,13 +299,13 @@ txn_limbo_worker_bump_confirmed_lsn(struct txn_limbo *limbo)
 		if (limbo->is_in_rollback)
 			return -1;
 		/* It can get bumped again while we are writing. */
-		int64_t lsn = queue->volatile_confirmed_lsn;
-		if (txn_limbo_write_confirm(limbo, lsn) != 0) {
+		struct txn_limbo_confirm confirm;
+		if (txn_limbo_write_confirm(limbo, &confirm) != 0) {
 			diag_log();
 			return -1;
 		}
 		ERROR_INJECT_YIELD(ERRINJ_TXN_LIMBO_WORKER_DELAY);
-		txn_limbo_queue_apply_confirm(queue, lsn);
+		txn_limbo_queue_apply_confirm(queue, confirm.lsn);
 	}
 	assert(queue->volatile_confirmed_lsn >= queue->confirmed_lsn);
 	return 0;
@@ -1068,6 +1142,31 @@ txn_limbo_process(struct txn_limbo *limbo, const struct synchro_request *req)
 	return 0;
 }
 
+void
+txn_limbo_on_journal_submit(struct txn_limbo *limbo)
+{
+	struct txn_limbo_confirm *confirm = limbo->pending_confirm;
+	/*
+	 * We are called from a fiber doing a journal write, which mustn't
+	 * yield here, so give up if the submission would wait for space in
+	 * the journal queue. The worker submits the request on its own after
+	 * the delay.
+	 */
+	if (confirm == NULL || journal_queue_would_block())
+		return;
+	/* Reset it first, the submission below calls this function again. */
+	limbo->pending_confirm = NULL;
+	if (txn_limbo_confirm_submit(limbo, confirm) != 0) {
+		/*
+		 * Don't clobber the diag of a fiber which has nothing to do
+		 * with the limbo. The worker retries on its own after the
+		 * delay and reports the error.
+		 */
+		diag_clear(diag_get());
+		limbo->pending_confirm = confirm;
+	}
+}
+
 void
 txn_limbo_on_parameters_change(struct txn_limbo *limbo)
 {
@@ -1084,6 +1183,9 @@ txn_limbo_on_parameters_change(struct txn_limbo *limbo)
 	 * sync transactions can live on replica infinitely.
 	 */
 	fiber_cond_broadcast(&limbo->queue.cond);
+	/* The pending CONFIRM delay may have changed. */
+	if (limbo->pending_confirm != NULL)
+		fiber_wakeup(limbo->worker);
 }
 
 void
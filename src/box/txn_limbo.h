@@ -39,6 +39,7 @@ extern "C" {
 
 struct raft;
 struct synchro_request;
+struct txn_limbo_confirm;
 
 /** Limbo state. */
 enum txn_limbo_state {
@@ -171,6 +172,12 @@ struct txn_limbo {
 	 * `confirmed_lsn`.
 	 */
 	struct fiber *worker;
+	/**
+	 * CONFIRM request the worker waits to get written together with the
+	 * next journal write to save a separate WAL write, see
+	 * replication_synchro_confirm_delay. NULL if there is no such request.
+	 */
+	struct txn_limbo_confirm *pending_confirm;
 	/** A trigger invoked on replica acks. */
 	struct trigger on_ack;
 };
@@ -349,6 +356,13 @@ txn_limbo_promote(struct txn_limbo *limbo, uint16_t type, double timeout);
 void
 txn_limbo_on_parameters_change(struct txn_limbo *limbo);
 
+/**
+ * Let the pending CONFIRM request, if any, join the journal write that has
+ * just been submitted. Must be called after each journal submission.
+ */
+void
+txn_limbo_on_journal_submit(struct txn_limbo *limbo);
+
 /**
  * Rollback all the volatile txns. That is, the ones waiting for space in the
  * limbo and not yet sent to the journal. It is supposed to happen when some
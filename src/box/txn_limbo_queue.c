@@ -4,6 +4,16 @@
 #include "session.h"
 #include "txn.h"
 
+const char *txn_limbo_latency_stage_strs[] = {
+	"quorum",
+	"confirm",
+	"total",
+};
+
+static_assert(lengthof(txn_limbo_latency_stage_strs) ==
+	      txn_limbo_latency_stage_MAX,
+	      "txn_limbo_latency_stage_strs is out of sync");
+
 /*******************************************************************************
  * Private API
  ******************************************************************************/
@@ -133,8 +143,20 @@ txn_limbo_queue_complete_success(struct txn_limbo_queue *queue,
 	assert(entry->state == TXN_LIMBO_ENTRY_SUBMITTED);
 	struct txn *txn = entry->txn;
 	entry->state = TXN_LIMBO_ENTRY_COMMIT;
-	if (txn_has_flag(txn, TXN_WAIT_ACK))
-		queue->confirm_lag = fiber_clock() - entry->insertion_time;
+	if (txn_has_flag(txn, TXN_WAIT_ACK)) {
+		double now = fiber_clock();
+		queue->confirm_lag = now - entry->insertion_time;
+		if (entry->quorum_time != 0) {
+			struct latency *latency = queue->latency;
+			latency_collect(&latency[TXN_LIMBO_LATENCY_QUORUM],
+					entry->quorum_time -
+					entry->insertion_time);
+			latency_collect(&latency[TXN_LIMBO_LATENCY_CONFIRM],
+					now - entry->quorum_time);
+			latency_collect(&latency[TXN_LIMBO_LATENCY_TOTAL],
+					queue->confirm_lag);
+		}
+	}
 	txn->limbo_entry = NULL;
 	txn_limbo_queue_pop_first(queue, entry);
 	txn_clear_flags(txn, TXN_WAIT_SYNC | TXN_WAIT_ACK);
@@ -279,6 +301,7 @@ txn_limbo_queue_submit(struct txn_limbo_queue *queue, uint32_t origin_id,
 	e->approx_len = approx_len;
 	e->lsn = -1;
 	e->insertion_time = fiber_clock();
+	e->quorum_time = 0;
 	txn->limbo_entry = e;
 	bool would_block = txn_limbo_queue_would_block(queue);
 	rlist_add_tail_entry(&queue->entries, e, in_queue);
@@ -792,6 +815,7 @@ txn_limbo_queue_bump_volatile_confirm(struct txn_limbo_queue *queue)
 	struct txn_limbo_entry *e = queue->entry_to_confirm;
 	queue->entry_to_confirm = NULL;
 	int64_t max_assigned_lsn = -1;
+	double now = fiber_clock();
 	for (; !rlist_entry_is_head(e, &queue->entries, in_queue);
 	       e = rlist_next_entry(e, in_queue)) {
 		if (!txn_has_flag(e->txn, TXN_WAIT_ACK))
@@ -808,6 +832,7 @@ txn_limbo_queue_bump_volatile_confirm(struct txn_limbo_queue *queue)
 			break;
 		} else {
 			max_assigned_lsn = e->lsn;
+			e->quorum_time = now;
 		}
 	}
 	assert(max_assigned_lsn != -1);
@@ -920,6 +945,10 @@ txn_limbo_queue_create(struct txn_limbo_queue *queue)
 	vclock_create(&queue->vclock);
 	vclock_create(&queue->confirmed_vclock);
 	fiber_cond_create(&queue->cond);
+	for (int i = 0; i < txn_limbo_latency_stage_MAX; i++) {
+		if (latency_create(&queue->latency[i]) != 0)
+			panic("failed to allocate limbo latency statistics");
+	}
 }
 
 void
@@ -933,5 +962,7 @@ txn_limbo_queue_destroy(struct txn_limbo_queue *queue)
 		entry->txn->limbo_entry = NULL;
 		txn_free(entry->txn);
 	}
+	for (int i = 0; i < txn_limbo_latency_stage_MAX; i++)
+		latency_destroy(&queue->latency[i]);
 	TRASH(queue);
 }
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "core/fiber_cond.h"
+#include "core/latency.h"
 #include "replication.h"
 #include "small/rlist.h"
 #include "vclock/vclock.h"
@@ -71,8 +72,27 @@ struct txn_limbo_entry {
 	enum txn_limbo_entry_state state;
 	/** When this entry was added to the queue. */
 	double insertion_time;
+	/**
+	 * When this entry gathered the quorum. Set only on the queue owner,
+	 * 0 otherwise.
+	 */
+	double quorum_time;
+};
+
+/** Stages of a synchronous transaction life in the queue. */
+enum txn_limbo_latency_stage {
+	/** From submission to the queue until the quorum is gathered. */
+	TXN_LIMBO_LATENCY_QUORUM,
+	/** From gathering the quorum until CONFIRM is written. */
+	TXN_LIMBO_LATENCY_CONFIRM,
+	/** From submission to the queue until CONFIRM is written. */
+	TXN_LIMBO_LATENCY_TOTAL,
+	txn_limbo_latency_stage_MAX,
 };
 
+/** Lowercase names of the latency stages. */
+extern const char *txn_limbo_latency_stage_strs[];
+
 /**
  * Synchronous transactions and other ones depending on them. The limbo-queue
  * encapsulates all the logic of the simple but a bit bulky management of the
@@ -159,6 +179,11 @@ struct txn_limbo_queue {
 	 * quorum.
 	 */
 	double confirm_lag;
+	/**
+	 * Latencies of the synchronous transactions confirmed by this
+	 * instance as the queue owner, by stage.
+	 */
+	struct latency latency[txn_limbo_latency_stage_MAX];
 	/**
 	 * Condition on which the transactions can be waiting when blocked on
 	 * anything like submission into the queue when the max size is already
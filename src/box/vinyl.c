@@ -305,11 +305,24 @@ vy_info_append_memory(struct vy_env *env, struct info_handler *h)
 	assert(sum_tuple_size >= 0);
 	info_append_int(h, "tuple", sum_tuple_size);
 	info_append_int(h, "tuple_cache", env->cache_env.mem_used);
+	info_append_int(h, "page_cache", env->run_env.page_cache.mem_used);
 	info_append_int(h, "page_index", env->lsm_env.page_index_size);
 	info_append_int(h, "bloom_filter", env->lsm_env.bloom_size);
 	info_table_end(h); /* memory */
 }
 
+static void
+vy_info_append_page_cache(struct vy_env *env, struct info_handler *h)
+{
+	struct vy_page_cache *cache = &env->run_env.page_cache;
+	info_table_begin(h, "page_cache");
+	info_append_int(h, "lookup", cache->stat.lookup);
+	info_append_int(h, "hit", cache->stat.hit);
+	info_append_int(h, "put", cache->stat.put);
+	info_append_int(h, "evict", cache->stat.evict);
+	info_table_end(h); /* page_cache */
+}
+
 static void
 vy_info_append_disk(struct vy_env *env, struct info_handler *h)
 {
@@ -328,6 +341,7 @@ vinyl_engine_stat(struct engine *engine, struct info_handler *h)
 	info_begin(h);
 	vy_info_append_tx(env, h);
 	vy_info_append_memory(env, h);
+	vy_info_append_page_cache(env, h);
 	vy_info_append_disk(env, h);
 	vy_info_append_scheduler(env, h);
 	vy_info_append_regulator(env, h);
@@ -518,6 +532,7 @@ vinyl_engine_memory_stat(struct engine *engine, struct engine_memory_stat *stat)
 	stat->index += env->lsm_env.bloom_size;
 	stat->index += env->lsm_env.page_index_size;
 	stat->cache += env->cache_env.mem_used;
+	stat->cache += env->run_env.page_cache.mem_used;
 	stat->tx += vy_tx_manager_mem_used(env->xm);
 }
 
@@ -528,6 +543,8 @@ vinyl_engine_reset_stat(struct engine *engine)
 
 	struct vy_tx_manager *xm = env->xm;
 	memset(&xm->stat, 0, sizeof(xm->stat));
+	memset(&env->run_env.page_cache.stat, 0,
+	       sizeof(env->run_env.page_cache.stat));
 
 	vy_scheduler_reset_stat(&env->scheduler);
 	vy_regulator_reset_stat(&env->regulator);
@@ -599,6 +616,11 @@ vinyl_engine_check_space_def(struct space_def *def)
 			return -1;
 		}
 	}
+	if (def->opts.compression != SPACE_COMPRESSION_NONE) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Vinyl",
+			 "tuple compression");
+		return -1;
+	}
 	if (space_opts_is_data_temporary(&def->opts)) {
 		diag_set(ClientError, ER_ALTER_SPACE,
 			 def->name,
@@ -2862,6 +2884,13 @@ vinyl_engine_set_cache(struct engine *engine, size_t quota)
 	vy_cache_env_set_quota(&env->cache_env, quota);
 }
 
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota)
+{
+	struct vy_env *env = vy_env(engine);
+	vy_page_cache_set_quota(&env->run_env.page_cache, quota);
+}
+
 int
 vinyl_engine_set_memory(struct engine *engine, size_t size)
 {
@@ -780,8 +780,8 @@ vy_lsm_add_range(struct vy_lsm *lsm, struct vy_range *range)
 void
 vy_lsm_remove_range(struct vy_lsm *lsm, struct vy_range *range)
 {
-	assert(! heap_node_is_stray(&range->heap_node));
-	vy_range_heap_delete(&lsm->range_heap, range);
+	if (!vy_range_is_scheduled(range))
+		vy_range_heap_delete(&lsm->range_heap, range);
 	vy_range_tree_remove(&lsm->range_tree, range);
 	lsm->range_count--;
 }
@@ -483,7 +483,8 @@ vy_lsm_add_range(struct vy_lsm *lsm, struct vy_range *range);
 
 /**
  * Remove a range from both the range tree and the range
- * heap of an LSM tree.
+ * heap of an LSM tree. A range scheduled for compaction
+ * isn't in the heap so it's removed only from the tree.
  */
 void
 vy_lsm_remove_range(struct vy_lsm *lsm, struct vy_range *range);
@@ -0,0 +1,168 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "vy_page_cache.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "vy_run.h"
+
+/** Page cache lookup key. */
+struct vy_page_cache_key {
+	/** Id of the run the page belongs to. */
+	int64_t run_id;
+	/** Page number in the run. */
+	uint32_t page_no;
+};
+
+static inline uint32_t
+vy_page_cache_hash(int64_t run_id, uint32_t page_no)
+{
+	uint64_t h = (uint64_t)run_id * 0x9E3779B97F4A7C15ULL + page_no;
+	return (uint32_t)(h ^ (h >> 32));
+}
+
+#define mh_name _vy_page_cache
+#define mh_key_t const struct vy_page_cache_key *
+#define mh_node_t struct vy_page *
+#define mh_arg_t void *
+#define mh_hash(a, arg) (vy_page_cache_hash((*(a))->run_id, (*(a))->page_no))
+#define mh_hash_key(a, arg) (vy_page_cache_hash((a)->run_id, (a)->page_no))
+#define mh_cmp(a, b, arg) ((*(a))->run_id != (*(b))->run_id || \
+			   (*(a))->page_no != (*(b))->page_no)
+#define mh_cmp_key(a, b, arg) ((a)->run_id != (*(b))->run_id || \
+			       (a)->page_no != (*(b))->page_no)
+#define MH_SOURCE 1
+#include "salad/mhash.h"
+
+/** Memory taken by a cached page. */
+static inline size_t
+vy_page_cache_page_size(struct vy_page *page)
+{
+	return sizeof(*page) + page->unpacked_size +
+	       page->row_count * sizeof(*page->row_index);
+}
+
+void
+vy_page_cache_create(struct vy_page_cache *cache)
+{
+	cache->hash = mh_vy_page_cache_new();
+	rlist_create(&cache->lru);
+	cache->quota = 0;
+	cache->mem_used = 0;
+	memset(&cache->stat, 0, sizeof(cache->stat));
+}
+
+/** Remove a page from the cache and drop the cache reference. */
+static void
+vy_page_cache_evict(struct vy_page_cache *cache, struct vy_page *page)
+{
+	struct vy_page_cache_key key = {
+		.run_id = page->run_id,
+		.page_no = page->page_no,
+	};
+	mh_int_t pos = mh_vy_page_cache_find(cache->hash, &key, NULL);
+	assert(pos != mh_end(cache->hash));
+	mh_vy_page_cache_del(cache->hash, pos, NULL);
+	rlist_del_entry(page, in_lru);
+	assert(cache->mem_used >= vy_page_cache_page_size(page));
+	cache->mem_used -= vy_page_cache_page_size(page);
+	vy_page_unref(page);
+}
+
+/** Evict the least recently used pages until the cache fits in the quota. */
+static void
+vy_page_cache_gc(struct vy_page_cache *cache)
+{
+	while (cache->mem_used > cache->quota) {
+		assert(!rlist_empty(&cache->lru));
+		struct vy_page *page = rlist_last_entry(&cache->lru,
+							struct vy_page, in_lru);
+		vy_page_cache_evict(cache, page);
+		cache->stat.evict++;
+	}
+}
+
+void
+vy_page_cache_destroy(struct vy_page_cache *cache)
+{
+	cache->quota = 0;
+	vy_page_cache_gc(cache);
+	assert(mh_size(cache->hash) == 0);
+	mh_vy_page_cache_delete(cache->hash);
+}
+
+void
+vy_page_cache_set_quota(struct vy_page_cache *cache, size_t quota)
+{
+	cache->quota = quota;
+	vy_page_cache_gc(cache);
+}
+
+struct vy_page *
+vy_page_cache_get(struct vy_page_cache *cache, int64_t run_id,
+		  uint32_t page_no)
+{
+	if (mh_size(cache->hash) == 0)
+		return NULL;
+	cache->stat.lookup++;
+	struct vy_page_cache_key key = {
+		.run_id = run_id,
+		.page_no = page_no,
+	};
+	mh_int_t pos = mh_vy_page_cache_find(cache->hash, &key, NULL);
+	if (pos == mh_end(cache->hash))
+		return NULL;
+	struct vy_page *page = *mh_vy_page_cache_node(cache->hash, pos);
+	rlist_move_entry(&cache->lru, page, in_lru);
+	cache->stat.hit++;
+	return page;
+}
+
+void
+vy_page_cache_put(struct vy_page_cache *cache, struct vy_page *page)
+{
+	size_t size = vy_page_cache_page_size(page);
+	if (size > cache->quota)
+		return;
+	struct vy_page *replaced = NULL;
+	struct vy_page **replaced_ptr = &replaced;
+	mh_vy_page_cache_put(cache->hash, &page, &replaced_ptr, NULL);
+	if (replaced != NULL) {
+		/*
+		 * The same page may be read concurrently by two fibers.
+		 * Keep the most recently read copy.
+		 */
+		rlist_del_entry(replaced, in_lru);
+		cache->mem_used -= vy_page_cache_page_size(replaced);
+		vy_page_unref(replaced);
+	}
+	vy_page_ref(page);
+	rlist_add_entry(&cache->lru, page, in_lru);
+	cache->mem_used += size;
+	cache->stat.put++;
+	vy_page_cache_gc(cache);
+}
+
+void
+vy_page_cache_invalidate_run(struct vy_page_cache *cache, int64_t run_id,
+			     uint32_t page_count)
+{
+	for (uint32_t page_no = 0; page_no < page_count; page_no++) {
+		if (mh_size(cache->hash) == 0)
+			break;
+		struct vy_page_cache_key key = {
+			.run_id = run_id,
+			.page_no = page_no,
+		};
+		mh_int_t pos = mh_vy_page_cache_find(cache->hash, &key, NULL);
+		if (pos != mh_end(cache->hash)) {
+			vy_page_cache_evict(
+				cache, *mh_vy_page_cache_node(cache->hash, pos));
+		}
+	}
+}
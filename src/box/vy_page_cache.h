@@ -0,0 +1,90 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <small/rlist.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct vy_page;
+struct mh_vy_page_cache_t;
+
+/** Page cache statistics. */
+struct vy_page_cache_stat {
+	/** Number of lookups in the cache. */
+	int64_t lookup;
+	/** Number of lookups that found a page. */
+	int64_t hit;
+	/** Number of pages added to the cache. */
+	int64_t put;
+	/** Number of pages evicted from the cache. */
+	int64_t evict;
+};
+
+/**
+ * Cache of decompressed run pages shared by all vinyl LSM trees.
+ *
+ * A page is identified by the run id and the page number. Pages are
+ * reference counted: a page stays in memory while it's referenced by
+ * the cache or by a run iterator. When the cache size exceeds the quota,
+ * the least recently used pages are evicted.
+ *
+ * The cache may only be used from the tx thread.
+ */
+struct vy_page_cache {
+	/** Pages indexed by run id and page number. */
+	struct mh_vy_page_cache_t *hash;
+	/** LRU list of cached pages, the most recently used first. */
+	struct rlist lru;
+	/** Max size of cached pages, in bytes. */
+	size_t quota;
+	/** Size of cached pages, in bytes. */
+	size_t mem_used;
+	/** Cache statistics. */
+	struct vy_page_cache_stat stat;
+};
+
+/** Create a page cache. The quota is zero, i.e. the cache is disabled. */
+void
+vy_page_cache_create(struct vy_page_cache *cache);
+
+/** Destroy a page cache and release all cached pages. */
+void
+vy_page_cache_destroy(struct vy_page_cache *cache);
+
+/** Set the cache quota, evicting pages that don't fit. */
+void
+vy_page_cache_set_quota(struct vy_page_cache *cache, size_t quota);
+
+/**
+ * Look up a page in the cache. Returns NULL if not found. The returned
+ * page isn't referenced: the caller must take a reference to keep it.
+ */
+struct vy_page *
+vy_page_cache_get(struct vy_page_cache *cache, int64_t run_id,
+		  uint32_t page_no);
+
+/**
+ * Add a page to the cache. The page must have its run id and page
+ * number set. The cache takes a reference to the page. Does nothing
+ * if the page doesn't fit in the quota.
+ */
+void
+vy_page_cache_put(struct vy_page_cache *cache, struct vy_page *page);
+
+/** Evict all pages of a run from the cache. */
+void
+vy_page_cache_invalidate_run(struct vy_page_cache *cache, int64_t run_id,
+			     uint32_t page_count);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -41,6 +41,7 @@
 #include "mp_util.h"
 #include "replication.h"
 #include "tuple_bloom.h"
+#include "uring.h"
 #include "xlog.h"
 #include "xrow.h"
 #include "vy_history.h"
@@ -58,6 +59,19 @@ static const uint64_t vy_run_info_key_map = (1 << VY_RUN_INFO_MIN_KEY) |
 					    (1 << VY_RUN_INFO_MAX_LSN) |
 					    (1 << VY_RUN_INFO_PAGE_COUNT);
 
+enum {
+	/**
+	 * Size of the io_uring submission queue used by a run reader
+	 * thread. Pages are read one at a time.
+	 */
+	VY_RUN_READER_URING_ENTRIES = 4,
+	/**
+	 * Size of the buffer registered in the io_uring of a run reader
+	 * thread. Pages that don't fit are read into a temporary buffer.
+	 */
+	VY_RUN_READER_URING_BUF_SIZE = 1024 * 1024,
+};
+
 /** xlog meta type for .run files */
 #define XLOG_META_TYPE_RUN "RUN"
 
@@ -119,6 +133,13 @@ vy_free_zdctx(void *arg)
 	ZSTD_freeDStream(arg);
 }
 
+/**
+ * Ring used by the current run reader thread to read pages or NULL if
+ * io_uring isn't available. Pages are read into the buffer registered
+ * in the ring so we don't need to allocate memory for compressed data.
+ */
+static __thread struct uring *vy_run_reader_uring;
+
 /** Run reader thread function. */
 static int
 vy_run_reader_f(va_list ap)
@@ -126,12 +147,18 @@ vy_run_reader_f(va_list ap)
 	struct vy_run_reader *reader = va_arg(ap, struct vy_run_reader *);
 	struct cbus_endpoint endpoint;
 
+	vy_run_reader_uring = uring_new(VY_RUN_READER_URING_ENTRIES,
+					VY_RUN_READER_URING_BUF_SIZE);
 	cpipe_create(&reader->tx_pipe, "tx_prio");
 	cbus_endpoint_create(&endpoint, cord_name(cord()),
 			     fiber_schedule_cb, fiber());
 	cbus_loop(&endpoint);
 	cbus_endpoint_destroy(&endpoint, cbus_process);
 	cpipe_destroy(&reader->tx_pipe);
+	if (vy_run_reader_uring != NULL) {
+		uring_delete(vy_run_reader_uring);
+		vy_run_reader_uring = NULL;
+	}
 	return 0;
 }
 
@@ -189,6 +216,7 @@ vy_run_env_create(struct vy_run_env *env, int read_threads)
 	mempool_create(&env->read_task_pool, cord_slab_cache(),
 		       sizeof(struct vy_page_read_task));
 	env->initial_join = false;
+	vy_page_cache_create(&env->page_cache);
 }
 
 /**
@@ -201,6 +229,7 @@ vy_run_env_destroy(struct vy_run_env *env)
 		vy_run_env_stop_readers(env);
 	mempool_destroy(&env->read_task_pool);
 	tt_pthread_key_delete(env->zdctx_key);
+	vy_page_cache_destroy(&env->page_cache);
 }
 
 /**
@@ -313,6 +342,8 @@ vy_run_delete(struct vy_run *run)
 	assert(run->refs == 0);
 	if (run->fd >= 0 && close(run->fd) < 0)
 		say_syserror("close failed");
+	vy_page_cache_invalidate_run(&run->env->page_cache, run->id,
+				     run->info.page_count);
 	vy_run_clear(run);
 	TRASH(run);
 	free(run);
@@ -624,8 +655,10 @@ iproto_to_tuple_bloom_version(uint32_t key)
 		return TUPLE_BLOOM_VERSION_V1;
 	case VY_RUN_INFO_BLOOM_FILTER_LEGACY_V2:
 		return TUPLE_BLOOM_VERSION_V2;
-	case VY_RUN_INFO_BLOOM_FILTER:
+	case VY_RUN_INFO_BLOOM_FILTER_LEGACY_V3:
 		return TUPLE_BLOOM_VERSION_V3;
+	case VY_RUN_INFO_BLOOM_FILTER:
+		return TUPLE_BLOOM_VERSION_V4;
 	default:
 		unreachable();
 	}
@@ -641,6 +674,8 @@ tuple_bloom_version_to_iproto(enum tuple_bloom_version version)
 	case TUPLE_BLOOM_VERSION_V2:
 		return VY_RUN_INFO_BLOOM_FILTER_LEGACY_V2;
 	case TUPLE_BLOOM_VERSION_V3:
+		return VY_RUN_INFO_BLOOM_FILTER_LEGACY_V3;
+	case TUPLE_BLOOM_VERSION_V4:
 		return VY_RUN_INFO_BLOOM_FILTER;
 	default:
 		unreachable();
@@ -697,6 +732,7 @@ vy_run_info_decode(struct vy_run_info *run_info,
 			break;
 		case VY_RUN_INFO_BLOOM_FILTER_LEGACY_V1:
 		case VY_RUN_INFO_BLOOM_FILTER_LEGACY_V2:
+		case VY_RUN_INFO_BLOOM_FILTER_LEGACY_V3:
 		case VY_RUN_INFO_BLOOM_FILTER:
 			run_info->bloom = tuple_bloom_decode(
 				&pos, iproto_to_tuple_bloom_version(key));
@@ -729,6 +765,9 @@ vy_page_new(const struct vy_page_info *page_info)
 			 "load_page", "page cache");
 		return NULL;
 	}
+	page->run_id = -1;
+	page->refs = 1;
+	rlist_create(&page->in_lru);
 	page->unpacked_size = page_info->unpacked_size;
 	page->row_count = page_info->row_count;
 	page->row_index = calloc(page_info->row_count, sizeof(uint32_t));
@@ -765,6 +804,14 @@ vy_page_delete(struct vy_page *page)
 	free(page);
 }
 
+void
+vy_page_unref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	if (--page->refs == 0)
+		vy_page_delete(page);
+}
+
 static int
 vy_page_xrow(struct vy_page *page, uint32_t stmt_no,
 	     struct xrow_header *xrow)
@@ -893,9 +940,9 @@ vy_run_iterator_stop(struct vy_run_iterator *itr)
 		itr->curr = vy_entry_none();
 	}
 	if (itr->curr_page != NULL) {
-		vy_page_delete(itr->curr_page);
+		vy_page_unref(itr->curr_page);
 		if (itr->prev_page != NULL)
-			vy_page_delete(itr->prev_page);
+			vy_page_unref(itr->prev_page);
 		itr->curr_page = itr->prev_page = NULL;
 	}
 }
@@ -954,13 +1001,25 @@ vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
 {
 	/* read xlog tx from xlog file */
 	size_t region_svp = region_used(&fiber()->gc);
-	char *data = (char *)region_alloc(&fiber()->gc, page_info->size);
-	if (data == NULL) {
-		diag_set(OutOfMemory, page_info->size, "region gc", "page");
-		return -1;
-	}
-	ssize_t readen = fio_pread(run->fd, data, page_info->size,
+	const char *data;
+	ssize_t readen = -1;
+	if (vy_run_reader_uring != NULL) {
+		readen = uring_read_fixed(vy_run_reader_uring, run->fd,
+					  page_info->size, page_info->offset,
+					  &data);
+	}
+	if (readen < 0 && (vy_run_reader_uring == NULL || errno == ENOBUFS)) {
+		char *buf = (char *)region_alloc(&fiber()->gc,
+						 page_info->size);
+		if (buf == NULL) {
+			diag_set(OutOfMemory, page_info->size, "region gc",
+				 "page");
+			return -1;
+		}
+		readen = fio_pread(run->fd, buf, page_info->size,
 				   page_info->offset);
+		data = buf;
+	}
 	ERROR_INJECT(ERRINJ_VYRUN_DATA_READ, {
 		readen = -1;
 		errno = EIO;});
@@ -1055,9 +1114,20 @@ vy_page_read_cb(struct cbus_call_msg *base)
 	return 0;
 }
 
+/** Replace the least recently used page of a run iterator. */
+static void
+vy_run_iterator_cache_page(struct vy_run_iterator *itr, struct vy_page *page)
+{
+	if (itr->prev_page != NULL)
+		vy_page_unref(itr->prev_page);
+	itr->prev_page = itr->curr_page;
+	itr->curr_page = page;
+}
+
 /**
  * Read a page from disk given its number.
- * The function caches two most recently read pages.
+ * The function caches two most recently read pages. Besides, pages
+ * are looked up in and added to the page cache shared by all runs.
  *
  * @retval 0 success
  * @retval -1 critical error
@@ -1091,6 +1161,20 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 		return 0;
 	}
 
+	/* Check the shared page cache */
+	page = vy_page_cache_get(&env->page_cache, slice->run->id, page_no);
+	if (page != NULL) {
+		if (key.stmt != NULL &&
+		    vy_page_find_key(page, key, itr->cmp_def,
+				     itr->is_primary, iterator_type,
+				     pos_in_page, equal_found) != 0)
+			return -1;
+		vy_page_ref(page);
+		vy_run_iterator_cache_page(itr, page);
+		*result = page;
+		return 0;
+	}
+
 	/* Allocate buffers */
 	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
 	page = vy_page_new(page_info);
@@ -1127,11 +1211,10 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	}
 
 	/* Update cache */
-	if (itr->prev_page != NULL)
-		vy_page_delete(itr->prev_page);
-	itr->prev_page = itr->curr_page;
-	itr->curr_page = page;
+	page->run_id = slice->run->id;
 	page->page_no = page_no;
+	vy_run_iterator_cache_page(itr, page);
+	vy_page_cache_put(&env->page_cache, page);
 
 	/* Update read statistics. */
 	itr->stat->read.rows += page_info->row_count;
@@ -40,6 +40,7 @@
 #include "vy_stmt_stream.h"
 #include "vy_read_view.h"
 #include "vy_stat.h"
+#include "vy_page_cache.h"
 #include "index_def.h"
 #include "xlog.h"
 
@@ -74,6 +75,8 @@ struct vy_run_env {
 	 * unconditionally remove unused runs' files in-place.
 	 */
 	bool initial_join;
+	/** Cache of decompressed pages shared by all runs. */
+	struct vy_page_cache page_cache;
 };
 
 /**
@@ -214,7 +217,10 @@ struct vy_slice {
 		/** Link in vy_join_ctx->slices list. */
 		struct rlist in_join;
 	};
-	/** Link in vy_task::compacted_slices. */
+	/**
+	 * Link in vy_task::compacted_slices or
+	 * vy_compaction_part::slices.
+	 */
 	struct rlist in_compaction;
 	/**
 	 * Indexes of the first and the last page in the run
@@ -295,8 +301,14 @@ struct vy_run_iterator {
  * Vinyl page stored in memory.
  */
 struct vy_page {
+	/** Id of the run the page belongs to. */
+	int64_t run_id;
 	/** Page position in the run file. */
 	uint32_t page_no;
+	/** Number of references to the page. */
+	int refs;
+	/** Link in the page cache LRU list, see vy_page_cache. */
+	struct rlist in_lru;
 	/** Size of page data in memory, i.e. unpacked. */
 	uint32_t unpacked_size;
 	/** Number of statements in the page. */
@@ -307,6 +319,18 @@ struct vy_page {
 	char *data;
 };
 
+/** Take a reference to a page. */
+static inline void
+vy_page_ref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	page->refs++;
+}
+
+/** Drop a reference to a page. Deletes the page if it was the last one. */
+void
+vy_page_unref(struct vy_page *page);
+
 /**
  * Initialize vinyl run environment
  *
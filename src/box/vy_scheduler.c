@@ -60,11 +60,19 @@
 #include "vy_run.h"
 #include "vy_write_iterator.h"
 #include "trivia/util.h"
+#include "tweaks.h"
 
 /* Min and max values for vy_scheduler::timeout. */
 #define VY_SCHEDULER_TIMEOUT_MIN	1
 #define VY_SCHEDULER_TIMEOUT_MAX	60
 
+/**
+ * Max number of parts compaction of a range can be split into, see
+ * vy_task_compaction_prepare_parts(). Set to 1 to disable splitting.
+ */
+static int vinyl_compaction_parts_max = 8;
+TWEAK_INT(vinyl_compaction_parts_max);
+
 static int vy_worker_f(va_list);
 static int vy_scheduler_f(va_list);
 static void vy_task_execute_f(struct cmsg *);
@@ -132,6 +140,30 @@ struct vy_deferred_delete_batch {
 	struct vy_deferred_delete_stmt stmt[VY_DEFERRED_DELETE_BATCH_MAX];
 };
 
+/**
+ * Part of a compaction task. Compaction of a big range is split into
+ * several parts with disjoint key ranges, which are executed in parallel
+ * in helper threads. On completion, every part becomes a separate range.
+ */
+struct vy_compaction_part {
+	/** Helper thread executing this part. */
+	struct cord cord;
+	/** Task this part belongs to. */
+	struct vy_task *task;
+	/**
+	 * Range that replaces the compacted range on task completion
+	 * in the key interval of this part.
+	 */
+	struct vy_range *range;
+	/**
+	 * Slices of the compacted runs cut to the range boundaries,
+	 * linked by vy_slice::in_compaction. Used only for reading.
+	 */
+	struct rlist slices;
+	/** Run written by this part. */
+	struct vy_run *new_run;
+};
+
 struct vy_task_ops {
 	/**
 	 * This function is called from a worker. It is supposed to do work
@@ -212,6 +244,13 @@ struct vy_task {
 	 * linked by vy_slice::in_compaction.
 	 */
 	struct rlist compacted_slices;
+	/**
+	 * Parts compaction is split into or NULL if the range is
+	 * compacted as a whole. If set, new_run is NULL.
+	 */
+	struct vy_compaction_part *parts;
+	/** Number of entries in the parts array. */
+	int part_count;
 	/** Set if there is no older level than the one we're writing to. */
 	bool is_last_level;
 	/** Array of read view LSNs sorted in the ascending order. */
@@ -1127,7 +1166,7 @@ vy_task_deferred_delete_iface = {
  */
 static int
 vy_task_write_run(struct vy_task *task, struct vy_stmt_stream *wi,
-		  bool no_compression)
+		  struct vy_run *run, bool no_compression)
 {
 	enum { YIELD_LOOPS = 32 };
 
@@ -1142,7 +1181,7 @@ vy_task_write_run(struct vy_task *task, struct vy_stmt_stream *wi,
 	ERROR_INJECT_SLEEP(ERRINJ_VY_RUN_WRITE_DELAY);
 
 	struct vy_run_writer writer;
-	if (vy_run_writer_create(&writer, task->new_run, lsm->env->path,
+	if (vy_run_writer_create(&writer, run, lsm->env->path,
 				 lsm->space_id, lsm->index_id,
 				 task->cmp_def, task->key_def,
 				 task->page_size, task->bloom_fpr,
@@ -1219,7 +1258,7 @@ vy_task_dump_execute(struct vy_task *task)
 	 * and smallest runs at the same time and so we would gain
 	 * nothing by compressing them.
 	 */
-	rc = vy_task_write_run(task, wi, true);
+	rc = vy_task_write_run(task, wi, task->new_run, true);
 out_close_wi:
 	wi->iface->close(wi);
 out_delete_format:
@@ -1521,10 +1560,15 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	return -1;
 }
 
+/**
+ * Merge the given list of slices, linked by vy_slice::in_compaction,
+ * and write the result to a new run.
+ */
 static int
-vy_task_compaction_execute(struct vy_task *task)
+vy_task_compaction_write(struct vy_task *task, struct rlist *slices,
+			 struct vy_run *run,
+			 struct vy_deferred_delete_handler *handler)
 {
-	ERROR_INJECT_SLEEP(ERRINJ_VY_COMPACTION_DELAY);
 	int rc = -1;
 	bool is_primary = (task->lsm->index_id == 0);
 	struct tuple_format *format = vy_space_stmt_format_new(
@@ -1539,17 +1583,16 @@ vy_task_compaction_execute(struct vy_task *task)
 	tuple_format_ref(key_format);
 	struct vy_stmt_stream *wi = vy_write_iterator_new(
 			task->cmp_def, is_primary, task->is_last_level,
-			task->vlsns, task->vlsn_count,
-			is_primary ? &task->deferred_delete_handler : NULL);
+			task->vlsns, task->vlsn_count, handler);
 	if (wi == NULL)
 		goto out_delete_key_format;
 	struct vy_slice *slice;
-	rlist_foreach_entry(slice, &task->compacted_slices, in_compaction) {
+	rlist_foreach_entry(slice, slices, in_compaction) {
 		if (vy_write_iterator_new_slice(wi, slice, format,
 						key_format) != 0)
 			goto out_close_wi;
 	}
-	rc = vy_task_write_run(task, wi, false);
+	rc = vy_task_write_run(task, wi, run, false);
 out_close_wi:
 	wi->iface->close(wi);
 out_delete_key_format:
@@ -1560,9 +1603,293 @@ vy_task_compaction_execute(struct vy_task *task)
 	return rc;
 }
 
+/** Helper thread function that executes a compaction part. */
+static int
+vy_task_compaction_part_f(va_list ap)
+{
+	struct vy_compaction_part *part = va_arg(ap, typeof(part));
+	tuple_format_init();
+	int rc = vy_task_compaction_write(part->task, &part->slices,
+					  part->new_run, NULL);
+	tuple_format_free();
+	return rc;
+}
+
+/**
+ * Execute compaction parts in parallel, each in its own helper thread.
+ * Cancellation of the calling fiber is forwarded to the helper threads
+ * by cord_cojoin().
+ */
+static int
+vy_task_compaction_execute_parts(struct vy_task *task)
+{
+	int rc = 0;
+	int started = 0;
+	for (int i = 0; i < task->part_count; i++) {
+		struct vy_compaction_part *part = &task->parts[i];
+		char name[FIBER_NAME_MAX];
+		snprintf(name, sizeof(name), "%s.%d", cord_name(cord()), i);
+		if (cord_costart(&part->cord, name,
+				 vy_task_compaction_part_f, part) != 0) {
+			rc = -1;
+			break;
+		}
+		started++;
+	}
+	for (int i = 0; i < started; i++) {
+		if (cord_cojoin(&task->parts[i].cord) != 0)
+			rc = -1;
+	}
+	return rc;
+}
+
+static int
+vy_task_compaction_execute(struct vy_task *task)
+{
+	ERROR_INJECT_SLEEP(ERRINJ_VY_COMPACTION_DELAY);
+	if (task->parts != NULL)
+		return vy_task_compaction_execute_parts(task);
+	bool is_primary = (task->lsm->index_id == 0);
+	return vy_task_compaction_write(
+			task, &task->compacted_slices, task->new_run,
+			is_primary ? &task->deferred_delete_handler : NULL);
+}
+
+/**
+ * Free compaction parts of a task. Runs that weren't committed
+ * are discarded.
+ */
+static void
+vy_task_compaction_delete_parts(struct vy_task *task)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	assert(scheduler->compaction_part_count >= task->part_count);
+	scheduler->compaction_part_count -= task->part_count;
+	for (int i = 0; i < task->part_count; i++) {
+		struct vy_compaction_part *part = &task->parts[i];
+		struct vy_slice *slice, *next_slice;
+		rlist_foreach_entry_safe(slice, &part->slices, in_compaction,
+					 next_slice)
+			vy_slice_delete(slice);
+		if (part->range != NULL)
+			vy_range_delete(part->range);
+		if (part->new_run != NULL)
+			vy_run_discard(part->new_run);
+	}
+	free(task->parts);
+	task->parts = NULL;
+	task->part_count = 0;
+}
+
+/**
+ * Complete compaction split into parts: replace the compacted range
+ * with the ranges of the parts, each of which stores the run written
+ * by the part and slices of the runs that weren't compacted, cut to
+ * the part boundaries.
+ */
+static int
+vy_task_compaction_complete_parts(struct vy_task *task)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_range *range = task->range;
+	double compaction_time = ev_monotonic_now(loop()) - task->start_time;
+	struct vy_disk_stmt_counter compaction_input;
+	struct vy_disk_stmt_counter compaction_output;
+	struct vy_slice *slice, *new_slice;
+	struct vy_run *run;
+	int i;
+
+	/* Slices used for reading aren't needed anymore. */
+	for (i = 0; i < task->part_count; i++) {
+		struct vy_slice *next_slice;
+		rlist_foreach_entry_safe(slice, &task->parts[i].slices,
+					 in_compaction, next_slice)
+			vy_slice_delete(slice);
+		rlist_create(&task->parts[i].slices);
+	}
+
+	/*
+	 * The LSM tree could have been dropped while we were writing
+	 * the new runs, see vy_task_compaction_complete().
+	 */
+	if (lsm->is_dropped) {
+		vy_task_compaction_delete_parts(task);
+		assert(heap_node_is_stray(&range->heap_node));
+		vy_range_heap_insert(&lsm->range_heap, range);
+		vy_scheduler_update_lsm(scheduler, lsm);
+		return 0;
+	}
+
+	/*
+	 * Fill the new ranges. The slice of a new run is inserted
+	 * at the same position where the compacted slices were,
+	 * because a slice might have been added to the range by
+	 * a concurrent dump while compaction was in progress.
+	 */
+	struct vy_slice *first_slice = rlist_first_entry(
+		&task->compacted_slices, struct vy_slice, in_compaction);
+	struct vy_slice *last_slice = rlist_last_entry(
+		&task->compacted_slices, struct vy_slice, in_compaction);
+	for (i = 0; i < task->part_count; i++) {
+		struct vy_compaction_part *part = &task->parts[i];
+		struct vy_range *new_range = part->range;
+		bool is_compacted = false;
+		/*
+		 * vy_range_add_slice() adds a slice to the list head,
+		 * so to preserve the order of the slices list, we have
+		 * to iterate backward.
+		 */
+		rlist_foreach_entry_reverse(slice, &range->slices, in_range) {
+			if (slice == last_slice) {
+				is_compacted = true;
+				if (!vy_run_is_empty(part->new_run)) {
+					new_slice = vy_slice_new(
+						vy_log_next_id(), part->new_run,
+						vy_entry_none(), vy_entry_none(),
+						lsm->cmp_def);
+					if (new_slice == NULL)
+						return -1;
+					vy_range_add_slice(new_range, new_slice);
+				}
+			}
+			if (!is_compacted) {
+				if (vy_slice_cut(slice, vy_log_next_id(),
+						 new_range->begin,
+						 new_range->end, lsm->cmp_def,
+						 &new_slice) != 0)
+					return -1;
+				if (new_slice != NULL)
+					vy_range_add_slice(new_range,
+							   new_slice);
+			}
+			if (slice == first_slice)
+				is_compacted = false;
+		}
+	}
+
+	/*
+	 * Build the list of runs that became unused
+	 * as a result of compaction.
+	 */
+	RLIST_HEAD(unused_runs);
+	rlist_foreach_entry(slice, &task->compacted_slices, in_compaction)
+		slice->run->compacted_slice_count++;
+	rlist_foreach_entry(slice, &task->compacted_slices, in_compaction) {
+		run = slice->run;
+		if (run->compacted_slice_count == run->slice_count)
+			rlist_add_entry(&unused_runs, run, in_unused);
+		slice->run->compacted_slice_count = 0;
+	}
+
+	/*
+	 * Log change in metadata.
+	 */
+	vy_log_tx_begin();
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_log_delete_slice(slice->id);
+	vy_log_delete_range(range->id);
+	rlist_foreach_entry(run, &unused_runs, in_unused)
+		vy_log_drop_run(run->id, VY_LOG_GC_LSN_CURRENT);
+	for (i = 0; i < task->part_count; i++) {
+		struct vy_compaction_part *part = &task->parts[i];
+		struct vy_range *new_range = part->range;
+		run = part->new_run;
+		if (!vy_run_is_empty(run))
+			vy_log_create_run(lsm->id, run->id, run->dump_lsn,
+					  run->dump_count);
+		vy_log_insert_range(lsm->id, new_range->id,
+				    tuple_data_or_null(new_range->begin.stmt),
+				    tuple_data_or_null(new_range->end.stmt));
+		rlist_foreach_entry(slice, &new_range->slices, in_range)
+			vy_log_insert_slice(new_range->id, slice->run->id,
+					    slice->id,
+					    tuple_data_or_null(slice->begin.stmt),
+					    tuple_data_or_null(slice->end.stmt));
+	}
+	if (vy_log_tx_commit() < 0)
+		return -1;
+
+	/*
+	 * Remove compacted run files that were created after
+	 * the last checkpoint, see vy_task_compaction_complete().
+	 */
+	rlist_foreach_entry(run, &unused_runs, in_unused) {
+		if (run->dump_lsn > vy_log_signature() ||
+		    scheduler->run_env->initial_join)
+			vy_run_remove_files(lsm->env->path, lsm->space_id,
+					    lsm->index_id, run->id);
+	}
+
+	/*
+	 * Account the new runs if they are not empty,
+	 * otherwise discard them.
+	 */
+	vy_disk_stmt_counter_reset(&compaction_output);
+	for (i = 0; i < task->part_count; i++) {
+		struct vy_compaction_part *part = &task->parts[i];
+		run = part->new_run;
+		part->new_run = NULL;
+		vy_disk_stmt_counter_add(&compaction_output, &run->count);
+		if (!vy_run_is_empty(run)) {
+			vy_lsm_add_run(lsm, run);
+			/* Drop the reference held by the task. */
+			vy_run_unref(run);
+		} else
+			vy_run_discard(run);
+	}
+
+	/*
+	 * Replace the compacted range with the new ranges and
+	 * account compaction in LSM tree statistics.
+	 */
+	vy_lsm_unacct_range(lsm, range);
+	vy_lsm_remove_range(lsm, range);
+	for (i = 0; i < task->part_count; i++) {
+		struct vy_range *new_range = task->parts[i].range;
+		task->parts[i].range = NULL;
+		new_range->n_compactions = range->n_compactions + 1;
+		new_range->needs_compaction = range->needs_compaction;
+		vy_range_update_compaction_priority(new_range, &lsm->opts);
+		vy_range_update_dumps_per_compaction(new_range);
+		vy_lsm_add_range(lsm, new_range);
+		vy_lsm_acct_range(lsm, new_range);
+	}
+	lsm->range_tree_version++;
+	vy_disk_stmt_counter_reset(&compaction_input);
+	rlist_foreach_entry(slice, &task->compacted_slices, in_compaction)
+		vy_disk_stmt_counter_add(&compaction_input, &slice->count);
+	vy_lsm_acct_compaction(lsm, compaction_time,
+			       &compaction_input, &compaction_output);
+	scheduler->stat.compaction_input += compaction_input.bytes;
+	scheduler->stat.compaction_output += compaction_output.bytes;
+	scheduler->stat.compaction_time += compaction_time;
+
+	/*
+	 * Unaccount unused runs and delete the compacted range
+	 * along with its slices.
+	 */
+	rlist_foreach_entry(run, &unused_runs, in_unused)
+		vy_lsm_remove_run(lsm, run);
+	vy_scheduler_update_lsm(scheduler, lsm);
+
+	say_verbose("%s: completed compacting range %s in %d parts",
+		    vy_lsm_name(lsm), vy_range_str(range), task->part_count);
+
+	vy_task_compaction_delete_parts(task);
+	rlist_create(&task->compacted_slices);
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_slice_wait_pinned(slice);
+	vy_range_delete(range);
+	return 0;
+}
+
 static int
 vy_task_compaction_complete(struct vy_task *task)
 {
+	if (task->parts != NULL)
+		return vy_task_compaction_complete_parts(task);
+
 	struct vy_scheduler *scheduler = task->scheduler;
 	struct vy_lsm *lsm = task->lsm;
 	struct vy_range *range = task->range;
@@ -1724,13 +2051,138 @@ vy_task_compaction_abort(struct vy_task *task)
 	say_error("%s: failed to compact range %s",
 		  vy_lsm_name(lsm), vy_range_str(range));
 
-	vy_run_discard(task->new_run);
+	if (task->parts != NULL)
+		vy_task_compaction_delete_parts(task);
+	else
+		vy_run_discard(task->new_run);
 
 	assert(heap_node_is_stray(&range->heap_node));
 	vy_range_heap_insert(&lsm->range_heap, range);
 	vy_scheduler_update_lsm(scheduler, lsm);
 }
 
+/**
+ * Split compaction of a big range into parts with disjoint key ranges,
+ * which are executed in parallel. The split keys are taken from the page
+ * index of the biggest compacted run. The number of parts is limited by
+ * the compaction thread pool size, which bounds the total number of parts
+ * of all tasks in progress, and by the size of the compacted data:
+ * every part becomes a separate range on completion so it must be at
+ * least half the target range size, otherwise the new ranges would be
+ * coalesced back, see vy_range_needs_coalesce().
+ *
+ * Returns 0 on success (including the case when the range is compacted
+ * as a whole), -1 on failure.
+ */
+static int
+vy_task_compaction_prepare_parts(struct vy_task *task)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_range *range = task->range;
+	struct key_def *cmp_def = lsm->cmp_def;
+	/*
+	 * Deferred DELETE statements generated by primary index
+	 * compaction are sent to tx by the worker thread so they
+	 * can't be generated in a helper thread.
+	 */
+	if (lsm->index_id == 0 && lsm->space_def->opts.defer_deletes)
+		return 0;
+
+	int64_t input_size = 0;
+	struct vy_slice *slice, *biggest_slice = NULL;
+	rlist_foreach_entry(slice, &task->compacted_slices, in_compaction) {
+		input_size += slice->count.bytes;
+		if (biggest_slice == NULL ||
+		    slice->count.bytes > biggest_slice->count.bytes)
+			biggest_slice = slice;
+	}
+	int page_count = biggest_slice->last_page_no -
+			 biggest_slice->first_page_no + 1;
+	int64_t part_count = vy_lsm_range_size(lsm) / 2;
+	part_count = input_size / MAX(part_count, 1);
+	part_count = MIN(part_count, vinyl_compaction_parts_max);
+	part_count = MIN(part_count, scheduler->compaction_pool.size -
+				     scheduler->compaction_part_count);
+	part_count = MIN(part_count, page_count);
+	if (part_count < 2)
+		return 0;
+
+	/*
+	 * Determine the boundaries of the parts. The min key of a page
+	 * may be less than the beginning of the slice, see
+	 * vy_range_needs_split(), so we skip such keys.
+	 */
+	struct vy_entry *keys = xcalloc(part_count + 1, sizeof(*keys));
+	int key_count = 1;
+	keys[0] = range->begin;
+	for (int i = 1; i < part_count; i++) {
+		struct vy_page_info *page = vy_run_page_info(
+			biggest_slice->run, biggest_slice->first_page_no +
+			page_count * i / part_count);
+		struct vy_entry prev = keys[key_count - 1];
+		if (prev.stmt != NULL &&
+		    vy_entry_compare_with_raw_key(prev, page->min_key,
+						  page->min_key_hint,
+						  cmp_def) >= 0)
+			continue;
+		struct vy_entry key = vy_entry_key_from_msgpack(
+			lsm->env->key_format, cmp_def, page->min_key);
+		if (key.stmt == NULL)
+			goto fail;
+		keys[key_count++] = key;
+	}
+	keys[key_count] = range->end;
+	if (key_count < 2)
+		goto out;
+
+	task->part_count = key_count;
+	task->parts = xcalloc(task->part_count, sizeof(*task->parts));
+	scheduler->compaction_part_count += task->part_count;
+	for (int i = 0; i < task->part_count; i++)
+		rlist_create(&task->parts[i].slices);
+	for (int i = 0; i < task->part_count; i++) {
+		struct vy_compaction_part *part = &task->parts[i];
+		part->task = task;
+		part->range = vy_range_new(vy_log_next_id(), keys[i],
+					   keys[i + 1], cmp_def);
+		if (part->range == NULL)
+			goto fail;
+		rlist_foreach_entry(slice, &task->compacted_slices,
+				    in_compaction) {
+			struct vy_slice *new_slice;
+			if (vy_slice_cut(slice, vy_log_next_id(),
+					 part->range->begin, part->range->end,
+					 cmp_def, &new_slice) != 0)
+				goto fail;
+			if (new_slice != NULL)
+				rlist_add_tail_entry(&part->slices, new_slice,
+						     in_compaction);
+		}
+		/* The first part writes the run prepared for the task. */
+		if (i == 0)
+			continue;
+		part->new_run = vy_run_prepare(scheduler->run_env, lsm);
+		if (part->new_run == NULL)
+			goto fail;
+		part->new_run->dump_lsn = task->new_run->dump_lsn;
+		part->new_run->dump_count = task->new_run->dump_count;
+	}
+	task->parts[0].new_run = task->new_run;
+	task->new_run = NULL;
+out:
+	for (int i = 1; i < key_count; i++)
+		tuple_unref(keys[i].stmt);
+	free(keys);
+	return 0;
+fail:
+	vy_task_compaction_delete_parts(task);
+	for (int i = 1; i < key_count; i++)
+		tuple_unref(keys[i].stmt);
+	free(keys);
+	return -1;
+}
+
 static int
 vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 		       struct vy_lsm *lsm, struct vy_task **p_task)
@@ -1788,14 +2240,17 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	else
 		new_run->dump_count = dump_count;
 
-	range->needs_compaction = false;
-
 	task->range = range;
 	task->new_run = new_run;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
 	task->page_size = lsm->opts.page_size;
 	vy_task_set_read_views(task, scheduler->read_views);
 
+	if (vy_task_compaction_prepare_parts(task) != 0)
+		goto err_parts;
+
+	range->needs_compaction = false;
+
 	/*
 	 * Remove the range we are going to compact from the heap
 	 * so that it doesn't get selected again.
@@ -1803,11 +2258,14 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	vy_range_heap_delete(&lsm->range_heap, range);
 	vy_scheduler_update_lsm(scheduler, lsm);
 
-	say_verbose("%s: started compacting range %s, runs %d/%d",
+	say_verbose("%s: started compacting range %s, runs %d/%d, parts %d",
 		    vy_lsm_name(lsm), vy_range_str(range),
-		    range->compaction_priority, range->slice_count);
+		    range->compaction_priority, range->slice_count,
+		    MAX(task->part_count, 1));
 	*p_task = task;
 	return 0;
+err_parts:
+	vy_run_discard(new_run);
 err_run:
 	vy_task_delete(task);
 err:
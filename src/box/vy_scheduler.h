@@ -137,6 +137,12 @@ struct vy_scheduler {
 	int64_t dump_generation;
 	/** Number of dump tasks that are currently in progress. */
 	int dump_task_count;
+	/**
+	 * Number of compaction parts of all tasks, i.e. the number of
+	 * helper threads started or to be started for them. Limited by
+	 * the compaction thread pool size.
+	 */
+	int compaction_part_count;
 	/** Time when the current dump round started. */
 	double dump_start;
 	/** Signaled on dump round completion. */
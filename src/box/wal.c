@@ -45,6 +45,8 @@
 #include "iproto_constants.h"
 #include "watcher.h"
 #include "tweaks.h"
+#include "wal_ring.h"
+#include "uring.h"
 
 enum {
 	/**
@@ -56,8 +58,21 @@ enum {
 	 * latency. 1 MB seems to be a well balanced choice.
 	 */
 	WAL_FALLOCATE_LEN = 1024 * 1024,
+	/**
+	 * Size of the io_uring submission queue used for WAL writes.
+	 * Writes are synchronous so we need just a couple of entries.
+	 */
+	WAL_URING_ENTRIES = 8,
 };
 
+/**
+ * Size of the in-memory ring of recently written rows shared by
+ * relays, see wal_ring.h. Zero disables the ring. Must be set before
+ * the WAL is initialized.
+ */
+static uint64_t wal_ring_size = 16 * 1024 * 1024;
+TWEAK_UINT(wal_ring_size);
+
 const char *wal_mode_STRS[WAL_MODE_MAX] = {
 	[WAL_NONE]	= "none",
 	[WAL_WRITE]	= "write",
@@ -199,6 +214,17 @@ struct wal_writer
 	 * Used for replication relays.
 	 */
 	struct rlist watchers;
+	/**
+	 * Ring of recently written rows read by relays instead of
+	 * the current WAL file. Filled only while there are watchers.
+	 * NULL if disabled.
+	 */
+	struct wal_ring *ring;
+	/**
+	 * Ring used for writing WAL files if io_uring is available,
+	 * otherwise NULL.
+	 */
+	struct uring *uring;
 };
 
 struct wal_msg {
@@ -239,6 +265,12 @@ wal_dir(void)
 	return wal_writer_singleton.wal_dir.dirname;
 }
 
+struct wal_ring *
+wal_get_ring(void)
+{
+	return wal_writer_singleton.ring;
+}
+
 static void
 wal_write_to_disk(struct cmsg *msg);
 
@@ -474,8 +506,19 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 			       wal_begin_checkpoint, wal_commit_checkpoint);
 	}
 
+	writer->uring = NULL;
+	if (wal_mode != WAL_NONE)
+		writer->uring = uring_new(WAL_URING_ENTRIES, 0);
+
 	struct xlog_opts opts = xlog_opts_default;
 	opts.sync_is_async = true;
+	opts.uring = writer->uring;
+	/*
+	 * With io_uring a write and the following sync are submitted
+	 * with a single system call so there's no need in O_SYNC.
+	 */
+	if (wal_mode == WAL_FSYNC && writer->uring != NULL)
+		opts.sync_on_write = true;
 	xdir_create(&writer->wal_dir, wal_dirname, "XLOG", instance_uuid,
 		    &opts);
 	writer->wal_dir.force_recovery = true;
@@ -486,7 +529,7 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	 */
 	xdir_set_retention_period(&writer->wal_dir, wal_retention_period);
 	xlog_clear(&writer->current_wal);
-	if (wal_mode == WAL_FSYNC)
+	if (wal_mode == WAL_FSYNC && !opts.sync_on_write)
 		writer->wal_dir.open_wflags |= O_SYNC;
 
 	stailq_create(&writer->rollback);
@@ -501,6 +544,9 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	if (checkpoint_vclock != NULL)
 		vclock_copy(&writer->checkpoint_vclock, checkpoint_vclock);
 	rlist_create(&writer->watchers);
+	writer->ring = NULL;
+	if (wal_mode != WAL_NONE && wal_ring_size > 0)
+		writer->ring = wal_ring_new(wal_ring_size);
 
 	writer->on_garbage_collection = on_garbage_collection;
 	writer->on_checkpoint_threshold = on_checkpoint_threshold;
@@ -514,6 +560,10 @@ static void
 wal_writer_destroy(struct wal_writer *writer)
 {
 	xdir_destroy(&writer->wal_dir);
+	if (writer->ring != NULL)
+		wal_ring_delete(writer->ring);
+	if (writer->uring != NULL)
+		uring_delete(writer->uring);
 }
 
 /** WAL writer thread routine. */
@@ -1366,6 +1416,16 @@ wal_write_to_disk(struct cmsg *msg)
 
 	struct xlog *l = &writer->current_wal;
 	ERROR_INJECT_SLEEP_FOR(ERRINJ_WAL_DELAY_DURATION);
+	/*
+	 * Filling the ring means encoding every row once again so
+	 * don't do it unless there are relays that may read it. A relay
+	 * that subscribes later will read the rows written before that
+	 * from the file.
+	 */
+	struct wal_ring *ring = rlist_empty(&writer->watchers) ?
+				NULL : writer->ring;
+	if (ring != NULL)
+		wal_ring_begin(ring, vclock_sum(&l->meta.vclock), l->offset);
 	/*
 	 * Iterate over requests (transactions)
 	 */
@@ -1379,6 +1439,10 @@ wal_write_to_disk(struct cmsg *msg)
 			err_code = JOURNAL_ENTRY_ERR_IO;
 			goto done;
 		}
+		if (ring != NULL) {
+			for (int i = 0; i < entry->n_rows; i++)
+				wal_ring_add_row(ring, entry->rows[i]);
+		}
 		if (rc > 0) {
 			writer->checkpoint_wal_size += rc;
 			last_committed = &entry->fifo;
@@ -1394,6 +1458,13 @@ wal_write_to_disk(struct cmsg *msg)
 	writer->checkpoint_wal_size += rc;
 	last_committed = stailq_last(&wal_msg->commit);
 	vclock_merge(&writer->vclock, &vclock_diff);
+	/*
+	 * Publish the batch for relays only if it has been written
+	 * in full. Otherwise they will read the committed part from
+	 * the file.
+	 */
+	if (ring != NULL)
+		wal_ring_commit(ring, l->offset);
 
 	/*
 	 * Notify TX if the checkpoint threshold has been exceeded.
@@ -1718,7 +1789,6 @@ wal_watcher_attach(void *arg)
 
 	assert(rlist_empty(&watcher->next));
 	rlist_add_tail_entry(&writer->watchers, watcher, next);
-
 	/*
 	 * Notify the watcher right after registering it
 	 * so that it can process existing WALs.
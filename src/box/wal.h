@@ -39,6 +39,7 @@
 
 struct fiber;
 struct wal_writer;
+struct wal_ring;
 struct tt_uuid;
 
 /**
@@ -130,6 +131,13 @@ wal_free(void);
 const char *
 wal_dir(void);
 
+/**
+ * Get the ring of recently written WAL rows or NULL if it's disabled.
+ * Relays may read from it in their own threads, see wal_ring.h.
+ */
+struct wal_ring *
+wal_get_ring(void);
+
 struct wal_watcher_msg {
 	struct cmsg cmsg;
 	struct wal_watcher *watcher;
@@ -0,0 +1,240 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "wal_ring.h"
+
+#include <assert.h>
+#include <pmatomic.h>
+#include <small/region.h>
+#include <string.h>
+
+#include "fiber.h"
+#include "trivia/util.h"
+#include "xrow.h"
+
+/** Header of a batch stored in a WAL ring. */
+struct wal_ring_header {
+	/** Size of the encoded rows following the header. */
+	uint32_t size;
+	/** Number of rows in the batch. */
+	uint32_t row_count;
+	/** See wal_ring_batch::file_signature. */
+	int64_t file_signature;
+	/** See wal_ring_batch::file_start. */
+	int64_t file_start;
+	/** See wal_ring_batch::file_end. */
+	int64_t file_end;
+};
+
+struct wal_ring {
+	/** Ring buffer. */
+	char *data;
+	/** Size of the ring buffer. Always a power of two. */
+	uint64_t size;
+	/**
+	 * Position following the last committed batch. Positions grow
+	 * monotonically and are mapped to the ring buffer modulo size.
+	 * Updated only by the writer.
+	 */
+	uint64_t head;
+	/**
+	 * Position of the oldest batch that hasn't been overwritten.
+	 * Updated only by the writer, always before reusing the memory.
+	 */
+	uint64_t tail;
+	/** Header of the batch being written. Used only by the writer. */
+	struct wal_ring_header batch;
+	/** Write position of the current batch. Used only by the writer. */
+	uint64_t wpos;
+	/** Set if the current batch doesn't fit in the ring. */
+	bool is_overflow;
+};
+
+/** Size of a batch stored in the ring, including the header. */
+static inline uint64_t
+wal_ring_batch_size(const struct wal_ring_header *hdr)
+{
+	return sizeof(*hdr) + small_align(hdr->size, sizeof(uint64_t));
+}
+
+/** Copy data to the ring, wrapping around the ring end if needed. */
+static void
+wal_ring_copy_in(struct wal_ring *ring, uint64_t pos, const void *src,
+		 size_t len)
+{
+	uint64_t offset = pos & (ring->size - 1);
+	size_t chunk = MIN(len, ring->size - offset);
+	memcpy(ring->data + offset, src, chunk);
+	memcpy(ring->data, (const char *)src + chunk, len - chunk);
+}
+
+/** Copy data from the ring, wrapping around the ring end if needed. */
+static void
+wal_ring_copy_out(const struct wal_ring *ring, uint64_t pos, void *dst,
+		  size_t len)
+{
+	uint64_t offset = pos & (ring->size - 1);
+	size_t chunk = MIN(len, ring->size - offset);
+	memcpy(dst, ring->data + offset, chunk);
+	memcpy((char *)dst + chunk, ring->data, len - chunk);
+}
+
+/**
+ * Evict the oldest batches so that the ring can store data up to the
+ * given position.
+ */
+static void
+wal_ring_reserve(struct wal_ring *ring, uint64_t end)
+{
+	uint64_t tail = ring->tail;
+	if (end - tail <= ring->size)
+		return;
+	do {
+		/* The current batch is never bigger than half of the ring. */
+		assert(tail < ring->head);
+		struct wal_ring_header hdr;
+		wal_ring_copy_out(ring, tail, &hdr, sizeof(hdr));
+		tail += wal_ring_batch_size(&hdr);
+	} while (end - tail > ring->size);
+	pm_atomic_store_explicit(&ring->tail, tail, pm_memory_order_relaxed);
+	/*
+	 * Readers must see the new tail before they can see any data
+	 * written over the evicted batches, see wal_ring_read().
+	 */
+	pm_atomic_thread_fence(pm_memory_order_release);
+}
+
+struct wal_ring *
+wal_ring_new(size_t size)
+{
+	uint64_t ring_size = 4096;
+	while (ring_size < size)
+		ring_size *= 2;
+	struct wal_ring *ring = xcalloc(1, sizeof(*ring));
+	ring->data = xmalloc(ring_size);
+	ring->size = ring_size;
+	return ring;
+}
+
+void
+wal_ring_delete(struct wal_ring *ring)
+{
+	free(ring->data);
+	free(ring);
+}
+
+void
+wal_ring_begin(struct wal_ring *ring, int64_t file_signature,
+	       int64_t file_start)
+{
+	ring->batch.size = 0;
+	ring->batch.row_count = 0;
+	ring->batch.file_signature = file_signature;
+	ring->batch.file_start = file_start;
+	ring->batch.file_end = file_start;
+	ring->wpos = ring->head + sizeof(struct wal_ring_header);
+	ring->is_overflow = false;
+}
+
+void
+wal_ring_add_row(struct wal_ring *ring, const struct xrow_header *row)
+{
+	if (ring->is_overflow)
+		return;
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt;
+	size_t region_svp = region_used(&fiber()->gc);
+	xrow_encode(row, /*sync=*/0, /*fixheader_len=*/0, iov, &iovcnt);
+	size_t len = 0;
+	for (int i = 0; i < iovcnt; i++)
+		len += iov[i].iov_len;
+	uint64_t batch_size = sizeof(struct wal_ring_header) +
+			      small_align(ring->batch.size + len,
+					  sizeof(uint64_t));
+	if (batch_size > ring->size / 2) {
+		ring->is_overflow = true;
+		goto out;
+	}
+	wal_ring_reserve(ring, ring->wpos + len);
+	for (int i = 0; i < iovcnt; i++) {
+		wal_ring_copy_in(ring, ring->wpos, iov[i].iov_base,
+				 iov[i].iov_len);
+		ring->wpos += iov[i].iov_len;
+	}
+	ring->batch.size += len;
+	ring->batch.row_count++;
+out:
+	region_truncate(&fiber()->gc, region_svp);
+}
+
+void
+wal_ring_commit(struct wal_ring *ring, int64_t file_end)
+{
+	if (ring->is_overflow || ring->batch.row_count == 0)
+		return;
+	ring->batch.file_end = file_end;
+	uint64_t end = ring->head + wal_ring_batch_size(&ring->batch);
+	wal_ring_reserve(ring, end);
+	wal_ring_copy_in(ring, ring->head, &ring->batch, sizeof(ring->batch));
+	/* Publish the batch only after it's fully written. */
+	pm_atomic_store_explicit(&ring->head, end, pm_memory_order_release);
+}
+
+int
+wal_ring_read(struct wal_ring *ring, int64_t file_signature,
+	      int64_t file_start, uint64_t *pos, struct region *region,
+	      struct wal_ring_batch *batch)
+{
+	uint64_t head = pm_atomic_load_explicit(&ring->head,
+						pm_memory_order_acquire);
+	uint64_t tail = pm_atomic_load_explicit(&ring->tail,
+						pm_memory_order_relaxed);
+	uint64_t p = *pos;
+	if (p < tail || p > head)
+		p = tail;
+	while (p < head) {
+		struct wal_ring_header hdr;
+		wal_ring_copy_out(ring, p, &hdr, sizeof(hdr));
+		pm_atomic_thread_fence(pm_memory_order_acquire);
+		tail = pm_atomic_load_explicit(&ring->tail,
+					       pm_memory_order_relaxed);
+		if (p < tail) {
+			/* Overwritten while we were reading it. */
+			p = tail;
+			continue;
+		}
+		/*
+		 * Batches are stored in the order they were written so
+		 * if we see a batch following the one we are looking
+		 * for, the latter must have been evicted or dropped.
+		 */
+		if (hdr.file_signature > file_signature ||
+		    (hdr.file_signature == file_signature &&
+		     hdr.file_start > file_start))
+			break;
+		if (hdr.file_signature == file_signature &&
+		    hdr.file_start == file_start) {
+			char *data = xregion_alloc(region, hdr.size);
+			wal_ring_copy_out(ring, p + sizeof(hdr), data,
+					  hdr.size);
+			pm_atomic_thread_fence(pm_memory_order_acquire);
+			tail = pm_atomic_load_explicit(
+				&ring->tail, pm_memory_order_relaxed);
+			if (p < tail)
+				break;
+			batch->file_signature = hdr.file_signature;
+			batch->file_start = hdr.file_start;
+			batch->file_end = hdr.file_end;
+			batch->row_count = hdr.row_count;
+			batch->size = hdr.size;
+			batch->data = data;
+			*pos = p + wal_ring_batch_size(&hdr);
+			return 0;
+		}
+		p += wal_ring_batch_size(&hdr);
+	}
+	*pos = p;
+	return 1;
+}
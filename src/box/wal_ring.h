@@ -0,0 +1,124 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct region;
+struct xrow_header;
+
+/**
+ * WAL ring is a bounded in-memory buffer of the rows recently written
+ * to the WAL. It is filled by the WAL thread on each batch write while
+ * there are relays subscribed to the WAL and is read by relay threads
+ * so that a relay following the current WAL doesn't have to re-read and
+ * decompress the freshly written xlog data.
+ *
+ * The ring stores a sequence of batches. Each batch is a set of rows
+ * written to the same xlog file by a single WAL write, identified by
+ * the signature of the xlog file and the file offsets the rows occupy.
+ * The offsets let a reader match a batch against its xlog cursor: if
+ * the cursor stopped right where a batch starts, the reader may take
+ * the batch rows from the ring and then move the cursor to the batch
+ * end.
+ *
+ * There's exactly one writer (the WAL thread) and any number of
+ * readers, all working without locks. The writer never waits for
+ * readers: it overwrites the oldest batches when it runs out of
+ * space. A reader copies a batch out of the ring and then checks that
+ * the batch hasn't been overwritten while it was copying. If it was,
+ * or if the batch the reader needs has already been evicted, the
+ * reader is supposed to fall back on reading the xlog file.
+ */
+struct wal_ring;
+
+/** Batch of rows read from a WAL ring. */
+struct wal_ring_batch {
+	/** Vclock signature of the xlog file the rows were written to. */
+	int64_t file_signature;
+	/** Offset of the first row in the xlog file. */
+	int64_t file_start;
+	/** Offset following the last row in the xlog file. */
+	int64_t file_end;
+	/** Number of rows in the batch. */
+	uint32_t row_count;
+	/** Size of the encoded rows. */
+	uint32_t size;
+	/**
+	 * Rows encoded in the xlog format (without fixheaders).
+	 * Use xrow_decode() to iterate over them.
+	 */
+	const char *data;
+};
+
+/**
+ * Allocate a WAL ring of the given size in bytes. The size is rounded
+ * up to a power of two. Never fails.
+ */
+struct wal_ring *
+wal_ring_new(size_t size);
+
+/** Free a WAL ring. Must not be called while it has readers. */
+void
+wal_ring_delete(struct wal_ring *ring);
+
+/**
+ * Start a new batch. Rows added with wal_ring_add_row() aren't visible
+ * to readers until wal_ring_commit() is called. A batch that hasn't
+ * been committed is discarded by the next call to this function.
+ *
+ * Must be called only from the writer thread.
+ */
+void
+wal_ring_begin(struct wal_ring *ring, int64_t file_signature,
+	       int64_t file_start);
+
+/**
+ * Append a row to the current batch. If the batch grows too big to be
+ * stored in the ring, it is silently dropped on commit and readers
+ * will have to read its rows from the xlog file.
+ *
+ * Must be called only from the writer thread.
+ */
+void
+wal_ring_add_row(struct wal_ring *ring, const struct xrow_header *row);
+
+/**
+ * Make the current batch visible to readers.
+ *
+ * Must be called only from the writer thread.
+ */
+void
+wal_ring_commit(struct wal_ring *ring, int64_t file_end);
+
+/**
+ * Look up a batch that starts at the given offset of the given xlog
+ * file and copy it to @a region.
+ *
+ * @a pos is a reader's position hint. It should be initialized with 0
+ * and then passed to all calls made by the same reader: if the reader
+ * consumes batches sequentially, the next batch is found in O(1).
+ *
+ * Returns 0 and fills @a batch on success. Returns 1 if there's no such
+ * batch in the ring, either because it hasn't been written yet or
+ * because it has already been evicted. Never fails otherwise.
+ *
+ * May be called from any thread.
+ */
+int
+wal_ring_read(struct wal_ring *ring, int64_t file_signature,
+	      int64_t file_start, uint64_t *pos, struct region *region,
+	      struct wal_ring_batch *batch);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -49,6 +49,7 @@
 #include "salad/grp_alloc.h"
 #include "trivia/util.h"
 #include "retention_period.h"
+#include "uring.h"
 #include "iproto_constants.h"
 
 /*
@@ -91,6 +92,12 @@ enum {
 	 * Maybe this should be a configuration option.
 	 */
 	XLOG_TX_COMPRESS_THRESHOLD = 2 * 1024,
+	/**
+	 * Number of blocks compressed by each thread at once if
+	 * xlog_opts::compress_threads > 1. Starting threads isn't
+	 * free, so each thread should get enough work.
+	 */
+	XLOG_ZBATCH_BLOCKS_PER_THREAD = 16,
 };
 
 const struct xlog_opts xlog_opts_default = {
@@ -99,6 +106,9 @@ const struct xlog_opts xlog_opts_default = {
 	.free_cache = false,
 	.sync_is_async = false,
 	.no_compression = false,
+	.sync_on_write = false,
+	.uring = NULL,
+	.compress_threads = 1,
 };
 
 /* {{{ struct xlog_meta */
@@ -784,6 +794,12 @@ xlog_materialize(struct xlog *l)
 	return 0;
 }
 
+static struct xlog_zbatch *
+xlog_zbatch_new(int thread_count);
+
+static void
+xlog_zbatch_delete(struct xlog_zbatch *batch);
+
 static int
 xlog_init(struct xlog *xlog, const struct xlog_opts *opts)
 {
@@ -800,6 +816,11 @@ xlog_init(struct xlog *xlog, const struct xlog_opts *opts)
 				 "failed to create context");
 			return -1;
 		}
+		if (opts->compress_threads > 1) {
+			xlog->zbatch = xlog_zbatch_new(opts->compress_threads);
+			if (xlog->zbatch == NULL)
+				return -1;
+		}
 	}
 	return 0;
 }
@@ -825,6 +846,10 @@ xlog_free(struct xlog *xlog)
 	obuf_destroy(&xlog->zbuf);
 	ZSTD_freeCCtx(xlog->zctx);
 	xlog->zctx = NULL;
+	if (xlog->zbatch != NULL) {
+		xlog_zbatch_delete(xlog->zbatch);
+		xlog->zbatch = NULL;
+	}
 }
 
 int
@@ -1061,6 +1086,24 @@ xlog_fallocate(struct xlog *log, size_t len)
 #endif /* HAVE_FALLOCATE */
 }
 
+/**
+ * Write a batch of data at the current end of the xlog and, if
+ * requested by the xlog options, sync it to disk.
+ */
+static ssize_t
+xlog_writev(struct xlog *log, struct iovec *iov, int iovcnt)
+{
+	if (log->opts.uring != NULL) {
+		int flags = log->opts.sync_on_write ? URING_DATASYNC : 0;
+		return uring_pwritev(log->opts.uring, log->fd, iov, iovcnt,
+				     log->offset, flags);
+	}
+	ssize_t written = fio_writevn(log->fd, iov, iovcnt);
+	if (written >= 0 && log->opts.sync_on_write && fdatasync(log->fd) < 0)
+		return -1;
+	return written;
+}
+
 /**
  * Write a sequence of uncompressed xrow objects.
  *
@@ -1111,7 +1154,7 @@ xlog_tx_write_plain(struct xlog *log)
 		return -1;
 	});
 
-	ssize_t written = fio_writevn(log->fd, log->obuf.iov, log->obuf.pos + 1);
+	ssize_t written = xlog_writev(log, log->obuf.iov, log->obuf.pos + 1);
 	if (written < 0) {
 		diag_set(SystemError, "failed to write to '%s' file",
 			 log->filename);
@@ -1120,6 +1163,33 @@ xlog_tx_write_plain(struct xlog *log)
 	return obuf_size(&log->obuf);
 }
 
+/**
+ * Encode the fixheader of a compressed block of the given size
+ * with the given checksum.
+ */
+static void
+xlog_encode_zfixheader(char *fixheader, size_t size, uint32_t crc32c)
+{
+	memcpy(fixheader, &zrow_marker, sizeof(log_magic_t));
+	char *data;
+	data = fixheader + sizeof(log_magic_t);
+	data = mp_encode_uint(data, size);
+	/* Encode crc32 for previous row */
+	data = mp_encode_uint(data, 0);
+	/* Encode crc32 for current row */
+	data = mp_encode_uint(data, crc32c);
+	/* Encode padding */
+	ssize_t padding;
+	padding = XLOG_FIXHEADER_SIZE - (data - fixheader);
+	if (padding > 0) {
+		data = mp_encode_strl(data, padding - 1);
+		if (padding > 1) {
+			memset(data, 0, padding - 1);
+			data += padding - 1;
+		}
+	}
+}
+
 /**
  * Write a compressed block of xrow objects.
  * @retval -1  error
@@ -1167,25 +1237,9 @@ xlog_tx_write_zstd(struct xlog *log)
 		offset = 0;
 	}
 
-	memcpy(fixheader, &zrow_marker, sizeof(log_magic_t));
-	char *data;
-	data = fixheader + sizeof(log_magic_t);
-	data = mp_encode_uint(data,
-			      obuf_size(&log->zbuf) - XLOG_FIXHEADER_SIZE);
-	/* Encode crc32 for previous row */
-	data = mp_encode_uint(data, 0);
-	/* Encode crc32 for current row */
-	data = mp_encode_uint(data, crc32c);
-	/* Encode padding */
-	ssize_t padding;
-	padding = XLOG_FIXHEADER_SIZE - (data - fixheader);
-	if (padding > 0) {
-		data = mp_encode_strl(data, padding - 1);
-		if (padding > 1) {
-			memset(data, 0, padding - 1);
-			data += padding - 1;
-		}
-	}
+	xlog_encode_zfixheader(fixheader,
+			       obuf_size(&log->zbuf) - XLOG_FIXHEADER_SIZE,
+			       crc32c);
 
 	ERROR_INJECT(ERRINJ_WAL_WRITE_DISK, {
 		diag_set(ClientError, ER_INJECTION, "xlog write injection");
@@ -1194,8 +1248,7 @@ xlog_tx_write_zstd(struct xlog *log)
 	});
 
 	ssize_t written;
-	written = fio_writevn(log->fd, log->zbuf.iov,
-			      log->zbuf.pos + 1);
+	written = xlog_writev(log, log->zbuf.iov, log->zbuf.pos + 1);
 	if (written < 0) {
 		diag_set(SystemError, "failed to write to '%s' file",
 			 log->filename);
@@ -1214,27 +1267,16 @@ xlog_tx_write_zstd(struct xlog *log)
 #define SYNC_ROUND_UP(size)	(SYNC_ROUND_DOWN(size + SYNC_MASK))
 
 /**
- * Writes xlog batch to file
+ * Account a block written to the file: advance the file offset and sync
+ * the file if needed. If the write failed, truncate the file to the last
+ * successfully written block.
+ *
+ * @retval -1 error
+ * @retval >= 0 the number of bytes written
  */
 static ssize_t
-xlog_tx_write(struct xlog *log)
+xlog_tx_complete(struct xlog *log, ssize_t written)
 {
-	if (obuf_size(&log->obuf) == XLOG_FIXHEADER_SIZE)
-		return 0;
-	ssize_t written;
-
-	if (!log->opts.no_compression &&
-	    obuf_size(&log->obuf) >= XLOG_TX_COMPRESS_THRESHOLD) {
-		written = xlog_tx_write_zstd(log);
-	} else {
-		written = xlog_tx_write_plain(log);
-	}
-	ERROR_INJECT(ERRINJ_WAL_WRITE, {
-		diag_set(ClientError, ER_INJECTION, "xlog write injection");
-		written = -1;
-	});
-
-	obuf_reset(&log->obuf);
 	/*
 	 * Simplify recovery after a temporary write failure:
 	 * truncate the file to the best known good write
@@ -1252,8 +1294,6 @@ xlog_tx_write(struct xlog *log)
 	else
 		log->allocated = 0;
 	log->offset += written;
-	log->rows += log->tx_rows;
-	log->tx_rows = 0;
 	if ((log->opts.sync_interval && log->offset >=
 	    (off_t)(log->synced_size + log->opts.sync_interval)) ||
 	    (log->opts.rate_limit && log->offset >=
@@ -1295,6 +1335,305 @@ xlog_tx_write(struct xlog *log)
 	return written;
 }
 
+/* {{{ Parallel compression */
+
+/** A block of rows compressed in parallel with other blocks. */
+struct xlog_zblock {
+	/** Rows of the block, starting with a reserved fixheader. */
+	struct obuf obuf;
+	/** Compressed block, starting with a fixheader. */
+	struct obuf zbuf;
+	/** Fixheader allocated in zbuf. */
+	char *fixheader;
+	/** Memory reserved in zbuf for the compressed data. */
+	char *zdata;
+	/** Size of the memory reserved in zbuf. */
+	size_t zdata_max;
+	/** Size of the compressed data. */
+	size_t zsize;
+	/** Checksum of the compressed data. */
+	uint32_t crc32c;
+	/** Zstd error code, 0 on success. */
+	size_t zerror;
+	/** Number of rows in the block. */
+	int64_t rows;
+};
+
+/** A thread compressing a part of a batch of blocks. */
+struct xlog_zworker {
+	/** The worker cord. */
+	struct cord cord;
+	/** The context of zstd compression. */
+	ZSTD_CCtx *zctx;
+	/** Blocks compressed by this worker. */
+	struct xlog_zblock *blocks;
+	/** Number of blocks compressed by this worker. */
+	int block_count;
+};
+
+/** Blocks of an xlog compressed in parallel. */
+struct xlog_zbatch {
+	/** Number of worker threads. */
+	int thread_count;
+	/** Worker threads, thread_count elements. */
+	struct xlog_zworker *workers;
+	/** Max number of blocks in a batch. */
+	int block_max;
+	/** Number of blocks accumulated so far. */
+	int block_count;
+	/** Blocks of the batch, block_max elements. */
+	struct xlog_zblock *blocks;
+};
+
+static void
+xlog_zbatch_delete(struct xlog_zbatch *batch)
+{
+	for (int i = 0; i < batch->block_max; i++) {
+		obuf_destroy(&batch->blocks[i].obuf);
+		obuf_destroy(&batch->blocks[i].zbuf);
+	}
+	for (int i = 0; i < batch->thread_count; i++)
+		ZSTD_freeCCtx(batch->workers[i].zctx);
+	free(batch->blocks);
+	free(batch->workers);
+	free(batch);
+}
+
+static struct xlog_zbatch *
+xlog_zbatch_new(int thread_count)
+{
+	assert(thread_count > 1);
+	struct xlog_zbatch *batch = xcalloc(1, sizeof(*batch));
+	batch->thread_count = thread_count;
+	batch->workers = xcalloc(thread_count, sizeof(*batch->workers));
+	batch->block_max = thread_count * XLOG_ZBATCH_BLOCKS_PER_THREAD;
+	batch->blocks = xcalloc(batch->block_max, sizeof(*batch->blocks));
+	for (int i = 0; i < batch->block_max; i++) {
+		obuf_create(&batch->blocks[i].obuf, &cord()->slabc,
+			    XLOG_TX_AUTOCOMMIT_THRESHOLD);
+		obuf_create(&batch->blocks[i].zbuf, &cord()->slabc,
+			    XLOG_TX_AUTOCOMMIT_THRESHOLD);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		batch->workers[i].zctx = ZSTD_createCCtx();
+		if (batch->workers[i].zctx == NULL) {
+			diag_set(ClientError, ER_COMPRESSION,
+				 "failed to create context");
+			xlog_zbatch_delete(batch);
+			return NULL;
+		}
+	}
+	return batch;
+}
+
+/**
+ * Compress a block. Called from a worker thread so it mustn't allocate
+ * memory from the xlog buffers: the output memory is reserved in advance.
+ */
+static void
+xlog_zblock_compress(struct xlog_zblock *block, ZSTD_CCtx *zctx)
+{
+	block->zsize = 0;
+	block->crc32c = 0;
+	block->zerror = 0;
+	/* 3 is compression level. */
+	ZSTD_compressBegin(zctx, 3);
+	struct obuf *obuf = &block->obuf;
+	size_t offset = XLOG_FIXHEADER_SIZE;
+	for (struct iovec *iov = obuf->iov; iov->iov_len; ++iov) {
+		size_t (*fcompress)(ZSTD_CCtx *, void *, size_t,
+				    const void *, size_t);
+		if (iov == obuf->iov + obuf->pos || !(iov + 1)->iov_len)
+			fcompress = ZSTD_compressEnd;
+		else
+			fcompress = ZSTD_compressContinue;
+		char *zdst = block->zdata + block->zsize;
+		size_t zsize = fcompress(zctx, zdst,
+					 block->zdata_max - block->zsize,
+					 (char *)iov->iov_base + offset,
+					 iov->iov_len - offset);
+		if (ZSTD_isError(zsize)) {
+			block->zerror = zsize;
+			return;
+		}
+		block->crc32c = crc32_calc(block->crc32c, zdst, zsize);
+		block->zsize += zsize;
+		offset = 0;
+	}
+}
+
+static int
+xlog_zworker_f(va_list ap)
+{
+	struct xlog_zworker *worker = va_arg(ap, struct xlog_zworker *);
+	for (int i = 0; i < worker->block_count; i++)
+		xlog_zblock_compress(&worker->blocks[i], worker->zctx);
+	return 0;
+}
+
+/** Compress the accumulated blocks in worker threads. Yields. */
+static void
+xlog_zbatch_compress(struct xlog_zbatch *batch)
+{
+	/* Reserve the output memory in this thread. */
+	for (int i = 0; i < batch->block_count; i++) {
+		struct xlog_zblock *block = &batch->blocks[i];
+		block->fixheader = xobuf_alloc(&block->zbuf,
+					       XLOG_FIXHEADER_SIZE);
+		size_t zdata_max = 0;
+		size_t offset = XLOG_FIXHEADER_SIZE;
+		for (struct iovec *iov = block->obuf.iov; iov->iov_len; ++iov) {
+			zdata_max += ZSTD_compressBound(iov->iov_len - offset);
+			offset = 0;
+		}
+		block->zdata = xobuf_reserve(&block->zbuf, zdata_max);
+		block->zdata_max = zdata_max;
+	}
+	/* Split the blocks evenly between the workers. */
+	int thread_count = MIN(batch->thread_count, batch->block_count);
+	int begin = 0;
+	for (int i = 0; i < thread_count; i++) {
+		struct xlog_zworker *worker = &batch->workers[i];
+		int end = (int64_t)batch->block_count * (i + 1) / thread_count;
+		worker->blocks = batch->blocks + begin;
+		worker->block_count = end - begin;
+		begin = end;
+		char name[FIBER_NAME_MAX];
+		snprintf(name, sizeof(name), "xlog.zworker.%d", i);
+		if (cord_costart(&worker->cord, name, xlog_zworker_f,
+				 worker) != 0) {
+			diag_log();
+			panic("cord_start failed");
+		}
+	}
+	for (int i = 0; i < thread_count; i++) {
+		if (cord_cojoin(&batch->workers[i].cord) != 0) {
+			diag_log();
+			panic("cord_cojoin failed");
+		}
+	}
+}
+
+/**
+ * Compress the accumulated blocks in parallel and write them to the file
+ * in order. Yields.
+ *
+ * @retval -1 error
+ * @retval >= 0 the number of bytes written
+ */
+static ssize_t
+xlog_zbatch_write(struct xlog *log)
+{
+	struct xlog_zbatch *batch = log->zbatch;
+	if (batch->block_count == 0)
+		return 0;
+	xlog_zbatch_compress(batch);
+	ssize_t total = 0;
+	int i;
+	for (i = 0; i < batch->block_count; i++) {
+		struct xlog_zblock *block = &batch->blocks[i];
+		ssize_t written = -1;
+		if (block->zerror != 0) {
+			diag_set(ClientError, ER_COMPRESSION,
+				 ZSTD_getErrorName(block->zerror));
+		} else {
+			obuf_alloc(&block->zbuf, block->zsize);
+			xlog_encode_zfixheader(block->fixheader, block->zsize,
+					       block->crc32c);
+			written = xlog_writev(log, block->zbuf.iov,
+					      block->zbuf.pos + 1);
+			if (written < 0) {
+				diag_set(SystemError,
+					 "failed to write to '%s' file",
+					 log->filename);
+			}
+		}
+		ERROR_INJECT(ERRINJ_WAL_WRITE, {
+			diag_set(ClientError, ER_INJECTION,
+				 "xlog write injection");
+			written = -1;
+		});
+		if (xlog_tx_complete(log, written) < 0)
+			break;
+		total += written;
+	}
+	/* Forget the rows of the blocks that weren't written. */
+	for (int j = i; j < batch->block_count; j++)
+		log->rows -= batch->blocks[j].rows;
+	for (int j = 0; j < batch->block_count; j++) {
+		obuf_reset(&batch->blocks[j].obuf);
+		obuf_reset(&batch->blocks[j].zbuf);
+	}
+	batch->block_count = 0;
+	return i == batch->block_count ? total : -1;
+}
+
+/**
+ * Add the rows accumulated in the output buffer to the batch of blocks
+ * compressed in parallel. The rows are accounted as written, because the
+ * snapshot writer numbers rows by the number of rows in the xlog. Writes
+ * the batch if it's full.
+ *
+ * @retval -1 error
+ * @retval >= 0 the number of bytes written
+ */
+static ssize_t
+xlog_zbatch_add(struct xlog *log)
+{
+	struct xlog_zbatch *batch = log->zbatch;
+	assert(batch->block_count < batch->block_max);
+	struct xlog_zblock *block = &batch->blocks[batch->block_count++];
+	assert(obuf_size(&block->obuf) == 0);
+	SWAP(block->obuf, log->obuf);
+	block->rows = log->tx_rows;
+	log->rows += log->tx_rows;
+	log->tx_rows = 0;
+	if (batch->block_count < batch->block_max)
+		return 0;
+	return xlog_zbatch_write(log);
+}
+
+/* }}} */
+
+/**
+ * Writes xlog batch to file
+ */
+static ssize_t
+xlog_tx_write(struct xlog *log)
+{
+	if (obuf_size(&log->obuf) == XLOG_FIXHEADER_SIZE)
+		return 0;
+	ssize_t written;
+
+	bool compress = !log->opts.no_compression &&
+			obuf_size(&log->obuf) >= XLOG_TX_COMPRESS_THRESHOLD;
+	if (log->zbatch != NULL) {
+		if (compress)
+			return xlog_zbatch_add(log);
+		/* Preserve the order of blocks. */
+		if (xlog_zbatch_write(log) < 0) {
+			obuf_reset(&log->obuf);
+			return -1;
+		}
+	}
+	if (compress)
+		written = xlog_tx_write_zstd(log);
+	else
+		written = xlog_tx_write_plain(log);
+	ERROR_INJECT(ERRINJ_WAL_WRITE, {
+		diag_set(ClientError, ER_INJECTION, "xlog write injection");
+		written = -1;
+	});
+
+	obuf_reset(&log->obuf);
+	written = xlog_tx_complete(log, written);
+	if (written < 0)
+		return -1;
+	log->rows += log->tx_rows;
+	log->tx_rows = 0;
+	return written;
+}
+
 /*
  * Add a row to a log and possibly flush the log.
  *
@@ -1394,9 +1733,14 @@ ssize_t
 xlog_flush(struct xlog *log)
 {
 	assert(log->is_autocommit);
-	if (log->obuf.used == 0)
-		return 0;
-	return xlog_tx_write(log);
+	ssize_t written = 0;
+	if (log->obuf.used != 0)
+		written = xlog_tx_write(log);
+	if (written >= 0 && log->zbatch != NULL) {
+		ssize_t rc = xlog_zbatch_write(log);
+		written = rc < 0 ? -1 : written + rc;
+	}
+	return written;
 }
 
 static int
@@ -1460,6 +1804,15 @@ xlog_write_eof(struct xlog *l)
 		return -1;
 	}
 
+	/*
+	 * Writes done with io_uring don't advance the file position.
+	 */
+	if (l->opts.uring != NULL &&
+	    lseek(l->fd, l->offset, SEEK_SET) < 0) {
+		diag_set(SystemError, "failed to seek in file '%s'",
+			 l->filename);
+		return -1;
+	}
 	if (fio_writen(l->fd, &eof_marker, sizeof(eof_marker)) < 0) {
 		diag_set(SystemError, "failed to write to file '%s'",
 			 l->filename);
@@ -2068,6 +2421,21 @@ xlog_cursor_openmem(struct xlog_cursor *i, const char *data, size_t size,
 	return -1;
 }
 
+void
+xlog_cursor_skip_to(struct xlog_cursor *cursor, off_t offset)
+{
+	assert(xlog_cursor_is_open(cursor));
+	assert(cursor->fd >= 0);
+	assert(xlog_cursor_is_tx_done(cursor));
+	assert(offset >= xlog_cursor_pos(cursor));
+	if (cursor->state == XLOG_CURSOR_TX) {
+		cursor->state = XLOG_CURSOR_ACTIVE;
+		ibuf_destroy(&cursor->tx_cursor);
+	}
+	ibuf_reset(&cursor->rbuf);
+	cursor->read_offset = offset;
+}
+
 void
 xlog_cursor_close(struct xlog_cursor *i, bool reuse_fd)
 {
@@ -43,6 +43,9 @@
 #include "small/ibuf.h"
 #include "small/obuf.h"
 
+struct uring;
+struct xlog_zbatch;
+
 struct iovec;
 struct xrow_header;
 
@@ -83,10 +86,36 @@ struct xlog_opts {
 	 * to be read frequently, e.g. L1 run files in Vinyl.
 	 */
 	bool no_compression;
+	/**
+	 * If this flag is set, each write is followed by fdatasync().
+	 *
+	 * This option is used instead of opening the file with O_SYNC
+	 * when writes go through io_uring, because io_uring can submit
+	 * a write and a sync linked to it with a single system call.
+	 */
+	bool sync_on_write;
+	/**
+	 * If set, the xlog writer uses this ring to write data to the
+	 * file. The ring must be used only by the thread writing the
+	 * xlog.
+	 */
+	struct uring *uring;
+	/**
+	 * Number of threads used to compress the xlog. If greater
+	 * than 1, compressed blocks are accumulated and compressed
+	 * in parallel before they are written to the file in order.
+	 *
+	 * This option is useful for memtx snapshots, which are
+	 * written in big chunks and are bound on compression.
+	 */
+	int compress_threads;
 };
 
 extern const struct xlog_opts xlog_opts_default;
 
+/** Max value of xlog_opts::compress_threads. */
+enum { XLOG_COMPRESS_THREADS_MAX = 256 };
+
 /* {{{ log dir */
 
 /**
@@ -436,6 +465,11 @@ struct xlog {
 	 * Compressed output buffer
 	 */
 	struct obuf zbuf;
+	/**
+	 * Blocks waiting to be compressed in parallel, NULL unless
+	 * compress_threads > 1 is set in xlog_opts.
+	 */
+	struct xlog_zbatch *zbatch;
 	/**
 	 * Synced file size
 	 */
@@ -884,6 +918,29 @@ xlog_cursor_pos(struct xlog_cursor *cursor)
 	return cursor->read_offset - ibuf_used(&cursor->rbuf);
 }
 
+/**
+ * Return true if the cursor has returned all rows of the last read
+ * tx so that xlog_cursor_pos() points to the next tx.
+ */
+static inline bool
+xlog_cursor_is_tx_done(struct xlog_cursor *cursor)
+{
+	return cursor->state != XLOG_CURSOR_TX ||
+	       ibuf_used(&cursor->tx_cursor) == 0;
+}
+
+/**
+ * Advance the cursor to the given file position skipping all data
+ * in between. The position must point to a tx boundary and must not
+ * be less than the current cursor position, which in turn must point
+ * to a tx boundary, too (see xlog_cursor_is_tx_done()).
+ *
+ * This is used when the rows located between the current cursor
+ * position and the given one have been obtained by other means.
+ */
+void
+xlog_cursor_skip_to(struct xlog_cursor *cursor, off_t offset);
+
 /**
  * Return tx positon for xlog cursor
  *
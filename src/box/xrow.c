@@ -43,6 +43,7 @@
 #include "error.h"
 #include "mp_error.h"
 #include "mp_extension_types.h"
+#include "mp_scan.h"
 #include "iproto_constants.h"
 #include "iproto_features.h"
 #include "mpstream/mpstream.h"
@@ -283,7 +284,8 @@ xrow_decode(struct xrow_header *header, const char **pos,
 	}
 
 	const char *body = *pos;
-	int rc = end_is_exact ? mp_check_exact(pos, end) : mp_check(pos, end);
+	int rc = end_is_exact ? mp_check_exact_fast(pos, end) :
+				mp_check_fast(pos, end);
 	if (rc != 0) {
 		diag_add(ClientError, ER_INVALID_MSGPACK, "packet body");
 		goto dump;
@@ -824,6 +826,30 @@ iproto_reply_select_with_position(struct obuf *buf, struct obuf_svp *svp,
 	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
 }
 
+/** Reply cursor fetch with IPROTO_DATA and optional IPROTO_CURSOR_ID. */
+void
+iproto_reply_cursor(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
+		    uint64_t schema_version, uint32_t count, uint64_t cursor_id)
+{
+	struct iproto_body_bin body = iproto_body_bin;
+	if (cursor_id != 0) {
+		size_t alloc_size = mp_sizeof_uint(IPROTO_CURSOR_ID) +
+				    mp_sizeof_uint(cursor_id);
+		char *ptr = xobuf_alloc(buf, alloc_size);
+		ptr = mp_encode_uint(ptr, IPROTO_CURSOR_ID);
+		mp_encode_uint(ptr, cursor_id);
+		body = iproto_body_bin_with_position;
+	}
+
+	char *pos = (char *)obuf_svp_to_ptr(buf, svp);
+	iproto_header_encode(pos, IPROTO_OK, sync, schema_version,
+			     obuf_size(buf) - svp->used -
+			     IPROTO_HEADER_LEN);
+
+	body.v_data_len = mp_bswap_u32(count);
+	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
+}
+
 int
 xrow_decode_sql(const struct xrow_header *row, struct sql_request *request)
 {
@@ -998,6 +1024,9 @@ xrow_decode_dml_internal(struct xrow_header *row, struct request *request,
 		case IPROTO_ITERATOR:
 			request->iterator = mp_decode_uint(&value);
 			break;
+		case IPROTO_CURSOR_ID:
+			request->cursor_id = mp_decode_uint(&value);
+			break;
 		case IPROTO_FETCH_POSITION:
 			request->fetch_position = mp_decode_bool(&value);
 			break;
@@ -1009,6 +1038,10 @@ xrow_decode_dml_internal(struct xrow_header *row, struct request *request,
 			request->key = value;
 			request->key_end = data;
 			break;
+		case IPROTO_KEY_LIST:
+			request->key_list = value;
+			request->key_list_end = data;
+			break;
 		case IPROTO_OPS:
 			request->ops = value;
 			request->ops_end = data;
@@ -1091,6 +1124,14 @@ request_snprint(char *buf, int size, const struct request *request)
 		SNPRINT(total, snprintf, buf, size, ", key: ");
 		SNPRINT(total, mp_snprint, buf, size, request->key);
 	}
+	if (request->key_list != NULL) {
+		SNPRINT(total, snprintf, buf, size, ", key_list: ");
+		SNPRINT(total, mp_snprint, buf, size, request->key_list);
+	}
+	if (request->cursor_id != 0) {
+		SNPRINT(total, snprintf, buf, size, ", cursor_id: %llu",
+			(unsigned long long)request->cursor_id);
+	}
 	if (request->tuple != NULL) {
 		SNPRINT(total, snprintf, buf, size, ", tuple: ");
 		SNPRINT(total, mp_snprint, buf, size, request->tuple);
@@ -218,6 +218,12 @@ struct request {
 	/** Search key. */
 	const char *key;
 	const char *key_end;
+	/** Array of search keys of IPROTO_SELECT_MULTI request. */
+	const char *key_list;
+	/** End of @key_list. */
+	const char *key_list_end;
+	/** Server-side cursor id, see IPROTO_CURSOR_OPEN. */
+	uint64_t cursor_id;
 	/** Insert/replace/upsert tuple or proc argument or update operations. */
 	const char *tuple;
 	const char *tuple_end;
@@ -926,6 +932,14 @@ iproto_reply_select_with_position(struct obuf *buf, struct obuf_svp *svp,
 				  const char *packed_pos_end,
 				  bool box_tuple_as_ext);
 
+/**
+ * Write cursor fetch header to a buffer prepared with iproto_prepare_select().
+ * IPROTO_CURSOR_ID is appended to the response body unless @a cursor_id is 0.
+ */
+void
+iproto_reply_cursor(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
+		    uint64_t schema_version, uint32_t count, uint64_t cursor_id);
+
 /**
  * Encode iproto header with IPROTO_OK response code.
  * @param out Encode to.
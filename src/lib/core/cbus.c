@@ -31,8 +31,28 @@
 #include "cbus.h"
 
 #include <limits.h>
+#include <pmatomic.h>
 #include "fiber.h"
 #include "trigger.h"
+#include "tweaks.h"
+
+/**
+ * If set, new pipes use CPIPE_TRANSPORT_LOCKFREE by default.
+ */
+static bool cpipe_lockfree = false;
+TWEAK_BOOL(cpipe_lockfree);
+
+/**
+ * Max number of iterations cbus_loop() may spin waiting for messages
+ * from lock-free pipes before going to sleep. Zero disables spinning.
+ */
+static uint64_t cbus_spin_max = 1024;
+TWEAK_UINT(cbus_spin_max);
+
+enum {
+	/** Min number of iterations cbus_loop() spins, see spin_count. */
+	CBUS_SPIN_MIN = 16,
+};
 
 /**
  * Cord interconnect.
@@ -87,6 +107,89 @@ static void
 cpipe_flush_cb(ev_loop * /* loop */, struct ev_async *watcher,
 	       int /* events */);
 
+/* {{{ Lock-free endpoint queue */
+
+static inline struct stailq_entry *
+cbus_lockfree_next(struct stailq_entry *entry)
+{
+	return pm_atomic_load_explicit(
+		(struct stailq_entry **)(void *)&entry->next.value,
+		pm_memory_order_acquire);
+}
+
+/**
+ * Append a list of linked entries to the lock-free queue of an
+ * endpoint. Wait-free: may be called by any number of producers
+ * concurrently.
+ */
+static void
+cbus_lockfree_push(struct cbus_endpoint *endpoint, struct stailq_entry *first,
+		   struct stailq_entry *last)
+{
+	last->next.value = NULL;
+	struct stailq_entry *prev = pm_atomic_exchange(
+		&endpoint->lockfree_tail, last);
+	/*
+	 * Until the store below is done, the consumer can't see the new
+	 * entries and stops at prev. It will be woken up by the async
+	 * sent after the push.
+	 */
+	pm_atomic_store_explicit(
+		(struct stailq_entry **)(void *)&prev->next.value, first,
+		pm_memory_order_release);
+}
+
+/** Move all messages from the lock-free queue to @a output. */
+static void
+cbus_lockfree_fetch(struct cbus_endpoint *endpoint, struct stailq *output)
+{
+	struct stailq_entry *stub = &endpoint->lockfree_stub;
+	struct stailq_entry *head = endpoint->lockfree_head;
+	struct stailq_entry *next = cbus_lockfree_next(head);
+	while (true) {
+		if (head == stub) {
+			if (next == NULL)
+				break;
+			head = next;
+			next = cbus_lockfree_next(head);
+			continue;
+		}
+		if (next == NULL) {
+			/*
+			 * A producer has exchanged the tail, but hasn't
+			 * linked the new entries yet. They will be
+			 * fetched on the next wakeup.
+			 */
+			if (head != pm_atomic_load(&endpoint->lockfree_tail))
+				break;
+			/*
+			 * The head is the last entry. We can't take it
+			 * out until there's an entry following it so
+			 * re-add the stub.
+			 */
+			cbus_lockfree_push(endpoint, stub, stub);
+			next = cbus_lockfree_next(head);
+			if (next == NULL)
+				break;
+		}
+		stailq_add_tail(output, head);
+		head = next;
+		next = cbus_lockfree_next(head);
+	}
+	endpoint->lockfree_head = head;
+}
+
+/** Check if there are messages in the lock-free queue. */
+static inline bool
+cbus_lockfree_is_empty(struct cbus_endpoint *endpoint)
+{
+	struct stailq_entry *stub = &endpoint->lockfree_stub;
+	return endpoint->lockfree_head == stub &&
+	       cbus_lockfree_next(stub) == NULL;
+}
+
+/* }}} Lock-free endpoint queue */
+
 void
 cpipe_create_noev(struct cpipe *pipe, const char *consumer)
 {
@@ -95,6 +198,8 @@ cpipe_create_noev(struct cpipe *pipe, const char *consumer)
 	pipe->n_input = 0;
 	pipe->max_input = INT_MAX;
 	pipe->producer = NULL;
+	pipe->transport = cpipe_lockfree ? CPIPE_TRANSPORT_LOCKFREE :
+			  CPIPE_TRANSPORT_MUTEX;
 	rlist_create(&pipe->on_flush);
 
 	tt_pthread_mutex_lock(&cbus.mutex);
@@ -106,9 +211,30 @@ cpipe_create_noev(struct cpipe *pipe, const char *consumer)
 	}
 	pipe->endpoint = endpoint;
 	++pipe->endpoint->n_pipes;
+	if (pipe->transport == CPIPE_TRANSPORT_MUTEX)
+		pm_atomic_fetch_add(&endpoint->n_mutex_pipes, 1);
+	else
+		pm_atomic_fetch_add(&endpoint->n_lockfree_pipes, 1);
 	tt_pthread_mutex_unlock(&cbus.mutex);
 }
 
+void
+cpipe_set_transport(struct cpipe *pipe, enum cpipe_transport transport)
+{
+	assert(pipe->n_input == 0);
+	if (pipe->transport == transport)
+		return;
+	struct cbus_endpoint *endpoint = pipe->endpoint;
+	if (transport == CPIPE_TRANSPORT_MUTEX) {
+		pm_atomic_fetch_add(&endpoint->n_mutex_pipes, 1);
+		pm_atomic_fetch_sub(&endpoint->n_lockfree_pipes, 1);
+	} else {
+		pm_atomic_fetch_add(&endpoint->n_lockfree_pipes, 1);
+		pm_atomic_fetch_sub(&endpoint->n_mutex_pipes, 1);
+	}
+	pipe->transport = transport;
+}
+
 void
 cpipe_create(struct cpipe *pipe, const char *consumer)
 {
@@ -121,15 +247,22 @@ cpipe_create(struct cpipe *pipe, const char *consumer)
 struct cmsg_poison {
 	struct cmsg msg;
 	struct cbus_endpoint *endpoint;
+	/** Transport of the destroyed pipe. */
+	enum cpipe_transport transport;
 };
 
 static void
 cbus_endpoint_poison_f(struct cmsg *msg)
 {
-	struct cbus_endpoint *endpoint = ((struct cmsg_poison *)msg)->endpoint;
+	struct cmsg_poison *poison = (struct cmsg_poison *)msg;
+	struct cbus_endpoint *endpoint = poison->endpoint;
 	tt_pthread_mutex_lock(&cbus.mutex);
 	assert(endpoint->n_pipes > 0);
 	--endpoint->n_pipes;
+	if (poison->transport == CPIPE_TRANSPORT_MUTEX)
+		pm_atomic_fetch_sub(&endpoint->n_mutex_pipes, 1);
+	else
+		pm_atomic_fetch_sub(&endpoint->n_lockfree_pipes, 1);
 	tt_pthread_mutex_unlock(&cbus.mutex);
 	fiber_cond_signal(&endpoint->cond);
 	free(msg);
@@ -149,17 +282,24 @@ cpipe_destroy(struct cpipe *pipe)
 	struct cmsg_poison *poison = malloc(sizeof(struct cmsg_poison));
 	cmsg_init(&poison->msg, route);
 	poison->endpoint = pipe->endpoint;
+	poison->transport = pipe->transport;
 	/*
 	 * Avoid the general purpose cpipe_push() since
 	 * we want to control the way the poison message is
 	 * delivered.
 	 */
 	tt_pthread_mutex_lock(&endpoint->mutex);
+	/* Add the pipe shutdown message as the last one. */
+	stailq_add_tail_entry(&pipe->input, poison, msg.fifo);
 	/* Flush input */
-	stailq_concat(&endpoint->output, &pipe->input);
+	if (pipe->transport == CPIPE_TRANSPORT_LOCKFREE) {
+		cbus_lockfree_push(endpoint, stailq_first(&pipe->input),
+				   stailq_last(&pipe->input));
+		stailq_create(&pipe->input);
+	} else {
+		stailq_concat(&endpoint->output, &pipe->input);
+	}
 	pipe->n_input = 0;
-	/* Add the pipe shutdown message as the last one. */
-	stailq_add_tail_entry(&endpoint->output, poison, msg.fifo);
 	/* Count statistics */
 	rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
 	/*
@@ -219,9 +359,15 @@ cbus_endpoint_create(struct cbus_endpoint *endpoint, const char *name,
 	snprintf(endpoint->name, sizeof(endpoint->name), "%s", name);
 	endpoint->consumer = loop();
 	endpoint->n_pipes = 0;
+	endpoint->n_mutex_pipes = 0;
+	endpoint->n_lockfree_pipes = 0;
+	endpoint->spin_count = CBUS_SPIN_MIN;
 	fiber_cond_create(&endpoint->cond);
 	tt_pthread_mutex_init(&endpoint->mutex, NULL);
 	stailq_create(&endpoint->output);
+	endpoint->lockfree_stub.next.value = NULL;
+	endpoint->lockfree_head = &endpoint->lockfree_stub;
+	endpoint->lockfree_tail = &endpoint->lockfree_stub;
 	ev_async_init(&endpoint->async,
 		      (void (*)(ev_loop *, struct ev_async *, int)) fetch_cb);
 	endpoint->async.data = fetch_data;
@@ -255,7 +401,13 @@ cbus_endpoint_destroy(struct cbus_endpoint *endpoint,
 	while (true) {
 		if (process_cb)
 			process_cb(endpoint);
-		if (endpoint->n_pipes == 0 && stailq_empty(&endpoint->output))
+		/*
+		 * Messages of lock-free pipes bypass the output list so
+		 * check the lock-free queue as well, otherwise they would
+		 * be lost.
+		 */
+		if (endpoint->n_pipes == 0 && stailq_empty(&endpoint->output) &&
+		    cbus_lockfree_is_empty(endpoint))
 			break;
 		 fiber_cond_wait(&endpoint->cond);
 	}
@@ -280,6 +432,22 @@ cpipe_flush(struct cpipe *pipe)
 		return;
 	struct cbus_endpoint *endpoint = pipe->endpoint;
 	trigger_run(&pipe->on_flush, pipe);
+	if (pipe->transport == CPIPE_TRANSPORT_LOCKFREE) {
+		cbus_lockfree_push(endpoint, stailq_first(&pipe->input),
+				   stailq_last(&pipe->input));
+		stailq_create(&pipe->input);
+		pipe->n_input = 0;
+		rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
+		/*
+		 * We can't tell if the consumer has seen the previous
+		 * messages so always notify it. This is cheap unless the
+		 * consumer is sleeping: libev doesn't write to the wakeup
+		 * descriptor if the async is already pending or the
+		 * consumer loop isn't blocked in poll.
+		 */
+		ev_async_send(endpoint->consumer, &endpoint->async);
+		return;
+	}
 	/* Trigger task processing when the queue becomes non-empty. */
 	bool output_was_empty;
 
@@ -600,6 +768,54 @@ cbus_unpair(struct cpipe *dest_pipe, struct cpipe *src_pipe,
 	cpipe_destroy(dest_pipe);
 }
 
+void
+cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output)
+{
+	if (pm_atomic_load(&endpoint->n_mutex_pipes) > 0) {
+		tt_pthread_mutex_lock(&endpoint->mutex);
+		stailq_concat(output, &endpoint->output);
+		tt_pthread_mutex_unlock(&endpoint->mutex);
+	}
+	cbus_lockfree_fetch(endpoint, output);
+}
+
+static inline void
+cbus_cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	__asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * Spin for a while waiting for new messages in the lock-free queue of
+ * an endpoint. Returns true if a message has arrived. Waking up a
+ * sleeping consumer takes a system call on both sides so under a high
+ * message rate it's cheaper to wait a bit before going to sleep. The
+ * number of iterations adapts to the load: it grows while messages
+ * keep arriving in time and shrinks otherwise.
+ */
+static bool
+cbus_endpoint_spin(struct cbus_endpoint *endpoint)
+{
+	int spin_max = MIN(cbus_spin_max, (uint64_t)INT_MAX / 2);
+	if (spin_max == 0 ||
+	    pm_atomic_load(&endpoint->n_lockfree_pipes) == 0)
+		return false;
+	int spin_count = MIN(endpoint->spin_count, spin_max);
+	for (int i = 0; i < spin_count; i++) {
+		if (!cbus_lockfree_is_empty(endpoint)) {
+			endpoint->spin_count = MIN(spin_count * 2, spin_max);
+			return true;
+		}
+		cbus_cpu_relax();
+	}
+	endpoint->spin_count = MAX(spin_count / 2, CBUS_SPIN_MIN);
+	return false;
+}
+
 void
 cbus_process(struct cbus_endpoint *endpoint)
 {
@@ -619,6 +835,14 @@ cbus_loop(struct cbus_endpoint *endpoint)
 		fiber_check_gc();
 		if (fiber_is_cancelled())
 			break;
+		if (cbus_endpoint_spin(endpoint)) {
+			/*
+			 * Let other fibers and the event loop run, but
+			 * don't block in poll.
+			 */
+			fiber_reschedule();
+			continue;
+		}
 		fiber_yield();
 	}
 }
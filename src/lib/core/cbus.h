@@ -109,6 +109,22 @@ cmsg_init(struct cmsg *msg, const struct cmsg_hop *route)
 void
 cmsg_deliver(struct cmsg *msg);
 
+/** The way messages are passed from a pipe to its endpoint. */
+enum cpipe_transport {
+	/**
+	 * Flushed messages are appended to the endpoint output queue
+	 * under the endpoint mutex.
+	 */
+	CPIPE_TRANSPORT_MUTEX,
+	/**
+	 * Flushed messages are appended to a lock-free queue of the
+	 * endpoint with a single atomic exchange. Cheaper than the mutex
+	 * when several producers flush to the same endpoint at a high
+	 * rate.
+	 */
+	CPIPE_TRANSPORT_LOCKFREE,
+};
+
 /** A  uni-directional FIFO queue from one cord to another. */
 struct cpipe {
 	/** Staging area for pushed messages */
@@ -140,6 +156,8 @@ struct cpipe {
 	 * is not empty.
 	 */
 	struct rlist on_flush;
+	/** The way flushed messages are passed to the endpoint. */
+	enum cpipe_transport transport;
 };
 
 /**
@@ -180,6 +198,14 @@ cpipe_set_max_input(struct cpipe *pipe, int max_input)
 	pipe->max_input = max_input;
 }
 
+/**
+ * Set the transport used by a pipe. The default one is chosen by the
+ * cpipe_lockfree tweak. Must be called by the producer before the
+ * first message is pushed to the pipe.
+ */
+void
+cpipe_set_transport(struct cpipe *pipe, enum cpipe_transport transport);
+
 void
 cpipe_flush(struct cpipe *pipe);
 
@@ -245,6 +271,33 @@ struct cbus_endpoint {
 	pthread_mutex_t mutex;
 	/** A queue with incoming messages. */
 	struct stailq output;
+	/**
+	 * A lock-free multi-producer single-consumer queue with messages
+	 * incoming from pipes using CPIPE_TRANSPORT_LOCKFREE. Producers
+	 * exchange the tail and then link the previous tail to the new
+	 * messages. The consumer takes messages from the head. The queue
+	 * always contains at least one entry: either a message or the
+	 * stub, which is re-added by the consumer to take the last
+	 * message out.
+	 */
+	struct stailq_entry *lockfree_tail;
+	/** Head of the lock-free queue. Accessed only by the consumer. */
+	struct stailq_entry *lockfree_head;
+	/** Stub entry of the lock-free queue. */
+	struct stailq_entry lockfree_stub;
+	/** Number of connected pipes using CPIPE_TRANSPORT_MUTEX. */
+	uint32_t n_mutex_pipes;
+	/**
+	 * Number of connected pipes using CPIPE_TRANSPORT_LOCKFREE.
+	 * Unlike n_pipes, it may be read without cbus.mutex.
+	 */
+	uint32_t n_lockfree_pipes;
+	/**
+	 * Number of iterations cbus_loop() spins waiting for new
+	 * messages in the lock-free queue before going to sleep. Doubled
+	 * when a message arrives while spinning, halved otherwise.
+	 */
+	int spin_count;
 	/** Consumer cord loop */
 	ev_loop *consumer;
 	/** Async to notify the consumer */
@@ -258,13 +311,8 @@ struct cbus_endpoint {
 /**
  * Fetch incomming messages to output
  */
-static inline void
-cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output)
-{
-	tt_pthread_mutex_lock(&endpoint->mutex);
-	stailq_concat(output, &endpoint->output);
-	tt_pthread_mutex_unlock(&endpoint->mutex);
-}
+void
+cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output);
 
 /** Initialize the global singleton bus. */
 void
@@ -34,9 +34,11 @@
 #include "say.h"
 #include "fio.h"
 #include "errinj.h"
+#include "uring.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <dirent.h>
+#include <errno.h>
 
 /**
  * A context of libeio request for any
@@ -106,6 +108,41 @@ struct coio_file_task {
 	};
 };
 
+enum {
+	/** Size of the io_uring submission queue used by coio. */
+	COIO_URING_ENTRIES = 64,
+};
+
+/**
+ * Ring used by the main thread for reads, writes and syncs instead of
+ * the coio thread pool if io_uring is available. Created on demand.
+ */
+static struct uring *coio_uring;
+
+/**
+ * Set if the coio ring couldn't be created for a reason other than
+ * io_uring being disabled or unsupported (for example, the locked memory
+ * limit), so that we fall back on the coio thread pool for good instead
+ * of retrying io_uring_setup() on every call.
+ */
+static bool coio_uring_failed;
+
+/** Returns the coio ring or NULL if io_uring can't be used. */
+static struct uring *
+coio_get_uring(void)
+{
+	if (!cord_is_main() || coio_uring_failed)
+		return NULL;
+	if (coio_uring == NULL) {
+		int save_errno = errno;
+		coio_uring = uring_new(COIO_URING_ENTRIES, 0);
+		if (coio_uring == NULL && errno != ENOSYS)
+			coio_uring_failed = true;
+		errno = save_errno;
+	}
+	return coio_uring;
+}
+
 #define INIT_COEIO_FILE(name)			\
 	struct coio_file_task name;		\
 	memset(&name, 0, sizeof(name));		\
@@ -166,6 +203,9 @@ coio_pwrite(int fd, const void *buf, size_t count, off_t offset)
 {
 	ssize_t left = count, pos = 0, res, chunk;
 	eio_req *req;
+	struct uring *ring = coio_get_uring();
+	if (ring != NULL)
+		return uring_co_pwrite(ring, fd, buf, count, offset);
 
 	while (left > 0) {
 		INIT_COEIO_FILE(eio);
@@ -193,6 +233,9 @@ coio_pwrite(int fd, const void *buf, size_t count, off_t offset)
 ssize_t
 coio_pread(int fd, void *buf, size_t count, off_t offset)
 {
+	struct uring *ring = coio_get_uring();
+	if (ring != NULL)
+		return uring_co_pread(ring, fd, buf, count, offset);
 	INIT_COEIO_FILE(eio);
 	eio_req *req = eio_read(fd, buf, count,
 				offset, 0, coio_complete, &eio);
@@ -535,6 +578,9 @@ coio_sync(void)
 int
 coio_fsync(int fd)
 {
+	struct uring *ring = coio_get_uring();
+	if (ring != NULL)
+		return uring_co_fsync(ring, fd, false);
 	INIT_COEIO_FILE(eio);
 	eio_req *req = eio_fsync(fd, 0, coio_complete, &eio);
 	return coio_wait_done(req, &eio);
@@ -543,6 +589,9 @@ coio_fsync(int fd)
 int
 coio_fdatasync(int fd)
 {
+	struct uring *ring = coio_get_uring();
+	if (ring != NULL)
+		return uring_co_fsync(ring, fd, true);
 	INIT_COEIO_FILE(eio);
 	eio_req *req = eio_fdatasync(fd, 0, coio_complete, &eio);
 	return coio_wait_done(req, &eio);
@@ -585,6 +585,28 @@ evio_service_detach(struct evio_service *service)
 	assert(service->entry_count == 0);
 }
 
+void
+evio_service_pause(struct evio_service *service)
+{
+	struct evio_service_entry *entry;
+	rlist_foreach_entry(entry, &service->entries, link) {
+		if (ev_is_active(&entry->ev))
+			ev_io_stop(service->loop, &entry->ev);
+	}
+}
+
+void
+evio_service_resume(struct evio_service *service)
+{
+	if (service->on_accept == NULL)
+		return;
+	struct evio_service_entry *entry;
+	rlist_foreach_entry(entry, &service->entries, link) {
+		if (entry->ev.fd >= 0 && !ev_is_active(&entry->ev))
+			ev_io_start(service->loop, &entry->ev);
+	}
+}
+
 /** Listen on bound socket. */
 static int
 evio_service_listen(struct evio_service *service)
@@ -130,6 +130,18 @@ evio_service_stop(struct evio_service *service);
 void
 evio_service_attach(struct evio_service *dst, const struct evio_service *src);
 
+/**
+ * Stop accepting new connections without detaching the service from its
+ * acceptor sockets. Pending connections stay in the listen backlog and may
+ * be accepted by another service attached to the same sockets.
+ */
+void
+evio_service_pause(struct evio_service *service);
+
+/** Resume accepting new connections after evio_service_pause(). */
+void
+evio_service_resume(struct evio_service *service);
+
 /**
  * Reload service URIs.
  *
@@ -82,6 +82,13 @@ histogram_collect(struct histogram *hist, int64_t val);
 void
 histogram_discard(struct histogram *hist, int64_t val);
 
+/**
+ * Add all observations collected by a histogram to another histogram.
+ * The histograms must have the same bucket boundaries.
+ */
+void
+histogram_merge(struct histogram *dst, const struct histogram *src);
+
 /**
  * Calculate a percentile, i.e. the value below which a given
  * percentage of observations fall.
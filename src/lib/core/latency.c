@@ -89,6 +89,21 @@ latency_collect(struct latency *latency, double value)
 	histogram_collect(latency->histogram, value_usec);
 }
 
+void
+latency_merge(struct latency *dst, const struct latency *src)
+{
+	histogram_merge(dst->histogram, src->histogram);
+	/* Drop the zero observation added by latency_create() to src. */
+	histogram_discard(dst->histogram, 0);
+}
+
+size_t
+latency_count(const struct latency *latency)
+{
+	/* Don't count the zero observation added by latency_create(). */
+	return latency->histogram->total - 1;
+}
+
 double
 latency_get(struct latency *latency, int pct)
 {
@@ -31,6 +31,8 @@
  * SUCH DAMAGE.
  */
 
+#include <stddef.h>
+
 struct histogram;
 
 /**
@@ -70,6 +72,19 @@ latency_reset(struct latency *latency);
 void
 latency_collect(struct latency *latency, double value);
 
+/**
+ * Add all observations collected by a latency counter to another
+ * latency counter.
+ */
+void
+latency_merge(struct latency *dst, const struct latency *src);
+
+/**
+ * Return the number of observations collected by a latency counter.
+ */
+size_t
+latency_count(const struct latency *latency);
+
 /**
  * Get accumulated latency value, in seconds.
  * Returns @pct-th percentile of all observations.
@@ -0,0 +1,74 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "mp_scan.h"
+
+/**
+ * Validate a MessagePack value without reporting errors. Nested values
+ * are counted like in mp_check(). Scalar values other than single-byte
+ * ones are validated with mp_check() so that extension types are checked
+ * the same way.
+ *
+ * Returns 0 on success, -1 if the data is invalid or truncated.
+ */
+static int
+mp_check_fast_impl(const char **data, const char *end)
+{
+	const char *p = *data;
+	uint64_t count = 1;
+	while (count > 0) {
+		if (p >= end)
+			return -1;
+		if (mp_scan_is_single_byte(*p)) {
+			uint32_t run = mp_scan_run(p, end, MIN(count, UINT32_MAX));
+			p += run;
+			count -= run;
+			continue;
+		}
+		switch (mp_typeof(*p)) {
+		case MP_ARRAY:
+			if (mp_check_array(p, end) > 0)
+				return -1;
+			count += mp_decode_array(&p);
+			break;
+		case MP_MAP:
+			if (mp_check_map(p, end) > 0)
+				return -1;
+			count += 2 * (uint64_t)mp_decode_map(&p);
+			break;
+		default:
+			if (mp_check(&p, end) != 0)
+				return -1;
+			break;
+		}
+		count--;
+	}
+	*data = p;
+	return 0;
+}
+
+int
+mp_check_fast(const char **data, const char *end)
+{
+	const char *p = *data;
+	if (likely(mp_check_fast_impl(&p, end) == 0)) {
+		*data = p;
+		return 0;
+	}
+	/* Rescan to report the error. */
+	return mp_check(data, end);
+}
+
+int
+mp_check_exact_fast(const char **data, const char *end)
+{
+	const char *p = *data;
+	if (likely(mp_check_fast_impl(&p, end) == 0 && p == end)) {
+		*data = p;
+		return 0;
+	}
+	/* Rescan to report the error. */
+	return mp_check_exact(data, end);
+}
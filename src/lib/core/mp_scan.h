@@ -0,0 +1,142 @@
+#pragma once
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif /* defined(__SSE2__) */
+
+#include "msgpuck.h"
+#include "trivia/util.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * Helpers for skipping and validating MessagePack faster than value by
+ * value. Tuples often consist of small integers, nils and booleans, which
+ * are encoded in one byte each. Runs of such values are skipped in bulk:
+ * with SSE2, 16 bytes are classified with a few vector instructions.
+ *
+ * When the end of the data is unknown, the 16 bytes may extend past the
+ * last value. Such a load never crosses a page boundary so it can't
+ * fault, but memory checkers would complain about it. So the functions
+ * doing it aren't instrumented by ASAN, and in builds integrated with
+ * valgrind (NVALGRIND is undefined) only bounded loads are vectorized.
+ */
+
+enum {
+	/** Number of bytes classified at once by mp_scan_run(). */
+	MP_SCAN_CHUNK = 16,
+	/** Size of a memory page, a 16 byte load never crosses it. */
+	MP_SCAN_PAGE_SIZE = 4096,
+};
+
+/** Check if a MessagePack value starting with the given byte is 1 byte. */
+static inline bool
+mp_scan_is_single_byte(uint8_t c)
+{
+	/*
+	 * Positive fixint (0x00..0x7f) and negative fixint (0xe0..0xff)
+	 * are >= -32 if treated as signed. Plus nil, false, true.
+	 */
+	return (int8_t)c >= -32 || c == 0xc0 || c == 0xc2 || c == 0xc3;
+}
+
+#if defined(__SSE2__)
+/**
+ * Return the number of single-byte MessagePack values at the beginning
+ * of the given 16 bytes.
+ */
+static inline uint32_t NO_SANITIZE_ADDRESS
+mp_scan_run_sse2(const char *data)
+{
+	__m128i v = _mm_loadu_si128((const __m128i *)data);
+	__m128i m = _mm_cmpgt_epi8(v, _mm_set1_epi8(-33));
+	m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8((char)0xc0)));
+	m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8((char)0xc2)));
+	m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8((char)0xc3)));
+	uint32_t mask = (uint32_t)_mm_movemask_epi8(m);
+	return __builtin_ctz(~mask);
+}
+#endif /* defined(__SSE2__) */
+
+/**
+ * Return the number of single-byte MessagePack values at the beginning
+ * of the given data, at most MP_SCAN_CHUNK and at most @a count. The data
+ * must be readable up to the end pointer. If the end is unknown (NULL),
+ * the data may be read past the last value, but not past the memory page
+ * it ends on.
+ */
+static inline uint32_t NO_SANITIZE_ADDRESS
+mp_scan_run(const char *data, const char *end, uint32_t count)
+{
+#if defined(__SSE2__)
+	if (end != NULL) {
+		if (end - data >= MP_SCAN_CHUNK)
+			return MIN(mp_scan_run_sse2(data), count);
+	} else {
+#if defined(NVALGRIND)
+		if (((uintptr_t)data & (MP_SCAN_PAGE_SIZE - 1)) <=
+		    MP_SCAN_PAGE_SIZE - MP_SCAN_CHUNK)
+			return MIN(mp_scan_run_sse2(data), count);
+#endif /* defined(NVALGRIND) */
+	}
+#endif /* defined(__SSE2__) */
+	uint32_t run = 0;
+	uint32_t max = MIN((uint32_t)MP_SCAN_CHUNK, count);
+	if (end != NULL && end - data < max)
+		max = end - data;
+	while (run < max && mp_scan_is_single_byte(data[run]))
+		run++;
+	return run;
+}
+
+/**
+ * Skip the given number of MessagePack values. Equivalent to calling
+ * mp_next() count times.
+ */
+static inline void
+mp_next_n(const char **data, uint32_t count)
+{
+	const char *p = *data;
+	while (count > 0) {
+		if (count > 1 && mp_scan_is_single_byte(*p)) {
+			uint32_t run = mp_scan_run(p, NULL, count);
+			p += run;
+			count -= run;
+			continue;
+		}
+		mp_next(&p);
+		count--;
+	}
+	*data = p;
+}
+
+/**
+ * Validate a MessagePack value. Equivalent to mp_check(), including
+ * the error reporting, but skips runs of single-byte values in bulk.
+ *
+ * @retval 0 success, the data is advanced past the value
+ * @retval != 0 invalid MessagePack
+ */
+int
+mp_check_fast(const char **data, const char *end);
+
+/**
+ * Validate a MessagePack value and check that it ends exactly at the
+ * given end. Equivalent to mp_check_exact().
+ */
+int
+mp_check_exact_fast(const char **data, const char *end);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
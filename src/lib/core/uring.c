@@ -0,0 +1,669 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "uring.h"
+
+#include <errno.h>
+
+#include "trivia/config.h"
+#include "tweaks.h"
+
+/**
+ * If this flag is cleared, uring_new() fails and all users fall back on
+ * plain system calls. Rings that have already been created keep working.
+ */
+static bool io_uring_enabled = false;
+TWEAK_BOOL(io_uring_enabled);
+
+#if defined(HAVE_IO_URING)
+
+#include <linux/io_uring.h>
+#include <pmatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "fiber.h"
+#include "fiber_cond.h"
+#include "say.h"
+#include "trivia/util.h"
+
+/**
+ * Set if io_uring_setup() failed because io_uring isn't supported by
+ * the kernel or is forbidden, so that we don't retry it every time.
+ */
+static bool uring_is_unsupported;
+
+/** A request submitted to a ring. */
+struct uring_req {
+	/** Result of the request. Valid only if done is set. */
+	int res;
+	/** Set when the request is complete. */
+	bool done;
+	/** Fiber to wake up on completion or NULL for a blocking wait. */
+	struct fiber *fiber;
+};
+
+struct uring {
+	/** Ring file descriptor. */
+	int fd;
+	/** Number of entries in the submission queue. */
+	unsigned sq_entries;
+	/** Memory mapped submission queue ring. */
+	void *sq_map;
+	/** Size of the memory mapped submission queue ring. */
+	size_t sq_map_size;
+	/** Submission queue head, updated by the kernel. */
+	unsigned *sq_head;
+	/** Submission queue tail, updated by us. */
+	unsigned *sq_tail;
+	/** Submission queue index mask. */
+	unsigned sq_mask;
+	/** Submission queue indirection array. */
+	unsigned *sq_array;
+	/** Memory mapped submission queue entries. */
+	struct io_uring_sqe *sqes;
+	/** Memory mapped completion queue ring. May equal sq_map. */
+	void *cq_map;
+	/** Size of the memory mapped completion queue ring. */
+	size_t cq_map_size;
+	/** Completion queue head, updated by us. */
+	unsigned *cq_head;
+	/** Completion queue tail, updated by the kernel. */
+	unsigned *cq_tail;
+	/** Completion queue index mask. */
+	unsigned cq_mask;
+	/** Completion queue entries. */
+	struct io_uring_cqe *cqes;
+	/** Number of requests that haven't been reaped yet. */
+	unsigned inflight;
+	/** Number of requests waited for by fibers. */
+	unsigned co_inflight;
+	/** Signalled when a request is reaped. */
+	struct fiber_cond cond;
+	/** Watcher of the ring fd used to reap cooperative requests. */
+	struct ev_io watcher;
+	/** Buffer registered in the kernel or NULL. */
+	char *buf;
+	/** Size of the registered buffer. */
+	size_t buf_size;
+};
+
+static int
+sys_io_uring_setup(unsigned entries, struct io_uring_params *params)
+{
+	return syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int
+sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+		   unsigned flags)
+{
+	return syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+		       flags, NULL, 0);
+}
+
+static int
+sys_io_uring_register(int fd, unsigned opcode, const void *arg,
+		      unsigned nr_args)
+{
+	return syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+/** Complete all requests found in the completion queue. */
+static void
+uring_reap(struct uring *ring)
+{
+	unsigned head = *ring->cq_head;
+	unsigned tail = pm_atomic_load_explicit(ring->cq_tail,
+						pm_memory_order_acquire);
+	if (head == tail)
+		return;
+	for (; head != tail; head++) {
+		struct io_uring_cqe *cqe = &ring->cqes[head & ring->cq_mask];
+		struct uring_req *req =
+			(struct uring_req *)(uintptr_t)cqe->user_data;
+		req->res = cqe->res;
+		req->done = true;
+		if (req->fiber != NULL) {
+			ring->co_inflight--;
+			fiber_wakeup(req->fiber);
+		}
+		ring->inflight--;
+	}
+	pm_atomic_store_explicit(ring->cq_head, head,
+				 pm_memory_order_release);
+	if (ring->co_inflight == 0 && ev_is_active(&ring->watcher))
+		ev_io_stop(loop(), &ring->watcher);
+	fiber_cond_broadcast(&ring->cond);
+}
+
+/** Block the calling thread until at least one request is complete. */
+static void
+uring_wait_any(struct uring *ring)
+{
+	assert(ring->inflight > 0);
+	if (sys_io_uring_enter(ring->fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+	    errno != EINTR)
+		panic_syserror("io_uring_enter");
+	uring_reap(ring);
+}
+
+/** Block the calling thread until the given request is complete. */
+static void
+uring_wait(struct uring *ring, struct uring_req *req)
+{
+	uring_reap(ring);
+	while (!req->done)
+		uring_wait_any(ring);
+}
+
+/** Yield the current fiber until the given request is complete. */
+static void
+uring_co_wait(struct uring *ring, struct uring_req *req)
+{
+	(void)ring;
+	while (!req->done)
+		fiber_yield();
+}
+
+static void
+uring_watcher_cb(struct ev_loop *loop, struct ev_io *watcher, int events)
+{
+	(void)loop;
+	(void)events;
+	struct uring *ring = watcher->data;
+	uring_reap(ring);
+}
+
+/**
+ * Wait until there are at least @a count free slots in the ring. We
+ * never submit more requests than there are submission queue entries so
+ * that the completion queue, which is twice as big, never overflows.
+ */
+static void
+uring_reserve(struct uring *ring, unsigned count, bool is_co)
+{
+	while (ring->inflight + count > ring->sq_entries) {
+		if (is_co)
+			fiber_cond_wait(&ring->cond);
+		else
+			uring_wait_any(ring);
+	}
+}
+
+/**
+ * Get the i-th free submission queue entry. The entry becomes visible
+ * to the kernel only after uring_submit() is called.
+ */
+static struct io_uring_sqe *
+uring_sqe(struct uring *ring, unsigned i)
+{
+	unsigned idx = (*ring->sq_tail + i) & ring->sq_mask;
+	struct io_uring_sqe *sqe = &ring->sqes[idx];
+	memset(sqe, 0, sizeof(*sqe));
+	ring->sq_array[idx] = idx;
+	return sqe;
+}
+
+/** Initialize a request and attach it to a submission queue entry. */
+static void
+uring_req_create(struct uring_req *req, struct io_uring_sqe *sqe,
+		 bool is_co)
+{
+	req->res = 0;
+	req->done = false;
+	req->fiber = is_co ? fiber() : NULL;
+	sqe->user_data = (uintptr_t)req;
+}
+
+/**
+ * Submit the first @a count entries of the submission queue. Returns
+ * the number of submitted entries. It may be less than @a count if the
+ * kernel failed to accept some of them, in which case the rest of the
+ * entries are discarded. Returns -1 and sets errno if no entries were
+ * submitted.
+ */
+static int
+uring_submit(struct uring *ring, unsigned count, bool is_co)
+{
+	unsigned tail = *ring->sq_tail;
+	pm_atomic_store_explicit(ring->sq_tail, tail + count,
+				 pm_memory_order_release);
+	unsigned submitted = 0;
+	while (submitted < count) {
+		int rc = sys_io_uring_enter(ring->fd, count - submitted, 0, 0);
+		if (rc < 0 && errno == EINTR)
+			continue;
+		if (rc <= 0) {
+			/*
+			 * The kernel reads the tail only when we enter it,
+			 * so it's safe to roll back the unused entries.
+			 */
+			pm_atomic_store_explicit(ring->sq_tail,
+						 tail + submitted,
+						 pm_memory_order_release);
+			if (rc == 0)
+				errno = EAGAIN;
+			break;
+		}
+		submitted += rc;
+	}
+	if (submitted == 0)
+		return -1;
+	ring->inflight += submitted;
+	if (is_co) {
+		ring->co_inflight += submitted;
+		if (!ev_is_active(&ring->watcher))
+			ev_io_start(loop(), &ring->watcher);
+	}
+	return submitted;
+}
+
+struct uring *
+uring_new(unsigned entries, size_t buf_size)
+{
+	if (!io_uring_enabled || uring_is_unsupported) {
+		errno = ENOSYS;
+		return NULL;
+	}
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	int fd = sys_io_uring_setup(entries, &params);
+	if (fd < 0) {
+		if (errno == ENOSYS || errno == EPERM)
+			uring_is_unsupported = true;
+		return NULL;
+	}
+	struct uring *ring = xcalloc(1, sizeof(*ring));
+	ring->fd = fd;
+	ring->sq_entries = params.sq_entries;
+	ring->sq_map_size = params.sq_off.array +
+			    params.sq_entries * sizeof(unsigned);
+	ring->cq_map_size = params.cq_off.cqes +
+			    params.cq_entries * sizeof(struct io_uring_cqe);
+	bool is_single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (is_single_mmap) {
+		ring->sq_map_size = MAX(ring->sq_map_size, ring->cq_map_size);
+		ring->cq_map_size = ring->sq_map_size;
+	}
+	ring->sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE,
+			    MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	if (ring->sq_map == MAP_FAILED) {
+		ring->sq_map = NULL;
+		goto fail;
+	}
+	if (is_single_mmap) {
+		ring->cq_map = ring->sq_map;
+	} else {
+		ring->cq_map = mmap(NULL, ring->cq_map_size,
+				    PROT_READ | PROT_WRITE,
+				    MAP_SHARED | MAP_POPULATE, fd,
+				    IORING_OFF_CQ_RING);
+		if (ring->cq_map == MAP_FAILED) {
+			ring->cq_map = NULL;
+			goto fail;
+		}
+	}
+	ring->sqes = mmap(NULL, params.sq_entries * sizeof(*ring->sqes),
+			  PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			  fd, IORING_OFF_SQES);
+	if (ring->sqes == MAP_FAILED) {
+		ring->sqes = NULL;
+		goto fail;
+	}
+	char *sq = ring->sq_map;
+	ring->sq_head = (unsigned *)(sq + params.sq_off.head);
+	ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+	ring->sq_mask = *(unsigned *)(sq + params.sq_off.ring_mask);
+	ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+	char *cq = ring->cq_map;
+	ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+	ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+	ring->cq_mask = *(unsigned *)(cq + params.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+	if (buf_size > 0) {
+		/*
+		 * Registering a buffer may fail because of RLIMIT_MEMLOCK.
+		 * The ring is still usable then, only without the buffer.
+		 */
+		void *buf = mmap(NULL, buf_size, PROT_READ | PROT_WRITE,
+				 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		struct iovec iov = {.iov_base = buf, .iov_len = buf_size};
+		if (buf == MAP_FAILED) {
+			say_syserror("failed to allocate io_uring buffer");
+		} else if (sys_io_uring_register(fd, IORING_REGISTER_BUFFERS,
+						 &iov, 1) != 0) {
+			say_syserror("failed to register io_uring buffer");
+			munmap(buf, buf_size);
+		} else {
+			ring->buf = buf;
+			ring->buf_size = buf_size;
+		}
+	}
+	fiber_cond_create(&ring->cond);
+	ev_io_init(&ring->watcher, uring_watcher_cb, fd, EV_READ);
+	ring->watcher.data = ring;
+	return ring;
+fail:;
+	int save_errno = errno;
+	if (ring->sqes != NULL)
+		munmap(ring->sqes, ring->sq_entries * sizeof(*ring->sqes));
+	if (ring->cq_map != NULL && ring->cq_map != ring->sq_map)
+		munmap(ring->cq_map, ring->cq_map_size);
+	if (ring->sq_map != NULL)
+		munmap(ring->sq_map, ring->sq_map_size);
+	close(fd);
+	free(ring);
+	errno = save_errno;
+	return NULL;
+}
+
+void
+uring_delete(struct uring *ring)
+{
+	assert(ring->inflight == 0);
+	assert(!ev_is_active(&ring->watcher));
+	fiber_cond_destroy(&ring->cond);
+	if (ring->buf != NULL)
+		munmap(ring->buf, ring->buf_size);
+	munmap(ring->sqes, ring->sq_entries * sizeof(*ring->sqes));
+	if (ring->cq_map != ring->sq_map)
+		munmap(ring->cq_map, ring->cq_map_size);
+	munmap(ring->sq_map, ring->sq_map_size);
+	close(ring->fd);
+	free(ring);
+}
+
+/**
+ * Do a single read or write request and wait for its completion.
+ * Returns the request result.
+ */
+static ssize_t
+uring_rw(struct uring *ring, int opcode, int fd, const void *addr,
+	 size_t len, off_t offset, bool is_co)
+{
+	uring_reserve(ring, 1, is_co);
+	struct uring_req req;
+	struct io_uring_sqe *sqe = uring_sqe(ring, 0);
+	sqe->opcode = opcode;
+	sqe->fd = fd;
+	sqe->addr = (uintptr_t)addr;
+	sqe->len = len;
+	sqe->off = offset;
+	uring_req_create(&req, sqe, is_co);
+	if (uring_submit(ring, 1, is_co) < 0)
+		return -1;
+	if (is_co)
+		uring_co_wait(ring, &req);
+	else
+		uring_wait(ring, &req);
+	if (req.res < 0) {
+		errno = -req.res;
+		return -1;
+	}
+	return req.res;
+}
+
+ssize_t
+uring_pwritev(struct uring *ring, int fd, const struct iovec *iov,
+	      int iovcnt, off_t offset, int flags)
+{
+	size_t total = 0;
+	for (int i = 0; i < iovcnt; i++)
+		total += iov[i].iov_len;
+	bool need_sync = (flags & URING_DATASYNC) != 0;
+	struct uring_req write_req, sync_req;
+	sync_req.res = 0;
+	uring_reserve(ring, 2, false);
+	struct io_uring_sqe *sqe = uring_sqe(ring, 0);
+	sqe->opcode = IORING_OP_WRITEV;
+	sqe->fd = fd;
+	sqe->addr = (uintptr_t)iov;
+	sqe->len = iovcnt;
+	sqe->off = offset;
+	uring_req_create(&write_req, sqe, false);
+	if (need_sync) {
+		/*
+		 * A linked request is started only if the previous one
+		 * succeeds. For writes it means that all data was written.
+		 */
+		sqe->flags |= IOSQE_IO_LINK;
+		sqe = uring_sqe(ring, 1);
+		sqe->opcode = IORING_OP_FSYNC;
+		sqe->fd = fd;
+		sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+		uring_req_create(&sync_req, sqe, false);
+	}
+	int submitted = uring_submit(ring, need_sync ? 2 : 1, false);
+	if (submitted < 0)
+		return -1;
+	uring_wait(ring, &write_req);
+	if (need_sync && submitted == 2) {
+		uring_wait(ring, &sync_req);
+	} else if (need_sync) {
+		/* The kernel accepted the write, but not the sync. */
+		sync_req.res = fdatasync(fd) == 0 ? 0 : -errno;
+	}
+	if (write_req.res < 0) {
+		errno = -write_req.res;
+		return -1;
+	}
+	size_t written = write_req.res;
+	if (written < total) {
+		/*
+		 * A short write cancels the linked sync. Write the rest
+		 * and sync once again.
+		 */
+		struct iovec *rest = xcalloc(iovcnt, sizeof(*rest));
+		int rest_cnt = 0;
+		size_t skip = written;
+		for (int i = 0; i < iovcnt; i++) {
+			if (skip >= iov[i].iov_len) {
+				skip -= iov[i].iov_len;
+				continue;
+			}
+			rest[rest_cnt].iov_base = (char *)iov[i].iov_base + skip;
+			rest[rest_cnt].iov_len = iov[i].iov_len - skip;
+			rest_cnt++;
+			skip = 0;
+		}
+		ssize_t rc = uring_pwritev(ring, fd, rest, rest_cnt,
+					   offset + written, flags);
+		free(rest);
+		return rc < 0 ? -1 : (ssize_t)total;
+	}
+	if (need_sync && sync_req.res < 0) {
+		errno = -sync_req.res;
+		return -1;
+	}
+	return total;
+}
+
+ssize_t
+uring_pread(struct uring *ring, int fd, void *buf, size_t count,
+	    off_t offset)
+{
+	struct iovec iov = {.iov_base = buf, .iov_len = count};
+	return uring_rw(ring, IORING_OP_READV, fd, &iov, 1, offset, false);
+}
+
+ssize_t
+uring_read_fixed(struct uring *ring, int fd, size_t count, off_t offset,
+		 const char **data)
+{
+	if (count > ring->buf_size) {
+		errno = ENOBUFS;
+		return -1;
+	}
+	uring_reserve(ring, 1, false);
+	struct uring_req req;
+	struct io_uring_sqe *sqe = uring_sqe(ring, 0);
+	sqe->opcode = IORING_OP_READ_FIXED;
+	sqe->fd = fd;
+	sqe->addr = (uintptr_t)ring->buf;
+	sqe->len = count;
+	sqe->off = offset;
+	sqe->buf_index = 0;
+	uring_req_create(&req, sqe, false);
+	if (uring_submit(ring, 1, false) < 0)
+		return -1;
+	uring_wait(ring, &req);
+	if (req.res < 0) {
+		errno = -req.res;
+		return -1;
+	}
+	*data = ring->buf;
+	return req.res;
+}
+
+ssize_t
+uring_co_pwrite(struct uring *ring, int fd, const void *buf, size_t count,
+		off_t offset)
+{
+	size_t pos = 0;
+	while (pos < count) {
+		struct iovec iov = {
+			.iov_base = (char *)buf + pos,
+			.iov_len = count - pos,
+		};
+		ssize_t rc = uring_rw(ring, IORING_OP_WRITEV, fd, &iov, 1,
+				      offset + pos, true);
+		if (rc < 0)
+			return -1;
+		pos += rc;
+	}
+	return pos;
+}
+
+ssize_t
+uring_co_pread(struct uring *ring, int fd, void *buf, size_t count,
+	       off_t offset)
+{
+	struct iovec iov = {.iov_base = buf, .iov_len = count};
+	return uring_rw(ring, IORING_OP_READV, fd, &iov, 1, offset, true);
+}
+
+int
+uring_co_fsync(struct uring *ring, int fd, bool datasync)
+{
+	uring_reserve(ring, 1, true);
+	struct uring_req req;
+	struct io_uring_sqe *sqe = uring_sqe(ring, 0);
+	sqe->opcode = IORING_OP_FSYNC;
+	sqe->fd = fd;
+	sqe->fsync_flags = datasync ? IORING_FSYNC_DATASYNC : 0;
+	uring_req_create(&req, sqe, true);
+	if (uring_submit(ring, 1, true) < 0)
+		return -1;
+	uring_co_wait(ring, &req);
+	if (req.res < 0) {
+		errno = -req.res;
+		return -1;
+	}
+	return 0;
+}
+
+#else /* !defined(HAVE_IO_URING) */
+
+#include "trivia/util.h"
+
+struct uring *
+uring_new(unsigned entries, size_t buf_size)
+{
+	(void)io_uring_enabled;
+	(void)entries;
+	(void)buf_size;
+	errno = ENOSYS;
+	return NULL;
+}
+
+void
+uring_delete(struct uring *ring)
+{
+	(void)ring;
+	unreachable();
+}
+
+ssize_t
+uring_pwritev(struct uring *ring, int fd, const struct iovec *iov,
+	      int iovcnt, off_t offset, int flags)
+{
+	(void)ring;
+	(void)fd;
+	(void)iov;
+	(void)iovcnt;
+	(void)offset;
+	(void)flags;
+	unreachable();
+	return -1;
+}
+
+ssize_t
+uring_pread(struct uring *ring, int fd, void *buf, size_t count,
+	    off_t offset)
+{
+	(void)ring;
+	(void)fd;
+	(void)buf;
+	(void)count;
+	(void)offset;
+	unreachable();
+	return -1;
+}
+
+ssize_t
+uring_read_fixed(struct uring *ring, int fd, size_t count, off_t offset,
+		 const char **data)
+{
+	(void)ring;
+	(void)fd;
+	(void)count;
+	(void)offset;
+	(void)data;
+	unreachable();
+	return -1;
+}
+
+ssize_t
+uring_co_pwrite(struct uring *ring, int fd, const void *buf, size_t count,
+		off_t offset)
+{
+	(void)ring;
+	(void)fd;
+	(void)buf;
+	(void)count;
+	(void)offset;
+	unreachable();
+	return -1;
+}
+
+ssize_t
+uring_co_pread(struct uring *ring, int fd, void *buf, size_t count,
+	       off_t offset)
+{
+	(void)ring;
+	(void)fd;
+	(void)buf;
+	(void)count;
+	(void)offset;
+	unreachable();
+	return -1;
+}
+
+int
+uring_co_fsync(struct uring *ring, int fd, bool datasync)
+{
+	(void)ring;
+	(void)fd;
+	(void)datasync;
+	unreachable();
+	return -1;
+}
+
+#endif /* !defined(HAVE_IO_URING) */
@@ -0,0 +1,114 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+/**
+ * A thin wrapper around the Linux io_uring interface used for file I/O.
+ *
+ * A ring must not be used by more than one thread at a time, and the
+ * cooperative functions must always be called from the same thread. All
+ * functions follow the fio conventions: on failure they return -1 and
+ * set errno.
+ *
+ * There are two ways to wait for a request completion. Blocking
+ * functions (uring_pwritev(), uring_pread(), uring_read_fixed()) block
+ * the calling thread like the corresponding system calls do. They are
+ * meant to be used by threads that do I/O synchronously, like the WAL
+ * writer. Cooperative functions (uring_co_*) yield the current fiber
+ * until the request is complete. They are meant to replace the calls
+ * made via the coio thread pool.
+ *
+ * io_uring may be unavailable: the kernel may be too old or io_uring
+ * may be disabled by the system administrator or by the io_uring_enabled
+ * tweak. In this case uring_new() returns NULL and the caller is
+ * supposed to fall back on the plain system calls.
+ */
+struct uring;
+
+/** Flags for uring_pwritev(). */
+enum {
+	/**
+	 * Call fdatasync() after writing the data. The sync request is
+	 * linked to the write so both are done with a single system call.
+	 */
+	URING_DATASYNC = 1 << 0,
+};
+
+/**
+ * Create a ring. @a buf_size is the size of a buffer registered in the
+ * kernel for use with uring_read_fixed(). Zero means no buffer.
+ *
+ * Returns NULL and sets errno if io_uring isn't available.
+ */
+struct uring *
+uring_new(unsigned entries, size_t buf_size);
+
+/** Destroy a ring. There must be no requests in progress. */
+void
+uring_delete(struct uring *ring);
+
+/**
+ * Write the whole iovec array to a file at the given offset, blocking
+ * the calling thread. Returns the number of bytes written.
+ */
+ssize_t
+uring_pwritev(struct uring *ring, int fd, const struct iovec *iov,
+	      int iovcnt, off_t offset, int flags);
+
+/**
+ * Read up to @a count bytes from a file at the given offset, blocking
+ * the calling thread. Returns the number of bytes read.
+ */
+ssize_t
+uring_pread(struct uring *ring, int fd, void *buf, size_t count,
+	    off_t offset);
+
+/**
+ * Read up to @a count bytes from a file at the given offset into the
+ * registered buffer, blocking the calling thread. On success returns
+ * the number of bytes read and sets @a data to point to them. The data
+ * stays valid until the next call to this function. Fails with ENOBUFS
+ * if @a count is greater than the size of the registered buffer.
+ */
+ssize_t
+uring_read_fixed(struct uring *ring, int fd, size_t count, off_t offset,
+		 const char **data);
+
+/**
+ * Like pwrite(2), but yields the current fiber until the request is
+ * complete. Writes the whole buffer.
+ */
+ssize_t
+uring_co_pwrite(struct uring *ring, int fd, const void *buf, size_t count,
+		off_t offset);
+
+/**
+ * Like pread(2), but yields the current fiber until the request is
+ * complete.
+ */
+ssize_t
+uring_co_pread(struct uring *ring, int fd, void *buf, size_t count,
+	       off_t offset);
+
+/**
+ * Like fsync(2) or fdatasync(2) if @a datasync is set, but yields the
+ * current fiber until the request is complete.
+ */
+int
+uring_co_fsync(struct uring *ring, int fd, bool datasync);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -81,3 +81,66 @@ bloom_merge(const struct bloom *bloom, void *dst_data, const void *src_data)
 	for (size_t i = 0; i < size; i++)
 		dst[i] |= src[i];
 }
+
+/**
+ * Return the expected false positive rate of a split block bloom filter
+ * with the given number of blocks.
+ */
+static double
+bloom_split_fpr_impl(uint64_t block_count, uint32_t number_of_values)
+{
+	if (number_of_values == 0)
+		return 0;
+	/*
+	 * The number of values in a block follows the Poisson distribution.
+	 * A block with i values has a bit set in a word with probability
+	 * 1 - (1 - 1/32)^i and gives a false positive if all the words
+	 * have the bits of the looked up value set.
+	 */
+	double lambda = (double)number_of_values / block_count;
+	uint32_t word_bits = sizeof(uint32_t) * CHAR_BIT;
+	uint32_t max = ceil(lambda + 10 * sqrt(lambda) + 10);
+	double fpr = 0;
+	for (uint32_t i = 0; i <= max; i++) {
+		double p = exp(i * log(lambda) - lambda - lgamma(i + 1));
+		double bit = 1 - pow(1 - 1.0 / word_bits, i);
+		fpr += p * pow(bit, BLOOM_SPLIT_HASH_COUNT);
+	}
+	return fpr < 1 ? fpr : 1;
+}
+
+void
+bloom_split_create(struct bloom *bloom, uint32_t number_of_values,
+		   double false_positive_rate)
+{
+	/*
+	 * Start with the size of the classic bloom filter, which is a lower
+	 * bound, and grow it until the false positive rate is low enough.
+	 */
+	double bit_count = -(double)number_of_values *
+			   log(false_positive_rate) / (log(2) * log(2));
+	uint32_t block_bits = CHAR_BIT * sizeof(struct bloom_split_block);
+	uint64_t block_count = ceil(bit_count / block_bits);
+	if (block_count == 0)
+		block_count = 1;
+	while (block_count < UINT32_MAX &&
+	       bloom_split_fpr_impl(block_count, number_of_values) >
+	       false_positive_rate)
+		block_count += block_count / 16 + 1;
+
+	bloom->table_size = block_count < UINT32_MAX ?
+			    block_count : UINT32_MAX;
+	bloom->hash_count = BLOOM_SPLIT_HASH_COUNT;
+}
+
+size_t
+bloom_split_data_size(const struct bloom *bloom)
+{
+	return bloom->table_size * sizeof(struct bloom_split_block);
+}
+
+double
+bloom_split_fpr(const struct bloom *bloom, uint32_t number_of_values)
+{
+	return bloom_split_fpr_impl(bloom->table_size, number_of_values);
+}
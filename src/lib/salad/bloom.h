@@ -49,6 +49,10 @@
 #include <limits.h>
 #include "bit/bit.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif /* defined(__AVX2__) */
+
 #if defined(__cplusplus)
 extern "C" {
 #endif /* defined(__cplusplus) */
@@ -193,6 +197,153 @@ bloom_maybe_has(const struct bloom *bloom, const void *bloom_data,
 
 /* }}} API definition */
 
+/* {{{ Split block bloom filter
+ *
+ * A variant of the blocked bloom filter that fits a value into a single
+ * 256-bit block split into eight 32-bit words and sets exactly one bit in
+ * each word. All the bits of a value can be tested at once with a couple
+ * of vector instructions and, provided the data is aligned at the cache
+ * line boundary (it is up to the caller to allocate it so), a lookup
+ * touches a single cache line:
+ *  Putze, F.; Sanders, P.; Singler, J. (2007), see above, "register
+ *  blocking" variant.
+ *
+ * The definition is shared with the classic bloom filter: table_size is
+ * the number of 256-bit blocks and hash_count is always equal to
+ * BLOOM_SPLIT_HASH_COUNT. The data layouts are incompatible though.
+ */
+
+enum {
+	/** Number of words in a split block, one bit is set per word. */
+	BLOOM_SPLIT_HASH_COUNT = 8,
+};
+
+/**
+ * Block of a split block bloom filter.
+ */
+struct bloom_split_block {
+	uint32_t words[BLOOM_SPLIT_HASH_COUNT];
+};
+
+/**
+ * Initialize a split block bloom filter definition.
+ *
+ * @param bloom - structure to initialize
+ * @param number_of_values - estimated number of values to be added
+ * @param false_positive_rate - desired false positive rate
+ */
+void
+bloom_split_create(struct bloom *bloom, uint32_t number_of_values,
+		   double false_positive_rate);
+
+/**
+ * Calculate size of a buffer that is needed for storing split block
+ * bloom table.
+ * @param bloom - the bloom filter to store
+ * @return - Exact size
+ */
+size_t
+bloom_split_data_size(const struct bloom *bloom);
+
+/**
+ * Return the expected false positive rate of a split block bloom filter.
+ * @param bloom - the bloom filter
+ * @param number_of_values - number of values stored in the filter
+ * @return - expected false positive rate
+ */
+double
+bloom_split_fpr(const struct bloom *bloom, uint32_t number_of_values);
+
+/**
+ * Find the block a value with the given hash is stored in. Upper bits of
+ * the hash select the block, so that the bits in the block, which depend
+ * on the whole hash, are not correlated with the block number.
+ */
+static inline uint32_t
+bloom_split_block_no(const struct bloom *bloom, bloom_hash_t hash)
+{
+	return ((uint64_t)hash * bloom->table_size) >> 32;
+}
+
+/**
+ * Odd constants used for deriving the bit number in each word of a block
+ * from the value hash, taken from the Parquet split block bloom filter.
+ */
+#define BLOOM_SPLIT_SALT \
+	0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, \
+	0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+
+#if defined(__AVX2__)
+/** Return the bits a value with the given hash sets in its block. */
+static inline __m256i
+bloom_split_mask_avx2(bloom_hash_t hash)
+{
+	const __m256i salt = _mm256_setr_epi32(BLOOM_SPLIT_SALT);
+	__m256i bit_no = _mm256_mullo_epi32(_mm256_set1_epi32(hash), salt);
+	bit_no = _mm256_srli_epi32(bit_no, 27);
+	return _mm256_sllv_epi32(_mm256_set1_epi32(1), bit_no);
+}
+#endif /* defined(__AVX2__) */
+
+/**
+ * Add a value into the data set of a split block bloom filter.
+ * @param bloom - the bloom filter definition
+ * @param bloom_data - the bloom filter data
+ * @param hash - hash of the value
+ */
+static inline void
+bloom_split_add(const struct bloom *bloom, void *bloom_data,
+		bloom_hash_t hash)
+{
+	struct bloom_split_block *block = (struct bloom_split_block *)
+		bloom_data + bloom_split_block_no(bloom, hash);
+#if defined(__AVX2__)
+	__m256i *words = (__m256i *)block->words;
+	__m256i value = _mm256_loadu_si256(words);
+	value = _mm256_or_si256(value, bloom_split_mask_avx2(hash));
+	_mm256_storeu_si256(words, value);
+#else
+	static const uint32_t salt[BLOOM_SPLIT_HASH_COUNT] = {
+		BLOOM_SPLIT_SALT
+	};
+	for (int i = 0; i < BLOOM_SPLIT_HASH_COUNT; i++)
+		block->words[i] |= 1U << ((hash * salt[i]) >> 27);
+#endif
+}
+
+/**
+ * Query for presence of a value in the data set of a split block bloom
+ * filter.
+ * @param bloom - the bloom filter definition
+ * @param bloom_data - the bloom filter data
+ * @param hash - hash of the value
+ * @return true - the value could be in data set; false - the value is
+ *  definitively not in data set
+ */
+static inline bool
+bloom_split_maybe_has(const struct bloom *bloom, const void *bloom_data,
+		      bloom_hash_t hash)
+{
+	const struct bloom_split_block *block =
+		(const struct bloom_split_block *)bloom_data +
+		bloom_split_block_no(bloom, hash);
+#if defined(__AVX2__)
+	__m256i value = _mm256_loadu_si256((const __m256i *)block->words);
+	return _mm256_testc_si256(value, bloom_split_mask_avx2(hash));
+#else
+	static const uint32_t salt[BLOOM_SPLIT_HASH_COUNT] = {
+		BLOOM_SPLIT_SALT
+	};
+	/* No early exit so that the loop can be vectorized. */
+	uint32_t missing = 0;
+	for (int i = 0; i < BLOOM_SPLIT_HASH_COUNT; i++)
+		missing |= ~block->words[i] & (1U << ((hash * salt[i]) >> 27));
+	return missing == 0;
+#endif
+}
+
+/* }}} Split block bloom filter */
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -443,6 +443,7 @@ typedef int64_t bps_tree_block_card_t;
 #define bps_tree_approximate_count _api_name(approximate_count)
 #define bps_tree_iterator_get_elem_impl _bps_tree(iterator_get_elem)
 #define bps_tree_iterator_get_elem _api_name(iterator_get_elem)
+#define bps_tree_iterator_get_leaf_elems _api_name(iterator_get_leaf_elems)
 #define bps_tree_view_iterator_get_elem _api_name(view_iterator_get_elem)
 #define bps_tree_iterator_next_impl _bps_tree(iterator_next)
 #define bps_tree_iterator_next _api_name(iterator_next)
@@ -1153,6 +1154,23 @@ static inline bps_tree_elem_t *
 bps_tree_iterator_get_elem(const struct bps_tree *tree,
 		           struct bps_tree_iterator *itr);
 
+/**
+ * @brief Get a pointer to the element pointed by iterator along with
+ *  the number of elements stored after it in the same leaf block.
+ *  The elements can be accessed as an array, which is faster than
+ *  calling bps_tree_iterator_next() for each of them.
+ *  If iterator is detected as broken, it is invalidated and NULL returned.
+ * @param tree - pointer to a tree
+ * @param itr - pointer to tree iterator
+ * @param[out] count - number of elements in the leaf block starting
+ *  from the one pointed by iterator
+ * @return - Pointer to the element. Null for invalid iterator
+ */
+static inline bps_tree_elem_t *
+bps_tree_iterator_get_leaf_elems(const struct bps_tree *tree,
+				 struct bps_tree_iterator *itr,
+				 bps_tree_pos_t *count);
+
 /**
  * @brief Get a pointer to the element pointed by iterator.
  *  If iterator is detected as broken, it is invalidated and NULL returned.
@@ -2904,6 +2922,18 @@ bps_tree_view_iterator_get_elem(const struct bps_tree_view *view,
 	return bps_tree_iterator_get_elem_impl(&view->common, itr);
 }
 
+static inline bps_tree_elem_t *
+bps_tree_iterator_get_leaf_elems(const struct bps_tree *tree,
+				 struct bps_tree_iterator *itr,
+				 bps_tree_pos_t *count)
+{
+	struct bps_leaf *leaf = bps_tree_get_leaf_safe(&tree->common, itr);
+	if (!leaf)
+		return 0;
+	*count = leaf->header.size - itr->pos;
+	return leaf->elems + itr->pos;
+}
+
 /**
  * @brief Increments an iterator, makes it point to the next element
  *  If the iterator is to last element, it will be invalidated
@@ -7686,6 +7716,7 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_approximate_count
 #undef bps_tree_iterator_get_elem_impl
 #undef bps_tree_iterator_get_elem
+#undef bps_tree_iterator_get_leaf_elems
 #undef bps_tree_view_iterator_get_elem
 #undef bps_tree_iterator_next_impl
 #undef bps_tree_iterator_next
@@ -0,0 +1,202 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    t.tarantool.skip_if_enterprise()
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        rawset(_G, 'create_space', function(name)
+            local s = box.schema.space.create(name, {format = {
+                {'id', 'unsigned'},
+                {'i', 'integer', is_nullable = true},
+                {'d', 'double', is_nullable = true},
+                {'s', 'string', is_nullable = true},
+                {'b', 'boolean', is_nullable = true},
+                {'v', 'varbinary', is_nullable = true},
+                {'i8', 'int8', is_nullable = true},
+            }})
+            s:create_index('pk')
+            s:create_index('sk', {parts = {'s'}, unique = false})
+            return s
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        for _, name in ipairs({'src', 'dst', 'test'}) do
+            if box.space[name] ~= nil then
+                box.space[name]:drop()
+            end
+        end
+    end)
+end)
+
+g.test_round_trip = function(cg)
+    cg.server:exec(function()
+        local varbinary = require('varbinary')
+        local src = _G.create_space('src')
+        local dst = _G.create_space('dst')
+        box.begin()
+        for i = 1, 10000 do
+            if i % 10 == 0 then
+                src:insert({i})
+            else
+                src:insert({i, -i, i + 0.5, 'str' .. i, i % 2 == 0,
+                            varbinary.new('bin' .. i), i % 100 - 50})
+            end
+        end
+        box.commit()
+
+        local arrow = src:select_arrow()
+        t.assert_type(arrow, 'string')
+        dst:insert_arrow(arrow)
+        t.assert_equals(dst:len(), src:len())
+        t.assert_equals(dst:select({}, {limit = 20}),
+                        src:select({}, {limit = 20}))
+        t.assert_equals(dst:get(9999), src:get(9999))
+        t.assert_equals(dst:get(10000), src:get(10000))
+        t.assert_equals(dst.index.sk:select('str77'), {src:get(77)})
+
+        -- Select options are respected.
+        dst:truncate()
+        dst:insert_arrow(src:select_arrow({100}, {iterator = 'ge',
+                                                  limit = 10}))
+        t.assert_equals(dst:select(), src:select({100}, {iterator = 'ge',
+                                                         limit = 10}))
+        local pos
+        arrow, pos = src.index.sk:select_arrow('str5', {fetch_pos = true})
+        t.assert_type(pos, 'string')
+        dst:truncate()
+        dst:insert_arrow(arrow)
+        t.assert_equals(dst:select(), {src:get(5)})
+
+        -- Empty selection.
+        dst:truncate()
+        dst:insert_arrow(src:select_arrow({20000}))
+        t.assert_equals(dst:len(), 0)
+    end)
+end
+
+g.test_insert_is_atomic = function(cg)
+    cg.server:exec(function()
+        local src = _G.create_space('src')
+        local dst = _G.create_space('dst')
+        for i = 1, 100 do
+            src:insert({i, i})
+        end
+        local arrow = src:select_arrow()
+        dst:insert({50})
+        t.assert_error_msg_content_equals(
+            'Duplicate key exists in unique index "pk" in space "dst" ' ..
+            'with old tuple - [50] and new tuple - [50, 50]',
+            dst.insert_arrow, dst, arrow)
+        t.assert_equals(dst:select(), {{50}})
+
+        dst:delete({50})
+        box.begin()
+        dst:insert_arrow(arrow)
+        t.assert_equals(dst:len(), 100)
+        box.rollback()
+        t.assert_equals(dst:len(), 0)
+        t.assert_equals(dst.index.sk:len(), 0)
+    end)
+end
+
+g.test_columns_by_name = function(cg)
+    cg.server:exec(function()
+        local src = box.schema.space.create('src', {format = {
+            {'s', 'string'}, {'id', 'unsigned'},
+        }})
+        src:create_index('pk', {parts = {'id'}})
+        src:insert({'a', 1})
+        src:insert({'b', 2})
+        local dst = _G.create_space('dst')
+        dst:insert_arrow(src:select_arrow())
+        t.assert_equals(dst:select(), {{1, box.NULL, box.NULL, 'a'},
+                                       {2, box.NULL, box.NULL, 'b'}})
+
+        src:format({{'x', 'string'}, {'id', 'unsigned'}})
+        t.assert_error_msg_content_equals(
+            "Field 'x' was not found in space 'dst' format",
+            dst.insert_arrow, dst, src:select_arrow())
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            'Invalid Arrow IPC stream: truncated message',
+            s.insert_arrow, s, 'foo')
+        t.assert_error_msg_content_equals(
+            'Invalid Arrow IPC stream: schema message expected',
+            s.insert_arrow, s, string.rep('\0', 8))
+        t.assert_error_msg_content_equals(
+            'Arrow conversion does not support spaces without format',
+            s.select_arrow, s)
+        s:format({{'id', 'unsigned'}, {'m', 'map'}})
+        t.assert_error_msg_content_equals(
+            "Arrow conversion does not support field type 'map'",
+            s.select_arrow, s)
+    end)
+end
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local src = _G.create_space('src')
+        local dst = _G.create_space('dst')
+        for i = 1, 1000 do
+            src:insert({i, i, nil, 'str' .. i})
+        end
+        dst:insert_arrow(src:select_arrow())
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local src = box.space.src
+        local dst = box.space.dst
+        t.assert_equals(dst:len(), 1000)
+        t.assert_equals(dst:select({}, {limit = 10}),
+                        src:select({}, {limit = 10}))
+    end)
+end
+
+local g_mvcc = t.group('arrow_ipc_mvcc')
+
+g_mvcc.before_all(function(cg)
+    t.tarantool.skip_if_enterprise()
+    cg.server = server:new({box_cfg = {memtx_use_mvcc_engine = true}})
+    cg.server:start()
+end)
+
+g_mvcc.after_all(function(cg)
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
+end)
+
+g_mvcc.test_insert_unsupported = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {format = {
+            {'id', 'unsigned'},
+        }})
+        s:create_index('pk')
+        s:insert({1})
+        local arrow = s:select_arrow()
+        s:truncate()
+        t.assert_error_msg_content_equals(
+            'Memtx MVCC engine does not support Arrow insert',
+            s.insert_arrow, s, arrow)
+        t.assert_equals(s:len(), 0)
+    end)
+end
@@ -70,6 +70,8 @@ local reference_table = {
         ARROW = 0x36,
         BEGIN_KEY = 0x37,
         END_KEY = 0x38,
+        KEY_LIST = 0x39,
+        CURSOR_ID = 0x3a,
         SQL_TEXT = 0x40,
         SQL_BIND = 0x41,
         SQL_INFO = 0x42,
@@ -142,6 +144,10 @@ local reference_table = {
         ROLLBACK = 16,
         INSERT_ARROW = 17,
         DELETE_RANGE = 18,
+        SELECT_MULTI = 19,
+        CURSOR_OPEN = 20,
+        CURSOR_FETCH = 21,
+        CURSOR_CLOSE = 22,
         RAFT = 30,
         RAFT_PROMOTE = 31,
         RAFT_DEMOTE = 32,
@@ -177,7 +183,7 @@ local reference_table = {
     },
 
     -- `IPROTO_CURRENT_VERSION` constant
-    protocol_version = 10,
+    protocol_version = 12,
 
     -- `feature_id` enumeration
     protocol_features = {
@@ -194,6 +200,8 @@ local reference_table = {
         fetch_snapshot_cursor = is_enterprise and true or nil,
         is_sync = true,
         insert_arrow = true,
+        select_multi = true,
+        cursors = true,
     },
     feature = {
         streams = 0,
@@ -209,6 +217,8 @@ local reference_table = {
         fetch_snapshot_cursor = 10,
         is_sync = 11,
         insert_arrow = 12,
+        select_multi = 13,
+        cursors = 14,
     },
 }
 
@@ -0,0 +1,65 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.create_space('test')
+        s:create_index('pk')
+        local data = string.rep('x', 1000)
+        for i = 1, 1000 do
+            s:insert({i, data})
+        end
+        box.schema.user.grant('guest', 'read', 'space', 'test')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_big_select = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    local data = string.rep('x', 1000)
+    local tuples = conn.space.test:select({}, {fullscan = true})
+    t.assert_equals(#tuples, 1000)
+    for i = 1, 1000 do
+        t.assert_equals(tuples[i], {i, data})
+    end
+    tuples = conn.space.test:select({500}, {iterator = 'ge'})
+    t.assert_equals(#tuples, 501)
+    t.assert_equals(tuples[1], {500, data})
+    t.assert_equals(tuples[501], {1000, data})
+    -- Big results with a position are written by tx.
+    local pos
+    tuples, pos = conn.space.test:select({}, {fullscan = true,
+                                              limit = 900,
+                                              fetch_pos = true})
+    t.assert_equals(#tuples, 900)
+    tuples = conn.space.test:select({}, {fullscan = true, after = pos})
+    t.assert_equals(#tuples, 100)
+    t.assert_equals(tuples[1], {901, data})
+    conn:close()
+end
+
+g.test_close_connection = function(cg)
+    for _ = 1, 10 do
+        local conn = net.connect(cg.server.net_box_uri)
+        for _ = 1, 10 do
+            conn.space.test:select({}, {fullscan = true, is_async = true})
+        end
+        conn:close()
+    end
+    local conn = net.connect(cg.server.net_box_uri)
+    t.assert_equals(#conn.space.test:select({}, {fullscan = true}), 1000)
+    conn:close()
+    cg.server:exec(function()
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.stat.net().CONNECTIONS.current, 0)
+        end)
+    end)
+end
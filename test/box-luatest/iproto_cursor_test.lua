@@ -0,0 +1,205 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        for i = 1, 10 do
+            s:insert({i, i % 3})
+        end
+        box.schema.user.grant('guest', 'read', 'space', 'test')
+        local v = box.schema.space.create('test_vinyl', {engine = 'vinyl'})
+        v:create_index('pk')
+        box.schema.user.grant('guest', 'read', 'space', 'test_vinyl')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.conn = net.connect(cg.server.net_box_uri)
+end)
+
+g.after_each(function(cg)
+    cg.conn:close()
+end)
+
+g.test_fetch = function(cg)
+    local space = cg.conn.space.test
+    t.assert(cg.conn.peer_protocol_features.cursors)
+    local cursor = space:cursor()
+    t.assert_not_equals(cursor.id, nil)
+    t.assert_equals(cursor:fetch(3), {{1, 1}, {2, 2}, {3, 0}})
+    t.assert(box.tuple.is(cursor:fetch(1)[1]))
+    t.assert_equals(cursor:fetch(0), {})
+    t.assert_equals(cursor:fetch(5), {{5, 2}, {6, 0}, {7, 1}, {8, 2}, {9, 0}})
+    t.assert_not_equals(cursor.id, nil)
+    -- The cursor is closed once it's exhausted.
+    t.assert_equals(cursor:fetch(5), {{10, 1}})
+    t.assert_equals(cursor.id, nil)
+    t.assert_equals(cursor:fetch(5), {})
+    cursor:close()
+
+    cursor = space.index.sk:cursor({1}, {offset = 1})
+    t.assert_equals(cursor:fetch(10), {{4, 1}, {7, 1}, {10, 1}})
+    t.assert_equals(cursor.id, nil)
+
+    cursor = space:cursor({8}, {iterator = 'LT'})
+    t.assert_equals(cursor:fetch(2), {{7, 1}, {6, 0}})
+    cursor:close()
+    t.assert_equals(cursor.id, nil)
+    t.assert_equals(cursor:fetch(2), {})
+end
+
+g.test_read_view = function(cg)
+    local cursor = cg.conn.space.test:cursor()
+    t.assert_equals(cursor:fetch(2), {{1, 1}, {2, 2}})
+    cg.server:exec(function()
+        box.space.test:delete(3)
+        box.space.test:replace({4, 100})
+        box.space.test:insert({11, 2})
+    end)
+    -- Changes made after the cursor was open aren't visible.
+    local tuples = cursor:fetch(100)
+    t.assert_equals(#tuples, 8)
+    t.assert_equals(tuples[1], {3, 0})
+    t.assert_equals(tuples[2], {4, 1})
+    t.assert_equals(tuples[8], {10, 1})
+    cg.server:exec(function()
+        box.space.test:delete(11)
+        box.space.test:replace({4, 1})
+        box.space.test:insert({3, 0})
+    end)
+end
+
+g.test_errors = function(cg)
+    local space = cg.conn.space.test
+    t.assert_error_msg_equals(
+        "Use cursor:fetch(...) instead of cursor.fetch(...)",
+        space:cursor().fetch, 10)
+    t.assert_error_msg_equals(
+        "Usage: cursor:fetch(count, opts)",
+        space:cursor().fetch, space:cursor())
+    t.assert_error_msg_equals(
+        "cursor() does not support pagination",
+        space.cursor, space, nil, {fetch_pos = true})
+    t.assert_error_msg_contains(
+        "index:cursor() doesn't support `buffer` and `is_async` arguments",
+        space.cursor, space, nil, {is_async = true})
+    t.assert_error_msg_equals(
+        "Cursor does not support TREE index of vinyl space",
+        cg.conn.space.test_vinyl.cursor, cg.conn.space.test_vinyl)
+    t.assert_error_msg_equals(
+        "Unknown iterator type 'FOO'",
+        space.cursor, space, nil, {iterator = 'FOO'})
+
+    -- Closing the cursor on the server makes it unusable.
+    local cursor = space:cursor()
+    local id = cursor.id
+    cursor:close()
+    cursor.id = id
+    t.assert_error_msg_equals("Cursor does not exist",
+                              cursor.fetch, cursor, 1)
+end
+
+g.test_cursor_limit = function(cg)
+    local cursors = {}
+    for i = 1, 64 do
+        cursors[i] = cg.conn.space.test:cursor()
+    end
+    t.assert_error_msg_equals("Too many open cursors",
+                              cg.conn.space.test.cursor, cg.conn.space.test)
+    cursors[1]:close()
+    cursors[1] = cg.conn.space.test:cursor()
+    t.assert_equals(cursors[1]:fetch(1), {{1, 1}})
+
+    -- Cursors are closed with the connection.
+    cg.conn:close()
+    cg.server:exec(function()
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.stat.net().CONNECTIONS.current, 0)
+        end)
+    end)
+    cg.conn = net.connect(cg.server.net_box_uri)
+    cg.conn.space.test:cursor():close()
+end
+
+g.test_big_result = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('big')
+        s:create_index('pk')
+        local data = string.rep('x', 1000)
+        for i = 1, 2000 do
+            s:insert({i, data})
+        end
+        box.schema.user.grant('guest', 'read', 'space', 'big')
+    end)
+    cg.conn:reload_schema()
+    local cursor = cg.conn.space.big:cursor()
+    -- The response size is limited whatever count is asked for.
+    local tuples = cursor:fetch(2000)
+    t.assert_lt(#tuples, 2000)
+    local count = #tuples
+    while cursor.id ~= nil do
+        count = count + #cursor:fetch(2000)
+    end
+    t.assert_equals(count, 2000)
+    cg.server:exec(function()
+        box.space.big:drop()
+    end)
+end
+
+g.test_data_temporary = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('temp', {type = 'data-temporary'})
+        s:create_index('pk')
+        s:insert({1})
+        s:insert({2})
+        box.schema.user.grant('guest', 'read', 'space', 'temp')
+    end)
+    cg.conn:reload_schema()
+    local cursor = cg.conn.space.temp:cursor()
+    t.assert_equals(cursor:fetch(10), {{1}, {2}})
+    cg.server:exec(function()
+        box.space.temp:drop()
+    end)
+end
+
+g.test_idle_timeout = function(cg)
+    cg.server:exec(function()
+        box.internal.tweaks.iproto_cursor_idle_timeout = 0.1
+    end)
+    local cursor = cg.conn.space.test:cursor()
+    t.assert_equals(cursor:fetch(1), {{1, 1}})
+    -- An idle cursor is closed by the server.
+    t.helpers.retrying({}, function()
+        t.assert_error_msg_equals("Cursor does not exist",
+                                  cursor.fetch, cursor, 1)
+    end)
+    cg.server:exec(function()
+        box.internal.tweaks.iproto_cursor_idle_timeout = 300
+    end)
+end
+
+g.test_gc = function(cg)
+    local space = cg.conn.space.test
+    -- The cursor object isn't referenced once the function returns.
+    local id = (function() return space:cursor().id end)()
+    collectgarbage()
+    collectgarbage()
+    -- The cursor is closed on the server with the next request.
+    local cursor = space:cursor()
+    cursor:close()
+    cursor.id = id
+    t.assert_error_msg_equals("Cursor does not exist",
+                              cursor.fetch, cursor, 1)
+end
@@ -0,0 +1,58 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        rawset(_G, 'func', function() return true end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        box.stat.reset()
+    end)
+end)
+
+g.test_latency = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    for i = 1, 10 do
+        conn.space.test:insert({i})
+        conn.space.test:select({i})
+        conn:call('func')
+    end
+    conn:close()
+    cg.server:exec(function()
+        local function check(stat, count)
+            t.assert_ge(stat.count, count)
+            for _, stage in ipairs({'NET_QUEUE', 'TX_QUEUE', 'EXEC',
+                                    'TOTAL'}) do
+                local prev = 0
+                for _, pct in ipairs({'p50', 'p75', 'p90', 'p95', 'p99'}) do
+                    t.assert_ge(stat[stage][pct], prev)
+                    prev = stat[stage][pct]
+                end
+            end
+        end
+        local latency = box.stat.net().LATENCY
+        t.assert_equals(box.stat.net.LATENCY, latency)
+        check(latency.INSERT, 10)
+        check(latency.SELECT, 10)
+        check(latency.CALL, 10)
+        t.assert_equals(latency.UPSERT, nil)
+        t.assert_equals(box.stat.net.thread[1].LATENCY, latency)
+        t.assert_equals(box.stat.net.thread()[1].LATENCY, latency)
+        box.stat.reset()
+        t.assert_equals(box.stat.net().LATENCY, {})
+    end)
+end
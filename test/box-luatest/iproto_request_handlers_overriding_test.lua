@@ -30,6 +30,10 @@ local basic_rq_types = {
     AUTH = box.iproto.type.AUTH,
     INSERT_ARROW = box.iproto.type.INSERT_ARROW,
     DELETE_RANGE = box.iproto.type.DELETE_RANGE,
+    SELECT_MULTI = box.iproto.type.SELECT_MULTI,
+    CURSOR_OPEN = box.iproto.type.CURSOR_OPEN,
+    CURSOR_FETCH = box.iproto.type.CURSOR_FETCH,
+    CURSOR_CLOSE = box.iproto.type.CURSOR_CLOSE,
 }
 
 -- Grep server logs for error messages about unsupported request types.
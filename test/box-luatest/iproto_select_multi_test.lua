@@ -0,0 +1,93 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        for i = 1, 10 do
+            s:insert({i, i % 3})
+        end
+        box.schema.user.grant('guest', 'read', 'space', 'test')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.conn = net.connect(cg.server.net_box_uri)
+end)
+
+g.after_each(function(cg)
+    cg.conn:close()
+end)
+
+g.test_select_multi = function(cg)
+    local space = cg.conn.space.test
+    t.assert(cg.conn.peer_protocol_features.select_multi)
+    t.assert_equals(space:select_multi({}), {})
+    t.assert_equals(space:select_multi({1, {3}, 100}),
+                    {{{1, 1}}, {{3, 0}}, {}})
+    t.assert_equals(space.index.sk:select_multi({0, 2}, {limit = 2}),
+                    {{{3, 0}, {6, 0}}, {{2, 2}, {5, 2}}})
+    t.assert_equals(space.index.sk:select_multi({1}, {offset = 1}),
+                    {{{4, 1}, {7, 1}, {10, 1}}})
+    t.assert_equals(space:select_multi({8, 2}, {iterator = 'GE', limit = 2}),
+                    {{{8, 2}, {9, 0}}, {{2, 2}, {3, 0}}})
+
+    -- The result is the same as with local select_multi.
+    local local_result = cg.server:exec(function()
+        return box.space.test.index.sk:select_multi({0, 2}, {limit = 2})
+    end)
+    t.assert_equals(local_result, {{{3, 0}, {6, 0}}, {{2, 2}, {5, 2}}})
+
+    -- Tuples have the space format.
+    local res = space:select_multi({1})
+    t.assert(box.tuple.is(res[1][1]))
+
+    local future = space:select_multi({1, 2}, {is_async = true})
+    t.assert_equals(future:wait_result(), {{{1, 1}}, {{2, 2}}})
+
+    -- All keys are selected in one request.
+    local stat = cg.server:exec(function()
+        return {box.stat().SELECT_MULTI.total, box.stat().SELECT.total}
+    end)
+    space:select_multi({1, 2, 3, 4, 5})
+    t.assert_equals(cg.server:exec(function()
+        return {box.stat().SELECT_MULTI.total, box.stat().SELECT.total}
+    end), {stat[1] + 1, stat[2] + 5})
+end
+
+g.test_errors = function(cg)
+    local space = cg.conn.space.test
+    t.assert_error_msg_equals("Usage: index:select_multi(keys, opts)",
+                              space.select_multi, space, 1)
+    t.assert_error_msg_equals("select_multi() does not support pagination",
+                              space.select_multi, space, {1},
+                              {fetch_pos = true})
+    t.assert_error_msg_contains("Supplied key type of part 0 does not match " ..
+                                "index part type: expected unsigned",
+                                space.select_multi, space, {1, 'a'})
+
+    -- Keys must be arrays.
+    local msgpack = require('msgpack')
+    local header = msgpack.encode({
+        [box.iproto.key.REQUEST_TYPE] = box.iproto.type.SELECT_MULTI,
+        [box.iproto.key.SYNC] = cg.conn:_next_sync(),
+    })
+    local body = msgpack.encode({
+        [box.iproto.key.SPACE_ID] = cg.conn.space.test.id,
+        [box.iproto.key.KEY_LIST] = {{1}, 2},
+    })
+    local request = msgpack.encode(#header + #body) .. header .. body
+    t.assert_error_msg_equals("Invalid MsgPack - SELECT_MULTI key",
+                              cg.conn._inject, cg.conn, request)
+end
@@ -0,0 +1,127 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg{iproto_stale_read_max_lag = 0}
+        for _, name in ipairs({'test', 'plain'}) do
+            if box.space[name] ~= nil then
+                box.space[name]:drop()
+            end
+        end
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.iproto_stale_read_max_lag, 0)
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'iproto_stale_read_max_lag': " ..
+            "the value must be greater than or equal to zero",
+            box.cfg, {iproto_stale_read_max_lag = -1})
+        box.cfg{iproto_stale_read_max_lag = 0.5}
+        t.assert_equals(box.cfg.iproto_stale_read_max_lag, 0.5)
+        t.assert_error_msg_equals(
+            "options parameter 'stale_read' should be of type boolean",
+            box.schema.space.create, 'test', {stale_read = 1})
+    end)
+end
+
+g.test_stale_read = function(cg)
+    cg.server:exec(function()
+        local net = require('net.box')
+
+        local s = box.schema.space.create('test', {stale_read = true})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'string'}, unique = false})
+        s:insert({1, 'a'})
+        local plain = box.schema.space.create('plain')
+        plain:create_index('pk')
+        plain:insert({1, 'a'})
+        box.schema.user.grant('guest', 'read', 'space', 'test')
+        box.schema.user.grant('guest', 'read', 'space', 'plain')
+        box.cfg{iproto_stale_read_max_lag = 1000}
+
+        local conn = net.connect(box.cfg.listen)
+        local function select_count()
+            return box.stat().SELECT.total
+        end
+
+        -- Requests for the space are served without tx.
+        t.helpers.retrying({}, function()
+            local count = select_count()
+            t.assert_equals(conn.space.test:select(), {{1, 'a'}})
+            t.assert_equals(select_count(), count)
+        end)
+        local count = select_count()
+        t.assert_equals(conn.space.test.index.sk:select({'a'}), {{1, 'a'}})
+        t.assert_equals(conn.space.test:select({}, {iterator = 'GT',
+                                                    limit = 0}), {})
+        t.assert_equals(conn.space.test:get({1}), {1, 'a'})
+        t.assert_equals(conn.space.plain:select(), {{1, 'a'}})
+        t.assert_equals(select_count(), count + 1)
+
+        -- Changes are visible after the read view is refreshed.
+        s:insert({2, 'b'})
+        t.assert_equals(conn.space.test:select(), {{1, 'a'}})
+        box.cfg{iproto_stale_read_max_lag = 2000}
+        t.helpers.retrying({}, function()
+            t.assert_equals(conn.space.test:select(), {{1, 'a'}, {2, 'b'}})
+        end)
+
+        -- Access is checked.
+        box.schema.user.revoke('guest', 'read', 'space', 'test')
+        box.cfg{iproto_stale_read_max_lag = 1000}
+        t.helpers.retrying({}, function()
+            t.assert_error_msg_contains(
+                "Read access to space 'test' is denied for user 'guest'",
+                conn.space.test.select, conn.space.test)
+        end)
+        box.schema.user.grant('guest', 'read', 'space', 'test')
+
+        -- Stale reads are disabled.
+        box.cfg{iproto_stale_read_max_lag = 0}
+        t.helpers.retrying({}, function()
+            count = select_count()
+            t.assert_equals(conn.space.test:select(), {{1, 'a'}, {2, 'b'}})
+            t.assert_equals(select_count(), count + 1)
+        end)
+        conn:close()
+    end)
+end
+
+g.test_blocked_tx = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {stale_read = true})
+        s:create_index('pk')
+        s:insert({1})
+        box.schema.user.grant('guest', 'read', 'space', 'test')
+        box.cfg{iproto_stale_read_max_lag = 1000}
+    end)
+    local net = require('net.box')
+    local conn = net.connect(cg.server.net_box_uri)
+    t.helpers.retrying({}, function()
+        t.assert_equals(conn.space.test:select(), {{1}})
+    end)
+    -- Block tx and check that the space is still readable.
+    cg.server:exec(function()
+        local clock = require('clock')
+        require('fiber').new(function()
+            local deadline = clock.monotonic() + 1
+            while clock.monotonic() < deadline do end
+        end)
+    end)
+    t.assert_equals(conn.space.test:select({}, {timeout = 0.5}), {{1}})
+    conn:close()
+end
@@ -0,0 +1,87 @@
+local net = require('net.box')
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({box_cfg = {iproto_threads = 2}})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.error.injection.set('ERRINJ_IPROTO_LOAD', -1)
+        box.stat.reset()
+    end)
+end)
+
+g.test_cpu_time = function(cg)
+    local conn = net.connect(cg.server.net_box_uri)
+    t.helpers.retrying({}, function()
+        for _ = 1, 100 do
+            conn:ping()
+        end
+        cg.server:exec(function()
+            local stat = box.stat.net().CPU_TIME
+            t.assert_gt(stat.total, 0)
+            t.assert_ge(stat.rps, 0)
+            for i = 1, box.cfg.iproto_threads do
+                local thread_stat = box.stat.net.thread[i].CPU_TIME
+                t.assert_ge(thread_stat.total, 0)
+                t.assert_ge(thread_stat.rps, 0)
+            end
+        end)
+    end)
+    conn:close()
+end
+
+-- Checks that an overloaded thread leaves new connections to other threads.
+g.test_balance_accept = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        box.error.injection.set('ERRINJ_IPROTO_LOAD', 0)
+        t.helpers.retrying({}, function()
+            t.assert_ge(box.stat.net.thread[1].CPU_TIME.rps, 100 * 1000)
+        end)
+    end)
+    local function connections()
+        return cg.server:exec(function()
+            return {
+                box.stat.net.thread[1].CONNECTIONS.current,
+                box.stat.net.thread[2].CONNECTIONS.current,
+            }
+        end)
+    end
+    -- Returns the number of connections accepted by each thread for
+    -- a new connection. Waits for the connection to be closed.
+    local function probe()
+        local before = connections()
+        local conn = net.connect(cg.server.net_box_uri)
+        local after = connections()
+        conn:close()
+        t.helpers.retrying({}, function()
+            t.assert_equals(connections(), before)
+        end)
+        return {after[1] - before[1], after[2] - before[2]}
+    end
+    -- The thread stops accepting on the next timer tick.
+    t.helpers.retrying({}, function()
+        t.assert_equals(probe(), {0, 1})
+    end)
+    local COUNT = 10
+    local before = connections()
+    local conns = {}
+    for i = 1, COUNT do
+        conns[i] = net.connect(cg.server.net_box_uri)
+        t.assert_equals(conns[i].state, 'active')
+    end
+    t.assert_equals(connections(), {before[1], before[2] + COUNT})
+    for i = 1, COUNT do
+        conns[i]:close()
+    end
+end
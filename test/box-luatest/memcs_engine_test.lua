@@ -0,0 +1,288 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    t.tarantool.skip_if_enterprise()
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        rawset(_G, 'create_space', function(name)
+            local s = box.schema.space.create(name, {
+                engine = 'memcs',
+                format = {
+                    {'id', 'unsigned'},
+                    {'i', 'integer', is_nullable = true},
+                    {'d', 'double', is_nullable = true},
+                    {'s', 'string', is_nullable = true},
+                    {'b', 'boolean', is_nullable = true},
+                    {'v', 'varbinary', is_nullable = true},
+                    {'i8', 'int8', is_nullable = true},
+                },
+            })
+            s:create_index('pk')
+            return s
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        for _, name in ipairs({'src', 'dst', 'test'}) do
+            if box.space[name] ~= nil then
+                box.space[name]:drop()
+            end
+        end
+    end)
+end)
+
+g.test_crud = function(cg)
+    cg.server:exec(function()
+        local varbinary = require('varbinary')
+        local s = _G.create_space('test')
+        t.assert_equals(s:insert({1, -1, 1.5, 'a', true,
+                                  varbinary.new('x'), -8}),
+                        {1, -1, 1.5, 'a', true, varbinary.new('x'), -8})
+        t.assert_equals(s:insert({2, box.NULL, box.NULL, 'b'}),
+                        {2, box.NULL, box.NULL, 'b'})
+        t.assert_error_msg_content_equals(
+            'Duplicate key exists in unique index "pk" in space "test" ' ..
+            'with old tuple - [2, null, null, "b"] and new tuple - [2]',
+            s.insert, s, {2})
+        t.assert_equals(s:replace({2, 20}), {2, 20})
+        t.assert_equals(s:get(2), {2, 20})
+        t.assert_equals(s:update(1, {{'=', 'i', 10}, {'=', 's', 'c'}}),
+                        {1, 10, 1.5, 'c', true, varbinary.new('x'), -8})
+        t.assert_error_msg_content_equals(
+            "Attempt to modify a tuple field which is part of primary " ..
+            "index in space 'test'",
+            s.update, s, 1, {{'=', 'id', 5}})
+        s:upsert({3, 30}, {{'+', 'i', 1}})
+        s:upsert({3, 30}, {{'+', 'i', 1}})
+        t.assert_equals(s:get(3), {3, 31})
+        t.assert_equals(s:delete(2), {2, 20})
+        t.assert_equals(s:delete(2), nil)
+        t.assert_equals(s:len(), 2)
+        t.assert_equals(s:count(), 2)
+        t.assert_equals(s:select(), {
+            {1, 10, 1.5, 'c', true, varbinary.new('x'), -8}, {3, 31},
+        })
+        t.assert_error_msg_content_equals(
+            "Tuple field 2 (i) type does not match one required by " ..
+            "operation: expected integer, got string",
+            s.insert, s, {4, 'x'})
+    end)
+end
+
+g.test_select = function(cg)
+    cg.server:exec(function()
+        local s = _G.create_space('test')
+        for i = 1, 3000 do
+            s:insert({i, i % 7, box.NULL, 'str' .. i % 13})
+        end
+        t.assert_equals(s:select({10}, {iterator = 'ge', limit = 2}), {
+            {10, 3, box.NULL, 'str10'}, {11, 4, box.NULL, 'str11'},
+        })
+        t.assert_equals(s:select({10}, {iterator = 'lt', limit = 2}), {
+            {9, 2, box.NULL, 'str9'}, {8, 1, box.NULL, 'str8'},
+        })
+        t.assert_equals(s:select({2999}, {iterator = 'gt'}),
+                        {{3000, 4, box.NULL, 'str10'}})
+        t.assert_equals(s:select({3000}, {iterator = 'req'}),
+                        {{3000, 4, box.NULL, 'str10'}})
+        t.assert_equals(#s:select({}, {iterator = 'le'}), 3000)
+
+        -- Pagination.
+        local page, pos = s:select({}, {limit = 2, fetch_pos = true})
+        t.assert_equals(page, {
+            {1, 1, box.NULL, 'str1'}, {2, 2, box.NULL, 'str2'},
+        })
+        page = s:select({}, {limit = 2, after = pos})
+        t.assert_equals(page, {
+            {3, 3, box.NULL, 'str3'}, {4, 4, box.NULL, 'str4'},
+        })
+
+        -- The iterator survives concurrent modifications.
+        local n = 0
+        for _, tuple in s:pairs() do
+            n = n + 1
+            s:delete(tuple.id + 1)
+        end
+        t.assert_equals(n, 1500)
+        t.assert_equals(s:len(), 1500)
+    end)
+end
+
+g.test_arrow = function(cg)
+    cg.server:exec(function()
+        local varbinary = require('varbinary')
+        local src = _G.create_space('src')
+        local dst = _G.create_space('dst')
+        for i = 1, 5000 do
+            if i % 10 == 0 then
+                src:insert({i})
+            else
+                src:insert({i, -i, i + 0.5, 'str' .. i % 100, i % 2 == 0,
+                            varbinary.new('bin' .. i), i % 100 - 50})
+            end
+        end
+        dst:insert_arrow(src:select_arrow())
+        t.assert_equals(dst:len(), src:len())
+        t.assert_equals(dst:select({}, {limit = 20}),
+                        src:select({}, {limit = 20}))
+        t.assert_equals(dst:get(4999), src:get(4999))
+        t.assert_equals(dst:get(5000), src:get(5000))
+
+        -- The batch is inserted atomically.
+        dst:delete(100)
+        t.assert_error_msg_contains('Duplicate key exists',
+                                    dst.insert_arrow, dst,
+                                    src:select_arrow({100}, {iterator = 'ge'}))
+        t.assert_equals(dst:len(), 4999)
+        t.assert_equals(dst:get(100), nil)
+    end)
+end
+
+g.test_rollback = function(cg)
+    cg.server:exec(function()
+        local s = _G.create_space('test')
+        for i = 1, 10 do
+            s:insert({i, i})
+        end
+        box.begin()
+        s:replace({1, 100})
+        s:delete(2)
+        s:upsert({3}, {{'=', 'i', 300}})
+        for i = 11, 2000 do
+            s:insert({i})
+        end
+        box.rollback()
+        t.assert_equals(s:len(), 10)
+        for i = 1, 10 do
+            t.assert_equals(s:get(i), {i, i})
+        end
+
+        box.begin()
+        s:delete(5)
+        local svp = box.savepoint()
+        s:insert({5, 50})
+        box.rollback_to_savepoint(svp)
+        box.commit()
+        t.assert_equals(s:get(5), nil)
+        t.assert_equals(s:len(), 9)
+    end)
+end
+
+g.test_read_view = function(cg)
+    cg.server:exec(function()
+        local s = _G.create_space('test')
+        for i = 1, 2000 do
+            s:insert({i, i, box.NULL, 'a' .. i})
+        end
+        box.snapshot()
+        for i = 1, 2000, 2 do
+            s:update(i, {{'=', 's', 'b' .. i}})
+        end
+        t.assert_equals(s:get(1), {1, 1, box.NULL, 'b1'})
+        t.assert_equals(s:get(2), {2, 2, box.NULL, 'a2'})
+    end)
+end
+
+-- Strings that aren't stored in any row are freed.
+g.test_dict_gc = function(cg)
+    cg.server:exec(function()
+        local varbinary = require('varbinary')
+        local s = _G.create_space('test')
+        for i = 1, 100 do
+            s:replace({1, i, box.NULL, 'str' .. i, box.NULL,
+                       varbinary.new('bin' .. i)})
+        end
+        local bsize = s:bsize()
+        for i = 101, 10000 do
+            s:replace({1, i, box.NULL, 'str' .. i, box.NULL,
+                       varbinary.new('bin' .. i)})
+        end
+        t.assert_le(s:bsize(), bsize)
+        t.assert_equals(s:get(1), {1, 10000, box.NULL, 'str10000', box.NULL,
+                                   varbinary.new('bin10000')})
+        s:delete(1)
+        t.assert_le(s:bsize(), bsize)
+
+        -- A string shared by rows lives until the last of them is freed.
+        s:insert({1, 1, box.NULL, 'shared'})
+        s:insert({2, 2, box.NULL, 'shared'})
+        s:delete(1)
+        t.assert_equals(s:get(2), {2, 2, box.NULL, 'shared'})
+        box.begin()
+        s:delete(2)
+        box.rollback()
+        t.assert_equals(s:get(2), {2, 2, box.NULL, 'shared'})
+        s:replace({2, 2, box.NULL, 'other'})
+        s:insert({3, 3, box.NULL, 'shared'})
+        t.assert_equals(s:select(), {{2, 2, box.NULL, 'other'},
+                                     {3, 3, box.NULL, 'shared'}})
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'memcs'})
+        t.assert_error_msg_content_equals(
+            "Engine 'memcs' does not support spaces without format",
+            s.create_index, s, 'pk')
+        t.assert_error_msg_content_equals(
+            "Engine 'memcs' does not support field type 'map'",
+            s.format, s, {{'id', 'unsigned'}, {'m', 'map'}})
+        s:format({{'id', 'unsigned'}, {'s', 'string'}})
+        t.assert_error_msg_content_equals(
+            "Unsupported index type supplied for index 'pk' in space 'test'",
+            s.create_index, s, 'pk', {type = 'hash'})
+        s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            "Engine 'memcs' does not support secondary indexes",
+            s.create_index, s, 'sk', {parts = {'s'}})
+        t.assert_error_msg_content_equals(
+            "Engine 'memcs' does not support changing field count or " ..
+            "types of an indexed space",
+            s.format, s, {{'id', 'unsigned'}, {'s', 'string'},
+                          {'x', 'integer', is_nullable = true}})
+        t.assert_error_msg_content_equals(
+            "Engine 'memcs' does not support fields not described by " ..
+            "the space format",
+            s.insert, s, {1, 'a', 2})
+        -- Renaming fields doesn't change the storage layout.
+        s:format({{'key', 'unsigned'}, {'val', 'string'}})
+        s:insert({1, 'a'})
+        t.assert_equals(s:get(1).val, 'a')
+    end)
+end
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = _G.create_space('test')
+        for i = 1, 1000 do
+            s:insert({i, i, box.NULL, 'str' .. i})
+        end
+        box.snapshot()
+        for i = 1001, 1100 do
+            s:insert({i, i})
+        end
+        s:delete(1)
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s.engine, 'memcs')
+        t.assert_equals(s:len(), 1099)
+        t.assert_equals(s:get(1), nil)
+        t.assert_equals(s:get(2), {2, 2, box.NULL, 'str2'})
+        t.assert_equals(s:get(1100), {1100, 1100})
+    end)
+end
@@ -0,0 +1,95 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_int_key = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test')
+        s:create_index('pk', {type = 'hash', parts = {1, 'integer'}})
+        local keys = {
+            0, 1, -1, 100, -100, 2^31, -2^31, 2^53,
+            9223372036854775807LL, -9223372036854775807LL - 1,
+            18446744073709551615ULL,
+        }
+        for _, k in ipairs(keys) do
+            s:insert({k, tostring(k)})
+        end
+        t.assert_equals(s:len(), #keys)
+        for _, k in ipairs(keys) do
+            t.assert_equals(s:get(k), {k, tostring(k)})
+            t.assert_equals(s:select(k), {{k, tostring(k)}})
+        end
+        t.assert_equals(s:get(2), nil)
+        t.assert_equals(s:get(-2), nil)
+        t.assert_equals(s:get(18446744073709551614ULL), nil)
+        t.assert_equals(s:delete(-1), {-1, '-1'})
+        t.assert_equals(s:get(-1), nil)
+        s:replace({1, 'x'})
+        t.assert_equals(s:get(1), {1, 'x'})
+        t.assert_equals(s:len(), #keys - 1)
+    end)
+end
+
+g.test_read_view = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test')
+        s:create_index('pk', {type = 'hash', parts = {1, 'unsigned'}})
+        for i = 1, 1000 do
+            s:insert({i * 7919})
+        end
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:len(), 1000)
+        for i = 1, 1000 do
+            t.assert_equals(s:get(i * 7919), {i * 7919})
+        end
+        t.assert_equals(s:get(1), nil)
+    end)
+end
+
+g.test_alter = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.create_space('test')
+        s:create_index('pk', {type = 'hash', parts = {1, 'unsigned'}})
+        for i = 1, 10 do
+            s:insert({i})
+        end
+        -- Integral doubles are looked up by integer keys and vice versa.
+        s.index.pk:alter({parts = {1, 'number'}})
+        s:insert({1.5})
+        t.assert_equals(s:get(1.5), {1.5})
+        t.assert_equals(s:get(3), {3})
+        t.assert_equals(s:get(3.0), {3})
+        t.assert_error_msg_content_equals(
+            'Duplicate key exists in unique index "pk" in space "test" ' ..
+            'with old tuple - [5] and new tuple - [5]',
+            s.insert, s, {5.0})
+        s:delete(1.5)
+        s.index.pk:alter({parts = {1, 'unsigned'}})
+        for i = 1, 10 do
+            t.assert_equals(s:get(i), {i})
+        end
+        t.assert_equals(s:len(), 10)
+    end)
+end
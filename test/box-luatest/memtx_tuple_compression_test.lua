@@ -0,0 +1,164 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+local function define_helpers(server)
+    server:exec(function()
+        -- Generates a JSON-like document that compresses well with
+        -- a dictionary, but not so well on its own.
+        rawset(_G, 'make_tuple', function(i)
+            return {i, i % 100, string.format(
+                '{"id": %d, "name": "user%d", "email": "user%d@example.com", ' ..
+                '"status": "active", "roles": ["reader", "writer"], ' ..
+                '"settings": {"theme": "dark", "language": "en_US"}}',
+                i, i, i), i * 2}
+        end)
+        -- Inserts tuples until the dictionary is trained and returns
+        -- the number of inserted tuples.
+        rawset(_G, 'fill', function(s)
+            local i = 0
+            local function insert_batch()
+                box.begin()
+                for _ = 1, 1000 do
+                    i = i + 1
+                    s:insert(_G.make_tuple(i))
+                end
+                box.commit()
+            end
+            t.helpers.retrying({timeout = 60}, function()
+                insert_batch()
+                local bsize = s:bsize()
+                insert_batch()
+                local size = box.tuple.new(_G.make_tuple(i)):bsize()
+                t.assert_lt((s:bsize() - bsize) / 1000, size / 2)
+            end)
+            return i
+        end)
+    end)
+end
+
+g.before_all(function(cg)
+    t.tarantool.skip_if_enterprise()
+    cg.server = server:new()
+    cg.server:start()
+    define_helpers(cg.server)
+end)
+
+g.after_all(function(cg)
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_invalid_option = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_contains(
+            "compression", box.schema.space.create, 'test',
+            {compression = 'lz4'})
+        t.assert_error_msg_content_equals(
+            "Vinyl does not support tuple compression",
+            box.schema.space.create, 'test',
+            {engine = 'vinyl', compression = 'zstd'})
+    end)
+end
+
+g.test_compression = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {compression = 'zstd'})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        local count = _G.fill(s)
+
+        t.assert_equals(s:len(), count)
+        for i = 1, count, 97 do
+            t.assert_equals(s:get(i), _G.make_tuple(i))
+        end
+        t.assert_equals(s.index.sk:select(7, {limit = 3}),
+                        {_G.make_tuple(7), _G.make_tuple(107),
+                         _G.make_tuple(207)})
+        t.assert_equals(s:select({count}, {iterator = 'le', limit = 1}),
+                        {_G.make_tuple(count)})
+
+        t.assert_equals(s:update(count, {{'+', 4, 1}}),
+                        {count, count % 100, _G.make_tuple(count)[3],
+                         count * 2 + 1})
+        t.assert_equals(s:delete(count - 1), _G.make_tuple(count - 1))
+        t.assert_equals(s:replace(_G.make_tuple(count - 2)),
+                        _G.make_tuple(count - 2))
+        s:upsert(_G.make_tuple(count - 3), {{'=', 2, 0}})
+        t.assert_equals(s:get(count - 3)[2], 0)
+    end)
+end
+
+g.test_index = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {compression = 'zstd'})
+        s:create_index('pk')
+        -- Indexes may be built on compressed tuples unless they need
+        -- compressed fields.
+        local count = _G.fill(s)
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        t.assert_equals(s.index.sk:count(0), count / 100)
+        t.assert_error_msg_content_equals(
+            "Tuple compression does not support " ..
+            "indexing fields of compressed tuples",
+            s.create_index, s, 'tk', {parts = {4, 'unsigned'}})
+        box.schema.func.create('f', {
+            body = 'function(t) return {t[4]} end',
+            is_deterministic = true, is_sandboxed = true,
+        })
+        t.assert_error_msg_content_equals(
+            "Functional index does not support tuple compression",
+            s.create_index, s, 'fk', {parts = {1, 'unsigned'}, func = 'f'})
+        box.schema.func.drop('f')
+    end)
+end
+
+g.test_alter = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {compression = 'zstd'})
+        s:create_index('pk')
+        local count = _G.fill(s)
+        -- Tuples stored before alter remain readable.
+        s:alter({compression = 'none'})
+        s:insert(_G.make_tuple(count + 1))
+        s:format({{'a', 'unsigned'}, {'b', 'unsigned'}})
+        for i = 1, count + 1, 101 do
+            t.assert_equals(s:get(i), _G.make_tuple(i))
+        end
+        t.assert_equals(s:get(count).b, count % 100)
+        s:alter({compression = 'zstd'})
+        for i = count + 2, count + 1000 do
+            s:insert(_G.make_tuple(i))
+        end
+        t.assert_equals(s:get(count + 1000), _G.make_tuple(count + 1000))
+    end)
+end
+
+g.test_snapshot = function(cg)
+    local count = cg.server:exec(function()
+        local s = box.schema.space.create('test', {compression = 'zstd'})
+        s:create_index('pk')
+        local count = _G.fill(s)
+        box.snapshot()
+        return count
+    end)
+    cg.server:restart()
+    define_helpers(cg.server)
+    cg.server:exec(function(count)
+        local s = box.space.test
+        t.assert_equals(s:len(), count)
+        for i = 1, count, 89 do
+            t.assert_equals(s:get(i), _G.make_tuple(i))
+        end
+    end, {count})
+end
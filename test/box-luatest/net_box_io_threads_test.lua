@@ -0,0 +1,104 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {net_box_io_threads = 2},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.schema.func.create('echo', {
+            body = 'function(...) return ... end',
+        })
+        box.schema.user.grant('guest', 'super')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_config = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.net_box_io_threads, 2)
+        t.assert_error_msg_equals(
+            "Can't set option 'net_box_io_threads' dynamically",
+            box.cfg, {net_box_io_threads = 1})
+    end)
+end
+
+-- Requests and responses of any size pass through I/O threads.
+g.test_requests = function(cg)
+    cg.server:exec(function(uri)
+        local fiber = require('fiber')
+        local net = require('net.box')
+        local conn = net.connect(uri)
+        t.assert_equals(conn.state, 'active')
+        local pad = string.rep('x', 1024 * 1024)
+        t.assert_equals(conn:call('echo', {1, pad}), {1, pad})
+        local fibers = {}
+        for i = 1, 10 do
+            local f = fiber.new(function()
+                for j = 1, 100 do
+                    local k = i * 1000 + j
+                    conn.space.test:replace({k, pad:sub(1, j)})
+                end
+            end)
+            f:set_joinable(true)
+            table.insert(fibers, f)
+        end
+        for _, f in ipairs(fibers) do
+            t.assert((f:join()))
+        end
+        t.assert_equals(conn.space.test:count(), 1000)
+        t.assert_equals(conn.space.test:get(5050), {5050, pad:sub(1, 50)})
+        t.assert_equals(#conn.space.test:select({}, {limit = 1000}), 1000)
+        local futures = {}
+        for i = 1, 100 do
+            futures[i] = conn:call('echo', {i}, {is_async = true})
+        end
+        for i = 1, 100 do
+            t.assert_equals(futures[i]:wait_result(), {i})
+        end
+        conn:close()
+        box.space.test:truncate()
+    end, {cg.server.net_box_uri})
+end
+
+-- Pending requests are sent before a connection is closed.
+g.test_close = function(cg)
+    cg.server:exec(function(uri)
+        local net = require('net.box')
+        local conn = net.connect(uri)
+        for i = 1, 100 do
+            conn.space.test:replace({i}, {is_async = true})
+        end
+        conn:close()
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.space.test:count(), 100)
+        end)
+        box.space.test:truncate()
+    end, {cg.server.net_box_uri})
+end
+
+-- A broken connection is released by the I/O thread and reconnects.
+g.test_reconnect = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function(uri)
+        local net = require('net.box')
+        local conn = net.connect(uri, {reconnect_after = 0.1})
+        t.assert_equals(conn:call('echo', {1}), {1})
+        box.error.injection.set('ERRINJ_NETBOX_IO_ERROR', true)
+        t.assert_error_msg_content_equals('Error injection',
+                                          conn.call, conn, 'echo', {2})
+        box.error.injection.set('ERRINJ_NETBOX_IO_ERROR', false)
+        t.helpers.retrying({}, function()
+            t.assert_equals(conn:call('echo', {3}), {3})
+        end)
+        conn:close()
+    end, {cg.server.net_box_uri})
+end
@@ -0,0 +1,105 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group(nil, t.helpers.matrix({
+    mvcc = {false, true},
+    index_type = {'TREE', 'HASH'},
+}))
+
+g.before_all(function(cg)
+    cg.server = server:new{
+        box_cfg = {memtx_use_mvcc_engine = cg.params.mvcc},
+    }
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(index_type)
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = index_type})
+        s:create_index('sk', {parts = {{2, 'unsigned'}}, unique = false})
+        box.begin()
+        for i = 1, 1000 do
+            s:insert({i, i % 10})
+        end
+        box.commit()
+    end, {cg.params.index_type})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+-- Checks that select fetching tuples in batches returns the same tuples
+-- as iteration with pairs, which fetches tuples one by one.
+g.test_select = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local function check(index, key, opts)
+            local expected = {}
+            local offset = opts.offset or 0
+            for _, tuple in index:pairs(key, opts) do
+                if offset > 0 then
+                    offset = offset - 1
+                elseif #expected == (opts.limit or math.huge) then
+                    break
+                else
+                    table.insert(expected, tuple)
+                end
+            end
+            t.assert_equals(index:select(key, opts), expected)
+        end
+        local index_type = s.index.pk.type
+        check(s.index.pk, nil, {})
+        check(s.index.pk, nil, {limit = 100})
+        check(s.index.pk, nil, {offset = 10, limit = 100})
+        check(s.index.pk, nil, {limit = 0})
+        if index_type == 'TREE' then
+            check(s.index.pk, 500, {iterator = 'GE'})
+            check(s.index.pk, 500, {iterator = 'GT', limit = 200})
+            check(s.index.pk, 500, {iterator = 'LE'})
+            check(s.index.pk, 500, {iterator = 'LT', offset = 100})
+            check(s.index.pk, 500, {iterator = 'EQ'})
+        else
+            check(s.index.pk, 500, {iterator = 'GT'})
+            check(s.index.pk, 500, {iterator = 'EQ'})
+        end
+        check(s.index.sk, nil, {})
+        check(s.index.sk, 5, {iterator = 'EQ'})
+        check(s.index.sk, 5, {iterator = 'GE', limit = 500})
+        check(s.index.sk, 5, {iterator = 'REQ', offset = 10})
+        t.assert_equals(#s:select(nil, {limit = 2000}), 1000)
+    end)
+end
+
+-- Checks that select skips tuples invisible to the transaction.
+g.test_select_in_txn = function(cg)
+    t.skip_if(not cg.params.mvcc, 'Requires MVCC')
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+        local f = fiber.new(function()
+            box.begin()
+            for i = 1, 1000, 3 do
+                s:delete(i)
+            end
+            s:insert({1001, 1})
+            fiber.sleep(0)
+            box.commit()
+        end)
+        f:set_joinable(true)
+        fiber.yield()
+        -- The changes aren't committed yet.
+        t.assert_equals(#s:select(), 1000)
+        t.assert_equals(#s.index.sk:select({1}), 100)
+        t.assert(f:join())
+        t.assert_equals(#s:select(), 667)
+        t.assert_equals(#s.index.sk:select({1}), 67)
+    end)
+end
@@ -0,0 +1,54 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.snap_compress_threads, 1)
+        local msg = "Incorrect value for option 'snap_compress_threads': " ..
+                    "must be greater than 0 and less than or equal to 256"
+        t.assert_error_msg_equals(msg, box.cfg, {snap_compress_threads = 0})
+        t.assert_error_msg_equals(msg, box.cfg, {snap_compress_threads = 257})
+        t.assert_equals(box.cfg.snap_compress_threads, 1)
+    end)
+end
+
+-- Checks that a snapshot compressed in parallel threads is recovered.
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        box.cfg{snap_compress_threads = 4}
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.begin()
+        for i = 1, 50000 do
+            s:insert({i, string.rep(tostring(i), i % 20)})
+        end
+        box.commit()
+        -- A small space is written in an uncompressed block between
+        -- the compressed ones.
+        box.schema.space.create('small'):create_index('pk')
+        box.space.small:insert({1, 'x'})
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.snap_compress_threads, 1)
+        local s = box.space.test
+        t.assert_equals(s:len(), 50000)
+        for _, tuple in s:pairs() do
+            local i = tuple[1]
+            t.assert_equals(tuple[2], string.rep(tostring(i), i % 20))
+        end
+        t.assert_equals(box.space.small:select(), {{1, 'x'}})
+    end)
+end
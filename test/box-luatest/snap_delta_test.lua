@@ -0,0 +1,206 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+local function define_helpers(cg)
+    cg.server:exec(function()
+        local fio = require('fio')
+        rawset(_G, 'file_count', function(ext)
+            local pattern = fio.pathjoin(box.cfg.memtx_dir, '*.' .. ext)
+            return #fio.glob(pattern)
+        end)
+    end)
+end
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {snap_delta_count = 2, checkpoint_count = 10},
+    })
+    cg.server:start()
+    define_helpers(cg)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg{snap_delta_count = 2, checkpoint_count = 10}
+        for _, name in ipairs({'test', 'seq'}) do
+            if box.space[name] ~= nil then
+                box.space[name]:drop()
+            end
+        end
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_equals(box.cfg.snap_delta_count, 2)
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'snap_delta_count': " ..
+            "the value must be greater than or equal to zero",
+            box.cfg, {snap_delta_count = -1})
+        box.cfg{snap_delta_count = 0}
+        t.assert_equals(box.cfg.snap_delta_count, 0)
+    end)
+end
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'integer'}})
+        for i = 1, 100 do
+            s:insert({i, i})
+        end
+        local seq = box.schema.space.create('seq')
+        seq:create_index('pk', {sequence = true})
+        seq:insert({box.NULL, 'a'})
+        -- The schema has changed so the snapshot is written in full.
+        local snap_count = _G.file_count('snap')
+        local delta_count = _G.file_count('delta')
+        box.snapshot()
+        t.assert_equals(_G.file_count('snap'), snap_count + 1)
+        t.assert_equals(_G.file_count('delta'), delta_count)
+
+        s:replace({1, 1000})
+        s:delete(2)
+        s:insert({101, 101})
+        -- Swap unique secondary keys.
+        s:update(3, {{'=', 2, -3}})
+        s:update(4, {{'=', 2, 3}})
+        s:update(3, {{'=', 2, 4}})
+        -- Auto increment doesn't update _sequence_data.
+        seq:insert({box.NULL, 'b'})
+        box.snapshot()
+        t.assert_equals(_G.file_count('snap'), snap_count + 1)
+        t.assert_equals(_G.file_count('delta'), delta_count + 1)
+
+        s:delete(1)
+        s:replace({2, 2})
+        box.snapshot()
+        t.assert_equals(_G.file_count('snap'), snap_count + 1)
+        t.assert_equals(_G.file_count('delta'), delta_count + 2)
+    end)
+    cg.server:restart()
+    define_helpers(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:len(), 100)
+        t.assert_equals(s:get(1), nil)
+        t.assert_equals(s:get(2), {2, 2})
+        t.assert_equals(s:get(3), {3, 4})
+        t.assert_equals(s:get(4), {4, 3})
+        t.assert_equals(s:get(101), {101, 101})
+        t.assert_equals(s.index.sk:get(3), {4, 3})
+        t.assert_equals(s.index.sk:get(1000), nil)
+        t.assert_equals(box.space.seq:insert({box.NULL, 'c'}), {3, 'c'})
+
+        -- Two deltas have been written since the last full snapshot.
+        local snap_count = _G.file_count('snap')
+        local delta_count = _G.file_count('delta')
+        s:replace({5, 500})
+        box.snapshot()
+        t.assert_equals(_G.file_count('snap'), snap_count + 1)
+        t.assert_equals(_G.file_count('delta'), delta_count)
+    end)
+end
+
+g.test_full_snapshot = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.snapshot()
+        local snap_count = _G.file_count('snap')
+        local delta_count = _G.file_count('delta')
+
+        s:replace({1})
+        box.snapshot()
+        t.assert_equals(_G.file_count('snap'), snap_count)
+        t.assert_equals(_G.file_count('delta'), delta_count + 1)
+
+        -- DDL.
+        s:create_index('sk', {parts = {1, 'unsigned'}})
+        box.snapshot()
+        t.assert_equals(_G.file_count('snap'), snap_count + 1)
+        t.assert_equals(_G.file_count('delta'), delta_count + 1)
+
+        -- Delta snapshots are disabled.
+        box.cfg{snap_delta_count = 0}
+        s:replace({2})
+        box.cfg{snap_delta_count = 2}
+        box.snapshot()
+        t.assert_equals(_G.file_count('snap'), snap_count + 2)
+        t.assert_equals(_G.file_count('delta'), delta_count + 1)
+    end)
+end
+
+g.test_gc = function(cg)
+    cg.server:exec(function()
+        box.cfg{checkpoint_count = 1}
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.snapshot()
+        t.helpers.retrying({}, function()
+            t.assert_equals(_G.file_count('snap'), 1)
+            t.assert_equals(_G.file_count('delta'), 0)
+        end)
+        -- The full snapshot the delta is based on is kept.
+        s:replace({1})
+        box.snapshot()
+        s:replace({2})
+        box.snapshot()
+        t.helpers.retrying({}, function()
+            t.assert_equals(_G.file_count('snap'), 1)
+            t.assert_equals(_G.file_count('delta'), 2)
+        end)
+        s:replace({3})
+        box.snapshot()
+        t.helpers.retrying({}, function()
+            t.assert_equals(_G.file_count('snap'), 1)
+            t.assert_equals(_G.file_count('delta'), 0)
+        end)
+    end)
+end
+
+g.after_test('test_wal_write_in_progress', function(cg)
+    cg.server:exec(function()
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+    end)
+end)
+
+-- Changes that have been applied to the indexes but haven't been written
+-- to WAL yet when a checkpoint starts must get into that checkpoint.
+g.test_wal_write_in_progress = function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert({1, 1})
+        s:insert({2, 2})
+        box.snapshot()
+        local delta_count = _G.file_count('delta')
+
+        s:replace({1, 10})
+        box.error.injection.set('ERRINJ_WAL_DELAY', true)
+        local f1 = fiber.new(s.replace, s, {2, 20})
+        f1:set_joinable(true)
+        local f2 = fiber.new(box.snapshot)
+        f2:set_joinable(true)
+        fiber.yield()
+        box.error.injection.set('ERRINJ_WAL_DELAY', false)
+        t.assert_equals({f1:join()}, {true, {2, 20}})
+        t.assert_equals({f2:join()}, {true, 'ok'})
+        t.assert_equals(_G.file_count('delta'), delta_count + 1)
+    end)
+    cg.server:restart()
+    define_helpers(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:select(), {{1, 10}, {2, 20}})
+    end)
+end
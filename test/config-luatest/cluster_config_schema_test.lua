@@ -262,7 +262,9 @@ g.test_defaults = function()
                 interval = 3600,
                 wal_size = 1000000000000000000,
             },
+            compress_threads = 1,
             count = 2,
+            delta_count = 0,
             snap_io_rate_limit = box.NULL,
         },
         iproto = {
@@ -270,8 +272,10 @@ g.test_defaults = function()
                 client = box.NULL,
             },
             threads = 1,
+            net_box_io_threads = 0,
             net_msg_max = 768,
             readahead = 16320,
+            stale_read_max_lag = 0,
         },
         process = {
             strip_core = true,
@@ -295,6 +299,7 @@ g.test_defaults = function()
             cache = 134217728,
             defer_deletes = false,
             memory = 134217728,
+            page_cache = 0,
             timeout = 60,
         },
         quiver = is_enterprise and {
@@ -320,6 +325,7 @@ g.test_defaults = function()
             timeout = 1,
             reconnect_timeout = box.NULL,
             synchro_timeout = 5,
+            synchro_confirm_delay = 0,
             synchro_queue_max_size = 16777216,
             connect_timeout = 30,
             sync_timeout = box.NULL,
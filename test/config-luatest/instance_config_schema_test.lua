@@ -495,8 +495,10 @@ g.test_iproto = function()
                 },
             },
             threads = 1,
+            net_box_io_threads = 1,
             net_msg_max = 1,
             readahead = 1,
+            stale_read_max_lag = 1,
         },
     }
     instance_config:validate(iconfig)
@@ -507,8 +509,10 @@ g.test_iproto = function()
             client = box.NULL,
         },
         threads = 1,
+        net_box_io_threads = 0,
         net_msg_max = 768,
         readahead = 16320,
+        stale_read_max_lag = 0,
     }
     local res = instance_config:apply_default({}).iproto
     t.assert_equals(res, exp)
@@ -562,8 +566,10 @@ g.test_iproto_enterprise = function()
                 },
             },
             threads = 1,
+            net_box_io_threads = 1,
             net_msg_max = 1,
             readahead = 1,
+            stale_read_max_lag = 1,
             ssl = {
                 ssl_key = 'one',
                 ssl_cert = 'two',
@@ -582,8 +588,10 @@ g.test_iproto_enterprise = function()
             client = box.NULL,
         },
         threads = 1,
+        net_box_io_threads = 0,
         net_msg_max = 768,
         readahead = 16320,
+        stale_read_max_lag = 0,
     }
     local res = instance_config:apply_default({}).iproto
     t.assert_equals(res, exp)
@@ -1096,6 +1104,7 @@ g.test_vinyl = function()
             cache = 10,
             defer_deletes = true,
             memory = 11,
+            page_cache = 12,
             timeout = 5.5,
         },
     }
@@ -1115,6 +1124,7 @@ g.test_vinyl = function()
         cache = 134217728,
         defer_deletes = false,
         memory = 134217728,
+        page_cache = 0,
         timeout = 60,
     }
     local res = instance_config:apply_default({}).vinyl
@@ -1193,7 +1203,9 @@ g.test_snapshot = function()
                 interval = 1,
                 wal_size = 1,
             },
+            compress_threads = 2,
             count = 1,
+            delta_count = 3,
             snap_io_rate_limit = 1,
         },
     }
@@ -1206,7 +1218,9 @@ g.test_snapshot = function()
             interval = 3600,
             wal_size = 1000000000000000000,
         },
+        compress_threads = 1,
         count = 2,
+        delta_count = 0,
         snap_io_rate_limit = box.NULL,
     }
     local res = instance_config:apply_default({}).snapshot
@@ -1224,6 +1238,7 @@ g.test_replication = function()
             timeout = 1,
             reconnect_timeout = 1,
             synchro_timeout = 1,
+            synchro_confirm_delay = 1,
             synchro_queue_max_size = 1,
             connect_timeout = 1,
             sync_timeout = 1,
@@ -1254,6 +1269,7 @@ g.test_replication = function()
         timeout = 1,
         reconnect_timeout = box.NULL,
         synchro_timeout = 5,
+        synchro_confirm_delay = 0,
         synchro_queue_max_size = 16777216,
         connect_timeout = 30,
         sync_timeout = box.NULL,
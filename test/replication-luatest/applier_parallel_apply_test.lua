@@ -0,0 +1,127 @@
+local t = require('luatest')
+local server = require('luatest.server')
+local replica_set = require('luatest.replica_set')
+
+local g = t.group('applier_parallel_apply', t.helpers.matrix({
+    engine = {'memtx', 'vinyl'},
+}))
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new{}
+    cg.master = cg.replica_set:build_and_add_server{
+        alias = 'master',
+        box_cfg = {
+            replication_timeout = 0.1,
+        },
+    }
+    cg.replica = cg.replica_set:build_and_add_server{
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                server.build_listen_uri('master', cg.replica_set.id),
+            },
+            replication_timeout = 0.1,
+        },
+    }
+    cg.replica_set:start()
+    cg.replica:exec(function()
+        box.internal.tweaks.applier_parallel_tx_max = 8
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+g.before_each(function(cg)
+    cg.master:exec(function(engine)
+        box.schema.space.create('test', {engine = engine})
+        box.space.test:create_index('pk')
+        box.schema.space.create('test_uniq', {engine = engine})
+        box.space.test_uniq:create_index('pk')
+        box.space.test_uniq:create_index('sk', {parts = {2, 'unsigned'}})
+        box.schema.space.create('test_memtx')
+        box.space.test_memtx:create_index('pk')
+    end, {cg.params.engine})
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+g.after_each(function(cg)
+    cg.master:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+        if box.space.test_uniq ~= nil then
+            box.space.test_uniq:drop()
+        end
+        if box.space.test_memtx ~= nil then
+            box.space.test_memtx:drop()
+        end
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+end)
+
+-- Check that the replica ends up with the same data as the master when
+-- transactions modifying the same keys are interleaved with independent
+-- ones and with transactions that must be applied exclusively.
+g.test_data_consistency = function(cg)
+    cg.replica:exec(function()
+        rawset(_G, 'old_replication', box.cfg.replication)
+        box.cfg{replication = {}}
+    end)
+    cg.master:exec(function()
+        for i = 1, 1000 do
+            box.begin()
+            box.space.test:replace{i % 50, i}
+            box.space.test:upsert({i % 7 + 100, 1}, {{'+', 2, 1}})
+            box.commit()
+            if i % 10 == 0 then
+                box.space.test:delete{i % 50}
+            end
+            if i % 3 == 0 then
+                box.space.test_uniq:replace{i % 20, i % 20 * 2}
+            end
+        end
+        box.space.test:update({100}, {{'=', 2, 0}})
+    end)
+    cg.replica:exec(function()
+        box.cfg{replication = _G.old_replication}
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    local function select_all()
+        return {box.space.test:select(), box.space.test_uniq:select()}
+    end
+    t.assert_equals(cg.replica:exec(select_all), cg.master:exec(select_all))
+    cg.replica:assert_follows_upstream(cg.master:get_instance_id())
+end
+
+-- Check that a memtx transaction, which isn't allowed to yield, isn't
+-- aborted when it's applied concurrently with a vinyl transaction that
+-- yields on a disk read.
+g.test_yield = function(cg)
+    t.tarantool.skip_if_not_debug()
+    t.skip_if(cg.params.engine ~= 'vinyl', 'vinyl-only test')
+    cg.master:exec(function()
+        box.space.test:insert{1}
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    cg.replica:exec(function()
+        box.snapshot()
+        box.error.injection.set('ERRINJ_VY_POINT_LOOKUP_DELAY', true)
+    end)
+    cg.master:exec(function()
+        box.space.test:insert{2}
+        box.space.test_memtx:insert{1}
+        box.space.test_memtx:insert{2}
+    end)
+    cg.replica:exec(function()
+        require('fiber').sleep(0.1)
+        box.error.injection.set('ERRINJ_VY_POINT_LOOKUP_DELAY', false)
+    end)
+    cg.replica:wait_for_vclock_of(cg.master)
+    local function select_all()
+        return {box.space.test:select(), box.space.test_memtx:select()}
+    end
+    t.assert_equals(cg.replica:exec(select_all), {{{1}, {2}}, {{1}, {2}}})
+    cg.replica:assert_follows_upstream(cg.master:get_instance_id())
+end
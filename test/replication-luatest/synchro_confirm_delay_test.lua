@@ -0,0 +1,128 @@
+local t = require('luatest')
+local replica_set = require('luatest.replica_set')
+local server = require('luatest.server')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.replica_set = replica_set:new{}
+    local box_cfg = {
+        replication = {
+            server.build_listen_uri('server1', cg.replica_set.id),
+            server.build_listen_uri('server2', cg.replica_set.id),
+        },
+        replication_timeout = 0.1,
+        replication_synchro_timeout = 120,
+        replication_synchro_quorum = 2,
+    }
+    cg.leader = cg.replica_set:build_and_add_server{
+        alias = 'server1',
+        box_cfg = box_cfg,
+    }
+    cg.replica = cg.replica_set:build_and_add_server{
+        alias = 'server2',
+        box_cfg = box_cfg,
+    }
+    cg.replica_set:start()
+    cg.replica_set:wait_for_fullmesh()
+    cg.leader:exec(function()
+        box.ctl.promote()
+        local s = box.schema.space.create('s', {is_sync = true})
+        s:create_index('pk')
+        local as = box.schema.space.create('as')
+        as:create_index('pk')
+    end)
+    cg.leader:wait_for_downstream_to(cg.replica)
+end)
+
+g.after_all(function(cg)
+    cg.replica_set:drop()
+end)
+
+g.after_each(function(cg)
+    cg.leader:exec(function()
+        box.cfg{replication_synchro_confirm_delay = 0}
+        box.space.s:truncate()
+        box.space.as:truncate()
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.leader:exec(function()
+        t.assert_equals(box.cfg.replication_synchro_confirm_delay, 0)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'replication_synchro_confirm_delay'" ..
+            ": the value must be greater than or equal to zero",
+            box.cfg, {replication_synchro_confirm_delay = -1})
+        box.cfg{replication_synchro_confirm_delay = 0.5}
+        t.assert_equals(box.cfg.replication_synchro_confirm_delay, 0.5)
+    end)
+end
+
+-- CONFIRM waits for the next WAL write and is written together with it.
+g.test_confirm_joins_next_write = function(cg)
+    cg.leader:exec(function()
+        local fiber = require('fiber')
+        box.cfg{replication_synchro_confirm_delay = 1000}
+        local f = fiber.new(function() box.space.s:replace{1} end)
+        f:set_joinable(true)
+        fiber.sleep(0.2)
+        -- The quorum is gathered, but CONFIRM isn't written yet.
+        t.assert_equals(f:status(), 'suspended')
+        t.assert_equals(box.info.synchro.queue.len, 1)
+        box.space.as:replace{1}
+        t.assert(f:join(10))
+        t.assert_equals(box.info.synchro.queue.len, 0)
+    end)
+    cg.leader:wait_for_downstream_to(cg.replica)
+    cg.replica:exec(function()
+        t.assert_equals(box.space.s:get(1), {1})
+        t.assert_equals(box.info.synchro.queue.len, 0)
+    end)
+end
+
+-- Lowering the delay writes the pending CONFIRM.
+g.test_delay_decrease = function(cg)
+    cg.leader:exec(function()
+        local fiber = require('fiber')
+        box.cfg{replication_synchro_confirm_delay = 1000}
+        local f = fiber.new(function() box.space.s:replace{2} end)
+        f:set_joinable(true)
+        fiber.sleep(0.2)
+        t.assert_equals(f:status(), 'suspended')
+        box.cfg{replication_synchro_confirm_delay = 0}
+        t.assert(f:join(10))
+        t.assert_equals(box.space.s:get(2), {2})
+    end)
+end
+
+-- CONFIRM is written on its own after the delay if nothing else is written.
+g.test_delay_expires = function(cg)
+    cg.leader:exec(function()
+        local clock = require('clock')
+        box.cfg{replication_synchro_confirm_delay = 0.1}
+        local start = clock.monotonic()
+        box.space.s:replace{3}
+        t.assert_ge(clock.monotonic() - start, 0.1)
+    end)
+end
+
+g.test_latency = function(cg)
+    cg.leader:exec(function()
+        local count = box.info.synchro.queue.latency.count
+        for i = 1, 10 do
+            box.space.s:replace{i}
+        end
+        local latency = box.info.synchro.queue.latency
+        t.assert_equals(latency.count, count + 10)
+        for _, stage in ipairs({'quorum', 'confirm', 'total'}) do
+            t.assert_ge(latency[stage].p50, 0)
+            t.assert_ge(latency[stage].p99, latency[stage].p50)
+        end
+        t.assert_ge(latency.total.p99, latency.quorum.p50)
+    end)
+    cg.replica:exec(function()
+        -- Only transactions confirmed by this instance are accounted.
+        t.assert_equals(box.info.synchro.queue.latency.count, 0)
+    end)
+end
@@ -0,0 +1,130 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new()
+    cg.server:start()
+    cg.server:exec(function()
+        box.execute([[SET SESSION "sql_seq_scan" = true;]])
+        box.execute([[CREATE TABLE t1(i INT PRIMARY KEY, a INT,
+                                      s STRING COLLATE "unicode_ci",
+                                      d DOUBLE, n NUMBER);]])
+        box.execute([[CREATE TABLE t2(i INT PRIMARY KEY, a INT,
+                                      s STRING COLLATE "unicode_ci",
+                                      d DOUBLE, n NUMBER);]])
+        -- The inner table must be big enough for an automatic index.
+        box.execute([[INSERT INTO t2
+                      WITH RECURSIVE c(x) AS
+                          (VALUES(1) UNION ALL
+                           SELECT x + 1 FROM c WHERE x < 10240)
+                      SELECT x, x % 1024, 'Key' || CAST(x % 1024 AS STRING),
+                             CAST(x % 1024 AS DOUBLE) / 2, x % 1024
+                      FROM c;]])
+        box.execute([[INSERT INTO t2 VALUES(10241, NULL, NULL, NULL, NULL);]])
+        box.execute([[INSERT INTO t1 VALUES
+                      (1, 5, 'KEY5', 2.5, CAST(5 AS DECIMAL)),
+                      (2, 7, 'key7', 3, 7),
+                      (3, 5000, 'nokey', 5000.5, 5000),
+                      (4, NULL, NULL, NULL, NULL);]])
+        -- Returns the plan of the inner loop of the given join.
+        rawset(_G, 'inner_plan', function(sql)
+            local res = box.execute('EXPLAIN QUERY PLAN ' .. sql)
+            return res.rows[2][4]
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_hash_join = function(cg)
+    cg.server:exec(function()
+        local sql = [[SELECT t1.i, COUNT(*) FROM t1 JOIN t2 ON t2.a = t1.a
+                      GROUP BY t1.i;]]
+        t.assert_equals(_G.inner_plan(sql),
+                        'SEARCH TABLE t2 USING EPHEMERAL HASH INDEX (a=?) ' ..
+                        '(~20 rows)')
+        t.assert_equals(box.execute(sql).rows, {{1, 10}, {2, 10}})
+
+        sql = [[SELECT t2.i FROM t1 JOIN t2 ON t2.a = t1.a
+                WHERE t1.a = 5 ORDER BY t2.i;]]
+        local rows = box.execute(sql).rows
+        t.assert_equals(#rows, 10)
+        for k, row in ipairs(rows) do
+            t.assert_equals(row[1], 5 + (k - 1) * 1024)
+        end
+    end)
+end
+
+g.test_hash_join_left = function(cg)
+    cg.server:exec(function()
+        local sql = [[SELECT COUNT(*), COUNT(t2.i) FROM t1
+                      LEFT JOIN t2 ON t2.a = t1.a;]]
+        t.assert_str_contains(_G.inner_plan(sql), 'EPHEMERAL HASH INDEX')
+        t.assert_equals(box.execute(sql).rows, {{22, 20}})
+    end)
+end
+
+g.test_hash_join_collation = function(cg)
+    cg.server:exec(function()
+        local sql = [[SELECT t1.i, COUNT(*) FROM t1 JOIN t2 ON t2.s = t1.s
+                      GROUP BY t1.i;]]
+        t.assert_str_contains(_G.inner_plan(sql), 'EPHEMERAL HASH INDEX')
+        t.assert_equals(box.execute(sql).rows, {{1, 10}, {2, 10}})
+    end)
+end
+
+g.test_hash_join_double = function(cg)
+    cg.server:exec(function()
+        local sql = [[SELECT t1.i, COUNT(*) FROM t1 JOIN t2 ON t2.d = t1.d
+                      GROUP BY t1.i;]]
+        t.assert_str_contains(_G.inner_plan(sql), 'EPHEMERAL HASH INDEX')
+        t.assert_equals(box.execute(sql).rows, {{1, 10}, {2, 10}})
+    end)
+end
+
+-- Equal NUMBER values may have different encodings, so a tree is used.
+g.test_hash_join_number = function(cg)
+    cg.server:exec(function()
+        local sql = [[SELECT t1.i, COUNT(*) FROM t1 JOIN t2 ON t2.n = t1.n
+                      GROUP BY t1.i;]]
+        t.assert_equals(_G.inner_plan(sql),
+                        'SEARCH TABLE t2 USING EPHEMERAL INDEX (n=?) ' ..
+                        '(~20 rows)')
+        t.assert_equals(box.execute(sql).rows, {{1, 10}, {2, 10}})
+    end)
+end
+
+-- A table that doesn't fit in the memory limit uses a tree.
+g.test_hash_join_memory_limit = function(cg)
+    cg.server:exec(function()
+        local sql = [[SELECT t1.i, COUNT(*) FROM t1 JOIN t2 ON t2.a = t1.a
+                      GROUP BY t1.i;]]
+        local stmt = box.prepare(sql)
+        box.internal.tweaks.sql_hash_join_memory_max = 64 * 1024
+        t.assert_equals(_G.inner_plan(sql),
+                        'SEARCH TABLE t2 USING EPHEMERAL INDEX (a=?) ' ..
+                        '(~20 rows)')
+        t.assert_equals(box.execute(sql).rows, {{1, 10}, {2, 10}})
+        -- The statement was prepared before the limit was lowered, so
+        -- its hash table is moved to an ephemeral space while it's built.
+        t.assert_equals(stmt:execute().rows, {{1, 10}, {2, 10}})
+        box.internal.tweaks.sql_hash_join_memory_max = 0
+        t.assert_equals(stmt:execute().rows, {{1, 10}, {2, 10}})
+        box.internal.tweaks.sql_hash_join_memory_max = 64 * 1024 * 1024
+        t.assert_equals(stmt:execute().rows, {{1, 10}, {2, 10}})
+        stmt:unprepare()
+
+        -- Collations are respected after the table is moved.
+        sql = [[SELECT t1.i, COUNT(*) FROM t1 JOIN t2 ON t2.s = t1.s
+                GROUP BY t1.i;]]
+        stmt = box.prepare(sql)
+        box.internal.tweaks.sql_hash_join_memory_max = 0
+        t.assert_equals(stmt:execute().rows, {{1, 10}, {2, 10}})
+        box.internal.tweaks.sql_hash_join_memory_max = 64 * 1024 * 1024
+        stmt:unprepare()
+    end)
+end
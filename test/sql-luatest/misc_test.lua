@@ -258,7 +258,7 @@ g.test_4933_make_sure_autoindex_optimization_used = function(cg)
                 {0, 0, 0, 'SCAN TABLE t1 (~1048576 rows)'},
                 {
                     0, 1, 1,
-                    'SEARCH TABLE t2 USING EPHEMERAL INDEX (b=?) (~20 rows)'
+                    'SEARCH TABLE t2 USING EPHEMERAL HASH INDEX (b=?) (~20 rows)'
                 },
             },
         }
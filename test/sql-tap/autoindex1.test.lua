@@ -33,7 +33,7 @@ test:do_eqp_test(
     ]], {
         {0,0,0,"SCAN TABLE t1 (~1048576 rows)"},
         {0,0,0,"EXECUTE CORRELATED SCALAR SUBQUERY 1"},
-        {1,0,0,"SEARCH TABLE t2 USING EPHEMERAL INDEX (c=?) (~20 rows)"}
+        {1,0,0,"SEARCH TABLE t2 USING EPHEMERAL HASH INDEX (c=?) (~20 rows)"}
     })
 
 local result = test:execsql([[SELECT b, (SELECT d FROM t2 WHERE c = a) FROM t1;]])
@@ -43,7 +43,7 @@ test:do_eqp_test(
         SELECT b, d FROM t1 JOIN t2 ON a = c ORDER BY b;
     ]], {
         {0,0,0,"SCAN TABLE t1 (~1048576 rows)"},
-        {0,1,1,"SEARCH TABLE t2 USING EPHEMERAL INDEX (c=?) (~20 rows)"}
+        {0,1,1,"SEARCH TABLE t2 USING EPHEMERAL HASH INDEX (c=?) (~20 rows)"}
     })
 
 test:do_execsql_test(
@@ -56,7 +56,7 @@ test:do_eqp_test(
         SELECT b, d FROM t1 CROSS JOIN t2 ON (c = a);
     ]], {
         {0,0,0,"SCAN TABLE t1 (~1048576 rows)"},
-        {0,1,1,"SEARCH TABLE t2 USING EPHEMERAL INDEX (c=?) (~20 rows)"}
+        {0,1,1,"SEARCH TABLE t2 USING EPHEMERAL HASH INDEX (c=?) (~20 rows)"}
     })
 
 test:do_execsql_test(
@@ -108,15 +108,15 @@ test:do_eqp_test(
           JOIN t3 AS x10 ON x10.a=x9.b;
     ]], {
         {0,0,0,"SCAN TABLE t3 AS x1 (~1048576 rows)"},
-        {0,1,1,"SEARCH TABLE t3 AS x2 USING EPHEMERAL INDEX (a=?) (~20 rows)"},
-        {0,2,2,"SEARCH TABLE t3 AS x3 USING EPHEMERAL INDEX (a=?) (~20 rows)"},
-        {0,3,3,"SEARCH TABLE t3 AS x4 USING EPHEMERAL INDEX (a=?) (~20 rows)"},
-        {0,4,4,"SEARCH TABLE t3 AS x5 USING EPHEMERAL INDEX (a=?) (~20 rows)"},
-        {0,5,5,"SEARCH TABLE t3 AS x6 USING EPHEMERAL INDEX (a=?) (~20 rows)"},
-        {0,6,6,"SEARCH TABLE t3 AS x7 USING EPHEMERAL INDEX (a=?) (~20 rows)"},
-        {0,7,7,"SEARCH TABLE t3 AS x8 USING EPHEMERAL INDEX (a=?) (~20 rows)"},
-        {0,8,8,"SEARCH TABLE t3 AS x9 USING EPHEMERAL INDEX (a=?) (~20 rows)"},
-        {0,9,9,"SEARCH TABLE t3 AS x10 USING EPHEMERAL INDEX (a=?) (~20 rows)"}
+        {0,1,1,"SEARCH TABLE t3 AS x2 USING EPHEMERAL HASH INDEX (a=?) (~20 rows)"},
+        {0,2,2,"SEARCH TABLE t3 AS x3 USING EPHEMERAL HASH INDEX (a=?) (~20 rows)"},
+        {0,3,3,"SEARCH TABLE t3 AS x4 USING EPHEMERAL HASH INDEX (a=?) (~20 rows)"},
+        {0,4,4,"SEARCH TABLE t3 AS x5 USING EPHEMERAL HASH INDEX (a=?) (~20 rows)"},
+        {0,5,5,"SEARCH TABLE t3 AS x6 USING EPHEMERAL HASH INDEX (a=?) (~20 rows)"},
+        {0,6,6,"SEARCH TABLE t3 AS x7 USING EPHEMERAL HASH INDEX (a=?) (~20 rows)"},
+        {0,7,7,"SEARCH TABLE t3 AS x8 USING EPHEMERAL HASH INDEX (a=?) (~20 rows)"},
+        {0,8,8,"SEARCH TABLE t3 AS x9 USING EPHEMERAL HASH INDEX (a=?) (~20 rows)"},
+        {0,9,9,"SEARCH TABLE t3 AS x10 USING EPHEMERAL HASH INDEX (a=?) (~20 rows)"}
     })
 
 test:finish_test()
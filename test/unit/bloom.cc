@@ -2,6 +2,7 @@
 #include <unordered_set>
 #include <vector>
 #include <iostream>
+#include <math.h>
 
 #define UNIT_TAP_COMPATIBLE 1
 #include "unit.h"
@@ -115,9 +116,64 @@ merge_test()
 	footer();
 }
 
+static void
+split_test()
+{
+	plan(3);
+	header();
+
+	srand(time(0));
+	uint32_t error_count = 0;
+	uint32_t fp_rate_too_big = 0;
+	uint32_t fp_rate_estimate_wrong = 0;
+	for (double p = 0.001; p < 0.5; p *= 1.3) {
+		uint64_t tests = 0;
+		uint64_t false_positive = 0;
+		double expected = 0;
+		for (uint32_t count = 1000; count <= 10000; count *= 2) {
+			struct bloom bloom;
+			bloom_split_create(&bloom, count, p);
+			void *bloom_data =
+				xcalloc(1, bloom_split_data_size(&bloom));
+			unordered_set<uint32_t> check;
+			for (uint32_t i = 0; i < count; i++) {
+				uint32_t val = rand() % (count * 10);
+				check.insert(val);
+				bloom_split_add(&bloom, bloom_data, h(val));
+			}
+			for (uint32_t i = 0; i < count * 10; i++) {
+				bool has = check.find(i) != check.end();
+				bool bloom_possible = bloom_split_maybe_has(
+					&bloom, bloom_data, h(i));
+				tests++;
+				if (has && !bloom_possible)
+					error_count++;
+				if (!has && bloom_possible)
+					false_positive++;
+			}
+			expected += bloom_split_fpr(&bloom, check.size()) *
+				    count * 10;
+			free(bloom_data);
+		}
+		double fp_rate = (double)false_positive / tests;
+		if (fp_rate > p + 0.001)
+			fp_rate_too_big++;
+		if (fabs(fp_rate - expected / tests) > p / 2 + 0.001)
+			fp_rate_estimate_wrong++;
+	}
+	ok(error_count == 0, "There were %u errors, 0 expected", error_count);
+	ok(fp_rate_too_big == 0, "False positive rate was higher than "
+	   "expected in %u cases", fp_rate_too_big);
+	ok(fp_rate_estimate_wrong == 0, "False positive rate estimate was "
+	   "wrong in %u cases", fp_rate_estimate_wrong);
+
+	footer();
+}
+
 int
 main(void)
 {
 	simple_test();
 	merge_test();
+	split_test();
 }
@@ -498,11 +498,48 @@ iterator_freeze_check()
 	ok(true, "tree view iteration");
 }
 
+static void
+iterator_leaf_elems_check()
+{
+	plan(2);
+	const long count = 10000;
+	struct test tree;
+	test_create(&tree, 0, &allocator, NULL);
+	for (long i = 0; i < count; i++) {
+		elem_t e;
+		e.first = i;
+		e.second = 0;
+		test_insert(&tree, e, 0, 0);
+	}
+	/* Walk the tree leaf by leaf, starting from the middle of a leaf. */
+	long expected = count / 3;
+	bool iterator_ok = true;
+	bool exact;
+	struct test_iterator iterator =
+		test_lower_bound(&tree, expected, &exact);
+	elem_t *elems;
+	bps_tree_pos_t n;
+	while ((elems = test_iterator_get_leaf_elems(&tree, &iterator,
+						     &n)) != NULL) {
+		iterator_ok = iterator_ok && n > 0;
+		for (bps_tree_pos_t i = 0; i < n; i++) {
+			if (elems[i].first != expected++)
+				iterator_ok = false;
+		}
+		iterator.pos += n - 1;
+		test_iterator_next(&tree, &iterator);
+	}
+	ok(iterator_ok, "leaf elements are in order");
+	is(expected, count, "all elements are visited");
+	test_destroy(&tree);
+	check_plan();
+}
+
 
 int
 main(void)
 {
-	plan(4);
+	plan(5);
 	header();
 
 	matras_allocator_create(&allocator, test_TREE_EXTENT_SIZE,
@@ -512,6 +549,7 @@ main(void)
 	iterator_check();
 	iterator_invalidate_check();
 	iterator_freeze_check();
+	iterator_leaf_elems_check();
 	ok(total_extents_allocated == allocator.num_reserved_extents,
 	   "leak check");
 
@@ -261,6 +261,79 @@ test_nonlibev_pipe(void)
 
 /** }}} Non-libev pipe ---------------------------------------- */
 
+/**
+ * Lock-free pipe {{{ --------------------------------------------
+ */
+
+/** Sequence number of the next message expected by the worker. */
+static int next_seq;
+/** Set if the worker received a message out of order. */
+static bool is_reordered;
+
+struct seq_msg {
+	struct test_msg base;
+	int seq;
+};
+
+static void
+check_seq(struct cmsg *m)
+{
+	struct seq_msg *msg = (struct seq_msg *)m;
+	if (msg->seq != next_seq++)
+		is_reordered = true;
+}
+
+static void
+test_lockfree_pipe(void)
+{
+	const int msg_count = 1000;
+
+	header();
+	plan(3);
+
+	struct cpipe pipe;
+	cpipe_create(&pipe, "worker");
+	cpipe_set_transport(&pipe, CPIPE_TRANSPORT_LOCKFREE);
+	cpipe_set_max_input(&pipe, 7);
+
+	struct cmsg_hop route[] = {
+		{ check_seq, &pipe_to_main },
+		{ send_signal, NULL },
+	};
+	struct seq_msg *msgs = xcalloc(msg_count, sizeof(*msgs));
+	for (int i = 0; i < msg_count; ++i) {
+		test_msg_create(&msgs[i].base, route);
+		msgs[i].seq = i;
+		cpipe_push(&pipe, &msgs[i].base.base);
+	}
+	for (int i = 0; i < msg_count; ++i) {
+		fiber_signal_recv(&msgs[i].base.signal);
+		test_msg_destroy(&msgs[i].base);
+	}
+	is(next_seq, msg_count, "all messages delivered");
+	ok(!is_reordered, "messages delivered in order");
+
+	struct cmsg_hop check_route[] = {
+		{ do_nothing, &pipe_to_main },
+		{ send_signal, NULL },
+	};
+	struct test_msg check_msg;
+	test_msg_create(&check_msg, check_route);
+	cpipe_push(&pipe_to_worker, &check_msg.base);
+	fiber_signal_recv(&check_msg.signal);
+	ok(true, "mutex pipe works along with lock-free one");
+	test_msg_destroy(&check_msg);
+	flushed_cnt = 0;
+
+	cpipe_destroy(&pipe);
+	free(msgs);
+
+	check_plan();
+	footer();
+}
+
+/** }}} Lock-free pipe ---------------------------------------- */
+
 static int
 cbus_loop_f(va_list ap)
 {
@@ -277,7 +350,7 @@ cbus_test_suite_f(va_list ap)
 {
 	(void)ap;
 	header();
-	plan(3);
+	plan(4);
 
 	struct fiber *endpoint_worker = fiber_new("main_endpoint", cbus_loop_f);
 	fiber_set_joinable(endpoint_worker, true);
@@ -290,6 +363,7 @@ cbus_test_suite_f(va_list ap)
 	test_single_msg();
 	test_auto_flush();
 	test_nonlibev_pipe();
+	test_lockfree_pipe();
 
 	worker_stop();
 	fiber_cancel(endpoint_worker);
@@ -0,0 +1,148 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mp_scan.h"
+#include "msgpuck.h"
+#include "trivia/util.h"
+
+#define UNIT_TAP_COMPATIBLE 1
+#include "unit.h"
+
+enum {
+	FIELD_COUNT = 300,
+	/** Enough for any tuple generated by encode_tuple(). */
+	BUF_SIZE = FIELD_COUNT * 1024,
+};
+
+/** Encode a random value, mostly single-byte ones. */
+static char *
+encode_value(char *data, int depth)
+{
+	switch (rand() % 12) {
+	case 0:
+		return mp_encode_uint(data, rand());
+	case 1:
+		return mp_encode_int(data, -rand() % 1000 - 1);
+	case 2:
+		return mp_encode_str0(data, "abc");
+	case 3:
+		return mp_encode_double(data, 1.5);
+	case 4:
+		if (depth < 3) {
+			data = mp_encode_array(data, 3);
+			for (int i = 0; i < 3; i++)
+				data = encode_value(data, depth + 1);
+			return data;
+		}
+		return mp_encode_nil(data);
+	case 5:
+		if (depth < 3) {
+			data = mp_encode_map(data, 2);
+			for (int i = 0; i < 4; i++)
+				data = encode_value(data, depth + 1);
+			return data;
+		}
+		return mp_encode_bool(data, true);
+	case 6:
+		return mp_encode_nil(data);
+	case 7:
+		return mp_encode_bool(data, rand() % 2 == 0);
+	case 8:
+		return mp_encode_int(data, -(rand() % 32) - 1);
+	default:
+		return mp_encode_uint(data, rand() % 128);
+	}
+}
+
+static size_t
+encode_tuple(char *data)
+{
+	char *end = mp_encode_array(data, FIELD_COUNT);
+	for (int i = 0; i < FIELD_COUNT; i++)
+		end = encode_value(end, 0);
+	return end - data;
+}
+
+static void
+test_next_n(void)
+{
+	plan(1);
+	header();
+
+	char *buf = xmalloc(BUF_SIZE);
+	bool success = true;
+	for (int iter = 0; iter < 100 && success; iter++) {
+		encode_tuple(buf);
+		for (uint32_t n = 0; n <= FIELD_COUNT && success; n++) {
+			const char *expected = buf;
+			mp_decode_array(&expected);
+			const char *actual = expected;
+			for (uint32_t i = 0; i < n; i++)
+				mp_next(&expected);
+			mp_next_n(&actual, n);
+			success = actual == expected;
+		}
+	}
+	ok(success, "mp_next_n skips the same data as mp_next");
+	free(buf);
+
+	footer();
+	check_plan();
+}
+
+static void
+test_check(void)
+{
+	plan(4);
+	header();
+
+	char *buf = xmalloc(BUF_SIZE);
+	bool valid_ok = true;
+	bool exact_ok = true;
+	bool trunc_ok = true;
+	for (int iter = 0; iter < 100; iter++) {
+		size_t size = encode_tuple(buf);
+		const char *p = buf;
+		if (mp_check_fast(&p, buf + size) != 0 || p != buf + size)
+			valid_ok = false;
+		p = buf;
+		if (mp_check_exact_fast(&p, buf + size) != 0)
+			exact_ok = false;
+		if (iter >= 10)
+			continue;
+		for (size_t len = 1; len < size; len++) {
+			const char *p1 = buf;
+			const char *p2 = buf;
+			if (mp_check_fast(&p1, buf + len) !=
+			    mp_check(&p2, buf + len)) {
+				trunc_ok = false;
+				break;
+			}
+		}
+	}
+	ok(valid_ok, "mp_check_fast accepts valid data");
+	ok(exact_ok, "mp_check_exact_fast accepts valid data");
+	ok(trunc_ok, "mp_check_fast rejects truncated data");
+
+	/* Junk after the value. */
+	size_t size = encode_tuple(buf);
+	buf[size] = 0x01;
+	const char *p = buf;
+	ok(mp_check_exact_fast(&p, buf + size + 1) != 0,
+	   "mp_check_exact_fast rejects junk");
+	free(buf);
+
+	footer();
+	check_plan();
+}
+
+int
+main(void)
+{
+	plan(2);
+	srand(time(NULL));
+	test_next_n();
+	test_check();
+	return check_plan();
+}
@@ -0,0 +1,122 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "fiber.h"
+#include "memory.h"
+#include "tweaks.h"
+#include "uring.h"
+
+#define UNIT_TAP_COMPATIBLE 1
+#include "unit.h"
+
+static void
+set_enabled(bool value)
+{
+	struct tweak *tweak = tweak_find("io_uring_enabled");
+	fail_if(tweak == NULL);
+	struct tweak_value val;
+	val.type = TWEAK_VALUE_BOOL;
+	val.bval = value;
+	fail_if(tweak_set(tweak, &val) != 0);
+}
+
+static void
+test_disabled(void)
+{
+	plan(2);
+	header();
+
+	set_enabled(false);
+	struct uring *ring = uring_new(8, 0);
+	ok(ring == NULL, "ring isn't created if disabled");
+	is(errno, ENOSYS, "errno");
+
+	footer();
+	check_plan();
+}
+
+static void
+test_io(void)
+{
+	plan(9);
+	header();
+
+	set_enabled(true);
+	struct uring *ring = uring_new(8, 4096);
+	if (ring == NULL) {
+		for (int i = 0; i < 9; i++)
+			ok(true, "# SKIP io_uring is unavailable");
+		goto out;
+	}
+	char path[] = "uring.XXXXXX";
+	int fd = mkstemp(path);
+	fail_if(fd < 0);
+
+	char a[100], b[200], buf[300];
+	memset(a, 'a', sizeof(a));
+	memset(b, 'b', sizeof(b));
+	struct iovec iov[2] = {
+		{.iov_base = a, .iov_len = sizeof(a)},
+		{.iov_base = b, .iov_len = sizeof(b)},
+	};
+	is(uring_pwritev(ring, fd, iov, 2, 0, URING_DATASYNC), 300,
+	   "pwritev with sync");
+	is(uring_pread(ring, fd, buf, sizeof(buf), 0), 300, "pread");
+	ok(memcmp(buf, a, sizeof(a)) == 0 &&
+	   memcmp(buf + sizeof(a), b, sizeof(b)) == 0, "pread data");
+
+	const char *data;
+	is(uring_read_fixed(ring, fd, 200, 100, &data), 200, "read fixed");
+	ok(memcmp(data, b, sizeof(b)) == 0, "read fixed data");
+	is(uring_read_fixed(ring, fd, 8192, 0, &data), -1,
+	   "read fixed more than buffer size");
+	is(errno, ENOBUFS, "errno");
+
+	is(uring_co_pwrite(ring, fd, a, sizeof(a), 300), 100, "co pwrite");
+	ok(uring_co_fsync(ring, fd, true) == 0 &&
+	   uring_co_pread(ring, fd, buf, sizeof(buf), 200) == 200 &&
+	   memcmp(buf + 100, a, sizeof(a)) == 0, "co pread after fsync");
+
+	close(fd);
+	unlink(path);
+	uring_delete(ring);
+out:
+	set_enabled(false);
+
+	footer();
+	check_plan();
+}
+
+static int
+main_f(va_list ap)
+{
+	(void)ap;
+	test_disabled();
+	test_io();
+	ev_break(loop(), EVBREAK_ALL);
+	return 0;
+}
+
+int
+main(void)
+{
+	memory_init();
+	fiber_init(fiber_c_invoke);
+	plan(2);
+
+	struct fiber *f = fiber_new("main", main_f);
+	fiber_wakeup(f);
+	ev_run(loop(), 0);
+
+	fiber_free();
+	memory_free();
+	return check_plan();
+}
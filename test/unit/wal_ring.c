@@ -0,0 +1,144 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include <string.h>
+
+#include "fiber.h"
+#include "iproto_constants.h"
+#include "memory.h"
+#include "wal_ring.h"
+#include "xrow.h"
+
+#define UNIT_TAP_COMPATIBLE 1
+#include "unit.h"
+
+/** Append a batch of @a row_count NOP rows to the ring. */
+static void
+write_batch(struct wal_ring *ring, int64_t file_signature, int64_t start,
+	    int64_t end, int row_count, int64_t *lsn)
+{
+	wal_ring_begin(ring, file_signature, start);
+	for (int i = 0; i < row_count; i++) {
+		struct xrow_header row;
+		memset(&row, 0, sizeof(row));
+		row.type = IPROTO_NOP;
+		row.replica_id = 1;
+		row.lsn = ++*lsn;
+		row.tsn = row.lsn;
+		row.is_commit = true;
+		wal_ring_add_row(ring, &row);
+	}
+	wal_ring_commit(ring, end);
+}
+
+/** Read a batch and check its rows. */
+static int
+read_batch(struct wal_ring *ring, int64_t file_signature, int64_t start,
+	   uint64_t *pos, struct wal_ring_batch *batch, int64_t *lsn)
+{
+	int rc = wal_ring_read(ring, file_signature, start, pos,
+			       &fiber()->gc, batch);
+	if (rc != 0)
+		return rc;
+	const char *data = batch->data;
+	const char *data_end = data + batch->size;
+	for (uint32_t i = 0; i < batch->row_count; i++) {
+		struct xrow_header row;
+		fail_if(xrow_decode(&row, &data, data_end, false) != 0);
+		fail_if(row.lsn != ++*lsn);
+	}
+	fail_if(data != data_end);
+	return 0;
+}
+
+static void
+test_basic(void)
+{
+	plan(9);
+	header();
+
+	struct wal_ring *ring = wal_ring_new(64 * 1024);
+	int64_t write_lsn = 0;
+	int64_t read_lsn = 0;
+	uint64_t pos = 0;
+	struct wal_ring_batch batch;
+
+	is(read_batch(ring, 10, 100, &pos, &batch, &read_lsn), 1,
+	   "empty ring");
+
+	write_batch(ring, 10, 100, 200, 3, &write_lsn);
+	write_batch(ring, 10, 200, 300, 5, &write_lsn);
+	write_batch(ring, 20, 50, 80, 1, &write_lsn);
+
+	is(read_batch(ring, 10, 150, &pos, &batch, &read_lsn), 1,
+	   "unknown offset");
+	pos = 0;
+	is(read_batch(ring, 10, 100, &pos, &batch, &read_lsn), 0,
+	   "first batch");
+	is(batch.file_end, 200, "first batch end");
+	is(batch.row_count, 3, "first batch row count");
+	is(read_batch(ring, 10, 200, &pos, &batch, &read_lsn), 0,
+	   "second batch");
+	is(read_batch(ring, 20, 50, &pos, &batch, &read_lsn), 0,
+	   "batch from the next file");
+	is(read_lsn, write_lsn, "all rows read");
+	is(read_batch(ring, 20, 80, &pos, &batch, &read_lsn), 1,
+	   "caught up");
+
+	wal_ring_delete(ring);
+	region_free(&fiber()->gc);
+
+	footer();
+	check_plan();
+}
+
+static void
+test_eviction(void)
+{
+	plan(3);
+	header();
+
+	/* The ring size is rounded up to 4 KB. */
+	struct wal_ring *ring = wal_ring_new(1);
+	int64_t write_lsn = 0;
+	int64_t read_lsn = 0;
+	uint64_t pos = 0;
+	struct wal_ring_batch batch;
+
+	int64_t offset = 0;
+	for (int i = 0; i < 100; i++, offset += 10)
+		write_batch(ring, 1, offset, offset + 10, 10, &write_lsn);
+	is(read_batch(ring, 1, 0, &pos, &batch, &read_lsn), 1,
+	   "evicted batch");
+	read_lsn = write_lsn - 10;
+	is(read_batch(ring, 1, offset - 10, &pos, &batch, &read_lsn), 0,
+	   "last batch");
+
+	/* A batch that doesn't fit in the ring is dropped. */
+	write_batch(ring, 1, offset, offset + 10, 1000, &write_lsn);
+	is(read_batch(ring, 1, offset, &pos, &batch, &read_lsn), 1,
+	   "big batch is dropped");
+
+	wal_ring_delete(ring);
+	region_free(&fiber()->gc);
+
+	footer();
+	check_plan();
+}
+
+int
+main(void)
+{
+	memory_init();
+	fiber_init(fiber_c_invoke);
+	plan(2);
+
+	test_basic();
+	test_eviction();
+
+	fiber_free();
+	memory_free();
+	return check_plan();
+}
@@ -844,7 +844,7 @@ static void
 test_xrow_decode_dml_requests()
 {
 	header();
-	plan(105);
+	plan(116);
 
 	const size_t buf_size = 1024;
 	char buf[buf_size];
@@ -1124,6 +1124,43 @@ test_xrow_decode_dml_requests()
 	is(r.end_key, r.end_key_end,
 	   "delete_range(space_id, begin_key, end_key): end_key size");
 
+	/* select_multi(space_id) */
+	header.type = IPROTO_SELECT_MULTI;
+	header.body[0].iov_len = mp_format(buf, buf_size, "{%u%u}",
+					   IPROTO_SPACE_ID, 1);
+	xrow_decode_dml_fail(&header, &r, "select_multi(space_id)",
+			     "Missing mandatory field 'KEY_LIST' in request");
+
+	/* select_multi(space_id, key_list) */
+	header.body[0].iov_len = mp_format(buf, buf_size, "{%u%u%u[[%u][%u]]}",
+					   IPROTO_SPACE_ID, 1,
+					   IPROTO_KEY_LIST, 3, 4);
+	is(xrow_decode_dml(&header, &r, dml_request_key_map(header.type)), 0,
+	   "select_multi(space_id, key_list): success");
+	is(r.space_id, 1, "select_multi(space_id, key_list): space ID");
+	is(mp_decode_array(&r.key_list), 2,
+	   "select_multi(space_id, key_list): key_list len");
+	mp_next(&r.key_list);
+	mp_next(&r.key_list);
+	is(r.key_list, r.key_list_end,
+	   "select_multi(space_id, key_list): key_list size");
+
+	/* cursor_fetch(limit) */
+	header.type = IPROTO_CURSOR_FETCH;
+	header.body[0].iov_len = mp_format(buf, buf_size, "{%u%u}",
+					   IPROTO_LIMIT, 10);
+	xrow_decode_dml_fail(&header, &r, "cursor_fetch(limit)",
+			     "Missing mandatory field 'CURSOR_ID' in request");
+
+	/* cursor_fetch(cursor_id, limit) */
+	header.body[0].iov_len = mp_format(buf, buf_size, "{%u%u%u%u}",
+					   IPROTO_CURSOR_ID, 7,
+					   IPROTO_LIMIT, 10);
+	is(xrow_decode_dml(&header, &r, dml_request_key_map(header.type)), 0,
+	   "cursor_fetch(cursor_id, limit): success");
+	is(r.cursor_id, 7, "cursor_fetch(cursor_id, limit): cursor ID");
+	is(r.limit, 10, "cursor_fetch(cursor_id, limit): limit");
+
 	check_plan();
 	footer();
 }
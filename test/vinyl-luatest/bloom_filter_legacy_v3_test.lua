@@ -0,0 +1,53 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    t.tarantool.skip_if_not_debug()
+    cg.server = server:new()
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
+end)
+
+-- Checks that runs written with a legacy (V3) bloom filter can be read.
+g.test_read_legacy_v3 = function(cg)
+    cg.server:exec(function()
+        local fio = require('fio')
+        local xlog = require('xlog')
+        local s = box.schema.create_space('test', {engine = 'vinyl'})
+        s:create_index('primary')
+        for i = 1, 100 do
+            s:insert({i * 2})
+        end
+        box.error.injection.set('ERRINJ_TUPLE_BLOOM_LEGACY_V3', true)
+        box.snapshot()
+        box.error.injection.set('ERRINJ_TUPLE_BLOOM_LEGACY_V3', false)
+        local files = fio.glob(fio.pathjoin(box.cfg.vinyl_dir, s.id, 0,
+                                            '*.index'))
+        t.assert_equals(#files, 1)
+        local found = false
+        for _, row in xlog.pairs(files[1]) do
+            if row.BODY.bloom_filter_legacy_v3 ~= nil then
+                t.assert_is(row.BODY.bloom_filter, nil)
+                found = true
+            end
+        end
+        t.assert(found)
+    end)
+    cg.server:restart({box_cfg = {vinyl_cache = 0}})
+    cg.server:exec(function()
+        local s = box.space.test
+        for i = 1, 100 do
+            t.assert_equals(s:get(i * 2), {i * 2})
+            t.assert_equals(s:get(i * 2 + 1), nil)
+        end
+        local stat = s.index.primary:stat().disk.iterator.bloom
+        t.assert_gt(stat.hit, 0)
+    end)
+end
@@ -0,0 +1,102 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {vinyl_write_threads = 4},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        local tweaks = require('internal.tweaks')
+        tweaks.vinyl_compaction_parts_max = 8
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Creates a space with two indexes, fills it with two dumps, compacts
+-- it and checks the content. Returns the number of ranges per index.
+local function compact_and_check(space_opts)
+    local s = box.schema.space.create('test', space_opts)
+    local opts = {page_size = 512, range_size = 64 * 1024}
+    s:create_index('pk', opts)
+    opts.parts = {{2, 'unsigned'}}
+    s:create_index('sk', opts)
+
+    local count = 10000
+    local pad = string.rep('x', 100)
+    for i = 1, count, 2 do
+        s:replace({i, count - i, pad})
+    end
+    box.snapshot()
+    for i = 2, count, 2 do
+        s:replace({i, count - i, pad})
+    end
+    box.snapshot()
+
+    for _, i in pairs(s.index) do
+        i:compact()
+    end
+    t.helpers.retrying({}, function()
+        t.assert_equals(box.stat.vinyl().scheduler.compaction_queue, 0)
+        t.assert_equals(box.stat.vinyl().scheduler.tasks_inprogress, 0)
+    end)
+
+    for _, i in pairs(s.index) do
+        t.assert_equals(i:stat().run_count, i:stat().range_count)
+    end
+    local prev = 0
+    for _, tuple in s:pairs() do
+        t.assert_equals(tuple[1], prev + 1)
+        t.assert_equals(tuple[2], count - tuple[1])
+        prev = tuple[1]
+    end
+    t.assert_equals(prev, count)
+    prev = -1
+    for _, tuple in s.index.sk:pairs() do
+        t.assert_equals(tuple[2], prev + 1)
+        prev = tuple[2]
+    end
+    t.assert_equals(prev, count - 1)
+    t.assert_equals(s:get(count / 2), {count / 2, count / 2, pad})
+    t.assert_equals(s.index.sk:get(0), {count, 0, pad})
+    return s.index.pk:stat().range_count, s.index.sk:stat().range_count
+end
+
+-- Compaction of a big range is split into parts executed in parallel,
+-- which become separate ranges. The number of parts is limited by the
+-- number of compaction threads.
+g.test_compaction_parts = function(cg)
+    local pk, sk = cg.server:exec(compact_and_check, {{engine = 'vinyl'}})
+    t.assert_equals(pk, 3)
+    t.assert_equals(sk, 3)
+end
+
+g.test_compaction_parts_disabled = function(cg)
+    cg.server:exec(function()
+        local tweaks = require('internal.tweaks')
+        tweaks.vinyl_compaction_parts_max = 1
+    end)
+    local pk, sk = cg.server:exec(compact_and_check, {{engine = 'vinyl'}})
+    t.assert_equals(pk, 1)
+    t.assert_equals(sk, 1)
+end
+
+-- Primary index compaction generating deferred DELETEs isn't split.
+g.test_compaction_parts_defer_deletes = function(cg)
+    local pk, sk = cg.server:exec(compact_and_check, {
+        {engine = 'vinyl', defer_deletes = true},
+    })
+    t.assert_equals(pk, 1)
+    t.assert_equals(sk, 3)
+end
@@ -0,0 +1,76 @@
+local server = require('luatest.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        box_cfg = {
+            -- Disable the tuple cache to force page reads.
+            vinyl_cache = 0,
+            vinyl_page_cache = 1024 * 1024,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+        box.cfg{vinyl_page_cache = 1024 * 1024}
+    end)
+end)
+
+g.test_page_cache = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 1024})
+        for i = 1, 100 do
+            s:insert({i, string.rep('x', 100)})
+        end
+        box.snapshot()
+
+        local function pages_read()
+            return s.index.pk:stat().disk.iterator.read.pages
+        end
+
+        t.assert_equals(#s:select(), 100)
+        local pages = pages_read()
+        t.assert_gt(pages, 1)
+        local st = box.stat.vinyl()
+        t.assert_equals(st.page_cache.put, pages)
+        t.assert_gt(st.memory.page_cache, 0)
+
+        -- Pages are taken from the cache.
+        t.assert_equals(#s:select(), 100)
+        t.assert_equals(s:get(50), {50, string.rep('x', 100)})
+        t.assert_equals(pages_read(), pages)
+        t.assert_gt(box.stat.vinyl().page_cache.hit, 0)
+
+        -- Shrinking the cache evicts pages.
+        box.cfg{vinyl_page_cache = 0}
+        st = box.stat.vinyl()
+        t.assert_equals(st.memory.page_cache, 0)
+        t.assert_equals(st.page_cache.evict, pages)
+
+        -- With the cache disabled, pages are read from disk.
+        t.assert_equals(#s:select(), 100)
+        t.assert_equals(pages_read(), pages * 2)
+        t.assert_equals(box.stat.vinyl().page_cache.put, pages)
+
+        -- The cache is invalidated when a run is deleted.
+        box.cfg{vinyl_page_cache = 1024 * 1024}
+        t.assert_equals(#s:select(), 100)
+        t.assert_gt(box.stat.vinyl().memory.page_cache, 0)
+        s:drop()
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.stat.vinyl().memory.page_cache, 0)
+        end)
+    end)
+end
@@ -33,16 +33,14 @@ box.snapshot()
 --
 -- There are 1000 unique tuples in the index. The cardinality of the
 -- first key part is 100, of the first two key parts is 500, of the
--- first three key parts is 1000. With the default bloom fpr of 0.05,
--- we use 5 hash functions or 5 / ln(2) ~= 7.3 bits per tuple.If we
--- allocated a full sized bloom filter per each sub key, we would need
--- to allocate at least (100 + 500 + 1000 + 1000) * 7 bits or 2275
--- bytes. However, since we adjust the fpr of bloom filters of higher
--- ranks (because a full key lookup checks all its sub keys as well),
--- we use 5, 4, 3, and 1 hash functions for each sub key respectively.
--- This leaves us only (100*5 + 500*4 + 1000*3 + 1000*1) / ln(2) bits
--- or 1172 bytes, and after rounding up to the block size (128 byte)
--- we have 1280 bytes plus the header overhead.
+-- first three key parts is 1000. A split block bloom filter sets one
+-- bit in each 32-bit word of a 32 byte block per key. With the default
+-- bloom fpr of 0.05, it needs 3, 15, 29, and 29 blocks for each sub key
+-- respectively, or 2432 bytes in total. However, since we adjust the fpr
+-- of bloom filters of higher ranks (because a full key lookup checks all
+-- its sub keys as well), we use 0.05, 0.052, 0.12, and 0.5 false positive
+-- rates for each sub key respectively. This leaves us only 3, 14, 24,
+-- and 13 blocks or 1728 bytes plus the header overhead.
 --
 s.index.pk:stat().disk.bloom_size
 
@@ -66,8 +64,8 @@ new_reflects() == 0
 new_seeks() == 1000
 
 for i = 1001, 2000 do s:select{i} end
-new_reflects() > 980
-new_seeks() < 20
+new_reflects() > 940
+new_seeks() < 60
 
 for i = 1, 1000 do s:select{i, i} end
 new_reflects() > 980
@@ -115,8 +113,8 @@ new_reflects() == 0
 new_seeks() == 1000
 
 for i = 1001, 2000 do s:select{i} end
-new_reflects() > 980
-new_seeks() < 20
+new_reflects() > 940
+new_seeks() < 60
 
 for i = 1, 1000 do s:select{i, i} end
 new_reflects() > 980
@@ -87,12 +87,16 @@ end;
 --
 -- Filter dump/compaction time as we need error injection to
 -- test them properly.
+--
+-- The page cache is disabled by default and tested separately.
 function gstat()
     local st = box.stat.vinyl()
     st.regulator = nil
     st.scheduler.dump_time = nil
     st.scheduler.compaction_time = nil
     st.memory.level0 = nil
+    st.memory.page_cache = nil
+    st.page_cache = nil
     return st
 end;
 